@@ -64,6 +64,7 @@
 #include "backend/common/graph_kernel/adapter/symbol_engine_builder.h"
 #include "backend/common/graph_kernel/core/graph_kernel_op_combiner.h"
 
+#include "backend/common/graph_kernel/loop_program_split.h"
 #ifdef ENABLE_AKG
 #include "backend/common/graph_kernel/graph_kernel_build.h"
 #endif
@@ -246,8 +247,17 @@ PassManagerPtr GraphKernelOptimizer::Build() const {
   auto enable_dyn_level = GetPassLevelByFlag(GraphKernelFlags::GetInstance().enable_dynamic_shape_fusion);
   pm->Add(std::make_shared<DynamicShapeCluster>(), enable_dyn_level, is_cpu || is_gpu);
   pm->Add(std::make_shared<SymbolEngineBuilder>(), enable_dyn_level, is_cpu || is_gpu);
+#ifndef USE_LLVM
+  // Without LLVM, the static shape nodes on cpu are run by the loop program interpreter instead of AKG.
+  auto enable_loop_program = is_cpu && GraphKernelFlags::GetInstance().enable_loop_program;
+  pm->Add(std::make_shared<LoopProgramSplit>(), OptLevel_1, enable_loop_program);
+#endif
 #ifdef ENABLE_AKG
+#ifdef USE_LLVM
   pm->Add(std::make_shared<GraphKernelBuild>(), OptLevel_1);
+#else
+  pm->Add(std::make_shared<GraphKernelBuild>(), enable_loop_program ? enable_dyn_level : OptLevel_1);
+#endif
 #endif
   pm->Add(std::make_shared<GeneratedDependElimination>(), OptLevel_2, is_gpu || is_ascend);
   pm->Add(std::make_shared<GetitemTuple>(), OptLevel_1);
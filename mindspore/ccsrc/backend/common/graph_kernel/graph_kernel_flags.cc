@@ -244,7 +244,10 @@ void GraphKernelFlags::CheckSupport() const {
     auto context = MsContext::GetInstance();
     MS_EXCEPTION_IF_NULL(context);
     auto is_cpu = (context->get_param<std::string>(MS_CTX_DEVICE_TARGET) == kCPUDevice);
-    if (is_cpu && !(const_cast<GraphKernelFlags *>(this)->enable_dynamic_shape_fusion)) {
+    if (is_cpu && enable_loop_program) {
+      MS_LOG(INFO) << "LLVM is not found, the static shape fused kernels on cpu platform are run by the built-in loop "
+                      "program interpreter, and the kernels it does not support are split back to single ops.";
+    } else if (is_cpu && !(const_cast<GraphKernelFlags *>(this)->enable_dynamic_shape_fusion)) {
       MS_LOG(WARNING)
         << "Graph Kernel Fusion is not supported without LLVM on cpu platform, and it will be turned off now. Please "
            "refer to https://www.mindspore.cn/install and install the required version of LLVM.";
@@ -322,6 +325,7 @@ void GraphKernelFlags::RegisterFlags(std::map<std::string, std::string> *flag_ma
   reg.AddFlag("enable_lite_conv_tuning", &enable_lite_conv_tuning);
   reg.AddFlag("enable_vectorization", &enable_vectorization);
   reg.AddFlag("enable_dynamic_shape_fusion", &enable_dynamic_shape_fusion);
+  reg.AddFlag("enable_loop_program", &enable_loop_program);
   reg.AddFlag("enable_parallel_op_combine", &enable_parallel_op_combine);
 
   // Integer flags
@@ -375,6 +379,7 @@ std::string GraphKernelFlags::DumpAllFlags() const {
   json["enable_lite_conv_tuning"] = enable_lite_conv_tuning;
   json["enable_vectorization"] = enable_vectorization;
   json["enable_dynamic_shape_fusion"] = enable_dynamic_shape_fusion;
+  json["enable_loop_program"] = enable_loop_program;
 
   json["opt_level"] = opt_level;
   json["fusion_ops_level"] = fusion_ops_level;
@@ -151,6 +151,12 @@ class BACKEND_EXPORT GraphKernelFlags {
    */
   bool enable_dynamic_shape_fusion{false};
 
+  /**
+   * Run the static shape fused kernels on cpu by the built-in loop program interpreter when LLVM is not found.
+   * Experimental feature, graph kernel fusion is turned off on cpu without LLVM when it is not set.
+   */
+  bool enable_loop_program{false};
+
   /**
    * Optimization level, value from 0 to 3.
    * 0: Disable GraphKernel
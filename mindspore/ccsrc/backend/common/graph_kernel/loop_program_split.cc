@@ -0,0 +1,89 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "backend/common/graph_kernel/loop_program_split.h"
+
+#include <memory>
+#include <string>
+#include "include/common/utils/anfalgo.h"
+#include "backend/common/graph_kernel/adapter/expander.h"
+#include "backend/common/graph_kernel/core/graph_kernel_splitter.h"
+#include "backend/common/graph_kernel/core/graph_kernel_utils.h"
+#include "backend/common/graph_kernel/core/split_schemer.h"
+#include "backend/common/graph_kernel/model/loop_program.h"
+
+namespace mindspore::graphkernel {
+namespace {
+// Put every op into its own group and inline it into the main graph.
+class SingleOpSplitSchemer : public CommonSplitSchemer {
+ public:
+  SingleOpSplitSchemer() = default;
+  ~SingleOpSplitSchemer() = default;
+  bool Split(const FuncGraphPtr &func_graph) override {
+    MS_EXCEPTION_IF_NULL(func_graph);
+    auto nodes = TopoSort(func_graph->get_return());
+    for (const auto &node : nodes) {
+      if (node->isa<CNode>() && AnfUtils::IsRealKernel(node)) {
+        (void)AddGroup({node}, true);
+      }
+    }
+    if (split_plan_.empty()) {
+      return false;
+    }
+    GroupReturnNode(func_graph);
+    return true;
+  }
+};
+
+class SingleOpGraphKernelSplitter : public GraphKernelSplitter {
+ public:
+  SingleOpGraphKernelSplitter() = default;
+  ~SingleOpGraphKernelSplitter() = default;
+  SplitSchemerPtr GetSplitSchema(const std::string &) override { return std::make_shared<SingleOpSplitSchemer>(); }
+};
+}  // namespace
+
+bool LoopProgramSplit::Run(const FuncGraphPtr &func_graph) {
+  MS_EXCEPTION_IF_NULL(func_graph);
+  auto mng = GkUtils::GetFuncGraphManager(func_graph);
+  SingleOpGraphKernelSplitter splitter;
+  bool changed = false;
+  auto todos = TopoSort(func_graph->get_return());
+  for (const auto &node : todos) {
+    if (!common::AnfAlgo::IsGraphKernel(node) || common::AnfAlgo::IsDynamicShape(node)) {
+      continue;
+    }
+    auto sub_graph = common::AnfAlgo::GetCNodeFuncGraphPtr(node);
+    MS_EXCEPTION_IF_NULL(sub_graph);
+    auto program = inner::LoopProgram::Lower(GkUtils::AnfGraph2LiteGraph(sub_graph));
+    if (program != nullptr) {
+      // Keep the program for the kernel build, so the node is not lowered twice.
+      sub_graph->set_user_data<inner::LoopProgram>(program);
+      continue;
+    }
+    MS_LOG(INFO) << "Split node " << node->fullname_with_scope() << " that can not be lowered to loop program.";
+    if (!splitter.TrySplit(node->cast<CNodePtr>())) {
+      MS_LOG(WARNING) << "Node " << node->fullname_with_scope()
+                      << " can not be lowered to loop program and can not be split, it is inlined to the main graph.";
+      InlineExpandFuncGraph(node, sub_graph);
+    }
+    changed = true;
+  }
+  if (changed) {
+    GkUtils::UpdateFuncGraphManager(mng, func_graph);
+  }
+  return changed;
+}
+}  // namespace mindspore::graphkernel
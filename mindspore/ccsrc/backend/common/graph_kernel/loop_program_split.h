@@ -0,0 +1,37 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_BACKEND_COMMON_GRAPH_KERNEL_LOOP_PROGRAM_SPLIT_H_
+#define MINDSPORE_CCSRC_BACKEND_COMMON_GRAPH_KERNEL_LOOP_PROGRAM_SPLIT_H_
+
+#include <memory>
+#include "include/backend/optimizer/pass.h"
+#include "ir/func_graph.h"
+
+namespace mindspore::graphkernel {
+/**
+ * @brief Split the graph kernel nodes that can not be lowered to a LoopProgram back to single ops.
+ * @note Used on CPU when there is no kernel compiler, the remaining graph kernel nodes are run by the loop program
+ *       interpreter of the CPU backend.
+ */
+class LoopProgramSplit : public opt::Pass {
+ public:
+  LoopProgramSplit() : Pass("loop_program_split") {}
+  ~LoopProgramSplit() override = default;
+  bool Run(const FuncGraphPtr &func_graph) override;
+};
+using LoopProgramSplitPtr = std::shared_ptr<LoopProgramSplit>;
+}  // namespace mindspore::graphkernel
+#endif  // MINDSPORE_CCSRC_BACKEND_COMMON_GRAPH_KERNEL_LOOP_PROGRAM_SPLIT_H_
@@ -0,0 +1,582 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "backend/common/graph_kernel/model/loop_program.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <sstream>
+#include <utility>
+#include "base/float16.h"
+#include "backend/common/graph_kernel/model/op_node.h"
+#include "utils/anf_utils.h"
+
+namespace mindspore::graphkernel::inner {
+namespace {
+using OpCode = LoopProgram::OpCode;
+constexpr int64_t kBroadcastAxis = -1;
+
+const std::map<std::string, OpCode> kBinaryOps = {
+  {"Add", OpCode::kAdd},         {"Sub", OpCode::kSub},         {"Mul", OpCode::kMul},
+  {"RealDiv", OpCode::kDiv},     {"Div", OpCode::kDiv},         {"Maximum", OpCode::kMaximum},
+  {"Minimum", OpCode::kMinimum}, {"Pow", OpCode::kPow},
+};
+const std::map<std::string, OpCode> kUnaryOps = {
+  {"Neg", OpCode::kNeg},     {"Abs", OpCode::kAbs},       {"Exp", OpCode::kExp},
+  {"Log", OpCode::kLog},     {"Sqrt", OpCode::kSqrt},     {"Rsqrt", OpCode::kRsqrt},
+  {"Reciprocal", OpCode::kReciprocal},                    {"Tanh", OpCode::kTanh},
+  {"Floor", OpCode::kFloor}, {"Round", OpCode::kRound},   {"Erf", OpCode::kErf},
+  {"Sin", OpCode::kSin},     {"Cos", OpCode::kCos},
+};
+const std::map<std::string, OpCode> kReduceOps = {
+  {"ReduceSum", OpCode::kReduceSum},
+  {"ReduceMax", OpCode::kReduceMax},
+  {"ReduceMin", OpCode::kReduceMin},
+};
+
+bool IsFloatType(TypeId type) { return type == kNumberTypeFloat32 || type == kNumberTypeFloat16; }
+
+bool IsDefaultFormat(const DFormat &format) {
+  return format == kOpFormat_DEFAULT || format == kOpFormat_NCHW || format == kOpFormat_ND;
+}
+
+std::vector<int64_t> GetTensorIntValue(const tensor::TensorPtr &tensor) {
+  std::vector<int64_t> values;
+  if (tensor->data_type() == kNumberTypeInt64) {
+    auto data = static_cast<int64_t *>(tensor->data_c());
+    values.assign(data, data + tensor->DataSize());
+  } else if (tensor->data_type() == kNumberTypeInt32) {
+    auto data = static_cast<int32_t *>(tensor->data_c());
+    values.assign(data, data + tensor->DataSize());
+  }
+  return values;
+}
+
+// Union-find over the axes of all values.
+class AxisSet {
+ public:
+  int64_t Add() {
+    parent_.push_back(parent_.size());
+    return static_cast<int64_t>(parent_.size() - 1);
+  }
+  int64_t Find(int64_t x) {
+    while (parent_[x] != static_cast<size_t>(x)) {
+      parent_[x] = parent_[parent_[x]];
+      x = static_cast<int64_t>(parent_[x]);
+    }
+    return x;
+  }
+  void Union(int64_t a, int64_t b) { parent_[Find(a)] = static_cast<size_t>(Find(b)); }
+
+ private:
+  std::vector<size_t> parent_;
+};
+}  // namespace
+
+// Lowering runs in three steps:
+//  1. Every non-1 axis of every value gets an id, the ids that must iterate together (the axes an elementwise op
+//     broadcasts, the axes a reduce keeps) are united. Each class of ids is one axis of the iteration domain.
+//  2. The domain is ordered like the value that has all its axes, the inner axes are the reduced ones, or the
+//     shortest suffix every value either fully has or fully broadcasts when there is no reduce.
+//  3. The nodes are emitted as values, arguments and instructions.
+class LoopProgramLowering {
+ public:
+  explicit LoopProgramLowering(const LiteGraphPtr &graph) : graph_(graph) {}
+  ~LoopProgramLowering() = default;
+
+  LoopProgramPtr Run() {
+    if (!UniteAxes() || !OrderDomain() || !SplitDomain()) {
+      return nullptr;
+    }
+    program_ = std::make_shared<LoopProgram>();
+    if (!Emit()) {
+      return nullptr;
+    }
+    return program_;
+  }
+
+ private:
+  bool Fail(const std::string &reason) const {
+    MS_LOG(INFO) << "Can not lower graph " << graph_->name() << " to loop program: " << reason;
+    return false;
+  }
+
+  bool CheckTensor(const NodePtr &node) const {
+    if (!IsFloatType(node->type)) {
+      return Fail(node->debug_name() + " has type " + TypeIdToString(node->type));
+    }
+    if (!IsDefaultFormat(node->format)) {
+      return Fail(node->debug_name() + " has format " + node->format);
+    }
+    if (std::any_of(node->shape.begin(), node->shape.end(), [](int64_t dim) { return dim <= 0; })) {
+      return Fail(node->debug_name() + " has shape " + ShapeVectorToString(node->shape));
+    }
+    return true;
+  }
+
+  std::vector<int64_t> NewAxes(const DShape &shape) {
+    std::vector<int64_t> axes(shape.size(), kBroadcastAxis);
+    for (size_t i = 0; i < shape.size(); ++i) {
+      if (shape[i] != 1) {
+        axes[i] = axis_set_.Add();
+      }
+    }
+    return axes;
+  }
+
+  // Unite the axes of an operand with the axes of the result it broadcasts to, aligned to the right.
+  bool UniteBroadcast(const NodePtr &input, const NodePtr &output) {
+    const auto &in_axes = axes_[input.get()];
+    const auto &out_axes = axes_[output.get()];
+    if (in_axes.size() > out_axes.size()) {
+      return Fail("operand " + input->debug_name() + " has higher rank than " + output->debug_name());
+    }
+    auto bias = out_axes.size() - in_axes.size();
+    for (size_t i = 0; i < in_axes.size(); ++i) {
+      if (in_axes[i] == kBroadcastAxis) {
+        continue;
+      }
+      if (input->shape[i] != output->shape[i + bias]) {
+        return Fail("operand " + input->debug_name() + " does not broadcast to " + output->debug_name());
+      }
+      axis_set_.Union(in_axes[i], out_axes[i + bias]);
+    }
+    return true;
+  }
+
+  // Unite the non-1 axes of two values in order, for reshapes that only add or remove axes of size 1.
+  bool UniteInOrder(const NodePtr &input, const NodePtr &output, const std::set<size_t> &skip_input_axes = {}) {
+    std::vector<size_t> in_axes;
+    for (size_t i = 0; i < input->shape.size(); ++i) {
+      if (input->shape[i] != 1 && skip_input_axes.count(i) == 0) {
+        in_axes.push_back(i);
+      }
+    }
+    std::vector<size_t> out_axes;
+    for (size_t i = 0; i < output->shape.size(); ++i) {
+      if (output->shape[i] != 1) {
+        out_axes.push_back(i);
+      }
+    }
+    if (in_axes.size() != out_axes.size()) {
+      return Fail(output->debug_name() + " reorganizes the axes of " + input->debug_name());
+    }
+    for (size_t i = 0; i < in_axes.size(); ++i) {
+      if (input->shape[in_axes[i]] != output->shape[out_axes[i]]) {
+        return Fail(output->debug_name() + " reorganizes the axes of " + input->debug_name());
+      }
+      axis_set_.Union(axes_[input.get()][in_axes[i]], axes_[output.get()][out_axes[i]]);
+    }
+    return true;
+  }
+
+  bool VisitConst(const NodePtr &node) {
+    if (axes_.count(node.get()) != 0) {
+      return true;
+    }
+    if (node->NodeType() == NType::Tensor) {
+      if (node->As<ConstTensorNode>()->data()->DataSize() != 1) {
+        return Fail("const tensor " + node->debug_name() + " is not a scalar");
+      }
+    } else if (node->NodeType() != NType::Scalar) {
+      return Fail("unknown input " + node->debug_name());
+    }
+    axes_[node.get()] = std::vector<int64_t>(node->shape.size(), kBroadcastAxis);
+    return true;
+  }
+
+  bool VisitReduce(const PrimOpPtr &op) {
+    const auto &input = op->input(0);
+    constexpr size_t axis_index = 1;
+    if (op->inputs().size() <= axis_index || op->input(axis_index)->NodeType() != NType::Tensor) {
+      return Fail(op->op() + " has no const axis");
+    }
+    auto axis = GetTensorIntValue(op->input(axis_index)->As<ConstTensorNode>()->data());
+    auto rank = static_cast<int64_t>(input->shape.size());
+    std::set<size_t> reduce_axis;
+    for (auto a : axis) {
+      a = a < 0 ? a + rank : a;
+      if (a < 0 || a >= rank) {
+        return Fail(op->op() + " has invalid axis");
+      }
+      (void)reduce_axis.insert(static_cast<size_t>(a));
+    }
+    if (axis.empty()) {
+      for (size_t i = 0; i < input->shape.size(); ++i) {
+        (void)reduce_axis.insert(i);
+      }
+    }
+    std::set<int64_t> reduced;
+    for (auto a : reduce_axis) {
+      if (axes_[input.get()][a] != kBroadcastAxis) {
+        (void)reduced.insert(axes_[input.get()][a]);
+      }
+    }
+    reduced_axes_[op.get()] = reduced;
+    return UniteInOrder(input, op, reduce_axis);
+  }
+
+  bool UniteAxes() {
+    for (const auto &input : graph_->inputs()) {
+      if (!CheckTensor(input)) {
+        return false;
+      }
+      axes_[input.get()] = NewAxes(input->shape);
+    }
+    for (const auto &node : graph_->ops()) {
+      if (node->NodeType() != NType::Primitive) {
+        return Fail("unknown node " + node->debug_name());
+      }
+      auto op = node->As<PrimOp>();
+      if (!CheckTensor(op)) {
+        return false;
+      }
+      axes_[op.get()] = NewAxes(op->shape);
+      const auto &name = op->op();
+      if (kBinaryOps.count(name) != 0 || kUnaryOps.count(name) != 0) {
+        for (const auto &input : op->inputs()) {
+          if (!VisitConst(input) || !UniteBroadcast(input, op)) {
+            return false;
+          }
+        }
+      } else if (name == "Cast" || name == "BroadcastTo") {
+        if (!UniteBroadcast(op->input(0), op)) {
+          return false;
+        }
+      } else if (name == "Reshape") {
+        if (!UniteInOrder(op->input(0), op)) {
+          return false;
+        }
+      } else if (kReduceOps.count(name) != 0) {
+        if (!VisitReduce(op)) {
+          return false;
+        }
+      } else {
+        return Fail("unsupported op " + name);
+      }
+    }
+    for (const auto &output : graph_->GetOutputs()) {
+      if (axes_.count(output.get()) == 0 && (!VisitConst(output) || !CheckTensor(output))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The domain axes of a value in its logical order.
+  std::vector<size_t> DomainAxes(const Node *node) {
+    std::vector<size_t> result;
+    for (auto axis : axes_[node]) {
+      if (axis != kBroadcastAxis) {
+        result.push_back(position_[axis_set_.Find(axis)]);
+      }
+    }
+    return result;
+  }
+
+  bool OrderDomain() {
+    std::set<int64_t> classes;
+    const Node *widest = nullptr;
+    size_t widest_size = 0;
+    for (auto &[node, axes] : axes_) {
+      std::set<int64_t> node_classes;
+      for (auto axis : axes) {
+        if (axis != kBroadcastAxis) {
+          (void)node_classes.insert(axis_set_.Find(axis));
+        }
+      }
+      classes.insert(node_classes.begin(), node_classes.end());
+      if (widest == nullptr || node_classes.size() > widest_size) {
+        widest = node;
+        widest_size = node_classes.size();
+      }
+    }
+    if (widest != nullptr && widest_size != classes.size()) {
+      return Fail("no value iterates over all axes");
+    }
+    if (widest != nullptr) {
+      for (size_t i = 0; i < widest->shape.size(); ++i) {
+        auto axis = axes_[widest][i];
+        if (axis != kBroadcastAxis) {
+          position_[axis_set_.Find(axis)] = domain_.size();
+          domain_.push_back(widest->shape[i]);
+        }
+      }
+    }
+    // Every value must keep the domain order, otherwise it is a transpose.
+    for (auto &[node, axes] : axes_) {
+      auto domain_axes = DomainAxes(node);
+      if (!std::is_sorted(domain_axes.begin(), domain_axes.end()) ||
+          std::adjacent_find(domain_axes.begin(), domain_axes.end()) != domain_axes.end()) {
+        return Fail(node->debug_name() + " transposes the iteration domain");
+      }
+    }
+    return true;
+  }
+
+  // Whether every value has all the inner axes or none of them.
+  bool IsValidSplit(size_t split) {
+    auto inner_num = domain_.size() - split;
+    for (auto &[node, axes] : axes_) {
+      auto domain_axes = DomainAxes(node);
+      auto inner = std::count_if(domain_axes.begin(), domain_axes.end(), [split](size_t d) { return d >= split; });
+      if (inner != 0 && static_cast<size_t>(inner) != inner_num) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool SplitDomain() {
+    std::set<size_t> reduced;
+    for (auto &[op, axes] : reduced_axes_) {
+      std::set<size_t> op_reduced;
+      for (auto axis : axes) {
+        (void)op_reduced.insert(position_[axis_set_.Find(axis)]);
+      }
+      if (op_reduced.empty()) {
+        continue;
+      }
+      if (!reduced.empty() && reduced != op_reduced) {
+        return Fail("the reduces reduce different axes");
+      }
+      reduced = op_reduced;
+    }
+    if (!reduced.empty()) {
+      split_ = domain_.size() - reduced.size();
+      if (*reduced.begin() != split_) {
+        return Fail("the reduced axes are not the innermost axes");
+      }
+      if (!IsValidSplit(split_)) {
+        return Fail("a value broadcasts part of the reduced axes");
+      }
+      return true;
+    }
+    split_ = 0;
+    while (!IsValidSplit(split_)) {
+      ++split_;
+    }
+    return true;
+  }
+
+  LoopProgram::Argument MakeArgument(const NodePtr &node, size_t value) {
+    LoopProgram::Argument arg;
+    arg.type = node->type;
+    arg.value = value;
+    arg.size_in_bytes = node->tensor_size(true);
+    arg.outer_strides.assign(split_, 0);
+    arg.inner_broadcast = true;
+    int64_t stride = 1;
+    const auto &axes = axes_[node.get()];
+    for (size_t i = node->shape.size(); i > 0; --i) {
+      if (axes[i - 1] != kBroadcastAxis) {
+        auto d = position_[axis_set_.Find(axes[i - 1])];
+        if (d < split_) {
+          arg.outer_strides[d] = stride;
+        } else {
+          arg.inner_broadcast = false;
+        }
+      }
+      stride *= node->shape[i - 1];
+    }
+    return arg;
+  }
+
+  size_t AddValue(bool row_scalar) {
+    LoopProgram::Value value;
+    value.row_scalar = row_scalar;
+    program_->values_.push_back(value);
+    return program_->values_.size() - 1;
+  }
+
+  size_t AddConst(const NodePtr &node) {
+    float const_value = 0;
+    if (node->NodeType() == NType::Tensor) {
+      auto tensor = node->As<ConstTensorNode>()->data();
+      switch (tensor->data_type()) {
+        case kNumberTypeFloat32:
+          const_value = *static_cast<float *>(tensor->data_c());
+          break;
+        case kNumberTypeFloat16:
+          const_value = static_cast<float>(*static_cast<float16 *>(tensor->data_c()));
+          break;
+        case kNumberTypeFloat64:
+          const_value = static_cast<float>(*static_cast<double *>(tensor->data_c()));
+          break;
+        default: {
+          auto ints = GetTensorIntValue(tensor);
+          if (ints.empty()) {
+            (void)Fail("const tensor has type " + TypeIdToString(tensor->data_type()));
+            return SIZE_MAX;
+          }
+          const_value = static_cast<float>(ints[0]);
+        }
+      }
+    } else {
+      auto data = node->As<ConstScalarNode>()->data();
+      if (data->isa<FP32Imm>() || data->isa<FP64Imm>()) {
+        const_value = GetValue<float>(data);
+      } else if (data->isa<Int64Imm>() || data->isa<Int32Imm>()) {
+        const_value = static_cast<float>(AnfUtils::GetIntValue(data));
+      } else {
+        (void)Fail("const scalar " + data->ToString() + " is not a number");
+        return SIZE_MAX;
+      }
+    }
+    auto value = AddValue(true);
+    program_->values_[value].is_const = true;
+    program_->values_[value].const_value = const_value;
+    return value;
+  }
+
+  bool ValueOf(const NodePtr &node, size_t *value) {
+    auto iter = value_of_.find(node.get());
+    if (iter == value_of_.end()) {
+      auto const_value = AddConst(node);
+      if (const_value == SIZE_MAX) {
+        return false;
+      }
+      iter = value_of_.emplace(node.get(), const_value).first;
+    }
+    *value = iter->second;
+    return true;
+  }
+
+  bool IsRowScalar(size_t value) const { return program_->values_[value].row_scalar; }
+
+  bool EmitOp(const PrimOpPtr &op) {
+    const auto &name = op->op();
+    if (name == "Reshape" || name == "BroadcastTo" || (name == "Cast" && op->type == kNumberTypeFloat32)) {
+      return ValueOf(op->input(0), &value_of_[op.get()]);
+    }
+    LoopProgram::Instruction instr;
+    size_t input_num = 1;
+    if (name == "Cast") {
+      instr.op = OpCode::kRoundToHalf;
+    } else if (kReduceOps.count(name) != 0) {
+      instr.op = kReduceOps.at(name);
+      if (reduced_axes_[op.get()].empty()) {
+        // reduces the axes of size 1 only
+        return ValueOf(op->input(0), &value_of_[op.get()]);
+      }
+    } else if (kUnaryOps.count(name) != 0) {
+      instr.op = kUnaryOps.at(name);
+    } else {
+      instr.op = kBinaryOps.at(name);
+      input_num = op->inputs().size();
+    }
+    bool row_scalar = true;
+    for (size_t i = 0; i < input_num; ++i) {
+      size_t value = 0;
+      if (!ValueOf(op->input(i), &value)) {
+        return false;
+      }
+      row_scalar = row_scalar && IsRowScalar(value);
+      instr.inputs.push_back(value);
+    }
+    if (kReduceOps.count(name) != 0) {
+      if (row_scalar) {
+        return Fail(name + " reduces a broadcast value");
+      }
+      row_scalar = true;
+      program_->has_reduce_ = true;
+    }
+    instr.output = AddValue(row_scalar);
+    value_of_[op.get()] = instr.output;
+    program_->instructions_.push_back(std::move(instr));
+    return true;
+  }
+
+  bool Emit() {
+    program_->outer_shape_.assign(domain_.begin(), domain_.begin() + static_cast<int64_t>(split_));
+    for (auto dim : program_->outer_shape_) {
+      program_->row_num_ *= dim;
+    }
+    for (size_t i = split_; i < domain_.size(); ++i) {
+      program_->inner_size_ *= domain_[i];
+    }
+    for (const auto &input : graph_->inputs()) {
+      auto arg = MakeArgument(input, 0);
+      arg.value = AddValue(arg.inner_broadcast);
+      value_of_[input.get()] = arg.value;
+      program_->inputs_.push_back(std::move(arg));
+    }
+    for (const auto &node : graph_->ops()) {
+      if (!EmitOp(node->As<PrimOp>())) {
+        return false;
+      }
+    }
+    for (const auto &output : graph_->GetOutputs()) {
+      size_t value = 0;
+      if (!ValueOf(output, &value)) {
+        return false;
+      }
+      auto arg = MakeArgument(output, value);
+      auto outer_num = std::count_if(arg.outer_strides.begin(), arg.outer_strides.end(),
+                                     [](int64_t stride) { return stride != 0; });
+      auto outer_dims = std::count_if(program_->outer_shape_.begin(), program_->outer_shape_.end(),
+                                      [](int64_t dim) { return dim != 1; });
+      if (outer_num != outer_dims) {
+        return Fail("output " + output->debug_name() + " broadcasts an outer axis");
+      }
+      if (arg.inner_broadcast && !IsRowScalar(value)) {
+        return Fail("output " + output->debug_name() + " broadcasts the inner axes");
+      }
+      program_->outputs_.push_back(std::move(arg));
+    }
+    return true;
+  }
+
+  LiteGraphPtr graph_;
+  LoopProgramPtr program_;
+  AxisSet axis_set_;
+  std::map<const Node *, std::vector<int64_t>> axes_;
+  std::map<const Node *, std::set<int64_t>> reduced_axes_;
+  std::map<int64_t, size_t> position_;
+  ShapeVector domain_;
+  size_t split_{0};
+  std::map<const Node *, size_t> value_of_;
+};
+
+LoopProgramPtr LoopProgram::Lower(const LiteGraphPtr &graph) {
+  MS_EXCEPTION_IF_NULL(graph);
+  return LoopProgramLowering(graph).Run();
+}
+
+std::string LoopProgram::ToString() const {
+  std::ostringstream oss;
+  oss << "LoopProgram(outer " << ShapeVectorToString(outer_shape_) << ", inner " << inner_size_ << ") {\n";
+  auto value_str = [this](size_t v) {
+    return values_[v].is_const ? std::to_string(values_[v].const_value)
+                               : "%" + std::to_string(v) + (values_[v].row_scalar ? "s" : "");
+  };
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    oss << "  " << value_str(inputs_[i].value) << " = load input_" << i << "\n";
+  }
+  for (const auto &instr : instructions_) {
+    oss << "  " << value_str(instr.output) << " = op" << static_cast<int>(instr.op) << "(";
+    for (size_t i = 0; i < instr.inputs.size(); ++i) {
+      oss << (i == 0 ? "" : ", ") << value_str(instr.inputs[i]);
+    }
+    oss << ")\n";
+  }
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    oss << "  store output_" << i << " = " << value_str(outputs_[i].value) << "\n";
+  }
+  oss << "}";
+  return oss.str();
+}
+}  // namespace mindspore::graphkernel::inner
@@ -0,0 +1,118 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_BACKEND_COMMON_GRAPH_KERNEL_MODEL_LOOP_PROGRAM_H_
+#define MINDSPORE_CCSRC_BACKEND_COMMON_GRAPH_KERNEL_MODEL_LOOP_PROGRAM_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "backend/common/graph_kernel/model/lite_graph.h"
+
+namespace mindspore::graphkernel::inner {
+// The loop nest of a LiteGraph made of elementwise, broadcast and reduce ops, run by a host interpreter when there is
+// no kernel compiler.
+//
+// The iteration domain is the broadcast shape of the graph, split into outer axes and inner axes. The instructions are
+// evaluated once for every row (a point of the outer axes), where a value holds either the whole inner block or one
+// element broadcast over it. All reduces reduce exactly the inner axes, so a row is reduced in place and the cluster
+// takes a single pass over memory. Values are computed in float32.
+class BACKEND_EXPORT LoopProgram {
+ public:
+  // The key of the program cached on the sub graph of a graph kernel node.
+  constexpr static char key[] = "LoopProgram";
+
+  enum class OpCode : int {
+    // binary
+    kAdd,
+    kSub,
+    kMul,
+    kDiv,
+    kMaximum,
+    kMinimum,
+    kPow,
+    // unary
+    kNeg,
+    kAbs,
+    kExp,
+    kLog,
+    kSqrt,
+    kRsqrt,
+    kReciprocal,
+    kTanh,
+    kFloor,
+    kRound,
+    kErf,
+    kSin,
+    kCos,
+    // rounding of a float32 value to float16 precision, for Cast
+    kRoundToHalf,
+    // reduce the inner block of a row to one element
+    kReduceSum,
+    kReduceMax,
+    kReduceMin,
+  };
+
+  struct Value {
+    // The value has one element per row, broadcast over the inner block.
+    bool row_scalar{false};
+    bool is_const{false};
+    float const_value{0};
+  };
+
+  // A tensor of the kernel, loaded to or stored from a value. The element of a row at inner index i is at
+  //   sum(row_index[d] * outer_strides[d]) + (inner_broadcast ? 0 : i)
+  struct Argument {
+    TypeId type{kTypeUnknown};
+    ShapeVector outer_strides;
+    bool inner_broadcast{false};
+    size_t value{0};
+    size_t size_in_bytes{0};
+  };
+
+  struct Instruction {
+    OpCode op;
+    size_t output;
+    std::vector<size_t> inputs;
+  };
+
+  // Lower the graph, return nullptr when it has an op or a layout the loop nest can not express.
+  static std::shared_ptr<LoopProgram> Lower(const LiteGraphPtr &graph);
+
+  const ShapeVector &outer_shape() const { return outer_shape_; }
+  int64_t row_num() const { return row_num_; }
+  int64_t inner_size() const { return inner_size_; }
+  bool has_reduce() const { return has_reduce_; }
+  const std::vector<Value> &values() const { return values_; }
+  const std::vector<Argument> &inputs() const { return inputs_; }
+  const std::vector<Argument> &outputs() const { return outputs_; }
+  const std::vector<Instruction> &instructions() const { return instructions_; }
+  std::string ToString() const;
+
+ private:
+  friend class LoopProgramLowering;
+
+  ShapeVector outer_shape_;
+  int64_t row_num_{1};
+  int64_t inner_size_{1};
+  bool has_reduce_{false};
+  std::vector<Value> values_;
+  std::vector<Argument> inputs_;
+  std::vector<Argument> outputs_;
+  std::vector<Instruction> instructions_;
+};
+using LoopProgramPtr = std::shared_ptr<LoopProgram>;
+}  // namespace mindspore::graphkernel::inner
+#endif  // MINDSPORE_CCSRC_BACKEND_COMMON_GRAPH_KERNEL_MODEL_LOOP_PROGRAM_H_
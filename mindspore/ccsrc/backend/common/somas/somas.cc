@@ -17,6 +17,7 @@
 #include "backend/common/somas/somas.h"
 #include <algorithm>
 #include <fstream>
+#include <iomanip>
 #include <iterator>
 #include <memory>
 #include <numeric>
@@ -37,6 +38,8 @@
 #include "debug/rdr/string_recorder.h"
 #endif
 #include "include/common/thread_pool.h"
+#include "include/common/utils/compile_cache_context.h"
+#include "utils/hashing.h"
 #ifndef ENABLE_SECURITY
 #include "plugin/device/ascend/hal/profiler/memory_profiling.h"
 
@@ -52,6 +55,7 @@ constexpr auto kOnlyTwoDestinationNode = 2;
 constexpr auto kNopNodeRealInputIndex = 1;
 constexpr auto kZeroAlignSize = 1;
 
+constexpr auto kVersion = "version";
 constexpr auto kGraphId = "graph_id";
 constexpr auto kHashId = "hash_id";
 constexpr auto kReused_memory_size = "reused_memory_size";
@@ -71,6 +75,8 @@ constexpr auto kLifeStart = "life_start";
 constexpr auto kLifeEnd = "life_end";
 constexpr auto kOffset = "offset";
 constexpr auto kCachedResultThreshold = 2000;
+// Bump it when the model fingerprint or the cached result format changes, the old results then miss.
+constexpr size_t kSomasCacheVersion = 2;
 constexpr size_t kLogMergedBlockSize = 10;
 
 // set somas result
@@ -201,7 +207,8 @@ size_t Somas::GetCommunicationReservedSize() const { return 0; }
 void Somas::CommunicationTensorProcess(const std::vector<SomasTensorPtr> &tensors) const {}
 
 bool Somas::GetEnableCacheFlag(const session::KernelGraph &graph) const {
-  return graph.execution_order().size() >= kCachedResultThreshold;
+  // Large graphs always cache the result, others only along with the compile cache.
+  return CompileCacheEnable() || graph.execution_order().size() >= kCachedResultThreshold;
 }
 
 std::pair<bool, std::string> Somas::GetDebugConfig() const {
@@ -259,8 +266,7 @@ bool Somas::LoadSomasCache(const session::KernelGraph &graph) {
   MS_LOG(DEBUG) << "Somas LoadSomasCache start...";
   bool ret = CalcSomasModelHash(graph);
   if (ret) {
-    std::string filename = Common::GetCompilerCachePath() + "/somas_meta/somas_graph_" +
-                           std::to_string(graph.graph_id()) + "_" + hash_id_ + ".json";
+    std::string filename = GetSomasCacheFile(".json");
     ret = LoadSomasResult(filename);
     if (ret) {
       MS_LOG(INFO) << "Load Somas Cache file " << filename << " Successfully.";
@@ -272,17 +278,75 @@ bool Somas::LoadSomasCache(const session::KernelGraph &graph) {
   return ret;
 }
 
+std::string Somas::GetSomasCacheFile(const std::string &suffix) const {
+  return Common::GetCompilerCachePath() + "/somas_meta/somas_graph_" + hash_id_ + suffix;
+}
+
 bool Somas::CalcSomasModelHash(const session::KernelGraph &graph) {
-  auto model_str = SomasInfo(true);
-  hash_id_ = std::to_string(std::hash<std::string>()(model_str));
+  // The fingerprint covers everything the solver reads: the tensor sizes and lifetimes, the node structure, the union
+  // and contiguous constraints and the device configuration. Scope names are left out, so a graph rebuilt with other
+  // names still hits. It is taken before the conflict computation, which rewrites the sizes of union tensors.
+  size_t hash = hash_combine({kSomasCacheVersion, std::hash<std::string>()(device_name_), communication_gap_size_,
+                              static_cast<size_t>(depend_exec_order_)});
+  auto hash_tensor = [&hash](const SomasTensorPtr &tensor) {
+    MS_EXCEPTION_IF_NULL(tensor);
+    hash = hash_combine(hash, hash_combine({tensor->GetId(), tensor->GetSourceNodeId(), tensor->GetSourceStreamId(),
+                                            tensor->GetOriginalSize(), tensor->GetAlignedSize(),
+                                            static_cast<size_t>(tensor->type_),
+                                            static_cast<size_t>(tensor->lifelong_value_),
+                                            static_cast<size_t>(tensor->contiguous_), tensor->lifetime_.start_,
+                                            tensor->lifetime_.end_}));
+  };
+  auto hash_tensor_ids = [&hash](const std::vector<SomasTensorPtr> &tensors) {
+    hash = hash_combine(hash, tensors.size());
+    for (const auto &tensor : tensors) {
+      MS_EXCEPTION_IF_NULL(tensor);
+      hash = hash_combine(hash, tensor->GetId());
+    }
+  };
+  auto hash_lists = [&hash](const std::vector<vector<size_t>> &lists) {
+    hash = hash_combine(hash, lists.size());
+    for (const auto &list : lists) {
+      hash = hash_combine(hash, list.size());
+      for (auto item : list) {
+        hash = hash_combine(hash, item);
+      }
+    }
+  };
+
+  std::for_each(tensors_list_.begin(), tensors_list_.end(), hash_tensor);
+  std::for_each(control_tensors_list_.begin(), control_tensors_list_.end(), hash_tensor);
+  for (const auto &node : nodes_list_) {
+    MS_EXCEPTION_IF_NULL(node);
+    hash = hash_combine(hash, hash_combine({node->GetId(), static_cast<size_t>(node->GetType()), node->GetStreamId()}));
+    hash_tensor_ids(node->input_tensors_);
+    hash_tensor_ids(node->output_tensors_);
+    hash_tensor_ids(node->workspace_tensors_);
+    hash_tensor_ids(node->control_input_tensors_);
+    hash_tensor_ids(node->control_output_tensors_);
+    for (const auto &[input_index, parameter] : node->input_parameters_map_) {
+      MS_EXCEPTION_IF_NULL(parameter);
+      hash = hash_combine(hash, hash_combine({input_index, parameter->id_, parameter->size_}));
+    }
+  }
+  hash_lists(union_tensors_list_);
+  hash_lists(contiguous_tensors_list_);
+  hash_lists(processed_contiguous_tensors_list_);
+  std::vector<vector<size_t>> stream_groups;
+  (void)std::transform(streams_groups_.begin(), streams_groups_.end(), std::back_inserter(stream_groups),
+                       [](const vector<uint32_t> &group) { return vector<size_t>(group.begin(), group.end()); });
+  hash_lists(stream_groups);
+
+  std::ostringstream oss;
+  oss << std::hex << std::setw(sizeof(size_t) * 2) << std::setfill('0') << hash;
+  hash_id_ = oss.str();
   MS_LOG(INFO) << "Graph " << graph.graph_id() << "'s SOMAS Model hash id is " << hash_id_;
-  std::string filename = Common::GetCompilerCachePath() + "/somas_meta/somas_graph_" +
-                         std::to_string(graph.graph_id()) + "_" + hash_id_ + ".info";
-  return Common::SaveStringToFile(filename, model_str);
+  return true;
 }
 
 void Somas::SaveSomasResult(const session::KernelGraph &graph) {
   nlohmann::json somas_json;
+  somas_json[kVersion] = kSomasCacheVersion;
   somas_json[kGraphId] = graph.graph_id();
   somas_json[kHashId] = hash_id_;
   somas_json[kReused_memory_size] = reused_memory_size_;
@@ -307,9 +371,24 @@ void Somas::SaveSomasResult(const session::KernelGraph &graph) {
   }
   somas_json[kTensors] = tensors_json;
 
-  std::string filename = Common::GetCompilerCachePath() + "/somas_meta/somas_graph_" +
-                         std::to_string(graph.graph_id()) + "_" + hash_id_ + ".json";
-  (void)Common::SaveStringToFile(filename, somas_json.dump());
+  if (save_debug_info_) {
+    (void)Common::SaveStringToFile(GetSomasCacheFile(".info"), SomasInfo(true));
+  }
+  // Several ranks or processes may share the cache, so write it aside and rename it into place: a reader sees either
+  // no result or a whole one.
+  std::string filename = GetSomasCacheFile(".json");
+  std::string temp_filename = filename + "." + std::to_string(std::random_device()()) + ".tmp";
+  if (!Common::SaveStringToFile(temp_filename, somas_json.dump())) {
+    MS_LOG(WARNING) << "Save Somas Cache file " << filename << " failed.";
+    return;
+  }
+  if (rename(temp_filename.c_str(), filename.c_str()) != 0) {
+    MS_LOG(WARNING) << "Rename Somas Cache file " << temp_filename << " to " << filename
+                    << " failed: " << ErrnoToString(errno);
+    (void)remove(temp_filename.c_str());
+    return;
+  }
+  MS_LOG(INFO) << "Save Somas Cache file " << filename << " Successfully.";
 }
 
 void Somas::UpdateSomasResultToGraph(const session::KernelGraph &graph) {
@@ -385,41 +464,51 @@ bool Somas::LoadSomasResult(const string &filename) {
     MS_LOG(INFO) << "Open json file: " << filename << " error, Somas Cache Missed.";
     return false;
   }
-  nlohmann::json somas_json;
+  // A corrupt or unreadable result is a cache miss, the model is solved again.
   try {
-    somas_json_fs >> somas_json;
-    somas_json_fs.close();
-  } catch (std::exception &e) {
-    MS_LOG(INFO) << "Parse json file error: " << filename << ", sleep 500ms and retry again.";
-    somas_json_fs.close();
-    std::this_thread::sleep_for(std::chrono::milliseconds(kRetryIntervalMilliSeconds));
-    std::ifstream retry_tmp(filename);
-    if (!retry_tmp.is_open()) {
-      MS_LOG(INFO) << "Open json file: " << filename << " error, please check kernel_meta.";
-      return false;
+    nlohmann::json somas_json;
+    try {
+      somas_json_fs >> somas_json;
+      somas_json_fs.close();
+    } catch (std::exception &e) {
+      MS_LOG(INFO) << "Parse json file error: " << filename << ", sleep 500ms and retry again.";
+      somas_json_fs.close();
+      std::this_thread::sleep_for(std::chrono::milliseconds(kRetryIntervalMilliSeconds));
+      std::ifstream retry_tmp(filename);
+      if (!retry_tmp.is_open()) {
+        MS_LOG(INFO) << "Open json file: " << filename << " error, please check kernel_meta.";
+        return false;
+      }
+      retry_tmp >> somas_json;
+      retry_tmp.close();
     }
-    retry_tmp >> somas_json;
-    retry_tmp.close();
-  }
 
-  auto ret = VerifySomasResult(somas_json);
-  if (!ret) {
-    MS_LOG(WARNING) << "Verify Somas Result Failed.";
+    auto ret = VerifySomasResult(somas_json);
+    if (!ret) {
+      MS_LOG(WARNING) << "Verify Somas Result Failed.";
+      return false;
+    }
+    reused_memory_size_ = somas_json.at(kReused_memory_size);
+    return UpdateTensorsOffset(somas_json.at(kTensors));
+  } catch (std::exception &e) {
+    MS_LOG(WARNING) << "Load Somas Cache file " << filename << " failed: " << e.what() << ", Somas Cache Missed.";
     return false;
   }
-  reused_memory_size_ = somas_json[kReused_memory_size];
-  ret = UpdateTensorsOffset(somas_json[kTensors]);
-  return ret;
 }
 
 bool Somas::VerifySomasResult(const nlohmann::json &somas_json) const {
-  const auto &hash_id = somas_json[kHashId];
-  const auto &node_size = somas_json[kNodeSize];
-  const auto &tensor_size = somas_json[kTensorSize];
-  const auto &contiguous_size = somas_json[kContiguousSize];
-  const auto &ref_node_size = somas_json[kRefNodeSize];
-  const auto &stream_size = somas_json[kStreamSize];
-  const auto &stream_group_size = somas_json[kStreamGroupSize];
+  const auto version = somas_json.value(kVersion, size_t(0));
+  if (version != kSomasCacheVersion) {
+    MS_LOG(WARNING) << "Mismatch cache version " << version << " vs " << kSomasCacheVersion;
+    return false;
+  }
+  const auto &hash_id = somas_json.at(kHashId);
+  const auto &node_size = somas_json.at(kNodeSize);
+  const auto &tensor_size = somas_json.at(kTensorSize);
+  const auto &contiguous_size = somas_json.at(kContiguousSize);
+  const auto &ref_node_size = somas_json.at(kRefNodeSize);
+  const auto &stream_size = somas_json.at(kStreamSize);
+  const auto &stream_group_size = somas_json.at(kStreamGroupSize);
 
   if (hash_id != hash_id_) {
     MS_LOG(WARNING) << "Mismatch hash id " << hash_id << " vs " << hash_id_;
@@ -456,19 +545,35 @@ bool Somas::VerifySomasResult(const nlohmann::json &somas_json) const {
     return false;
   }
 
-  const auto &tensors_json = somas_json[kTensors];
+  // The sizes were checked by the hash id, the cached ones are the sizes the solver assigned, which differ for union
+  // tensors. Check the plan itself: every tensor is placed exactly once and inside the reused memory.
+  const size_t reused_memory_size = somas_json.at(kReused_memory_size);
+  std::vector<bool> placed(tensors_list_.size(), false);
+  const auto &tensors_json = somas_json.at(kTensors);
+  if (tensors_json.size() != tensors_list_.size()) {
+    MS_LOG(WARNING) << "Mismatch tensor result size " << tensors_json.size() << " vs " << tensors_list_.size();
+    return false;
+  }
   for (const auto &tensor_json : tensors_json) {
-    const auto &tensor_id = tensor_json[kTensorId];
-    const auto &size = tensor_json[kSize];
-    const auto &ori_size = tensor_json[kOriSize];
-    const auto &lifelong_value = tensor_json[kLifelongValue];
-    const auto &life_start = tensor_json[kLifeStart];
-    const auto &life_end = tensor_json[kLifeEnd];
+    const auto &tensor_id = tensor_json.at(kTensorId);
+    const size_t size = tensor_json.at(kSize);
+    const size_t offset = tensor_json.at(kOffset);
+    const auto &ori_size = tensor_json.at(kOriSize);
+    const auto &lifelong_value = tensor_json.at(kLifelongValue);
+    const auto &life_start = tensor_json.at(kLifeStart);
+    const auto &life_end = tensor_json.at(kLifeEnd);
     if (tensor_id < tensors_list_.size()) {
       auto &tensor = tensors_list_[tensor_id];
       MS_EXCEPTION_IF_NULL(tensor);
-      if (size != tensor->aligned_size_) {
-        MS_LOG(WARNING) << "Mismatch size of tensor " << tensor_id << " " << size << " vs " << tensor->aligned_size_;
+      if (placed[tensor_id]) {
+        MS_LOG(WARNING) << "Duplicate result of tensor " << tensor_id;
+        return false;
+      }
+      placed[tensor_id] = true;
+
+      if (size > 0 && (offset > reused_memory_size || size > reused_memory_size - offset)) {
+        MS_LOG(WARNING) << "Tensor " << tensor_id << " at offset " << offset << " with size " << size
+                        << " is out of the reused memory size " << reused_memory_size;
         return false;
       }
 
@@ -507,9 +612,9 @@ bool Somas::VerifySomasResult(const nlohmann::json &somas_json) const {
 bool Somas::UpdateTensorsOffset(const std::vector<nlohmann::json> &tensors_json) {
   bool ret = true;
   for (auto &tensor_json : tensors_json) {
-    const auto &tensor_id = tensor_json[kTensorId];
-    const auto &size = tensor_json[kSize];
-    const auto &offset = tensor_json[kOffset];
+    const auto &tensor_id = tensor_json.at(kTensorId);
+    const auto &size = tensor_json.at(kSize);
+    const auto &offset = tensor_json.at(kOffset);
     auto &tensor = tensors_list_[tensor_id];
     MS_EXCEPTION_IF_NULL(tensor);
     // update memory offset
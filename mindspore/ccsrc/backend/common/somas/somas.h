@@ -205,14 +205,6 @@ class BACKEND_EXPORT Somas {
   void UpdateUnionTensorsOffset();
   void UpdateContiguousTensorsOffset(const std::map<size_t, size_t> &contiguous_ref_list_map);
 
-  // cache
-  void SaveSomasResult(const session::KernelGraph &graph);
-  bool VerifySomasResult(const nlohmann::json &somas_json) const;
-  bool LoadSomasResult(const string &filename);
-  bool UpdateTensorsOffset(const std::vector<nlohmann::json> &tensors_json);
-  bool CalcSomasModelHash(const session::KernelGraph &graph);
-  bool LoadSomasCache(const session::KernelGraph &graph);
-
   // log
   std::string Offline() const;
   void DumpOfflineIR(const string &filename) const;
@@ -248,6 +240,15 @@ class BACKEND_EXPORT Somas {
   SomasNodePtr GetSomasNode(size_t node_id) const;
   static std::string GetSplitName(const string &scope_name);
 
+  // cache
+  void SaveSomasResult(const session::KernelGraph &graph);
+  bool VerifySomasResult(const nlohmann::json &somas_json) const;
+  bool LoadSomasResult(const string &filename);
+  bool UpdateTensorsOffset(const std::vector<nlohmann::json> &tensors_json);
+  bool CalcSomasModelHash(const session::KernelGraph &graph);
+  std::string GetSomasCacheFile(const std::string &suffix) const;
+  bool LoadSomasCache(const session::KernelGraph &graph);
+
   size_t reused_memory_size_{0};
   std::vector<std::pair<size_t, size_t>> dump_merged_blocks_;
 };
@@ -15,9 +15,13 @@
  */
 
 #include "include/common/profiler.h"
+#include <chrono>
 #include <functional>
 #include <iomanip>
 #include <utility>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 #include "utils/file_utils.h"
 #include "include/common/debug/common.h"
 
@@ -38,6 +42,17 @@ static const char kJsonPhX[] = "X";
 static const char kEnableRuntimeProfiler[] = "MS_ENABLE_RUNTIME_PROFILER";
 static const char kRuntimeProfilerTopNum[] = "MS_ENABLE_PROFILER_TOP_NUM";
 
+// The env of runtime trace.
+static const char kEnableRuntimeTrace[] = "MS_ENABLE_RUNTIME_TRACE";
+static const char kRuntimeTraceFlushInterval[] = "MS_RUNTIME_TRACE_FLUSH_INTERVAL";
+static const size_t kDefaultTraceFlushInterval = 1000;
+// The records of a thread, 1.5MB per thread.
+static const size_t kTraceBufferSize = 1 << 16;
+static const uint16_t kStageModule = UINT16_MAX;
+static const char kTraceFileName[] = "RuntimeTrace";
+// The minimum time in milliseconds the ticks are measured against steady_clock.
+static const uint64_t kTraceCalibrationTime = 100;
+
 // Save file name.
 static const char kJsonFileName[] = "RuntimeProfilerJson";
 static const char kSummaryInfoFileName[] = "RuntimeProfilerSummary";
@@ -113,6 +128,13 @@ std::string GetRealPathName(const std::string &name) {
 ProfilerRecorder::ProfilerRecorder(ProfilerModule module, ProfilerEvent event, const std::string &op_name,
                                    bool is_inner_event) {
   if (!ProfilerAnalyzer::GetInstance().profiler_enable()) {
+    auto &tracer = RuntimeTracer::GetInstance();
+    if (tracer.enable()) {
+      trace_module_ = module;
+      trace_event_ = event;
+      trace_name_id_ = tracer.InternName(op_name);
+      trace_start_ticks_ = RuntimeTracer::GetTicks();
+    }
     return;
   }
   data_ = std::make_unique<Data>(module, event, ProfilerAnalyzer::GetInstance().GetBriefName(op_name),
@@ -121,6 +143,10 @@ ProfilerRecorder::ProfilerRecorder(ProfilerModule module, ProfilerEvent event, c
 
 ProfilerRecorder::~ProfilerRecorder() {
   if (!ProfilerAnalyzer::GetInstance().profiler_enable()) {
+    if (trace_start_ticks_ != 0) {
+      RuntimeTracer::GetInstance().Record(trace_module_, trace_event_, trace_name_id_, trace_start_ticks_,
+                                          RuntimeTracer::GetTicks());
+    }
     return;
   }
   if (data_ == nullptr) {
@@ -133,6 +159,10 @@ ProfilerRecorder::~ProfilerRecorder() {
 
 ProfilerStageRecorder::ProfilerStageRecorder(ProfilerStage stage) {
   if (!ProfilerAnalyzer::GetInstance().profiler_enable()) {
+    if (RuntimeTracer::GetInstance().enable()) {
+      start_time_ = RuntimeTracer::GetTicks();
+      stage_ = stage;
+    }
     return;
   }
   start_time_ = ProfilerAnalyzer::GetInstance().GetTimeStamp();
@@ -141,12 +171,341 @@ ProfilerStageRecorder::ProfilerStageRecorder(ProfilerStage stage) {
 
 ProfilerStageRecorder::~ProfilerStageRecorder() {
   if (!ProfilerAnalyzer::GetInstance().profiler_enable()) {
+    if (start_time_ != 0) {
+      RuntimeTracer::GetInstance().RecordStage(stage_, start_time_, RuntimeTracer::GetTicks());
+    }
     return;
   }
   ProfilerAnalyzer::GetInstance().RecordData(
     std::make_shared<runtime::ProfilerData>(stage_, start_time_, ProfilerAnalyzer::GetInstance().GetTimeStamp()));
 }
 
+namespace {
+uint64_t GetSteadyTimeUs() {
+  auto now_time = std::chrono::steady_clock::now();
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::microseconds>(now_time.time_since_epoch()).count());
+}
+
+uint64_t GetSteadyTimeNs() {
+  auto now_time = std::chrono::steady_clock::now();
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(now_time.time_since_epoch()).count());
+}
+
+// Append a string to a json string literal.
+void AppendJsonString(const std::string &str, std::string *out) {
+  for (auto c : str) {
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (static_cast<unsigned char>(c) >= ' ') {
+      out->push_back(c);
+    }
+  }
+}
+}  // namespace
+
+RuntimeTracer::ThreadBuffer::ThreadBuffer() : records_(std::make_unique<TraceRecord[]>(kTraceBufferSize)) {}
+
+RuntimeTracer &RuntimeTracer::GetInstance() noexcept {
+  static RuntimeTracer instance{};
+  return instance;
+}
+
+RuntimeTracer::RuntimeTracer() {
+  (void)names_.emplace_back();
+  // The runtime profiler records its own timestamps with the same macros, the trace is off when it is on.
+  if (common::GetEnv(kEnableRuntimeTrace) != "1" || common::GetEnv(kEnableRuntimeProfiler) == "1") {
+    return;
+  }
+  size_t flush_interval = kDefaultTraceFlushInterval;
+  auto interval_env = common::GetEnv(kRuntimeTraceFlushInterval);
+  if (!interval_env.empty()) {
+    try {
+      flush_interval = std::stoul(interval_env);
+    } catch (const std::exception &e) {
+      MS_LOG(ERROR) << "Invalid argument: " << e.what() << " when parse " << interval_env << ", use default "
+                    << kDefaultTraceFlushInterval << "ms.";
+    }
+  }
+  Enable(GetRealPathName(kTraceFileName + std::to_string(getpid()) + "_" + std::to_string(GetSteadyTimeUs()) +
+                         ".json"),
+         flush_interval);
+}
+
+RuntimeTracer::~RuntimeTracer() { Disable(); }
+
+void RuntimeTracer::Enable(const std::string &file_name, size_t flush_interval) {
+  std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+  if (enable()) {
+    MS_LOG(WARNING) << "Runtime trace is already enabled, file: " << file_name_;
+    return;
+  }
+  file_name_ = file_name;
+  file_ = std::fopen(file_name_.c_str(), "w");
+  if (file_ == nullptr) {
+    MS_LOG(ERROR) << "Open file [" << file_name_ << "] failed, the runtime trace is disabled.";
+    return;
+  }
+  // The trailing ']' of the json array is optional for the trace viewers, so the file is valid after every flush.
+  (void)std::fputs("[\n", file_);
+  flush_interval_ = flush_interval;
+  pid_ = getpid();
+  base_ticks_ = GetTicks();
+  base_time_ns_ = GetSteadyTimeNs();
+  ticks_per_us_ = 0;
+  stop_ = false;
+  enable_ = true;
+  flush_thread_ = std::thread(&RuntimeTracer::FlushLoop, this);
+  MS_LOG(INFO) << "Runtime trace is enabled, file: " << file_name_;
+}
+
+void RuntimeTracer::Disable() {
+  if (!enable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+    stop_ = true;
+  }
+  flush_cond_.notify_all();
+  if (flush_thread_.joinable()) {
+    flush_thread_.join();
+  }
+  Flush();
+  std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+  enable_ = false;
+  (void)std::fclose(file_);
+  file_ = nullptr;
+  ChangeFileMode(file_name_, S_IRUSR);
+}
+
+uint64_t RuntimeTracer::GetTicks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+RuntimeTracer::ThreadBuffer *RuntimeTracer::GetThreadBuffer() {
+  // Hands the buffer back when the thread exits, so short-lived threads do not keep one each.
+  struct ThreadBufferHolder {
+    ~ThreadBufferHolder() {
+      if (buffer_ != nullptr) {
+        buffer_->retired_.store(true, std::memory_order_release);
+      }
+    }
+    ThreadBuffer *buffer_{nullptr};
+  };
+  static thread_local ThreadBufferHolder holder;
+  if (holder.buffer_ == nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ThreadBufferPtr buffer = nullptr;
+    if (free_buffers_.empty()) {
+      buffer = std::make_shared<ThreadBuffer>();
+    } else {
+      buffer = free_buffers_.back();
+      free_buffers_.pop_back();
+      buffer->head_.store(0, std::memory_order_relaxed);
+      buffer->tail_.store(0, std::memory_order_relaxed);
+      buffer->dropped_.store(0, std::memory_order_relaxed);
+      buffer->retired_.store(false, std::memory_order_relaxed);
+    }
+    buffer->tid_ = next_tid_++;
+    buffer->name_ = "Thread" + std::to_string(buffer->tid_);
+    buffer->name_dumped_ = false;
+    (void)buffers_.emplace_back(buffer);
+    holder.buffer_ = buffer.get();
+  }
+  return holder.buffer_;
+}
+
+size_t RuntimeTracer::buffer_num() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return buffers_.size() + free_buffers_.size();
+}
+
+uint32_t RuntimeTracer::InternName(const std::string &op_name) {
+  auto buffer = GetThreadBuffer();
+  auto iter = buffer->name_cache_.find(op_name);
+  if (iter != buffer->name_cache_.end()) {
+    return iter->second;
+  }
+  uint32_t name_id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto global_iter = name_ids_.find(op_name);
+    if (global_iter != name_ids_.end()) {
+      name_id = global_iter->second;
+    } else {
+      name_id = static_cast<uint32_t>(names_.size());
+      (void)names_.emplace_back(ProfilerAnalyzer::GetInstance().GetBriefName(op_name));
+      (void)name_ids_.emplace(op_name, name_id);
+    }
+  }
+  (void)buffer->name_cache_.emplace(op_name, name_id);
+  return name_id;
+}
+
+void RuntimeTracer::Push(const TraceRecord &record) noexcept {
+  auto buffer = GetThreadBuffer();
+  auto head = buffer->head_.load(std::memory_order_relaxed);
+  if (head - buffer->tail_.load(std::memory_order_acquire) >= kTraceBufferSize) {
+    // Drop the event rather than wait for the flush.
+    (void)buffer->dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer->records_[head % kTraceBufferSize] = record;
+  buffer->head_.store(head + 1, std::memory_order_release);
+}
+
+void RuntimeTracer::Record(ProfilerModule module, ProfilerEvent event, uint32_t name_id, uint64_t start_ticks,
+                           uint64_t end_ticks) noexcept {
+  Push({start_ticks, end_ticks, name_id, static_cast<uint16_t>(module), static_cast<uint16_t>(event)});
+}
+
+void RuntimeTracer::RecordStage(ProfilerStage stage, uint64_t start_ticks, uint64_t end_ticks) noexcept {
+  Push({start_ticks, end_ticks, 0, kStageModule, static_cast<uint16_t>(stage)});
+}
+
+void RuntimeTracer::SetThreadName(const std::string &name) {
+  auto buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffer->name_ = name;
+  buffer->name_dumped_ = false;
+}
+
+void RuntimeTracer::FlushLoop() {
+  std::unique_lock<std::mutex> lock(flush_mutex_);
+  CalibrateTicks();
+  while (!stop_) {
+    (void)flush_cond_.wait_for(lock, std::chrono::milliseconds(flush_interval_), [this]() { return stop_; });
+    if (stop_) {
+      break;
+    }
+    lock.unlock();
+    Flush();
+    lock.lock();
+  }
+}
+
+void RuntimeTracer::CalibrateTicks() {
+  if (ticks_per_us_ != 0) {
+    return;
+  }
+  // Measure the tick rate once over a window long enough for the clock reads to be negligible, every flush of the
+  // run then converts the ticks the same way.
+  const uint64_t calibration_ns = kTraceCalibrationTime * 1000000;
+  const auto elapsed_ns = GetSteadyTimeNs() - base_time_ns_;
+  if (elapsed_ns < calibration_ns) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(calibration_ns - elapsed_ns));
+  }
+  const auto now_ticks = GetTicks();
+  const auto now_time_ns = GetSteadyTimeNs();
+  ticks_per_us_ = 1.0;
+  if (now_time_ns > base_time_ns_ && now_ticks > base_ticks_) {
+    constexpr double kNsPerUs = 1000.0;
+    ticks_per_us_ =
+      static_cast<double>(now_ticks - base_ticks_) * kNsPerUs / static_cast<double>(now_time_ns - base_time_ns_);
+  }
+  MS_LOG(INFO) << "Runtime trace ticks per us: " << ticks_per_us_;
+}
+
+void RuntimeTracer::DumpRecord(const TraceRecord &record, uint32_t tid, std::string *out) const {
+  constexpr double kNsPerUs = 1000.0;
+  const auto start_time = static_cast<double>(base_time_ns_) / kNsPerUs +
+                          static_cast<double>(record.start_ticks_ - base_ticks_) / ticks_per_us_;
+  const auto dur_time = static_cast<double>(record.end_ticks_ - record.start_ticks_) / ticks_per_us_;
+  out->append("{\"name\":\"");
+  if (record.module_ == kStageModule) {
+    out->append(kProfilerStageString.at(static_cast<ProfilerStage>(record.event_)));
+    out->append("\",\"cat\":\"Stage");
+  } else {
+    const auto &module_name = kProfilerModuleString.at(static_cast<ProfilerModule>(record.module_));
+    out->append(module_name);
+    out->append("::");
+    out->append(kProfilerEventString.at(static_cast<ProfilerEvent>(record.event_)));
+    out->append("::");
+    AppendJsonString(flush_names_[record.name_id_], out);
+    out->append("\",\"cat\":\"");
+    out->append(module_name);
+  }
+  constexpr size_t kNumberSize = 128;
+  char numbers[kNumberSize];
+  (void)snprintf(numbers, kNumberSize, "\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f},\n", pid_, tid,
+                 start_time, dur_time);
+  out->append(numbers);
+}
+
+void RuntimeTracer::Flush() {
+  if (!enable()) {
+    return;
+  }
+  std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+  if (file_ == nullptr) {
+    return;
+  }
+  CalibrateTicks();
+
+  // Copy the records out under the lock and format them after it is released, so the threads registering buffers
+  // or interning names do not wait for the formatting and the file write.
+  std::vector<std::pair<uint32_t, TraceRecord>> records;
+  std::vector<std::pair<std::string, uint64_t>> dropped_threads;
+  std::string out;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = flush_names_.size(); i < names_.size(); ++i) {
+      (void)flush_names_.emplace_back(names_[i]);
+    }
+    std::vector<ThreadBufferPtr> live_buffers;
+    for (const auto &buffer : buffers_) {
+      if (!buffer->name_dumped_) {
+        out.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + std::to_string(pid_) +
+                   ",\"tid\":" + std::to_string(buffer->tid_) + ",\"args\":{\"name\":\"");
+        AppendJsonString(buffer->name_, &out);
+        out.append("\"}},\n");
+        buffer->name_dumped_ = true;
+      }
+      // A retired buffer gets no more records, it is drained by this copy.
+      const auto retired = buffer->retired_.load(std::memory_order_acquire);
+      const auto head = buffer->head_.load(std::memory_order_acquire);
+      const auto tail = buffer->tail_.load(std::memory_order_relaxed);
+      for (auto index = tail; index < head; ++index) {
+        (void)records.emplace_back(buffer->tid_, buffer->records_[index % kTraceBufferSize]);
+      }
+      buffer->tail_.store(head, std::memory_order_release);
+      auto dropped = buffer->dropped_.exchange(0, std::memory_order_relaxed);
+      if (dropped != 0) {
+        (void)dropped_threads.emplace_back(buffer->name_, dropped);
+      }
+      if (retired) {
+        (void)free_buffers_.emplace_back(buffer);
+      } else {
+        (void)live_buffers.emplace_back(buffer);
+      }
+    }
+    buffers_.swap(live_buffers);
+  }
+
+  for (const auto &[thread_name, dropped] : dropped_threads) {
+    MS_LOG(WARNING) << "Runtime trace dropped " << dropped << " events of thread " << thread_name
+                    << ", decrease MS_RUNTIME_TRACE_FLUSH_INTERVAL to flush more often.";
+  }
+  for (const auto &[tid, record] : records) {
+    DumpRecord(record, tid, &out);
+  }
+  if (!out.empty() && std::fwrite(out.data(), 1, out.size(), file_) != out.size()) {
+    MS_LOG(ERROR) << "Write runtime trace file [" << file_name_ << "] failed.";
+  }
+  (void)std::fflush(file_);
+}
+
 ProfilerAnalyzer &ProfilerAnalyzer::GetInstance() noexcept {
   static ProfilerAnalyzer instance{};
   return instance;
@@ -189,6 +548,9 @@ std::string ProfilerAnalyzer::GetTidString(const std::thread::id &tid) const {
 }
 
 void ProfilerAnalyzer::SetThreadIdToName(const std::thread::id &id, const std::string &name) {
+  if (id == std::this_thread::get_id() && RuntimeTracer::GetInstance().enable()) {
+    RuntimeTracer::GetInstance().SetThreadName(name);
+  }
   std::unique_lock<std::mutex> lock(data_mutex_);
   thread_id_to_name_[id] = name;
 }
@@ -0,0 +1,433 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "include/backend/debug/data_dump/async_dump_writer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include "ir/tensor.h"
+#include "utils/log_adapter.h"
+#include "utils/convert_utils_base.h"
+#include "utils/file_utils.h"
+#include "include/common/debug/common.h"
+#include "include/backend/debug/tensor_data.h"
+#include "include/backend/debug/data_dump/dump_json_parser.h"
+#include "include/backend/debug/data_dump/tensor_stat_dump.h"
+#include "debug/data_dump/npy_header.h"
+
+namespace mindspore {
+namespace {
+constexpr auto kNpySuffix = ".npy";
+constexpr auto kNpyLz4Suffix = ".npy.lz4";
+constexpr auto kInput = "input";
+constexpr auto kOutput = "output";
+// Fields of the dump file name after the op name: task_id, stream_id, timestamp, io, slot and format.
+constexpr size_t kFileNameSuffixFieldNum = 6;
+
+// The lz4 frame holds independent blocks of at most 4MB, without block or content checksums.
+constexpr uint32_t kLz4FrameMagic = 0x184D2204U;
+constexpr uint8_t kLz4FrameFlag = 0x60;
+constexpr uint8_t kLz4BlockDescriptor = 0x70;
+constexpr size_t kLz4BlockSize = 4 * kMBToByte;
+constexpr uint32_t kLz4UncompressedBlock = 0x80000000U;
+constexpr size_t kLz4MinMatch = 4;
+constexpr size_t kLz4LastLiterals = 5;
+constexpr size_t kLz4MatchFindLimit = 12;
+constexpr size_t kLz4MaxOffset = 65535;
+constexpr size_t kLz4HashBits = 16;
+constexpr uint32_t kLz4LengthMask = 15;
+constexpr uint32_t kLz4TokenShift = 4;
+constexpr size_t kLz4LengthByteMax = 255;
+
+constexpr uint32_t kXXH32Prime1 = 2654435761U;
+constexpr uint32_t kXXH32Prime2 = 2246822519U;
+constexpr uint32_t kXXH32Prime3 = 3266489917U;
+constexpr uint32_t kXXH32Prime4 = 668265263U;
+constexpr uint32_t kXXH32Prime5 = 374761393U;
+
+inline uint32_t Read32(const uint8_t *data) {
+  uint32_t value;
+  (void)memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+inline uint32_t RotateLeft(uint32_t value, uint32_t shift) { return (value << shift) | (value >> (32 - shift)); }
+
+void AppendLE32(uint32_t value, std::string *output) {
+  constexpr uint32_t kByteBits = 8;
+  constexpr uint32_t kByteMask = 0xFF;
+  for (size_t i = 0; i < sizeof(value); ++i) {
+    output->push_back(static_cast<char>((value >> (i * kByteBits)) & kByteMask));
+  }
+}
+
+// xxh32 of an input shorter than 16 bytes, the frame header checksum is its second byte.
+uint32_t SmallXXH32(const uint8_t *data, size_t len) {
+  uint32_t hash = kXXH32Prime5 + static_cast<uint32_t>(len);
+  size_t i = 0;
+  for (; i + sizeof(uint32_t) <= len; i += sizeof(uint32_t)) {
+    hash += Read32(data + i) * kXXH32Prime3;
+    hash = RotateLeft(hash, 17) * kXXH32Prime4;
+  }
+  for (; i < len; ++i) {
+    hash += data[i] * kXXH32Prime5;
+    hash = RotateLeft(hash, 11) * kXXH32Prime1;
+  }
+  hash ^= hash >> 15;
+  hash *= kXXH32Prime2;
+  hash ^= hash >> 13;
+  hash *= kXXH32Prime3;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+void AppendLz4Length(size_t length, std::string *output) {
+  for (; length >= kLz4LengthByteMax; length -= kLz4LengthByteMax) {
+    output->push_back(static_cast<char>(kLz4LengthByteMax));
+  }
+  output->push_back(static_cast<char>(length));
+}
+
+// A sequence is the token, the literals and then the offset and length of the match, if any.
+void AppendLz4Sequence(const uint8_t *literals, size_t literal_len, size_t offset, size_t match_len,
+                       std::string *output) {
+  size_t token_match_len = (match_len == 0 ? 0 : match_len - kLz4MinMatch);
+  auto token = (std::min<size_t>(literal_len, kLz4LengthMask) << kLz4TokenShift) |
+               std::min<size_t>(token_match_len, kLz4LengthMask);
+  output->push_back(static_cast<char>(token));
+  if (literal_len >= kLz4LengthMask) {
+    AppendLz4Length(literal_len - kLz4LengthMask, output);
+  }
+  (void)output->append(reinterpret_cast<const char *>(literals), literal_len);
+  if (match_len == 0) {
+    return;
+  }
+  constexpr size_t kByteBits = 8;
+  output->push_back(static_cast<char>(offset & kLz4LengthByteMax));
+  output->push_back(static_cast<char>(offset >> kByteBits));
+  if (token_match_len >= kLz4LengthMask) {
+    AppendLz4Length(token_match_len - kLz4LengthMask, output);
+  }
+}
+
+// Greedy lz4 block compression with a single entry hash table of the last position of every 4 bytes sequence.
+void CompressLz4Block(const uint8_t *src, size_t size, std::vector<uint32_t> *table, std::string *output) {
+  std::fill(table->begin(), table->end(), 0);
+  size_t anchor = 0;
+  if (size > kLz4MatchFindLimit) {
+    // The last match starts 12 bytes before the end of the block and the last 5 bytes are literals.
+    const size_t match_find_limit = size - kLz4MatchFindLimit;
+    const size_t match_end_limit = size - kLz4LastLiterals;
+    size_t pos = 0;
+    while (pos < match_find_limit) {
+      auto sequence = Read32(src + pos);
+      auto hash = (sequence * kXXH32Prime1) >> (32 - kLz4HashBits);
+      size_t candidate = (*table)[hash];
+      (*table)[hash] = static_cast<uint32_t>(pos);
+      if (candidate >= pos || pos - candidate > kLz4MaxOffset || Read32(src + candidate) != sequence) {
+        ++pos;
+        continue;
+      }
+      size_t match_len = kLz4MinMatch;
+      while (pos + match_len < match_end_limit && src[candidate + match_len] == src[pos + match_len]) {
+        ++match_len;
+      }
+      AppendLz4Sequence(src + anchor, pos - anchor, pos - candidate, match_len, output);
+      pos += match_len;
+      anchor = pos;
+    }
+  }
+  AppendLz4Sequence(src + anchor, size - anchor, 0, 0, output);
+}
+
+bool IsNumber(const std::string &field) {
+  return !field.empty() && std::all_of(field.begin(), field.end(), [](char c) { return std::isdigit(c) != 0; });
+}
+}  // namespace
+
+AsyncDumpWriter::AsyncDumpWriter(size_t thread_num, size_t staging_size, bool compress)
+    : staging_size_(staging_size), compress_(compress) {
+  for (size_t i = 0; i < std::max<size_t>(thread_num, 1); ++i) {
+    (void)workers_.emplace_back(&AsyncDumpWriter::WorkerLoop, this);
+  }
+}
+
+AsyncDumpWriter::~AsyncDumpWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  task_cond_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+AsyncDumpWriter *AsyncDumpWriter::GetInstance() {
+  std::call_once(instance_flag_, []() {
+    auto &dump_json_parser = DumpJsonParser::GetInstance();
+    if (!dump_json_parser.async_write()) {
+      return;
+    }
+    MS_LOG(INFO) << "Write the e2e dump files in the background, staging size " << dump_json_parser.staging_size()
+                 << "MB, lz4 compression " << dump_json_parser.lz4_compression();
+    instance_ = std::make_unique<AsyncDumpWriter>(
+      kDefaultAsyncDumpThreadNum, dump_json_parser.staging_size() * kMBToByte, dump_json_parser.lz4_compression());
+  });
+  return instance_.get();
+}
+
+void AsyncDumpWriter::Finalize() {
+  if (instance_ == nullptr) {
+    return;
+  }
+  instance_->Wait();
+  instance_ = nullptr;
+}
+
+void AsyncDumpWriter::Submit(const std::string &filename, const void *data, size_t len, const ShapeVector &shape,
+                             TypeId type) {
+  if (filename.empty() || data == nullptr || len == 0) {
+    MS_LOG(INFO) << "Skip dumping empty data to file: " << filename;
+    return;
+  }
+  auto task = std::make_unique<DumpTask>();
+  task->filename = filename;
+  task->shape = shape;
+  task->type = type;
+  task->len = len;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task->buffer = AcquireBuffer(len, &task->capacity);
+  }
+  if (task->buffer == nullptr) {
+    // The io threads are behind, dump the statistics only instead of waiting for them.
+    if (degraded_count_++ == 0) {
+      MS_LOG(WARNING) << "The staging buffers of the async dump are full, only the statistics of " << filename
+                      << " and the following tensors that do not fit are dumped. Increase staging_size of "
+                      << "e2e_dump_settings to keep them.";
+    }
+    WriteStat(filename, data, len, shape, type);
+    return;
+  }
+  (void)memcpy(task->buffer.get(), data, len);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  task_cond_.notify_one();
+}
+
+void AsyncDumpWriter::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_cond_.wait(lock, [this]() { return tasks_.empty() && running_tasks_ == 0; });
+}
+
+std::unique_ptr<uint8_t[]> AsyncDumpWriter::AcquireBuffer(size_t len, size_t *capacity) {
+  if (in_use_bytes_ + len > staging_size_) {
+    return nullptr;
+  }
+  // Reuse a free buffer unless it wastes more than its half.
+  auto iter = free_buffers_.lower_bound(len);
+  if (iter != free_buffers_.end() && iter->first / 2 <= len) {
+    *capacity = iter->first;
+    auto buffer = std::move(iter->second);
+    (void)free_buffers_.erase(iter);
+    in_use_bytes_ += *capacity;
+    return buffer;
+  }
+  // Release the smaller free buffers until the new one fits in the staging size.
+  while (staged_bytes_ + len > staging_size_ && !free_buffers_.empty()) {
+    staged_bytes_ -= free_buffers_.begin()->first;
+    (void)free_buffers_.erase(free_buffers_.begin());
+  }
+  std::unique_ptr<uint8_t[]> buffer(new (std::nothrow) uint8_t[len]);
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  *capacity = len;
+  staged_bytes_ += len;
+  in_use_bytes_ += len;
+  return buffer;
+}
+
+void AsyncDumpWriter::ReleaseBuffer(std::unique_ptr<uint8_t[]> buffer, size_t capacity) {
+  in_use_bytes_ -= capacity;
+  (void)free_buffers_.emplace(capacity, std::move(buffer));
+}
+
+void AsyncDumpWriter::WorkerLoop() {
+  while (true) {
+    std::unique_ptr<DumpTask> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_cond_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      ++running_tasks_;
+    }
+    try {
+      Process(task.get());
+    } catch (const std::exception &e) {
+      MS_LOG(ERROR) << "Async dump of " << task->filename << " failed: " << e.what();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (task->buffer != nullptr) {
+      ReleaseBuffer(std::move(task->buffer), task->capacity);
+    }
+    --running_tasks_;
+    if (tasks_.empty() && running_tasks_ == 0) {
+      idle_cond_.notify_all();
+    }
+  }
+}
+
+void AsyncDumpWriter::Process(DumpTask *task) {
+  WriteStat(task->filename, task->buffer.get(), task->len, task->shape, task->type);
+  (void)WriteTensor(*task);
+}
+
+bool AsyncDumpWriter::WriteTensor(const DumpTask &task) {
+  std::string npy_header = GenerateNpyHeader(task.shape, task.type);
+  if (npy_header.empty()) {
+    return false;
+  }
+  auto file_path = DumpJsonParser::GenerateDumpFilePath(task.filename + (compress_ ? kNpyLz4Suffix : kNpySuffix));
+  if (!file_path.has_value()) {
+    return false;
+  }
+  const std::string &file_path_str = file_path.value();
+  MS_LOG(INFO) << "Dump path is " << file_path_str;
+  ChangeFileMode(file_path_str, S_IWUSR);
+  std::ofstream fd(file_path_str, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!fd.is_open()) {
+    MS_LOG(ERROR) << "Open file " << file_path_str << " failed." << ErrnoToString(errno);
+    return false;
+  }
+  if (compress_) {
+    std::string frame;
+    CompressLz4Frame({{npy_header.data(), npy_header.size()}, {task.buffer.get(), task.len}}, &frame);
+    (void)fd.write(frame.data(), SizeToLong(frame.size()));
+  } else {
+    fd << npy_header;
+    (void)fd.write(reinterpret_cast<const char *>(task.buffer.get()), SizeToLong(task.len));
+  }
+  bool success = !fd.bad();
+  fd.close();
+  ChangeFileMode(file_path_str, S_IRUSR);
+  if (!success) {
+    MS_LOG(ERROR) << "Write mem to file " << file_path_str << " failed.";
+  }
+  return success;
+}
+
+void AsyncDumpWriter::WriteStat(const std::string &filename, const void *data, size_t len, const ShapeVector &shape,
+                                TypeId type) {
+  // The file name is op_type.op_name.task_id.stream_id.timestamp.io.slot.format, the name of a parameter may have
+  // dots, so the fields after it are split from the end.
+  auto pos = filename.rfind('/');
+  std::string dump_dir = (pos == std::string::npos ? "." : filename.substr(0, pos));
+  std::string file_name = filename.substr(pos + 1);
+  std::vector<std::string> fields;
+  auto end = file_name.size();
+  while (fields.size() < kFileNameSuffixFieldNum) {
+    auto dot = (end == 0 ? std::string::npos : file_name.rfind('.', end - 1));
+    if (dot == std::string::npos) {
+      break;
+    }
+    (void)fields.emplace_back(file_name.substr(dot + 1, end - dot - 1));
+    end = dot;
+  }
+  auto first_dot = file_name.find('.');
+  if (fields.size() != kFileNameSuffixFieldNum || first_dot >= end) {
+    MS_LOG(WARNING) << "Cannot get the op name from dump file name " << file_name << ", skipping current statistics";
+    return;
+  }
+  const auto &slot = fields[1];
+  const auto &io = fields[2];
+  const auto &timestamp = fields[3];
+  const auto &stream_id = fields[4];
+  const auto &task_id = fields[5];
+  if (!IsNumber(slot) || (io != kInput && io != kOutput)) {
+    MS_LOG(WARNING) << "Invalid io or slot in dump file name " << file_name << ", skipping current statistics";
+    return;
+  }
+  std::string op_type = file_name.substr(0, first_dot);
+  std::string op_name = file_name.substr(first_dot + 1, end - first_dot - 1);
+
+  // The statistics of bfloat16 are computed in float32, the same as the ascend dump.
+  std::shared_ptr<tensor::Tensor> trans_buf = nullptr;
+  if (type == kNumberTypeBFloat16) {
+    auto bfloat16_tensor = std::make_shared<tensor::Tensor>(type, shape, const_cast<void *>(data), len);
+    trans_buf = std::make_shared<tensor::Tensor>(*bfloat16_tensor, kNumberTypeFloat32);
+  }
+  auto tensor_data = std::make_shared<TensorData>();
+  if (trans_buf != nullptr) {
+    tensor_data->SetByteSize(trans_buf->Size());
+    tensor_data->SetDataPtr(static_cast<char *>(trans_buf->data_c()));
+    tensor_data->SetType(kNumberTypeFloat32);
+  } else {
+    tensor_data->SetByteSize(len);
+    tensor_data->SetDataPtr(static_cast<char *>(const_cast<void *>(data)));
+    tensor_data->SetType(type);
+  }
+  tensor_data->SetShape(shape);
+  auto slot_num = std::stoul(slot);
+  TensorStatDump stat_dump(op_type, op_name, task_id, stream_id, timestamp, io, slot_num, slot_num, type);
+  std::lock_guard<std::mutex> lock(stat_mutex_);
+  (void)stat_dump.DumpTensorStatsToFile(dump_dir, tensor_data);
+}
+
+void AsyncDumpWriter::CompressLz4Frame(const std::vector<std::pair<const void *, size_t>> &parts,
+                                       std::string *output) {
+  MS_EXCEPTION_IF_NULL(output);
+  output->clear();
+  AppendLE32(kLz4FrameMagic, output);
+  const uint8_t descriptor[] = {kLz4FrameFlag, kLz4BlockDescriptor};
+  output->push_back(static_cast<char>(kLz4FrameFlag));
+  output->push_back(static_cast<char>(kLz4BlockDescriptor));
+  constexpr uint32_t kHeaderChecksumShift = 8;
+  constexpr uint32_t kByteMask = 0xFF;
+  output->push_back(
+    static_cast<char>((SmallXXH32(descriptor, sizeof(descriptor)) >> kHeaderChecksumShift) & kByteMask));
+
+  std::vector<uint32_t> table(1 << kLz4HashBits);
+  std::string block;
+  for (const auto &[data, len] : parts) {
+    auto src = static_cast<const uint8_t *>(data);
+    for (size_t offset = 0; offset < len; offset += kLz4BlockSize) {
+      size_t size = std::min(kLz4BlockSize, len - offset);
+      block.clear();
+      CompressLz4Block(src + offset, size, &table, &block);
+      if (block.size() < size) {
+        AppendLE32(static_cast<uint32_t>(block.size()), output);
+        (void)output->append(block);
+      } else {
+        AppendLE32(static_cast<uint32_t>(size) | kLz4UncompressedBlock, output);
+        (void)output->append(reinterpret_cast<const char *>(src + offset), size);
+      }
+    }
+  }
+  // End mark.
+  AppendLE32(0, output);
+}
+}  // namespace mindspore
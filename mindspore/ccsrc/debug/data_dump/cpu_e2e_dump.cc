@@ -21,8 +21,22 @@
 #include "include/common/debug/anf_dump_utils.h"
 #include "include/common/debug/common.h"
 #include "mindspore/core/utils/file_utils.h"
+#include "include/backend/debug/data_dump/async_dump_writer.h"
 
 namespace mindspore {
+namespace {
+void DumpAddressToFile(const std::string &file_path, const device::DeviceAddress &addr, const ShapeVector &int_shapes,
+                       TypeId type) {
+  auto async_writer = AsyncDumpWriter::GetInstance();
+  if (async_writer == nullptr) {
+    DumpMemToFile(file_path, addr, int_shapes, type);
+    return;
+  }
+  // The same file name as CPUDeviceAddress::DumpMemToFile, the data is written by the io threads of the writer.
+  async_writer->Submit(file_path + '.' + addr.format(), addr.GetPtr(), addr.GetSize(), int_shapes, type);
+}
+}  // namespace
+
 void CPUE2eDump::DumpCNodeData(const CNodePtr &node, uint32_t graph_id) {
   MS_EXCEPTION_IF_NULL(node);
   auto &dump_json_parser = DumpJsonParser::GetInstance();
@@ -120,7 +134,7 @@ void CPUE2eDump::DumpInputImpl(const CNodePtr &node, const std::string &dump_pat
     std::string file_path = dump_path + '/' + op_type + '.' + op_name + '.' + std::to_string(kTaskId) + '.' +
                             std::to_string(kStreamId) + '.' + std::to_string(timestamp) + ".input." + std::to_string(j);
     MS_EXCEPTION_IF_NULL(addr);
-    DumpMemToFile(file_path, *addr, int_shapes, type);
+    DumpAddressToFile(file_path, *addr, int_shapes, type);
   }
 }
 
@@ -145,7 +159,7 @@ void CPUE2eDump::DumpOutputImpl(const CNodePtr &node, const std::string &dump_pa
     std::string file_path = dump_path + '/' + op_type + '.' + op_name + '.' + std::to_string(kTaskId) + '.' +
                             std::to_string(kStreamId) + '.' + std::to_string(timestamp) + ".output." +
                             std::to_string(j);
-    DumpMemToFile(file_path, *addr, int_shapes, type);
+    DumpAddressToFile(file_path, *addr, int_shapes, type);
   }
 }
 
@@ -190,7 +204,7 @@ void CPUE2eDump::DumpSingleAnfNode(const AnfNodePtr &anf_node, const size_t outp
   const uint32_t kStreamId = 0;
   std::string file_path = dump_path + "/Parameter." + dump_name + '.' + std::to_string(kTaskId) + '.' +
                           std::to_string(kStreamId) + '.' + std::to_string(timestamp) + ".output.0";
-  DumpMemToFile(file_path, *addr, int_shapes, type);
+  DumpAddressToFile(file_path, *addr, int_shapes, type);
 }
 
 void CPUE2eDump::DumpParameters(const session::KernelGraph *graph, uint32_t graph_id) {
@@ -47,6 +47,12 @@ constexpr auto kStatisticDump = "statistic";
 constexpr auto kTensorDump = "tensor";
 constexpr auto kFullDump = "full";
 constexpr auto kFileFormat = "file_format";
+constexpr auto kAsyncWrite = "async_write";
+constexpr auto kCompression = "compression";
+constexpr auto kStagingSize = "staging_size";
+constexpr auto kLz4Compression = "lz4";
+constexpr auto kNoCompression = "none";
+constexpr size_t kDefaultStagingSize = 1024;
 constexpr auto kDumpInputAndOutput = 0;
 constexpr auto kDumpInputOnly = 1;
 constexpr auto kDumpOutputOnly = 2;
@@ -312,14 +318,39 @@ bool DumpJsonParser::DumpToFile(const std::string &filename, const void *data, s
     return false;
   }
   std::string npy_suffix = ".npy";
-  std::string origin_file_path = filename + npy_suffix;
+  auto file_path = GenerateDumpFilePath(filename + npy_suffix);
+  if (!file_path.has_value()) {
+    return false;
+  }
+  const std::string file_path_str = file_path.value();
+  MS_LOG(INFO) << "Dump path is " << file_path_str;
+  ChangeFileMode(file_path_str, S_IWUSR);
+  std::ofstream fd(file_path_str, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!fd.is_open()) {
+    MS_LOG(EXCEPTION) << "Open file " << file_path_str << " failed." << ErrnoToString(errno);
+  }
+  std::string npy_header = GenerateNpyHeader(shape, type);
+  if (!npy_header.empty()) {
+    fd << npy_header;
+    (void)fd.write(reinterpret_cast<const char *>(data), SizeToLong(len));
+    if (fd.bad()) {
+      fd.close();
+      MS_LOG(EXCEPTION) << "Write mem to file " << file_path_str << " failed.";
+    }
+    fd.close();
+    ChangeFileMode(file_path_str, S_IRUSR);
+  }
+  return true;
+}
+
+std::optional<std::string> DumpJsonParser::GenerateDumpFilePath(const std::string &origin_file_path) {
   std::optional<std::string> prefix_path;
   std::optional<std::string> origin_name;
   std::optional<std::string> mapped_name;
   bool need_map = Common::MappingName(origin_file_path, &prefix_path, &origin_name, &mapped_name);
   if (!prefix_path.has_value() || !origin_name.has_value() || !mapped_name.has_value()) {
     MS_LOG(ERROR) << "Cannot get prefix_path or file_name from: " << origin_file_path;
-    return false;
+    return std::nullopt;
   }
   std::string final_file_path = origin_file_path;
   if (need_map) {
@@ -329,7 +360,7 @@ bool DumpJsonParser::DumpToFile(const std::string &filename, const void *data, s
     auto mapping_file = Common::CreatePrefixPath(prefix_path.value() + "/mapping.csv");
     if (!mapping_file.has_value()) {
       MS_LOG(ERROR) << "CreatePrefixPath for mapping.csv failed.";
-      return false;
+      return std::nullopt;
     }
     const std::string mapping_file_str = mapping_file.value();
     // try to open file
@@ -337,7 +368,7 @@ bool DumpJsonParser::DumpToFile(const std::string &filename, const void *data, s
     std::ofstream fout(mapping_file_str, std::ofstream::app);
     if (!fout.is_open()) {
       MS_LOG(WARNING) << "Open file for mapping.csv failed.";
-      return false;
+      return std::nullopt;
     }
     fout << mapped_name_str << "," << origin_name_str << "\n";
     fout.close();
@@ -347,27 +378,8 @@ bool DumpJsonParser::DumpToFile(const std::string &filename, const void *data, s
   auto file_path = Common::CreatePrefixPath(final_file_path);
   if (!file_path.has_value()) {
     MS_LOG(ERROR) << "CreatePrefixPath failed.";
-    return false;
   }
-  const std::string file_path_str = file_path.value();
-  MS_LOG(INFO) << "Dump path is " << file_path_str;
-  ChangeFileMode(file_path_str, S_IWUSR);
-  std::ofstream fd(file_path_str, std::ios::out | std::ios::trunc | std::ios::binary);
-  if (!fd.is_open()) {
-    MS_LOG(EXCEPTION) << "Open file " << file_path_str << " failed." << ErrnoToString(errno);
-  }
-  std::string npy_header = GenerateNpyHeader(shape, type);
-  if (!npy_header.empty()) {
-    fd << npy_header;
-    (void)fd.write(reinterpret_cast<const char *>(data), SizeToLong(len));
-    if (fd.bad()) {
-      fd.close();
-      MS_LOG(EXCEPTION) << "Write mem to file " << file_path_str << " failed.";
-    }
-    fd.close();
-    ChangeFileMode(file_path_str, S_IRUSR);
-  }
-  return true;
+  return file_path;
 }
 
 void DumpJsonParser::ParseCommonDumpSetting(const nlohmann::json &content) {
@@ -426,6 +438,35 @@ void DumpJsonParser::ParseE2eDumpSetting(const nlohmann::json &content) {
     MS_LOG(WARNING) << "Deprecated: Synchronous dump mode is deprecated and will be removed in a future release";
   }
   trans_flag_ = ParseEnable(*trans_flag);
+  ParseAsyncWriteSetting(*e2e_dump_setting);
+}
+
+void DumpJsonParser::ParseAsyncWriteSetting(const nlohmann::json &content) {
+  // The async write settings are optional.
+  auto async_write = content.find(kAsyncWrite);
+  if (async_write == content.end()) {
+    return;
+  }
+  async_write_ = ParseEnable(*async_write);
+  auto compression = content.find(kCompression);
+  if (compression != content.end()) {
+    if (!compression->is_string() || (*compression != kLz4Compression && *compression != kNoCompression)) {
+      MS_LOG(EXCEPTION) << "Dump config parse failed, " << kCompression << " should be \"" << kLz4Compression
+                        << "\" or \"" << kNoCompression << "\", but got: " << compression->dump();
+    }
+    lz4_compression_ = (*compression == kLz4Compression);
+  }
+  staging_size_ = kDefaultStagingSize;
+  auto staging_size = content.find(kStagingSize);
+  if (staging_size != content.end()) {
+    if (!staging_size->is_number_unsigned()) {
+      MS_LOG(EXCEPTION) << "Dump config parse failed, " << kStagingSize << " should be unsigned int type";
+    }
+    staging_size_ = staging_size->get<size_t>();
+  }
+  if (async_write_ && MsContext::GetInstance()->get_param<std::string>(MS_CTX_DEVICE_TARGET) != kCPUDevice) {
+    MS_LOG(WARNING) << "The async_write of e2e_dump_settings only takes effect on CPU.";
+  }
 }
 
 void CheckJsonUnsignedType(const nlohmann::json &content, const std::string &key) {
@@ -74,9 +74,40 @@ class Cache {
   // Get the maximum number of elements that the cache can hold.
   size_t capacity() const { return capacity_; }
 
+  // Get the number of Get calls which found the key in the cache.
+  size_t hit_count() const { return hit_count_; }
+
+  // Get the number of Get calls which did not find the key in the cache.
+  size_t miss_count() const { return miss_count_; }
+
+  // Get the ratio of the hit count to the count of all Get calls since the last reset.
+  double hit_rate() const {
+    size_t access_count = hit_count_ + miss_count_;
+    return access_count == 0 ? 0.0 : static_cast<double>(hit_count_) / static_cast<double>(access_count);
+  }
+
+  // Clear the hit and miss counters.
+  void ResetStatistics() {
+    hit_count_ = 0;
+    miss_count_ = 0;
+  }
+
  protected:
+  // Record the result of a Get call in the hit and miss counters.
+  void RecordAccess(bool hit) {
+    if (hit) {
+      ++hit_count_;
+    } else {
+      ++miss_count_;
+    }
+  }
+
   // The maximum number of elements that the cache can hold.
   size_t capacity_;
+
+  // The number of Get calls which found or did not find the key in the cache.
+  size_t hit_count_{0};
+  size_t miss_count_{0};
 };
 }  // namespace distributed
 }  // namespace mindspore
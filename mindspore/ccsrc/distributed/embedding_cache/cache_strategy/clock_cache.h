@@ -0,0 +1,233 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_DISTRIBUTED_EMBEDDING_CACHE_CACHE_STRATEGY_CLOCK_CACHE_H_
+#define MINDSPORE_CCSRC_DISTRIBUTED_EMBEDDING_CACHE_CACHE_STRATEGY_CLOCK_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <vector>
+#include <utility>
+#include <functional>
+
+#include "distributed/embedding_cache/cache_strategy/cache.h"
+#include "utils/hash_map.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace distributed {
+// This class implements the CLOCK caching strategy, an approximation of LRU which gives a second chance to the elements
+// accessed since the clock hand passed them last time.
+// The elements are kept in contiguous arrays of slots with a reference bit for each slot, and a hash table maps a key
+// to its slot. Unlike the LRUCache, a cache hit only sets the reference bit of the slot instead of relinking the
+// elements, and the clock hand sweeps over the slots to find the element to evict.
+// A newly inserted element starts with the reference bit cleared, so the keys which are accessed only once, such as a
+// scan of cold keys, are evicted by the first sweep and do not push the hot elements out of the cache.
+template <typename KeyType, typename ValueType, typename Hash = std::hash<KeyType>,
+          typename KeyEqual = std::equal_to<KeyType>>
+class ClockCache : public Cache<KeyType, ValueType> {
+ public:
+  // The elements in cache are stored as key-value pairs.
+  using Element = typename Cache<KeyType, ValueType>::Element;
+
+  explicit ClockCache(size_t capacity)
+      : Cache<KeyType, ValueType>(capacity), elements_(capacity), referenced_(capacity, 0), occupied_(capacity, 0) {
+    element_keys_to_slots_.reserve(capacity);
+    free_slots_.reserve(capacity);
+    for (size_t slot = capacity; slot > 0; --slot) {
+      free_slots_.push_back(slot - 1);
+    }
+  }
+
+  ~ClockCache() override = default;
+
+  // Insert an element (key-value pair) into the clock cache. If the key exists, update the value and mark the element
+  // referenced.
+  void Put(const KeyType &key, const ValueType &value) override {
+    const auto &iter = element_keys_to_slots_.find(key);
+    if (iter != element_keys_to_slots_.end()) {
+      elements_[iter->second].second = value;
+      referenced_[iter->second] = 1;
+      recent_slot_ = iter->second;
+      return;
+    }
+
+    if (IsFull()) {
+      MS_LOG(EXCEPTION) << "There is no space in clock cache.";
+    }
+
+    size_t slot = free_slots_.back();
+    free_slots_.pop_back();
+    elements_[slot].first = key;
+    elements_[slot].second = value;
+    referenced_[slot] = 0;
+    occupied_[slot] = 1;
+    recent_slot_ = slot;
+    (void)element_keys_to_slots_.emplace(key, slot);
+  }
+
+  // Query the corresponding Value from the cache according to the Key. If the element exists, the corresponding Value
+  // is assigned to parameter value and return true. If the element does not exist, return false.
+  // The accessed element is marked referenced and survives the next sweep of the clock hand.
+  bool Get(const KeyType &key, ValueType *value) override {
+    const auto &iter = element_keys_to_slots_.find(key);
+    if (iter != element_keys_to_slots_.end()) {
+      MS_EXCEPTION_IF_NULL(value);
+      referenced_[iter->second] = 1;
+      recent_slot_ = iter->second;
+      *value = elements_[iter->second].second;
+      this->RecordAccess(true);
+      return true;
+    }
+    this->RecordAccess(false);
+    return false;
+  }
+
+  // Get the most recently inserted or accessed element, or the element just behind the clock hand if it has been
+  // evicted.
+  const Element &Front() const override {
+    if (size() == 0) {
+      MS_LOG(EXCEPTION) << "There is no element in clock cache.";
+    }
+    if (recent_slot_ < occupied_.size() && occupied_[recent_slot_]) {
+      return elements_[recent_slot_];
+    }
+    size_t capacity = occupied_.size();
+    size_t slot = hand_;
+    for (size_t i = 0; i < capacity; ++i) {
+      slot = (slot + capacity - 1) % capacity;
+      if (occupied_[slot]) {
+        break;
+      }
+    }
+    return elements_[slot];
+  }
+
+  // Get the element which the clock hand evicts next if no element is accessed before, that is the first unreferenced
+  // element from the clock hand, or the first element from the clock hand if all elements are referenced.
+  const Element &Back() const override {
+    if (size() == 0) {
+      MS_LOG(EXCEPTION) << "There is no element in clock cache.";
+    }
+    size_t capacity = occupied_.size();
+    size_t first_occupied = capacity;
+    for (size_t i = 0, slot = hand_; i < capacity; ++i, slot = (slot + 1) % capacity) {
+      if (!occupied_[slot]) {
+        continue;
+      }
+      if (!referenced_[slot]) {
+        return elements_[slot];
+      }
+      first_occupied = first_occupied == capacity ? slot : first_occupied;
+    }
+    return elements_[first_occupied];
+  }
+
+  // Query whether the element corresponding to a particular key exists in the cache.
+  bool Exists(const KeyType &key) const override {
+    return element_keys_to_slots_.find(key) != element_keys_to_slots_.end();
+  }
+
+  // When the size of the cache is close to capacity, you can use this interface to evict some non-hot data to reserve
+  // space for new elements to be inserted into the cache. If the current cache has enough free space, this function
+  // does nothing.
+  // The input parameter 'reserve_size' indicates the number of element slots that are expected to be reserved. If the
+  // reserve_size is less than or equal to the number of slots remaining in the cache, the function does nothing.
+  // The output parameter 'evicted_elements' is used to hold the evicted element.
+  void TryEvict(size_t reserve_size, std::vector<Element> *evicted_elements) override {
+    MS_EXCEPTION_IF_NULL(evicted_elements);
+    const auto &capacity = Cache<KeyType, ValueType>::capacity();
+    if (reserve_size > capacity) {
+      MS_LOG(EXCEPTION) << "The evict number must be less or equal to clock cache capacity: " << capacity
+                        << ", but got: " << reserve_size;
+    }
+
+    while (size() > capacity - reserve_size) {
+      (void)evicted_elements->emplace_back(Evict());
+    }
+  }
+
+  // Check whether the number of elements in cache reaches capacity.
+  bool IsFull() const override { return size() >= Cache<KeyType, ValueType>::capacity(); }
+
+  // Get the current number of elements in the cache.
+  size_t size() const override { return element_keys_to_slots_.size(); }
+
+  // Dump all elements in the clock cache, in the order from the element just behind the clock hand to the element
+  // under the clock hand. The list is rebuilt on each call.
+  const std::list<Element> &Export() const override {
+    exported_elements_.clear();
+    size_t capacity = occupied_.size();
+    for (size_t i = 0, slot = hand_; i < capacity; ++i) {
+      slot = (slot + capacity - 1) % capacity;
+      if (occupied_[slot]) {
+        (void)exported_elements_.emplace_back(elements_[slot]);
+      }
+    }
+    return exported_elements_;
+  }
+
+  // Move the clock hand to the next element to evict and return it without evicting it, the referenced elements the
+  // clock hand passes lose their reference bits. The next Evict call evicts the returned element unless it is
+  // accessed in between.
+  const Element &Victim() {
+    if (size() == 0) {
+      MS_LOG(EXCEPTION) << "There is no element in clock cache.";
+    }
+    size_t capacity = occupied_.size();
+    while (!occupied_[hand_] || referenced_[hand_]) {
+      referenced_[hand_] = 0;
+      hand_ = (hand_ + 1) % capacity;
+    }
+    return elements_[hand_];
+  }
+
+  // Evict the next element of the clock hand and return it.
+  Element Evict() {
+    (void)Victim();
+    Element element = std::move(elements_[hand_]);
+    (void)element_keys_to_slots_.erase(element.first);
+    occupied_[hand_] = 0;
+    free_slots_.push_back(hand_);
+    hand_ = (hand_ + 1) % occupied_.size();
+    return element;
+  }
+
+ private:
+  // The contiguous slots used to hold elements.
+  std::vector<Element> elements_;
+  // The reference bit and the occupied flag of each slot.
+  std::vector<uint8_t> referenced_;
+  std::vector<uint8_t> occupied_;
+
+  // The slots which hold no element.
+  std::vector<size_t> free_slots_;
+
+  // The hash table used to quickly find the slot of an element.
+  mindspore::HashMap<KeyType, size_t, Hash, KeyEqual> element_keys_to_slots_;
+
+  // The slot which the clock hand points to.
+  size_t hand_{0};
+
+  // The slot of the most recently inserted or accessed element.
+  size_t recent_slot_{SIZE_MAX};
+
+  // The buffer of Export.
+  mutable std::list<Element> exported_elements_;
+};
+}  // namespace distributed
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_DISTRIBUTED_EMBEDDING_CACHE_CACHE_STRATEGY_CLOCK_CACHE_H_
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_DISTRIBUTED_EMBEDDING_CACHE_CACHE_STRATEGY_FREQUENCY_SKETCH_H_
+#define MINDSPORE_CCSRC_DISTRIBUTED_EMBEDDING_CACHE_CACHE_STRATEGY_FREQUENCY_SKETCH_H_
+
+#include <cstdint>
+#include <vector>
+#include <functional>
+
+namespace mindspore {
+namespace distributed {
+// This class implements a count-min sketch with 4-bit counters, which estimates the access frequency of a large number
+// of keys in a small fixed memory, it is the frequency filter of TinyLFU admission.
+// Each 64-bit word of the table holds 16 counters, and each key is counted by 4 counters in 4 different words. The
+// estimated frequency of a key is the minimum of its counters, which saturate at 15. All counters are halved after
+// the number of additions reaches the sample size, so the sketch ages and follows the recent popularity of the keys.
+template <typename KeyType, typename Hash = std::hash<KeyType>>
+class FrequencySketch {
+ public:
+  // The 'capacity' is the maximum number of elements of the cache using this sketch.
+  explicit FrequencySketch(size_t capacity) {
+    size_t table_size = 1;
+    while (table_size < capacity) {
+      table_size <<= 1;
+    }
+    table_.resize(table_size, 0);
+    table_mask_ = table_size - 1;
+    sample_size_ = (capacity == 0 ? 1 : capacity) * kSampleSizeFactor;
+  }
+
+  ~FrequencySketch() = default;
+
+  // Increase the estimated access frequency of the key by one if it is not saturated.
+  void Increment(const KeyType &key) {
+    uint64_t hash = Spread(hasher_(key));
+    bool added = false;
+    for (size_t i = 0; i < kDepth; i++) {
+      uint64_t &word = table_[WordIndex(hash, i)];
+      size_t offset = CounterOffset(hash, i);
+      if (((word >> offset) & kCounterMask) != kCounterMask) {
+        word += (1ULL << offset);
+        added = true;
+      }
+    }
+    if (added && ++additions_ >= sample_size_) {
+      Reset();
+    }
+  }
+
+  // Get the estimated access frequency of the key, which is in range [0, 15].
+  size_t Frequency(const KeyType &key) const {
+    uint64_t hash = Spread(hasher_(key));
+    size_t frequency = kCounterMask;
+    for (size_t i = 0; i < kDepth; i++) {
+      size_t count = (table_[WordIndex(hash, i)] >> CounterOffset(hash, i)) & kCounterMask;
+      frequency = count < frequency ? count : frequency;
+    }
+    return frequency;
+  }
+
+  // Halve all counters to age the sketch.
+  void Reset() {
+    for (auto &word : table_) {
+      word = (word >> 1) & kResetMask;
+    }
+    additions_ >>= 1;
+  }
+
+ private:
+  // Mix the bits of the key hash, the std::hash of integers is an identity function.
+  static uint64_t Spread(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  size_t WordIndex(uint64_t hash, size_t i) const {
+    uint64_t row_hash = (hash + kSeeds[i]) * kSeeds[i];
+    return static_cast<size_t>((row_hash >> 32) & table_mask_);
+  }
+
+  static size_t CounterOffset(uint64_t hash, size_t i) {
+    // Each row uses its own 4 bits of the hash to select one of the 16 counters in the word.
+    return static_cast<size_t>((hash >> (i * kCounterBits)) & kCounterMask) * kCounterBits;
+  }
+
+  static constexpr size_t kDepth = 4;
+  static constexpr size_t kCounterBits = 4;
+  static constexpr uint64_t kCounterMask = 0xF;
+  static constexpr uint64_t kResetMask = 0x7777777777777777ULL;
+  static constexpr size_t kSampleSizeFactor = 10;
+  static constexpr uint64_t kSeeds[kDepth] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL,
+                                              0xcbf29ce484222325ULL};
+
+  // The counters, 16 counters in each word.
+  std::vector<uint64_t> table_;
+  size_t table_mask_{0};
+
+  // The number of increments after the last reset, and the threshold to reset.
+  size_t additions_{0};
+  size_t sample_size_{0};
+
+  Hash hasher_;
+};
+}  // namespace distributed
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_DISTRIBUTED_EMBEDDING_CACHE_CACHE_STRATEGY_FREQUENCY_SKETCH_H_
@@ -77,8 +77,10 @@ class LRUCache : public Cache<KeyType, ValueType> {
       elements_.splice(elements_.begin(), elements_, iter->second);
       MS_EXCEPTION_IF_NULL(value);
       *value = iter->second->second;
+      this->RecordAccess(true);
       return true;
     }
+    this->RecordAccess(false);
     return false;
   }
 
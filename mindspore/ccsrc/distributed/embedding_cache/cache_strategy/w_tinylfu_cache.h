@@ -0,0 +1,195 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_DISTRIBUTED_EMBEDDING_CACHE_CACHE_STRATEGY_W_TINYLFU_CACHE_H_
+#define MINDSPORE_CCSRC_DISTRIBUTED_EMBEDDING_CACHE_CACHE_STRATEGY_W_TINYLFU_CACHE_H_
+
+#include <algorithm>
+#include <list>
+#include <vector>
+#include <utility>
+#include <functional>
+
+#include "distributed/embedding_cache/cache_strategy/cache.h"
+#include "distributed/embedding_cache/cache_strategy/clock_cache.h"
+#include "distributed/embedding_cache/cache_strategy/frequency_sketch.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace distributed {
+// The default ratio of the window cache capacity to the whole W-TinyLFU cache capacity.
+constexpr float kDefaultTinyLFUWindowRatio = 0.01;
+
+// This class implements the W-TinyLFU caching strategy, which fits the skewed key distributions, such as the Zipfian
+// distribution of ids in CTR models, and resists the scans of cold keys.
+// The cache is split into a small window cache and a large main cache, both of them are clock caches. The new elements
+// are inserted into the window cache, and the elements evicted from the window cache are the candidates to enter the
+// main cache. When the main cache is full, the TinyLFU admission compares the access frequency of a candidate with
+// the frequency of the element the main cache evicts next, and keeps the more frequent one. The access frequencies of
+// all keys, including the keys not in cache, are estimated by a count-min sketch updated in Get.
+// The embedding storage reserves space for a whole batch of missing keys before inserting them, so the window cache
+// can hold up to the whole capacity, and its elements beyond the window capacity are moved out by the next TryEvict.
+// This way every new key has to win the admission to enter the main cache.
+template <typename KeyType, typename ValueType, typename Hash = std::hash<KeyType>,
+          typename KeyEqual = std::equal_to<KeyType>>
+class WTinyLFUCache : public Cache<KeyType, ValueType> {
+ public:
+  // The elements in cache are stored as key-value pairs.
+  using Element = typename Cache<KeyType, ValueType>::Element;
+  using SegmentType = ClockCache<KeyType, ValueType, Hash, KeyEqual>;
+
+  explicit WTinyLFUCache(size_t capacity, float window_ratio = kDefaultTinyLFUWindowRatio)
+      : Cache<KeyType, ValueType>(capacity),
+        window_capacity_(WindowCapacity(capacity, window_ratio)),
+        window_(capacity),
+        main_(capacity - window_capacity_),
+        sketch_(capacity) {}
+
+  ~WTinyLFUCache() override = default;
+
+  // Insert an element (key-value pair) into the cache. A new element is always inserted into the window cache.
+  void Put(const KeyType &key, const ValueType &value) override {
+    if (window_.Exists(key)) {
+      window_.Put(key, value);
+      return;
+    }
+    if (main_.Exists(key)) {
+      main_.Put(key, value);
+      return;
+    }
+
+    if (IsFull()) {
+      MS_LOG(EXCEPTION) << "There is no space in w-tinylfu cache.";
+    }
+    window_.Put(key, value);
+  }
+
+  // Query the corresponding Value from the cache according to the Key. If the element exists, the corresponding Value
+  // is assigned to parameter value and return true. If the element does not exist, return false.
+  // Every query is recorded in the frequency sketch, no matter whether it hits.
+  bool Get(const KeyType &key, ValueType *value) override {
+    sketch_.Increment(key);
+    bool hit = window_.Get(key, value) || main_.Get(key, value);
+    this->RecordAccess(hit);
+    return hit;
+  }
+
+  // Get the most recently inserted element.
+  const Element &Front() const override {
+    if (size() == 0) {
+      MS_LOG(EXCEPTION) << "There is no element in w-tinylfu cache.";
+    }
+    return window_.size() != 0 ? window_.Front() : main_.Front();
+  }
+
+  // Get the element which the main cache evicts next.
+  const Element &Back() const override {
+    if (size() == 0) {
+      MS_LOG(EXCEPTION) << "There is no element in w-tinylfu cache.";
+    }
+    return main_.size() != 0 ? main_.Back() : window_.Back();
+  }
+
+  // Query whether the element corresponding to a particular key exists in the cache.
+  bool Exists(const KeyType &key) const override { return window_.Exists(key) || main_.Exists(key); }
+
+  // When the size of the cache is close to capacity, you can use this interface to evict some non-hot data to reserve
+  // space for new elements to be inserted into the cache. If the current cache has enough free space, this function
+  // does nothing.
+  // The input parameter 'reserve_size' indicates the number of element slots that are expected to be reserved. If the
+  // reserve_size is less than or equal to the number of slots remaining in the cache, the function does nothing.
+  // The output parameter 'evicted_elements' is used to hold the evicted element.
+  // The reserved slots are taken by the window cache, so each evicted element is the loser of the duel between the
+  // window victim and the main victim.
+  void TryEvict(size_t reserve_size, std::vector<Element> *evicted_elements) override {
+    MS_EXCEPTION_IF_NULL(evicted_elements);
+    const auto &capacity = Cache<KeyType, ValueType>::capacity();
+    if (reserve_size > capacity) {
+      MS_LOG(EXCEPTION) << "The evict number must be less or equal to w-tinylfu cache capacity: " << capacity
+                        << ", but got: " << reserve_size;
+    }
+
+    while (size() > capacity - reserve_size) {
+      if (window_.size() == 0) {
+        (void)evicted_elements->emplace_back(main_.Evict());
+        continue;
+      }
+      // The candidate enters the main cache for free if the main cache still has space after the reserved elements
+      // and the window capacity are taken, that is the cache is warming up.
+      if (main_.size() + reserve_size + window_capacity_ < capacity) {
+        Element candidate = window_.Evict();
+        main_.Put(candidate.first, candidate.second);
+        continue;
+      }
+      if (main_.size() == 0 || !Admit(window_.Victim().first, main_.Victim().first)) {
+        (void)evicted_elements->emplace_back(window_.Evict());
+        continue;
+      }
+      (void)evicted_elements->emplace_back(main_.Evict());
+      Element candidate = window_.Evict();
+      main_.Put(candidate.first, candidate.second);
+    }
+  }
+
+  // Check whether the number of elements in cache reaches capacity.
+  bool IsFull() const override { return size() >= Cache<KeyType, ValueType>::capacity(); }
+
+  // Get the current number of elements in the cache.
+  size_t size() const override { return window_.size() + main_.size(); }
+
+  // Dump all elements in the cache, the elements of the window cache come first. The list is rebuilt on each call.
+  const std::list<Element> &Export() const override {
+    exported_elements_ = window_.Export();
+    const auto &main_elements = main_.Export();
+    (void)exported_elements_.insert(exported_elements_.end(), main_elements.begin(), main_elements.end());
+    return exported_elements_;
+  }
+
+  // Get the estimated access frequency of a key.
+  size_t Frequency(const KeyType &key) const { return sketch_.Frequency(key); }
+
+ private:
+  static size_t WindowCapacity(size_t capacity, float window_ratio) {
+    if (window_ratio <= 0 || window_ratio > 1) {
+      MS_LOG(EXCEPTION) << "The window ratio of w-tinylfu cache should be in range (0, 1], but got: " << window_ratio;
+    }
+    size_t window_capacity = static_cast<size_t>(static_cast<float>(capacity) * window_ratio);
+    return std::min(std::max(window_capacity, static_cast<size_t>(1)), capacity);
+  }
+
+  // The TinyLFU admission policy, the candidate replaces the victim only if it is accessed more frequently, so a
+  // scan of cold keys can not replace the hot elements.
+  bool Admit(const KeyType &candidate, const KeyType &victim) const {
+    return sketch_.Frequency(candidate) > sketch_.Frequency(victim);
+  }
+
+  // The expected number of elements in the window cache, the window cache exceeds it until the next TryEvict.
+  size_t window_capacity_;
+
+  // The window cache holds the new elements, and the main cache holds the elements admitted by the TinyLFU policy. The
+  // capacity of the main cache is the capacity excluding the window capacity.
+  SegmentType window_;
+  SegmentType main_;
+
+  // The access frequency estimator of all keys.
+  FrequencySketch<KeyType, Hash> sketch_;
+
+  // The buffer of Export.
+  mutable std::list<Element> exported_elements_;
+};
+}  // namespace distributed
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_DISTRIBUTED_EMBEDDING_CACHE_CACHE_STRATEGY_W_TINYLFU_CACHE_H_
@@ -34,9 +34,33 @@ EmbeddingCacheTableManager &EmbeddingCacheTableManager::GetInstance() {
   return instance;
 }
 
+size_t GetMultiBatchThreshold(size_t worker_num) {
+  std::string prefetch_steps_env = common::GetEnv(kEnvEmbeddingCachePrefetchSteps);
+  if (prefetch_steps_env.empty()) {
+    return worker_num > 1 ? 1 : kMultiBatchThreshold;
+  }
+  size_t prefetch_steps = 0;
+  try {
+    prefetch_steps = std::stoul(prefetch_steps_env);
+  } catch (const std::exception &e) {
+    MS_LOG(EXCEPTION) << "The environment variable " << kEnvEmbeddingCachePrefetchSteps
+                      << " should be a positive integer, but got: " << prefetch_steps_env;
+  }
+  if (prefetch_steps == 0 || prefetch_steps > kMaxMultiBatchThreshold) {
+    MS_LOG(EXCEPTION) << "The environment variable " << kEnvEmbeddingCachePrefetchSteps << " should be in range [1, "
+                      << kMaxMultiBatchThreshold << "], but got: " << prefetch_steps;
+  }
+  if (worker_num > 1) {
+    MS_LOG(WARNING) << "The environment variable " << kEnvEmbeddingCachePrefetchSteps
+                    << " is ignored in multi-worker case, the cache prefetch processes one step once.";
+    return 1;
+  }
+  return prefetch_steps;
+}
+
 void EmbeddingCacheTableManager::Initialize() {
-  auto worker_num = ps::PSContext::instance()->worker_num();
-  multi_batch_threshold_ = worker_num > 1 ? 1 : kMultiBatchThreshold;
+  multi_batch_threshold_ = GetMultiBatchThreshold(ps::PSContext::instance()->worker_num());
+  MS_LOG(INFO) << "The lookahead step number of embedding cache prefetch: " << multi_batch_threshold_;
   GetEmbeddingTableSliceBound();
 
   device::DeviceContextKey host_key = {"CPU", 0};
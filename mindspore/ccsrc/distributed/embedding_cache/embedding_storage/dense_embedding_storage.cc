@@ -183,7 +183,8 @@ void DenseEmbeddingStorage<KeyType, ValueType, Allocator>::QueryCache(const KeyT
   }
 
   MS_LOG(DEBUG) << "Total keys number: " << key_num << ", cache hit number: " << (key_num - *cache_miss_cnt)
-                << ", cache hit rate: " << static_cast<float>(key_num - *cache_miss_cnt) / static_cast<float>(key_num);
+                << ", cache hit rate: " << static_cast<float>(key_num - *cache_miss_cnt) / static_cast<float>(key_num)
+                << ", accumulated cache hit rate: " << this->cache_->hit_rate();
 }
 
 template <typename KeyType, typename ValueType, typename Allocator>
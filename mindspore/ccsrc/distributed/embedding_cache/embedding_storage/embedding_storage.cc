@@ -18,6 +18,8 @@
 #include <map>
 #include <string>
 #include "distributed/embedding_cache/cache_strategy/lru_cache.h"
+#include "distributed/embedding_cache/cache_strategy/clock_cache.h"
+#include "distributed/embedding_cache/cache_strategy/w_tinylfu_cache.h"
 #include "distributed/persistent/storage/local_file.h"
 #if defined(__linux__) && defined(WITH_BACKEND)
 #include "include/backend/distributed/ps/ps_context.h"
@@ -43,6 +45,30 @@ std::string GetEmbeddingRemoteStoragePath() {
 
   return stoage_path;
 }
+
+// The environment variable used to set the cache strategy of the host cache: lru, clock or w_tinylfu.
+constexpr auto kEnvEmbeddingCacheStrategy = "MS_EMBEDDING_CACHE_STRATEGY";
+constexpr auto kLRUCacheStrategy = "lru";
+constexpr auto kClockCacheStrategy = "clock";
+constexpr auto kWTinyLFUCacheStrategy = "w_tinylfu";
+
+// Create the host cache with the cache strategy set by environment variable, the default strategy is lru.
+template <typename KeyType>
+std::unique_ptr<Cache<KeyType, int>> CreateCache(size_t capacity) {
+  std::string strategy = common::GetEnv(kEnvEmbeddingCacheStrategy);
+  if (strategy.empty() || strategy == kLRUCacheStrategy) {
+    return std::make_unique<LRUCache<KeyType, int>>(capacity);
+  }
+  if (strategy == kClockCacheStrategy) {
+    return std::make_unique<ClockCache<KeyType, int>>(capacity);
+  }
+  if (strategy == kWTinyLFUCacheStrategy) {
+    return std::make_unique<WTinyLFUCache<KeyType, int>>(capacity);
+  }
+  MS_LOG(EXCEPTION) << "Invalid embedding cache strategy: " << strategy << ", the environment variable "
+                    << kEnvEmbeddingCacheStrategy << " should be one of: " << kLRUCacheStrategy << ", "
+                    << kClockCacheStrategy << ", " << kWTinyLFUCacheStrategy;
+}
 }  // namespace
 
 template <typename KeyType, typename ValueType, typename Allocator>
@@ -57,7 +83,7 @@ void EmbeddingStorage<KeyType, ValueType, Allocator>::Initialize(const DeviceAdd
 #endif
 
   // 2. Create the host memory cache instance.
-  cache_ = std::make_unique<LRUCache<KeyType, int>>(cache_capacity_);
+  cache_ = CreateCache<KeyType>(cache_capacity_);
   MS_EXCEPTION_IF_NULL(cache_);
 
   // 3. Create the persistent storage instance.
@@ -86,6 +112,8 @@ void EmbeddingStorage<KeyType, ValueType, Allocator>::Initialize(const DeviceAdd
 template <typename KeyType, typename ValueType, typename Allocator>
 void EmbeddingStorage<KeyType, ValueType, Allocator>::Finalize() {
   MS_EXCEPTION_IF_NULL(cache_);
+  MS_LOG(INFO) << "Embedding storage " << embedding_key_ << " host cache hit number: " << cache_->hit_count()
+               << ", miss number: " << cache_->miss_count() << ", hit rate: " << cache_->hit_rate();
   cache_ = nullptr;
   MS_EXCEPTION_IF_NULL(storage_);
   storage_->Finalize();
@@ -0,0 +1,142 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "include/backend/distributed/rpc/tcp/buffer_pool.h"
+
+#include <cstdlib>
+
+#include "include/backend/distributed/rpc/tcp/constants.h"
+
+namespace mindspore {
+namespace distributed {
+namespace rpc {
+namespace {
+// The smallest size class is 4KB, the largest one holds the max message body.
+constexpr size_t kMinSizeClassShift = 12;
+constexpr size_t kMaxSizeClassShift = 30;
+static_assert((1UL << kMaxSizeClassShift) >= MAX_KMSG_BODY_LEN, "The size classes must hold the max message body.");
+
+size_t ClassSize(size_t size_class) { return 1UL << (size_class + kMinSizeClassShift); }
+}  // namespace
+
+MessageBufferPool::MessageBufferPool(size_t max_cached_size)
+    : free_lists_(kMaxSizeClassShift - kMinSizeClassShift + 1), max_cached_size_(max_cached_size) {}
+
+MessageBufferPool::~MessageBufferPool() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &free_list : free_lists_) {
+    for (void *buffer : free_list) {
+      free(buffer);
+    }
+    free_list.clear();
+  }
+  if (!in_use_.empty()) {
+    MS_LOG(WARNING) << in_use_.size() << " buffers are still in use when the message buffer pool is destroyed.";
+  }
+  for (auto &item : in_use_) {
+    free(item.first);
+  }
+  in_use_.clear();
+}
+
+size_t MessageBufferPool::SizeClass(size_t size) {
+  size_t size_class = 0;
+  while (size_class + kMinSizeClassShift < kMaxSizeClassShift && ClassSize(size_class) < size) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+void *MessageBufferPool::Allocate(size_t size) {
+  if (size > ClassSize(free_lists_.size() - 1)) {
+    MS_LOG(ERROR) << "The buffer size " << size << " exceeds the max message body size.";
+    return nullptr;
+  }
+  size_t size_class = SizeClass(size);
+  std::lock_guard<std::mutex> lock(mutex_);
+  void *buffer = nullptr;
+  auto &free_list = free_lists_[size_class];
+  if (!free_list.empty()) {
+    buffer = free_list.back();
+    free_list.pop_back();
+    cached_size_ -= ClassSize(size_class);
+  } else {
+    buffer = malloc(ClassSize(size_class));
+    if (buffer == nullptr) {
+      MS_LOG(ERROR) << "Failed to allocate the buffer of size " << ClassSize(size_class);
+      return nullptr;
+    }
+  }
+  (void)in_use_.emplace(buffer, size_class);
+  return buffer;
+}
+
+bool MessageBufferPool::Free(void *data) {
+  if (data == nullptr) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = in_use_.find(data);
+  if (iter == in_use_.end()) {
+    MS_LOG(ERROR) << "The buffer " << data << " is not allocated by the message buffer pool.";
+    return false;
+  }
+  size_t size_class = iter->second;
+  (void)in_use_.erase(iter);
+  if (cached_size_ + ClassSize(size_class) > max_cached_size_) {
+    free(data);
+    return true;
+  }
+  free_lists_[size_class].push_back(data);
+  cached_size_ += ClassSize(size_class);
+  return true;
+}
+
+MemAllocateCallback MessageBufferPool::allocate_cb() {
+  return [this](size_t size) -> void * { return Allocate(size); };
+}
+
+MemFreeCallback MessageBufferPool::free_cb() {
+  return [this](void *data) -> bool { return Free(data); };
+}
+
+size_t MessageBufferPool::cached_size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cached_size_;
+}
+
+PooledMessage::PooledMessage(const std::shared_ptr<MessageBufferPool> &pool, size_t size) : pool_(pool) {
+  MS_EXCEPTION_IF_NULL(pool_);
+  data = pool_->Allocate(size);
+  this->size = data == nullptr ? 0 : size;
+}
+
+PooledMessage::~PooledMessage() {
+  if (data != nullptr) {
+    (void)pool_->Free(data);
+    data = nullptr;
+  }
+}
+
+void *PooledMessage::ReleaseData() {
+  void *buffer = data;
+  data = nullptr;
+  size = 0;
+  return buffer;
+}
+}  // namespace rpc
+}  // namespace distributed
+}  // namespace mindspore
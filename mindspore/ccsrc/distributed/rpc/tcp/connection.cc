@@ -16,6 +16,7 @@
 
 #include "distributed/rpc/tcp/connection.h"
 
+#include <linux/errqueue.h>
 #include <memory>
 #include <utility>
 
@@ -53,6 +54,15 @@ void SocketEventHandler(int fd, uint32_t events, void *context) {
     }
     return;
   }
+  // The completion notifications of MSG_ZEROCOPY raise EPOLLERR, it is a socket error only if SO_ERROR is set.
+  if (conn->zero_copy_enabled && (events & EPOLLERR) > 0) {
+    conn->HandleZeroCopyCompletion();
+    int so_error = 0;
+    socklen_t len = sizeof(so_error);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &len) == 0 && so_error == 0) {
+      events &= ~static_cast<uint32_t>(EPOLLERR);
+    }
+  }
   // Handle write event.
   if ((events & EPOLLOUT) > 0) {
     (void)conn->recv_event_loop->UpdateEpollEvent(fd, EPOLLIN | EPOLLHUP | EPOLLERR);
@@ -156,16 +166,8 @@ Connection::Connection()
   recv_kernel_msg.msg_iov = recv_io_vec;
   recv_kernel_msg.msg_iovlen = RECV_MSG_IO_VEC_LEN;
 
-  // Initialize the send message header.
   // This variable will be deleted in the `Close` method.
   send_metrics = new SendMetrics();
-  for (unsigned int i = 0; i < MAGICID_LEN; i++) {
-    if (i < sizeof(RPC_MAGICID) - 1) {
-      send_msg_header.magic[i] = RPC_MAGICID[i];
-    } else {
-      send_msg_header.magic[i] = '\0';
-    }
-  }
 
   // Initialize the send kernel message structure.
   send_kernel_msg.msg_control = nullptr;
@@ -246,9 +248,24 @@ void Connection::Close() {
 
   // There's no need to release the recv_message because the lifecycle of this data is passed to the caller.
 
-  if (total_send_len != 0 && send_message != nullptr) {
-    delete send_message;
+  if (total_send_len != 0) {
+    for (size_t i = 0; i < send_slot_num; ++i) {
+      delete send_slots[i].message;
+      send_slots[i].message = nullptr;
+    }
+    send_slot_num = 0;
     send_message = nullptr;
+    zero_copy_message_ = nullptr;
+  }
+
+  // The socket is closed, the kernel drops the notifications of the messages sent with MSG_ZEROCOPY.
+  while (!zero_copy_pending_.empty()) {
+    MessageBase *pending_msg = zero_copy_pending_.front().second;
+    zero_copy_pending_.pop_front();
+    if (!FreeMessageMemory(pending_msg)) {
+      MS_LOG(ERROR) << "Failed to free memory of the send message.";
+    }
+    delete pending_msg;
   }
 
   MessageBase *tmpMsg = nullptr;
@@ -286,7 +303,7 @@ int Connection::ReceiveMessage() {
     auto result = message_handler(recv_message);
     if (result != rpc::NULL_MSG) {
       // Send the result message back to the tcp client if any.
-      FillSendMessage(result, "", false);
+      send_message_queue.push(result);
       (void)Flush();
     }
   } else {
@@ -359,35 +376,45 @@ void Connection::FillSendMessage(MessageBase *msg, const std::string &advertiseU
     return;
   }
   if (msg->type == MessageBase::Type::KMSG) {
-    // The total len of array variable `send_io_vec` is `SEND_MSG_IO_VEC_LEN` whose value is 5 currently.
-    size_t index = 0;
+    // Every message takes `SEND_MSG_IO_VEC_LEN` iovecs of `send_io_vec` whose value is 5 currently.
+    size_t index = send_slot_num * SEND_MSG_IO_VEC_LEN;
     if (!isHttpKmsg) {
-      send_to = msg->to;
-      send_from = msg->from;
-      FillMessageHeader(*msg, &send_msg_header);
-
-      send_io_vec[index].iov_base = &send_msg_header;
-      send_io_vec[index].iov_len = sizeof(send_msg_header);
+      SendSlot *slot = &send_slots[send_slot_num];
+      slot->to = msg->to;
+      slot->from = msg->from;
+      slot->message = msg;
+      FillMessageHeader(*msg, &slot->header);
+
+      send_io_vec[index].iov_base = &slot->header;
+      send_io_vec[index].iov_len = sizeof(slot->header);
       ++index;
       send_io_vec[index].iov_base = const_cast<char *>(msg->name.data());
       send_io_vec[index].iov_len = msg->name.size();
       ++index;
-      send_io_vec[index].iov_base = const_cast<char *>(send_to.data());
-      send_io_vec[index].iov_len = send_to.size();
+      send_io_vec[index].iov_base = const_cast<char *>(slot->to.data());
+      send_io_vec[index].iov_len = slot->to.size();
       ++index;
-      send_io_vec[index].iov_base = const_cast<char *>(send_from.data());
-      send_io_vec[index].iov_len = send_from.size();
+      send_io_vec[index].iov_base = const_cast<char *>(slot->from.data());
+      send_io_vec[index].iov_len = slot->from.size();
       ++index;
-      send_io_vec[index].iov_base = GetMessageBaseRealData(msg);
+      total_send_len += UlongToUint(sizeof(slot->header)) + msg->name.size() + slot->to.size() + slot->from.size();
       // The real size of the data body.
       size_t real_data_size = GetMessageBaseRealDataSize(msg);
-      send_io_vec[index].iov_len = real_data_size;
-      ++index;
+      if (zero_copy_enabled && real_data_size >= ZERO_COPY_THRESHOLD) {
+        // The body is sent by a separate 'sendmsg' call with MSG_ZEROCOPY, see `FillZeroCopyBody`.
+        zero_copy_message_ = msg;
+      } else {
+        send_io_vec[index].iov_base = GetMessageBaseRealData(msg);
+        send_io_vec[index].iov_len = real_data_size;
+        ++index;
+        total_send_len += real_data_size;
+      }
       send_kernel_msg.msg_iov = send_io_vec;
       send_kernel_msg.msg_iovlen = index;
-      total_send_len =
-        UlongToUint(sizeof(send_msg_header)) + msg->name.size() + send_to.size() + send_from.size() + real_data_size;
-      send_message = msg;
+      if (send_slot_num == 0) {
+        send_message = msg;
+      }
+      ++send_slot_num;
 
       // update metrics
       send_metrics->UpdateMax(real_data_size);
@@ -405,6 +432,8 @@ void Connection::FillSendMessage(MessageBase *msg, const std::string &advertiseU
       msg->body = GenerateHttpMessage(msg);
     }
 
+    // The http message takes one iovec, so it is always sent alone.
+    index = 0;
     send_io_vec[index].iov_base = GetMessageBaseRealData(msg);
     size_t real_data_size = GetMessageBaseRealDataSize(msg);
     send_io_vec[index].iov_len = real_data_size;
@@ -413,6 +442,8 @@ void Connection::FillSendMessage(MessageBase *msg, const std::string &advertiseU
     send_kernel_msg.msg_iovlen = index;
     total_send_len = UlongToUint(real_data_size);
     send_message = msg;
+    send_slots[0].message = msg;
+    send_slot_num = 1;
 
     // update metrics
     send_metrics->UpdateMax(real_data_size);
@@ -436,14 +467,26 @@ void Connection::FillRecvMessage() {
   int i = 0;
 
   // This new message will be assigned to `recv_message` later.
-  MessageBase *msg = new (std::nothrow) MessageBase();
+  MessageBase *msg = nullptr;
+  if (buffer_pool_ != nullptr) {
+    msg = new (std::nothrow) PooledMessage(buffer_pool_, recvBodyLen);
+  } else {
+    msg = new (std::nothrow) MessageBase();
+  }
   MS_EXCEPTION_IF_NULL(msg);
 
   msg->name.resize(recvNameLen);
   recv_to.resize(recvToLen);
   recv_from.resize(recvFromLen);
 
-  if (allocate_cb_) {
+  if (buffer_pool_ != nullptr) {
+    if (msg->data == nullptr) {
+      MS_LOG(ERROR) << "Failed to borrow the buffer of size " << recvBodyLen << " from the message buffer pool.";
+      delete msg;
+      state = ConnectionState::kDisconnecting;
+      return;
+    }
+  } else if (allocate_cb_) {
     void *allocated_mem = allocate_cb_(recvBodyLen);
     msg->data = allocated_mem;
     msg->size = recvBodyLen;
@@ -473,34 +516,75 @@ void Connection::FillRecvMessage() {
   // There is no need to delete recv_message first because the recv_message has already been returned to the caller and
   // it's the caller's responsibility to release the received message after using it.
   // The real data raw pointer is allocated by callback set by the caller. So the caller should be responsible for its
-  // releasing as well.
+  // releasing as well. A buffer borrowed from the buffer pool is returned by deleting the message.
   recv_message = msg;
 }
 
+void Connection::FillSendBatch() {
+  while (!send_message_queue.empty() && send_slot_num < SEND_MSG_BATCH_NUM && zero_copy_message_ == nullptr) {
+    FillSendMessage(send_message_queue.front(), source, false);
+    send_message_queue.pop();
+  }
+}
+
+void Connection::FillZeroCopyBody() {
+  send_io_vec[0].iov_base = GetMessageBaseRealData(zero_copy_message_);
+  send_io_vec[0].iov_len = GetMessageBaseRealDataSize(zero_copy_message_);
+  send_kernel_msg.msg_iov = send_io_vec;
+  send_kernel_msg.msg_iovlen = 1;
+  total_send_len = send_io_vec[0].iov_len;
+  send_zero_copy = true;
+}
+
+size_t Connection::ReleaseSendBatch() {
+  // update metrics
+  send_metrics->UpdateError(false);
+
+  size_t send_bytes = 0;
+  for (size_t i = 0; i < send_slot_num; ++i) {
+    MessageBase *msg = send_slots[i].message;
+    send_slots[i].message = nullptr;
+    size_t real_data_size = GetMessageBaseRealDataSize(msg);
+    output_buffer_size -= real_data_size;
+    send_bytes += real_data_size;
+
+    // The kernel may still read the pages of the body, it is released in `HandleZeroCopyCompletion` unless all the
+    // 'sendmsg' calls up to now are completed, e.g. the body fell back to copying.
+    bool wait_completion =
+      !zero_copy_pending_.empty() || static_cast<int32_t>(zero_copy_done_seq_ - zero_copy_send_seq) < 0;
+    if (msg == zero_copy_message_ && send_zero_copy && wait_completion) {
+      zero_copy_pending_.emplace_back(zero_copy_send_seq, msg);
+      continue;
+    }
+    if (!FreeMessageMemory(msg)) {
+      MS_LOG(ERROR) << "Failed to free memory of the send message.";
+    }
+    delete msg;
+  }
+  send_slot_num = 0;
+  send_message = nullptr;
+  zero_copy_message_ = nullptr;
+  send_zero_copy = false;
+  return send_bytes;
+}
+
 size_t Connection::Flush() {
   size_t total_send_bytes = 0;
   while (!send_message_queue.empty() || total_send_len != 0) {
     if (total_send_len == 0) {
-      FillSendMessage(send_message_queue.front(), source, false);
-      send_message_queue.pop();
+      FillSendBatch();
     }
     size_t sendLen = 0;
     int retval = socket_operation->SendMessage(this, &send_kernel_msg, total_send_len, &sendLen);
     if (retval == IO_RW_OK && sendLen > 0) {
       total_send_len -= sendLen;
       if (total_send_len == 0) {
-        // update metrics
-        send_metrics->UpdateError(false);
-
-        size_t real_data_size = GetMessageBaseRealDataSize(send_message);
-        output_buffer_size -= real_data_size;
-        total_send_bytes += real_data_size;
-
-        if (!FreeMessageMemory(send_message)) {
-          MS_LOG(ERROR) << "Failed to free memory of the send message.";
+        if (zero_copy_message_ != nullptr && !send_zero_copy) {
+          // The other parts of the batch are sent out, then send the large body without copying.
+          FillZeroCopyBody();
+          continue;
         }
-        delete send_message;
-        send_message = nullptr;
+        total_send_bytes += ReleaseSendBatch();
         break;
       }
     } else if (retval == IO_RW_OK && sendLen == 0) {
@@ -518,6 +602,62 @@ size_t Connection::Flush() {
   return total_send_bytes;
 }
 
+bool Connection::EnableZeroCopy() {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+  int enable = 1;
+  if (setsockopt(socket_fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) != 0) {
+    MS_LOG(WARNING) << "Failed to enable zero copy on fd: " << socket_fd << ", errno: " << errno << " "
+                    << strerror(errno);
+    return false;
+  }
+  zero_copy_enabled = true;
+  return true;
+#else
+  MS_LOG(WARNING) << "Zero copy sending is not supported on this platform.";
+  return false;
+#endif
+}
+
+void Connection::HandleZeroCopyCompletion() {
+#ifdef SO_EE_ORIGIN_ZEROCOPY
+  std::lock_guard<std::mutex> lock(*conn_mutex);
+  const size_t control_len = 128;
+  char control[control_len];
+  while (true) {
+    struct msghdr err_msg = {};
+    err_msg.msg_control = control;
+    err_msg.msg_controllen = sizeof(control);
+    if (recvmsg(socket_fd, &err_msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      break;
+    }
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&err_msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&err_msg, cmsg)) {
+      bool is_recv_err = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                         (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+      if (!is_recv_err) {
+        continue;
+      }
+      struct sock_extended_err serr;
+      (void)memcpy(&serr, CMSG_DATA(cmsg), sizeof(serr));
+      if (serr.ee_errno != 0 || serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      // The calls numbered in [ee_info, ee_data] are completed, tcp completes the calls in sending order.
+      zero_copy_done_seq_ = serr.ee_data + 1;
+    }
+  }
+  // The sequence numbers wrap around, compare their distance.
+  while (!zero_copy_pending_.empty() &&
+         static_cast<int32_t>(zero_copy_done_seq_ - zero_copy_pending_.front().first) >= 0) {
+    MessageBase *msg = zero_copy_pending_.front().second;
+    zero_copy_pending_.pop_front();
+    if (!FreeMessageMemory(msg)) {
+      MS_LOG(ERROR) << "Failed to free memory of the send message.";
+    }
+    delete msg;
+  }
+#endif
+}
+
 int Connection::AddConnnectEventHandler() {
   return recv_event_loop->SetEventHandler(socket_fd, EPOLLIN | EPOLLHUP | EPOLLERR, NewConnectEventHandler,
                                           reinterpret_cast<void *>(this));
@@ -17,12 +17,15 @@
 #ifndef MINDSPORE_CCSRC_DISTRIBUTED_RPC_TCP_CONNECTION_H_
 #define MINDSPORE_CCSRC_DISTRIBUTED_RPC_TCP_CONNECTION_H_
 
+#include <deque>
 #include <queue>
 #include <string>
+#include <utility>
 #include <mutex>
 #include <memory>
 
 #include "actor/msg.h"
+#include "include/backend/distributed/rpc/tcp/buffer_pool.h"
 #include "include/backend/distributed/rpc/tcp/constants.h"
 #include "distributed/rpc/tcp/event_loop.h"
 #include "distributed/rpc/tcp/socket_operation.h"
@@ -74,6 +77,16 @@ struct SendMetrics {
   std::string last_send_msg_name;
 };
 
+/*
+ * The parts of a message in the sending batch, they are referenced by the iovecs until the batch is sent.
+ */
+struct SendSlot {
+  MessageHeader header;
+  std::string to;
+  std::string from;
+  MessageBase *message{nullptr};
+};
+
 /*
  * Represents a TCP or SSL connection.
  */
@@ -112,6 +125,13 @@ struct Connection {
   // Send all the messages in the message queue.
   size_t Flush();
 
+  // Send the bodies of large messages with MSG_ZEROCOPY. Return false if the socket does not support zero copy.
+  bool EnableZeroCopy();
+
+  // Receive the MSG_ZEROCOPY completion notifications from the socket error queue and release the messages whose
+  // pages are no longer referenced by the kernel.
+  void HandleZeroCopyCompletion();
+
   /**
    * @description: Set callback to allocate memory for this connection when receiving message from the remote.
    * @param {MemAllocateCallback} &allocate_cb: The allocating memory callback.
@@ -119,6 +139,14 @@ struct Connection {
    */
   void SetAllocateCallback(const MemAllocateCallback &allocate_cb) { allocate_cb_ = allocate_cb; }
 
+  /**
+   * @description: Set the pool lending the body buffers of the received messages, it takes precedence over the
+   * allocating callback. The received messages are PooledMessage objects which return the buffers when deleted.
+   * @param {std::shared_ptr<MessageBufferPool>} &buffer_pool: The buffer pool.
+   * @return {void}
+   */
+  void SetMessageBufferPool(const std::shared_ptr<MessageBufferPool> &buffer_pool) { buffer_pool_ = buffer_pool; }
+
   /**
    * @description: Set callback to free message for this connection.
    * @param {MemFreeCallback} &free_cb: The callback which frees the real memory after message is sent to peer.
@@ -181,6 +209,10 @@ struct Connection {
   MessageBase *send_message;
   MessageBase *recv_message;
 
+  // The messages gathered into the current 'sendmsg' call, send_message is the first one.
+  SendSlot send_slots[SEND_MSG_BATCH_NUM];
+  size_t send_slot_num{0};
+
   // Owned by the tcp_comm.
   std::shared_ptr<std::mutex> conn_mutex;
 
@@ -194,13 +226,10 @@ struct Connection {
   size_t total_send_len;
   size_t recv_len;
 
-  std::string send_to;
-  std::string send_from;
   std::string recv_to;
   std::string recv_from;
 
   // Message header.
-  MessageHeader send_msg_header;
   MessageHeader recv_msg_header;
 
   // The message structure of kernel.
@@ -208,7 +237,7 @@ struct Connection {
   struct msghdr recv_kernel_msg;
 
   struct iovec recv_io_vec[RECV_MSG_IO_VEC_LEN];
-  struct iovec send_io_vec[SEND_MSG_IO_VEC_LEN];
+  struct iovec send_io_vec[SEND_MSG_IO_VEC_LEN * SEND_MSG_BATCH_NUM];
 
   ParseType recv_message_type{kTcpMsg};
 
@@ -232,9 +261,19 @@ struct Connection {
   // The method used to allocate memory when server receiving message from the remote.
   MemAllocateCallback allocate_cb_;
 
+  // The pool lending the body buffers of the received messages.
+  std::shared_ptr<MessageBufferPool> buffer_pool_;
+
   // The method used to free the memory after client sending data to the remote.
   MemFreeCallback free_cb_;
 
+  // Whether MSG_ZEROCOPY is enabled on this connection and whether the ongoing 'sendmsg' call uses it.
+  bool zero_copy_enabled{false};
+  bool send_zero_copy{false};
+
+  // The number of 'sendmsg' calls with MSG_ZEROCOPY which sent data, the kernel numbers the completions the same way.
+  uint32_t zero_copy_send_seq{0};
+
  private:
   // Add handler for socket connect event.
   int AddConnnectEventHandler();
@@ -248,6 +287,15 @@ struct Connection {
   // Make a http message based on given input message.
   std::string GenerateHttpMessage(MessageBase *msg);
 
+  // Gather the messages at the front of the send queue into send_kernel_msg.
+  void FillSendBatch();
+
+  // Point send_kernel_msg to the body of the message which is sent with MSG_ZEROCOPY.
+  void FillZeroCopyBody();
+
+  // Release the messages of the sent batch and return the number of body bytes sent.
+  size_t ReleaseSendBatch();
+
   // Change the header body from network byte order to host byte order.
   void ReorderHeader(MessageHeader *header) const;
 
@@ -266,6 +314,17 @@ struct Connection {
   size_t GetMessageBaseRealDataSize(const MessageBase *msg) const;
 
   std::string advertise_addr_;
+
+  // The last message of the batch whose body is sent with MSG_ZEROCOPY after the other parts of the batch, so the
+  // header slots reused by the next batch are never pinned by the kernel.
+  MessageBase *zero_copy_message_{nullptr};
+
+  // The messages sent with MSG_ZEROCOPY and the sequence number their completion notification ends with. Guarded by
+  // conn_mutex because the notifications are handled by the receiving event loop.
+  std::deque<std::pair<uint32_t, MessageBase *>> zero_copy_pending_;
+
+  // All the 'sendmsg' calls numbered below this one are completed.
+  uint32_t zero_copy_done_seq_{0};
 };
 }  // namespace rpc
 }  // namespace distributed
@@ -19,6 +19,8 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <securec.h>
@@ -192,6 +194,21 @@ bool EventLoop::Initialize(const std::string &threadName) {
   return true;
 }
 
+bool EventLoop::BindCore(int core_id) {
+  if (loop_thread_ == 0 || core_id < 0 || core_id >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(core_id, &cpu_set);
+  int retval = pthread_setaffinity_np(loop_thread_, sizeof(cpu_set), &cpu_set);
+  if (retval != 0) {
+    MS_LOG(WARNING) << "Failed to bind the event loop thread to core " << core_id << ", retval: " << retval;
+    return false;
+  }
+  return true;
+}
+
 void EventLoop::Finalize() {
   if (loop_thread_ > 0) {
     void *threadResult = nullptr;
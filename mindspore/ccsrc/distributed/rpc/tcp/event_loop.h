@@ -65,6 +65,9 @@ class EventLoop {
   bool Initialize(const std::string &threadName);
   void Finalize();
 
+  // Pin the loop thread to the specified cpu core.
+  bool BindCore(int core_id);
+
   // Add task (eg. send message, reconnect etc.) to task queue of the event loop.
   // These tasks are executed asynchronously.
   size_t AddTask(std::function<int()> &&task);
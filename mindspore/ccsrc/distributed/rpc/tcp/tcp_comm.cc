@@ -16,11 +16,16 @@
 
 #include "distributed/rpc/tcp/tcp_comm.h"
 
+#include <sched.h>
+#include <algorithm>
+#include <functional>
 #include <mutex>
 #include <utility>
 #include <memory>
+#include <vector>
 
 #include "actor/aid.h"
+#include "utils/ms_utils.h"
 #include "include/backend/distributed/rpc/tcp/constants.h"
 #include "distributed/rpc/tcp/tcp_socket_operation.h"
 
@@ -118,10 +123,11 @@ void OnAccept(int server, uint32_t events, void *arg) {
   conn->peer = conn->destination;
 
   conn->is_remote = true;
-  conn->recv_event_loop = tcpmgr->recv_event_loop_;
+  size_t loop_index = tcpmgr->SelectRecvEventLoop(conn->destination);
+  conn->recv_event_loop = tcpmgr->recv_event_loops_[loop_index];
   conn->send_event_loop = tcpmgr->send_event_loop_;
 
-  conn->conn_mutex = tcpmgr->conn_mutex_;
+  conn->conn_mutex = tcpmgr->recv_loop_mutexes_[loop_index];
   conn->message_handler = tcpmgr->message_handler_;
 
   conn->event_callback = std::bind(&TCPComm::EventCallBack, tcpmgr, std::placeholders::_1);
@@ -129,6 +135,7 @@ void OnAccept(int server, uint32_t events, void *arg) {
   conn->read_callback = std::bind(&TCPComm::ReadCallBack, tcpmgr, std::placeholders::_1);
 
   conn->SetAllocateCallback(tcpmgr->allocate_cb());
+  conn->SetMessageBufferPool(tcpmgr->buffer_pool_);
 
   int retval = conn->Initialize();
   if (retval != RPC_OK) {
@@ -186,9 +193,101 @@ bool TCPComm::Initialize() {
     return false;
   }
 
+  size_t recv_loop_num = 1;
+  std::string recv_loop_num_env = common::GetEnv(kEnvRpcRecvEventLoopNum);
+  if (!recv_loop_num_env.empty()) {
+    try {
+      recv_loop_num = std::min(std::max(std::stoul(recv_loop_num_env), 1UL), MAX_RECV_EVENT_LOOP_NUM);
+    } catch (const std::exception &e) {
+      MS_LOG(WARNING) << "Invalid " << kEnvRpcRecvEventLoopNum << ": " << recv_loop_num_env << ", use 1 event loop.";
+    }
+  }
+  return InitRecvEventLoops(recv_loop_num);
+}
+
+bool TCPComm::InitRecvEventLoops(size_t loop_num) {
+  recv_event_loops_.push_back(recv_event_loop_);
+  recv_loop_mutexes_.push_back(conn_mutex_);
+  for (size_t i = 1; i < loop_num; ++i) {
+    EventLoop *event_loop = new (std::nothrow) EventLoop();
+    if (event_loop == nullptr) {
+      MS_LOG(ERROR) << "Failed to create recv evLoop " << i;
+      return false;
+    }
+    if (!event_loop->Initialize(TCP_RECV_SHARD_EVLOOP_THREADNAME + std::to_string(i))) {
+      MS_LOG(ERROR) << "Failed to init recv evLoop " << i;
+      delete event_loop;
+      return false;
+    }
+    recv_event_loops_.push_back(event_loop);
+    recv_loop_mutexes_.push_back(std::make_shared<std::mutex>());
+  }
+
+  // Virtual nodes smooth the distribution, and adding a loop only moves the connections hashed to its nodes.
+  std::hash<std::string> hasher;
+  for (size_t i = 0; i < recv_event_loops_.size(); ++i) {
+    for (size_t j = 0; j < EVENT_LOOP_VIRTUAL_NODE_NUM; ++j) {
+      recv_loop_ring_[hasher("evloop#" + std::to_string(i) + "#" + std::to_string(j))] = i;
+    }
+  }
+  if (recv_event_loops_.size() > 1) {
+    BindRecvEventLoops();
+  }
+  MS_LOG(INFO) << "The number of receiving event loops is " << recv_event_loops_.size();
   return true;
 }
 
+void TCPComm::BindRecvEventLoops() {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    MS_LOG(WARNING) << "Failed to get the cpu affinity, the receiving event loops are not bound to cores.";
+    return;
+  }
+  std::vector<int> cores;
+  for (int core_id = 0; core_id < CPU_SETSIZE; ++core_id) {
+    if (CPU_ISSET(core_id, &cpu_set)) {
+      cores.push_back(core_id);
+    }
+  }
+  if (cores.size() < recv_event_loops_.size()) {
+    MS_LOG(INFO) << "There are fewer cores than the receiving event loops, the loops are not bound to cores.";
+    return;
+  }
+  // The compute threads bind the first cores, so the loops take the last ones.
+  for (size_t i = 0; i < recv_event_loops_.size(); ++i) {
+    (void)recv_event_loops_[i]->BindCore(cores[cores.size() - 1 - i]);
+  }
+}
+
+size_t TCPComm::SelectRecvEventLoop(const std::string &peer) const {
+  if (recv_loop_ring_.empty()) {
+    return 0;
+  }
+  auto iter = recv_loop_ring_.lower_bound(std::hash<std::string>()(peer));
+  if (iter == recv_loop_ring_.end()) {
+    iter = recv_loop_ring_.begin();
+  }
+  return iter->second;
+}
+
+int TCPComm::GetRecvEventLoopIndex(const std::string &peer) {
+  // The connection is only deleted by its loop holding the loop mutex, lock all of them in the order of the loops.
+  std::vector<std::unique_lock<std::mutex>> loop_locks;
+  for (auto &loop_mutex : recv_loop_mutexes_) {
+    loop_locks.emplace_back(*loop_mutex);
+  }
+  Connection *conn = conn_pool_->FindConnection(peer);
+  if (conn == nullptr) {
+    return -1;
+  }
+  auto iter = std::find(recv_event_loops_.begin(), recv_event_loops_.end(), conn->recv_event_loop);
+  if (iter == recv_event_loops_.end()) {
+    return -1;
+  }
+  return static_cast<int>(iter - recv_event_loops_.begin());
+}
+
 int TCPComm::StartServerSocket(const std::string &url, const MemAllocateCallback &allocate_cb) {
   server_fd_ = SocketOperation::Listen(url);
   if (server_fd_ < 0) {
@@ -366,11 +465,14 @@ bool TCPComm::Send(MessageBase *msg, size_t *const send_bytes, bool sync) {
       return false;
     }
 
-    if (conn->total_send_len == 0) {
-      conn->FillSendMessage(msg, url_, false);
-    } else {
-      (void)conn->send_message_queue.emplace(msg);
+    // The accepted connections on the sharded receiving loops are guarded by the mutex of their loop.
+    std::unique_lock<std::mutex> conn_lock;
+    if (conn->conn_mutex != conn_mutex_) {
+      conn_lock = std::unique_lock<std::mutex>(*conn->conn_mutex);
     }
+
+    // The queued messages are gathered and sent by as few 'sendmsg' calls as possible.
+    (void)conn->send_message_queue.emplace(msg);
     auto bytes = conn->Flush();
     if (send_bytes != nullptr) {
       *send_bytes = bytes;
@@ -435,6 +537,9 @@ bool TCPComm::Connect(const std::string &dst_url, const MemFreeCallback &free_cb
     }
 
     conn->socket_fd = sock_fd;
+    if (!enable_ssl_ && common::GetEnv(kEnvEnableRpcZeroCopy) == "1") {
+      (void)conn->EnableZeroCopy();
+    }
     conn->event_callback = std::bind(&TCPComm::EventCallBack, this, std::placeholders::_1);
     conn->write_callback = std::bind(&TCPComm::WriteCallBack, this, std::placeholders::_1);
     conn->read_callback = std::bind(&TCPComm::ReadCallBack, this, std::placeholders::_1);
@@ -505,6 +610,10 @@ bool TCPComm::Disconnect(const std::string &dst_url) {
   std::lock_guard<std::mutex> lock(*conn_mutex_);
   auto conn = conn_pool_->FindConnection(dst_url);
   if (conn != nullptr) {
+    std::unique_lock<std::mutex> loop_lock;
+    if (conn->conn_mutex != conn_mutex_) {
+      loop_lock = std::unique_lock<std::mutex>(*conn->conn_mutex);
+    }
     std::lock_guard<std::mutex> conn_lock(conn->conn_owned_mutex_);
     conn_pool_->DeleteConnection(dst_url);
   }
@@ -536,6 +645,15 @@ void TCPComm::Finalize() {
     send_event_loop_ = nullptr;
   }
 
+  // The first one is recv_event_loop_ which is deleted below.
+  for (size_t i = 1; i < recv_event_loops_.size(); ++i) {
+    recv_event_loops_[i]->Finalize();
+    delete recv_event_loops_[i];
+  }
+  recv_event_loops_.clear();
+  recv_loop_mutexes_.clear();
+  recv_loop_ring_.clear();
+
   if (recv_event_loop_ != nullptr) {
     MS_LOG(INFO) << "Delete recv event loop";
     recv_event_loop_->Finalize();
@@ -21,6 +21,7 @@
 #include <string>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "actor/msg.h"
 #include "distributed/rpc/tcp/connection.h"
@@ -78,12 +79,22 @@ class TCPComm {
 
   const std::string &GetClientSrcIP(const std::string &dst_url) { return dst_url_to_src_ip_[dst_url]; }
 
+  // Select the receiving event loop for the connection from the peer, the peer is formatted as 'ip:port'.
+  size_t SelectRecvEventLoop(const std::string &peer) const;
+
+  // Return the index of the receiving event loop handling the connection accepted from the peer, or -1 if the peer is
+  // not connected.
+  int GetRecvEventLoopIndex(const std::string &peer);
+
   /**
    * @description: Returns the allocating callback.
    * @return {const MemAllocateCallback &}
    */
   const MemAllocateCallback &allocate_cb() const { return allocate_cb_; }
 
+  // Lend the body buffers of the messages received by the accepted connections from the pool, see PooledMessage.
+  void SetMessageBufferPool(const std::shared_ptr<MessageBufferPool> &buffer_pool) { buffer_pool_ = buffer_pool; }
+
  private:
   // Build the connection.
   Connection *CreateDefaultConn(const std::string &to);
@@ -100,6 +111,13 @@ class TCPComm {
 
   static void DropMessage(MessageBase *msg);
 
+  // Create the extra receiving event loops and build the consistent hash ring over all of them.
+  bool InitRecvEventLoops(size_t loop_num);
+
+  // Pin the receiving event loops to the last cores this process is allowed to run on.
+  void BindRecvEventLoops();
+
+
   // Read and write events.
   void ReadCallBack(void *conn);
   void WriteCallBack(void *conn);
@@ -115,10 +133,18 @@ class TCPComm {
   // User defined handler for Handling received messages.
   MessageHandler message_handler_;
 
-  // All the connections share the same read and write event loop objects.
+  // All the connections share the same write event loop object. The connections created by this TCPComm and the
+  // server socket use recv_event_loop_.
   EventLoop *recv_event_loop_;
   EventLoop *send_event_loop_;
 
+  // The event loops receiving messages from the accepted connections, the first one is recv_event_loop_. Connections
+  // are spread over the loops by consistent hashing of the peer address, and guarded by the mutex of their loop instead
+  // of conn_mutex_ so that the loops do not serialize on one lock.
+  std::vector<EventLoop *> recv_event_loops_;
+  std::vector<std::shared_ptr<std::mutex>> recv_loop_mutexes_;
+  std::map<size_t, size_t> recv_loop_ring_;
+
   // The connection pool used to store new connections.
   std::shared_ptr<ConnectionPool> conn_pool_;
 
@@ -128,6 +154,9 @@ class TCPComm {
   // The method used to allocate memory when tcp servers of this TcpComm receive message from the remote.
   MemAllocateCallback allocate_cb_;
 
+  // The pool lending the body buffers of the received messages, it takes precedence over allocate_cb_.
+  std::shared_ptr<MessageBufferPool> buffer_pool_;
+
   bool enable_ssl_;
 
   friend void OnAccept(int server, uint32_t events, void *arg);
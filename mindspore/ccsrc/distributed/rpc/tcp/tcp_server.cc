@@ -47,6 +47,7 @@ bool TCPServer::InitializeImpl(const std::string &url, const MemAllocateCallback
     if (!rt) {
       MS_LOG(EXCEPTION) << "Failed to initialize tcp comm";
     }
+    tcp_comm_->SetMessageBufferPool(buffer_pool_);
     if (url != "") {
       rt = (tcp_comm_->StartServerSocket(url, allocate_cb) == 0) ? true : false;
       ip_ = SocketOperation::GetIP(url);
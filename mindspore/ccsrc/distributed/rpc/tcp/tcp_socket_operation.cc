@@ -123,11 +123,24 @@ int TCPSocketOperation::SendMessage(Connection *connection, struct msghdr *sendM
   const int print_interval = 10000;
   const int sleep_interval_factor = 10;
   *sendLen = 0;
+  bool zero_copy = connection->send_zero_copy;
 
   while (*sendLen != totalSendLen) {
-    auto retval = sendmsg(connection->socket_fd, sendMsg, MSG_NOSIGNAL);
+    int flags = MSG_NOSIGNAL;
+#ifdef MSG_ZEROCOPY
+    if (zero_copy) {
+      flags |= MSG_ZEROCOPY;
+    }
+#endif
+    auto retval = sendmsg(connection->socket_fd, sendMsg, flags);
     if (retval < 0) {
       ++eagainCount;
+      if (errno == ENOBUFS && zero_copy) {
+        // The pinned pages exceed the socket option memory limit, copy the rest of the body instead.
+        MS_LOG(INFO) << "Failed to call sendmsg with MSG_ZEROCOPY, fall back to copying.";
+        zero_copy = false;
+        continue;
+      }
       if (errno != EAGAIN) {
         MS_LOG(WARNING) << "Failed to call sendmsg and errno is: " << errno << " " << strerror(errno);
         connection->error_code = errno;
@@ -136,7 +149,7 @@ int TCPSocketOperation::SendMessage(Connection *connection, struct msghdr *sendM
         MS_LOG(WARNING) << "Failed to call sendmsg after retry " + std::to_string(EAGAIN_RETRY) +
                              " times and errno is: "
                         << errno << " " << strerror(errno);
-        *sendLen = 0;
+        // Return the bytes already sent, the iovecs have been moved forward by them.
         return IO_RW_OK;
       }
       if (eagainCount % print_interval == 0) {
@@ -147,6 +160,9 @@ int TCPSocketOperation::SendMessage(Connection *connection, struct msghdr *sendM
     } else {
       size_t send_bytes = static_cast<size_t>(retval);
       *sendLen += send_bytes;
+      if (zero_copy) {
+        ++connection->zero_copy_send_seq;
+      }
 
       if (*sendLen == totalSendLen) {
         sendMsg->msg_iovlen = 0;
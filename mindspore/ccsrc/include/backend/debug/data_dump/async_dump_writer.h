@@ -0,0 +1,106 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_MINDSPORE_CCSRC_DEBUG_DATA_DUMP_ASYNC_DUMP_WRITER_H_
+#define MINDSPORE_MINDSPORE_CCSRC_DEBUG_DATA_DUMP_ASYNC_DUMP_WRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "utils/ms_utils.h"
+#include "utils/shape_utils.h"
+#include "ir/dtype/type_id.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+constexpr size_t kDefaultAsyncDumpThreadNum = 2;
+
+// Writer of the e2e dump files in the background, enabled by "async_write" of e2e_dump_settings in the dump config.
+// Submit only stalls the kernel thread to snapshot the tensor into a staging buffer, the io threads write the npy file
+// and append the statistics of the snapshot to statistic.csv of the dump directory through TensorStatDump.
+// With "compression": "lz4" the npy file is written as a lz4 frame (".npy.lz4"), readable by the lz4 tool.
+// The staging buffers are reused and bounded by "staging_size" MB. A tensor that does not fit in them any more is
+// not copied, only its statistics are dumped in place, so a slow disk degrades the dump instead of blocking the step.
+class BACKEND_EXPORT AsyncDumpWriter {
+ public:
+  AsyncDumpWriter(size_t thread_num, size_t staging_size, bool compress);
+  ~AsyncDumpWriter();
+  DISABLE_COPY_AND_ASSIGN(AsyncDumpWriter)
+
+  // The writer of the dump config, nullptr when the config does not enable async_write.
+  static AsyncDumpWriter *GetInstance();
+  // Wait for and stop the writer of the dump config.
+  static void Finalize();
+
+  // Queue the data to be written to filename + ".npy", it is copied before returning. The file name is
+  // op_type.op_name.task_id.stream_id.timestamp.io.slot.format as in the synchronous dump.
+  void Submit(const std::string &filename, const void *data, size_t len, const ShapeVector &shape, TypeId type);
+  // Wait until all the submitted tensors are written.
+  void Wait();
+  // Number of tensors dumped with statistics only since the writer was created.
+  size_t degraded_count() const { return degraded_count_.load(); }
+
+  // Compress the data into a lz4 frame of independent blocks, without checksums.
+  static void CompressLz4Frame(const std::vector<std::pair<const void *, size_t>> &parts, std::string *output);
+
+ private:
+  struct DumpTask {
+    std::string filename;
+    ShapeVector shape;
+    TypeId type{kTypeUnknown};
+    size_t len{0};
+    // Snapshot of the data.
+    std::unique_ptr<uint8_t[]> buffer;
+    size_t capacity{0};
+  };
+
+  void WorkerLoop();
+  void Process(DumpTask *task);
+  bool WriteTensor(const DumpTask &task);
+  void WriteStat(const std::string &filename, const void *data, size_t len, const ShapeVector &shape, TypeId type);
+  std::unique_ptr<uint8_t[]> AcquireBuffer(size_t len, size_t *capacity);
+  void ReleaseBuffer(std::unique_ptr<uint8_t[]> buffer, size_t capacity);
+
+  size_t staging_size_;
+  bool compress_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable task_cond_;
+  std::condition_variable idle_cond_;
+  std::deque<std::unique_ptr<DumpTask>> tasks_;
+  size_t running_tasks_{0};
+  bool stop_{false};
+  // Bytes of the staging buffers, in use or free.
+  size_t staged_bytes_{0};
+  size_t in_use_bytes_{0};
+  std::multimap<size_t, std::unique_ptr<uint8_t[]>> free_buffers_;
+  std::atomic<size_t> degraded_count_{0};
+
+  // The rows of the io threads and of the degraded tensors are appended to the same statistic.csv.
+  std::mutex stat_mutex_;
+
+  inline static std::unique_ptr<AsyncDumpWriter> instance_ = nullptr;
+  inline static std::once_flag instance_flag_;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_MINDSPORE_CCSRC_DEBUG_DATA_DUMP_ASYNC_DUMP_WRITER_H_
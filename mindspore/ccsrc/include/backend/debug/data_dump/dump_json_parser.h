@@ -23,6 +23,7 @@
 #include <mutex>
 #include <vector>
 #include <memory>
+#include <optional>
 #include "nlohmann/json.hpp"
 #include "utils/ms_utils.h"
 #include "include/backend/kernel_graph.h"
@@ -45,6 +46,8 @@ class BACKEND_EXPORT DumpJsonParser {
   void Parse();
   static bool DumpToFile(const std::string &filename, const void *data, size_t len, const ShapeVector &shape,
                          TypeId type);
+  // Map the name of the dump file if it is too long and create its directory, return the path to write.
+  static std::optional<std::string> GenerateDumpFilePath(const std::string &origin_file_path);
   void CopyDumpJsonToDir(uint32_t rank_id);
   void CopyHcclJsonToDir(uint32_t rank_id);
   void CopyMSCfgJsonToDir(uint32_t rank_id);
@@ -66,6 +69,9 @@ class BACKEND_EXPORT DumpJsonParser {
   std::string net_name() const { return net_name_; }
   uint32_t op_debug_mode() const { return op_debug_mode_; }
   bool trans_flag() const { return trans_flag_; }
+  bool async_write() const { return async_write_; }
+  bool lz4_compression() const { return lz4_compression_; }
+  size_t staging_size() const { return staging_size_; }
   uint32_t cur_dump_iter() const { return cur_dump_iter_; }
   uint32_t input_output() const { return input_output_; }
   void UpdateDumpIter() { ++cur_dump_iter_; }
@@ -112,6 +118,9 @@ class BACKEND_EXPORT DumpJsonParser {
   uint32_t op_debug_mode_{0};
   JsonFileFormat file_format_{FORMAT_BIN};
   bool trans_flag_{false};
+  bool async_write_{false};
+  bool lz4_compression_{false};
+  size_t staging_size_{0};
   uint32_t cur_dump_iter_{0};
   bool already_parsed_{false};
   bool dump_enabled_warning_printed_{false};
@@ -122,6 +131,7 @@ class BACKEND_EXPORT DumpJsonParser {
 
   void ParseCommonDumpSetting(const nlohmann::json &content);
   void ParseE2eDumpSetting(const nlohmann::json &content);
+  void ParseAsyncWriteSetting(const nlohmann::json &content);
 
   static auto CheckJsonKeyExist(const nlohmann::json &content, const std::string &key);
 
@@ -50,6 +50,15 @@ static constexpr size_t kMaxIdsPerThread = 10000;
 
 // Prefetch 16 batchs data once.
 static constexpr size_t kMultiBatchThreshold = 16;
+// The maximum number of batches prefetched once.
+static constexpr size_t kMaxMultiBatchThreshold = 1024;
+// The environment variable used to set the lookahead step number of the cache prefetch, the ids of these steps are
+// deduplicated and prefetched together.
+constexpr char kEnvEmbeddingCachePrefetchSteps[] = "MS_EMBEDDING_CACHE_PREFETCH_STEPS";
+
+// Get the lookahead step number of the cache prefetch. It is kEnvEmbeddingCachePrefetchSteps for a single worker if
+// the variable is set, otherwise kMultiBatchThreshold for a single worker and 1 for multiple workers.
+BACKEND_EXPORT size_t GetMultiBatchThreshold(size_t worker_num);
 
 using mindspore::device::DeviceAddress;
 using mindspore::kernel::Address;
@@ -346,7 +355,7 @@ class BACKEND_EXPORT EmbeddingCacheTableManager {
   // If the storage format is sparse or dense, the default format is dense.
   bool sparse_format_{false};
 
-  // The batch number once cache prefetch.
+  // The batch number once cache prefetch, that is the lookahead step number of the cache prefetch.
   size_t multi_batch_threshold_;
 
   // Record whether multi-stage pipeline cache prefetch is enabled.
@@ -0,0 +1,97 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_DISTRIBUTED_RPC_TCP_BUFFER_POOL_H_
+#define MINDSPORE_CCSRC_DISTRIBUTED_RPC_TCP_BUFFER_POOL_H_
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "actor/msg.h"
+#include "include/backend/distributed/constants.h"
+#include "utils/ms_utils.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace distributed {
+namespace rpc {
+// The buffers released to the pool are kept for reuse up to this size in total.
+constexpr size_t kDefaultMaxCachedBufferSize = 1UL << 30;
+
+/*
+ * The MessageBufferPool caches the message body buffers in power of two size classes, so the server receiving messages
+ * of similar sizes reuses the buffers instead of allocating and zero filling new ones for every message. Set it with
+ * TCPServer::SetMessageBufferPool before initializing the server, then the received messages are PooledMessage objects
+ * and deleting them returns their buffers. It also works as a plain allocate callback, whose buffers the caller
+ * releases with Free.
+ */
+class BACKEND_EXPORT MessageBufferPool {
+ public:
+  explicit MessageBufferPool(size_t max_cached_size = kDefaultMaxCachedBufferSize);
+  ~MessageBufferPool();
+
+  // Return a buffer of at least size bytes.
+  void *Allocate(size_t size);
+
+  // Return the buffer allocated by this pool to the pool.
+  bool Free(void *data);
+
+  MemAllocateCallback allocate_cb();
+  MemFreeCallback free_cb();
+
+  // The total size of the cached buffers which are not in use.
+  size_t cached_size() const;
+
+ private:
+  // The index of the smallest size class holding size bytes.
+  static size_t SizeClass(size_t size);
+
+  mutable std::mutex mutex_;
+  // The buffers in use and their size classes.
+  std::unordered_map<void *, size_t> in_use_;
+  std::vector<std::vector<void *>> free_lists_;
+  size_t cached_size_{0};
+  size_t max_cached_size_;
+
+  DISABLE_COPY_AND_ASSIGN(MessageBufferPool);
+};
+
+/*
+ * The PooledMessage owns its body buffer `data` borrowed from a MessageBufferPool and returns it to the pool when the
+ * message is deleted, so the message handler releases a received message the same way whether it is pooled or not.
+ */
+class BACKEND_EXPORT PooledMessage : public MessageBase {
+ public:
+  // Borrow a buffer of size bytes from the pool as the message body, `data` is nullptr if the pool is out of memory.
+  PooledMessage(const std::shared_ptr<MessageBufferPool> &pool, size_t size);
+  ~PooledMessage() override;
+
+  // Take the ownership of the body buffer, the caller returns it with MessageBufferPool::Free later.
+  void *ReleaseData();
+
+ private:
+  // Holding the pool keeps it alive until the last message borrowing from it is deleted.
+  std::shared_ptr<MessageBufferPool> pool_;
+
+  DISABLE_COPY_AND_ASSIGN(PooledMessage);
+};
+}  // namespace rpc
+}  // namespace distributed
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_DISTRIBUTED_RPC_TCP_BUFFER_POOL_H_
@@ -35,6 +35,24 @@ using ConnectionCallBack = std::function<void(void *connection)>;
 constexpr int SEND_MSG_IO_VEC_LEN = 5;
 constexpr int RECV_MSG_IO_VEC_LEN = 4;
 
+// The max number of queued messages gathered into one 'sendmsg' call.
+constexpr size_t SEND_MSG_BATCH_NUM = 16;
+
+// The message body no smaller than this threshold is sent with MSG_ZEROCOPY if zero copy is enabled. The page pinning
+// and completion notification cost more than copying for small messages.
+constexpr size_t ZERO_COPY_THRESHOLD = 65536;
+
+// Set this environment variable to 1 to send large messages with MSG_ZEROCOPY on the tcp connections.
+constexpr char kEnvEnableRpcZeroCopy[] = "MS_ENABLE_RPC_ZERO_COPY";
+
+// The number of event loops receiving messages from the connections accepted by a server, 1 by default. The loops run
+// the message handler concurrently, so it must be thread safe if more than one loop is set.
+constexpr char kEnvRpcRecvEventLoopNum[] = "MS_RPC_RECV_EVENT_LOOP_NUM";
+constexpr size_t MAX_RECV_EVENT_LOOP_NUM = 64;
+
+// The number of virtual nodes of every receiving event loop on the consistent hash ring.
+constexpr size_t EVENT_LOOP_VIRTUAL_NODE_NUM = 64;
+
 constexpr unsigned int MAGICID_LEN = 4;
 constexpr int SENDMSG_QUEUELEN = 1024;
 constexpr int SENDMSG_DROPED = -1;
@@ -75,6 +93,7 @@ static const int SOCKET_KEEPCOUNT = 3;
 static const char RPC_MAGICID[] = "RPC0";
 static const char TCP_RECV_EVLOOP_THREADNAME[] = "RECV_EVENT_LOOP";
 static const char TCP_SEND_EVLOOP_THREADNAME[] = "SEND_EVENT_LOOP";
+static const char TCP_RECV_SHARD_EVLOOP_THREADNAME[] = "RECV_EVLOOP_";
 
 constexpr int RPC_OK = 0;
 constexpr int RPC_ERROR = -1;
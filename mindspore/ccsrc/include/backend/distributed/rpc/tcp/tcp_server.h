@@ -21,6 +21,7 @@
 #include <memory>
 
 #include "include/backend/distributed/rpc/rpc_server_base.h"
+#include "include/backend/distributed/rpc/tcp/buffer_pool.h"
 #include "distributed/rpc/tcp/tcp_comm.h"
 #include "utils/ms_utils.h"
 #include "include/backend/visible.h"
@@ -42,6 +43,10 @@ class BACKEND_EXPORT TCPServer : public RPCServerBase {
   // Init the tcp server using local IP and random port.
   bool Initialize(const MemAllocateCallback &allocate_cb = {}) override;
 
+  // Receive the message bodies into the buffers borrowed from the pool instead of the allocate callback. It must be
+  // called before initializing the server, and the message handler frees the received messages by deleting them.
+  void SetMessageBufferPool(const std::shared_ptr<MessageBufferPool> &buffer_pool) { buffer_pool_ = buffer_pool; }
+
   // Destroy the tcp server.
   void Finalize() override;
 
@@ -60,6 +65,8 @@ class BACKEND_EXPORT TCPServer : public RPCServerBase {
   // The basic TCP communication component used by the server.
   std::unique_ptr<TCPComm> tcp_comm_;
 
+  std::shared_ptr<MessageBufferPool> buffer_pool_;
+
   DISABLE_COPY_AND_ASSIGN(TCPServer);
 };
 }  // namespace rpc
@@ -17,6 +17,9 @@
 #ifndef MINDSPORE_CCSRC_RUNTIME_PROFILER_PROFILER_H_
 #define MINDSPORE_CCSRC_RUNTIME_PROFILER_PROFILER_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
 #include <list>
 #include <map>
 #include <memory>
@@ -93,6 +96,8 @@ enum class ProfilerEvent {
   do {                                                                      \
     if (runtime::ProfilerAnalyzer::GetInstance().profiler_enable()) {       \
       start_time = runtime::ProfilerAnalyzer::GetInstance().GetTimeStamp(); \
+    } else if (runtime::RuntimeTracer::GetInstance().enable()) {            \
+      start_time = runtime::RuntimeTracer::GetTicks();                      \
     }                                                                       \
   } while (0);
 
@@ -104,19 +109,118 @@ enum class ProfilerEvent {
       auto brief_name = runtime::ProfilerAnalyzer::GetInstance().GetBriefName(op_name);                            \
       runtime::ProfilerAnalyzer::GetInstance().RecordData(                                                         \
         std::make_shared<runtime::ProfilerData>(module, event, brief_name, is_inner_event, start_time, end_time)); \
+    } else if (runtime::RuntimeTracer::GetInstance().enable()) {                                                   \
+      auto &tracer = runtime::RuntimeTracer::GetInstance();                                                        \
+      tracer.Record(module, event, tracer.InternName(op_name), start_time, runtime::RuntimeTracer::GetTicks());    \
     }                                                                                                              \
   } while (0);
 
 // Match PROFILER_START to use.
-#define PROFILER_STAGE_END(start_time, stage)                                  \
-  do {                                                                         \
-    if (runtime::ProfilerAnalyzer::GetInstance().profiler_enable()) {          \
-      auto end_time = runtime::ProfilerAnalyzer::GetInstance().GetTimeStamp(); \
-      runtime::ProfilerAnalyzer::GetInstance().RecordData(                     \
-        std::make_shared<runtime::ProfilerData>(stage, start_time, end_time)); \
-    }                                                                          \
+#define PROFILER_STAGE_END(start_time, stage)                                                                    \
+  do {                                                                                                           \
+    if (runtime::ProfilerAnalyzer::GetInstance().profiler_enable()) {                                            \
+      auto end_time = runtime::ProfilerAnalyzer::GetInstance().GetTimeStamp();                                   \
+      runtime::ProfilerAnalyzer::GetInstance().RecordData(                                                       \
+        std::make_shared<runtime::ProfilerData>(stage, start_time, end_time));                                   \
+    } else if (runtime::RuntimeTracer::GetInstance().enable()) {                                                 \
+      runtime::RuntimeTracer::GetInstance().RecordStage(stage, start_time, runtime::RuntimeTracer::GetTicks()); \
+    }                                                                                                            \
   } while (0);
 
+// The always-on runtime trace, enabled by MS_ENABLE_RUNTIME_TRACE=1 when the runtime profiler is off. Every thread
+// records fixed-size events with cpu tick timestamps into its own ring buffer without locks, and a background thread
+// flushes the buffers every MS_RUNTIME_TRACE_FLUSH_INTERVAL milliseconds to a Chrome trace json file, which can be
+// opened by chrome://tracing or Perfetto. Events of all threads share one clock, so actors, kernels and data queues
+// line up across threads.
+class COMMON_EXPORT RuntimeTracer {
+ public:
+  static RuntimeTracer &GetInstance() noexcept;
+
+  // The cpu tick counter, converted to microseconds when the trace is flushed.
+  static uint64_t GetTicks() noexcept;
+
+  bool enable() const { return enable_.load(std::memory_order_relaxed); }
+  // Start tracing to the file, the env enables it at the first use. Disable flushes the remaining records.
+  void Enable(const std::string &file_name, size_t flush_interval);
+  void Disable();
+
+  // Get the id of the brief name of an op, names are interned once and the records only keep the id.
+  uint32_t InternName(const std::string &op_name);
+  void Record(ProfilerModule module, ProfilerEvent event, uint32_t name_id, uint64_t start_ticks,
+              uint64_t end_ticks) noexcept;
+  void RecordStage(ProfilerStage stage, uint64_t start_ticks, uint64_t end_ticks) noexcept;
+  void SetThreadName(const std::string &name);
+
+  // Write the records in the buffers to the trace file.
+  void Flush();
+
+  // The buffers of the running threads and the recycled ones.
+  size_t buffer_num();
+
+ private:
+  // 24 bytes per event, the stage records use kStageModule as module and the stage as event.
+  struct TraceRecord {
+    uint64_t start_ticks_;
+    uint64_t end_ticks_;
+    uint32_t name_id_;
+    uint16_t module_;
+    uint16_t event_;
+  };
+
+  // Single producer ring buffer, written by its thread and drained by the flush.
+  struct ThreadBuffer {
+    ThreadBuffer();
+    std::unique_ptr<TraceRecord[]> records_;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+    // Set when the thread exits, the buffer is recycled once the flush has drained it.
+    std::atomic<bool> retired_{false};
+    uint32_t tid_{0};
+    std::string name_;
+    bool name_dumped_{false};
+    // The name ids interned by the threads of this buffer, only accessed by the thread. The ids stay valid when the
+    // buffer is recycled.
+    mindspore::HashMap<std::string, uint32_t> name_cache_;
+  };
+  using ThreadBufferPtr = std::shared_ptr<ThreadBuffer>;
+
+  RuntimeTracer();
+  ~RuntimeTracer();
+  DISABLE_COPY_AND_ASSIGN(RuntimeTracer);
+
+  ThreadBuffer *GetThreadBuffer();
+  void Push(const TraceRecord &record) noexcept;
+  void FlushLoop();
+  void CalibrateTicks();
+  void DumpRecord(const TraceRecord &record, uint32_t tid, std::string *out) const;
+
+  std::atomic<bool> enable_{false};
+  // Protects the registered buffers, the recycled buffers and the interned names.
+  std::mutex mutex_;
+  std::vector<ThreadBufferPtr> buffers_;
+  std::vector<ThreadBufferPtr> free_buffers_;
+  uint32_t next_tid_{0};
+  mindspore::HashMap<std::string, uint32_t> name_ids_;
+  std::vector<std::string> names_;
+
+  // Serializes the flushes and guards the members below.
+  std::mutex flush_mutex_;
+  // The clock of the ticks, calibrated against steady_clock once.
+  uint64_t base_ticks_{0};
+  uint64_t base_time_ns_{0};
+  double ticks_per_us_{0};
+  // The interned names copied out by the flush, so the records are formatted without holding mutex_.
+  std::vector<std::string> flush_names_;
+  std::string file_name_;
+  std::FILE *file_{nullptr};
+  size_t flush_interval_{0};
+  int pid_{0};
+  std::thread flush_thread_;
+  std::condition_variable flush_cond_;
+  bool stop_{false};
+};
+
 // Record the profiler data by the constructor and destructor of this class.
 class COMMON_EXPORT ProfilerRecorder {
  public:
@@ -141,6 +245,11 @@ class COMMON_EXPORT ProfilerRecorder {
 
  private:
   std::unique_ptr<Data> data_{nullptr};
+  // The event recorded by the runtime trace.
+  ProfilerModule trace_module_{ProfilerModule::kDefault};
+  ProfilerEvent trace_event_{ProfilerEvent::kDefault};
+  uint32_t trace_name_id_{0};
+  uint64_t trace_start_ticks_{0};
 };
 
 class COMMON_EXPORT ProfilerStageRecorder {
@@ -0,0 +1,81 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_INCLUDE_COMMON_UTILS_CHECKPOINT_WRITER_H_
+#define MINDSPORE_CCSRC_INCLUDE_COMMON_UTILS_CHECKPOINT_WRITER_H_
+
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ir/tensor.h"
+#include "include/common/visible.h"
+
+namespace mindspore {
+constexpr size_t kDefaultCheckpointShardNum = 8;
+constexpr char kCheckpointManifestName[] = "manifest.json";
+
+using NamedTensors = std::vector<std::pair<std::string, tensor::TensorPtr>>;
+
+// Sharded checkpoint written in the background. A checkpoint is a directory holding the shard files and a manifest:
+//   shard_<save id>_<i>.ckpt  byte order flag and padding, then whole tensors, each at a kCheckpointAlign bytes aligned
+//                             offset. The save id is unique to each save, so no save overwrites the shards of another.
+//   manifest.json             name, data type, shape, file and offset of every tensor, written last. An incremental
+//                             save also records the SHA-256 digest of every tensor.
+// Save only stalls the caller to snapshot the tensors into host buffers, the shards are written in the background. An
+// incremental save snapshots and writes only the tensors whose size or digest changed since the last save of this
+// writer, the manifest refers the others to the shard files of the earlier checkpoints, which must be kept. Only the
+// incremental saves digest the tensors, so the first incremental save after a full one writes all tensors.
+class COMMON_EXPORT CheckpointWriter {
+ public:
+  explicit CheckpointWriter(size_t shard_num = kDefaultCheckpointShardNum) : shard_num_(shard_num) {}
+  ~CheckpointWriter();
+
+  // Snapshot the tensors and start writing them to the directory path. It waits for the previous save first.
+  bool Save(const std::string &path, const NamedTensors &tensors, bool incremental = false);
+  // Wait for the running save, return whether it succeeded.
+  bool Wait();
+
+  // Load the tensors of a checkpoint, the shard files are read concurrently. With mmap_load the tensors borrow the
+  // pages of the mapped shard files instead, which are read on first access.
+  static bool Load(const std::string &path, bool mmap_load, NamedTensors *tensors);
+
+ private:
+  struct TensorRecord {
+    TypeId data_type{kTypeUnknown};
+    ShapeVector shape;
+    size_t nbytes{0};
+    std::string digest;
+    // Absolute path of the shard file holding the tensor.
+    std::string file;
+    size_t offset{0};
+  };
+  using TensorRecords = std::vector<std::pair<std::string, TensorRecord>>;
+
+  bool WriteCheckpoint(const std::string &path, const std::string &save_id, const TensorRecords &records,
+                       size_t shard_count);
+
+  size_t shard_num_;
+  // Snapshot buffer of each shard, kept between saves to avoid allocating them again.
+  std::vector<std::vector<uint8_t>> shard_buffers_;
+  std::future<bool> running_save_;
+  // Records of the last successful save, compared by the incremental saves.
+  std::map<std::string, TensorRecord> last_records_;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_INCLUDE_COMMON_UTILS_CHECKPOINT_WRITER_H_
@@ -141,6 +141,7 @@ void RegModule(py::module *m) {
   mindspore::initializer::RegRandomNormal(m);
   RegMsContext(m);
   RegSecurity(m);
+  RegCheckpointWriter(m);
   mindspore::pynative::RegPyNativeExecutor(m);
   mindspore::prim::RegCompositeOpsGroup(m);
 #ifndef ENABLE_SECURITY
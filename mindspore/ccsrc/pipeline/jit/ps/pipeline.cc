@@ -92,6 +92,7 @@
 
 #ifndef ENABLE_SECURITY
 #include "include/backend/debug/data_dump/dump_json_parser.h"
+#include "include/backend/debug/data_dump/async_dump_writer.h"
 #include "abstract/abstract_value.h"
 #endif
 #if defined(__linux__) && defined(WITH_BACKEND)
@@ -2317,6 +2318,7 @@ void ClearSingleton() {
   device::KernelRuntimeManager::Instance().Clear();
   OpPrimPyRegister::GetInstance().Clear();
 #ifndef ENABLE_SECURITY
+  AsyncDumpWriter::Finalize();
   DumpJsonParser::Finalize();
 #endif
   CommManager::Clear();
@@ -31,6 +31,12 @@
 #include <fstream>
 #include <chrono>
 #include <mutex>
+#include <shared_mutex>
+#include <array>
+#include <optional>
+#include <climits>
+#include <algorithm>
+#include <iterator>
 
 #include "pipeline/jit/ps/static_analysis/static_analysis.h"
 #include "utils/hash_map.h"
@@ -214,6 +220,99 @@ class NormalCache {
   CacheType cache_;
 };
 
+// Cache split into shards by the hash of the key, each shard is guarded by its own reader-writer lock, so the
+// lookups of the infer threads do not contend with each other and a writer only blocks one shard. No reference into
+// a shard is handed out, find copies the stored item and items copies the whole cache under the shard locks.
+template <typename KeyType, typename ValueType, typename CacheType>
+class ShardedCache {
+ public:
+  using value_type = std::pair<KeyType, ValueType>;
+  static constexpr size_t kShardNum = 16;
+
+  ValueType get(const KeyType &key) const {
+    const auto &shard = GetShard(key);
+    std::shared_lock<std::shared_mutex> lock(shard.lock);
+    auto it = shard.cache.find(key);
+    if (it != shard.cache.end()) {
+      return it->second;
+    }
+    return nullptr;
+  }
+
+  // The key of the returned item is the one stored in the cache, which may be a different object equal to the key.
+  std::optional<value_type> find(const KeyType &key) const {
+    const auto &shard = GetShard(key);
+    std::shared_lock<std::shared_mutex> lock(shard.lock);
+    auto it = shard.cache.find(key);
+    if (it == shard.cache.end()) {
+      return std::nullopt;
+    }
+    return value_type(it->first, it->second);
+  }
+
+  void set(const KeyType &key, const ValueType &data) {
+    auto &shard = GetShard(key);
+    std::unique_lock<std::shared_mutex> lock(shard.lock);
+    shard.cache[key] = data;
+  }
+
+  void clear() {
+    for (auto &shard : shards_) {
+      std::unique_lock<std::shared_mutex> lock(shard.lock);
+      shard.cache.clear();
+    }
+  }
+
+  size_t size() const {
+    size_t total = 0;
+    for (const auto &shard : shards_) {
+      std::shared_lock<std::shared_mutex> lock(shard.lock);
+      total += shard.cache.size();
+    }
+    return total;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  std::vector<value_type> items() const {
+    std::vector<value_type> result;
+    for (const auto &shard : shards_) {
+      std::shared_lock<std::shared_mutex> lock(shard.lock);
+      (void)std::copy(shard.cache.cbegin(), shard.cache.cend(), std::back_inserter(result));
+    }
+    return result;
+  }
+
+  std::string dump() const {
+    std::ostringstream buf;
+    for (auto &item : items()) {
+      MS_EXCEPTION_IF_NULL(item.first);
+      MS_EXCEPTION_IF_NULL(item.second);
+      buf << "{" << item.first->ToString() << ": " << item.second->ToString() << "}" << std::endl;
+    }
+    return buf.str();
+  }
+
+ private:
+  struct Shard {
+    mutable std::shared_mutex lock;
+    CacheType cache;
+  };
+
+  const Shard &GetShard(const KeyType &key) const {
+    // Fibonacci hashing, the shard is taken from the high bits of the product so it does not follow the low bits
+    // which select the bucket in the shard.
+    constexpr uint64_t kGoldenRatio = 0x9E3779B97F4A7C15ULL;
+    constexpr size_t kShardShift = 60;
+    static_assert((size_t{1} << (sizeof(uint64_t) * CHAR_BIT - kShardShift)) == kShardNum);
+    auto hash = static_cast<uint64_t>(typename CacheType::hasher()(key));
+    return shards_[static_cast<size_t>((hash * kGoldenRatio) >> kShardShift)];
+  }
+  Shard &GetShard(const KeyType &key) { return const_cast<Shard &>(std::as_const(*this).GetShard(key)); }
+
+  std::array<Shard, kShardNum> shards_;
+};
+
 class AsyncAbstract : public std::enable_shared_from_this<AsyncAbstract> {
  public:
   explicit AsyncAbstract(const std::shared_ptr<AsyncAbstract> &switchAbstract = nullptr)
@@ -417,7 +516,7 @@ class AsyncInferTask {
 
 using EvaluatorCacheMap =
   std::unordered_map<AbstractBasePtrList, EvalResultPtr, AbstractBasePtrListHasher, AbstractBasePtrListEqual>;
-using EvalResultCache = NormalCache<AbstractBasePtrList, EvalResultPtr, EvaluatorCacheMap>;
+using EvalResultCache = ShardedCache<AbstractBasePtrList, EvalResultPtr, EvaluatorCacheMap>;
 
 class EvaluatorCacheMgr {
  public:
@@ -439,8 +538,7 @@ class AnalysisResultCacheMgr {
  public:
   using AnalysisConfigResultMap =
     mindspore::HashMap<AnfNodeConfigPtr, EvalResultPtr, AnfNodeConfigHasher, AnfNodeConfigEqual>;
-  using AnalysisConfigResultCache = NormalCache<AnfNodeConfigPtr, EvalResultPtr, AnalysisConfigResultMap>;
-  using const_iterator = typename AnalysisConfigResultCache::const_iterator;
+  using AnalysisConfigResultCache = ShardedCache<AnfNodeConfigPtr, EvalResultPtr, AnalysisConfigResultMap>;
 
   ~AnalysisResultCacheMgr() = default;
   AnalysisResultCacheMgr(const AnalysisResultCacheMgr &) = delete;
@@ -456,8 +554,6 @@ class AnalysisResultCacheMgr {
   void InitSwitchValue(const AnfNodeConfigPtr &conf);
   AbstractBasePtr GetSwitchValue(const AnfNodeConfigPtr &conf);
   void SetSwitchValue(const AnfNodeConfigPtr &conf, const AbstractBasePtr &arg);
-  const_iterator begin() { return cache_.begin(); }
-  const_iterator end() { return cache_.end(); }
   void CheckSwitchValueJoinable(const AnfNodeConfigPtr &conf, const AbstractBasePtr &arg);
   const PrimitiveEvalCachePtr &prim_eval_cache() const { return prim_eval_cache_; }
 
@@ -696,7 +696,7 @@ EvalResultPtr Evaluator::Run(AnalysisEnginePtr engine, const ConfigPtrList &args
   MS_EXCEPTION_IF_NULL(evaluator_cache_mgr_);
   auto &cache = evaluator_cache_mgr_->GetCache();
   auto iter = cache.find(args_abs_list);
-  if (iter == cache.end()) {
+  if (!iter.has_value()) {
     MS_LOG(DEBUG) << "[" << this << "/" << evaluator_name << "] cache miss, call Eval(), args: " << args_abs_list;
     eval_result = Eval(engine, args_abs_list, out_conf);
     MS_EXCEPTION_IF_NULL(eval_result);
@@ -1370,7 +1370,7 @@ std::pair<AbstractBasePtrList, AbstractBasePtr> FuncGraphSpecializer::BuildFromB
   }
   MS_EXCEPTION_IF_NULL(eval_cache_iter->second);
   auto &origin_eval_cache = eval_cache_iter->second->GetCache();
-  for (auto &args_map : origin_eval_cache) {
+  for (auto &args_map : origin_eval_cache.items()) {
     auto args = args_map.first;
     args_vector.push_back(args);
   }
@@ -1744,7 +1744,7 @@ void DumpEvaluatorCache(const EvaluatorPtr &eval, const AbstractBasePtrList &arg
 
   int64_t i = 0;
   const EvalResultCache &map = evaluator_cache_mgr->GetCache();
-  for (const auto &item : map) {
+  for (const auto &item : map.items()) {
     MS_LOG(DEBUG) << "\tevaluator_cache[" << i++ << "]: {args_abs_list hash: " << AbstractBasePtrListHash(item.first)
                   << ", args_abs_list: " << item.first << "}";
   }
@@ -1794,12 +1794,14 @@ SpecializeStatusCode FuncGraphSpecializer::AcquireUniqueEvalResult(
   if (eval_result != nullptr) {
     *res = std::make_pair(args_abs_list, eval_result->abstract());
     return kSpecializeSuccess;
-  } else if (choices.size() == 1) {
+  }
+  auto items = choices.items();
+  if (items.size() == 1) {
     MS_LOG(DEBUG) << "Evaluator cache has a single item, just use it.";
-    MS_EXCEPTION_IF_NULL(choices.begin()->second);
-    *res = std::make_pair(choices.begin()->first, choices.begin()->second->abstract());
+    MS_EXCEPTION_IF_NULL(items.front().second);
+    *res = std::make_pair(items.front().first, items.front().second->abstract());
     return kSpecializeSuccess;
-  } else if (choices.empty()) {
+  } else if (items.empty()) {
     MS_LOG(DEBUG) << "Find DEAD code, it may be optimized in later phase " << func->ToString() << " | "
                   << func->type_name() << ", evaluator: " << eval->ToString() << ", ptr: " << eval.get();
     return kSpecializeDead;
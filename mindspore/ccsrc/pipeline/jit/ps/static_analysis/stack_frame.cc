@@ -77,7 +77,7 @@ StackFramePtr StackFrame::DoJump(const AnalysisEnginePtr &engine, const CNodePtr
   MS_EXCEPTION_IF_NULL(evaluator->evaluator_cache_mgr());
   auto &cache = evaluator->evaluator_cache_mgr()->GetCache();
   auto iter = cache.find(args_abs_list);
-  if (iter != cache.end()) {
+  if (iter.has_value()) {
     MS_EXCEPTION_IF_NULL(current_context_);
     MS_LOG(DEBUG) << "Eval before, current_node: " << current_cnode->DebugString()
                   << ", current_context_: " << current_context_->ToString() << ", args: " << args_abs_list;
@@ -606,7 +606,7 @@ void AnalysisEngine::SaveEvalResultInCache(const AnfNodeConfigPtr &conf, const E
   MS_EXCEPTION_IF_NULL(result);
   static AnalysisResultCacheMgr &cache_mgr = AnalysisResultCacheMgr::GetInstance();
   auto iter = cache_mgr.GetCache().find(conf);
-  if (iter != cache_mgr.GetCache().end()) {
+  if (iter.has_value()) {
     MS_EXCEPTION_IF_NULL(iter->second);
     MS_EXCEPTION_IF_NULL(iter->second->abstract());
     MS_LOG(DEBUG) << "Found previous result for NodeConfig: " << conf->ToString()
@@ -655,7 +655,7 @@ void SynchronizeSequenceElementsUseFlagsForFuncGraphArgs(const AnalysisEnginePtr
   MS_EXCEPTION_IF_NULL(evaluator->evaluator_cache_mgr());
   auto &cache = evaluator->evaluator_cache_mgr()->GetCache();
   auto iter = cache.find(args_abs_list);
-  if (iter != cache.end()) {
+  if (iter.has_value()) {
     MS_EXCEPTION_IF_NULL(fg_context);
     MS_LOG(DEBUG) << "Eval before, current_node: " << cnode->DebugString() << ", context: " << fg_context->ToString()
                   << ", args: " << args_abs_list;
@@ -15,8 +15,12 @@
  */
 
 #include "plugin/device/cpu/hal/hardware/cpu_device_context.h"
+#include <chrono>
 #include <map>
+#include <numeric>
 #include <string>
+#include <tuple>
+#include <utility>
 #include "plugin/device/cpu/hal/device/cpu_device_address.h"
 #include "plugin/device/cpu/hal/device/cpu_memory_manager.h"
 #include "plugin/device/cpu/optimizer/reg_cpu_const_input_to_attr.h"
@@ -26,6 +30,10 @@
 #ifdef ENABLE_AKG
 #include "plugin/device/cpu/kernel/akg/akg_cpu_kernel_build.h"
 #endif
+#ifndef USE_LLVM
+#include "plugin/device/cpu/kernel/loop_program_cpu_kernel.h"
+#include "backend/common/graph_kernel/core/graph_kernel_utils.h"
+#endif
 #include "plugin/factory/ms_factory.h"
 #include "plugin/device/cpu/kernel/cpu_kernel.h"
 #include "kernel/kernel_build_info.h"
@@ -87,6 +95,54 @@ pynative::KernelTaskPtr GetTaskByTaskType(const pynative::KernelTaskType &task_t
       MS_LOG(EXCEPTION) << "KernelTaskType is invalid, task_type:" << task_type;
   }
 }
+
+#ifndef USE_LLVM
+// Without LLVM the graph kernel nodes are run by the loop program interpreter, the nodes it can not run have been
+// split by the LoopProgramSplit pass, which also caches the lowered program on the sub graph.
+bool CreateLoopProgramKernel(const CNodePtr &node) {
+  auto sub_graph = common::AnfAlgo::GetCNodeFuncGraphPtr(node);
+  MS_EXCEPTION_IF_NULL(sub_graph);
+  auto program = sub_graph->user_data<graphkernel::inner::LoopProgram>();
+  if (program == nullptr) {
+    program = graphkernel::inner::LoopProgram::Lower(graphkernel::GkUtils::AnfGraph2LiteGraph(sub_graph));
+  }
+  if (program == nullptr) {
+    MS_LOG(WARNING) << "Lower graph kernel node [" << node->fullname_with_scope()
+                    << "] to loop program failed, it is built as an AKG kernel.";
+    return false;
+  }
+  MS_LOG(DEBUG) << "Run graph kernel node " << node->fullname_with_scope() << " by " << program->ToString();
+  auto kernel_mod = std::make_shared<kernel::LoopProgramCpuKernelMod>(node->fullname_with_scope(), program);
+  AnfAlgo::SetKernelMod(kernel_mod, node.get());
+  return true;
+}
+#endif
+
+#ifndef ENABLE_SECURITY
+// Estimated flops and bytes of inputs and outputs of a launch, for the roofline statistics of the profiler.
+std::pair<double, double> EstimateKernelCost(const CNodePtr &kernel, const std::vector<AddressPtr> &inputs,
+                                             const std::vector<AddressPtr> &outputs) {
+  double flops = 0;
+  auto kernel_mod = dynamic_cast<kernel::NativeCpuKernelMod *>(AnfAlgo::GetKernelMod(kernel));
+  if (kernel_mod != nullptr) {
+    std::vector<ShapeVector> input_shapes;
+    std::vector<ShapeVector> output_shapes;
+    for (size_t i = 0; i < common::AnfAlgo::GetInputTensorNum(kernel); ++i) {
+      (void)input_shapes.emplace_back(common::AnfAlgo::GetPrevNodeOutputInferShape(kernel, i));
+    }
+    for (size_t i = 0; i < AnfAlgo::GetOutputTensorNum(kernel); ++i) {
+      (void)output_shapes.emplace_back(common::AnfAlgo::GetOutputInferShape(kernel, i));
+    }
+    flops = kernel_mod->EstimateFlops(input_shapes, output_shapes);
+  }
+  auto add_size = [](double bytes, const AddressPtr &address) {
+    return address == nullptr ? bytes : bytes + static_cast<double>(address->size);
+  };
+  double bytes = std::accumulate(inputs.begin(), inputs.end(), 0.0, add_size);
+  bytes = std::accumulate(outputs.begin(), outputs.end(), bytes, add_size);
+  return {flops, bytes};
+}
+#endif
 }  // namespace
 using mindspore::kernel::KernelBuildInfo;
 
@@ -410,6 +466,12 @@ void CPUKernelExecutor::CreateKernel(const std::vector<CNodePtr> &nodes) const {
       continue;
     }
     if (session::AnfRuntimeAlgorithm::GetKernelType(node) == KernelType::AKG_KERNEL) {
+#ifndef USE_LLVM
+      if (graphkernel::GraphKernelFlags::GetInstance().enable_loop_program && common::AnfAlgo::IsGraphKernel(node) &&
+          !common::AnfAlgo::IsDynamicShape(node) && CreateLoopProgramKernel(node)) {
+        continue;
+      }
+#endif
       if (!bin_map->initialized()) {
         bin_map->Initialize();
       }
@@ -562,10 +624,25 @@ bool CPUKernelExecutor::LaunchKernelWithProfiling(const CNodePtr &kernel, const
   MS_EXCEPTION_IF_NULL(profiler_inst);
 
   uint32_t pid = IntToUint(getpid());
+  auto roofline = profiler_inst->roofline();
+  double flops = 0;
+  double bytes = 0;
+  if (roofline != nullptr) {
+    // The cost estimate and the counters are read outside the time of the op.
+    std::tie(flops, bytes) = EstimateKernelCost(kernel, inputs, outputs);
+    roofline->Begin();
+  }
   // cpu support multi-thread with mindrt for profiling.
   profiler_inst->OpDataProducerBeginParallel(kernel->fullname_with_scope(), pid);
+  auto start_time = std::chrono::steady_clock::now();
   bool ret = DoLaunchKernel(kernel, inputs, workspace, outputs);
+  auto end_time = std::chrono::steady_clock::now();
   profiler_inst->OpDataProducerEndParallel(kernel->fullname_with_scope());
+  if (roofline != nullptr) {
+    auto time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    roofline->End(kernel->fullname_with_scope(), common::AnfAlgo::GetCNodeName(kernel), flops, bytes,
+                  static_cast<uint64_t>(time_ns));
+  }
   profiler_inst->RecordFrameWorkInfo(kernel);
   return ret;
 }
@@ -42,6 +42,8 @@ class BACKEND_EXPORT CpuDataSaver : public DataSaver {
 
   void WriteFile(const std::string out_path);
 
+  const std::string &device_id() const { return device_id_; }
+
  private:
   static std::shared_ptr<CpuDataSaver> cpu_data_saver_inst_;
 };
@@ -18,11 +18,13 @@
 #include "plugin/device/cpu/hal/profiler/cpu_data_saver.h"
 #include "utils/log_adapter.h"
 #include "utils/ms_context.h"
+#include "utils/ms_utils.h"
 
 namespace mindspore {
 namespace profiler {
 namespace cpu {
 namespace {
+constexpr auto kRooflineEnv = "MS_CPU_PROFILER_ROOFLINE";
 PROFILER_REG(kCPUDevice, CPUProfiler);
 }  // namespace
 std::shared_ptr<CPUProfiler> CPUProfiler::GetInstance() {
@@ -36,6 +38,10 @@ void CPUProfiler::Init(const std::string &profiling_path, uint32_t, const std::s
   base_time_ = GetHostMonoTimeStamp();
   profile_data_path_ = profiling_path;
   MS_LOG(INFO) << " Host start time(ns): " << base_time_ << " profile data path: " << profile_data_path_;
+  if (common::GetEnv(kRooflineEnv) == "1" && roofline_ == nullptr) {
+    MS_LOG(INFO) << "Collect the roofline statistics of the CPU kernels.";
+    roofline_ = std::make_unique<CpuRoofline>();
+  }
 }
 
 void CPUProfiler::StepProfilingEnable(const bool enable_flag) {
@@ -178,6 +184,9 @@ void CPUProfiler::SaveProfileData() {
     if (!all_kernel_info_.empty()) {
       cpu_data_saver_inst->WriteFrameWork(profile_data_path_, all_kernel_info_);
     }
+    if (roofline_ != nullptr) {
+      roofline_->WriteReport(profile_data_path_, cpu_data_saver_inst->device_id());
+    }
   }
 }
 
@@ -192,6 +201,9 @@ void CPUProfiler::ClearInst() {
   all_step_start_end_info_.clear();
   step_start_end_info_vector_.clear();
   all_kernel_info_.clear();
+  if (roofline_ != nullptr) {
+    roofline_->Clear();
+  }
   init_flag_ = false;
   enable_flag_ = false;
   has_find_ = false;
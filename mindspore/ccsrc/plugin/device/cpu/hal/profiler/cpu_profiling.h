@@ -29,6 +29,7 @@
 #include "include/backend/debug/profiler/data_saver.h"
 #include "actor/actormgr.h"
 #include "include/backend/kernel_graph.h"
+#include "plugin/device/cpu/hal/profiler/cpu_roofline.h"
 
 namespace mindspore {
 namespace profiler {
@@ -55,6 +56,8 @@ class CPUProfiler : public Profiler {
   float SetRuntimeEnd(const std::string op_name, const uint64_t stop_timestamp);
   void SetRuntimeStart(const std::string op_name, const uint64_t start_timestamp);
   void RecordFrameWorkInfo(const CNodePtr &kernel);
+  // The roofline statistics of the kernels, nullptr unless MS_CPU_PROFILER_ROOFLINE=1.
+  CpuRoofline *roofline() const { return roofline_.get(); }
   std::vector<CurKernelInfo> all_kernel_info_;
   std::mutex kernel_mutex_;
 
@@ -74,6 +77,7 @@ class CPUProfiler : public Profiler {
   uint64_t op_time_stop_;
 
   std::optional<bool> is_gpu_hetero_ = {};
+  std::unique_ptr<CpuRoofline> roofline_;
 };
 }  // namespace cpu
 }  // namespace profiler
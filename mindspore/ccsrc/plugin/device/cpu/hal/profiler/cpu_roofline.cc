@@ -0,0 +1,219 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "plugin/device/cpu/hal/profiler/cpu_roofline.h"
+#include <algorithm>
+#include <fstream>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "utils/log_adapter.h"
+#include "utils/ms_utils.h"
+#include "mindspore/core/utils/file_utils.h"
+
+namespace mindspore {
+namespace profiler {
+namespace cpu {
+namespace {
+constexpr auto kRooflineRidgeEnv = "MS_CPU_ROOFLINE_RIDGE";
+// Ridge point of a typical server core with avx2, about 16 flops per cycle over 2 bytes per cycle of memory.
+constexpr double kDefaultRidgePoint = 8.0;
+constexpr double kCacheLineSize = 64.0;
+constexpr double kNsToUs = 1e3;
+constexpr double kGiga = 1e9;
+
+#ifdef __linux__
+constexpr uint64_t kCounterConfigs[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                        PERF_COUNT_HW_CACHE_MISSES};
+constexpr size_t kCounterNum = sizeof(kCounterConfigs) / sizeof(kCounterConfigs[0]);
+
+uint64_t CounterDelta(uint64_t begin, uint64_t end) { return end > begin ? end - begin : 0; }
+
+// The layout of a read of the counter group.
+struct CounterGroupValues {
+  uint64_t nr{0};
+  uint64_t time_enabled{0};
+  uint64_t time_running{0};
+  uint64_t values[kCounterNum]{};
+};
+
+// Open a group of the counters for the calling thread, the cycles counter leads the group.
+std::vector<int> OpenThreadCounters() {
+  std::vector<int> fds;
+  for (auto config : kCounterConfigs) {
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    int group_fd = fds.empty() ? -1 : fds[0];
+    auto fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+    if (fd < 0) {
+      for (auto opened : fds) {
+        (void)close(opened);
+      }
+      return {};
+    }
+    fds.push_back(fd);
+  }
+  return fds;
+}
+
+// The counter group of a thread, opened at its first launch and closed when the thread exits.
+class ThreadCounters {
+ public:
+  ThreadCounters() = default;
+  ~ThreadCounters() {
+    for (auto fd : fds_) {
+      (void)close(fd);
+    }
+  }
+
+  bool Read(CounterGroupValues *group_values) {
+    if (!opened_) {
+      fds_ = OpenThreadCounters();
+      opened_ = true;
+    }
+    return !fds_.empty() && read(fds_[0], group_values, sizeof(*group_values)) == sizeof(*group_values);
+  }
+
+ private:
+  std::vector<int> fds_;
+  bool opened_{false};
+};
+
+thread_local ThreadCounters thread_counters;
+thread_local CounterGroupValues launch_start;
+thread_local bool launch_counted = false;
+#endif
+}  // namespace
+
+CpuRoofline::CpuRoofline() {
+#ifdef __linux__
+  auto fds = OpenThreadCounters();
+  counter_available_ = !fds.empty();
+  for (auto fd : fds) {
+    (void)close(fd);
+  }
+#endif
+  if (!counter_available_) {
+    MS_LOG(WARNING) << "Hardware counters are not available, check /proc/sys/kernel/perf_event_paranoid. The CPU "
+                    << "roofline only holds the estimated flops and bytes of the kernels.";
+  }
+}
+
+CpuRoofline::~CpuRoofline() = default;
+
+void CpuRoofline::Begin() {
+#ifdef __linux__
+  launch_counted = counter_available_ && thread_counters.Read(&launch_start);
+#endif
+}
+
+void CpuRoofline::End(const std::string &op_name, const std::string &op_type, double flops, double bytes,
+                      uint64_t time_ns) {
+  PerfCounters delta;
+#ifdef __linux__
+  CounterGroupValues end_values;
+  if (launch_counted && thread_counters.Read(&end_values)) {
+    // The kernel multiplexes the counters when there are more events than hardware counters, the counts of the time
+    // they were running are scaled up to the whole launch.
+    auto time_enabled = CounterDelta(launch_start.time_enabled, end_values.time_enabled);
+    auto time_running = CounterDelta(launch_start.time_running, end_values.time_running);
+    double scale = time_running > 0 ? static_cast<double>(time_enabled) / static_cast<double>(time_running) : 0;
+    auto scaled_delta = [scale, &end_values](size_t i) {
+      return static_cast<uint64_t>(static_cast<double>(CounterDelta(launch_start.values[i], end_values.values[i])) *
+                                   scale);
+    };
+    delta.cycles = scaled_delta(0);
+    delta.instructions = scaled_delta(1);
+    delta.llc_misses = scaled_delta(2);
+  }
+#endif
+  std::lock_guard<std::mutex> lock(stat_mutex_);
+  auto &stat = op_stats_[op_name];
+  stat.op_type = op_type;
+  stat.count += 1;
+  stat.time_ns += time_ns;
+  stat.flops += flops;
+  stat.bytes += bytes;
+  stat.counters.cycles += delta.cycles;
+  stat.counters.instructions += delta.instructions;
+  stat.counters.llc_misses += delta.llc_misses;
+}
+
+void CpuRoofline::WriteReport(const std::string &dir, const std::string &device_id) {
+  std::lock_guard<std::mutex> lock(stat_mutex_);
+  if (op_stats_.empty()) {
+    return;
+  }
+  double ridge_point = kDefaultRidgePoint;
+  auto ridge_env = common::GetEnv(kRooflineRidgeEnv);
+  if (!ridge_env.empty()) {
+    try {
+      ridge_point = std::stod(ridge_env);
+    } catch (const std::exception &) {
+      MS_LOG(WARNING) << "Invalid " << kRooflineRidgeEnv << ": " << ridge_env << ", use " << kDefaultRidgePoint;
+    }
+  }
+  std::vector<std::pair<std::string, const OpStat *>> sorted_stats;
+  for (const auto &[op_name, stat] : op_stats_) {
+    (void)sorted_stats.emplace_back(op_name, &stat);
+  }
+  std::sort(sorted_stats.begin(), sorted_stats.end(),
+            [](const auto &a, const auto &b) { return a.second->time_ns > b.second->time_ns; });
+
+  std::string file_path = dir + "/cpu_roofline_" + device_id + ".csv";
+  std::ofstream ofs(file_path);
+  if (!ofs.is_open()) {
+    MS_LOG(WARNING) << "Open file '" << file_path << "' failed!";
+    return;
+  }
+  ofs << "op_name,op_type,count,total_time(us),avg_time(us),flops,bytes,memory_bytes,arithmetic_intensity,"
+         "gflops/s,memory_bandwidth(GB/s),cycles,instructions,ipc,llc_misses,bound\n";
+  for (const auto &[op_name, stat] : sorted_stats) {
+    double seconds = static_cast<double>(stat->time_ns) / kGiga;
+    // Without counters the bytes of the inputs and outputs are the least bytes moved.
+    double memory_bytes = counter_available_ ? static_cast<double>(stat->counters.llc_misses) * kCacheLineSize
+                                             : stat->bytes;
+    double intensity = memory_bytes > 0 ? stat->flops / memory_bytes : stat->flops;
+    double ipc = stat->counters.cycles > 0
+                   ? static_cast<double>(stat->counters.instructions) / static_cast<double>(stat->counters.cycles)
+                   : 0;
+    ofs << op_name << ',' << stat->op_type << ',' << stat->count << ',' << stat->time_ns / kNsToUs << ','
+        << stat->time_ns / kNsToUs / stat->count << ',' << stat->flops << ',' << stat->bytes << ',' << memory_bytes
+        << ',' << intensity << ',' << (seconds > 0 ? stat->flops / seconds / kGiga : 0) << ','
+        << (seconds > 0 ? memory_bytes / seconds / kGiga : 0) << ',' << stat->counters.cycles << ','
+        << stat->counters.instructions << ',' << ipc << ',' << stat->counters.llc_misses << ','
+        << (intensity < ridge_point ? "memory" : "compute") << '\n';
+  }
+  ofs.close();
+  ChangeFileMode(file_path, S_IRUSR);
+  MS_LOG(INFO) << "Write the roofline of " << sorted_stats.size() << " ops into file: " << file_path;
+}
+
+void CpuRoofline::Clear() {
+  std::lock_guard<std::mutex> lock(stat_mutex_);
+  op_stats_.clear();
+}
+}  // namespace cpu
+}  // namespace profiler
+}  // namespace mindspore
@@ -0,0 +1,77 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_HAL_PROFILER_CPU_ROOFLINE_H
+#define MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_HAL_PROFILER_CPU_ROOFLINE_H
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace mindspore {
+namespace profiler {
+namespace cpu {
+// Hardware counters of a thread.
+struct PerfCounters {
+  uint64_t cycles{0};
+  uint64_t instructions{0};
+  uint64_t llc_misses{0};
+};
+
+// Roofline statistics of the CPU kernels, collected by the CPU profiler when MS_CPU_PROFILER_ROOFLINE=1.
+//
+// Every launch records its time, the flops estimated by the kernel mod and the bytes of its inputs and outputs. When
+// Linux perf events are available, the cycles, instructions and last level cache misses of the launching thread are
+// recorded too, the misses times the cache line size being the bytes moved from memory. Each thread reads its own
+// counters, so concurrent launches do not wait for each other, but the work a kernel hands to the intra-op thread
+// pool is not counted. The counts are scaled up by time enabled over time running when the kernel multiplexes them.
+//
+// The report sorts the ops by total time and marks an op memory bound when its arithmetic intensity, in flops per
+// byte moved from memory (per byte of inputs and outputs without counters), is below the ridge point of the machine,
+// MS_CPU_ROOFLINE_RIDGE flops per byte.
+class CpuRoofline {
+ public:
+  CpuRoofline();
+  ~CpuRoofline();
+  CpuRoofline(const CpuRoofline &) = delete;
+  CpuRoofline &operator=(const CpuRoofline &) = delete;
+
+  // Read the counters of the calling thread before a launch, outside the time of the launch.
+  void Begin();
+  // Record the launch of time_ns started by the last Begin of the calling thread.
+  void End(const std::string &op_name, const std::string &op_type, double flops, double bytes, uint64_t time_ns);
+  // Write cpu_roofline_<device_id>.csv to the directory.
+  void WriteReport(const std::string &dir, const std::string &device_id);
+  void Clear();
+
+ private:
+  struct OpStat {
+    std::string op_type;
+    uint64_t count{0};
+    uint64_t time_ns{0};
+    double flops{0};
+    double bytes{0};
+    PerfCounters counters;
+  };
+
+  bool counter_available_{false};
+
+  std::mutex stat_mutex_;
+  std::map<std::string, OpStat> op_stats_;
+};
+}  // namespace cpu
+}  // namespace profiler
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_HAL_PROFILER_CPU_ROOFLINE_H
@@ -24,6 +24,7 @@
 #include <complex>
 
 #include "plugin/device/cpu/hal/device/cpu_device_address.h"
+#include "utils/float_convert.h"
 
 namespace mindspore {
 namespace kernel {
@@ -45,6 +46,11 @@ class CastCpuKernelFunc : public CpuKernelFunc {
 template <typename S, typename T>
 void Cast(CastCpuKernelFunc<S, T> *content, const S *in, T *out, size_t size) {
   auto task = [&in, &out](size_t start, size_t end) {
+    if constexpr ((std::is_same_v<S, float> && (std::is_same_v<T, float16> || std::is_same_v<T, bfloat16>)) ||
+                  (std::is_same_v<T, float> && (std::is_same_v<S, float16> || std::is_same_v<S, bfloat16>))) {
+      ConvertRange(in + start, out + start, end - start);
+      return;
+    }
     for (size_t i = start; i < end; i++) {
       if constexpr (std::is_same_v<S, T>) {
         out[i] = static_cast<T>(in[i]);
@@ -29,6 +29,15 @@
 
 namespace mindspore {
 namespace kernel {
+double NativeCpuKernelMod::EstimateFlops(const std::vector<ShapeVector> &,
+                                         const std::vector<ShapeVector> &output_shapes) const {
+  double flops = 0;
+  for (const auto &shape : output_shapes) {
+    flops += static_cast<double>(SizeOf(shape));
+  }
+  return flops;
+}
+
 std::vector<KernelAttr> NativeCpuKernelMod::GetAllSupportedList(const std::string &kernel_name) {
   auto iter = support_map_.find(kernel_name);
   if (iter == support_map_.end()) {
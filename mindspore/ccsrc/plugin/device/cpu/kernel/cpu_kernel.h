@@ -164,6 +164,11 @@ class BACKEND_EXPORT NativeCpuKernelMod : public CpuKernelMod {
 
   enum KernelModType GetKernelModType() const override { return KernelModType::NativeCpuKernelMod; }
 
+  // Floating point operations of a launch with the given shapes, for the roofline statistics of the CPU profiler.
+  // The default takes the kernel as elementwise, one operation per output element.
+  virtual double EstimateFlops(const std::vector<ShapeVector> &input_shapes,
+                               const std::vector<ShapeVector> &output_shapes) const;
+
   ParallelSearchInfo parallel_search_info_;
 
  protected:
@@ -0,0 +1,366 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin/device/cpu/kernel/loop_program_cpu_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "base/float16.h"
+#include "nnacl/fp32/activation_fp32.h"
+#include "nnacl/fp32/add_fp32.h"
+#include "nnacl/fp32/arithmetic_fp32.h"
+#include "nnacl/fp32/arithmetic_self_fp32.h"
+#include "nnacl/fp32/div_fp32.h"
+#include "nnacl/fp32/exp_fp32.h"
+#include "nnacl/fp32/mul_fp32.h"
+#include "nnacl/fp32/sub_fp32.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+using graphkernel::inner::LoopProgram;
+using OpCode = LoopProgram::OpCode;
+using BinaryFunc = int (*)(const float *, const float *, float *, int);
+using BinaryOptFunc = int (*)(const float *, const float *, float *, int, bool);
+using UnaryFunc = int (*)(const float *, float *, const int);
+
+// Elements of a tile when the program has no reduce, the buffers of a thread stay in the L2 cache.
+constexpr size_t kTileSize = 2048;
+// Elements a thread computes at least, smaller kernels are not worth the scheduling.
+constexpr size_t kMinElementsPerTask = 16384;
+
+int ExpFunc(const float *in, float *out, const int size) {
+  ExpFp32(in, out, size);
+  return NNACL_OK;
+}
+
+int TanhFunc(const float *in, float *out, const int size) { return Tanh(in, size, out); }
+
+int RoundFunc(const float *in, float *out, const int size) {
+  // Round half to even, like the Round op.
+  for (int i = 0; i < size; ++i) {
+    out[i] = std::nearbyint(in[i]);
+  }
+  return NNACL_OK;
+}
+
+int RoundToHalfFunc(const float *in, float *out, const int size) {
+  for (int i = 0; i < size; ++i) {
+    out[i] = static_cast<float>(float16(in[i]));
+  }
+  return NNACL_OK;
+}
+
+UnaryFunc GetUnaryFunc(OpCode op) {
+  switch (op) {
+    case OpCode::kNeg:
+      return ElementNegative;
+    case OpCode::kAbs:
+      return ElementAbs;
+    case OpCode::kExp:
+      return ExpFunc;
+    case OpCode::kLog:
+      return ElementLog;
+    case OpCode::kSqrt:
+      return ElementSqrt;
+    case OpCode::kRsqrt:
+      return ElementRsqrt;
+    case OpCode::kReciprocal:
+      return ElementReciprocal;
+    case OpCode::kTanh:
+      return TanhFunc;
+    case OpCode::kFloor:
+      return ElementFloor;
+    case OpCode::kRound:
+      return RoundFunc;
+    case OpCode::kErf:
+      return ElementErf;
+    case OpCode::kSin:
+      return ElementSin;
+    case OpCode::kCos:
+      return ElementCos;
+    case OpCode::kRoundToHalf:
+      return RoundToHalfFunc;
+    default:
+      return nullptr;
+  }
+}
+
+std::pair<BinaryFunc, BinaryOptFunc> GetBinaryFunc(OpCode op) {
+  switch (op) {
+    case OpCode::kAdd:
+      return {ElementAdd, ElementOptAdd};
+    case OpCode::kSub:
+      return {ElementSub, ElementOptSub};
+    case OpCode::kMul:
+      return {ElementMul, ElementOptMul};
+    case OpCode::kDiv:
+      return {ElementDiv, ElementOptDiv};
+    case OpCode::kMaximum:
+      return {ElementMaximum, ElementOptMaximum};
+    case OpCode::kMinimum:
+      return {ElementMinimum, ElementOptMinimum};
+    default:
+      return {nullptr, nullptr};
+  }
+}
+
+float Reduce(OpCode op, const float *in, size_t size) {
+  float result = in[0];
+  for (size_t i = 1; i < size; ++i) {
+    if (op == OpCode::kReduceSum) {
+      result += in[i];
+    } else if (op == OpCode::kReduceMax) {
+      result = std::max(result, in[i]);
+    } else {
+      result = std::min(result, in[i]);
+    }
+  }
+  return result;
+}
+}  // namespace
+
+LoopProgramCpuKernelMod::LoopProgramCpuKernelMod(const std::string &kernel_name,
+                                                 const graphkernel::inner::LoopProgramPtr &program)
+    : program_(program) {
+  MS_EXCEPTION_IF_NULL(program_);
+  kernel_name_ = kernel_name;
+  auto inner_size = LongToSize(program_->inner_size());
+  // A reduce needs the whole row in one tile.
+  tile_size_ = program_->has_reduce() ? inner_size : std::min(inner_size, kTileSize);
+  tile_num_ = (inner_size + tile_size_ - 1) / tile_size_;
+  std::vector<size_t> input_size_list;
+  for (const auto &arg : program_->inputs()) {
+    input_size_list.push_back(arg.size_in_bytes);
+  }
+  std::vector<size_t> output_size_list;
+  for (const auto &arg : program_->outputs()) {
+    output_size_list.push_back(arg.size_in_bytes);
+  }
+  SetInputSizeList(input_size_list);
+  SetOutputSizeList(output_size_list);
+  PlanStorage();
+}
+
+void LoopProgramCpuKernelMod::PlanStorage() {
+  const auto &values = program_->values();
+  storage_.assign(values.size(), Storage::kBuffer);
+  location_.assign(values.size(), SIZE_MAX);
+  size_t const_num = 0;
+  for (size_t v = 0; v < values.size(); ++v) {
+    if (values[v].is_const) {
+      storage_[v] = Storage::kConst;
+      location_[v] = const_num++;
+    }
+  }
+  // The float32 tensors are read in place.
+  const auto &inputs = program_->inputs();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (inputs[i].type == kNumberTypeFloat32 && !values[inputs[i].value].row_scalar) {
+      storage_[inputs[i].value] = Storage::kInput;
+      location_[inputs[i].value] = i;
+    }
+  }
+  const auto &instructions = program_->instructions();
+  std::vector<bool> computed(values.size(), false);
+  for (const auto &instr : instructions) {
+    computed[instr.output] = true;
+  }
+  // The float32 results are written to the outputs in place.
+  const auto &outputs = program_->outputs();
+  std::vector<size_t> last_use(values.size(), 0);
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    auto v = outputs[i].value;
+    last_use[v] = SIZE_MAX;
+    if (computed[v] && storage_[v] == Storage::kBuffer && location_[v] == SIZE_MAX &&
+        outputs[i].type == kNumberTypeFloat32 && !outputs[i].inner_broadcast && !values[v].row_scalar) {
+      storage_[v] = Storage::kOutput;
+      location_[v] = i;
+    }
+  }
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    for (auto v : instructions[i].inputs) {
+      last_use[v] = std::max(last_use[v], i);
+    }
+  }
+  // Assign the buffers greedily, a buffer is free again after the last use of its value.
+  std::vector<size_t> free_buffers;
+  auto allocate = [this, &free_buffers](size_t v) {
+    if (free_buffers.empty()) {
+      location_[v] = buffer_num_++;
+    } else {
+      location_[v] = free_buffers.back();
+      free_buffers.pop_back();
+    }
+  };
+  for (const auto &arg : inputs) {
+    if (storage_[arg.value] == Storage::kBuffer) {
+      allocate(arg.value);
+    }
+  }
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    const auto &instr = instructions[i];
+    if (storage_[instr.output] == Storage::kBuffer) {
+      allocate(instr.output);
+    }
+    for (size_t k = 0; k < instr.inputs.size(); ++k) {
+      auto v = instr.inputs[k];
+      bool first = std::find(instr.inputs.begin(), instr.inputs.begin() + k, v) == instr.inputs.begin() + k;
+      if (first && last_use[v] == i && storage_[v] == Storage::kBuffer) {
+        free_buffers.push_back(location_[v]);
+      }
+    }
+  }
+  const_num_ = const_num;
+}
+
+size_t LoopProgramCpuKernelMod::Offset(const LoopProgram::Argument &arg, size_t row) const {
+  const auto &outer_shape = program_->outer_shape();
+  size_t offset = 0;
+  for (size_t d = outer_shape.size(); d > 0; --d) {
+    auto dim = LongToSize(outer_shape[d - 1]);
+    offset += (row % dim) * LongToSize(arg.outer_strides[d - 1]);
+    row /= dim;
+  }
+  return offset;
+}
+
+void LoopProgramCpuKernelMod::Load(const std::vector<AddressPtr> &inputs, const Tile &tile,
+                                   std::vector<float *> *values) const {
+  const auto &args = program_->inputs();
+  for (size_t i = 0; i < args.size(); ++i) {
+    const auto &arg = args[i];
+    auto offset = Offset(arg, tile.row) + (arg.inner_broadcast ? 0 : tile.begin);
+    auto size = arg.inner_broadcast ? 1 : tile.size;
+    if (storage_[arg.value] == Storage::kInput) {
+      (*values)[arg.value] = static_cast<float *>(inputs[i]->addr) + offset;
+    } else if (arg.type == kNumberTypeFloat32) {
+      (void)std::copy_n(static_cast<float *>(inputs[i]->addr) + offset, size, (*values)[arg.value]);
+    } else {
+      auto src = static_cast<float16 *>(inputs[i]->addr) + offset;
+      (void)std::transform(src, src + size, (*values)[arg.value], [](float16 x) { return static_cast<float>(x); });
+    }
+  }
+}
+
+void LoopProgramCpuKernelMod::Execute(const Tile &tile, const std::vector<float *> &values) const {
+  const auto &info = program_->values();
+  for (const auto &instr : program_->instructions()) {
+    auto out = values[instr.output];
+    auto size = SizeToInt(info[instr.output].row_scalar ? 1 : tile.size);
+    if (instr.op == OpCode::kReduceSum || instr.op == OpCode::kReduceMax || instr.op == OpCode::kReduceMin) {
+      *out = Reduce(instr.op, values[instr.inputs[0]], tile.size);
+    } else if (instr.inputs.size() == 1) {
+      (void)GetUnaryFunc(instr.op)(values[instr.inputs[0]], out, size);
+    } else {
+      auto a = values[instr.inputs[0]];
+      auto b = values[instr.inputs[1]];
+      bool a_scalar = info[instr.inputs[0]].row_scalar;
+      bool b_scalar = info[instr.inputs[1]].row_scalar;
+      if (instr.op == OpCode::kPow) {
+        for (int i = 0; i < size; ++i) {
+          out[i] = std::pow(a[a_scalar ? 0 : i], b[b_scalar ? 0 : i]);
+        }
+      } else if (a_scalar == b_scalar) {
+        (void)GetBinaryFunc(instr.op).first(a, b, out, size);
+      } else {
+        (void)GetBinaryFunc(instr.op).second(a, b, out, size, a_scalar);
+      }
+    }
+  }
+}
+
+void LoopProgramCpuKernelMod::Store(const std::vector<AddressPtr> &outputs, const Tile &tile,
+                                    const std::vector<float *> &values) const {
+  const auto &info = program_->values();
+  const auto &args = program_->outputs();
+  for (size_t i = 0; i < args.size(); ++i) {
+    const auto &arg = args[i];
+    if (storage_[arg.value] == Storage::kOutput && location_[arg.value] == i) {
+      continue;
+    }
+    // The tiles of a row share the element of a broadcast output.
+    if (arg.inner_broadcast && tile.begin != 0) {
+      continue;
+    }
+    auto offset = Offset(arg, tile.row) + (arg.inner_broadcast ? 0 : tile.begin);
+    auto size = arg.inner_broadcast ? 1 : tile.size;
+    auto src = values[arg.value];
+    bool fill = info[arg.value].row_scalar;
+    if (arg.type == kNumberTypeFloat32) {
+      auto dst = static_cast<float *>(outputs[i]->addr) + offset;
+      if (fill) {
+        (void)std::fill_n(dst, size, src[0]);
+      } else {
+        (void)std::copy_n(src, size, dst);
+      }
+    } else {
+      auto dst = static_cast<float16 *>(outputs[i]->addr) + offset;
+      if (fill) {
+        (void)std::fill_n(dst, size, float16(src[0]));
+      } else {
+        (void)std::transform(src, src + size, dst, [](float x) { return float16(x); });
+      }
+    }
+  }
+}
+
+bool LoopProgramCpuKernelMod::Launch(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &,
+                                     const std::vector<AddressPtr> &outputs, void *) {
+  if (inputs.size() != program_->inputs().size() || outputs.size() != program_->outputs().size()) {
+    MS_LOG(ERROR) << "For " << kernel_name_ << ", the number of inputs and outputs should be "
+                  << program_->inputs().size() << " and " << program_->outputs().size() << ", but got "
+                  << inputs.size() << " and " << outputs.size();
+    return false;
+  }
+  auto inner_size = LongToSize(program_->inner_size());
+  auto task = [this, &inputs, &outputs, inner_size](size_t start, size_t end) {
+    const auto &info = program_->values();
+    // The consts are stored after the tile buffers.
+    std::vector<float> buffer(buffer_num_ * tile_size_ + const_num_);
+    std::vector<float *> values(info.size(), nullptr);
+    for (size_t v = 0; v < info.size(); ++v) {
+      if (storage_[v] == Storage::kConst) {
+        values[v] = buffer.data() + buffer_num_ * tile_size_ + location_[v];
+        *values[v] = info[v].const_value;
+      } else if (storage_[v] == Storage::kBuffer) {
+        values[v] = buffer.data() + location_[v] * tile_size_;
+      }
+    }
+    for (size_t item = start; item < end; ++item) {
+      Tile tile;
+      tile.row = item / tile_num_;
+      tile.begin = (item % tile_num_) * tile_size_;
+      tile.size = std::min(tile_size_, inner_size - tile.begin);
+      for (size_t i = 0; i < outputs.size(); ++i) {
+        auto v = program_->outputs()[i].value;
+        if (storage_[v] == Storage::kOutput && location_[v] == i) {
+          values[v] = static_cast<float *>(outputs[i]->addr) + Offset(program_->outputs()[i], tile.row) + tile.begin;
+        }
+      }
+      Load(inputs, tile, &values);
+      Execute(tile, values);
+      Store(outputs, tile, values);
+    }
+  };
+  auto item_num = LongToSize(program_->row_num()) * tile_num_;
+  auto block_size = std::max(1.0f, static_cast<float>(kMinElementsPerTask) / static_cast<float>(tile_size_));
+  ParallelLaunch(task, item_num, block_size);
+  return true;
+}
+}  // namespace kernel
+}  // namespace mindspore
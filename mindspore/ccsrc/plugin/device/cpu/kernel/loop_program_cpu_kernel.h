@@ -0,0 +1,67 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_LOOP_PROGRAM_CPU_KERNEL_H_
+#define MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_LOOP_PROGRAM_CPU_KERNEL_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "kernel/kernel.h"
+#include "plugin/device/cpu/kernel/cpu_kernel.h"
+#include "backend/common/graph_kernel/model/loop_program.h"
+
+namespace mindspore {
+namespace kernel {
+// Run a graph kernel node lowered to a LoopProgram, used when the AKG cpu backend is not available.
+// Every row of the program is cut into tiles that are evaluated by the nnacl primitives, so the intermediate values of
+// the cluster stay in small per-thread buffers instead of going through memory.
+class LoopProgramCpuKernelMod : public CpuKernelMod {
+ public:
+  LoopProgramCpuKernelMod(const std::string &kernel_name, const graphkernel::inner::LoopProgramPtr &program);
+  ~LoopProgramCpuKernelMod() = default;
+
+  bool Launch(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &,
+              const std::vector<AddressPtr> &outputs, void *) override;
+
+  std::vector<KernelAttr> GetOpSupport() { return {}; }
+
+ private:
+  enum class Storage { kConst, kInput, kOutput, kBuffer };
+  struct Tile {
+    size_t row;
+    size_t begin;
+    size_t size;
+  };
+
+  void PlanStorage();
+  size_t Offset(const graphkernel::inner::LoopProgram::Argument &arg, size_t row) const;
+  void Load(const std::vector<AddressPtr> &inputs, const Tile &tile, std::vector<float *> *values) const;
+  void Execute(const Tile &tile, const std::vector<float *> &values) const;
+  void Store(const std::vector<AddressPtr> &outputs, const Tile &tile, const std::vector<float *> &values) const;
+
+  graphkernel::inner::LoopProgramPtr program_;
+  size_t tile_size_{0};
+  size_t tile_num_{0};
+  std::vector<Storage> storage_;
+  // The buffer of a kBuffer value, the argument index of a kInput or kOutput value.
+  std::vector<size_t> location_;
+  size_t buffer_num_{0};
+  size_t const_num_{0};
+};
+}  // namespace kernel
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_CPU_LOOP_PROGRAM_CPU_KERNEL_H_
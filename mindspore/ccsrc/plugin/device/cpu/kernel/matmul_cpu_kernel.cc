@@ -176,6 +176,26 @@ int MatMulCpuKernelMod::Resize(const BaseOperatorPtr &base_operator, const std::
   return func_obj_->Resize(base_operator, inputs, outputs, inputsOnHost);
 }
 
+double MatMulCpuKernelMod::EstimateFlops(const std::vector<ShapeVector> &input_shapes,
+                                         const std::vector<ShapeVector> &output_shapes) const {
+  // Each output element takes a multiply and an add per element of the reduced axis, which is whichever axis of the
+  // last two of input a is not the row axis of the output.
+  constexpr size_t kMatrixRank = 2;
+  if (input_shapes.empty() || output_shapes.empty() || input_shapes[kIndex0].size() < kMatrixRank ||
+      output_shapes[kIndex0].size() < kMatrixRank) {
+    return NativeCpuKernelMod::EstimateFlops(input_shapes, output_shapes);
+  }
+  const auto &a_shape = input_shapes[kIndex0];
+  const auto &output_shape = output_shapes[kIndex0];
+  auto row = output_shape[output_shape.size() - kMatrixRank];
+  if (row <= 0) {
+    return 0;
+  }
+  auto depth = a_shape[a_shape.size() - kIndex1] * a_shape[a_shape.size() - kIndex2] / row;
+  constexpr double kMultiplyAdd = 2;
+  return kMultiplyAdd * static_cast<double>(SizeOf(output_shape)) * static_cast<double>(depth);
+}
+
 MS_KERNEL_FACTORY_REG_BY_CREATOR(NativeCpuKernelMod, MatMul,
                                  []() { return std::make_shared<MatMulCpuKernelMod>(kMatMul); });
 MS_KERNEL_FACTORY_REG_BY_CREATOR(NativeCpuKernelMod, BatchMatMul,
@@ -53,6 +53,9 @@ class MatMulCpuKernelMod : public NativeCpuKernelMod {
 
   std::vector<KernelAttr> GetOpSupport() override;
 
+  double EstimateFlops(const std::vector<ShapeVector> &input_shapes,
+                       const std::vector<ShapeVector> &output_shapes) const override;
+
  private:
   std::shared_ptr<CpuKernelFunc> func_obj_;
   std::string kernel_type_{kUnkown};
@@ -122,6 +122,19 @@ bool ConvCpuKernelMod::Launch(const std::vector<kernel::AddressPtr> &inputs, con
   return true;
 }
 
+double ConvCpuKernelMod::EstimateFlops(const std::vector<ShapeVector> &input_shapes,
+                                       const std::vector<ShapeVector> &output_shapes) const {
+  // Each output element takes a multiply and an add per weight of its output channel.
+  if (input_shapes.size() < kConvInputsNum || output_shapes.empty() || input_shapes[kIndex1].empty() ||
+      input_shapes[kIndex1][kIndex0] <= 0) {
+    return NativeCpuKernelMod::EstimateFlops(input_shapes, output_shapes);
+  }
+  const auto &weight_shape = input_shapes[kIndex1];
+  auto weights_per_channel = static_cast<double>(SizeOf(weight_shape)) / static_cast<double>(weight_shape[kIndex0]);
+  constexpr double kMultiplyAdd = 2;
+  return kMultiplyAdd * static_cast<double>(SizeOf(output_shapes[kIndex0])) * weights_per_channel;
+}
+
 MS_KERNEL_FACTORY_REG(NativeCpuKernelMod, Conv2D, ConvCpuKernelMod);
 MS_KERNEL_FACTORY_REG(NativeCpuKernelMod, Conv3D, ConvCpuKernelMod);
 }  // namespace kernel
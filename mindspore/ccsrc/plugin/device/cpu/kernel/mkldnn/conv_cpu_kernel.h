@@ -39,6 +39,9 @@ class ConvCpuKernelMod : public MKLCpuKernelMod {
   bool Launch(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &workspace,
               const std::vector<AddressPtr> &outputs) override;
 
+  double EstimateFlops(const std::vector<ShapeVector> &input_shapes,
+                       const std::vector<ShapeVector> &output_shapes) const override;
+
  private:
   std::string format_;
   std::string pad_mode_;
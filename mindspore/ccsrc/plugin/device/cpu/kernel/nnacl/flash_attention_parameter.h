@@ -0,0 +1,41 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef NNACL_FLASH_ATTENTION_PARAMETER_H_
+#define NNACL_FLASH_ATTENTION_PARAMETER_H_
+
+#include "nnacl/op_base.h"
+
+typedef struct FlashAttentionParameter {
+  // Primitive parameter
+  OpParameter op_parameter_;
+  float scale_;     // scale applied to q * k^T before softmax
+  bool is_causal_;  // query i attends key j only when j <= i + kv_seq_len_ - q_seq_len_
+  // shape correlative, q is [batch, q_head_num, q_seq_len, head_size], k/v are [batch, kv_head_num, kv_seq_len,
+  // head_size], the optional additive mask is [mask_batch, mask_head, q_seq_len, kv_seq_len]
+  int batch_;
+  int q_head_num_;
+  int kv_head_num_;
+  int q_seq_len_;
+  int kv_seq_len_;
+  int head_size_;
+  int mask_batch_;
+  int mask_head_;
+  // tile of the query rows and the key/value rows computed at a time
+  int q_tile_;
+  int kv_tile_;
+} FlashAttentionParameter;
+
+#endif  // NNACL_FLASH_ATTENTION_PARAMETER_H_
@@ -0,0 +1,94 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nnacl/fp16/flash_attention_fp16.h"
+#include "nnacl/fp32/flash_attention_fp32.h"
+#include "nnacl/intrinsics/ms_simd_instructions_fp16.h"
+
+static inline float FlashAttentionRowDotFp16(const float16_t *a, const float16_t *b, int size) {
+  int index = 0;
+  float dot = 0.0f;
+#ifdef ENABLE_NEON
+  float32x4_t dot_low = vdupq_n_f32(0.0f);
+  float32x4_t dot_high = vdupq_n_f32(0.0f);
+  for (; index <= size - C8NUM; index += C8NUM) {
+    float16x8_t a_8 = vld1q_f16(a + index);
+    float16x8_t b_8 = vld1q_f16(b + index);
+    dot_low = vmlaq_f32(dot_low, MS_CVT_F32_F16(vget_low_f16(a_8)), MS_CVT_F32_F16(vget_low_f16(b_8)));
+    dot_high = vmlaq_f32(dot_high, MS_CVT_F32_F16(vget_high_f16(a_8)), MS_CVT_F32_F16(vget_high_f16(b_8)));
+  }
+  dot = MS_ADDVQ_F32(vaddq_f32(dot_low, dot_high));
+#endif
+  for (; index < size; index++) {
+    dot += (float)a[index] * (float)b[index];
+  }
+  return dot;
+}
+
+static inline void FlashAttentionRowAxpyFp16(float *dst, const float16_t *src, float alpha, int size) {
+  int index = 0;
+#ifdef ENABLE_NEON
+  float32x4_t alpha_4 = vdupq_n_f32(alpha);
+  for (; index <= size - C8NUM; index += C8NUM) {
+    float16x8_t src_8 = vld1q_f16(src + index);
+    vst1q_f32(dst + index, vmlaq_f32(vld1q_f32(dst + index), MS_CVT_F32_F16(vget_low_f16(src_8)), alpha_4));
+    vst1q_f32(dst + index + C4NUM,
+              vmlaq_f32(vld1q_f32(dst + index + C4NUM), MS_CVT_F32_F16(vget_high_f16(src_8)), alpha_4));
+  }
+#endif
+  for (; index < size; index++) {
+    dst[index] += (float)src[index] * alpha;
+  }
+}
+
+static void FlashAttentionScoreFp16(const void *q_row, const void *k_tile, float *score, int cols, int head_size,
+                                   float scale) {
+  const float16_t *q = (const float16_t *)q_row;
+  const float16_t *k = (const float16_t *)k_tile;
+  for (int j = 0; j < cols; j++) {
+    score[j] = FlashAttentionRowDotFp16(q, k + j * head_size, head_size) * scale;
+  }
+}
+
+static void FlashAttentionAddMaskFp16(float *score, const void *mask_row, int cols) {
+  const float16_t *mask = (const float16_t *)mask_row;
+  for (int j = 0; j < cols; j++) {
+    score[j] += (float)mask[j];
+  }
+}
+
+static void FlashAttentionAccumulateFp16(float *acc_row, const void *v_tile, const float *score, int cols,
+                                         int head_size) {
+  const float16_t *v = (const float16_t *)v_tile;
+  for (int j = 0; j < cols; j++) {
+    FlashAttentionRowAxpyFp16(acc_row, v + j * head_size, score[j], head_size);
+  }
+}
+
+static void FlashAttentionStoreFp16(void *out_row, float *acc_row, float inv_sum, int head_size) {
+  float16_t *out = (float16_t *)out_row;
+  for (int d = 0; d < head_size; d++) {
+    out[d] = (float16_t)(acc_row[d] * inv_sum);
+  }
+}
+
+int FlashAttentionFp16(const float16_t *q, const float16_t *k, const float16_t *v, const float16_t *mask,
+                       float16_t *out, float *workspace, const FlashAttentionParameter *param, int task_start,
+                       int task_end) {
+  static const FlashAttentionFunc func = {sizeof(float16_t), FlashAttentionScoreFp16, FlashAttentionAddMaskFp16,
+                                          FlashAttentionAccumulateFp16, FlashAttentionStoreFp16};
+  return FlashAttentionCompute(q, k, v, mask, out, workspace, param, task_start, task_end, &func);
+}
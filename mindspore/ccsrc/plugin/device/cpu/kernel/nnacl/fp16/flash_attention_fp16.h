@@ -0,0 +1,33 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_NNACL_FP16_FLASH_ATTENTION_FP16_H_
+#define MINDSPORE_NNACL_FP16_FLASH_ATTENTION_FP16_H_
+
+#include "nnacl/op_base.h"
+#include "nnacl/flash_attention_parameter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// the fp16 version of FlashAttentionFp32, scores and the output accumulator are kept in float, the workspace size is
+// the same FlashAttentionWorkspaceSize floats per thread.
+int FlashAttentionFp16(const float16_t *q, const float16_t *k, const float16_t *v, const float16_t *mask,
+                       float16_t *out, float *workspace, const FlashAttentionParameter *param, int task_start,
+                       int task_end);
+#ifdef __cplusplus
+}
+#endif
+#endif  // MINDSPORE_NNACL_FP16_FLASH_ATTENTION_FP16_H_
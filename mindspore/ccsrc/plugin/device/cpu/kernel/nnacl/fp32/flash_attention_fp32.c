@@ -0,0 +1,222 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nnacl/fp32/flash_attention_fp32.h"
+#include <float.h>
+#include <string.h>
+#include "nnacl/errorcode.h"
+#include "nnacl/flash_attention_fp32_simd.h"
+
+size_t FlashAttentionWorkspaceSize(const FlashAttentionParameter *param) {
+  size_t q_tile = (size_t)param->q_tile_;
+  return q_tile * (size_t)param->kv_tile_ + q_tile * C2NUM + q_tile * (size_t)param->head_size_;
+}
+
+int FlashAttentionTaskNum(const FlashAttentionParameter *param) {
+  return param->batch_ * param->q_head_num_ * UP_DIV(param->q_seq_len_, param->q_tile_);
+}
+
+static inline float FlashAttentionRowDot(const float *a, const float *b, int size) {
+  int index = 0;
+  float dot = 0.0f;
+  SIMD_RUN_NO_SCALAR(FlashAttentionDot, index, a, b, &dot, size);
+  for (; index < size; index++) {
+    dot += a[index] * b[index];
+  }
+  return dot;
+}
+
+static inline float FlashAttentionRowMax(const float *src, int size) {
+  int index = 0;
+  float max = -FLT_MAX;
+  SIMD_RUN_NO_SCALAR(FlashAttentionMax, index, src, &max, size);
+  for (; index < size; index++) {
+    max = src[index] > max ? src[index] : max;
+  }
+  return max;
+}
+
+static inline float FlashAttentionRowExpSum(float *src, float max, int size) {
+  int index = 0;
+  float exp_sum = 0.0f;
+  SIMD_RUN_NO_SCALAR(FlashAttentionExpSum, index, src, max, &exp_sum, size);
+  for (; index < size; index++) {
+    src[index] = simd_exp32_f32(src[index] - max);
+    exp_sum += src[index];
+  }
+  return exp_sum;
+}
+
+static inline void FlashAttentionRowAxpy(float *dst, const float *src, float alpha, int size) {
+  int index = 0;
+  SIMD_RUN_NO_SCALAR(FlashAttentionAxpy, index, dst, src, alpha, size);
+  for (; index < size; index++) {
+    dst[index] += src[index] * alpha;
+  }
+}
+
+static inline void FlashAttentionRowScale(float *dst, float scale, int size) {
+  int index = 0;
+  SIMD_RUN_NO_SCALAR(FlashAttentionScale, index, dst, scale, size);
+  for (; index < size; index++) {
+    dst[index] *= scale;
+  }
+}
+
+static float FlashAttentionOnlineSoftmax(float *score, int size, float *row_max, float *row_sum) {
+  // rescale what is accumulated so far when the running max grows.
+  float block_max = FlashAttentionRowMax(score, size);
+  float new_max = MSMAX(*row_max, block_max);
+  float exp_sum = FlashAttentionRowExpSum(score, new_max, size);
+  float correction = simd_exp32_f32(*row_max - new_max);
+  *row_sum = *row_sum * correction + exp_sum;
+  *row_max = new_max;
+  return correction;
+}
+
+static void FlashAttentionScoreFp32(const void *q_row, const void *k_tile, float *score, int cols, int head_size,
+                                   float scale) {
+  const float *q = (const float *)q_row;
+  const float *k = (const float *)k_tile;
+  for (int j = 0; j < cols; j++) {
+    score[j] = FlashAttentionRowDot(q, k + j * head_size, head_size) * scale;
+  }
+}
+
+static void FlashAttentionAddMaskFp32(float *score, const void *mask_row, int cols) {
+  const float *mask = (const float *)mask_row;
+  for (int j = 0; j < cols; j++) {
+    score[j] += mask[j];
+  }
+}
+
+static void FlashAttentionAccumulateFp32(float *acc_row, const void *v_tile, const float *score, int cols,
+                                         int head_size) {
+  const float *v = (const float *)v_tile;
+  for (int j = 0; j < cols; j++) {
+    FlashAttentionRowAxpy(acc_row, v + j * head_size, score[j], head_size);
+  }
+}
+
+static void FlashAttentionStoreFp32(void *out_row, float *acc_row, float inv_sum, int head_size) {
+  FlashAttentionRowScale(acc_row, inv_sum, head_size);
+  memcpy(out_row, acc_row, (size_t)head_size * sizeof(float));
+}
+
+// q/out point to the [q_seq_len, head_size] matrix of one query head, k/v to that of the matching key/value head and
+// mask to the [q_seq_len, kv_seq_len] matrix of the head or NULL. Computes the query rows in [q_start, q_end).
+static void FlashAttentionTile(const uint8_t *q, const uint8_t *k, const uint8_t *v, const uint8_t *mask,
+                               uint8_t *out, float *workspace, const FlashAttentionParameter *param, int q_start,
+                               int q_end, const FlashAttentionFunc *func) {
+  int head_size = param->head_size_;
+  int kv_tile = param->kv_tile_;
+  int kv_seq_len = param->kv_seq_len_;
+  size_t row_bytes = (size_t)head_size * func->data_size_;
+  int rows = q_end - q_start;
+  float *scores = workspace;
+  float *row_max = scores + param->q_tile_ * kv_tile;
+  float *row_sum = row_max + param->q_tile_;
+  float *acc = row_sum + param->q_tile_;
+  for (int r = 0; r < rows; r++) {
+    row_max[r] = -FLT_MAX;
+    row_sum[r] = 0.0f;
+  }
+  memset(acc, 0, (size_t)rows * (size_t)head_size * sizeof(float));
+
+  // with causal mask, query i sees the keys up to i + causal_offset, so keys after the last query row are skipped.
+  int causal_offset = kv_seq_len - param->q_seq_len_;
+  int kv_end = param->is_causal_ ? MSMIN(kv_seq_len, q_end + causal_offset) : kv_seq_len;
+  for (int kv_start = 0; kv_start < kv_end; kv_start += kv_tile) {
+    int cols = MSMIN(kv_tile, kv_end - kv_start);
+    const uint8_t *k_tile = k + (size_t)kv_start * row_bytes;
+    const uint8_t *v_tile = v + (size_t)kv_start * row_bytes;
+    for (int r = 0; r < rows; r++) {
+      int q_index = q_start + r;
+      int valid = param->is_causal_ ? MSMIN(cols, q_index + causal_offset + 1 - kv_start) : cols;
+      if (valid <= 0) {
+        continue;
+      }
+      float *score = scores + r * kv_tile;
+      func->score_(q + (size_t)q_index * row_bytes, k_tile, score, valid, head_size, param->scale_);
+      if (mask != NULL) {
+        func->add_mask_(score, mask + ((size_t)q_index * (size_t)kv_seq_len + (size_t)kv_start) * func->data_size_,
+                        valid);
+      }
+      float correction = FlashAttentionOnlineSoftmax(score, valid, row_max + r, row_sum + r);
+      float *acc_row = acc + r * head_size;
+      if (correction != 1.0f) {
+        FlashAttentionRowScale(acc_row, correction, head_size);
+      }
+      func->accumulate_(acc_row, v_tile, score, valid, head_size);
+    }
+  }
+
+  for (int r = 0; r < rows; r++) {
+    // a row which sees no key at all is zero.
+    float inv_sum = row_sum[r] > 0.0f ? 1.0f / row_sum[r] : 0.0f;
+    func->store_(out + (size_t)(q_start + r) * row_bytes, acc + r * head_size, inv_sum, head_size);
+  }
+}
+
+int FlashAttentionCompute(const void *q, const void *k, const void *v, const void *mask, void *out, float *workspace,
+                          const FlashAttentionParameter *param, int task_start, int task_end,
+                          const FlashAttentionFunc *func) {
+  NNACL_CHECK_NULL_RETURN_ERR(q);
+  NNACL_CHECK_NULL_RETURN_ERR(k);
+  NNACL_CHECK_NULL_RETURN_ERR(v);
+  NNACL_CHECK_NULL_RETURN_ERR(out);
+  NNACL_CHECK_NULL_RETURN_ERR(workspace);
+  NNACL_CHECK_NULL_RETURN_ERR(param);
+  NNACL_CHECK_NULL_RETURN_ERR(func);
+  NNACL_CHECK_ZERO_RETURN_ERR(param->q_tile_);
+  NNACL_CHECK_ZERO_RETURN_ERR(param->kv_tile_);
+  NNACL_CHECK_ZERO_RETURN_ERR(param->kv_head_num_);
+  NNACL_CHECK_TRUE_RET(param->q_head_num_ % param->kv_head_num_ == 0, NNACL_PARAM_INVALID);
+  int group = param->q_head_num_ / param->kv_head_num_;
+  int q_blocks = UP_DIV(param->q_seq_len_, param->q_tile_);
+  size_t q_head_bytes = (size_t)param->q_seq_len_ * (size_t)param->head_size_ * func->data_size_;
+  size_t kv_head_bytes = (size_t)param->kv_seq_len_ * (size_t)param->head_size_ * func->data_size_;
+  size_t mask_head_bytes = (size_t)param->q_seq_len_ * (size_t)param->kv_seq_len_ * func->data_size_;
+  for (int task = task_start; task < task_end; task++) {
+    int q_block = task % q_blocks;
+    int head = task / q_blocks;
+    int b = head / param->q_head_num_;
+    int h = head % param->q_head_num_;
+    int kv_head = b * param->kv_head_num_ + h / group;
+    const uint8_t *mask_head = NULL;
+    if (mask != NULL) {
+      int mask_b = param->mask_batch_ == 1 ? 0 : b;
+      int mask_h = param->mask_head_ == 1 ? 0 : h;
+      mask_head =
+        (const uint8_t *)mask + ((size_t)mask_b * (size_t)param->mask_head_ + (size_t)mask_h) * mask_head_bytes;
+    }
+    int q_start = q_block * param->q_tile_;
+    int q_end = MSMIN(q_start + param->q_tile_, param->q_seq_len_);
+    const uint8_t *q_head = (const uint8_t *)q + (size_t)head * q_head_bytes;
+    const uint8_t *k_head = (const uint8_t *)k + (size_t)kv_head * kv_head_bytes;
+    const uint8_t *v_head = (const uint8_t *)v + (size_t)kv_head * kv_head_bytes;
+    FlashAttentionTile(q_head, k_head, v_head, mask_head, (uint8_t *)out + (size_t)head * q_head_bytes, workspace,
+                       param, q_start, q_end, func);
+  }
+  return NNACL_OK;
+}
+
+int FlashAttentionFp32(const float *q, const float *k, const float *v, const float *mask, float *out,
+                       float *workspace, const FlashAttentionParameter *param, int task_start, int task_end) {
+  static const FlashAttentionFunc func = {sizeof(float), FlashAttentionScoreFp32, FlashAttentionAddMaskFp32,
+                                          FlashAttentionAccumulateFp32, FlashAttentionStoreFp32};
+  return FlashAttentionCompute(q, k, v, mask, out, workspace, param, task_start, task_end, &func);
+}
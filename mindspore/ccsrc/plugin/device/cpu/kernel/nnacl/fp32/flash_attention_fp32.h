@@ -0,0 +1,56 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_NNACL_FP32_FLASH_ATTENTION_FP32_H_
+#define MINDSPORE_NNACL_FP32_FLASH_ATTENTION_FP32_H_
+
+#include "nnacl/op_base.h"
+#include "nnacl/flash_attention_parameter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// number of float needed by one thread: a q_tile x kv_tile score tile, the running max and sum of each query row and
+// a q_tile x head_size output accumulator. The q_seq_len x kv_seq_len score matrix is never materialized.
+size_t FlashAttentionWorkspaceSize(const FlashAttentionParameter *param);
+
+// number of tasks which can run in parallel: batch * q_head_num * UP_DIV(q_seq_len, q_tile).
+int FlashAttentionTaskNum(const FlashAttentionParameter *param);
+
+// the data type specific parts of a query row, scores and the output accumulator are always float.
+typedef struct FlashAttentionFunc {
+  size_t data_size_;
+  // score[j] = dot(q_row, k_tile[j]) * scale for j in [0, cols)
+  void (*score_)(const void *q_row, const void *k_tile, float *score, int cols, int head_size, float scale);
+  void (*add_mask_)(float *score, const void *mask_row, int cols);
+  // acc_row += score[j] * v_tile[j] for j in [0, cols)
+  void (*accumulate_)(float *acc_row, const void *v_tile, const float *score, int cols, int head_size);
+  // out_row = acc_row * inv_sum, acc_row may be overwritten
+  void (*store_)(void *out_row, float *acc_row, float inv_sum, int head_size);
+} FlashAttentionFunc;
+
+// the tiling, online softmax and task split shared by all data types, see FlashAttentionFp32.
+int FlashAttentionCompute(const void *q, const void *k, const void *v, const void *mask, void *out, float *workspace,
+                          const FlashAttentionParameter *param, int task_start, int task_end,
+                          const FlashAttentionFunc *func);
+
+// softmax(q * k^T * scale + mask) * v for the tasks in [task_start, task_end), the softmax is computed online block by
+// block of kv_tile keys. Query heads share the key/value head q_head_num / kv_head_num of them (grouped-query).
+int FlashAttentionFp32(const float *q, const float *k, const float *v, const float *mask, float *out,
+                       float *workspace, const FlashAttentionParameter *param, int task_start, int task_end);
+#ifdef __cplusplus
+}
+#endif
+#endif  // MINDSPORE_NNACL_FP32_FLASH_ATTENTION_FP32_H_
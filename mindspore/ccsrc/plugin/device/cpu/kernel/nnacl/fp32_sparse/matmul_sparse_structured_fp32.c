@@ -0,0 +1,401 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nnacl/fp32_sparse/matmul_sparse_structured_fp32.h"
+#include <string.h>
+#include "nnacl/errorcode.h"
+#include "nnacl/matmul_sparse_structured_fp32_simd.h"
+
+#define SPARSE_WEIGHT_MAGIC 0x57525053
+#define SPARSE_HEADER_NUM C8NUM
+#define SPARSE_COLUMN_UNROLL C4NUM
+
+typedef struct SparseWeightLayout {
+  size_t index_offset_;
+  size_t data_offset_;
+  size_t total_size_;
+} SparseWeightLayout;
+
+static void SparseGetLayout(int format, int col, int block_k, int block_n, int nnz, SparseWeightLayout *layout) {
+  size_t header_size = SPARSE_HEADER_NUM * sizeof(int32_t);
+  size_t data_num;
+  if (format == SparseWeightFormat_Block) {
+    size_t col_ptr_size = (size_t)(UP_DIV(col, block_n) + 1) * sizeof(int32_t);
+    layout->index_offset_ = header_size + col_ptr_size;
+    layout->data_offset_ = UP_ROUND(layout->index_offset_ + (size_t)nnz * sizeof(int32_t), C64NUM);
+    data_num = (size_t)nnz * (size_t)block_k * (size_t)block_n;
+  } else {
+    layout->index_offset_ = header_size;
+    layout->data_offset_ = UP_ROUND(layout->index_offset_ + (size_t)col * (size_t)nnz, C64NUM);
+    data_num = (size_t)col * (size_t)nnz;
+  }
+  layout->total_size_ = layout->data_offset_ + data_num * sizeof(float);
+}
+
+static void SparseWriteHeader(int32_t *header, int format, int deep, int col, int block_k, int block_n, int nnz) {
+  header[0] = SPARSE_WEIGHT_MAGIC;
+  header[C1NUM] = format;
+  header[C2NUM] = deep;
+  header[C3NUM] = col;
+  header[C4NUM] = block_k;
+  header[C5NUM] = block_n;
+  header[C6NUM] = nnz;
+  header[C7NUM] = 0;
+}
+
+bool SparseNonZeroLess(const float *src, int size, int max_non_zero) {
+  // once max_non_zero nonzeros or size - max_non_zero + 1 zeros are seen the rest can not change the answer.
+  int max_zero = size - max_non_zero;
+  int non_zero = 0;
+  int zero = 0;
+  for (int i = 0; i < size; i++) {
+    if (src[i] != 0.0f) {
+      if (++non_zero >= max_non_zero) {
+        return false;
+      }
+    } else if (++zero > max_zero) {
+      return true;
+    }
+  }
+  return non_zero < max_non_zero;
+}
+
+static bool SparseBlockIsZero(const float *b, int deep, int col, int stride_k, int stride_n, int k_start, int j_start,
+                              int block_k, int block_n) {
+  int k_end = MSMIN(k_start + block_k, deep);
+  int j_end = MSMIN(j_start + block_n, col);
+  for (int k = k_start; k < k_end; k++) {
+    for (int j = j_start; j < j_end; j++) {
+      if (b[k * stride_k + j * stride_n] != 0.0f) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int SparseBlockNum(const float *b, int deep, int col, int stride_k, int stride_n, int block_k, int block_n) {
+  int block_num = 0;
+  for (int j = 0; j < col; j += block_n) {
+    for (int k = 0; k < deep; k += block_k) {
+      block_num += SparseBlockIsZero(b, deep, col, stride_k, stride_n, k, j, block_k, block_n) ? 0 : 1;
+    }
+  }
+  return block_num;
+}
+
+int SparseNMKeepNum(const float *b, int deep, int col, int stride_k, int stride_n, int m) {
+  int keep_num = 0;
+  for (int j = 0; j < col; j++) {
+    for (int k_start = 0; k_start < deep; k_start += m) {
+      int k_end = MSMIN(k_start + m, deep);
+      int num = 0;
+      for (int k = k_start; k < k_end; k++) {
+        num += b[k * stride_k + j * stride_n] != 0.0f ? 1 : 0;
+      }
+      keep_num = MSMAX(keep_num, num);
+    }
+  }
+  return keep_num;
+}
+
+size_t SparseBlockPackSize(int col, int block_k, int block_n, int block_num) {
+  SparseWeightLayout layout;
+  SparseGetLayout(SparseWeightFormat_Block, col, block_k, block_n, block_num, &layout);
+  return layout.total_size_;
+}
+
+size_t SparseNMPackSize(int deep, int col, int n, int m) {
+  SparseWeightLayout layout;
+  SparseGetLayout(SparseWeightFormat_NM, col, m, n, UP_DIV(deep, m) * n, &layout);
+  return layout.total_size_;
+}
+
+int SparseBlockPack(const float *b, int deep, int col, int stride_k, int stride_n, int block_k, int block_n,
+                    void *buf, size_t size) {
+  if (b == NULL || buf == NULL || deep <= 0 || col <= 0 || block_k <= 0 || block_n <= 0) {
+    return NNACL_PARAM_INVALID;
+  }
+  int block_num = SparseBlockNum(b, deep, col, stride_k, stride_n, block_k, block_n);
+  SparseWeightLayout layout;
+  SparseGetLayout(SparseWeightFormat_Block, col, block_k, block_n, block_num, &layout);
+  if (size < layout.total_size_) {
+    return NNACL_PARAM_INVALID;
+  }
+  memset(buf, 0, layout.total_size_);
+  SparseWriteHeader((int32_t *)buf, SparseWeightFormat_Block, deep, col, block_k, block_n, block_num);
+  int32_t *col_ptr = (int32_t *)buf + SPARSE_HEADER_NUM;
+  int32_t *block_idx = (int32_t *)((uint8_t *)buf + layout.index_offset_);
+  float *data = (float *)((uint8_t *)buf + layout.data_offset_);
+  int index = 0;
+  for (int jb = 0; jb < UP_DIV(col, block_n); jb++) {
+    col_ptr[jb] = index;
+    int j_start = jb * block_n;
+    for (int kb = 0; kb < UP_DIV(deep, block_k); kb++) {
+      int k_start = kb * block_k;
+      if (SparseBlockIsZero(b, deep, col, stride_k, stride_n, k_start, j_start, block_k, block_n)) {
+        continue;
+      }
+      float *block = data + (size_t)index * (size_t)block_k * (size_t)block_n;
+      for (int k = k_start; k < MSMIN(k_start + block_k, deep); k++) {
+        for (int j = j_start; j < MSMIN(j_start + block_n, col); j++) {
+          block[(k - k_start) * block_n + (j - j_start)] = b[k * stride_k + j * stride_n];
+        }
+      }
+      block_idx[index++] = kb;
+    }
+  }
+  col_ptr[UP_DIV(col, block_n)] = index;
+  return NNACL_OK;
+}
+
+int SparseNMPack(const float *b, int deep, int col, int stride_k, int stride_n, int n, int m, void *buf,
+                 size_t size) {
+  if (b == NULL || buf == NULL || deep <= 0 || col <= 0 || n <= 0 || n > m || m > SPARSE_NM_MAX_M) {
+    return NNACL_PARAM_INVALID;
+  }
+  int nnz = UP_DIV(deep, m) * n;
+  SparseWeightLayout layout;
+  SparseGetLayout(SparseWeightFormat_NM, col, m, n, nnz, &layout);
+  if (size < layout.total_size_) {
+    return NNACL_PARAM_INVALID;
+  }
+  memset(buf, 0, layout.total_size_);
+  SparseWriteHeader((int32_t *)buf, SparseWeightFormat_NM, deep, col, m, n, nnz);
+  uint8_t *idx = (uint8_t *)buf + layout.index_offset_;
+  float *data = (float *)((uint8_t *)buf + layout.data_offset_);
+  for (int j = 0; j < col; j++) {
+    uint8_t *col_idx = idx + (size_t)j * (size_t)nnz;
+    float *col_data = data + (size_t)j * (size_t)nnz;
+    for (int k_start = 0, g = 0; k_start < deep; k_start += m, g++) {
+      int kept = 0;
+      for (int k = k_start; k < MSMIN(k_start + m, deep); k++) {
+        float value = b[k * stride_k + j * stride_n];
+        if (value == 0.0f) {
+          continue;
+        }
+        if (kept == n) {
+          return NNACL_ERR;
+        }
+        // unused slots keep index 0 and value 0, which stay inside the group.
+        col_idx[g * n + kept] = (uint8_t)(k - k_start);
+        col_data[g * n + kept] = value;
+        kept++;
+      }
+    }
+  }
+  return NNACL_OK;
+}
+
+static int SparseCheckBlockIndex(const SparseStructuredWeight *weight) {
+  int col_block = UP_DIV(weight->col_, weight->block_n_);
+  int deep_block = UP_DIV(weight->deep_, weight->block_k_);
+  if (weight->col_ptr_[0] != 0 || weight->col_ptr_[col_block] != weight->nnz_) {
+    return NNACL_ERR;
+  }
+  for (int jb = 0; jb < col_block; jb++) {
+    if (weight->col_ptr_[jb] > weight->col_ptr_[jb + 1]) {
+      return NNACL_ERR;
+    }
+  }
+  for (int i = 0; i < weight->nnz_; i++) {
+    if (weight->block_idx_[i] < 0 || weight->block_idx_[i] >= deep_block) {
+      return NNACL_ERR;
+    }
+  }
+  return NNACL_OK;
+}
+
+static int SparseCheckNMIndex(const SparseStructuredWeight *weight) {
+  size_t idx_num = (size_t)weight->col_ * (size_t)weight->nnz_;
+  for (size_t i = 0; i < idx_num; i++) {
+    if (weight->nm_idx_[i] >= weight->block_k_) {
+      return NNACL_ERR;
+    }
+  }
+  return NNACL_OK;
+}
+
+int SparseStructuredWeightInit(const void *buf, size_t size, SparseStructuredWeight *weight) {
+  if (buf == NULL || weight == NULL || size < SPARSE_HEADER_NUM * sizeof(int32_t)) {
+    return NNACL_NULL_PTR;
+  }
+  const int32_t *header = (const int32_t *)buf;
+  if (header[0] != SPARSE_WEIGHT_MAGIC) {
+    return NNACL_ERR;
+  }
+  weight->format_ = header[C1NUM];
+  weight->deep_ = header[C2NUM];
+  weight->col_ = header[C3NUM];
+  weight->block_k_ = header[C4NUM];
+  weight->block_n_ = header[C5NUM];
+  weight->nnz_ = header[C6NUM];
+  if (weight->deep_ <= 0 || weight->col_ <= 0 || weight->block_k_ <= 0 || weight->block_n_ <= 0 || weight->nnz_ < 0) {
+    return NNACL_ERR;
+  }
+  if (weight->format_ == SparseWeightFormat_NM &&
+      (weight->block_k_ > SPARSE_NM_MAX_M || weight->block_n_ > weight->block_k_ ||
+       weight->nnz_ != UP_DIV(weight->deep_, weight->block_k_) * weight->block_n_)) {
+    return NNACL_ERR;
+  }
+  if (weight->format_ != SparseWeightFormat_Block && weight->format_ != SparseWeightFormat_NM) {
+    return NNACL_ERR;
+  }
+  SparseWeightLayout layout;
+  SparseGetLayout(weight->format_, weight->col_, weight->block_k_, weight->block_n_, weight->nnz_, &layout);
+  if (size < layout.total_size_) {
+    return NNACL_ERR;
+  }
+  const uint8_t *base = (const uint8_t *)buf;
+  weight->data_ = (const float *)(base + layout.data_offset_);
+  if (weight->format_ == SparseWeightFormat_Block) {
+    weight->col_ptr_ = header + SPARSE_HEADER_NUM;
+    weight->block_idx_ = (const int *)(base + layout.index_offset_);
+    weight->nm_idx_ = NULL;
+    return SparseCheckBlockIndex(weight);
+  }
+  weight->col_ptr_ = NULL;
+  weight->block_idx_ = NULL;
+  weight->nm_idx_ = base + layout.index_offset_;
+  return SparseCheckNMIndex(weight);
+}
+
+int SparseStructuredPackDeep(const SparseStructuredWeight *weight) {
+  if (weight->format_ == SparseWeightFormat_Block) {
+    return UP_ROUND(weight->deep_, weight->block_k_);
+  }
+  return weight->deep_;
+}
+
+void SparsePackInputTile(const float *a, float *dst, int rows, int deep, int pack_deep, int stride_row, int stride_k) {
+  for (int k = 0; k < pack_deep; k++) {
+    float *dst_k = dst + k * SPARSE_ROW_TILE;
+    if (k >= deep) {
+      memset(dst_k, 0, SPARSE_ROW_TILE * sizeof(float));
+      continue;
+    }
+    int r = 0;
+    for (; r < rows; r++) {
+      dst_k[r] = a[r * stride_row + k * stride_k];
+    }
+    for (; r < SPARSE_ROW_TILE; r++) {
+      dst_k[r] = 0.0f;
+    }
+  }
+}
+
+static void SparseBlockColumnScalar(const float *a_tile, const float *values, const int *block_idx, int block_num,
+                                    int block_k, int block_n, float *dst, int row_start) {
+  for (int r = row_start; r < SPARSE_ROW_TILE; r++) {
+    float acc = 0.0f;
+    for (int b = 0; b < block_num; b++) {
+      const float *a_block = a_tile + block_idx[b] * block_k * SPARSE_ROW_TILE + r;
+      const float *value = values + b * block_k * block_n;
+      for (int k = 0; k < block_k; k++) {
+        acc += a_block[k * SPARSE_ROW_TILE] * value[k * block_n];
+      }
+    }
+    dst[r] = acc;
+  }
+}
+
+static void SparseBlockColumns(const float *a_tile, const SparseStructuredWeight *weight, float *col_buf,
+                               int col_start, int col_end) {
+  int block_k = weight->block_k_;
+  int block_n = weight->block_n_;
+  int j = col_start;
+  while (j < col_end) {
+    int jb = j / block_n;
+    int in_block = j - jb * block_n;
+    const int *block_idx = weight->block_idx_ + weight->col_ptr_[jb];
+    int block_num = weight->col_ptr_[jb + 1] - weight->col_ptr_[jb];
+    const float *values = weight->data_ + (size_t)weight->col_ptr_[jb] * block_k * block_n + in_block;
+    float *dst = col_buf + (j - col_start) * SPARSE_ROW_TILE;
+    int index = 0;
+    // four adjacent columns of one block column share the loads of the input tile.
+    if (in_block + SPARSE_COLUMN_UNROLL <= block_n && j + SPARSE_COLUMN_UNROLL <= col_end) {
+      SIMD_RUN_NO_SCALAR(SparseBlockColumn4, index, a_tile, values, block_idx, block_num, block_k, block_n, dst,
+                         SPARSE_ROW_TILE);
+      for (int c = 0; c < SPARSE_COLUMN_UNROLL; c++) {
+        SparseBlockColumnScalar(a_tile, values + c, block_idx, block_num, block_k, block_n,
+                                dst + c * SPARSE_ROW_TILE, index);
+      }
+      j += SPARSE_COLUMN_UNROLL;
+      continue;
+    }
+    SIMD_RUN_NO_SCALAR(SparseBlockColumn, index, a_tile, values, block_idx, block_num, block_k, block_n, dst,
+                       SPARSE_ROW_TILE);
+    SparseBlockColumnScalar(a_tile, values, block_idx, block_num, block_k, block_n, dst, index);
+    j++;
+  }
+}
+
+static void SparseNMColumns(const float *a_tile, const SparseStructuredWeight *weight, float *col_buf, int col_start,
+                            int col_end) {
+  int m = weight->block_k_;
+  int n = weight->block_n_;
+  int group_num = UP_DIV(weight->deep_, m);
+  for (int j = col_start; j < col_end; j++) {
+    const float *values = weight->data_ + (size_t)j * weight->nnz_;
+    const uint8_t *idx = weight->nm_idx_ + (size_t)j * weight->nnz_;
+    float *dst = col_buf + (j - col_start) * SPARSE_ROW_TILE;
+    int index = 0;
+    SIMD_RUN_NO_SCALAR(SparseNMColumn, index, a_tile, values, idx, group_num, n, m, dst, SPARSE_ROW_TILE);
+    for (int r = index; r < SPARSE_ROW_TILE; r++) {
+      float acc = 0.0f;
+      for (int g = 0; g < group_num; g++) {
+        const float *a_group = a_tile + g * m * SPARSE_ROW_TILE + r;
+        for (int t = 0; t < n; t++) {
+          acc += a_group[idx[g * n + t] * SPARSE_ROW_TILE] * values[g * n + t];
+        }
+      }
+      dst[r] = acc;
+    }
+  }
+}
+
+static void SparseStoreOutput(const float *col_buf, const float *bias, float *c, int rows, int col_start, int col_end,
+                              int c_stride, ActType act_type) {
+  for (int r = 0; r < rows; r++) {
+    float *dst = c + r * c_stride;
+    for (int j = col_start; j < col_end; j++) {
+      float value = col_buf[(j - col_start) * SPARSE_ROW_TILE + r];
+      if (bias != NULL) {
+        value += bias[j];
+      }
+      if (act_type == ActType_Relu || act_type == ActType_Relu6) {
+        value = MSMAX(value, 0.0f);
+      }
+      if (act_type == ActType_Relu6) {
+        value = MSMIN(value, 6.0f);
+      }
+      dst[j] = value;
+    }
+  }
+}
+
+void SparseStructuredMatmulTile(const float *a_tile, const SparseStructuredWeight *weight, const float *bias, float *c,
+                                float *col_buf, int rows, int col_start, int col_end, int c_stride, ActType act_type) {
+  for (int chunk_start = col_start; chunk_start < col_end; chunk_start += SPARSE_COL_CHUNK) {
+    int chunk_end = MSMIN(chunk_start + SPARSE_COL_CHUNK, col_end);
+    if (weight->format_ == SparseWeightFormat_Block) {
+      SparseBlockColumns(a_tile, weight, col_buf, chunk_start, chunk_end);
+    } else {
+      SparseNMColumns(a_tile, weight, col_buf, chunk_start, chunk_end);
+    }
+    SparseStoreOutput(col_buf, bias, c, rows, chunk_start, chunk_end, c_stride, act_type);
+  }
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NNACL_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
+#define NNACL_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "nnacl/op_base.h"
+
+#define SPARSE_ROW_TILE C16NUM
+#define SPARSE_COL_CHUNK C32NUM
+#define SPARSE_NM_MAX_M 128
+
+typedef enum SparseWeightFormat {
+  SparseWeightFormat_None = 0,
+  // nonzero block_k x block_n blocks of B, stored block column by block column (BSC)
+  SparseWeightFormat_Block = 1,
+  // at most n nonzero elements in every m consecutive deep elements of each column of B
+  SparseWeightFormat_NM = 2,
+} SparseWeightFormat;
+
+/* A structured sparse weight B[deep][col] packed in one self-describing buffer, so the buffer can be produced once
+ * and shared by every kernel using the same weight:
+ *   header   int32[8]   magic, format, deep, col, block_k, block_n, nnz, reserved
+ *   block:   int32 col_ptr[UP_DIV(col, block_n) + 1], int32 block_idx[nnz], float data[nnz][block_k][block_n]
+ *   N:M:     uint8 idx[col][nnz], float data[col][nnz], block_k = m, block_n = n, nnz = UP_DIV(deep, m) * n
+ * data starts at a 64 bytes aligned offset. */
+typedef struct SparseStructuredWeight {
+  int format_;
+  int deep_;
+  int col_;
+  int block_k_;
+  int block_n_;
+  int nnz_;
+  const int *col_ptr_;
+  const int *block_idx_;
+  const uint8_t *nm_idx_;
+  const float *data_;
+} SparseStructuredWeight;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// whether fewer than max_non_zero of the size values are nonzero, the scan stops as soon as it is decided.
+bool SparseNonZeroLess(const float *src, int size, int max_non_zero);
+// element (k, j) of B is b[k * stride_k + j * stride_n], so both B and transposed B can be packed.
+int SparseBlockNum(const float *b, int deep, int col, int stride_k, int stride_n, int block_k, int block_n);
+// the smallest n making B n:m sparse
+int SparseNMKeepNum(const float *b, int deep, int col, int stride_k, int stride_n, int m);
+
+size_t SparseBlockPackSize(int col, int block_k, int block_n, int block_num);
+size_t SparseNMPackSize(int deep, int col, int n, int m);
+int SparseBlockPack(const float *b, int deep, int col, int stride_k, int stride_n, int block_k, int block_n,
+                    void *buf, size_t size);
+int SparseNMPack(const float *b, int deep, int col, int stride_k, int stride_n, int n, int m, void *buf, size_t size);
+int SparseStructuredWeightInit(const void *buf, size_t size, SparseStructuredWeight *weight);
+
+// deep of the packed input tile, the last deep block of the block format is padded with zero.
+int SparseStructuredPackDeep(const SparseStructuredWeight *weight);
+// pack rows of A into a [pack_deep][SPARSE_ROW_TILE] tile, element (r, k) of A is a[r * stride_row + k * stride_k].
+void SparsePackInputTile(const float *a, float *dst, int rows, int deep, int pack_deep, int stride_row, int stride_k);
+// c[r][j] = act(sum_k a[r][k] * b[k][j] + bias[j]) for the rows of the tile and j in [col_start, col_end),
+// col_buf holds SPARSE_ROW_TILE * SPARSE_COL_CHUNK floats.
+void SparseStructuredMatmulTile(const float *a_tile, const SparseStructuredWeight *weight, const float *bias, float *c,
+                                float *col_buf, int rows, int col_start, int col_end, int c_stride, ActType act_type);
+#ifdef __cplusplus
+}
+#endif
+#endif  // NNACL_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
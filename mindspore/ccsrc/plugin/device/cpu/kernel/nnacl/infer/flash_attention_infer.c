@@ -0,0 +1,49 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nnacl/infer/flash_attention_infer.h"
+#include "nnacl/infer/infer_register.h"
+
+int FlashAttentionInferShape(const TensorC *const *inputs, size_t inputs_size, TensorC **outputs, size_t outputs_size,
+                             OpParameter *parameter) {
+  int check_ret = CheckAugmentNullSizeInputTwo(inputs, inputs_size, outputs, outputs_size, parameter, C3NUM, C4NUM, 1);
+  if (check_ret != NNACL_OK) {
+    return check_ret;
+  }
+
+  const TensorC *q = inputs[0];
+  TensorC *output = outputs[0];
+  SetDataTypeFormat(output, q);
+  if (!InferFlag(inputs, inputs_size)) {
+    return NNACL_INFER_INVALID;
+  }
+  const TensorC *k = inputs[1];
+  const TensorC *v = inputs[2];
+  if (q->shape_size_ != C4NUM || k->shape_size_ != C4NUM || v->shape_size_ != C4NUM) {
+    return NNACL_INPUT_TENSOR_ERROR;
+  }
+  if (k->shape_[0] != q->shape_[0] || k->shape_[C3NUM] != q->shape_[C3NUM] || v->shape_[0] != k->shape_[0] ||
+      v->shape_[1] != k->shape_[1] || v->shape_[C2NUM] != k->shape_[C2NUM] || v->shape_[C3NUM] != k->shape_[C3NUM]) {
+    return NNACL_INPUT_TENSOR_ERROR;
+  }
+  if (k->shape_[1] <= 0 || q->shape_[1] % k->shape_[1] != 0) {
+    return NNACL_INPUT_TENSOR_ERROR;
+  }
+  SetShapeTensor(output, q);
+  return NNACL_OK;
+}
+
+REG_INFER(FlashAttention, PrimType_Inner_FlashAttention, FlashAttentionInferShape)
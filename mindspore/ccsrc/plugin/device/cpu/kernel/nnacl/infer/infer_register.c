@@ -76,6 +76,7 @@
 #include "nnacl/infer/fillv2_infer.h"
 #include "nnacl/infer/flatten_grad_infer.h"
 #include "nnacl/infer/flatten_infer.h"
+#include "nnacl/infer/flash_attention_infer.h"
 #include "nnacl/infer/full_connection_infer.h"
 #include "nnacl/infer/fused_batchnorm_infer.h"
 #include "nnacl/infer/gather_infer.h"
@@ -415,6 +416,7 @@ void RegAllInferFunc5() {
   g_inner_op_infer_func[PrimType_Inner_FseDecode - PrimType_InnerOpMin] = FseDecoderInferShape;
 #endif
   g_inner_op_infer_func[PrimType_Inner_CustomGru - PrimType_InnerOpMin] = CustomGruInferShape;
+  g_inner_op_infer_func[PrimType_Inner_FlashAttention - PrimType_InnerOpMin] = FlashAttentionInferShape;
   g_inner_op_infer_func[PrimType_Inner_ToFormat - PrimType_InnerOpMin] = NULL;
 }
 
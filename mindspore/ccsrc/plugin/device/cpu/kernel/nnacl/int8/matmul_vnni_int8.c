@@ -0,0 +1,122 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "nnacl/int8/matmul_vnni_int8.h"
+#include <string.h>
+#include "nnacl/int8/fixed_point.h"
+#include "nnacl/intrinsics/ms_simd_instructions.h"
+
+void RowMajor2RowVnniInt8(const int8_t *src, int8_t *dst, int row, int col) {
+  int col4 = UP_ROUND(col, C4NUM);
+  for (int r = 0; r < row; ++r) {
+    for (int c = 0; c < col; ++c) {
+      dst[r * col4 + c] = (int8_t)((uint8_t)src[r * col + c] ^ 0x80);
+    }
+  }
+}
+
+void RowMajor2ColVnniInt8(const int8_t *src, int8_t *dst, int row, int col) {
+  int row4 = UP_ROUND(row, C4NUM);
+  for (int r = 0; r < row; ++r) {
+    for (int c = 0; c < col; ++c) {
+      dst[c * row4 + r] = (int8_t)((uint8_t)src[r * col + c] ^ 0x80);
+    }
+  }
+}
+
+void CalcVnniWeightBiasSums(const int8_t *weight, int row, int col, int input_zp, const int32_t *weight_zp_ptr,
+                            const int32_t *bias, int32_t *dst, DataOrder order, bool filter_per_channel) {
+  for (int c = 0; c < col; ++c) {
+    int sum = 0;
+    for (int r = 0; r < row; ++r) {
+      if (order == RowMajor) {
+        sum += weight[r * col + c];
+      } else {
+        sum += weight[c * row + r];
+      }
+    }
+    int weight_zp = filter_per_channel ? weight_zp_ptr[c] : weight_zp_ptr[0];
+    dst[c] = row * input_zp * weight_zp - (input_zp + C128NUM) * sum;
+    if (bias != NULL) {
+      dst[c] += bias[c];
+    }
+  }
+}
+
+// row_block <= 6, col_block <= 2, dst is row_block x 32 int32
+static void GemmRowxColVnniInt8(int32_t *dst, const int8_t *a, const int8_t *b, int row_block, int col_block,
+                                int deep4) {
+  __m512i dst_data[C12NUM];
+  __m512i weight_data[C2NUM];
+  for (int i = 0; i < row_block * col_block; ++i) {
+    dst_data[i] = _mm512_setzero_si512();
+  }
+  size_t b_block_stride = (size_t)deep4 * C16NUM;
+  for (int d = 0; d < deep4; d += C4NUM) {
+    for (int j = 0; j < col_block; ++j) {
+      weight_data[j] = _mm512_loadu_si512(b + j * b_block_stride + d * C16NUM);
+    }
+    for (int i = 0; i < row_block; ++i) {
+      int32_t src4;
+      memcpy(&src4, a + i * deep4 + d, sizeof(int32_t));
+      __m512i src_data = _mm512_set1_epi32(src4);
+      for (int j = 0; j < col_block; ++j) {
+        dst_data[i * col_block + j] = _mm512_dpbusd_epi32(dst_data[i * col_block + j], src_data, weight_data[j]);
+      }
+    }
+  }
+  for (int i = 0; i < row_block; ++i) {
+    for (int j = 0; j < col_block; ++j) {
+      _mm512_storeu_si512(dst + i * C32NUM + j * C16NUM, dst_data[i * col_block + j]);
+    }
+  }
+}
+
+void MatmulVnniInt8(const int8_t *a, const int8_t *b, int8_t *dst, int row, int col, int deep4, const int32_t *a_sums,
+                    const int32_t *bias, int mini, int maxi, int out_zp, const int32_t *multiplier,
+                    const int32_t *left_shift, const int32_t *right_shift, size_t stride, size_t filter_peroc,
+                    const int32_t *filter_zp) {
+  /*
+   * (uint8)row-major * col16x4-major => (int8)row-major
+   * a_sums is  perT  : input_row_sum * filter_zp
+   *            perOc : input_row_sum
+   * */
+  int32_t tmp[C6NUM * C32NUM];
+  for (int c = 0; c < col; c += C32NUM) {
+    int col_res = MSMIN(C32NUM, col - c);
+    int col_block = UP_DIV(col_res, C16NUM);
+    const int8_t *b_ptr = b + (size_t)c * deep4;
+    for (int r = 0; r < row; r += C6NUM) {
+      int row_block = MSMIN(C6NUM, row - r);
+      GemmRowxColVnniInt8(tmp, a + (size_t)r * deep4, b_ptr, row_block, col_block, deep4);
+      for (int i = 0; i < row_block; ++i) {
+        int8_t *dst_r = dst + (size_t)(r + i) * stride + c;
+        for (int j = 0; j < col_res; ++j) {
+          int oc = c + j;
+          int32_t value = tmp[i * C32NUM + j];
+          value -= filter_peroc ? a_sums[r + i] * filter_zp[oc] : a_sums[r + i];
+          value += bias[oc];
+          int32_t cur_left_shift = filter_peroc ? left_shift[oc] : left_shift[0];
+          int32_t cur_right_shift = filter_peroc ? right_shift[oc] : right_shift[0];
+          int32_t cur_multiplier = filter_peroc ? multiplier[oc] : multiplier[0];
+          value = MultiplyByQuantizedMultiplier(value, cur_multiplier, cur_left_shift, cur_right_shift) + out_zp;
+          value = MSMIN(maxi, value);
+          value = MSMAX(mini, value);
+          dst_r[j] = (int8_t)value;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,42 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef NNACL_INT8_MATMUL_VNNI_INT8_H_
+#define NNACL_INT8_MATMUL_VNNI_INT8_H_
+
+#include "nnacl/op_base.h"
+#include "nnacl/matmul_parameter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* vpdpbusd multiplies unsigned bytes of a by signed bytes of b, so a is packed with an offset of 128 and the
+ * offset is taken back through the weight sums.
+ * a: row-major, deep padded to 4, each element xor 0x80
+ * b: col16-block, deep4-block, 16 cols x 4 deep, the same layout as RowMajor2Col4x16MajorInt8 */
+void RowMajor2RowVnniInt8(const int8_t *src, int8_t *dst, int row, int col);
+void RowMajor2ColVnniInt8(const int8_t *src, int8_t *dst, int row, int col);
+// dst: bias + depth*input_zp*weight_zp - (input_zp+128)*weight_col_sums
+void CalcVnniWeightBiasSums(const int8_t *weight, int row, int col, int input_zp, const int32_t *weight_zp_ptr,
+                            const int32_t *bias, int32_t *dst, DataOrder order, bool filter_per_channel);
+void MatmulVnniInt8(const int8_t *a, const int8_t *b, int8_t *dst, int row, int col, int deep4, const int32_t *a_sums,
+                    const int32_t *bias, int mini, int maxi, int out_zp, const int32_t *multiplier,
+                    const int32_t *left_shift, const int32_t *right_shift, size_t stride, size_t filter_peroc,
+                    const int32_t *filter_zp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // NNACL_INT8_MATMUL_VNNI_INT8_H_
@@ -28,6 +28,7 @@ struct X86CpuInfoContext {
   bool sse4_1_flag_;
   bool avx2_flag_;
   bool avx512_flag_;
+  bool avx512_vnni_flag_;
 };
 
 static struct X86CpuInfoContext g_x86_cpu_info_context_;
@@ -58,6 +59,14 @@ inline const bool X86_Avx512_Support(void) {
 #endif
 }
 
+inline const bool X86_Avx512Vnni_Support(void) {
+#ifdef ENABLE_AVX512
+  return g_x86_cpu_info_context_.avx512_flag_ && g_x86_cpu_info_context_.avx512_vnni_flag_;
+#else
+  return false;
+#endif
+}
+
 void ExecuteCpuIdCmd(DWORD cmd_code, DWORD *eax_data, DWORD *ebx_data, DWORD *ecx_data, DWORD *edx_data) {
   DWORD deax, debx, decx, dedx;
   asm volatile(
@@ -109,6 +118,7 @@ int IntelX86CpuInfoInit(void) {
   ExecuteCpuIdCmd(7, &eax_data, &ebx_data, &ecx_data, &edx_data);  // eax = 7, execute cpuid to get avx2/avx512 flag
   g_x86_cpu_info_context_.avx2_flag_ = (ebx_data & (1 << 5)) == 0 ? false : true;     // avx2 flag is ecx 5 bit
   g_x86_cpu_info_context_.avx512_flag_ = (ebx_data & (1 << 16)) == 0 ? false : true;  // avx512 flag is ecx 16 bit
+  g_x86_cpu_info_context_.avx512_vnni_flag_ = (ecx_data & (1 << 11)) == 0 ? false : true;  // vnni flag is ecx 11 bit
 
   return NNACL_OK;
 }
@@ -16,9 +16,13 @@
 
 #include "pybind_api/ir/tensor_py.h"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
 #include <utility>
 
 #include "include/common/pybind_api/api_register.h"
+#include "pybind_api/ir/dlpack.h"
 #include "abstract/abstract_value.h"
 #include "utils/shape_utils.h"
 #include "utils/cache_embedding_hashmap_struct.h"
@@ -260,6 +264,157 @@ class PersistentTensorDataNumpy : public TensorDataNumpy {
   int slice_num_{1};
 };
 
+constexpr auto kDLPackCapsuleName = "dltensor";
+constexpr auto kDLPackUsedCapsuleName = "used_dltensor";
+constexpr uint8_t kBitsPerByte = 8;
+
+static const std::vector<std::pair<TypeId, DLDataType>> kDLPackDataTypes = {
+  {kNumberTypeBool, {kDLBool, 8, 1}},          {kNumberTypeInt8, {kDLInt, 8, 1}},
+  {kNumberTypeInt16, {kDLInt, 16, 1}},         {kNumberTypeInt32, {kDLInt, 32, 1}},
+  {kNumberTypeInt64, {kDLInt, 64, 1}},         {kNumberTypeUInt8, {kDLUInt, 8, 1}},
+  {kNumberTypeUInt16, {kDLUInt, 16, 1}},       {kNumberTypeUInt32, {kDLUInt, 32, 1}},
+  {kNumberTypeUInt64, {kDLUInt, 64, 1}},       {kNumberTypeFloat16, {kDLFloat, 16, 1}},
+  {kNumberTypeFloat32, {kDLFloat, 32, 1}},     {kNumberTypeFloat64, {kDLFloat, 64, 1}},
+  {kNumberTypeBFloat16, {kDLBfloat, 16, 1}},   {kNumberTypeComplex64, {kDLComplex, 64, 1}},
+  {kNumberTypeComplex128, {kDLComplex, 128, 1}}};
+
+static DLDataType GetDLDataType(TypeId data_type) {
+  auto iter = std::find_if(kDLPackDataTypes.begin(), kDLPackDataTypes.end(),
+                           [data_type](const auto &item) { return item.first == data_type; });
+  if (iter == kDLPackDataTypes.end()) {
+    MS_EXCEPTION(TypeError) << "For __dlpack__, the type of tensor " << TypeIdLabel(data_type) << " is not supported.";
+  }
+  return iter->second;
+}
+
+static TypeId GetDataType(const DLDataType &dtype) {
+  if (dtype.lanes != 1) {
+    MS_EXCEPTION(TypeError) << "For from_dlpack, vector data types with " << dtype.lanes << " lanes are not supported.";
+  }
+  auto iter = std::find_if(kDLPackDataTypes.begin(), kDLPackDataTypes.end(), [&dtype](const auto &item) {
+    return item.second.code == dtype.code && item.second.bits == dtype.bits;
+  });
+  if (iter == kDLPackDataTypes.end()) {
+    MS_EXCEPTION(TypeError) << "For from_dlpack, the data type with code " << static_cast<int>(dtype.code)
+                            << " and bits " << static_cast<int>(dtype.bits) << " is not supported.";
+  }
+  return iter->first;
+}
+
+// Whether the DLPack tensor is row-major without gaps, dimensions of size 1 may have any stride.
+static bool IsCompact(const DLTensor &dl_tensor) {
+  if (dl_tensor.strides == nullptr) {
+    return true;
+  }
+  int64_t expect_stride = 1;
+  for (int32_t i = dl_tensor.ndim - 1; i >= 0; --i) {
+    if (dl_tensor.shape[i] != 1 && dl_tensor.strides[i] != expect_stride) {
+      return false;
+    }
+    expect_stride *= dl_tensor.shape[i];
+  }
+  return true;
+}
+
+// Copy a strided DLPack tensor to a row-major buffer, the innermost dimension is copied as a run when it is dense.
+static void CopyStridedData(const DLTensor &dl_tensor, size_t item_size, uint8_t *dst) {
+  const auto ndim = IntToSize(dl_tensor.ndim);
+  const auto *src = static_cast<const uint8_t *>(dl_tensor.data) + dl_tensor.byte_offset;
+  const int64_t inner_size = dl_tensor.shape[ndim - 1];
+  const int64_t inner_stride = dl_tensor.strides[ndim - 1];
+  const int64_t outer_size =
+    std::accumulate(dl_tensor.shape, dl_tensor.shape + ndim - 1, int64_t(1), std::multiplies<int64_t>());
+  std::vector<int64_t> index(ndim, 0);
+  for (int64_t row = 0; row < outer_size; ++row) {
+    int64_t offset = 0;
+    for (size_t d = 0; d + 1 < ndim; ++d) {
+      offset += index[d] * dl_tensor.strides[d];
+    }
+    const uint8_t *row_src = src + offset * SizeToLong(item_size);
+    if (inner_stride == 1) {
+      (void)memcpy(dst, row_src, LongToSize(inner_size) * item_size);
+      dst += LongToSize(inner_size) * item_size;
+    } else {
+      for (int64_t i = 0; i < inner_size; ++i) {
+        (void)memcpy(dst, row_src + i * inner_stride * SizeToLong(item_size), item_size);
+        dst += item_size;
+      }
+    }
+    for (size_t d = ndim - 1; d > 0; --d) {
+      if (++index[d - 1] < dl_tensor.shape[d - 1]) {
+        break;
+      }
+      index[d - 1] = 0;
+    }
+  }
+}
+
+// TensorDataDLPack implements TensorData on the compact memory of a DLPack tensor of another framework, the memory
+// is released by the deleter of the producer when the data is destroyed.
+class TensorDataDLPack : public TensorData {
+ public:
+  TensorDataDLPack(DLManagedTensor *managed, ssize_t size, ssize_t itemsize)
+      : managed_(managed), size_(size), itemsize_(itemsize) {}
+
+  ~TensorDataDLPack() override {
+    if (managed_->deleter != nullptr) {
+      py::gil_scoped_acquire acquire;
+      managed_->deleter(managed_);
+    }
+  }
+
+  ssize_t size() const override { return size_; }
+
+  ssize_t itemsize() const override { return itemsize_; }
+
+  ssize_t nbytes() const override { return size_ * itemsize_; }
+
+  ssize_t ndim() const override { return managed_->dl_tensor.ndim; }
+
+  void *data() override { return static_cast<uint8_t *>(managed_->dl_tensor.data) + managed_->dl_tensor.byte_offset; }
+
+  const void *const_data() const override {
+    return static_cast<const uint8_t *>(managed_->dl_tensor.data) + managed_->dl_tensor.byte_offset;
+  }
+
+  bool is_sub_data() const override { return false; }
+
+  bool has_sub_data() const override { return false; }
+
+  std::string ToString(const TypeId type, const ShapeVector &shape, bool use_comma) const override {
+    Tensor tensor(type, shape, const_cast<void *>(const_data()), LongToSize(nbytes()));
+    return tensor.data().ToString(type, shape, use_comma);
+  }
+
+ private:
+  DLManagedTensor *managed_;
+  ssize_t size_;
+  ssize_t itemsize_;
+};
+
+// The owner of a tensor exported by __dlpack__, keeps the tensor data alive until the consumer calls the deleter.
+struct DLPackExportContext {
+  TensorDataPtr data;
+  std::vector<int64_t> shape;
+  std::vector<int64_t> strides;
+  DLManagedTensor managed;
+};
+
+static void DeleteDLPackExportContext(DLManagedTensor *self) {
+  delete static_cast<DLPackExportContext *>(self->manager_ctx);
+}
+
+// Destructor of the capsule, which releases the tensor only if no consumer took it over.
+static void DeleteDLPackCapsule(PyObject *capsule) {
+  if (!PyCapsule_IsValid(capsule, kDLPackCapsuleName)) {
+    return;
+  }
+  auto managed = static_cast<DLManagedTensor *>(PyCapsule_GetPointer(capsule, kDLPackCapsuleName));
+  if (managed != nullptr && managed->deleter != nullptr) {
+    managed->deleter(managed);
+  }
+}
+
 TensorPtr TensorPy::MakeTensor(const py::array &input, const TypePtr &type_ptr) {
   py::gil_scoped_acquire acquire;
   // Get input buffer info.
@@ -522,6 +677,91 @@ py::array TensorPy::AsNumpyOfSlice(const Tensor &tensor, const int32_t param_key
   return data_numpy->py_array(owner);
 }
 
+py::capsule TensorPy::ToDLPack(const Tensor &tensor) {
+  {
+    py::gil_scoped_release gil_release;
+    if (tensor.NeedWait()) {
+      tensor.Wait();
+    }
+    tensor.data_sync();
+  }
+  auto dtype = GetDLDataType(tensor.data_type());
+  auto context = std::make_unique<DLPackExportContext>();
+  context->data = tensor.data_ptr();
+  MS_EXCEPTION_IF_NULL(context->data);
+  context->shape.assign(tensor.shape().begin(), tensor.shape().end());
+  context->strides.resize(context->shape.size());
+  int64_t stride = 1;
+  for (size_t i = context->shape.size(); i > 0; --i) {
+    context->strides[i - 1] = stride;
+    stride *= context->shape[i - 1];
+  }
+  auto &dl_tensor = context->managed.dl_tensor;
+  dl_tensor.data = context->data->data();
+  dl_tensor.device = {kDLCPU, 0};
+  dl_tensor.ndim = SizeToInt(context->shape.size());
+  dl_tensor.dtype = dtype;
+  dl_tensor.shape = context->shape.data();
+  dl_tensor.strides = context->strides.data();
+  dl_tensor.byte_offset = 0;
+  context->managed.manager_ctx = context.get();
+  context->managed.deleter = DeleteDLPackExportContext;
+  auto capsule = PyCapsule_New(&context->managed, kDLPackCapsuleName, DeleteDLPackCapsule);
+  if (capsule == nullptr) {
+    throw py::error_already_set();
+  }
+  (void)context.release();
+  return py::reinterpret_steal<py::capsule>(capsule);
+}
+
+py::tuple TensorPy::GetDLPackDevice(const Tensor &) { return py::make_tuple(static_cast<int>(kDLCPU), 0); }
+
+TensorPtr TensorPy::MakeTensorOfDLPack(const py::object &input) {
+  py::gil_scoped_acquire acquire;
+  py::object capsule = input;
+  if (py::hasattr(input, "__dlpack__")) {
+    capsule = input.attr("__dlpack__")();
+  }
+  if (!PyCapsule_IsValid(capsule.ptr(), kDLPackCapsuleName)) {
+    MS_EXCEPTION(TypeError) << "For from_dlpack, the input should be an object with __dlpack__ or an unused DLPack "
+                            << "capsule, but got " << py::str(input.get_type());
+  }
+  auto managed = static_cast<DLManagedTensor *>(PyCapsule_GetPointer(capsule.ptr(), kDLPackCapsuleName));
+  MS_EXCEPTION_IF_NULL(managed);
+  // Take over the tensor from the capsule, from now on the tensor data owns it.
+  if (PyCapsule_SetName(capsule.ptr(), kDLPackUsedCapsuleName) != 0) {
+    throw py::error_already_set();
+  }
+  const auto &dl_tensor = managed->dl_tensor;
+  auto data_type = TypeId::kTypeUnknown;
+  try {
+    if (dl_tensor.device.device_type != kDLCPU && dl_tensor.device.device_type != kDLCUDAHost) {
+      MS_EXCEPTION(ValueError) << "For from_dlpack, only tensors on cpu are supported, but got device type "
+                               << static_cast<int>(dl_tensor.device.device_type);
+    }
+    data_type = GetDataType(dl_tensor.dtype);
+  } catch (...) {
+    if (managed->deleter != nullptr) {
+      managed->deleter(managed);
+    }
+    throw;
+  }
+  ShapeVector shape(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+  const auto item_size = static_cast<size_t>((dl_tensor.dtype.bits + kBitsPerByte - 1) / kBitsPerByte);
+  const auto size = SizeOf(shape);
+  if (IsCompact(dl_tensor) || size == 0) {
+    auto tensor_data = std::make_shared<TensorDataDLPack>(managed, SizeToLong(size), SizeToLong(item_size));
+    return std::make_shared<Tensor>(data_type, shape, tensor_data);
+  }
+  // Strided tensors are copied to a row-major tensor, the memory of the producer is released right away.
+  auto tensor = std::make_shared<Tensor>(data_type, shape);
+  CopyStridedData(dl_tensor, item_size, static_cast<uint8_t *>(tensor->data_c()));
+  if (managed->deleter != nullptr) {
+    managed->deleter(managed);
+  }
+  return tensor;
+}
+
 static ShapeVector GetShapeFromTuple(const py::tuple &tuple) {
   ShapeVector shape;
   const size_t size = tuple.size();
@@ -694,6 +934,30 @@ void RegMetaTensor(const py::module *m) {
                                  >>> a = np.ones((2, 3))
                                  >>> t = mindspore.Tensor.from_numpy(a)
                              )mydelimiter")
+    .def("from_dlpack", TensorPy::MakeTensorOfDLPack, R"mydelimiter(
+                             Creates a Tensor from a DLPack tensor of another framework without copy.
+
+                             Arg:
+                                 ext_tensor (object): An object with __dlpack__, or a DLPack capsule.
+
+                             Returns:
+                                 Tensor, tensor with shared data to the input if it is compact, otherwise a copy.
+
+                             Examples:
+                                 >>> a = np.ones((2, 3))
+                                 >>> t = mindspore.Tensor.from_dlpack(a)
+                             )mydelimiter")
+    .def("to_dlpack", TensorPy::ToDLPack, R"mydelimiter(
+                             Export the tensor as a DLPack capsule sharing the data of the tensor.
+
+                             Returns:
+                                 PyCapsule, named "dltensor".
+
+                             Examples:
+                                 >>> data = mindspore.Tensor(np.ones((2, 3)))
+                                 >>> capsule = data.to_dlpack()
+                             )mydelimiter")
+    .def("dlpack_device", TensorPy::GetDLPackDevice)
     .def("persistent_data_from_numpy", TensorPy::MakePersistentDataTensorOfNumpy, R"mydelimiter(
                              Creates a Tensor from a numpy.ndarray without copy.
                              Use persistent data tensor.
@@ -133,6 +133,21 @@ class TensorPy {
   static void FlushFromCache(const Tensor &tensor);
 
   static void Offload(const Tensor &tensor);
+
+  // brief Export the tensor as a DLPack capsule sharing its data, the data lives until the consumer releases it.
+  //
+  // return [py::capsule] The "dltensor" capsule.
+  static py::capsule ToDLPack(const Tensor &tensor);
+
+  // brief Get the DLPack device of the tensor.
+  //
+  // return [py::tuple] (device_type, device_id).
+  static py::tuple GetDLPackDevice(const Tensor &tensor);
+
+  // brief Create Tensor from a DLPack tensor of another framework, without copy if it is compact.
+  //
+  // param input [py::object] An object with __dlpack__, or a DLPack capsule.
+  static TensorPtr MakeTensorOfDLPack(const py::object &input);
 };
 
 // CSRTensor python wrapper and adapter class.
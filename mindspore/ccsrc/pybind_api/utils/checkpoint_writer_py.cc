@@ -0,0 +1,60 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include "include/common/utils/checkpoint_writer.h"
+#include "include/common/pybind_api/api_register.h"
+
+namespace mindspore {
+namespace {
+bool SaveCheckpoint(CheckpointWriter *writer, const std::string &path, const py::dict &tensors, bool incremental) {
+  NamedTensors named_tensors;
+  for (const auto &item : tensors) {
+    (void)named_tensors.emplace_back(py::cast<std::string>(item.first), py::cast<tensor::TensorPtr>(item.second));
+  }
+  py::gil_scoped_release release;
+  return writer->Save(path, named_tensors, incremental);
+}
+
+py::dict LoadCheckpoint(const std::string &path, bool mmap_load) {
+  NamedTensors named_tensors;
+  {
+    py::gil_scoped_release release;
+    if (!CheckpointWriter::Load(path, mmap_load, &named_tensors)) {
+      MS_LOG(EXCEPTION) << "Load checkpoint " << path << " failed.";
+    }
+  }
+  py::dict tensors;
+  for (const auto &[name, tensor] : named_tensors) {
+    tensors[py::str(name)] = tensor;
+  }
+  return tensors;
+}
+}  // namespace
+
+// Define python wrapper of the sharded asynchronous checkpoint writer.
+void RegCheckpointWriter(py::module *m) {
+  (void)py::class_<CheckpointWriter, std::shared_ptr<CheckpointWriter>>(*m, "CheckpointWriter")
+    .def(py::init<size_t>(), py::arg("shard_num") = kDefaultCheckpointShardNum)
+    .def("save", &SaveCheckpoint, py::arg("path"), py::arg("tensors"), py::arg("incremental") = false,
+         "Snapshot the tensors and write them to the checkpoint directory in the background.")
+    .def("wait", &CheckpointWriter::Wait, py::call_guard<py::gil_scoped_release>(),
+         "Wait for the running save, return whether it succeeded.")
+    .def_static("load", &LoadCheckpoint, py::arg("path"), py::arg("mmap_load") = false,
+                "Load the tensors of a checkpoint directory.");
+}
+}  // namespace mindspore
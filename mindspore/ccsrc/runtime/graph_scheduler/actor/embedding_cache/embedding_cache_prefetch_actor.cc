@@ -358,9 +358,10 @@ void EmbeddingCachePrefetchActor::CreateChannelLock(const std::string &channel_n
 void EmbeddingCachePrefetchActor::CreateBlockQueue(const std::string &channel_name) {
   auto unique_ids_queue = std::make_shared<BlockingQueue<UniqueIds>>(kDefaultQueueCapacity);
   auto cache_analysis_queue = std::make_shared<BlockingQueue<CacheAnalysis>>(kDefaultQueueCapacity);
+  auto host_cache_updated_queue = std::make_shared<BlockingQueue<CacheAnalysis>>(kDefaultQueueCapacity);
   auto ids_and_indices_queue = std::make_shared<BlockingQueue<IdsAndIndices>>(kDefaultQueueCapacity);
-  (void)channel_to_queues_.emplace(channel_name,
-                                   std::make_tuple(unique_ids_queue, cache_analysis_queue, ids_and_indices_queue));
+  (void)channel_to_queues_.emplace(channel_name, std::make_tuple(unique_ids_queue, cache_analysis_queue,
+                                                                 host_cache_updated_queue, ids_and_indices_queue));
 }
 
 void EmbeddingCachePrefetchActor::StartPrefetchCachePipeline(const std::string &channel_name) {
@@ -378,8 +379,9 @@ void EmbeddingCachePrefetchActor::StartPrefetchCachePipeline(const std::string &
 
   thread_list->at(kIndex0) = std::thread(&EmbeddingCachePrefetchActor::UniqueIdsTask, this, channel_name);
   thread_list->at(kIndex1) = std::thread(&EmbeddingCachePrefetchActor::AnalyseCacheTask, this, channel_name);
-  thread_list->at(kIndex2) = std::thread(&EmbeddingCachePrefetchActor::UpdateCacheTask, this, channel_name);
-  thread_list->at(kIndex3) = std::thread(&EmbeddingCachePrefetchActor::TransformIdsToIndicesTask, this, channel_name);
+  thread_list->at(kIndex2) = std::thread(&EmbeddingCachePrefetchActor::UpdateHostCacheTask, this, channel_name);
+  thread_list->at(kIndex3) = std::thread(&EmbeddingCachePrefetchActor::UpdateDeviceCacheTask, this, channel_name);
+  thread_list->at(kIndex4) = std::thread(&EmbeddingCachePrefetchActor::TransformIdsToIndicesTask, this, channel_name);
   MS_LOG(INFO) << "End StartPrefetchCachePipeline for channel name: " << channel_name;
 }
 
@@ -394,10 +396,14 @@ void EmbeddingCachePrefetchActor::StopPrefetchCachePipeline() {
     MS_EXCEPTION_IF_NULL(unique_ids_queue);
     unique_ids_queue->Close();
 
-    const auto &cache_analysis_queue = std::get<std::shared_ptr<BlockingQueue<CacheAnalysis>>>(queues_tuple);
+    const auto &cache_analysis_queue = std::get<kIndex1>(queues_tuple);
     MS_EXCEPTION_IF_NULL(cache_analysis_queue);
     cache_analysis_queue->Close();
 
+    const auto &host_cache_updated_queue = std::get<kIndex2>(queues_tuple);
+    MS_EXCEPTION_IF_NULL(host_cache_updated_queue);
+    host_cache_updated_queue->Close();
+
     const auto &ids_and_indices_queue = std::get<std::shared_ptr<BlockingQueue<IdsAndIndices>>>(queues_tuple);
     MS_EXCEPTION_IF_NULL(ids_and_indices_queue);
     ids_and_indices_queue->Close();
@@ -506,7 +512,7 @@ void EmbeddingCachePrefetchActor::AnalyseCacheTask(const std::string &channel_na
 
   const auto &unique_ids_queue = std::get<std::shared_ptr<BlockingQueue<UniqueIds>>>(queue_iter->second);
   MS_EXCEPTION_IF_NULL(unique_ids_queue);
-  const auto &cache_analysis_queue = std::get<std::shared_ptr<BlockingQueue<CacheAnalysis>>>(queue_iter->second);
+  const auto &cache_analysis_queue = std::get<kIndex1>(queue_iter->second);
   MS_EXCEPTION_IF_NULL(cache_analysis_queue);
 
   while (running_) {
@@ -554,20 +560,59 @@ void EmbeddingCachePrefetchActor::AnalyseCacheTask(const std::string &channel_na
   }
 }
 
-void EmbeddingCachePrefetchActor::UpdateCacheTask(const std::string &channel_name) {
+void EmbeddingCachePrefetchActor::UpdateHostCacheTask(const std::string &channel_name) {
   const auto &queue_iter = channel_to_queues_.find(channel_name);
   if (queue_iter == channel_to_queues_.end()) {
     MS_LOG(EXCEPTION) << "Can not find queue for channel: " << channel_name;
   }
 
-  const auto &cache_analysis_queue = std::get<std::shared_ptr<BlockingQueue<CacheAnalysis>>>(queue_iter->second);
+  const auto &cache_analysis_queue = std::get<kIndex1>(queue_iter->second);
   MS_EXCEPTION_IF_NULL(cache_analysis_queue);
+  const auto &host_cache_updated_queue = std::get<kIndex2>(queue_iter->second);
+  MS_EXCEPTION_IF_NULL(host_cache_updated_queue);
+
+  while (running_) {
+    CacheAnalysis *cache_analysis = cache_analysis_queue->Pop();
+    if (!running_) {
+      break;
+    }
+    MS_EXCEPTION_IF_NULL(cache_analysis);
+    if (cache_analysis->end_of_file_ || cache_analysis->end_of_epoch_) {
+      // Pass the epoch or file end flag to next stage.
+      host_cache_updated_queue->Push(cache_analysis);
+      continue;
+    }
+
+    // The host cache slots evicted to remote are read before they are overwritten by the ids from remote or device,
+    // and the slots of the ids used by the steps in device cache update stage are not evicted by the later steps.
+    for (const auto &item : embedding_cache_table_manager.hash_tables_) {
+      const auto &hash_info = item.second;
+      MS_EXCEPTION_IF_CHECK_FAIL(PushCacheFromLocalHostToRemote(hash_info, cache_analysis),
+                                 "Push cache from local host to remote failed.");
+      MS_EXCEPTION_IF_CHECK_FAIL(InitLocalCacheForNewIds(hash_info, cache_analysis),
+                                 "Initialize the local cache values using random generator.");
+    }
+    MS_EXCEPTION_IF_CHECK_FAIL(PullCacheFromRemoteToLocalHost(cache_analysis),
+                               "Pull cache from remote to local host failed.");
+
+    host_cache_updated_queue->Push(cache_analysis);
+  }
+}
+
+void EmbeddingCachePrefetchActor::UpdateDeviceCacheTask(const std::string &channel_name) {
+  const auto &queue_iter = channel_to_queues_.find(channel_name);
+  if (queue_iter == channel_to_queues_.end()) {
+    MS_LOG(EXCEPTION) << "Can not find queue for channel: " << channel_name;
+  }
+
+  const auto &host_cache_updated_queue = std::get<kIndex2>(queue_iter->second);
+  MS_EXCEPTION_IF_NULL(host_cache_updated_queue);
 
   const auto &ids_and_indices_queue = std::get<std::shared_ptr<BlockingQueue<IdsAndIndices>>>(queue_iter->second);
   MS_EXCEPTION_IF_NULL(ids_and_indices_queue);
 
   while (running_) {
-    CacheAnalysis *cache_analysis = cache_analysis_queue->Pop();
+    CacheAnalysis *cache_analysis = host_cache_updated_queue->Pop();
     if (!running_) {
       break;
     }
@@ -585,14 +630,8 @@ void EmbeddingCachePrefetchActor::UpdateCacheTask(const std::string &channel_nam
 
     for (const auto &item : embedding_cache_table_manager.hash_tables_) {
       const auto &hash_info = item.second;
-      MS_EXCEPTION_IF_CHECK_FAIL(PushCacheFromLocalHostToRemote(hash_info, cache_analysis),
-                                 "Push cache from local host to remote failed.");
       MS_EXCEPTION_IF_CHECK_FAIL(emb_ops_->PushCacheFromDeviceToLocalHost(hash_info, cache_analysis),
                                  "Push cache from device to local host failed.");
-      MS_EXCEPTION_IF_CHECK_FAIL(InitLocalCacheForNewIds(hash_info, cache_analysis),
-                                 "Initialize the local cache values using random generator.");
-      MS_EXCEPTION_IF_CHECK_FAIL(PullCacheFromRemoteToLocalHost(hash_info, cache_analysis),
-                                 "Pull cache from remote to local host failed.");
       MS_EXCEPTION_IF_CHECK_FAIL(emb_ops_->PullCacheFromLocalHostToDevice(hash_info, cache_analysis),
                                  "Pull cache from local host to device failed.");
     }
@@ -810,6 +849,55 @@ bool EmbeddingCachePrefetchActor::PullCacheFromRemoteToLocalHost(const HashTable
   return true;
 }
 
+bool EmbeddingCachePrefetchActor::PullCacheFromRemoteToLocalHost(const CacheAnalysis *cache_analysis) {
+  MS_ERROR_IF_NULL(cache_analysis);
+  auto statistics_info = cache_analysis->statistics_info_;
+  auto embedding_host_cache = cache_analysis->embedding_host_cache_;
+  MS_ERROR_IF_NULL(statistics_info);
+  MS_ERROR_IF_NULL(embedding_host_cache);
+
+  auto swap_indices_size = statistics_info->server_to_host_size_;
+  if (swap_indices_size == 0) {
+    return true;
+  }
+  // There is nothing to overlap for one embedding table.
+  if (embedding_cache_table_manager.hash_tables_.size() == 1) {
+    return PullCacheFromRemoteToLocalHost(embedding_cache_table_manager.hash_tables_.begin()->second, cache_analysis);
+  }
+
+  auto server_to_host_ids = embedding_host_cache->server_to_host_ids.get();
+  MS_ERROR_IF_NULL(server_to_host_ids);
+  auto server_to_host_index = embedding_host_cache->server_to_host_index.get();
+  MS_ERROR_IF_NULL(server_to_host_index);
+
+  // 1. Send the lookup requests of all embedding tables.
+  std::vector<const HashTableInfo *> hash_infos;
+  std::vector<std::vector<std::vector<int>>> slice_ids_lists;
+  for (const auto &item : embedding_cache_table_manager.hash_tables_) {
+    const auto &hash_info = item.second;
+    MS_ERROR_IF_NULL(hash_info.host_address);
+    (void)slice_ids_lists.emplace_back(server_num_);
+    RETURN_IF_FALSE_WITH_LOG(SendLookupToRemote(hash_info.param_key_, server_to_host_ids, swap_indices_size,
+                                                hash_info.embedding_size, &slice_ids_lists.back()),
+                             "Send lookup ids to remote failed.");
+    hash_infos.push_back(&hash_info);
+  }
+
+  // 2. Wait the embeddings of each embedding table and insert them into local host cache.
+  for (size_t i = 0; i < hash_infos.size(); ++i) {
+    const auto &hash_info = *hash_infos[i];
+    auto embedding_size = hash_info.embedding_size;
+    std::vector<float> lookup_result(swap_indices_size * embedding_size, 0);
+    RETURN_IF_FALSE_WITH_LOG(ReceiveLookupFromRemote(hash_info.param_key_, server_to_host_ids, swap_indices_size,
+                                                     embedding_size, slice_ids_lists[i], &lookup_result),
+                             "Pull embedding from remote failed.");
+    RETURN_IF_FALSE_WITH_LOG(InsertLocalHostCache(embedding_size, IntToSize(swap_indices_size), server_to_host_index,
+                                                  lookup_result.data(), hash_info.host_address),
+                             "Insert local host cache failed.");
+  }
+  return true;
+}
+
 bool EmbeddingCachePrefetchActor::InitLocalCacheForNewIds(const HashTableInfo &hash_info,
                                                           const CacheAnalysis *cache_analysis) {
   MS_ERROR_IF_NULL(cache_analysis);
@@ -948,12 +1036,25 @@ bool EmbeddingCachePrefetchActor::PullEembeddingsFromRemote(int32_t param_key, c
   }
 
   std::vector<std::vector<int>> slice_ids_list(server_num_);
+  size_t embedding_dim = outputs->size() / ids_num;
+  RETURN_IF_FALSE_WITH_LOG(SendLookupToRemote(param_key, ids, ids_num, embedding_dim, &slice_ids_list),
+                           "Send lookup ids to remote failed.");
+  RETURN_IF_FALSE_WITH_LOG(ReceiveLookupFromRemote(param_key, ids, ids_num, embedding_dim, slice_ids_list, outputs),
+                           "Receive lookup embeddings from remote failed.");
+  return true;
+}
+
+bool EmbeddingCachePrefetchActor::SendLookupToRemote(int32_t param_key, const int *ids, size_t ids_num,
+                                                     size_t embedding_dim,
+                                                     std::vector<std::vector<int>> *slice_ids_list) {
+  MS_ERROR_IF_NULL(ids);
+  MS_ERROR_IF_NULL(slice_ids_list);
+
   // 1. Partition ids by remote embedding slice bound and get unique ids.
-  RETURN_IF_FALSE_WITH_LOG(PartitionIds(ids, ids_num, &slice_ids_list), "Partition ids failed.");
+  RETURN_IF_FALSE_WITH_LOG(PartitionIds(ids, ids_num, slice_ids_list), "Partition ids failed.");
 
-  size_t embedding_dim = outputs->size() / ids_num;
   for (size_t i = 0; i < server_num_; i++) {
-    auto &slice_ids = slice_ids_list[i];
+    auto &slice_ids = slice_ids_list->at(i);
     if (slice_ids.empty()) {
       continue;
     }
@@ -963,6 +1064,15 @@ bool EmbeddingCachePrefetchActor::PullEembeddingsFromRemote(int32_t param_key, c
                                           slice_ids.data(), slice_ids.size() * sizeof(int), nullptr, 0, false, false),
                              "Send ids to server failed.");
   }
+  return true;
+}
+
+bool EmbeddingCachePrefetchActor::ReceiveLookupFromRemote(int32_t param_key, const int *ids, size_t ids_num,
+                                                          size_t embedding_dim,
+                                                          const std::vector<std::vector<int>> &slice_ids_list,
+                                                          std::vector<float> *outputs) {
+  MS_ERROR_IF_NULL(ids);
+  MS_ERROR_IF_NULL(outputs);
 
   std::vector<std::unique_ptr<std::vector<char>>> slice_embeddings_list(server_num_);
   for (size_t i = 0; i < server_num_; i++) {
@@ -70,9 +70,11 @@ using distributed::BlockingQueue;
 using distributed::CacheAnalysis;
 using distributed::IdsAndIndices;
 using distributed::UniqueIds;
+// The queues between the pipeline stages: unique ids queue, cache analysis queue, host cache updated queue and ids and
+// indices queue.
 using BlockingQueueTuple =
   std::tuple<std::shared_ptr<BlockingQueue<UniqueIds>>, std::shared_ptr<BlockingQueue<CacheAnalysis>>,
-             std::shared_ptr<BlockingQueue<IdsAndIndices>>>;
+             std::shared_ptr<BlockingQueue<CacheAnalysis>>, std::shared_ptr<BlockingQueue<IdsAndIndices>>>;
 
 using distributed::cluster::ActorRouteTableProxy;
 using distributed::cluster::ActorRouteTableProxyPtr;
@@ -84,11 +86,12 @@ using Generator = random::Philox;
 using NormalDistribution = random::NormalDistribution<double>;
 using ConstantDistribution = random::ConstantDistribution<DataType>;
 
-constexpr size_t kPipelineStageNum = 4;
+constexpr size_t kPipelineStageNum = 5;
 constexpr size_t kIndex0 = 0;
 constexpr size_t kIndex1 = 1;
 constexpr size_t kIndex2 = 2;
 constexpr size_t kIndex3 = 3;
+constexpr size_t kIndex4 = 4;
 
 // The EmbeddingCachePrefetchActor is used to cache large embedding table scenarios. The cache level is: Device
 // Cache->Local Host Cache->Remote Cache. This Actor is used to perform Local and Device Cache hit analysis and cache
@@ -147,6 +150,9 @@ class EmbeddingCachePrefetchActor : public ActorBase {
 
   // Pull missing embeddings on local cache from remote.
   bool PullCacheFromRemoteToLocalHost(const HashTableInfo &hash_info, const CacheAnalysis *cache_analysis);
+  // Pull missing embeddings of all embedding tables on local cache from remote, the lookup requests of all tables are
+  // sent before waiting for any response, so that the remote lookups of different tables overlap.
+  bool PullCacheFromRemoteToLocalHost(const CacheAnalysis *cache_analysis);
 
   // Initialize local cache values using the random number generator.
   bool InitLocalCacheForNewIds(const HashTableInfo &hash_info);
@@ -154,6 +160,12 @@ class EmbeddingCachePrefetchActor : public ActorBase {
 
   // Lookup embedding from Remote and get embeddings via RPC.
   bool PullEembeddingsFromRemote(int32_t param_key, const int *ids, size_t ids_num, std::vector<float> *outputs);
+  // The two halves of PullEembeddingsFromRemote: send the ids partitioned by remote embedding slice bound to remote
+  // asynchronously, and wait the embeddings of these ids.
+  bool SendLookupToRemote(int32_t param_key, const int *ids, size_t ids_num, size_t embedding_dim,
+                          std::vector<std::vector<int>> *slice_ids_list);
+  bool ReceiveLookupFromRemote(int32_t param_key, const int *ids, size_t ids_num, size_t embedding_dim,
+                               const std::vector<std::vector<int>> &slice_ids_list, std::vector<float> *outputs);
   // Push the local embedding cache that requires evict to the remote.
   bool PushEmbeddingsToRemote(int32_t param_key, const int *ids, size_t ids_num, const float *embeddings,
                               size_t embeddings_len);
@@ -225,15 +237,20 @@ class EmbeddingCachePrefetchActor : public ActorBase {
   void CreateBlockQueue(const std::string &channel_name);
 
   // Perform Local and Device Cache hit/miss analysis and prefetch cache for missing embeddings by multi-stage pipeline.
-  // Data flow: unique id queue -> cache analysis queue->id and indices queue
+  // Data flow: unique id queue -> cache analysis queue -> host cache updated queue -> id and indices queue
+  // The ids of 'multi_batch_threshold_' steps are deduplicated and analysed together, the host cache update which
+  // involves rpc with remote and the device cache update run in different stages, so the remote pulls for the later
+  // steps overlap with the device cache update and the computation of the earlier steps. The cache elements used by
+  // a step are not evicted until the computed graph runs over the step, so they are pinned until used.
   void StartPrefetchCachePipeline(const std::string &channel_name);
   void StopPrefetchCachePipeline();
   void WaitPrefetchCacheFinish();
 
-  // The four stage pipeline task.
+  // The five stage pipeline task.
   void UniqueIdsTask(const std::string &channel_name);
   void AnalyseCacheTask(const std::string &channel_name);
-  void UpdateCacheTask(const std::string &channel_name);
+  void UpdateHostCacheTask(const std::string &channel_name);
+  void UpdateDeviceCacheTask(const std::string &channel_name);
   void TransformIdsToIndicesTask(const std::string &channel_name);
 
   // Set current error information before finalizing actor.
@@ -0,0 +1,346 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "include/common/utils/checkpoint_writer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <nlohmann/json.hpp>
+#include "include/common/thread_pool.h"
+#include "load_mindir/mmap_tensor_data.h"
+#include "utils/file_utils.h"
+#include "utils/log_adapter.h"
+#include "utils/ms_utils.h"
+#include "utils/system/sha256.h"
+
+namespace mindspore {
+namespace {
+constexpr int kCheckpointVersion = 1;
+// The shard header holds the byte order flag at byte 0, the tensors start aligned after it.
+constexpr size_t kCheckpointHeaderSize = 64;
+constexpr size_t kCheckpointAlign = 64;
+
+size_t AlignCheckpointOffset(size_t offset) {
+  return (offset + kCheckpointAlign - 1) / kCheckpointAlign * kCheckpointAlign;
+}
+
+// The shard files of a save are named by its save id, so a later save to the same directory never overwrites the shards
+// an incremental checkpoint refers to.
+std::string ShardFileName(const std::string &save_id, size_t shard_id) {
+  return "shard_" + save_id + "_" + std::to_string(shard_id) + ".ckpt";
+}
+
+std::string NewSaveId() {
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  return std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+// Run the tasks on the shared thread pool, return whether all of them succeeded.
+bool RunTasks(size_t task_num, const std::function<bool(size_t)> &task) {
+  std::atomic<bool> success{true};
+  std::vector<common::Task> tasks;
+  tasks.reserve(task_num);
+  for (size_t i = 0; i < task_num; ++i) {
+    (void)tasks.emplace_back([&task, &success, i]() {
+      if (!task(i)) {
+        success = false;
+        return common::FAIL;
+      }
+      return common::SUCCESS;
+    });
+  }
+  (void)common::ThreadPool::GetInstance().SyncRun(tasks);
+  return success;
+}
+
+bool ReadManifest(const std::string &path, nlohmann::json *manifest) {
+  auto manifest_file = path + "/" + kCheckpointManifestName;
+  std::ifstream ifs(manifest_file);
+  if (!ifs.is_open()) {
+    MS_LOG(ERROR) << "Open checkpoint manifest " << manifest_file << " failed.";
+    return false;
+  }
+  try {
+    ifs >> *manifest;
+    if (manifest->at("version").get<int>() != kCheckpointVersion) {
+      MS_LOG(ERROR) << "Unsupported checkpoint version " << manifest->at("version") << " of " << manifest_file;
+      return false;
+    }
+    if (manifest->at("little_endian").get<bool>() != common::IsLittleByteOrder()) {
+      MS_LOG(ERROR) << "The byte order of the checkpoint " << path << " is not the same as the loading device.";
+      return false;
+    }
+  } catch (const std::exception &e) {
+    MS_LOG(ERROR) << "Parse checkpoint manifest " << manifest_file << " failed: " << e.what();
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+CheckpointWriter::~CheckpointWriter() {
+  try {
+    if (running_save_.valid() && !Wait()) {
+      MS_LOG(ERROR) << "The last checkpoint save failed.";
+    }
+  } catch (const std::exception &e) {
+    MS_LOG(ERROR) << "Wait for the last checkpoint save failed: " << e.what();
+  }
+}
+
+bool CheckpointWriter::Wait() {
+  if (!running_save_.valid()) {
+    return true;
+  }
+  return running_save_.get();
+}
+
+bool CheckpointWriter::Save(const std::string &path, const NamedTensors &tensors, bool incremental) {
+  if (running_save_.valid() && !Wait()) {
+    MS_LOG(WARNING) << "The previous checkpoint save failed, save all tensors of this checkpoint.";
+    incremental = false;
+  }
+  auto real_path = FileUtils::CreateNotExistDirs(path, true);
+  if (!real_path.has_value()) {
+    MS_LOG(ERROR) << "Create checkpoint directory " << path << " failed.";
+    return false;
+  }
+  auto dir = real_path.value();
+
+  // 1. Digest the tensors to find the ones changed since the last save, a full save has nothing to compare.
+  TensorRecords records(tensors.size());
+  std::vector<const uint8_t *> sources(tensors.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const auto &tensor = tensors[i].second;
+    MS_EXCEPTION_IF_NULL(tensor);
+    tensor->data_sync();
+    records[i].first = tensors[i].first;
+    records[i].second.data_type = tensor->data_type();
+    records[i].second.shape = tensor->shape();
+    records[i].second.nbytes = LongToSize(tensor->data().nbytes());
+    sources[i] = static_cast<const uint8_t *>(tensor->data_c());
+  }
+  if (incremental) {
+    (void)RunTasks(tensors.size(), [&records, &sources](size_t i) {
+      auto &record = records[i].second;
+      record.digest = system::sha256::GetHashFromBuffer(sources[i], record.nbytes);
+      return true;
+    });
+  }
+  std::vector<size_t> changed;
+  for (size_t i = 0; i < records.size(); ++i) {
+    auto &record = records[i].second;
+    auto iter = last_records_.find(records[i].first);
+    if (!incremental || iter == last_records_.end() || iter->second.nbytes != record.nbytes ||
+        iter->second.digest != record.digest || iter->second.data_type != record.data_type ||
+        iter->second.shape != record.shape) {
+      changed.push_back(i);
+      continue;
+    }
+    record.file = iter->second.file;
+    record.offset = iter->second.offset;
+  }
+
+  // 2. Assign the changed tensors to the shards, each to the least loaded shard from the largest one.
+  size_t shard_count = std::min(std::max<size_t>(shard_num_, 1), changed.size());
+  std::sort(changed.begin(), changed.end(), [&records](size_t lhs, size_t rhs) {
+    return records[lhs].second.nbytes > records[rhs].second.nbytes;
+  });
+  std::vector<size_t> shard_sizes(shard_count, kCheckpointHeaderSize);
+  std::vector<std::vector<size_t>> shard_tensors(shard_count);
+  auto save_id = NewSaveId();
+  for (auto i : changed) {
+    auto shard_id = static_cast<size_t>(std::min_element(shard_sizes.begin(), shard_sizes.end()) - shard_sizes.begin());
+    auto &record = records[i].second;
+    record.offset = AlignCheckpointOffset(shard_sizes[shard_id]);
+    record.file = dir + "/" + ShardFileName(save_id, shard_id);
+    shard_sizes[shard_id] = record.offset + record.nbytes;
+    shard_tensors[shard_id].push_back(i);
+  }
+
+  // 3. Snapshot the changed tensors into the shard buffers, the tensors can be updated once this returns.
+  if (shard_buffers_.size() < shard_count) {
+    shard_buffers_.resize(shard_count);
+  }
+  (void)RunTasks(shard_count, [this, &shard_sizes, &shard_tensors, &records, &sources](size_t shard_id) {
+    auto &buffer = shard_buffers_[shard_id];
+    buffer.resize(shard_sizes[shard_id]);
+    (void)std::fill_n(buffer.begin(), kCheckpointHeaderSize, 0);
+    buffer[0] = static_cast<uint8_t>(common::IsLittleByteOrder());
+    for (auto i : shard_tensors[shard_id]) {
+      const auto &record = records[i].second;
+      if (record.nbytes > 0) {
+        (void)memcpy(buffer.data() + record.offset, sources[i], record.nbytes);
+      }
+    }
+    return true;
+  });
+  MS_LOG(INFO) << "Snapshot " << changed.size() << " of " << records.size() << " tensors into " << shard_count
+               << " shards of checkpoint " << dir;
+
+  // 4. Write the shards and the manifest in the background.
+  running_save_ = std::async(std::launch::async, [this, dir, save_id, records = std::move(records), shard_count]() {
+    return WriteCheckpoint(dir, save_id, records, shard_count);
+  });
+  return true;
+}
+
+bool CheckpointWriter::WriteCheckpoint(const std::string &path, const std::string &save_id,
+                                       const TensorRecords &records, size_t shard_count) {
+  // The shared thread pool holds its lock until all of its tasks finish, the writes run on their own threads so they do
+  // not block the other users of the pool.
+  std::vector<std::future<bool>> writes;
+  writes.reserve(shard_count);
+  for (size_t shard_id = 0; shard_id < shard_count; ++shard_id) {
+    (void)writes.emplace_back(std::async(std::launch::async, [this, &path, &save_id, shard_id]() {
+      auto file = path + "/" + ShardFileName(save_id, shard_id);
+      std::ofstream ofs(file, std::ios::out | std::ios::binary | std::ios::trunc);
+      const auto &buffer = shard_buffers_[shard_id];
+      (void)ofs.write(reinterpret_cast<const char *>(buffer.data()), SizeToLong(buffer.size()));
+      ofs.close();
+      if (!ofs.good()) {
+        MS_LOG(ERROR) << "Write checkpoint shard " << file << " failed.";
+        return false;
+      }
+      return true;
+    }));
+  }
+  bool success = true;
+  for (auto &write : writes) {
+    success = write.get() && success;
+  }
+  if (!success) {
+    return false;
+  }
+
+  nlohmann::json manifest;
+  manifest["version"] = kCheckpointVersion;
+  manifest["little_endian"] = common::IsLittleByteOrder();
+  auto tensors = nlohmann::json::array();
+  for (const auto &[name, record] : records) {
+    // The shards of this checkpoint are relative to it, so the directory can be moved.
+    auto file = record.file;
+    if (file.compare(0, path.size() + 1, path + "/") == 0) {
+      file = file.substr(path.size() + 1);
+    }
+    nlohmann::json item = {{"name", name},
+                           {"dtype", TypeIdToString(record.data_type)},
+                           {"shape", record.shape},
+                           {"nbytes", record.nbytes},
+                           {"file", file},
+                           {"offset", record.offset}};
+    if (!record.digest.empty()) {
+      item["sha256"] = record.digest;
+    }
+    tensors.push_back(std::move(item));
+  }
+  manifest["tensors"] = std::move(tensors);
+  // Write the manifest last, a checkpoint without it is incomplete.
+  auto manifest_file = path + "/" + kCheckpointManifestName;
+  auto tmp_file = manifest_file + ".tmp";
+  std::ofstream ofs(tmp_file, std::ios::out | std::ios::trunc);
+  ofs << manifest.dump();
+  ofs.close();
+  if (!ofs.good() || std::rename(tmp_file.c_str(), manifest_file.c_str()) != 0) {
+    MS_LOG(ERROR) << "Write checkpoint manifest " << manifest_file << " failed.";
+    return false;
+  }
+  last_records_.clear();
+  for (const auto &[name, record] : records) {
+    last_records_[name] = record;
+  }
+  MS_LOG(INFO) << "Save checkpoint " << path << " success.";
+  return true;
+}
+
+bool CheckpointWriter::Load(const std::string &path, bool mmap_load, NamedTensors *tensors) {
+  MS_EXCEPTION_IF_NULL(tensors);
+  auto real_path = FileUtils::GetRealPath(path.c_str());
+  if (!real_path.has_value()) {
+    MS_LOG(ERROR) << "Get real path of checkpoint " << path << " failed.";
+    return false;
+  }
+  auto dir = real_path.value();
+  nlohmann::json manifest;
+  if (!ReadManifest(dir, &manifest)) {
+    return false;
+  }
+
+  // Group the tensors by their files.
+  std::map<std::string, std::vector<size_t>> file_tensors;
+  std::vector<size_t> offsets;
+  std::vector<size_t> nbytes;
+  tensors->clear();
+  try {
+    for (const auto &item : manifest.at("tensors")) {
+      auto data_type = StringToTypeId(item.at("dtype").get<std::string>());
+      auto shape = item.at("shape").get<ShapeVector>();
+      auto file = item.at("file").get<std::string>();
+      if (file.empty() || file[0] != '/') {
+        file = dir + "/" + file;
+      }
+      file_tensors[file].push_back(tensors->size());
+      offsets.push_back(item.at("offset").get<size_t>());
+      nbytes.push_back(item.at("nbytes").get<size_t>());
+      (void)tensors->emplace_back(item.at("name").get<std::string>(),
+                                  mmap_load ? nullptr : std::make_shared<tensor::Tensor>(data_type, shape));
+      if (!mmap_load && LongToSize(tensors->back().second->data().nbytes()) != nbytes.back()) {
+        MS_LOG(ERROR) << "The size of tensor " << tensors->back().first << " does not match its shape.";
+        return false;
+      }
+    }
+    if (mmap_load) {
+      for (const auto &[file, indexes] : file_tensors) {
+        auto mapped_file = MappedFile::Open(file, common::IsLittleByteOrder());
+        if (mapped_file == nullptr) {
+          MS_LOG(ERROR) << "Map checkpoint shard " << file << " failed.";
+          return false;
+        }
+        for (auto i : indexes) {
+          const auto &item = manifest.at("tensors").at(i);
+          auto data_type = StringToTypeId(item.at("dtype").get<std::string>());
+          auto shape = item.at("shape").get<ShapeVector>();
+          auto data = std::make_shared<tensor::MmapTensorData>(mapped_file, offsets[i], data_type, shape);
+          (*tensors)[i].second = std::make_shared<tensor::Tensor>(data_type, shape, data);
+        }
+      }
+      return true;
+    }
+  } catch (const std::exception &e) {
+    MS_LOG(ERROR) << "Parse checkpoint manifest of " << dir << " failed: " << e.what();
+    return false;
+  }
+
+  // Read the files concurrently.
+  std::vector<std::pair<std::string, std::vector<size_t>>> files(file_tensors.begin(), file_tensors.end());
+  return RunTasks(files.size(), [&files, &offsets, &nbytes, tensors](size_t file_id) {
+    const auto &file = files[file_id].first;
+    std::ifstream ifs(file, std::ios::in | std::ios::binary);
+    for (auto i : files[file_id].second) {
+      (void)ifs.seekg(SizeToLong(offsets[i]), std::ios::beg);
+      (void)ifs.read(static_cast<char *>((*tensors)[i].second->data_c()), SizeToLong(nbytes[i]));
+      if (!ifs.good()) {
+        MS_LOG(ERROR) << "Read tensor " << (*tensors)[i].first << " from checkpoint shard " << file << " failed.";
+        return false;
+      }
+    }
+    return true;
+  });
+}
+}  // namespace mindspore
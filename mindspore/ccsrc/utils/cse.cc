@@ -87,18 +87,33 @@ BasePtr AbsOf(const AnfNodePtr &node, bool ignore_fg_abs_tracking_id) {
   return node_abs;
 }
 
+// The hash of a CNode input. The hashes of the CNodes are cached on the nodes and kept by the later runs until the
+// manager resets them, so the abstracts of the value nodes are left out as they may change without notifying it.
+// The hashes only pick the candidates that CheckReplace compares, so a hash left stale by an edit made outside the
+// manager can only miss a merge.
+std::size_t InputHash(const AnfNodePtr &node) {
+  if (node->isa<CNode>()) {
+    return node->cast_ptr<CNode>()->structural_hash();
+  }
+  if (node->isa<ValueNode>()) {
+    if (IsPrimitive(node, prim::kPrimUpdateState)) {
+      return 0;
+    }
+    auto value = node->cast_ptr<ValueNode>()->value();
+    MS_EXCEPTION_IF_NULL(value);
+    return value->hash();
+  }
+  return node->hash();
+}
+
 bool CSE::BuildOrderGroupForOneGraph(const FuncGraphPtr &fg) {
   MS_EXCEPTION_IF_NULL(fg);
   std::vector<std::size_t> order_group;
   mindspore::HashMap<std::size_t, std::vector<AnfNodePtr>> groups;
-  mindspore::HashMap<AnfNodePtr, std::size_t> hashes;
 
   std::vector<AnfNodePtr> toposet = TopoSort(fg->get_return());
   for (const auto &node : toposet) {
     MS_EXCEPTION_IF_NULL(node);
-    if (hashes.find(node) != hashes.end()) {
-      continue;
-    }
     if (IsHiddenSideEffectNode(node) && node->func_graph() != nullptr) {
       MS_LOG(DEBUG) << "Add hidden func graph:" << node->func_graph()->ToString();
       (void)hidden_side_effect_func_graphs_.insert(node->func_graph());
@@ -114,19 +129,22 @@ bool CSE::BuildOrderGroupForOneGraph(const FuncGraphPtr &fg) {
       MS_EXCEPTION_IF_NULL(value);
       h = hash_combine(value->hash(), (AbsOf(value_node, true)->hash()));
     } else if (node->isa<CNode>()) {
-      auto cnode = node->cast<CNodePtr>();
-      auto &inputs = cnode->inputs();
-      size_t init = 0;
-      h = std::accumulate(inputs.begin(), inputs.end(), init, [&hashes](std::size_t hash, const AnfNodePtr &node_in) {
-        return hash_combine(hash, hashes[node_in]);
-      });
+      auto cnode = node->cast_ptr<CNode>();
+      h = cnode->structural_hash();
+      if (h == 0) {
+        auto &inputs = cnode->inputs();
+        size_t init = 0;
+        h = std::accumulate(inputs.begin(), inputs.end(), init, [](std::size_t hash, const AnfNodePtr &node_in) {
+          return hash_combine(hash, InputHash(node_in));
+        });
+        cnode->set_structural_hash(h);
+      }
     } else if (node->isa<Parameter>()) {
       h = node->hash();
     } else {
       MS_LOG(ERROR) << "Unknown node type";
     }
 
-    hashes[node] = h;
     if (groups.find(h) == groups.end()) {
       std::vector<AnfNodePtr> innervec({node});
       groups[h] = innervec;
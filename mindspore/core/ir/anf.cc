@@ -163,6 +163,7 @@ bool CNode::IsApply(const PrimitivePtr &value) const {
 void CNode::add_input(const AnfNodePtr &input) {
   (void)inputs_.emplace_back(input);
   input_tensor_num_ = -1;
+  structural_hash_ = 0;
 }
 
 void CNode::set_input(size_t i, const AnfNodePtr &new_input) {
@@ -171,11 +172,13 @@ void CNode::set_input(size_t i, const AnfNodePtr &new_input) {
   }
   inputs_[i] = new_input;
   input_tensor_num_ = -1;
+  structural_hash_ = 0;
 }
 
 void CNode::set_inputs(const std::vector<AnfNodePtr> &inputs) {
   inputs_ = inputs;
   input_tensor_num_ = -1;
+  structural_hash_ = 0;
 }
 
 const AnfNodePtr &CNode::input(size_t i) const {
@@ -368,6 +368,17 @@ class MS_CORE_API CNode final : public AnfNode, public EffectInfoHolder {
   /// \param[in] inputs Input nodes.
   void set_inputs(const std::vector<AnfNodePtr> &inputs);
 
+  /// \brief Get the structural hash of this CNode cached by common subexpression elimination.
+  ///
+  /// \return The cached hash, 0 if it is not computed or the inputs have changed since.
+  std::size_t structural_hash() const { return structural_hash_; }
+
+  /// \brief Cache the structural hash of this CNode, it is reset when the inputs are set, and the manager resets the
+  /// hashes of the users when the inputs of a managed CNode change.
+  ///
+  /// \param[in] structural_hash The structural hash.
+  void set_structural_hash(std::size_t structural_hash) { structural_hash_ = structural_hash; }
+
   // output_value store cnode value and id in pynative mode.
   using OutputValue = std::pair<ValueNodePtr, std::string>;
 
@@ -584,6 +595,7 @@ class MS_CORE_API CNode final : public AnfNode, public EffectInfoHolder {
 
   // If the inputs or their inputs contain Depend CNode with isolated side-effect node.
   bool has_side_effect_node_{false};
+  std::size_t structural_hash_{0};
 };
 
 // ANode represents the atomic node. It's derived Parameter and ValueNode.
@@ -717,6 +717,7 @@ void FuncGraphManager::MoveAllCNodeDropGraph(const FuncGraphPtr &source, const F
 }
 
 void FuncGraphManager::OnEdgeAdded(const AnfNodePtr &node, int index, const AnfNodePtr &input) {
+  InvalidateStructuralHash(node);
   auto fg = node->func_graph();
   if (input->isa<ValueNode>()) {
     fg->AddValueNode(input);
@@ -768,6 +769,31 @@ void FuncGraphManager::OnEdgeRemoved(const AnfNodePtr &node, int index, const An
   }
 }
 
+// The structural hash of a CNode is computed from the hashes of its inputs, so the cached hashes of all the users
+// reached from a changed node are reset. The walk stops at the users whose hash is not cached, their users have not
+// been hashed since either.
+void FuncGraphManager::InvalidateStructuralHash(const AnfNodePtr &node) {
+  std::vector<AnfNodePtr> todo{node};
+  while (!todo.empty()) {
+    auto cur = std::move(todo.back());
+    todo.pop_back();
+    auto cnode = dyn_cast_ptr<CNode>(cur);
+    if (cnode == nullptr || (cnode->structural_hash() == 0 && cur != node)) {
+      continue;
+    }
+    cnode->set_structural_hash(0);
+    auto iter = node_users_.find(cur);
+    if (iter == node_users_.end()) {
+      continue;
+    }
+    for (const auto &user : iter->second) {
+      if (user.first != node) {
+        (void)todo.emplace_back(user.first);
+      }
+    }
+  }
+}
+
 void FuncGraphManager::MoveAllNodes(const FuncGraphPtr &source, const FuncGraphPtr &target) {
   target->CopyNodes(source);
   target->CopyValueNodes(source);
@@ -378,6 +378,7 @@ class MS_CORE_API FuncGraphManager : public std::enable_shared_from_this<FuncGra
   FuncGraphSet MaybeDropNodes(std::vector<AnfNodePtr> &&nodes);
   void OnEdgeAdded(const AnfNodePtr &node, int index, const AnfNodePtr &input);
   void OnEdgeRemoved(const AnfNodePtr &node, int index, const AnfNodePtr &input);
+  void InvalidateStructuralHash(const AnfNodePtr &node);
   void MoveAllNodes(const FuncGraphPtr &source, const FuncGraphPtr &target);
 
   FuncGraphSet roots_;                   // Managed roots.
@@ -34,6 +34,7 @@
 #include "mindspore/ccsrc/include/common/utils/convert_utils.h"
 #include "utils/ms_utils_secure.h"
 #include "utils/shape_utils.h"
+#include "utils/float_convert.h"
 #include "utils/ordered_set.h"
 #include "utils/system/env.h"
 #include "utils/temp_file_manager.h"
@@ -96,10 +97,9 @@ std::unique_ptr<T[]> NewData(const U *input, size_t size) {
                  std::is_same<T, ComplexStorage<float>>::value || std::is_same<U, ComplexStorage<float>>::value ||
                  std::is_same<T, ComplexStorage<double>>::value || std::is_same<U, ComplexStorage<double>>::value)) {
     // Because float16 and bfloat16 do not support implicit cast from/to other types,
-    // We can not use std::copy() on array of float16 and bfloat16, use a loop here.
-    for (size_t i = 0; i < size; ++i) {
-      data[i] = static_cast<T>(input[i]);
-    }
+    // We can not use std::copy() on array of float16 and bfloat16, convert them in parallel chunks,
+    // vectorized between float32 and float16/bfloat16.
+    ConvertData(input, data.get(), size);
   } else {
     // otherwise, use std::copy for better performance.
     std::copy(input, input + size, data.get());
@@ -38,13 +38,17 @@
 #include "ir/functor.h"
 #include "ops/primitive_c.h"
 #include "abstract/abstract_value.h"
+#include "abstract/utils.h"
 #include "abstract/ops/primitive_infer_map.h"
 #include "utils/hash_map.h"
 #include "utils/log_adapter.h"
+#include "utils/ms_utils.h"
 #include "utils/check_convert_utils.h"
 #include "utils/ms_utils_secure.h"
 #include "abstract/abstract_function.h"
 #include "load_mindir/infer_mindir.h"
+#include "load_mindir/mmap_tensor_data.h"
+#include "load_mindir/model_proto_parser.h"
 #include "include/common/debug/common.h"
 #include "proto/mind_ir.pb.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
@@ -340,6 +344,7 @@ class MSANFModelParser {
   void SetMindIRDecKey(const unsigned char *dec_key) { mindir_dec_key_ = dec_key; }
   void SetMindIRKeySize(size_t size) { mindir_key_size_ = size; }
   void SetMindIRDecMode(const std::string &dec_mode) { mindir_dec_mode_ = dec_mode; }
+  void SetMmapLoad(bool mmap_load) { mmap_load_ = mmap_load; }
 
  private:
   void TrytoBuildCNodeAbstract();
@@ -363,6 +368,8 @@ class MSANFModelParser {
   abstract::AbstractScalarPtr BuildAbstractScalar(const mind_ir::AttributeProto &attr_proto) const;
   bool SetValueForTopGraphParameter(const FuncGraphPtr &topGraph, const std::map<std::string, ValuePtr> &weights);
   bool GetTensorDataFromExternal(const mind_ir::TensorProto &tensor_proto, const tensor::TensorPtr &tensor_info);
+  tensor::TensorPtr GetMappedTensorFromExternal(const mind_ir::TensorProto &tensor_proto, TypeId data_type,
+                                                const ShapeVector &shape);
   bool BuildInputForFuncGraph(const ParameterPtr &node, const mind_ir::ValueInfoProto &value_proto);
   abstract::AbstractTensorPtr GetAbsTensorFromTensorProto(const mind_ir::TensorProto &tensor_proto);
   CNodePtr BuildCNodeForFuncGraph(const FuncGraphPtr &outputFuncGraph, const mind_ir::NodeProto &node_proto);
@@ -414,6 +421,8 @@ class MSANFModelParser {
   std::string mindir_dec_mode_;
   bool little_endian_ = common::IsLittleByteOrder();
   std::map<std::string, std::unique_ptr<Byte[]>> tenor_data_;
+  bool mmap_load_{false};
+  std::map<std::string, MappedFilePtr> mapped_files_;
   bool is_kernel_graph_{false};
   std::list<std::pair<const CNodePtr, const mind_ir::AttributeProto *>> node_abstract_protos_;
 };
@@ -515,7 +524,12 @@ tensor::TensorPtr MSANFModelParser::GenerateTensorPtrFromTensorProto(const mind_
   tensor::TensorPtr tensor = nullptr;
   if (!attr_tensor.has_compression_type() ||
       attr_tensor.compression_type() == mind_ir::TensorProto_CompressionType_NO_COMPRESSION) {
-    tensor = std::make_shared<tensor::Tensor>(kDefaultValueSwitchMap[attr_tensor_type], shape);
+    if (mmap_load_ && !attr_tensor.has_raw_data() && attr_tensor.has_external_data()) {
+      tensor = GetMappedTensorFromExternal(attr_tensor, kDefaultValueSwitchMap[attr_tensor_type], shape);
+    }
+    if (tensor == nullptr) {
+      tensor = std::make_shared<tensor::Tensor>(kDefaultValueSwitchMap[attr_tensor_type], shape);
+    }
   } else {
     auto compression_type = static_cast<TensorCompressionType>(static_cast<int>(attr_tensor.compression_type()));
     size_t data_size = 0;
@@ -543,6 +557,9 @@ tensor::TensorPtr MSANFModelParser::GenerateTensorPtrFromTensorProto(const mind_
       return nullptr;
     }
   } else if (attr_tensor.has_external_data()) {
+    if (std::dynamic_pointer_cast<tensor::MmapTensorData>(tensor->data_ptr()) != nullptr) {
+      return tensor;
+    }
     auto ret = GetTensorDataFromExternal(attr_tensor, tensor);
     if (!ret) {
       MS_LOG(ERROR) << "Failed to get external data from tensor proto.";
@@ -991,6 +1008,39 @@ bool MSANFModelParser::GetTensorDataFromExternal(const mind_ir::TensorProto &ten
   return true;
 }
 
+tensor::TensorPtr MSANFModelParser::GetMappedTensorFromExternal(const mind_ir::TensorProto &tensor_proto,
+                                                               TypeId data_type, const ShapeVector &shape) {
+  // Encrypted files are decrypted into memory, they can not be mapped.
+  if (mindir_dec_key_ != nullptr) {
+    return nullptr;
+  }
+  const auto &external_data = tensor_proto.external_data();
+  size_t nbytes = abstract::TypeIdSize(data_type);
+  for (auto dim : shape) {
+    if (dim < 0) {
+      return nullptr;
+    }
+    nbytes *= LongToSize(dim);
+  }
+  if (nbytes == 0 || LongToSize(external_data.length()) != nbytes) {
+    return nullptr;
+  }
+  MappedFilePtr file = nullptr;
+  auto it = mapped_files_.find(external_data.location());
+  if (it != mapped_files_.end()) {
+    file = it->second;
+  } else {
+    file = MappedFile::Open(mindir_path_ + "/" + external_data.location(), little_endian());
+    // Keep the failure too, the tensors of the file are read into memory then.
+    (void)mapped_files_.emplace(external_data.location(), file);
+  }
+  if (file == nullptr) {
+    return nullptr;
+  }
+  auto data = std::make_shared<tensor::MmapTensorData>(file, LongToSize(external_data.offset()), data_type, shape);
+  return std::make_shared<tensor::Tensor>(data_type, shape, data);
+}
+
 bool MSANFModelParser::BuildInputForFuncGraph(const ParameterPtr &node, const mind_ir::ValueInfoProto &value_proto) {
   MS_EXCEPTION_IF_NULL(node);
 
@@ -2518,13 +2568,12 @@ bool ParseModelProto(mind_ir::ModelProto *model, const std::string &path, const
         << "Decrypt MindIR file failed, please check the correctness of the dec_key or dec_mode or the file integrity.";
       return false;
     }
-    if (!model->ParseFromArray(reinterpret_cast<char *>(plain_data.get()), static_cast<int32_t>(plain_len))) {
+    if (!ParseModelProtoParallel(plain_data.get(), plain_len, model)) {
       MS_LOG(ERROR) << "Load MindIR file failed, please check the correctness of the file, dec_key or dec_mode.";
       return false;
     }
   } else {
-    std::fstream input_graph(path, std::ios::in | std::ios::binary);
-    if (!input_graph || !model->ParseFromIstream(&input_graph)) {
+    if (!ParseModelProtoFile(path, model)) {
       MS_LOG(ERROR) << "Load MindIR file failed, please check the correctness of the file.";
       return false;
     }
@@ -2560,6 +2609,7 @@ void InitModelParser(MSANFModelParser *model_parser, const MindIRLoader *loader)
   model_parser->SetMindIRDecKey(loader->dec_key());
   model_parser->SetMindIRKeySize(loader->key_len());
   model_parser->SetMindIRDecMode(loader->dec_mode());
+  model_parser->SetMmapLoad(loader->mmap_load() || common::GetEnv(kMindIRMmapLoadEnv) == "1");
 
   if (loader->is_lite()) {
     model_parser->SetLite();
@@ -2637,7 +2687,7 @@ FuncGraphPtr MindIRLoader::LoadMindIR(const void *buffer, const size_t &size) {
   /* mindir -> func_graph
    * only support lite */
   mind_ir::ModelProto model;
-  auto ret = model.ParseFromArray(buffer, SizeToInt(size));
+  auto ret = ParseModelProtoParallel(buffer, size, &model);
   if (!ret) {
     MS_LOG(ERROR) << "ParseFromArray failed.";
     return nullptr;
@@ -2734,7 +2784,7 @@ FuncGraphPtr MindIRLoader::LoadMindIR(const std::string &file_name,
 bool MindIRLoader::LoadMindIR(const void *buffer, const size_t &size, const std::string &mindir_path,
                               FuncGraphPtr *func_graph, std::string *user_info_string) {
   mind_ir::ModelProto model;
-  auto ret = model.ParseFromArray(buffer, SizeToInt(size));
+  auto ret = ParseModelProtoParallel(buffer, size, &model);
   if (!ret) {
     MS_LOG(ERROR) << "ParseFromArray failed.";
     return false;
@@ -2764,7 +2814,7 @@ bool MindIRLoader::LoadMindIR(const void *buffer, const size_t &size, const std:
 
 FuncGraphPtr MindIRLoader::LoadMindIR(const void *buffer, const size_t &size, const std::string &mindir_path) {
   mind_ir::ModelProto model;
-  auto ret = model.ParseFromArray(buffer, SizeToInt(size));
+  auto ret = ParseModelProtoParallel(buffer, size, &model);
   if (!ret) {
     MS_LOG(ERROR) << "ParseFromArray failed.";
     return nullptr;
@@ -53,6 +53,8 @@ class Layout {
 };
 using LayoutPtr = std::shared_ptr<Layout>;
 using LayoutMap = std::map<string, LayoutPtr>;
+// Set to 1 to map the external data files of MindIR instead of reading them into memory.
+constexpr char kMindIRMmapLoadEnv[] = "MS_MINDIR_MMAP_LOAD";
 class MS_CORE_API MindIRLoader {
  public:
   MindIRLoader() = default;
@@ -66,6 +68,10 @@ class MS_CORE_API MindIRLoader {
     weights_value_map_ = weights_value_map;
   }
   const LayoutMap &layout_map() const { return layout_map_; }
+  // Parameters loaded from external data files borrow the pages of the mapped files, the pages are read on first
+  // access, shared between processes and copied on write.
+  void set_mmap_load(bool mmap_load) { mmap_load_ = mmap_load; }
+  bool mmap_load() const { return mmap_load_; }
   FuncGraphPtr LoadMindIR(const void *buffer, const size_t &size);
   FuncGraphPtr LoadMindIR(const void *buffer, const size_t &size, const std::string &mindir_path);
   FuncGraphPtr LoadMindIR(const std::string &file_name,
@@ -90,6 +96,7 @@ class MS_CORE_API MindIRLoader {
   bool inc_load_ = false;
   std::map<string, ValuePtr> weights_value_map_;
   bool has_parallel_info_ = false;
+  bool mmap_load_ = false;
   LayoutMap layout_map_;
 };
 MS_CORE_API FuncGraphPtr ConvertStreamToFuncGraph(const char *buf, const size_t buf_size, bool is_lite = false);
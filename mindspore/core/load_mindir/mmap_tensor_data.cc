@@ -0,0 +1,109 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "load_mindir/mmap_tensor_data.h"
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "abstract/utils.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+MappedFile::~MappedFile() {
+#if !defined(_WIN32) && !defined(_WIN64)
+  if (addr_ != nullptr) {
+    (void)munmap(addr_, size_);
+    addr_ = nullptr;
+  }
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string &file, bool little_endian) {
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(MS_COMPILE_IOS)
+  auto fd = open(file.c_str(), O_RDONLY);
+  if (fd == -1) {
+    MS_LOG(ERROR) << "Open file '" << file << "' failed, please check the correct of the file.";
+    return nullptr;
+  }
+  struct stat fd_stat;
+  if (fstat(fd, &fd_stat) != 0 || fd_stat.st_size <= 0) {
+    MS_LOG(ERROR) << "Get the size of file '" << file << "' failed.";
+    (void)close(fd);
+    return nullptr;
+  }
+  // The first byte of the external data file records the byte order of the exporting device.
+  constexpr char is_little_endian = 1;
+  char byte_order = 0;
+  auto read_size = pread(fd, &byte_order, sizeof(byte_order), 0);
+  (void)close(fd);
+  if (read_size != static_cast<ssize_t>(sizeof(byte_order))) {
+    MS_LOG(ERROR) << "Read file '" << file << "' failed.";
+    return nullptr;
+  }
+  if ((byte_order == is_little_endian) ^ little_endian) {
+    MS_LOG(ERROR) << "The byte order of export MindIr device and load MindIr device is not same!";
+    return nullptr;
+  }
+  return std::shared_ptr<MappedFile>(new MappedFile(file, static_cast<size_t>(fd_stat.st_size)));
+#else
+  MS_LOG(WARNING) << "Mmap is unsupported on this platform, file '" << file << "' will be read into memory.";
+  return nullptr;
+#endif
+}
+
+uint8_t *MappedFile::data() {
+  std::call_once(map_flag_, [this]() {
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(MS_COMPILE_IOS)
+    auto fd = open(path_.c_str(), O_RDONLY);
+    if (fd == -1) {
+      MS_LOG(EXCEPTION) << "Open file '" << path_ << "' failed, please check the correct of the file.";
+    }
+    // Writable private mapping, a tensor updating its data gets its own copy of the pages written.
+    auto addr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    (void)close(fd);
+    if (addr == MAP_FAILED) {
+      MS_LOG(EXCEPTION) << "Mmap file '" << path_ << "' failed, errno: " << errno;
+    }
+    addr_ = addr;
+    MS_LOG(INFO) << "Mmap MindIR external data file '" << path_ << "', size: " << size_;
+#endif
+  });
+  return static_cast<uint8_t *>(addr_);
+}
+
+namespace tensor {
+MmapTensorData::MmapTensorData(const MappedFilePtr &file, size_t offset, TypeId data_type, const ShapeVector &shape)
+    : file_(file), offset_(offset), item_size_(abstract::TypeIdSize(data_type)), ndim_(shape.size()) {
+  MS_EXCEPTION_IF_NULL(file_);
+  data_size_ = 1;
+  for (auto dim : shape) {
+    data_size_ *= LongToSize(dim);
+  }
+  if (offset_ + data_size_ * item_size_ > file_->size()) {
+    MS_LOG(EXCEPTION) << "The tensor data [" << offset_ << ", " << (offset_ + data_size_ * item_size_)
+                      << ") is out of the range of file '" << file_->path() << "', file size: " << file_->size();
+  }
+}
+
+std::string MmapTensorData::ToString(TypeId type, const ShapeVector &shape, bool use_comma) const {
+  // Printing is rare, stringify a temporary copy rather than duplicating the stringifier of each data type.
+  Tensor copy(type, shape, const_cast<void *>(const_data()), LongToSize(nbytes()));
+  return copy.data().ToString(type, shape, use_comma);
+}
+}  // namespace tensor
+}  // namespace mindspore
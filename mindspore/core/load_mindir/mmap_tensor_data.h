@@ -0,0 +1,78 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CORE_LOAD_MINDIR_MMAP_TENSOR_DATA_H
+#define MINDSPORE_CORE_LOAD_MINDIR_MMAP_TENSOR_DATA_H
+#include <memory>
+#include <mutex>
+#include <string>
+#include "ir/tensor.h"
+
+namespace mindspore {
+// A MindIR external data file mapped into memory. The file is mapped privately on the first access of its data, so
+// the pages are read from disk on demand, are shared with other processes mapping the same file through the page
+// cache, and are copied only when they are written.
+class MS_CORE_API MappedFile {
+ public:
+  ~MappedFile();
+
+  // Open the file and check its byte order, the file is not mapped yet. Return nullptr if it is unsupported.
+  static std::shared_ptr<MappedFile> Open(const std::string &file, bool little_endian);
+
+  const std::string &path() const { return path_; }
+  size_t size() const { return size_; }
+  // Base address of the mapping, map the file if it is the first access.
+  uint8_t *data();
+
+ private:
+  MappedFile(const std::string &path, size_t size) : path_(path), size_(size) {}
+
+  std::string path_;
+  size_t size_{0};
+  void *addr_{nullptr};
+  std::once_flag map_flag_;
+};
+using MappedFilePtr = std::shared_ptr<MappedFile>;
+
+namespace tensor {
+// Tensor data borrowing a segment of a mapped external data file instead of owning a copy of it.
+class MS_CORE_API MmapTensorData : public TensorData {
+ public:
+  MmapTensorData(const MappedFilePtr &file, size_t offset, TypeId data_type, const ShapeVector &shape);
+  ~MmapTensorData() override = default;
+
+  ssize_t size() const override { return static_cast<ssize_t>(data_size_); }
+  ssize_t itemsize() const override { return static_cast<ssize_t>(item_size_); }
+  ssize_t nbytes() const override { return size() * itemsize(); }
+  ssize_t ndim() const override { return static_cast<ssize_t>(ndim_); }
+  bool is_sub_data() const override { return false; }
+  bool has_sub_data() const override { return false; }
+
+  void *data() override { return file_->data() + offset_; }
+  const void *const_data() const override { return file_->data() + offset_; }
+
+  std::string ToString(TypeId type, const ShapeVector &shape, bool use_comma) const override;
+
+ private:
+  MappedFilePtr file_;
+  size_t offset_{0};
+  size_t item_size_{0};
+  size_t data_size_{0};
+  size_t ndim_{0};
+};
+}  // namespace tensor
+}  // namespace mindspore
+#endif  // MINDSPORE_CORE_LOAD_MINDIR_MMAP_TENSOR_DATA_H
@@ -0,0 +1,338 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "load_mindir/model_proto_parser.h"
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(MS_COMPILE_IOS)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/convert_utils_base.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace {
+// Field numbers of mind_ir.proto split by the parser.
+constexpr uint32_t kModelGraphField = 7;
+constexpr uint32_t kModelFunctionsField = 8;
+constexpr uint32_t kGraphNodeField = 1;
+constexpr uint32_t kGraphParameterField = 3;
+// Wire types of the protobuf encoding.
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeFixed64 = 1;
+constexpr uint32_t kWireTypeLengthDelimited = 2;
+constexpr uint32_t kWireTypeFixed32 = 5;
+constexpr uint32_t kWireTypeBits = 3;
+constexpr uint64_t kWireTypeMask = 7;
+constexpr size_t kFixed64Size = 8;
+constexpr size_t kFixed32Size = 4;
+constexpr size_t kMaxVarintBytes = 10;
+constexpr size_t kVarintPayloadBits = 7;
+constexpr uint8_t kVarintPayloadMask = 0x7f;
+constexpr uint8_t kVarintContinueMask = 0x80;
+// Models smaller than this are parsed on the calling thread.
+constexpr size_t kMinParallelParseSize = 1 << 20;
+// Number of nodes or parameters parsed by one task.
+constexpr size_t kParseBatchSize = 256;
+
+// One field of a serialized message, begin is the tag and [value, end) the payload of a length delimited field.
+struct WireField {
+  uint32_t number;
+  const uint8_t *begin;
+  const uint8_t *value;
+  const uint8_t *end;
+};
+
+struct WirePiece {
+  const uint8_t *data;
+  size_t size;
+};
+
+// A graph split into its nodes, its parameters and the remaining fields.
+struct GraphPieces {
+  std::unique_ptr<mind_ir::GraphProto> graph = std::make_unique<mind_ir::GraphProto>();
+  std::string rest;
+  std::vector<WirePiece> nodes;
+  std::vector<WirePiece> parameters;
+  std::vector<std::unique_ptr<mind_ir::NodeProto>> parsed_nodes;
+  std::vector<std::unique_ptr<mind_ir::TensorProto>> parsed_parameters;
+};
+
+bool ReadVarint(const uint8_t **pos, const uint8_t *end, uint64_t *value) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < kMaxVarintBytes && *pos < end; ++i) {
+    auto byte = *((*pos)++);
+    result |= static_cast<uint64_t>(byte & kVarintPayloadMask) << (kVarintPayloadBits * i);
+    if ((byte & kVarintContinueMask) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Split a serialized message into its top level fields, groups are not used by mind_ir.proto and are rejected.
+bool ScanFields(const uint8_t *begin, const uint8_t *end, const std::function<bool(const WireField &)> &visit) {
+  auto pos = begin;
+  while (pos < end) {
+    WireField field{0, pos, nullptr, nullptr};
+    uint64_t tag = 0;
+    if (!ReadVarint(&pos, end, &tag)) {
+      return false;
+    }
+    field.number = static_cast<uint32_t>(tag >> kWireTypeBits);
+    uint64_t value = 0;
+    auto remain_size = static_cast<uint64_t>(end - pos);
+    switch (static_cast<uint32_t>(tag & kWireTypeMask)) {
+      case kWireTypeVarint:
+        if (!ReadVarint(&pos, end, &value)) {
+          return false;
+        }
+        break;
+      case kWireTypeFixed64:
+        if (remain_size < kFixed64Size) {
+          return false;
+        }
+        pos += kFixed64Size;
+        break;
+      case kWireTypeFixed32:
+        if (remain_size < kFixed32Size) {
+          return false;
+        }
+        pos += kFixed32Size;
+        break;
+      case kWireTypeLengthDelimited:
+        if (!ReadVarint(&pos, end, &value) || value > static_cast<uint64_t>(end - pos)) {
+          return false;
+        }
+        field.value = pos;
+        pos += value;
+        break;
+      default:
+        return false;
+    }
+    field.end = pos;
+    if (!visit(field)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool ParsePiece(const WirePiece &piece, T *message) {
+  if (piece.size > static_cast<size_t>(INT_MAX)) {
+    MS_LOG(ERROR) << "The message size " << piece.size << " exceeds the limit of protobuf.";
+    return false;
+  }
+  return message->ParseFromArray(piece.data, static_cast<int>(piece.size));
+}
+
+bool SplitGraph(const WireField &field, GraphPieces *pieces) {
+  return ScanFields(field.value, field.end, [pieces](const WireField &graph_field) {
+    auto value_size = static_cast<size_t>(graph_field.end - graph_field.value);
+    if (graph_field.number == kGraphNodeField && graph_field.value != nullptr) {
+      pieces->nodes.push_back({graph_field.value, value_size});
+    } else if (graph_field.number == kGraphParameterField && graph_field.value != nullptr) {
+      pieces->parameters.push_back({graph_field.value, value_size});
+    } else {
+      (void)pieces->rest.append(reinterpret_cast<const char *>(graph_field.begin),
+                                static_cast<size_t>(graph_field.end - graph_field.begin));
+    }
+    return true;
+  });
+}
+
+// The messages are created by the tasks and added to the repeated field afterwards, which is not thread safe.
+template <typename T>
+void AddParseTasks(const std::vector<WirePiece> &pieces, std::vector<std::unique_ptr<T>> *messages,
+                   std::vector<std::function<bool()>> *tasks) {
+  messages->resize(pieces.size());
+  for (size_t start = 0; start < pieces.size(); start += kParseBatchSize) {
+    auto stop = std::min(start + kParseBatchSize, pieces.size());
+    (void)tasks->emplace_back([&pieces, messages, start, stop]() {
+      for (size_t i = start; i < stop; ++i) {
+        (*messages)[i] = std::make_unique<T>();
+        if (!ParsePiece(pieces[i], (*messages)[i].get())) {
+          return false;
+        }
+      }
+      return true;
+    });
+  }
+}
+
+template <typename T>
+void AddParsedMessages(std::vector<std::unique_ptr<T>> *messages, google::protobuf::RepeatedPtrField<T> *field) {
+  field->Reserve(SizeToInt(messages->size()));
+  for (auto &message : *messages) {
+    field->AddAllocated(message.release());
+  }
+  messages->clear();
+}
+
+bool RunParallel(const std::vector<std::function<bool()>> &tasks, size_t thread_num) {
+  std::atomic<size_t> next_task{0};
+  std::atomic<bool> success{true};
+  auto worker = [&tasks, &next_task, &success]() {
+    for (size_t i = next_task++; i < tasks.size() && success; i = next_task++) {
+      if (!tasks[i]()) {
+        success = false;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < std::min(thread_num, tasks.size()); ++i) {
+    (void)threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return success;
+}
+}  // namespace
+
+bool ParseModelProtoParallel(const void *data, size_t size, mind_ir::ModelProto *model, size_t thread_num) {
+  if (data == nullptr || model == nullptr) {
+    MS_LOG(ERROR) << "The model data or the model proto is nullptr.";
+    return false;
+  }
+  if (thread_num == 0) {
+    thread_num = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  auto begin = static_cast<const uint8_t *>(data);
+  if (thread_num == 1 || size < kMinParallelParseSize) {
+    return ParsePiece({begin, size}, model);
+  }
+
+  // 1. Split the model into the graphs and each graph into its nodes and parameters.
+  std::string model_rest;
+  std::vector<GraphPieces> graphs;
+  size_t main_graph_index = SIZE_MAX;
+  auto split_success = ScanFields(begin, begin + size, [&](const WireField &field) {
+    // A repeated main graph field has to be merged, leave it to protobuf.
+    bool is_graph = field.number == kModelGraphField && main_graph_index == SIZE_MAX;
+    if (field.value != nullptr && (is_graph || field.number == kModelFunctionsField)) {
+      if (is_graph) {
+        main_graph_index = graphs.size();
+      }
+      (void)graphs.emplace_back();
+      return SplitGraph(field, &graphs.back());
+    }
+    if (field.number == kModelGraphField) {
+      return false;
+    }
+    (void)model_rest.append(reinterpret_cast<const char *>(field.begin), static_cast<size_t>(field.end - field.begin));
+    return true;
+  });
+  if (!split_success) {
+    MS_LOG(WARNING) << "Split the model failed, parse it on one thread.";
+    return ParsePiece({begin, size}, model);
+  }
+
+  // 2. Parse the fields other than the nodes and parameters.
+  std::vector<std::function<bool()>> tasks;
+  (void)tasks.emplace_back([&model_rest, model]() {
+    return ParsePiece({reinterpret_cast<const uint8_t *>(model_rest.data()), model_rest.size()}, model);
+  });
+  for (auto &pieces : graphs) {
+    (void)tasks.emplace_back([&pieces]() {
+      return ParsePiece({reinterpret_cast<const uint8_t *>(pieces.rest.data()), pieces.rest.size()},
+                        pieces.graph.get());
+    });
+  }
+  if (!RunParallel(tasks, thread_num)) {
+    MS_LOG(ERROR) << "Parse the model failed.";
+    return false;
+  }
+
+  // 3. Parse the nodes and parameters of all graphs.
+  tasks.clear();
+  for (auto &pieces : graphs) {
+    AddParseTasks(pieces.nodes, &pieces.parsed_nodes, &tasks);
+    AddParseTasks(pieces.parameters, &pieces.parsed_parameters, &tasks);
+  }
+  if (!RunParallel(tasks, thread_num)) {
+    MS_LOG(ERROR) << "Parse the nodes or parameters of the model failed.";
+    return false;
+  }
+
+  // 4. Assemble the graphs in their original order.
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    AddParsedMessages(&graphs[i].parsed_nodes, graphs[i].graph->mutable_node());
+    AddParsedMessages(&graphs[i].parsed_parameters, graphs[i].graph->mutable_parameter());
+    if (i == main_graph_index) {
+      model->set_allocated_graph(graphs[i].graph.release());
+    } else {
+      model->mutable_functions()->AddAllocated(graphs[i].graph.release());
+    }
+  }
+  MS_LOG(INFO) << "Parse the model of size " << size << " with " << std::min(thread_num, tasks.size())
+               << " threads, graph number: " << graphs.size();
+  return true;
+}
+
+bool ParseModelProtoFile(const std::string &path, mind_ir::ModelProto *model, size_t thread_num) {
+  if (model == nullptr) {
+    MS_LOG(ERROR) << "The model proto is nullptr.";
+    return false;
+  }
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(MS_COMPILE_IOS)
+  auto fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    MS_LOG(ERROR) << "Open file '" << path << "' failed, errno: " << errno;
+    return false;
+  }
+  struct stat fd_stat;
+  if (fstat(fd, &fd_stat) != 0) {
+    MS_LOG(ERROR) << "Get the size of file '" << path << "' failed, errno: " << errno;
+    (void)close(fd);
+    return false;
+  }
+  auto size = static_cast<size_t>(fd_stat.st_size);
+  if (size == 0) {
+    (void)close(fd);
+    return model->ParseFromArray(nullptr, 0);
+  }
+  // The parsed messages copy what they keep, so the mapping is dropped once the model is parsed.
+  auto addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  (void)close(fd);
+  if (addr != MAP_FAILED) {
+    (void)madvise(addr, size, MADV_WILLNEED);
+    auto ret = ParseModelProtoParallel(addr, size, model, thread_num);
+    (void)munmap(addr, size);
+    return ret;
+  }
+  MS_LOG(WARNING) << "Mmap file '" << path << "' failed, errno: " << errno << ", parse it as a stream.";
+#endif
+  std::ifstream input(path, std::ios::in | std::ios::binary);
+  if (!input) {
+    MS_LOG(ERROR) << "Open file '" << path << "' failed.";
+    return false;
+  }
+  return model->ParseFromIstream(&input);
+}
+}  // namespace mindspore
@@ -0,0 +1,35 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CORE_LOAD_MINDIR_MODEL_PROTO_PARSER_H
+#define MINDSPORE_CORE_LOAD_MINDIR_MODEL_PROTO_PARSER_H
+#include <cstddef>
+#include <string>
+#include "mindapi/base/macros.h"
+#include "proto/mind_ir.pb.h"
+
+namespace mindspore {
+// Parse a serialized ModelProto with several threads. The model is split on the wire format into the graphs and the
+// nodes and parameters of each graph, the pieces are parsed concurrently and then assembled in their original order.
+// thread_num 0 means the number of hardware threads.
+MS_CORE_API bool ParseModelProtoParallel(const void *data, size_t size, mind_ir::ModelProto *model,
+                                         size_t thread_num = 0);
+
+// Parse a MindIR file with ParseModelProtoParallel. The file is mapped read only for the parsing instead of being read
+// into a buffer, and it is parsed as a stream where mmap is unavailable.
+MS_CORE_API bool ParseModelProtoFile(const std::string &path, mind_ir::ModelProto *model, size_t thread_num = 0);
+}  // namespace mindspore
+#endif  // MINDSPORE_CORE_LOAD_MINDIR_MODEL_PROTO_PARSER_H
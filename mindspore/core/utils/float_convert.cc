@@ -0,0 +1,261 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/float_convert.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "actor/actormgr.h"
+#include "utils/log_adapter.h"
+#if defined(ENABLE_ARM64)
+#include <arm_neon.h>
+#elif defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define FLOAT_CONVERT_X86_DISPATCH
+#endif
+
+namespace mindspore {
+namespace {
+// Below this number of elements a conversion runs on the calling thread.
+constexpr size_t kParallelConvertThreshold = 1 << 20;
+constexpr size_t kMinElementsPerThread = 1 << 18;
+constexpr uint32_t kFloat32AbsMask = 0x7fffffff;
+constexpr uint32_t kFloat32Inf = 0x7f800000;
+constexpr uint32_t kFloat32MantissaMask = 0x007fffff;
+constexpr uint32_t kBFloat16RoundingBias = 0x7fff;
+constexpr uint16_t kBFloat16NaN = 0x7fc0;
+constexpr uint32_t kBFloat16Shift = 16;
+// The static_cast to float16 gives this NaN with the sign of the input, whatever the payload is.
+constexpr uint16_t kFloat16NaN = 0x7e00;
+constexpr uint16_t kFloat16SignMask = 0x8000;
+// The quiet bit of a float16 NaN and how far it moves in the float32 one.
+constexpr uint16_t kFloat16QuietBit = 0x0200;
+constexpr uint32_t kFloat32QuietBit = 0x00400000;
+constexpr int kFloat16ToFloat32MantissaShift = 13;
+
+static_assert(sizeof(float16) == sizeof(uint16_t) && sizeof(bfloat16) == sizeof(uint16_t),
+              "The 16-bit float types are converted through their bits.");
+
+#if defined(ENABLE_ARM64)
+// Same NaN handling as the scalar conversions, see the F16C loops below.
+uint16x4_t Float32ToFloat16Neon(float32x4_t value) {
+  uint16x4_t half = vreinterpret_u16_f16(vcvt_f16_f32(value));
+  uint16x4_t nan_mask = vmovn_u32(vmvnq_u32(vceqq_f32(value, value)));
+  uint16x4_t canonical = vorr_u16(vand_u16(half, vdup_n_u16(kFloat16SignMask)), vdup_n_u16(kFloat16NaN));
+  return vbsl_u16(nan_mask, canonical, half);
+}
+
+float32x4_t Float16ToFloat32Neon(uint16x4_t half) {
+  float32x4_t value = vcvt_f32_f16(vreinterpret_f16_u16(half));
+  uint32x4_t nan_mask = vmvnq_u32(vceqq_f32(value, value));
+  uint32x4_t quiet_bits =
+    vshlq_n_u32(vmovl_u16(vand_u16(half, vdup_n_u16(kFloat16QuietBit))), kFloat16ToFloat32MantissaShift);
+  uint32x4_t bits = vreinterpretq_u32_f32(value);
+  uint32x4_t widened = vorrq_u32(vbicq_u32(bits, vdupq_n_u32(kFloat32QuietBit)), quiet_bits);
+  return vreinterpretq_f32_u32(vbslq_u32(nan_mask, widened, bits));
+}
+#endif
+
+#ifdef FLOAT_CONVERT_X86_DISPATCH
+constexpr size_t kAvxBlock = 8;
+constexpr size_t kAvx512Block = 16;
+
+struct CpuFeatures {
+  CpuFeatures() {
+    __builtin_cpu_init();
+    f16c = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    avx512_bf16 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                  __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bf16");
+  }
+  bool f16c{false};
+  bool avx512_bf16{false};
+};
+
+const CpuFeatures &GetCpuFeatures() {
+  static const CpuFeatures features;
+  return features;
+}
+
+// The vectorized loops return the number of elements converted, the tail is left to the scalar loop.
+__attribute__((target("avx,f16c"))) size_t Float32ToFloat16F16C(const float *src, uint16_t *dst, size_t size) {
+  size_t i = 0;
+  for (; i + kAvxBlock <= size; i += kAvxBlock) {
+    __m256 value = _mm256_loadu_ps(src + i);
+    __m128i half = _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT);
+    // vcvtps2ph keeps the payload of a NaN, while the scalar conversion gives the canonical one with the same sign.
+    __m256 nan_mask = _mm256_cmp_ps(value, value, _CMP_UNORD_Q);
+    if (_mm256_movemask_ps(nan_mask) != 0) {
+      __m256i nan_mask_bits = _mm256_castps_si256(nan_mask);
+      __m128i nan_mask16 =
+        _mm_packs_epi32(_mm256_castsi256_si128(nan_mask_bits), _mm256_extractf128_si256(nan_mask_bits, 1));
+      __m128i canonical = _mm_or_si128(_mm_and_si128(half, _mm_set1_epi16(static_cast<int16_t>(kFloat16SignMask))),
+                                       _mm_set1_epi16(static_cast<int16_t>(kFloat16NaN)));
+      half = _mm_blendv_epi8(half, canonical, nan_mask16);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), half);
+  }
+  return i;
+}
+
+__attribute__((target("avx,f16c"))) size_t Float16ToFloat32F16C(const uint16_t *src, float *dst, size_t size) {
+  size_t i = 0;
+  for (; i + kAvxBlock <= size; i += kAvxBlock) {
+    __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m256 value = _mm256_cvtph_ps(half);
+    // vcvtph2ps quiets a signaling NaN, while the scalar conversion only widens the payload, so the quiet bit of the
+    // input is put back.
+    __m256 nan_mask = _mm256_cmp_ps(value, value, _CMP_UNORD_Q);
+    if (_mm256_movemask_ps(nan_mask) != 0) {
+      __m128i quiet = _mm_and_si128(half, _mm_set1_epi16(static_cast<int16_t>(kFloat16QuietBit)));
+      __m128i quiet_low = _mm_slli_epi32(_mm_cvtepu16_epi32(quiet), kFloat16ToFloat32MantissaShift);
+      __m128i quiet_high =
+        _mm_slli_epi32(_mm_cvtepu16_epi32(_mm_unpackhi_epi64(quiet, quiet)), kFloat16ToFloat32MantissaShift);
+      __m256 quiet_bits = _mm256_castsi256_ps(_mm256_set_m128i(quiet_high, quiet_low));
+      __m256 widened = _mm256_or_ps(
+        _mm256_andnot_ps(_mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int32_t>(kFloat32QuietBit))), value),
+        quiet_bits);
+      value = _mm256_blendv_ps(value, widened, nan_mask);
+    }
+    _mm256_storeu_ps(dst + i, value);
+  }
+  return i;
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vl,avx512bf16"))) size_t Float32ToBFloat16Avx512(const float *src,
+                                                                                               uint16_t *dst,
+                                                                                               size_t size) {
+  size_t i = 0;
+  for (; i + kAvx512Block <= size; i += kAvx512Block) {
+    __m512 value = _mm512_loadu_ps(src + i);
+    // vcvtneps2bf16 keeps the sign and the payload of a NaN, while the scalar conversion gives the canonical one.
+    __mmask16 nan_mask = _mm512_cmp_ps_mask(value, value, _CMP_UNORD_Q);
+    __m256i bf16 = (__m256i)_mm512_cvtneps_pbh(value);
+    bf16 = _mm256_mask_blend_epi16(nan_mask, bf16, _mm256_set1_epi16(static_cast<int16_t>(kBFloat16NaN)));
+    // vcvtneps2bf16 also flushes denormal inputs to zero, while the scalar conversion rounds their bits, so the
+    // denormal lanes are rounded the scalar way. The bits minus one are below the mantissa mask only for them.
+    __m512i bits = _mm512_castps_si512(value);
+    __m512i abs_bits = _mm512_and_si512(bits, _mm512_set1_epi32(static_cast<int32_t>(kFloat32AbsMask)));
+    __mmask16 denormal_mask = _mm512_cmplt_epu32_mask(_mm512_sub_epi32(abs_bits, _mm512_set1_epi32(1)),
+                                                      _mm512_set1_epi32(static_cast<int32_t>(kFloat32MantissaMask)));
+    if (denormal_mask != 0) {
+      __m512i odd = _mm512_and_si512(_mm512_srli_epi32(bits, kBFloat16Shift), _mm512_set1_epi32(1));
+      __m512i bias = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int32_t>(kBFloat16RoundingBias)), odd);
+      __m256i rounded = _mm512_cvtepi32_epi16(_mm512_srli_epi32(_mm512_add_epi32(bits, bias), kBFloat16Shift));
+      bf16 = _mm256_mask_blend_epi16(denormal_mask, bf16, rounded);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), bf16);
+  }
+  return i;
+}
+#endif
+}  // namespace
+
+void Float32ToFloat16(const float *src, float16 *dst, size_t size) {
+  size_t done = 0;
+#if defined(ENABLE_ARM64)
+  constexpr size_t kNeonBlock = 8;
+  constexpr size_t kNeonHalfBlock = 4;
+  auto out = reinterpret_cast<uint16_t *>(dst);
+  for (; done + kNeonBlock <= size; done += kNeonBlock) {
+    uint16x4_t low = Float32ToFloat16Neon(vld1q_f32(src + done));
+    uint16x4_t high = Float32ToFloat16Neon(vld1q_f32(src + done + kNeonHalfBlock));
+    vst1q_u16(out + done, vcombine_u16(low, high));
+  }
+#elif defined(FLOAT_CONVERT_X86_DISPATCH)
+  if (GetCpuFeatures().f16c) {
+    done = Float32ToFloat16F16C(src, reinterpret_cast<uint16_t *>(dst), size);
+  }
+#endif
+  for (size_t i = done; i < size; ++i) {
+    dst[i] = static_cast<float16>(src[i]);
+  }
+}
+
+void Float16ToFloat32(const float16 *src, float *dst, size_t size) {
+  size_t done = 0;
+#if defined(ENABLE_ARM64)
+  constexpr size_t kNeonBlock = 8;
+  constexpr size_t kNeonHalfBlock = 4;
+  auto in = reinterpret_cast<const uint16_t *>(src);
+  for (; done + kNeonBlock <= size; done += kNeonBlock) {
+    uint16x8_t half = vld1q_u16(in + done);
+    vst1q_f32(dst + done, Float16ToFloat32Neon(vget_low_u16(half)));
+    vst1q_f32(dst + done + kNeonHalfBlock, Float16ToFloat32Neon(vget_high_u16(half)));
+  }
+#elif defined(FLOAT_CONVERT_X86_DISPATCH)
+  if (GetCpuFeatures().f16c) {
+    done = Float16ToFloat32F16C(reinterpret_cast<const uint16_t *>(src), dst, size);
+  }
+#endif
+  for (size_t i = done; i < size; ++i) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+void Float32ToBFloat16(const float *src, bfloat16 *dst, size_t size) {
+  auto out = reinterpret_cast<uint16_t *>(dst);
+  size_t done = 0;
+#ifdef FLOAT_CONVERT_X86_DISPATCH
+  if (GetCpuFeatures().avx512_bf16) {
+    done = Float32ToBFloat16Avx512(src, out, size);
+  }
+#endif
+  // Round to nearest even on the bits as BFloat16 does, written without branches so that it is auto-vectorized.
+  for (size_t i = done; i < size; ++i) {
+    uint32_t bits;
+    (void)memcpy(&bits, src + i, sizeof(bits));
+    uint32_t rounding_bias = kBFloat16RoundingBias + ((bits >> kBFloat16Shift) & 1);
+    auto rounded = static_cast<uint16_t>((bits + rounding_bias) >> kBFloat16Shift);
+    out[i] = (bits & kFloat32AbsMask) > kFloat32Inf ? kBFloat16NaN : rounded;
+  }
+}
+
+void BFloat16ToFloat32(const bfloat16 *src, float *dst, size_t size) {
+  auto in = reinterpret_cast<const uint16_t *>(src);
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t bits = static_cast<uint32_t>(in[i]) << kBFloat16Shift;
+    (void)memcpy(dst + i, &bits, sizeof(bits));
+  }
+}
+
+void ParallelConvert(size_t size, const std::function<void(size_t, size_t)> &task) {
+  // Share the kernel threads of the actor runtime, the conversion runs on the calling thread until they are created.
+  ActorThreadPool *thread_pool = nullptr;
+  if (size >= kParallelConvertThreshold) {
+    thread_pool = ActorMgr::GetActorMgrRef()->GetActorThreadPool();
+  }
+  size_t task_num = 1;
+  if (thread_pool != nullptr) {
+    task_num = std::min(thread_pool->GetKernelThreadNum(), size / kMinElementsPerThread);
+  }
+  if (task_num <= 1) {
+    task(0, size);
+    return;
+  }
+  size_t chunk = (size + task_num - 1) / task_num;
+  auto func = [&task, size, chunk](void *, int task_id, float, float) {
+    size_t start = static_cast<size_t>(task_id) * chunk;
+    if (start < size) {
+      task(start, std::min(start + chunk, size));
+    }
+    return THREAD_OK;
+  };
+  if (thread_pool->ParallelLaunch(func, nullptr, static_cast<int>(task_num)) != THREAD_OK) {
+    MS_LOG(EXCEPTION) << "Convert " << size << " elements on " << task_num << " threads failed.";
+  }
+}
+}  // namespace mindspore
@@ -0,0 +1,54 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CORE_UTILS_FLOAT_CONVERT_H_
+#define MINDSPORE_CORE_UTILS_FLOAT_CONVERT_H_
+
+#include <cstddef>
+#include <functional>
+#include "base/float16.h"
+#include "base/bfloat16.h"
+#include "mindapi/base/macros.h"
+
+namespace mindspore {
+// Conversions between float32 and the 16-bit float types, vectorized with F16C and AVX512-BF16 on x86 when the cpu
+// supports them and with NEON on ARM64. The results are the same as the element-wise static_cast.
+MS_CORE_API void Float32ToFloat16(const float *src, float16 *dst, size_t size);
+MS_CORE_API void Float16ToFloat32(const float16 *src, float *dst, size_t size);
+MS_CORE_API void Float32ToBFloat16(const float *src, bfloat16 *dst, size_t size);
+MS_CORE_API void BFloat16ToFloat32(const bfloat16 *src, float *dst, size_t size);
+
+// Run task(start, end) over [0, size) in chunks on several threads when size is large enough to pay for them.
+MS_CORE_API void ParallelConvert(size_t size, const std::function<void(size_t, size_t)> &task);
+
+template <typename T, typename U>
+void ConvertRange(const U *src, T *dst, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    dst[i] = static_cast<T>(src[i]);
+  }
+}
+inline void ConvertRange(const float *src, float16 *dst, size_t size) { Float32ToFloat16(src, dst, size); }
+inline void ConvertRange(const float16 *src, float *dst, size_t size) { Float16ToFloat32(src, dst, size); }
+inline void ConvertRange(const float *src, bfloat16 *dst, size_t size) { Float32ToBFloat16(src, dst, size); }
+inline void ConvertRange(const bfloat16 *src, float *dst, size_t size) { BFloat16ToFloat32(src, dst, size); }
+
+// Convert size elements of src to the element type of dst.
+template <typename T, typename U>
+void ConvertData(const U *src, T *dst, size_t size) {
+  ParallelConvert(size, [src, dst](size_t start, size_t end) { ConvertRange(src + start, dst + start, end - start); });
+}
+}  // namespace mindspore
+#endif  // MINDSPORE_CORE_UTILS_FLOAT_CONVERT_H_
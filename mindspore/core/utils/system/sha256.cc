@@ -82,16 +82,18 @@ bool Padding(std::string *message) {
   return true;
 }
 
-bool ProcessInner(const std::string &message, const int &bias, uint32_t *digest, const int &digest_size) {
+namespace {
+const uint32_t kInitialDigest[kDigestSize] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                              0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+bool ProcessBlock(const uint8_t *block, uint32_t *digest, const int &digest_size) {
   if (digest_size != 8) {  // The number of digests is fixed at 8
     return false;
   }
   uint32_t w[kIterationNumber] = {0};
   for (int i = 0; i < 16; ++i) {
-    w[i] = (static_cast<uint32_t>(static_cast<uint8_t>(message[IntToSize(bias + i * 4)]) & 0xff) << 24) |
-           (static_cast<uint32_t>(static_cast<uint8_t>(message[IntToSize(bias + i * 4 + 1)]) & 0xff) << 16) |
-           (static_cast<uint32_t>(static_cast<uint8_t>(message[IntToSize(bias + i * 4 + 2)]) & 0xff) << 8) |
-           (static_cast<uint32_t>(static_cast<uint8_t>(message[IntToSize(bias + i * 4 + 3)]) & 0xff));
+    w[i] = (static_cast<uint32_t>(block[i * 4]) << 24) | (static_cast<uint32_t>(block[i * 4 + 1]) << 16) |
+           (static_cast<uint32_t>(block[i * 4 + 2]) << 8) | static_cast<uint32_t>(block[i * 4 + 3]);
   }
   for (int i = 16; i < kIterationNumber; ++i) {
     w[i] = sigma3(w[i - 2]) + w[i - 7] + sigma2(w[i - 15]) + w[i - 16];
@@ -121,6 +123,14 @@ bool ProcessInner(const std::string &message, const int &bias, uint32_t *digest,
   }
   return true;
 }
+}  // namespace
+
+bool ProcessInner(const std::string &message, const int &bias, uint32_t *digest, const int &digest_size) {
+  if (bias < 0 || IntToSize(bias) + kMessageBlockLength > message.size()) {
+    return false;
+  }
+  return ProcessBlock(reinterpret_cast<const uint8_t *>(message.data()) + bias, digest, digest_size);
+}
 
 std::string ConvertToString(const uint32_t *input, const int &size) {
   std::ostringstream oss;
@@ -135,8 +145,8 @@ std::string ConvertToString(const uint32_t *input, const int &size) {
 }
 
 std::string Encrypt(const std::string &message) {
-  uint32_t digest[kDigestSize] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
-                                  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  uint32_t digest[kDigestSize];
+  std::copy(kInitialDigest, kInitialDigest + kDigestSize, digest);
   for (int i = 0; i < static_cast<int>(message.size()); i += kMessageBlockLength) {
     if (!ProcessInner(message, i, digest, kDigestSize)) {
       return "";
@@ -153,6 +163,34 @@ std::string GetHashFromString(const std::string &data) {
   return Encrypt(message);
 }
 
+std::string GetHashFromBuffer(const void *data, size_t size) {
+  if (data == nullptr || size == 0) {
+    return "";
+  }
+  uint32_t digest[kDigestSize];
+  std::copy(kInitialDigest, kInitialDigest + kDigestSize, digest);
+  auto bytes = static_cast<const uint8_t *>(data);
+  size_t full_size = size / kMessageBlockLength * kMessageBlockLength;
+  for (size_t i = 0; i < full_size; i += kMessageBlockLength) {
+    (void)ProcessBlock(bytes + i, digest, kDigestSize);
+  }
+  // Only the last partial block is copied to append the padding and the message length in bits.
+  std::string tail(reinterpret_cast<const char *>(bytes + full_size), size - full_size);
+  auto bits_message = static_cast<uint64_t>(size) * kBitNumber;
+  tail.push_back(static_cast<char>(0x80));
+  const int size_append = 8;
+  while (tail.size() % kMessageBlockLength != IntToSize(kMessageBlockLength - size_append)) {
+    tail.push_back(0x00);
+  }
+  for (int i = size_append - 1; i >= 0; --i) {
+    tail.push_back(static_cast<char>((bits_message >> static_cast<uint32_t>(i * kBitNumber)) & 0xff));
+  }
+  for (size_t i = 0; i < tail.size(); i += kMessageBlockLength) {
+    (void)ProcessBlock(reinterpret_cast<const uint8_t *>(tail.data()) + i, digest, kDigestSize);
+  }
+  return ConvertToString(digest, kDigestSize);
+}
+
 std::string GetHashFromFile(const std::string &path) {
   std::string message = LoadFilePath(path);
   if (message.empty() || !Padding(&message)) {
@@ -42,6 +42,9 @@ std::string Encrypt(const std::string &message);
 
 MS_CORE_API std::string GetHashFromString(const std::string &data);
 
+// Same digest as GetHashFromString of the bytes, hashed in place without copying the buffer.
+MS_CORE_API std::string GetHashFromBuffer(const void *data, size_t size);
+
 MS_CORE_API std::string GetHashFromFile(const std::string &path);
 
 #ifndef _WIN32
@@ -79,6 +79,11 @@ static const char *const kSharedThreadPoolSection = "shared_thread_pool";
 static const char *const kEnableSharedThreadPoolKey = "enable_shared_thread_pool";
 static const char *const kThreadNumLimitPerWorkerKey = "thread_num_limit_per_worker";
 static const char *const kThreadNumRemainingPerWorkerKey = "thread_num_remaining_per_worker";
+// model pool dynamic batching
+static const char *const kDynamicBatchingSection = "dynamic_batching";
+static const char *const kEnableDynamicBatchingKey = "enable_dynamic_batching";
+static const char *const kMaxBatchSizeKey = "max_batch_size";
+static const char *const kBatchTimeoutUsKey = "batch_timeout_us";
 // model pool inner section and key
 static const char *const kInnerModelParallelRunnerSection = "inner_model_parallel_runner";
 static const char *const kInnerSharingWeightCopyBufKey = "sharing_weight_copy_buf";
@@ -89,6 +94,10 @@ static const char *const kInnerWorkerNumKey = "inner_worker_num";
 
 // common context
 static const char *const kCommonContextSection = "common_context";
+static const char *const kShapePlanCacheSizeKey = "shape_plan_cache_size";
+static const char *const kPackWeightCacheDirKey = "pack_weight_cache_dir";
+static const char *const kKernelTuneProfileKey = "kernel_tune_profile";
+static const char *const kEnableKernelTuneKey = "enable_kernel_tune";
 // gpu context
 static const char *const kGPUContextSection = "gpu_context";
 static const char *const kInputShapeKey = "input_shape";
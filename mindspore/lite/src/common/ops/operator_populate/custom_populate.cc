@@ -16,6 +16,7 @@
 #include "src/common/ops/operator_populate/operator_populate_register.h"
 #include "nnacl/custom_parameter.h"
 #include "nnacl/split_parameter.h"
+#include "nnacl/flash_attention_parameter.h"
 #include "ops/custom.h"
 using mindspore::ops::kNameCustom;
 using mindspore::schema::PrimitiveType_Custom;
@@ -68,6 +69,29 @@ OpParameter *PopulateSplitReduceConcatFusionParam(const ops::Custom *op) {
   param->op_parameter_.type_ = PrimType_Inner_SplitReduceConcatFusion;
   return reinterpret_cast<OpParameter *>(param);
 }
+
+OpParameter *PopulateFlashAttentionParam(const ops::Custom *op) {
+  auto param = static_cast<FlashAttentionParameter *>(malloc(sizeof(FlashAttentionParameter)));
+  if (param == nullptr) {
+    MS_LOG(ERROR) << "malloc FlashAttentionParameter failed.";
+    return nullptr;
+  }
+  memset(param, 0, sizeof(FlashAttentionParameter));
+  param->op_parameter_.type_ = PrimType_Inner_FlashAttention;
+  auto attrs = op->get_attr();
+  if (attrs.find("scale_value") != attrs.end() &&
+      !GetDataFromOp(&param->scale_, sizeof(float), op, "scale_value")) {
+    MS_LOG(ERROR) << "Get scale_value of FlashAttention from op fail.";
+    free(param);
+    return nullptr;
+  }
+  if (attrs.find("is_causal") != attrs.end() && !GetDataFromOp(&param->is_causal_, sizeof(bool), op, "is_causal")) {
+    MS_LOG(ERROR) << "Get is_causal of FlashAttention from op fail.";
+    free(param);
+    return nullptr;
+  }
+  return reinterpret_cast<OpParameter *>(param);
+}
 }  // namespace
 
 OpParameter *PopulateCustomOpParameter(const BaseOperatorPtr &base_operator) {
@@ -102,6 +126,8 @@ OpParameter *PopulateCustomOpParameter(const BaseOperatorPtr &base_operator) {
     return reinterpret_cast<OpParameter *>(param);
   } else if (type == "SplitReduceConcatFusion") {
     return PopulateSplitReduceConcatFusionParam(op);
+  } else if (type == "CpuFlashAttention") {
+    return PopulateFlashAttentionParam(op);
   } else if (type == "EncoderLayer") {
     std::cout << "EncoderLayer populate" << std::endl;
     auto *param = reinterpret_cast<OpParameter *>(malloc(sizeof(OpParameter)));
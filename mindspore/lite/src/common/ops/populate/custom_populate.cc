@@ -19,6 +19,7 @@
 #include "nnacl/custom_parameter.h"
 #include "nnacl/split_parameter.h"
 #include "nnacl/custom_gru_parameter.h"
+#include "nnacl/flash_attention_parameter.h"
 using mindspore::schema::PrimitiveType_Custom;
 
 namespace mindspore {
@@ -94,6 +95,39 @@ OpParameter *CreateCustomGruParameter() {
   return reinterpret_cast<OpParameter *>(param);
 }
 
+OpParameter *PopulateFlashAttentionParameter(const schema::Custom *value) {
+  auto *param = static_cast<FlashAttentionParameter *>(malloc(sizeof(FlashAttentionParameter)));
+  if (param == nullptr) {
+    MS_LOG(ERROR) << "malloc FlashAttentionParameter failed.";
+    return nullptr;
+  }
+  (void)memset(param, 0, sizeof(FlashAttentionParameter));
+  // without scale_value, the zero scale is replaced with 1 / sqrt(head_size) by the kernel.
+  param->op_parameter_.type_ = PrimType_Inner_FlashAttention;
+  if (value->attr() == nullptr) {
+    return reinterpret_cast<OpParameter *>(param);
+  }
+  for (size_t i = 0; i < value->attr()->size(); i++) {
+    auto attr = value->attr()->Get(i);
+    if (attr == nullptr || attr->name() == nullptr || attr->data() == nullptr) {
+      continue;
+    }
+    std::string attr_name = attr->name()->str();
+    bool ret = true;
+    if (attr_name == "scale_value") {
+      ret = attr->data()->size() == sizeof(float) && GetDataFromPrim(&param->scale_, sizeof(float), value, i);
+    } else if (attr_name == "is_causal") {
+      ret = attr->data()->size() == sizeof(bool) && GetDataFromPrim(&param->is_causal_, sizeof(bool), value, i);
+    }
+    if (!ret) {
+      MS_LOG(ERROR) << "Get " << attr_name << " of FlashAttention from prim failed.";
+      free(param);
+      return nullptr;
+    }
+  }
+  return reinterpret_cast<OpParameter *>(param);
+}
+
 OpParameter *PopulateCustomParameter(const void *prim) {
   MS_CHECK_TRUE_RET(prim != nullptr, nullptr);
   auto primitive = static_cast<const schema::Primitive *>(prim);
@@ -133,6 +167,8 @@ OpParameter *PopulateCustomParameter(const void *prim) {
     return CreateCustomGruParameter();
   } else if (type == "CastGatherReduceFusion") {
     return CreateParam(PrimType_Inner_CastGatherReduceFusion);
+  } else if (type == "CpuFlashAttention") {
+    return PopulateFlashAttentionParameter(value);
   } else {
     MS_LOG(ERROR) << "Unsupported custom type: " << type;
   }
@@ -0,0 +1,274 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "extendrt/cxx_api/llm_engine/llm_batch_scheduler.h"
+#include <algorithm>
+#include <utility>
+#include "src/common/log_adapter.h"
+
+namespace mindspore {
+Status LLMBatchScheduler::Init(const LLMBatchSchedulerConfig &config,
+                               const std::shared_ptr<LLMKVCacheManager> &kv_cache) {
+  if (config.max_batch_size == 0 || config.max_batch_tokens < config.max_batch_size) {
+    MS_LOG(ERROR) << "batch scheduler config is invalid, max batch size: " << config.max_batch_size
+                  << " | max batch tokens: " << config.max_batch_tokens;
+    return kLiteParamInvalid;
+  }
+  if (kv_cache == nullptr || kv_cache->GetTotalBlockNum() == 0) {
+    MS_LOG(ERROR) << "kv cache is nullptr or not initialized.";
+    return kLiteNullptr;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  config_ = config;
+  kv_cache_ = kv_cache;
+  sequences_.clear();
+  waiting_.clear();
+  running_.clear();
+  return kSuccess;
+}
+
+Status LLMBatchScheduler::AddRequest(const LLMReq &req) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (kv_cache_ == nullptr) {
+    MS_LOG(ERROR) << "batch scheduler is not initialized.";
+    return kLiteUninitializedObj;
+  }
+  if (sequences_.find(req.req_id) != sequences_.end()) {
+    MS_LOG(ERROR) << "request " << req.req_id << " is already added.";
+    return kLiteLLMRepeatRequest;
+  }
+  if (req.prompt_length == 0) {
+    MS_LOG(ERROR) << "prompt length of request " << req.req_id << " is 0.";
+    return kLiteParamInvalid;
+  }
+  if (req.prefix_id != UINT64_MAX && !kv_cache_->HasPrefix(req.prefix_id)) {
+    MS_LOG(ERROR) << "prefix " << req.prefix_id << " of request " << req.req_id << " is not preloaded.";
+    return kLiteLLMKVCacheNotExist;
+  }
+  Sequence seq;
+  seq.req = req;
+  seq.num_tokens = kv_cache_->GetPrefixLength(req.prefix_id) + req.prompt_length;
+  // a preempted request is recomputed from scratch, so the whole sequence must fit in one step and in the cache.
+  if (seq.num_tokens > config_.max_batch_tokens ||
+      kv_cache_->GetBlockNum(seq.num_tokens + 1) > kv_cache_->GetTotalBlockNum()) {
+    MS_LOG(ERROR) << "request " << req.req_id << " is too long, tokens: " << seq.num_tokens
+                  << " | max batch tokens: " << config_.max_batch_tokens
+                  << " | kv cache blocks: " << kv_cache_->GetTotalBlockNum();
+    return kLiteParamInvalid;
+  }
+  sequences_[req.req_id] = seq;
+  waiting_.push_back(req.req_id);
+  return kSuccess;
+}
+
+Status LLMBatchScheduler::CompleteRequest(const LLMReq &req) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = sequences_.find(req.req_id);
+  if (it == sequences_.end()) {
+    MS_LOG(ERROR) << "request " << req.req_id << " is not found.";
+    return kLiteLLMKVCacheNotExist;
+  }
+  if (it->second.completed) {
+    MS_LOG(ERROR) << "request " << req.req_id << " is already completed.";
+    return kLiteLLMRequestAlreadyCompleted;
+  }
+  it->second.completed = true;
+  return kSuccess;
+}
+
+Status LLMBatchScheduler::AddPrefix(uint64_t prefix_id, size_t num_tokens) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (kv_cache_ == nullptr) {
+    MS_LOG(ERROR) << "batch scheduler is not initialized.";
+    return kLiteUninitializedObj;
+  }
+  return kv_cache_->AddPrefix(prefix_id, num_tokens);
+}
+
+Status LLMBatchScheduler::ReleasePrefix(uint64_t prefix_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (kv_cache_ == nullptr) {
+    MS_LOG(ERROR) << "batch scheduler is not initialized.";
+    return kLiteUninitializedObj;
+  }
+  return kv_cache_->ReleasePrefix(prefix_id);
+}
+
+void LLMBatchScheduler::RetireCompleted(LLMScheduleOutput *output) {
+  for (auto it = sequences_.begin(); it != sequences_.end();) {
+    if (!it->second.completed) {
+      ++it;
+      continue;
+    }
+    auto req_id = it->first;
+    if (kv_cache_->HasSequence(req_id)) {
+      (void)kv_cache_->FreeSequence(req_id);
+    }
+    running_.erase(std::remove(running_.begin(), running_.end(), req_id), running_.end());
+    waiting_.erase(std::remove(waiting_.begin(), waiting_.end(), req_id), waiting_.end());
+    output->retired.push_back(req_id);
+    it = sequences_.erase(it);
+  }
+}
+
+void LLMBatchScheduler::Preempt(uint64_t req_id, LLMScheduleOutput *output) {
+  MS_LOG(INFO) << "preempt request " << req_id << ", free kv cache blocks: " << kv_cache_->GetFreeBlockNum();
+  (void)kv_cache_->FreeSequence(req_id);
+  sequences_[req_id].num_computed = 0;
+  running_.erase(std::remove(running_.begin(), running_.end(), req_id), running_.end());
+  waiting_.push_front(req_id);
+  output->preempted.push_back(req_id);
+}
+
+Status LLMBatchScheduler::AddScheduledSeq(const Sequence &seq, bool is_prefill, LLMScheduleOutput *output) {
+  LLMScheduledSeq scheduled;
+  scheduled.req_id = seq.req.req_id;
+  scheduled.is_prefill = is_prefill;
+  scheduled.start_pos = seq.num_computed;
+  scheduled.num_tokens = seq.num_tokens - seq.num_computed;
+  auto ret = kv_cache_->GetBlockTable(scheduled.req_id, &scheduled.block_table);
+  if (ret != kSuccess) {
+    return ret;
+  }
+  output->num_batch_tokens += scheduled.num_tokens;
+  output->seqs.push_back(std::move(scheduled));
+  return kSuccess;
+}
+
+Status LLMBatchScheduler::ScheduleRunning(LLMScheduleOutput *output) {
+  size_t index = 0;
+  while (index < running_.size()) {
+    auto req_id = running_[index];
+    auto &seq = sequences_[req_id];
+    auto num_tokens = seq.num_tokens - seq.num_computed;
+    if (output->num_batch_tokens + num_tokens > config_.max_batch_tokens) {
+      break;
+    }
+    bool self_preempted = false;
+    while (kv_cache_->GetAppendBlockNum(req_id, num_tokens) > kv_cache_->GetFreeBlockNum()) {
+      auto victim = running_.back();
+      Preempt(victim, output);
+      if (victim == req_id) {
+        self_preempted = true;
+        break;
+      }
+    }
+    if (self_preempted) {
+      break;
+    }
+    auto ret = kv_cache_->AppendSlots(req_id, num_tokens);
+    if (ret != kSuccess) {
+      MS_LOG(ERROR) << "append kv cache slots for request " << req_id << " failed.";
+      return ret;
+    }
+    ret = AddScheduledSeq(seq, false, output);
+    if (ret != kSuccess) {
+      return ret;
+    }
+    index++;
+  }
+  return kSuccess;
+}
+
+Status LLMBatchScheduler::ScheduleWaiting(LLMScheduleOutput *output) {
+  // admitting new requests right after a preemption would only evict them again.
+  if (!output->preempted.empty()) {
+    return kSuccess;
+  }
+  while (!waiting_.empty() && running_.size() < config_.max_batch_size) {
+    auto req_id = waiting_.front();
+    auto &seq = sequences_[req_id];
+    auto prefix_id = seq.req.prefix_id;
+    if (prefix_id != UINT64_MAX && !kv_cache_->HasPrefix(prefix_id)) {
+      // the prefix has been released since the request was added, recompute it with the prompt.
+      prefix_id = UINT64_MAX;
+    }
+    auto ret = kv_cache_->AddSequence(req_id, prefix_id);
+    if (ret != kSuccess) {
+      return ret;
+    }
+    seq.num_computed = kv_cache_->GetSequenceLength(req_id);
+    auto num_tokens = seq.num_tokens - seq.num_computed;
+    // a recomputed request may exceed the token budget after decoding, let it run alone.
+    bool over_budget = output->num_batch_tokens > 0 && output->num_batch_tokens + num_tokens > config_.max_batch_tokens;
+    if (over_budget || kv_cache_->GetAppendBlockNum(req_id, num_tokens) > kv_cache_->GetFreeBlockNum()) {
+      (void)kv_cache_->FreeSequence(req_id);
+      seq.num_computed = 0;
+      break;
+    }
+    ret = kv_cache_->AppendSlots(req_id, num_tokens);
+    if (ret != kSuccess) {
+      MS_LOG(ERROR) << "append kv cache slots for request " << req_id << " failed.";
+      return ret;
+    }
+    waiting_.pop_front();
+    running_.push_back(req_id);
+    ret = AddScheduledSeq(seq, true, output);
+    if (ret != kSuccess) {
+      return ret;
+    }
+  }
+  return kSuccess;
+}
+
+Status LLMBatchScheduler::Schedule(LLMScheduleOutput *output) {
+  if (output == nullptr) {
+    MS_LOG(ERROR) << "schedule output is nullptr.";
+    return kLiteNullptr;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (kv_cache_ == nullptr) {
+    MS_LOG(ERROR) << "batch scheduler is not initialized.";
+    return kLiteUninitializedObj;
+  }
+  *output = LLMScheduleOutput();
+  RetireCompleted(output);
+  auto ret = ScheduleRunning(output);
+  if (ret != kSuccess) {
+    return ret;
+  }
+  return ScheduleWaiting(output);
+}
+
+Status LLMBatchScheduler::StepDone(const LLMScheduleOutput &output) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (auto &scheduled : output.seqs) {
+    auto it = sequences_.find(scheduled.req_id);
+    if (it == sequences_.end()) {
+      MS_LOG(ERROR) << "request " << scheduled.req_id << " is not found.";
+      return kLiteLLMKVCacheNotExist;
+    }
+    auto &seq = it->second;
+    if (seq.num_computed != scheduled.start_pos) {
+      MS_LOG(ERROR) << "request " << scheduled.req_id << " is not scheduled at position " << scheduled.start_pos
+                    << ", computed tokens: " << seq.num_computed;
+      return kLiteError;
+    }
+    seq.num_computed += scheduled.num_tokens;
+    seq.num_tokens += 1;
+  }
+  return kSuccess;
+}
+
+size_t LLMBatchScheduler::GetWaitingNum() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return waiting_.size();
+}
+
+size_t LLMBatchScheduler::GetRunningNum() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return running_.size();
+}
+}  // namespace mindspore
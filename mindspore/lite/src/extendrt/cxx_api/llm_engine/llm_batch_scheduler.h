@@ -0,0 +1,84 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_LLM_ENGINE_LLM_BATCH_SCHEDULER_H_
+#define MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_LLM_ENGINE_LLM_BATCH_SCHEDULER_H_
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "include/api/status.h"
+#include "extendrt/cxx_api/llm_engine/llm_engine.h"
+#include "extendrt/cxx_api/llm_engine/llm_kv_cache_manager.h"
+
+namespace mindspore {
+struct LLMBatchSchedulerConfig {
+  // max number of sequences running in one step
+  size_t max_batch_size = 8;
+  // max number of tokens computed in one step, prefill tokens included
+  size_t max_batch_tokens = 2048;
+};
+
+// LLMBatchScheduler implements continuous batching on top of the paged kv cache: every step it retires the
+// completed sequences, keeps decoding the running ones and admits waiting requests into the free slots, so requests
+// join and leave the batch between decode steps instead of waiting for the longest one in a static batch.
+// When the cache runs out of blocks the latest admitted sequence is preempted and requeued for recomputation.
+// The prompt of a request starting from a preloaded prefix is prefix length + prompt_length tokens.
+class LLMBatchScheduler {
+ public:
+  LLMBatchScheduler() = default;
+  ~LLMBatchScheduler() = default;
+
+  Status Init(const LLMBatchSchedulerConfig &config, const std::shared_ptr<LLMKVCacheManager> &kv_cache);
+  Status AddRequest(const LLMReq &req);
+  // mark the request completed, its kv cache blocks are released in the next Schedule.
+  Status CompleteRequest(const LLMReq &req);
+  // prefix blocks are allocated under the scheduler lock too, so they never race with a step taking free blocks.
+  Status AddPrefix(uint64_t prefix_id, size_t num_tokens);
+  Status ReleasePrefix(uint64_t prefix_id);
+  Status Schedule(LLMScheduleOutput *output);
+  // commit the tokens computed by the step, each scheduled sequence gets one new token.
+  Status StepDone(const LLMScheduleOutput &output);
+
+  size_t GetWaitingNum() const;
+  size_t GetRunningNum() const;
+
+ private:
+  struct Sequence {
+    LLMReq req;
+    // prompt tokens + generated tokens
+    size_t num_tokens = 0;
+    // tokens whose kv are in the cache
+    size_t num_computed = 0;
+    bool completed = false;
+  };
+
+  void RetireCompleted(LLMScheduleOutput *output);
+  void Preempt(uint64_t req_id, LLMScheduleOutput *output);
+  Status ScheduleRunning(LLMScheduleOutput *output);
+  Status ScheduleWaiting(LLMScheduleOutput *output);
+  Status AddScheduledSeq(const Sequence &seq, bool is_prefill, LLMScheduleOutput *output);
+
+  LLMBatchSchedulerConfig config_;
+  std::shared_ptr<LLMKVCacheManager> kv_cache_ = nullptr;
+  std::map<uint64_t, Sequence> sequences_;
+  std::deque<uint64_t> waiting_;
+  // ordered by admission, the back is preempted first
+  std::deque<uint64_t> running_;
+  mutable std::mutex mutex_;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_LLM_ENGINE_LLM_BATCH_SCHEDULER_H_
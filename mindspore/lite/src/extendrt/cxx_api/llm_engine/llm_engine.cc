@@ -19,6 +19,9 @@
 #include "mindspore/lite/src/extendrt/cxx_api/file_utils.h"
 #include "mindspore/core/load_mindir/load_model.h"
 #include "extendrt/cxx_api/llm_engine/llm_engine_plugin.h"
+#include "extendrt/cxx_api/llm_engine/llm_kv_cache_manager.h"
+#include "extendrt/cxx_api/llm_engine/llm_batch_scheduler.h"
+#include "mindspore/lite/src/common/utils.h"
 #include "mindspore/lite/src/common/common.h"
 #include "mindspore/lite/tools/common/custom_ascend_utils.h"
 #include "mindspore/lite/src/extendrt/utils/func_graph_utils.h"
@@ -27,6 +30,29 @@ namespace mindspore {
 namespace {
 constexpr auto kLLMEnginePluginSoName = "libllm_engine_plugin.so";
 constexpr auto kLLMEngineCreatePluginFuncName = "CreateLLMEnginePlugin";
+constexpr auto kOptionKvCacheNumBlocks = "llm.KvCacheNumBlocks";
+constexpr auto kOptionKvCacheBlockSize = "llm.KvCacheBlockSize";
+constexpr auto kOptionKvCacheNumLayers = "llm.KvCacheNumLayers";
+constexpr auto kOptionKvCacheNumHeads = "llm.KvCacheNumHeads";
+constexpr auto kOptionKvCacheHeadDim = "llm.KvCacheHeadDim";
+constexpr auto kOptionMaxBatchSize = "llm.MaxBatchSize";
+constexpr auto kOptionMaxBatchTokens = "llm.MaxBatchTokens";
+
+// the option is consumed here and not passed to the plugin.
+bool TakeSizeOption(std::map<std::string, std::string> *options, const std::string &key, size_t *value) {
+  auto it = options->find(key);
+  if (it == options->end()) {
+    return true;
+  }
+  int64_t int_value = 0;
+  if (!lite::ConvertStrToInt(it->second, &int_value) || int_value <= 0) {
+    MS_LOG(ERROR) << "Option " << key << " should be a positive integer, but got " << it->second;
+    return false;
+  }
+  *value = static_cast<size_t>(int_value);
+  (void)options->erase(it);
+  return true;
+}
 
 Status GetModelInfo(const FuncGraphPtr &func_graph, LLMEngineModelInfo *model_info) {
   if (func_graph == nullptr || model_info == nullptr) {
@@ -179,6 +205,45 @@ std::shared_ptr<LLMEnginePluginBase> LLEnginePluginLoader::CreatePlugin() {
 
 LLMEngine::LLMEngine() { plugin_ = LLEnginePluginLoader::Instance().CreatePlugin(); }
 
+LLMEngine::LLMEngine(const std::shared_ptr<LLMEnginePluginBase> &plugin) : plugin_(plugin) {}
+
+Status LLMEngine::InitBatchScheduler(std::map<std::string, std::string> *options) {
+  LLMKVCacheConfig kv_config;
+  // the kv data lives on the device, the host blocks only need one byte per token for the block accounting.
+  kv_config.head_dim = 1;
+  kv_config.data_type_size = 1;
+  LLMBatchSchedulerConfig batch_config;
+  if (!TakeSizeOption(options, kOptionKvCacheNumBlocks, &kv_config.num_blocks) ||
+      !TakeSizeOption(options, kOptionKvCacheBlockSize, &kv_config.block_size) ||
+      !TakeSizeOption(options, kOptionKvCacheNumLayers, &kv_config.num_layers) ||
+      !TakeSizeOption(options, kOptionKvCacheNumHeads, &kv_config.num_kv_heads) ||
+      !TakeSizeOption(options, kOptionKvCacheHeadDim, &kv_config.head_dim) ||
+      !TakeSizeOption(options, kOptionMaxBatchSize, &batch_config.max_batch_size) ||
+      !TakeSizeOption(options, kOptionMaxBatchTokens, &batch_config.max_batch_tokens)) {
+    return kLiteParamInvalid;
+  }
+  if (kv_config.num_blocks == 0) {
+    return kSuccess;
+  }
+  auto kv_cache = std::make_shared<LLMKVCacheManager>();
+  auto ret = kv_cache->Init(kv_config);
+  if (ret != kSuccess) {
+    MS_LOG(ERROR) << "Failed to init the paged kv cache";
+    return ret;
+  }
+  auto batch_scheduler = std::make_shared<LLMBatchScheduler>();
+  ret = batch_scheduler->Init(batch_config, kv_cache);
+  if (ret != kSuccess) {
+    MS_LOG(ERROR) << "Failed to init the batch scheduler";
+    return ret;
+  }
+  std::atomic_store(&kv_cache_, kv_cache);
+  batch_scheduler_ = batch_scheduler;
+  MS_LOG(INFO) << "Continuous batching is enabled, max batch size: " << batch_config.max_batch_size
+               << " | max batch tokens: " << batch_config.max_batch_tokens;
+  return kSuccess;
+}
+
 Status LLMEngine::Init(const std::vector<std::string> &model_paths, LLMRole role, uint64_t cluster_id,
                        const std::map<std::string, std::string> &options, const std::string &batch_mode,
                        const std::string &postprocess_model_path) {
@@ -209,7 +274,12 @@ Status LLMEngine::Init(const std::vector<std::string> &model_paths, LLMRole role
       return kLiteError;
     }
   }
-  return plugin_->Init(infos, role, cluster_id, options, batch_mode, postprocess_model_info);
+  auto plugin_options = options;
+  auto ret = InitBatchScheduler(&plugin_options);
+  if (ret != kSuccess) {
+    return ret;
+  }
+  return plugin_->Init(infos, role, cluster_id, plugin_options, batch_mode, postprocess_model_info);
 }
 
 void LLMEngine::Finalize() {
@@ -218,6 +288,10 @@ void LLMEngine::Finalize() {
     return;
   }
   plugin_->Finalize();
+  std::unique_lock<std::mutex> lock(step_mutex_);
+  batch_scheduler_ = nullptr;
+  std::atomic_store(&kv_cache_, std::shared_ptr<LLMKVCacheManager>(nullptr));
+  step_pending_ = false;
 }
 
 Status LLMEngine::Predict(const LLMReq &req, const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs) {
@@ -228,13 +302,79 @@ Status LLMEngine::Predict(const LLMReq &req, const std::vector<MSTensor> &inputs
   return plugin_->Predict(req, inputs, outputs);
 }
 
+Status LLMEngine::Schedule(const std::vector<LLMReq> &new_reqs, LLMScheduleOutput *output) {
+  if (output == nullptr) {
+    MS_LOG(ERROR) << "Schedule output is nullptr";
+    return kLiteNullptr;
+  }
+  std::unique_lock<std::mutex> lock(step_mutex_);
+  if (batch_scheduler_ == nullptr) {
+    MS_LOG(ERROR) << "Continuous batching is not enabled, set option " << kOptionKvCacheNumBlocks;
+    return kLiteUninitializedObj;
+  }
+  if (step_pending_) {
+    MS_LOG(ERROR) << "The scheduled step has not been run yet";
+    return kLiteError;
+  }
+  for (auto &req : new_reqs) {
+    auto ret = batch_scheduler_->AddRequest(req);
+    if (ret != kSuccess) {
+      MS_LOG(ERROR) << "Failed to add request " << req.req_id << " to the batch";
+      return ret;
+    }
+  }
+  auto ret = batch_scheduler_->Schedule(&scheduled_step_);
+  if (ret != kSuccess) {
+    MS_LOG(ERROR) << "Failed to schedule the next step";
+    return ret;
+  }
+  step_pending_ = !scheduled_step_.seqs.empty();
+  *output = scheduled_step_;
+  return kSuccess;
+}
+
+Status LLMEngine::CheckScheduledStep(const std::vector<LLMReq> &req) const {
+  if (!step_pending_) {
+    MS_LOG(ERROR) << "No step is scheduled, call Schedule first";
+    return kLiteError;
+  }
+  auto &seqs = scheduled_step_.seqs;
+  if (req.size() != seqs.size()) {
+    MS_LOG(ERROR) << "Request num " << req.size() << " is not equal to the scheduled sequence num " << seqs.size();
+    return kLiteParamInvalid;
+  }
+  for (size_t i = 0; i < req.size(); i++) {
+    if (req[i].req_id != seqs[i].req_id) {
+      MS_LOG(ERROR) << "Request " << req[i].req_id << " at batch index " << i << " is not scheduled, expect request "
+                    << seqs[i].req_id;
+      return kLiteParamInvalid;
+    }
+  }
+  return kSuccess;
+}
+
 Status LLMEngine::Predict(const std::vector<LLMReq> &req, const std::vector<MSTensor> &inputs,
                           std::vector<MSTensor> *outputs) {
   if (plugin_ == nullptr) {
     MS_LOG(ERROR) << "LLMEngine plugin has not been created";
     return kLiteError;
   }
-  return plugin_->Predict(req, inputs, outputs);
+  std::unique_lock<std::mutex> lock(step_mutex_);
+  if (batch_scheduler_ == nullptr) {
+    lock.unlock();
+    return plugin_->Predict(req, inputs, outputs);
+  }
+  auto ret = CheckScheduledStep(req);
+  if (ret != kSuccess) {
+    return ret;
+  }
+  // a failed step stays scheduled, it can be run again.
+  ret = plugin_->Predict(req, inputs, outputs);
+  if (ret != kSuccess) {
+    return ret;
+  }
+  step_pending_ = false;
+  return batch_scheduler_->StepDone(scheduled_step_);
 }
 
 Status LLMEngine::CompleteRequest(const LLMReq &req) {
@@ -242,7 +382,16 @@ Status LLMEngine::CompleteRequest(const LLMReq &req) {
     MS_LOG(ERROR) << "LLMEngine plugin has not been created";
     return kLiteError;
   }
-  return plugin_->CompleteRequest(req);
+  auto ret = plugin_->CompleteRequest(req);
+  if (ret != kSuccess) {
+    return ret;
+  }
+  std::unique_lock<std::mutex> lock(step_mutex_);
+  if (batch_scheduler_ == nullptr) {
+    return kSuccess;
+  }
+  // the kv cache blocks of the request are released by the next Schedule.
+  return batch_scheduler_->CompleteRequest(req);
 }
 
 LLMEngineStatus LLMEngine::FetchStatus() {
@@ -250,7 +399,13 @@ LLMEngineStatus LLMEngine::FetchStatus() {
     MS_LOG(ERROR) << "LLMEngine plugin has not been created";
     return LLMEngineStatus();
   }
-  return plugin_->FetchStatus();
+  auto status = plugin_->FetchStatus();
+  // read without the step lock, which is held while a step runs, the kv cache guards its own state.
+  auto kv_cache = std::atomic_load(&kv_cache_);
+  if (kv_cache != nullptr) {
+    status.empty_max_prompt_kv = kv_cache->GetFreeBlockNum() * kv_cache->GetBlockSize();
+  }
+  return status;
 }
 
 Status LLMEngine::PreloadPromptPrefix(const LLMReq &req, const std::vector<MSTensor> &inputs) {
@@ -258,7 +413,21 @@ Status LLMEngine::PreloadPromptPrefix(const LLMReq &req, const std::vector<MSTen
     MS_LOG(ERROR) << "LLMEngine plugin has not been created";
     return kLiteError;
   }
-  return plugin_->PreloadPromptPrefix(req, inputs);
+  std::unique_lock<std::mutex> lock(step_mutex_);
+  if (batch_scheduler_ == nullptr) {
+    lock.unlock();
+    return plugin_->PreloadPromptPrefix(req, inputs);
+  }
+  auto ret = batch_scheduler_->AddPrefix(req.prefix_id, req.prompt_length);
+  if (ret != kSuccess) {
+    MS_LOG(ERROR) << "Failed to allocate kv cache blocks for prefix " << req.prefix_id;
+    return ret;
+  }
+  ret = plugin_->PreloadPromptPrefix(req, inputs);
+  if (ret != kSuccess) {
+    (void)batch_scheduler_->ReleasePrefix(req.prefix_id);
+  }
+  return ret;
 }
 
 Status LLMEngine::ReleasePromptPrefix(const LLMReq &req) {
@@ -266,7 +435,15 @@ Status LLMEngine::ReleasePromptPrefix(const LLMReq &req) {
     MS_LOG(ERROR) << "LLMEngine plugin has not been created";
     return kLiteError;
   }
-  return plugin_->ReleasePromptPrefix(req);
+  auto ret = plugin_->ReleasePromptPrefix(req);
+  if (ret != kSuccess) {
+    return ret;
+  }
+  std::unique_lock<std::mutex> lock(step_mutex_);
+  if (batch_scheduler_ == nullptr) {
+    return kSuccess;
+  }
+  return batch_scheduler_->ReleasePrefix(req.prefix_id);
 }
 
 Status LLMEngine::PullKV(const LLMReq &req) {
@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include "include/api/types.h"
 #include "include/api/status.h"
@@ -48,15 +49,36 @@ struct LLMEngineStatus {
   uint64_t empty_max_prompt_kv = 0;
 };
 
+struct LLMScheduledSeq {
+  uint64_t req_id = UINT64_MAX;
+  bool is_prefill = false;
+  // position of the first token computed in this step, tokens before it are already in the kv cache
+  size_t start_pos = 0;
+  size_t num_tokens = 0;
+  std::vector<int32_t> block_table;
+};
+
+struct LLMScheduleOutput {
+  std::vector<LLMScheduledSeq> seqs;
+  size_t num_batch_tokens = 0;
+  // sequences whose blocks were reclaimed in this step, they are recomputed when readmitted
+  std::vector<uint64_t> preempted;
+  // completed sequences released in this step
+  std::vector<uint64_t> retired;
+};
+
 enum LLMRole {
   kLLMRolePrompt = 0,
   kLLMRoleDecoder = 1,
 };
 
 class LLMEnginePluginBase;
+class LLMKVCacheManager;
+class LLMBatchScheduler;
 class MS_API LLMEngine {
  public:
   LLMEngine();
+  explicit LLMEngine(const std::shared_ptr<LLMEnginePluginBase> &plugin);
   ~LLMEngine() = default;
   Status Init(const std::vector<std::string> &model_paths, LLMRole role, uint64_t cluster_id,
               const std::map<std::string, std::string> &options, const std::string &batch_mode,
@@ -74,8 +96,21 @@ class MS_API LLMEngine {
   Status LinkClusters(const std::vector<LLMClusterInfo> &clusters, std::vector<Status> *rets, int32_t timeout = -1);
   Status UnlinkClusters(const std::vector<LLMClusterInfo> &clusters, std::vector<Status> *rets, int32_t timeout = -1);
 
+  // Continuous batching over a paged kv cache, enabled by the llm.KvCacheNumBlocks option. new_reqs join the batch,
+  // output gets the sequences of the next step and the batched Predict must run exactly them, in the same order.
+  Status Schedule(const std::vector<LLMReq> &new_reqs, LLMScheduleOutput *output);
+
  private:
+  Status InitBatchScheduler(std::map<std::string, std::string> *options);
+  Status CheckScheduledStep(const std::vector<LLMReq> &req) const;
+
   std::shared_ptr<LLMEnginePluginBase> plugin_ = nullptr;
+  std::shared_ptr<LLMKVCacheManager> kv_cache_ = nullptr;
+  std::shared_ptr<LLMBatchScheduler> batch_scheduler_ = nullptr;
+  // one step is scheduled and run at a time
+  std::mutex step_mutex_;
+  LLMScheduleOutput scheduled_step_;
+  bool step_pending_ = false;
 };
 }  // namespace mindspore
 #endif  // MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_LLM_ENGINE_H_
@@ -0,0 +1,307 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "extendrt/cxx_api/llm_engine/llm_kv_cache_manager.h"
+#include <cstring>
+#include <limits>
+#include <utility>
+#include "src/common/log_adapter.h"
+
+namespace mindspore {
+Status LLMKVCacheManager::Init(const LLMKVCacheConfig &config) {
+  if (config.num_layers == 0 || config.num_kv_heads == 0 || config.head_dim == 0 || config.block_size == 0 ||
+      config.num_blocks == 0 || config.data_type_size == 0) {
+    MS_LOG(ERROR) << "kv cache config is invalid, num layers: " << config.num_layers
+                  << " | num kv heads: " << config.num_kv_heads << " | head dim: " << config.head_dim
+                  << " | block size: " << config.block_size << " | num blocks: " << config.num_blocks
+                  << " | data type size: " << config.data_type_size;
+    return kLiteParamInvalid;
+  }
+  if (config.num_blocks > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    MS_LOG(ERROR) << "kv cache num blocks " << config.num_blocks << " is too large.";
+    return kLiteParamInvalid;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  config_ = config;
+  block_bytes_ = config_.block_size * config_.num_kv_heads * config_.head_dim * config_.data_type_size;
+  auto cache_bytes = block_bytes_ * config_.num_blocks * config_.num_layers;
+  if (block_bytes_ == 0 || cache_bytes / block_bytes_ != config_.num_blocks * config_.num_layers) {
+    MS_LOG(ERROR) << "kv cache size overflow, block bytes: " << block_bytes_ << " | num blocks: " << config_.num_blocks;
+    return kLiteParamInvalid;
+  }
+  key_cache_.assign(cache_bytes, 0);
+  value_cache_.assign(cache_bytes, 0);
+  ref_counts_.assign(config_.num_blocks, 0);
+  free_blocks_.clear();
+  for (size_t i = 0; i < config_.num_blocks; i++) {
+    free_blocks_.push_back(static_cast<int32_t>(i));
+  }
+  sequences_.clear();
+  prefixes_.clear();
+  MS_LOG(INFO) << "kv cache init done, block size: " << config_.block_size << " | num blocks: " << config_.num_blocks
+               << " | cache bytes: " << cache_bytes * 2;
+  return kSuccess;
+}
+
+size_t LLMKVCacheManager::GetBlockNum(size_t num_tokens) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return BlockNum(num_tokens);
+}
+
+size_t LLMKVCacheManager::GetFreeBlockNum() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return free_blocks_.size();
+}
+
+size_t LLMKVCacheManager::BlockNum(size_t num_tokens) const {
+  return (num_tokens + config_.block_size - 1) / config_.block_size;
+}
+
+int32_t LLMKVCacheManager::AllocateBlock() {
+  auto block_id = free_blocks_.front();
+  free_blocks_.pop_front();
+  ref_counts_[block_id] = 1;
+  return block_id;
+}
+
+void LLMKVCacheManager::FreeBlocks(const std::vector<int32_t> &blocks) {
+  for (auto block_id : blocks) {
+    if (ref_counts_[block_id] == 0) {
+      MS_LOG(WARNING) << "kv cache block " << block_id << " is already free.";
+      continue;
+    }
+    ref_counts_[block_id]--;
+    if (ref_counts_[block_id] == 0) {
+      // freed blocks are reused last in first out, they are more likely still in cache.
+      free_blocks_.push_front(block_id);
+    }
+  }
+}
+
+bool LLMKVCacheManager::NeedCopyOnWrite(const BlockList &seq) const {
+  if (seq.blocks.empty() || seq.num_tokens % config_.block_size == 0) {
+    return false;
+  }
+  return ref_counts_[seq.blocks.back()] > 1;
+}
+
+void LLMKVCacheManager::CopyBlock(int32_t src, int32_t dst) {
+  for (size_t layer = 0; layer < config_.num_layers; layer++) {
+    (void)memcpy(KeyBlock(layer, dst), KeyBlock(layer, src), block_bytes_);
+    (void)memcpy(ValueBlock(layer, dst), ValueBlock(layer, src), block_bytes_);
+  }
+}
+
+Status LLMKVCacheManager::AddPrefix(uint64_t prefix_id, size_t num_tokens) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (prefixes_.find(prefix_id) != prefixes_.end()) {
+    MS_LOG(ERROR) << "prefix " << prefix_id << " is already added.";
+    return kLiteLLMRepeatRequest;
+  }
+  auto block_num = BlockNum(num_tokens);
+  if (block_num > free_blocks_.size()) {
+    MS_LOG(ERROR) << "no enough kv cache blocks for prefix " << prefix_id << ", need: " << block_num
+                  << " | free: " << free_blocks_.size();
+    return kLiteMemoryFailed;
+  }
+  BlockList prefix;
+  prefix.num_tokens = num_tokens;
+  for (size_t i = 0; i < block_num; i++) {
+    prefix.blocks.push_back(AllocateBlock());
+  }
+  prefixes_[prefix_id] = std::move(prefix);
+  return kSuccess;
+}
+
+Status LLMKVCacheManager::ReleasePrefix(uint64_t prefix_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = prefixes_.find(prefix_id);
+  if (it == prefixes_.end()) {
+    MS_LOG(ERROR) << "prefix " << prefix_id << " is not found.";
+    return kLiteLLMKVCacheNotExist;
+  }
+  // sequences still referencing the prefix blocks keep them alive.
+  FreeBlocks(it->second.blocks);
+  prefixes_.erase(it);
+  return kSuccess;
+}
+
+bool LLMKVCacheManager::HasPrefix(uint64_t prefix_id) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return prefixes_.find(prefix_id) != prefixes_.end();
+}
+
+size_t LLMKVCacheManager::GetPrefixLength(uint64_t prefix_id) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = prefixes_.find(prefix_id);
+  return it == prefixes_.end() ? 0 : it->second.num_tokens;
+}
+
+Status LLMKVCacheManager::AddSequence(uint64_t req_id, uint64_t prefix_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (sequences_.find(req_id) != sequences_.end()) {
+    MS_LOG(ERROR) << "request " << req_id << " is already added.";
+    return kLiteLLMRepeatRequest;
+  }
+  BlockList seq;
+  if (prefix_id != UINT64_MAX) {
+    auto it = prefixes_.find(prefix_id);
+    if (it == prefixes_.end()) {
+      MS_LOG(ERROR) << "prefix " << prefix_id << " of request " << req_id << " is not found.";
+      return kLiteLLMKVCacheNotExist;
+    }
+    seq = it->second;
+    for (auto block_id : seq.blocks) {
+      ref_counts_[block_id]++;
+    }
+  }
+  sequences_[req_id] = std::move(seq);
+  return kSuccess;
+}
+
+size_t LLMKVCacheManager::GetAppendBlockNum(uint64_t req_id, size_t num_tokens) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return AppendBlockNum(req_id, num_tokens);
+}
+
+size_t LLMKVCacheManager::AppendBlockNum(uint64_t req_id, size_t num_tokens) const {
+  auto it = sequences_.find(req_id);
+  if (it == sequences_.end()) {
+    return BlockNum(num_tokens);
+  }
+  auto &seq = it->second;
+  auto block_num = BlockNum(seq.num_tokens + num_tokens) - seq.blocks.size();
+  if (num_tokens > 0 && NeedCopyOnWrite(seq)) {
+    block_num++;
+  }
+  return block_num;
+}
+
+Status LLMKVCacheManager::AppendSlots(uint64_t req_id, size_t num_tokens) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = sequences_.find(req_id);
+  if (it == sequences_.end()) {
+    MS_LOG(ERROR) << "request " << req_id << " is not found.";
+    return kLiteLLMKVCacheNotExist;
+  }
+  auto need = AppendBlockNum(req_id, num_tokens);
+  if (need > free_blocks_.size()) {
+    MS_LOG(INFO) << "no enough kv cache blocks for request " << req_id << ", need: " << need
+                 << " | free: " << free_blocks_.size();
+    return kLiteMemoryFailed;
+  }
+  auto &seq = it->second;
+  if (num_tokens > 0 && NeedCopyOnWrite(seq)) {
+    auto shared = seq.blocks.back();
+    auto block_id = AllocateBlock();
+    CopyBlock(shared, block_id);
+    ref_counts_[shared]--;
+    seq.blocks.back() = block_id;
+  }
+  seq.num_tokens += num_tokens;
+  while (seq.blocks.size() < BlockNum(seq.num_tokens)) {
+    seq.blocks.push_back(AllocateBlock());
+  }
+  return kSuccess;
+}
+
+Status LLMKVCacheManager::FreeSequence(uint64_t req_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = sequences_.find(req_id);
+  if (it == sequences_.end()) {
+    MS_LOG(ERROR) << "request " << req_id << " is not found.";
+    return kLiteLLMKVCacheNotExist;
+  }
+  FreeBlocks(it->second.blocks);
+  sequences_.erase(it);
+  return kSuccess;
+}
+
+bool LLMKVCacheManager::HasSequence(uint64_t req_id) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return sequences_.find(req_id) != sequences_.end();
+}
+
+size_t LLMKVCacheManager::GetSequenceLength(uint64_t req_id) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = sequences_.find(req_id);
+  return it == sequences_.end() ? 0 : it->second.num_tokens;
+}
+
+Status LLMKVCacheManager::GetBlockTable(uint64_t req_id, std::vector<int32_t> *block_table) const {
+  if (block_table == nullptr) {
+    MS_LOG(ERROR) << "block table is nullptr.";
+    return kLiteNullptr;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = sequences_.find(req_id);
+  if (it == sequences_.end()) {
+    MS_LOG(ERROR) << "request " << req_id << " is not found.";
+    return kLiteLLMKVCacheNotExist;
+  }
+  *block_table = it->second.blocks;
+  return kSuccess;
+}
+
+Status LLMKVCacheManager::GetSlotMapping(uint64_t req_id, size_t start, size_t num_tokens,
+                                         std::vector<int64_t> *slots) const {
+  if (slots == nullptr) {
+    MS_LOG(ERROR) << "slots is nullptr.";
+    return kLiteNullptr;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = sequences_.find(req_id);
+  if (it == sequences_.end()) {
+    MS_LOG(ERROR) << "request " << req_id << " is not found.";
+    return kLiteLLMKVCacheNotExist;
+  }
+  auto &seq = it->second;
+  if (start + num_tokens > seq.num_tokens) {
+    MS_LOG(ERROR) << "slots [" << start << ", " << start + num_tokens << ") of request " << req_id
+                  << " are out of range, sequence length: " << seq.num_tokens;
+    return kLiteOutOfTensorRange;
+  }
+  for (size_t pos = start; pos < start + num_tokens; pos++) {
+    auto block_id = seq.blocks[pos / config_.block_size];
+    slots->push_back(static_cast<int64_t>(block_id) * static_cast<int64_t>(config_.block_size) +
+                     static_cast<int64_t>(pos % config_.block_size));
+  }
+  return kSuccess;
+}
+
+size_t LLMKVCacheManager::GetBlockRefCount(int32_t block_id) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (block_id < 0 || static_cast<size_t>(block_id) >= ref_counts_.size()) {
+    return 0;
+  }
+  return ref_counts_[block_id];
+}
+
+uint8_t *LLMKVCacheManager::KeyBlock(size_t layer, int32_t block_id) {
+  if (layer >= config_.num_layers || block_id < 0 || static_cast<size_t>(block_id) >= config_.num_blocks) {
+    MS_LOG(ERROR) << "layer " << layer << " or block " << block_id << " is out of range.";
+    return nullptr;
+  }
+  return key_cache_.data() + (layer * config_.num_blocks + static_cast<size_t>(block_id)) * block_bytes_;
+}
+
+uint8_t *LLMKVCacheManager::ValueBlock(size_t layer, int32_t block_id) {
+  if (layer >= config_.num_layers || block_id < 0 || static_cast<size_t>(block_id) >= config_.num_blocks) {
+    MS_LOG(ERROR) << "layer " << layer << " or block " << block_id << " is out of range.";
+    return nullptr;
+  }
+  return value_cache_.data() + (layer * config_.num_blocks + static_cast<size_t>(block_id)) * block_bytes_;
+}
+}  // namespace mindspore
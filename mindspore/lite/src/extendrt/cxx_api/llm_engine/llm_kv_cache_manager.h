@@ -0,0 +1,103 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_LLM_ENGINE_LLM_KV_CACHE_MANAGER_H_
+#define MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_LLM_ENGINE_LLM_KV_CACHE_MANAGER_H_
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "include/api/status.h"
+
+namespace mindspore {
+struct LLMKVCacheConfig {
+  size_t num_layers = 1;
+  size_t num_kv_heads = 1;
+  size_t head_dim = 0;
+  // number of tokens held by one block
+  size_t block_size = 16;
+  size_t num_blocks = 0;
+  size_t data_type_size = sizeof(float);
+};
+
+// LLMKVCacheManager splits the KV cache into fixed size blocks of block_size tokens. Each sequence owns a block
+// table mapping its logical token positions to physical blocks, so sequences of any length share one pool without
+// padding. Blocks are refcounted: sequences started from a preloaded prompt prefix reference the prefix blocks
+// instead of copying them, and a shared block which is not full yet is copied before it is written.
+// The block layout is [layer][block][token][head][dim] for both key and value. Every call is atomic, a caller
+// checking free blocks before appending slots still serializes the pair itself, as LLMBatchScheduler does.
+class LLMKVCacheManager {
+ public:
+  LLMKVCacheManager() = default;
+  ~LLMKVCacheManager() = default;
+
+  Status Init(const LLMKVCacheConfig &config);
+
+  // allocate blocks for num_tokens prefix tokens, the caller writes the prefix KV through KeyBlock/ValueBlock.
+  Status AddPrefix(uint64_t prefix_id, size_t num_tokens);
+  Status ReleasePrefix(uint64_t prefix_id);
+  bool HasPrefix(uint64_t prefix_id) const;
+  size_t GetPrefixLength(uint64_t prefix_id) const;
+
+  // create an empty sequence, or one sharing all blocks of a registered prefix.
+  Status AddSequence(uint64_t req_id, uint64_t prefix_id = UINT64_MAX);
+  // reserve slots for the next num_tokens tokens of the sequence.
+  Status AppendSlots(uint64_t req_id, size_t num_tokens);
+  Status FreeSequence(uint64_t req_id);
+  bool HasSequence(uint64_t req_id) const;
+  size_t GetSequenceLength(uint64_t req_id) const;
+  Status GetBlockTable(uint64_t req_id, std::vector<int32_t> *block_table) const;
+  // physical slot (block_id * block_size + offset) of the tokens in [start, start + num_tokens).
+  Status GetSlotMapping(uint64_t req_id, size_t start, size_t num_tokens, std::vector<int64_t> *slots) const;
+
+  // number of free blocks needed before AppendSlots(req_id, num_tokens) can succeed, copy on write included.
+  size_t GetAppendBlockNum(uint64_t req_id, size_t num_tokens) const;
+  size_t GetBlockNum(size_t num_tokens) const;
+  size_t GetFreeBlockNum() const;
+  size_t GetTotalBlockNum() const { return config_.num_blocks; }
+  size_t GetBlockRefCount(int32_t block_id) const;
+  size_t GetBlockSize() const { return config_.block_size; }
+  // bytes of the key (or value) of one block in one layer.
+  size_t GetBlockBytes() const { return block_bytes_; }
+
+  uint8_t *KeyBlock(size_t layer, int32_t block_id);
+  uint8_t *ValueBlock(size_t layer, int32_t block_id);
+
+ private:
+  struct BlockList {
+    std::vector<int32_t> blocks;
+    size_t num_tokens = 0;
+  };
+
+  size_t BlockNum(size_t num_tokens) const;
+  size_t AppendBlockNum(uint64_t req_id, size_t num_tokens) const;
+  int32_t AllocateBlock();
+  void FreeBlocks(const std::vector<int32_t> &blocks);
+  bool NeedCopyOnWrite(const BlockList &seq) const;
+  void CopyBlock(int32_t src, int32_t dst);
+
+  LLMKVCacheConfig config_;
+  size_t block_bytes_ = 0;
+  std::vector<uint8_t> key_cache_;
+  std::vector<uint8_t> value_cache_;
+  std::vector<size_t> ref_counts_;
+  std::deque<int32_t> free_blocks_;
+  std::map<uint64_t, BlockList> sequences_;
+  std::map<uint64_t, BlockList> prefixes_;
+  mutable std::mutex mutex_;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_LLM_ENGINE_LLM_KV_CACHE_MANAGER_H_
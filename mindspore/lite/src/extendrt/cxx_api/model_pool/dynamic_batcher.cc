@@ -0,0 +1,307 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/extendrt/cxx_api/model_pool/dynamic_batcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "src/common/log_adapter.h"
+namespace mindspore {
+DynamicBatcher::~DynamicBatcher() { Stop(); }
+
+Status DynamicBatcher::Init(const DynamicBatchConfig &config, const std::vector<MSTensor> &model_inputs,
+                            const BatchPredictFunc &predict_func) {
+  if (config.max_batch_size <= 0 || config.batch_timeout_us < 0 || config.parallel_batch_num == 0) {
+    MS_LOG(ERROR) << "dynamic batch config is invalid, max batch size: " << config.max_batch_size
+                  << " | batch timeout us: " << config.batch_timeout_us
+                  << " | parallel batch num: " << config.parallel_batch_num;
+    return kLiteParamInvalid;
+  }
+  if (model_inputs.empty() || predict_func == nullptr) {
+    MS_LOG(ERROR) << "model inputs is empty or predict func is nullptr.";
+    return kLiteNullptr;
+  }
+  config_ = config;
+  model_inputs_ = model_inputs;
+  predict_func_ = predict_func;
+  buffers_.resize(config_.parallel_batch_num);
+  for (auto &buffer : buffers_) {
+    buffer.inputs.resize(model_inputs_.size());
+    for (size_t i = 0; i < model_inputs_.size(); i++) {
+      auto shape = model_inputs_[i].Shape();
+      if (shape.empty() || shape[0] <= 0) {
+        continue;
+      }
+      auto row_size = model_inputs_[i].DataSize() / static_cast<size_t>(shape[0]);
+      // the shape is static, the buffer for a full batch can be allocated now.
+      if (model_inputs_[i].ElementNum() > 0) {
+        buffer.inputs[i].resize(row_size * static_cast<size_t>(config_.max_batch_size));
+      }
+    }
+  }
+  stop_ = false;
+  for (size_t i = 0; i < config_.parallel_batch_num; i++) {
+    batch_threads_.push_back(std::thread(&DynamicBatcher::Run, this, i));
+  }
+  MS_LOG(INFO) << "dynamic batcher init done, max batch size: " << config_.max_batch_size
+               << " | batch timeout us: " << config_.batch_timeout_us
+               << " | parallel batch num: " << config_.parallel_batch_num;
+  return kSuccess;
+}
+
+bool DynamicBatcher::CanBatch(const std::vector<MSTensor> &inputs) const {
+  if (inputs.size() != model_inputs_.size()) {
+    return false;
+  }
+  int64_t batch = -1;
+  for (auto &input : inputs) {
+    auto shape = input.Shape();
+    if (shape.empty() || shape[0] <= 0 || input.Data() == nullptr) {
+      return false;
+    }
+    if (batch != -1 && batch != shape[0]) {
+      return false;
+    }
+    batch = shape[0];
+  }
+  return batch <= config_.max_batch_size;
+}
+
+Status DynamicBatcher::Predict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs) {
+  if (outputs == nullptr) {
+    MS_LOG(ERROR) << "outputs is nullptr.";
+    return kLiteNullptr;
+  }
+  BatchRequest request;
+  request.inputs = &inputs;
+  request.outputs = outputs;
+  request.batch = inputs.front().Shape()[0];
+  {
+    std::unique_lock<std::mutex> pending_lock(pending_mutex_);
+    if (stop_) {
+      MS_LOG(ERROR) << "dynamic batcher is stopped.";
+      return kLiteError;
+    }
+    pending_requests_.push_back(&request);
+    pending_condition_.notify_all();
+  }
+  std::unique_lock<std::mutex> done_lock(request.done_mutex);
+  while (!request.done) {
+    request.done_condition.wait(done_lock);
+  }
+  return request.status;
+}
+
+void DynamicBatcher::Stop() {
+  {
+    std::unique_lock<std::mutex> pending_lock(pending_mutex_);
+    stop_ = true;
+    pending_condition_.notify_all();
+  }
+  for (auto &batch_thread : batch_threads_) {
+    if (batch_thread.joinable()) {
+      batch_thread.join();
+    }
+  }
+  batch_threads_.clear();
+  std::vector<BatchRequest *> remaining;
+  {
+    std::unique_lock<std::mutex> pending_lock(pending_mutex_);
+    remaining.assign(pending_requests_.begin(), pending_requests_.end());
+    pending_requests_.clear();
+  }
+  FinishBatch(remaining, kLiteError);
+}
+
+bool DynamicBatcher::IsSameSample(const BatchRequest *first, const BatchRequest *request) const {
+  for (size_t i = 0; i < first->inputs->size(); i++) {
+    auto &first_input = first->inputs->at(i);
+    auto &input = request->inputs->at(i);
+    if (first_input.DataType() != input.DataType()) {
+      return false;
+    }
+    auto first_shape = first_input.Shape();
+    auto shape = input.Shape();
+    if (first_shape.size() != shape.size() ||
+        !std::equal(first_shape.begin() + 1, first_shape.end(), shape.begin() + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DynamicBatcher::CollectBatch(std::vector<BatchRequest *> *batch) {
+  std::unique_lock<std::mutex> collect_lock(collect_mutex_);
+  std::unique_lock<std::mutex> pending_lock(pending_mutex_);
+  while (pending_requests_.empty() && !stop_) {
+    pending_condition_.wait(pending_lock);
+  }
+  if (stop_) {
+    return false;
+  }
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(config_.batch_timeout_us);
+  auto first = pending_requests_.front();
+  int64_t rows = 0;
+  while (true) {
+    for (auto iter = pending_requests_.begin(); iter != pending_requests_.end();) {
+      auto request = *iter;
+      if (!IsSameSample(first, request)) {
+        ++iter;
+        continue;
+      }
+      if (rows + request->batch > config_.max_batch_size) {
+        break;
+      }
+      rows += request->batch;
+      batch->push_back(request);
+      iter = pending_requests_.erase(iter);
+    }
+    if (rows >= config_.max_batch_size || stop_ || std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    (void)pending_condition_.wait_until(pending_lock, deadline);
+  }
+  return true;
+}
+
+void DynamicBatcher::Run(size_t buffer_id) {
+  auto &buffer = buffers_[buffer_id];
+  while (!stop_) {
+    std::vector<BatchRequest *> batch;
+    if (!CollectBatch(&batch)) {
+      FinishBatch(batch, kLiteError);
+      break;
+    }
+    if (batch.empty()) {
+      continue;
+    }
+    auto status = RunBatch(batch, &buffer);
+    FinishBatch(batch, status);
+  }
+}
+
+Status DynamicBatcher::RunBatch(const std::vector<BatchRequest *> &batch, BatchBuffer *buffer) {
+  auto first = batch.front();
+  int64_t rows = 0;
+  for (auto request : batch) {
+    rows += request->batch;
+  }
+  std::vector<MSTensor> batch_inputs;
+  for (size_t i = 0; i < first->inputs->size(); i++) {
+    auto &sample = first->inputs->at(i);
+    auto row_size = sample.DataSize() / static_cast<size_t>(first->batch);
+    auto data_size = row_size * static_cast<size_t>(rows);
+    auto &input_buffer = buffer->inputs[i];
+    if (input_buffer.size() < data_size) {
+      input_buffer.resize(data_size);
+    }
+    size_t offset = 0;
+    for (auto request : batch) {
+      auto &input = request->inputs->at(i);
+      (void)memcpy(input_buffer.data() + offset, input.Data().get(), input.DataSize());
+      offset += input.DataSize();
+    }
+    auto shape = sample.Shape();
+    shape[0] = rows;
+    auto batch_input = MSTensor::CreateRefTensor(sample.Name(), sample.DataType(), shape, input_buffer.data(),
+                                                 data_size, false);
+    if (batch_input == nullptr) {
+      MS_LOG(ERROR) << "create batch input tensor failed.";
+      return kLiteNullptr;
+    }
+    batch_inputs.push_back(*batch_input);
+    MSTensor::DestroyTensorPtr(batch_input);
+  }
+  // scatter straight from the model outputs, they are not copied out of the worker first.
+  Status scatter_status = kLiteError;
+  auto scatter = [this, &batch, &scatter_status](const std::vector<MSTensor> &batch_outputs) {
+    scatter_status = ScatterOutputs(batch, batch_outputs);
+    return scatter_status;
+  };
+  auto status = predict_func_(batch_inputs, scatter);
+  if (status != kSuccess || scatter_status != kSuccess) {
+    MS_LOG(ERROR) << "dynamic batch predict failed, batch size: " << rows << " | request num: " << batch.size();
+    return status != kSuccess ? status : scatter_status;
+  }
+  return kSuccess;
+}
+
+Status DynamicBatcher::ScatterOutputs(const std::vector<BatchRequest *> &batch,
+                                      const std::vector<MSTensor> &batch_outputs) {
+  int64_t rows = 0;
+  for (auto request : batch) {
+    rows += request->batch;
+  }
+  for (auto &output : batch_outputs) {
+    auto shape = output.Shape();
+    if (shape.empty() || shape[0] != rows) {
+      MS_LOG(ERROR) << "output " << output.Name() << " is not batched along axis 0, output shape: " << shape
+                    << " | batch size: " << rows;
+      return kLiteError;
+    }
+  }
+  for (auto request : batch) {
+    if (!request->outputs->empty() && request->outputs->size() != batch_outputs.size()) {
+      MS_LOG(ERROR) << "user output size is: " << request->outputs->size()
+                    << ", but model output size is: " << batch_outputs.size();
+      return kLiteError;
+    }
+  }
+  std::vector<size_t> offsets(batch_outputs.size(), 0);
+  for (auto request : batch) {
+    bool user_data = !request->outputs->empty();
+    std::vector<MSTensor> request_outputs;
+    for (size_t i = 0; i < batch_outputs.size(); i++) {
+      auto &output = batch_outputs[i];
+      auto data = static_cast<const uint8_t *>(output.Data().get()) + offsets[i];
+      auto data_size = output.DataSize() / static_cast<size_t>(rows) * static_cast<size_t>(request->batch);
+      offsets[i] += data_size;
+      if (user_data) {
+        auto &user_output = request->outputs->at(i);
+        if (user_output.DataSize() != data_size) {
+          MS_LOG(ERROR) << "user output " << user_output.Name() << " size is: " << user_output.DataSize()
+                        << ", but need: " << data_size;
+          return kLiteError;
+        }
+        (void)memcpy(user_output.MutableData(), data, data_size);
+        continue;
+      }
+      auto shape = output.Shape();
+      shape[0] = request->batch;
+      auto copy_tensor = MSTensor::CreateTensor(output.Name(), output.DataType(), shape, data, data_size);
+      if (copy_tensor == nullptr) {
+        MS_LOG(ERROR) << "copy output tensor failed.";
+        return kLiteError;
+      }
+      request_outputs.push_back(*copy_tensor);
+      MSTensor::DestroyTensorPtr(copy_tensor);
+    }
+    if (!user_data) {
+      *request->outputs = request_outputs;
+    }
+  }
+  return kSuccess;
+}
+
+void DynamicBatcher::FinishBatch(const std::vector<BatchRequest *> &batch, Status status) {
+  for (auto request : batch) {
+    std::unique_lock<std::mutex> done_lock(request->done_mutex);
+    request->status = status;
+    request->done = true;
+    request->done_condition.notify_one();
+  }
+}
+}  // namespace mindspore
@@ -0,0 +1,97 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_MODEL_POOL_DYNAMIC_BATCHER_H_
+#define MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_MODEL_POOL_DYNAMIC_BATCHER_H_
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include "include/api/types.h"
+#include "include/api/status.h"
+namespace mindspore {
+struct DynamicBatchConfig {
+  bool enable = false;
+  // max number of rows (sum of request batch sizes) merged into one inference
+  int64_t max_batch_size = 8;
+  // max time the first request of a batch waits for others to join
+  int64_t batch_timeout_us = 1000;
+  // number of batches allowed in flight at the same time, usually the worker num
+  size_t parallel_batch_num = 1;
+};
+
+struct BatchRequest {
+  const std::vector<MSTensor> *inputs = nullptr;
+  std::vector<MSTensor> *outputs = nullptr;
+  int64_t batch = 0;
+  Status status = kSuccess;
+  bool done = false;
+  std::mutex done_mutex;
+  std::condition_variable done_condition;
+};
+
+// DynamicBatcher gathers small requests arriving within a latency budget, concatenates them along axis 0 into
+// reusable input buffers, runs one inference and scatters the output rows back to each request.
+class DynamicBatcher {
+ public:
+  using OutputsCallback = std::function<Status(const std::vector<MSTensor> &)>;
+  // runs the batch and calls the callback with the model outputs before they are released
+  using BatchPredictFunc = std::function<Status(const std::vector<MSTensor> &, const OutputsCallback &)>;
+
+  DynamicBatcher() = default;
+  ~DynamicBatcher();
+
+  Status Init(const DynamicBatchConfig &config, const std::vector<MSTensor> &model_inputs,
+              const BatchPredictFunc &predict_func);
+
+  // return false if the request can not be merged with others, the caller should run it directly.
+  bool CanBatch(const std::vector<MSTensor> &inputs) const;
+
+  Status Predict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs);
+
+  void Stop();
+
+ private:
+  struct BatchBuffer {
+    std::vector<std::vector<uint8_t>> inputs;
+  };
+
+  void Run(size_t buffer_id);
+  bool CollectBatch(std::vector<BatchRequest *> *batch);
+  bool IsSameSample(const BatchRequest *first, const BatchRequest *request) const;
+  Status RunBatch(const std::vector<BatchRequest *> &batch, BatchBuffer *buffer);
+  Status ScatterOutputs(const std::vector<BatchRequest *> &batch, const std::vector<MSTensor> &batch_outputs);
+  void FinishBatch(const std::vector<BatchRequest *> &batch, Status status);
+
+ private:
+  DynamicBatchConfig config_;
+  BatchPredictFunc predict_func_ = nullptr;
+  std::vector<MSTensor> model_inputs_;
+  std::vector<BatchBuffer> buffers_;
+  std::vector<std::thread> batch_threads_;
+
+  std::deque<BatchRequest *> pending_requests_;
+  std::mutex pending_mutex_;
+  std::condition_variable pending_condition_;
+  // only one thread gathers a batch at a time, the others run the batches already gathered.
+  std::mutex collect_mutex_;
+  std::atomic_bool stop_ = false;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_MODEL_POOL_DYNAMIC_BATCHER_H_
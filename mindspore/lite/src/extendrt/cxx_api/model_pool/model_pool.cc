@@ -792,6 +792,13 @@ Status ModelPool::CreateWorkers(const char *graph_buf, size_t size, const ModelP
       tensor_info.quant_param = tensor.QuantParams();
       outputs_info_.push_back(tensor_info);
     }
+    if (dynamic_batch_config_.enable) {
+      status = InitDynamicBatcher(inputs);
+      if (status != kSuccess) {
+        MS_LOG(ERROR) << "init dynamic batcher failed.";
+        return status;
+      }
+    }
   }
   return kSuccess;
 }
@@ -945,6 +952,11 @@ ModelPoolConfig ModelPool::Init(const std::shared_ptr<RunnerConfig> &runner_conf
     MS_LOG(WARNING) << "ParseSharedThreadPoolParam failed, Not use thread pool shared.";
     enable_shared_thread_pool_ = false;
   }
+  status = ParseDynamicBatchParam(runner_config);
+  if (status != kSuccess) {
+    MS_LOG(WARNING) << "ParseDynamicBatchParam failed, Not use dynamic batching.";
+    dynamic_batch_config_.enable = false;
+  }
   ModelPoolConfig model_pool_config = {};
   status = CanUseAllPhysicalResources();
   if (status != kSuccess) {
@@ -1052,7 +1064,7 @@ std::shared_ptr<ModelWorker> ModelPool::GetMaxWaitWorkerNum(int *max_wait_worker
 
 PredictTask *ModelPool::CreatePredictTask(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
                                           const MSKernelCallBack &before, const MSKernelCallBack &after,
-                                          size_t *task_id) {
+                                          size_t *task_id, const OutputsConsumer &consumer) {
   std::lock_guard<std::mutex> lock(task_id_mutex_);
   if (!free_tasks_id_.empty()) {
     auto item = free_tasks_id_.front();
@@ -1063,6 +1075,7 @@ PredictTask *ModelPool::CreatePredictTask(const std::vector<MSTensor> &inputs, s
     task->outputs = outputs;
     task->before = before;
     task->after = after;
+    task->consumer = consumer;
     return task;
   } else {
     return nullptr;
@@ -1115,12 +1128,21 @@ Status ModelPool::Predict(const std::vector<MSTensor> &inputs, std::vector<MSTen
       return kSuccess;
     }
   }
+  if (dynamic_batcher_ != nullptr && before == nullptr && after == nullptr && dynamic_batcher_->CanBatch(inputs)) {
+    return dynamic_batcher_->Predict(inputs, outputs);
+  }
+  return DispatchPredict(inputs, outputs, before, after);
+}
+
+Status ModelPool::DispatchPredict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
+                                  const MSKernelCallBack &before, const MSKernelCallBack &after,
+                                  const OutputsConsumer &consumer) {
   int max_wait_worker_node_id = 0;
   int max_wait_worker_num = 0;
   auto available_worker = GetMaxWaitWorkerNum(&max_wait_worker_node_id, &max_wait_worker_num);
   if (available_worker != nullptr) {
     // dispatch tasks directly to workers
-    auto ret = available_worker->Predict(inputs, outputs, before, after);
+    auto ret = available_worker->Predict(inputs, outputs, before, after, consumer);
     if (ret != kSuccess) {
       MS_LOG(ERROR) << "direct predict failed.";
       return kLiteError;
@@ -1130,7 +1152,7 @@ Status ModelPool::Predict(const std::vector<MSTensor> &inputs, std::vector<MSTen
   } else {
     // do predict
     size_t task_id;
-    auto task = CreatePredictTask(inputs, outputs, before, after, &task_id);
+    auto task = CreatePredictTask(inputs, outputs, before, after, &task_id, consumer);
     if (task == nullptr) {
       MS_LOG(ERROR) << "The number of waiting tasks in the queue exceeds the limit, ret=" << kLiteServiceDeny;
       return kLiteServiceDeny;
@@ -1144,6 +1166,10 @@ Status ModelPool::Predict(const std::vector<MSTensor> &inputs, std::vector<MSTen
 
 ModelPool::~ModelPool() {
   MS_LOG(INFO) << "free model pool.";
+  if (dynamic_batcher_ != nullptr) {
+    dynamic_batcher_->Stop();
+    dynamic_batcher_ = nullptr;
+  }
   if (predict_task_queue_ != nullptr) {
     predict_task_queue_->SetPredictTaskDone();
   }
@@ -1212,4 +1238,73 @@ Status ModelPool::ParseDeviceIds(const std::shared_ptr<RunnerConfig> &runner_con
   }
   return kSuccess;
 }
+
+Status ModelPool::ParseDynamicBatchParam(const std::shared_ptr<RunnerConfig> &runner_config) {
+  if (runner_config == nullptr) {
+    MS_LOG(INFO) << "runner config is nullptr.";
+    return kSuccess;
+  }
+  std::map<std::string, std::map<std::string, std::string>> config_info;
+  if (!runner_config->GetConfigPath().empty()) {
+    int ret = lite::GetAllSectionInfoFromConfigFile(runner_config->GetConfigPath(), &config_info);
+    if (ret != lite::RET_OK) {
+      MS_LOG(ERROR) << "GetAllSectionInfoFromConfigFile failed.";
+      return kLiteError;
+    }
+  }
+  // the section set by runner config overrides the one in config file
+  auto user_config_info = runner_config->GetConfigInfo();
+  if (user_config_info.find(lite::kDynamicBatchingSection) != user_config_info.end()) {
+    config_info[lite::kDynamicBatchingSection] = user_config_info[lite::kDynamicBatchingSection];
+  }
+  auto dynamic_batching = config_info.find(lite::kDynamicBatchingSection);
+  if (dynamic_batching == config_info.end()) {
+    MS_LOG(INFO) << "not set dynamic batching.";
+    return kSuccess;
+  }
+  auto &param = dynamic_batching->second;
+  if (param.find(lite::kEnableDynamicBatchingKey) == param.end() || param[lite::kEnableDynamicBatchingKey] != "true") {
+    MS_LOG(INFO) << "Not use dynamic batching";
+    return kSuccess;
+  }
+  if (param.find(lite::kMaxBatchSizeKey) != param.end() && !param[lite::kMaxBatchSizeKey].empty()) {
+    dynamic_batch_config_.max_batch_size = std::atoi(param[lite::kMaxBatchSizeKey].c_str());
+    if (dynamic_batch_config_.max_batch_size <= 0) {
+      MS_LOG(WARNING) << "max_batch_size is invalid, max_batch_size: " << dynamic_batch_config_.max_batch_size;
+      return kLiteParamInvalid;
+    }
+  }
+  if (param.find(lite::kBatchTimeoutUsKey) != param.end() && !param[lite::kBatchTimeoutUsKey].empty()) {
+    dynamic_batch_config_.batch_timeout_us = std::atoi(param[lite::kBatchTimeoutUsKey].c_str());
+    if (dynamic_batch_config_.batch_timeout_us < 0) {
+      MS_LOG(WARNING) << "batch_timeout_us is invalid, batch_timeout_us: " << dynamic_batch_config_.batch_timeout_us;
+      return kLiteParamInvalid;
+    }
+  }
+  dynamic_batch_config_.enable = true;
+  MS_LOG(INFO) << "use dynamic batching, max batch size: " << dynamic_batch_config_.max_batch_size
+               << " | batch timeout us: " << dynamic_batch_config_.batch_timeout_us;
+  return kSuccess;
+}
+
+Status ModelPool::InitDynamicBatcher(const std::vector<MSTensor> &model_inputs) {
+  dynamic_batcher_ = std::make_shared<DynamicBatcher>();
+  if (dynamic_batcher_ == nullptr) {
+    MS_LOG(ERROR) << "create dynamic batcher failed.";
+    return kLiteNullptr;
+  }
+  // keep every worker busy: one batch can be gathered while the others are running.
+  dynamic_batch_config_.parallel_batch_num = workers_num_;
+  auto predict_func = [this](const std::vector<MSTensor> &inputs, const OutputsConsumer &consumer) {
+    std::vector<MSTensor> outputs;
+    return DispatchPredict(inputs, &outputs, nullptr, nullptr, consumer);
+  };
+  auto status = dynamic_batcher_->Init(dynamic_batch_config_, model_inputs, predict_func);
+  if (status != kSuccess) {
+    MS_LOG(ERROR) << "dynamic batcher init failed.";
+    dynamic_batcher_ = nullptr;
+    return status;
+  }
+  return kSuccess;
+}
 }  // namespace mindspore
@@ -30,6 +30,7 @@
 #include "include/api/model_parallel_runner.h"
 #include "src/extendrt/cxx_api/model_pool/model_worker.h"
 #include "src/extendrt/cxx_api/model_pool/predict_task_queue.h"
+#include "src/extendrt/cxx_api/model_pool/dynamic_batcher.h"
 namespace mindspore {
 using ModelPoolConfig = std::vector<std::shared_ptr<WorkerConfig>>;
 
@@ -81,8 +82,13 @@ class ModelPool {
 
   std::shared_ptr<ModelWorker> GetMaxWaitWorkerNum(int *max_wait_worker_node_id, int *max_wait_worker_num);
 
+  Status DispatchPredict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
+                         const MSKernelCallBack &before, const MSKernelCallBack &after,
+                         const OutputsConsumer &consumer = nullptr);
+
   PredictTask *CreatePredictTask(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
-                                 const MSKernelCallBack &before, const MSKernelCallBack &after, size_t *task_id);
+                                 const MSKernelCallBack &before, const MSKernelCallBack &after, size_t *task_id,
+                                 const OutputsConsumer &consumer = nullptr);
 
   void UpdateFreeTaskId(size_t id);
 
@@ -121,6 +127,10 @@ class ModelPool {
 
   Status ParseDeviceIds(const std::shared_ptr<RunnerConfig> &runner_config, ModelPoolConfig *model_pool_config);
 
+  Status ParseDynamicBatchParam(const std::shared_ptr<RunnerConfig> &runner_config);
+
+  Status InitDynamicBatcher(const std::vector<MSTensor> &model_inputs);
+
  private:
   // different workers get tasks from different task queues.
   // currently task queues are distinguished according to different numa node numbers.
@@ -156,6 +166,10 @@ class ModelPool {
   // split batch
   bool is_user_data_ = false;
 
+  // merge small requests into one batch
+  DynamicBatchConfig dynamic_batch_config_;
+  std::shared_ptr<DynamicBatcher> dynamic_batcher_ = nullptr;
+
   bool can_use_all_physical_core_ = true;
   int can_use_core_num_ = -1;
   int all_core_num_ = -1;
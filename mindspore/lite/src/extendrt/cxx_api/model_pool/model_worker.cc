@@ -91,7 +91,7 @@ void ModelWorker::Run() {
     auto *outputs = task->outputs;
     auto before = task->before;
     auto after = task->after;
-    auto status = Predict(*inputs, outputs, before, after);
+    auto status = Predict(*inputs, outputs, before, after, task->consumer);
     if (status != kSuccess) {
       PrintWorkerInfo();
       MS_LOG(ERROR) << "model predict failed.";
@@ -212,7 +212,8 @@ Status ModelWorker::CopyOutputTensor(std::vector<MSTensor> model_outputs, std::v
 }
 
 Status ModelWorker::Predict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
-                            const MSKernelCallBack &before, const MSKernelCallBack &after) {
+                            const MSKernelCallBack &before, const MSKernelCallBack &after,
+                            const OutputsConsumer &consumer) {
   std::lock_guard<std::mutex> worker_lock(mtx_worker_);
   available_ = false;
   auto model_input = model_->GetInputs();
@@ -252,7 +253,13 @@ Status ModelWorker::Predict(const std::vector<MSTensor> &inputs, std::vector<MST
     available_ = true;
     return status;
   }
-  if (outputs->empty()) {
+  if (consumer != nullptr && outputs->empty()) {
+    status = consumer(model_outputs);
+    if (status != kSuccess) {
+      available_ = true;
+      return status;
+    }
+  } else if (outputs->empty()) {
     status = CopyOutputTensor(model_outputs, outputs);
     if (status != kSuccess) {
       available_ = true;
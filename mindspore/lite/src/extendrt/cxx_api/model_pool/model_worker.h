@@ -24,10 +24,13 @@
 #include <utility>
 #include <memory>
 #include <map>
+#include <functional>
 #include "include/api/model.h"
 #include "src/extendrt/cxx_api/model_pool/predict_task_queue.h"
 namespace mindspore {
 class PredictTaskQueue;
+// called with the model outputs while the worker still holds them, the tensors must not be kept after it returns.
+using OutputsConsumer = std::function<Status(const std::vector<MSTensor> &)>;
 
 struct WorkerConfig {
   std::map<std::string, std::map<std::string, std::string>> config_info;
@@ -52,7 +55,8 @@ class ModelWorker {
   std::vector<MSTensor> GetOutputs();
 
   Status Predict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
-                 const MSKernelCallBack &before = nullptr, const MSKernelCallBack &after = nullptr);
+                 const MSKernelCallBack &before = nullptr, const MSKernelCallBack &after = nullptr,
+                 const OutputsConsumer &consumer = nullptr);
 
   void WaitCreateWorkerDone();
 
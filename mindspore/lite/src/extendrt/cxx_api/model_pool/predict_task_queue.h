@@ -20,6 +20,7 @@
 #include <mutex>
 #include <memory>
 #include <vector>
+#include <functional>
 #include <condition_variable>
 #include "include/api/types.h"
 #include "include/api/status.h"
@@ -38,6 +39,8 @@ struct PredictTask {
   std::vector<MSTensor> *outputs;
   MSKernelCallBack before;
   MSKernelCallBack after;
+  // reads the model outputs in place instead of copying them to outputs
+  std::function<Status(const std::vector<MSTensor> &)> consumer = nullptr;
   std::atomic_bool ready;
   std::condition_variable task_done_condition;
   std::mutex task_done_mutex;
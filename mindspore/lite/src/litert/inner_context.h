@@ -34,6 +34,7 @@
 #endif
 #include "include/lite_types.h"
 #include "src/litert/infer_manager.h"
+#include "src/litert/kernel_tune_profile.h"
 
 namespace mindspore {
 class DeviceInfoContext;
@@ -140,6 +141,8 @@ struct MS_API InnerContext {
   InferChecker infer_checker_{InferCheckerOutput};
   // key is the precursor tensor's pointer, value is the group of successors' pointer.
   std::unordered_map<void *, std::set<void *>> link_info_{};
+  // kernel choices of the model being compiled, nullptr when kernel tune is not used.
+  std::shared_ptr<KernelTuneProfile> kernel_tune_profile_ = nullptr;
   const ExecEnv *GetExecEnv() const { return &exec_env_; }
 
  private:
@@ -556,7 +556,7 @@ int ConvolutionBaseCPUKernel::CheckAndGetWeightParam(int32_t *batch, int32_t *he
 
 void *ConvolutionBaseCPUKernel::GetConvPackWeightData(size_t data_size) {
   void *data = nullptr;
-  if (reinterpret_cast<ConvParameter *>(op_parameter_)->group_ > 1 ||
+  if (!is_sharing_pack_ || reinterpret_cast<ConvParameter *>(op_parameter_)->group_ > 1 ||
       (in_tensors_[1]->category() != lite::CONST_TENSOR && in_tensors_[1]->category() != lite::CONST_SCALAR)) {
     if (data_size == 0) {
       MS_LOG(ERROR) << "data size is zero.";
@@ -71,6 +71,8 @@ class ConvolutionBaseCPUKernel : public LiteKernel {
 
   int CheckAndGetWeightParam(int32_t *batch, int32_t *height, int32_t *width) const;
   void *GetConvPackWeightData(size_t data_size);
+  // a kernel which does not share its packed weight packs into its own memory.
+  void SetSharingPack(bool is_sharing) { is_sharing_pack_ = is_sharing; }
 
  protected:
   int InitConvWeightBias();
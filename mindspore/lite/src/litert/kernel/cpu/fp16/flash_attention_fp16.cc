@@ -0,0 +1,38 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "src/litert/kernel/cpu/fp16/flash_attention_fp16.h"
+#include "src/litert/kernel_registry.h"
+#include "nnacl/fp16/flash_attention_fp16.h"
+
+using mindspore::lite::KernelRegistrar;
+
+namespace mindspore::kernel {
+namespace {
+constexpr size_t kMaskIndex = 3;
+}  // namespace
+
+int FlashAttentionFp16CPUKernel::RunFlashAttention(float *workspace, int task_start, int task_end) {
+  auto q = reinterpret_cast<float16_t *>(in_tensors_[FIRST_INPUT]->data());
+  auto k = reinterpret_cast<float16_t *>(in_tensors_[SECOND_INPUT]->data());
+  auto v = reinterpret_cast<float16_t *>(in_tensors_[THIRD_INPUT]->data());
+  auto mask =
+    in_tensors_.size() > kMaskIndex ? reinterpret_cast<float16_t *>(in_tensors_[kMaskIndex]->data()) : nullptr;
+  auto out = reinterpret_cast<float16_t *>(out_tensors_.front()->data());
+  return FlashAttentionFp16(q, k, v, mask, out, workspace, param_, task_start, task_end);
+}
+
+REG_KERNEL(kCPU, kNumberTypeFloat16, PrimType_Inner_FlashAttention, LiteKernelCreator<FlashAttentionFp16CPUKernel>)
+}  // namespace mindspore::kernel
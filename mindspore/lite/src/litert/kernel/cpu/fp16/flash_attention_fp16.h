@@ -0,0 +1,38 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP16_FLASH_ATTENTION_FP16_H_
+#define MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP16_FLASH_ATTENTION_FP16_H_
+
+#include <vector>
+#include "src/litert/kernel/cpu/fp32/flash_attention_fp32.h"
+
+namespace mindspore::kernel {
+class FlashAttentionFp16CPUKernel : public FlashAttentionCPUKernel {
+ public:
+  FlashAttentionFp16CPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
+                              const std::vector<lite::Tensor *> &outputs, const lite::InnerContext *ctx)
+      : FlashAttentionCPUKernel(parameter, inputs, outputs, ctx) {
+    data_type_ = kNumberTypeFloat16;
+  }
+  ~FlashAttentionFp16CPUKernel() override = default;
+
+ protected:
+  int RunFlashAttention(float *workspace, int task_start, int task_end) override;
+};
+}  // namespace mindspore::kernel
+
+#endif  // MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP16_FLASH_ATTENTION_FP16_H_
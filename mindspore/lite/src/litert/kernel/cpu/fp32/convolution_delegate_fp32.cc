@@ -15,6 +15,8 @@
  */
 
 #include "src/litert/kernel/cpu/fp32/convolution_delegate_fp32.h"
+#include <algorithm>
+#include <cstring>
 #include "src/litert/kernel_registry.h"
 #include "src/litert/kernel/cpu/fp32/convolution_im2col_fp32.h"
 #include "src/litert/kernel/cpu/fp32/convolution_1x1_fp32.h"
@@ -29,6 +31,7 @@
 #include "nnacl/fp32/conv_sw_arm64_fp32.h"
 #include "schema/model_generated.h"
 #include "include/errorcode.h"
+#include "src/common/utils.h"
 #if defined(ENABLE_ARM) || (defined(ENABLE_SSE) && !defined(ENABLE_AVX))
 #include "src/litert/kernel/cpu/fp32/convolution_depthwise_3x3_fp32.h"
 #endif
@@ -50,6 +53,19 @@ using mindspore::schema::PrimitiveType_Conv2DFusion;
 namespace mindspore::kernel {
 namespace {
 constexpr int kMaxDwConvSWSize = 32;
+constexpr int kConvTuneWarmupTimes = 1;
+constexpr int kConvTuneRunTimes = 3;
+// variants of fp32 convolution in kernel tune profiles
+constexpr char kConvWinograd[] = "winograd";
+#ifdef ENABLE_AVX
+constexpr char kConvSW1x1[] = "sw_1x1";
+constexpr char kConvSWAVX[] = "sw_avx";
+#endif
+#ifdef ENABLE_ARM64
+constexpr char kConvSWARM64[] = "sw_arm64";
+#endif
+constexpr char kConv1x1[] = "1x1";
+constexpr char kConvIm2Col[] = "im2col";
 }  // namespace
 
 float *ConvolutionDelegateCPUKernel::CopyData(const lite::Tensor *tensor) {
@@ -235,28 +251,28 @@ bool ConvolutionDelegateCPUKernel::CheckAvxUseSWConv(const ConvParameter *conv_p
   return false;
 }
 
-kernel::LiteKernel *ConvolutionDelegateCPUKernel::CreateConv1x1MatmulKernel() {
-  auto conv_param = reinterpret_cast<ConvParameter *>(op_parameter_);
-
-  matmul_param_ = reinterpret_cast<MatMulParameter *>(malloc(sizeof(MatMulParameter)));
-  if (matmul_param_ == nullptr) {
+kernel::LiteKernel *ConvolutionDelegateCPUKernel::CreateConv1x1MatmulKernel(const ConvParameter *conv_param,
+                                                                            MatMulParameter **matmul_param) {
+  *matmul_param = reinterpret_cast<MatMulParameter *>(malloc(sizeof(MatMulParameter)));
+  if (*matmul_param == nullptr) {
     MS_LOG(WARNING) << "Memory allocation failed, Create Conv1x1 Matmul Kernel failed.";
     return nullptr;
   }
 
   MS_CHECK_INT_MUL_NOT_OVERFLOW(conv_param->output_h_, conv_param->output_w_, nullptr);
-  matmul_param_->row_ = conv_param->output_h_ * conv_param->output_w_;
-  matmul_param_->col_ = conv_param->output_channel_;
-  matmul_param_->deep_ = conv_param->input_channel_;
-  matmul_param_->batch = conv_param->input_batch_;
-  matmul_param_->op_parameter_ = conv_param->op_parameter_;
-  matmul_param_->act_type_ = conv_param->act_type_;
-  matmul_param_->a_transpose_ = false;
-  matmul_param_->b_transpose_ = true;
-  matmul_param_->a_const_ = input_const_;
-  matmul_param_->b_const_ = weight_const_;
+  auto param = *matmul_param;
+  param->row_ = conv_param->output_h_ * conv_param->output_w_;
+  param->col_ = conv_param->output_channel_;
+  param->deep_ = conv_param->input_channel_;
+  param->batch = conv_param->input_batch_;
+  param->op_parameter_ = conv_param->op_parameter_;
+  param->act_type_ = conv_param->act_type_;
+  param->a_transpose_ = false;
+  param->b_transpose_ = true;
+  param->a_const_ = input_const_;
+  param->b_const_ = weight_const_;
   auto kernel = new (std::nothrow) kernel::ConvolutionSW1x1CPUKernel(
-    reinterpret_cast<OpParameter *>(matmul_param_), in_tensors_, out_tensors_,
+    reinterpret_cast<OpParameter *>(param), in_tensors_, out_tensors_,
     static_cast<const lite::InnerContext *>(this->ms_context_), origin_weight_, origin_bias_);
   return kernel;
 }
@@ -274,7 +290,7 @@ kernel::LiteKernel *ConvolutionDelegateCPUKernel::CpuConvFp32NHWCKernelSelect()
 
 #ifdef ENABLE_AVX
   if (kernel == nullptr && CheckAvxUseSW1x1Conv(conv_param)) {
-    kernel = CreateConv1x1MatmulKernel();
+    kernel = CreateConv1x1MatmulKernel(conv_param, &matmul_param_);
   }
 
   if (kernel == nullptr && CheckAvxUseSWConv(conv_param)) {
@@ -306,12 +322,203 @@ kernel::LiteKernel *ConvolutionDelegateCPUKernel::CpuConvFp32NHWCKernelSelect()
   return kernel;
 }
 
+std::vector<std::string> ConvolutionDelegateCPUKernel::ConvKernelVariants(const ConvParameter *conv_param) {
+  // the variants the heuristics pick from for the convolution, im2col fits every convolution.
+  std::vector<std::string> variants;
+  int out_unit = 0;
+  if (CheckIfUseWinograd(&out_unit, conv_param)) {
+    variants.push_back(kConvWinograd);
+  }
+#ifdef ENABLE_AVX
+  if (CheckAvxUseSW1x1Conv(conv_param)) {
+    variants.push_back(kConvSW1x1);
+  }
+  if (CheckAvxUseSWConv(conv_param)) {
+    variants.push_back(kConvSWAVX);
+  }
+#endif
+#ifdef ENABLE_ARM64
+  if (CheckArm64UseSWConv(conv_param)) {
+    variants.push_back(kConvSWARM64);
+  }
+#endif
+  if (conv_param->kernel_h_ == 1 && conv_param->kernel_w_ == 1) {
+    variants.push_back(kConv1x1);
+  }
+  variants.push_back(kConvIm2Col);
+  return variants;
+}
+
+kernel::LiteKernel *ConvolutionDelegateCPUKernel::CreateConvKernelVariant(const std::string &variant,
+                                                                         ConvParameter *conv_param,
+                                                                         MatMulParameter **matmul_param) {
+  auto parameter = reinterpret_cast<OpParameter *>(conv_param);
+  auto ctx = static_cast<const lite::InnerContext *>(this->ms_context_);
+  if (variant == kConvWinograd) {
+    int out_unit = 0;
+    (void)CheckIfUseWinograd(&out_unit, conv_param);
+    return CreateConvolutionWinogradCPUKernel(parameter, in_tensors_, out_tensors_, ctx, out_unit, origin_weight_,
+                                              origin_bias_);
+  }
+#ifdef ENABLE_AVX
+  if (variant == kConvSW1x1) {
+    return CreateConv1x1MatmulKernel(conv_param, matmul_param);
+  }
+  if (variant == kConvSWAVX) {
+    return new (std::nothrow)
+      kernel::ConvolutionSWAVXCPUKernel(parameter, in_tensors_, out_tensors_, ctx, origin_weight_, origin_bias_);
+  }
+#endif
+#ifdef ENABLE_ARM64
+  if (variant == kConvSWARM64) {
+    return new (std::nothrow)
+      kernel::ConvolutionSWARM64CPUKernel(parameter, in_tensors_, out_tensors_, ctx, origin_weight_, origin_bias_);
+  }
+#endif
+  if (variant == kConv1x1) {
+    return new (std::nothrow)
+      kernel::Convolution1x1CPUKernel(parameter, in_tensors_, out_tensors_, ctx, origin_weight_, origin_bias_);
+  }
+  if (variant == kConvIm2Col) {
+    return CreateConvolutionIm2ColCPUKernel(parameter, in_tensors_, out_tensors_, ctx, origin_weight_, origin_bias_);
+  }
+  return nullptr;
+}
+
+int64_t ConvolutionDelegateCPUKernel::BenchmarkConvKernel(const std::string &variant, int thread_num) {
+  auto conv_param = reinterpret_cast<ConvParameter *>(malloc(sizeof(ConvParameter)));
+  if (conv_param == nullptr) {
+    MS_LOG(ERROR) << "malloc conv parameter failed.";
+    return -1;
+  }
+  (void)memcpy(conv_param, op_parameter_, sizeof(ConvParameter));
+  conv_param->op_parameter_.thread_num_ = thread_num;
+  MatMulParameter *matmul_param = nullptr;
+  auto kernel = CreateConvKernelVariant(variant, conv_param, &matmul_param);
+  if (kernel == nullptr) {
+    free(conv_param);
+    free(matmul_param);
+    return -1;
+  }
+  if (matmul_param != nullptr) {
+    // the matmul based kernel owns the matmul parameter only.
+    free(conv_param);
+  } else {
+    // the candidates pack different layouts of the same weight, they must not share the packed weight.
+    static_cast<ConvolutionBaseCPUKernel *>(kernel)->SetSharingPack(false);
+  }
+  kernel->set_name("tune_" + name_);
+  int64_t cost = -1;
+  if (kernel->Prepare() == RET_OK && kernel->ReSize() == RET_OK) {
+    bool run_ok = true;
+    for (int i = 0; i < kConvTuneWarmupTimes && run_ok; ++i) {
+      run_ok = kernel->Run() == RET_OK;
+    }
+    auto start = lite::GetTimeUs();
+    for (int i = 0; i < kConvTuneRunTimes && run_ok; ++i) {
+      run_ok = kernel->Run() == RET_OK;
+    }
+    if (run_ok) {
+      cost = static_cast<int64_t>(lite::GetTimeUs() - start) / kConvTuneRunTimes;
+    }
+  }
+  delete kernel;
+  return cost;
+}
+
+int ConvolutionDelegateCPUKernel::TuneConvKernel(const std::vector<std::string> &variants,
+                                                 lite::KernelTuneChoice *best) {
+  // the graph has not run yet, the candidates run on scratch input and output data.
+  std::vector<lite::Tensor *> scratch_tensors;
+  bool data_ready = true;
+  for (auto tensor : {in_tensors_.at(kInputIndex), out_tensors_.at(kOutputIndex)}) {
+    if (tensor->data() != nullptr) {
+      continue;
+    }
+    if (tensor->MallocData() != RET_OK) {
+      MS_LOG(ERROR) << "malloc scratch data of " << tensor->tensor_name() << " failed.";
+      data_ready = false;
+      break;
+    }
+    (void)memset(tensor->data(), 0, tensor->Size());
+    scratch_tensors.push_back(tensor);
+  }
+  int64_t best_cost = -1;
+  if (data_ready) {
+    auto thread_num = op_parameter_->thread_num_;
+    std::vector<int> thread_nums = {thread_num};
+    for (auto num : {thread_num / C2NUM, 1}) {
+      if (num >= 1 && std::find(thread_nums.begin(), thread_nums.end(), num) == thread_nums.end()) {
+        thread_nums.push_back(num);
+      }
+    }
+    for (const auto &variant : variants) {
+      for (auto num : thread_nums) {
+        auto cost = BenchmarkConvKernel(variant, num);
+        MS_LOG(INFO) << "tune " << name_ << ": " << variant << " with " << num << " threads costs " << cost << "us.";
+        if (cost >= 0 && (best_cost < 0 || cost < best_cost)) {
+          best_cost = cost;
+          best->variant = variant;
+          best->thread_num = num;
+        }
+      }
+    }
+  }
+  for (auto tensor : scratch_tensors) {
+    tensor->FreeData();
+  }
+  return best_cost < 0 ? RET_ERROR : RET_OK;
+}
+
+kernel::LiteKernel *ConvolutionDelegateCPUKernel::CpuConvFp32TunedKernelSelect() {
+  auto profile = static_cast<const lite::InnerContext *>(this->ms_context_)->kernel_tune_profile_;
+  if (profile == nullptr || op_parameter_->is_train_session_) {
+    return nullptr;
+  }
+  auto conv_param = reinterpret_cast<ConvParameter *>(op_parameter_);
+  auto variants = ConvKernelVariants(conv_param);
+  auto key = lite::KernelTuneProfile::GenerateKey(name_, in_tensors_.at(kInputIndex)->shape(),
+                                                  op_parameter_->thread_num_);
+  lite::KernelTuneChoice choice;
+  if (!profile->Find(key, &choice)) {
+    if (!profile->tune()) {
+      return nullptr;
+    }
+    if (TuneConvKernel(variants, &choice) != RET_OK) {
+      MS_LOG(WARNING) << "tune kernel of " << name_ << " failed, select by heuristics.";
+      return nullptr;
+    }
+    profile->Insert(key, choice);
+  }
+  if (std::find(variants.begin(), variants.end(), choice.variant) == variants.end() ||
+      choice.thread_num > op_parameter_->thread_num_) {
+    MS_LOG(WARNING) << "kernel choice " << choice.variant << " does not fit " << name_ << ", select by heuristics.";
+    return nullptr;
+  }
+  MS_LOG(INFO) << "select " << choice.variant << " with " << choice.thread_num << " threads for " << name_;
+  auto thread_num = op_parameter_->thread_num_;
+  op_parameter_->thread_num_ = choice.thread_num;
+  auto kernel = CreateConvKernelVariant(choice.variant, conv_param, &matmul_param_);
+  if (kernel == nullptr) {
+    op_parameter_->thread_num_ = thread_num;
+    return nullptr;
+  }
+  if (profile->tune() && matmul_param_ == nullptr) {
+    // the kernels of a tuning session may differ from those of other sessions of the model.
+    static_cast<ConvolutionBaseCPUKernel *>(kernel)->SetSharingPack(false);
+  }
+  return kernel;
+}
+
 kernel::LiteKernel *ConvolutionDelegateCPUKernel::CpuConvFp32KernelSelect() {
   kernel::LiteKernel *kernel = nullptr;
   if (out_tensors().front()->format() == NC4HW4) {
     kernel = CpuConvFp32NC4KernelSelect();
   } else {
-    kernel = CpuConvFp32NHWCKernelSelect();
+    kernel = CpuConvFp32TunedKernelSelect();
+    if (kernel == nullptr) {
+      kernel = CpuConvFp32NHWCKernelSelect();
+    }
   }
 
   if (kernel != nullptr) {
@@ -16,8 +16,10 @@
 #ifndef MINDSPORE_LITE_SRC_RUNTIME_KERNEL_CPU_FP32_CONVOLUTION_DELEGATE_FP32_H_
 #define MINDSPORE_LITE_SRC_RUNTIME_KERNEL_CPU_FP32_CONVOLUTION_DELEGATE_FP32_H_
 
+#include <string>
 #include <vector>
 #include "src/litert/lite_kernel.h"
+#include "src/litert/kernel_tune_profile.h"
 #include "nnacl/conv_parameter.h"
 #include "nnacl/matmul_parameter.h"
 #include "nnacl/op_base.h"
@@ -91,7 +93,14 @@ class ConvolutionDelegateCPUKernel : public LiteKernel {
   kernel::LiteKernel *CpuConvFp32KernelSelect();
   kernel::LiteKernel *CpuConvFp32NC4KernelSelect();
   kernel::LiteKernel *CpuConvFp32NHWCKernelSelect();
-  kernel::LiteKernel *CreateConv1x1MatmulKernel();
+  // select by the kernel tune profile of the context, nullptr when the node has no choice.
+  kernel::LiteKernel *CpuConvFp32TunedKernelSelect();
+  std::vector<std::string> ConvKernelVariants(const ConvParameter *conv_param);
+  kernel::LiteKernel *CreateConvKernelVariant(const std::string &variant, ConvParameter *conv_param,
+                                              MatMulParameter **matmul_param);
+  int TuneConvKernel(const std::vector<std::string> &variants, lite::KernelTuneChoice *best);
+  int64_t BenchmarkConvKernel(const std::string &variant, int thread_num);
+  kernel::LiteKernel *CreateConv1x1MatmulKernel(const ConvParameter *conv_param, MatMulParameter **matmul_param);
   bool CheckAvxUseSW1x1Conv(const ConvParameter *conv_param);
   bool CheckAvxUseSWConv(const ConvParameter *conv_param);
   // If inferShape process can't complete in Init part, initialization of weight and bis will be implemented in runtime
@@ -0,0 +1,174 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "src/litert/kernel/cpu/fp32/flash_attention_fp32.h"
+#include <algorithm>
+#include <cmath>
+#include "src/litert/kernel_registry.h"
+#include "include/errorcode.h"
+#include "src/common/log_adapter.h"
+#include "nnacl/fp32/flash_attention_fp32.h"
+
+using mindspore::lite::KernelRegistrar;
+using mindspore::lite::RET_ERROR;
+using mindspore::lite::RET_NULL_PTR;
+using mindspore::lite::RET_OK;
+using mindspore::lite::RET_PARAM_INVALID;
+
+namespace mindspore::kernel {
+namespace {
+constexpr size_t kBNSDRank = 4;
+constexpr size_t kMaskIndex = 3;
+// the key and value rows of one kv tile are kept within about 32KB, the usual L1 data cache size.
+constexpr int kKVTileBytes = 32 * 1024;
+constexpr int kMaxKVTile = 256;
+}  // namespace
+
+int FlashAttentionCPUKernel::Prepare() {
+  CHECK_LESS_RETURN(in_tensors_.size(), C3NUM);
+  CHECK_LESS_RETURN(out_tensors_.size(), 1);
+  CHECK_NULL_RETURN(param_);
+  for (size_t i = 0; i < in_tensors_.size(); i++) {
+    CHECK_NULL_RETURN(in_tensors_[i]);
+    if (in_tensors_[i]->data_type() != data_type_) {
+      MS_LOG(ERROR) << "FlashAttention input " << i << " is " << in_tensors_[i]->data_type() << ", but "
+                    << data_type_ << " is expected.";
+      return RET_PARAM_INVALID;
+    }
+  }
+  scale_ = param_->scale_;
+  if (!InferShapeDone()) {
+    return RET_OK;
+  }
+  return ReSize();
+}
+
+int FlashAttentionCPUKernel::CheckMask() {
+  auto mask_shape = in_tensors_[kMaskIndex]->shape();
+  if (mask_shape.size() != kBNSDRank) {
+    MS_LOG(ERROR) << "FlashAttention mask must be 4D, but got " << mask_shape.size() << "D.";
+    return RET_PARAM_INVALID;
+  }
+  param_->mask_batch_ = mask_shape[0];
+  param_->mask_head_ = mask_shape[1];
+  if ((param_->mask_batch_ != 1 && param_->mask_batch_ != param_->batch_) ||
+      (param_->mask_head_ != 1 && param_->mask_head_ != param_->q_head_num_) ||
+      mask_shape[C2NUM] != param_->q_seq_len_ || mask_shape[C3NUM] != param_->kv_seq_len_) {
+    MS_LOG(ERROR) << "FlashAttention mask shape " << mask_shape << " can not be broadcast to ["
+                  << param_->batch_ << ", " << param_->q_head_num_ << ", " << param_->q_seq_len_ << ", "
+                  << param_->kv_seq_len_ << "].";
+    return RET_PARAM_INVALID;
+  }
+  return RET_OK;
+}
+
+void FlashAttentionCPUKernel::InitTile() {
+  // every query row of a tile reuses the key/value tile loaded for the row before it.
+  param_->q_tile_ = MSMIN(C16NUM, param_->q_seq_len_);
+  int kv_tile = kKVTileBytes / (C2NUM * param_->head_size_ * static_cast<int>(sizeof(float)));
+  kv_tile = MSMIN(MSMAX(kv_tile / C8NUM * C8NUM, C8NUM), kMaxKVTile);
+  param_->kv_tile_ = MSMIN(kv_tile, param_->kv_seq_len_);
+}
+
+int FlashAttentionCPUKernel::ReSize() {
+  auto q_shape = in_tensors_[FIRST_INPUT]->shape();
+  auto k_shape = in_tensors_[SECOND_INPUT]->shape();
+  auto v_shape = in_tensors_[THIRD_INPUT]->shape();
+  if (q_shape.size() != kBNSDRank || k_shape.size() != kBNSDRank || v_shape != k_shape) {
+    MS_LOG(ERROR) << "FlashAttention needs q/k/v of layout BNSD and k/v of the same shape, q: " << q_shape
+                  << ", k: " << k_shape << ", v: " << v_shape;
+    return RET_PARAM_INVALID;
+  }
+  param_->batch_ = q_shape[0];
+  param_->q_head_num_ = q_shape[1];
+  param_->q_seq_len_ = q_shape[C2NUM];
+  param_->head_size_ = q_shape[C3NUM];
+  param_->kv_head_num_ = k_shape[1];
+  param_->kv_seq_len_ = k_shape[C2NUM];
+  if (k_shape[0] != param_->batch_ || k_shape[C3NUM] != param_->head_size_ || param_->kv_head_num_ <= 0 ||
+      param_->q_head_num_ % param_->kv_head_num_ != 0 || param_->q_seq_len_ <= 0 || param_->kv_seq_len_ <= 0 ||
+      param_->head_size_ <= 0) {
+    MS_LOG(ERROR) << "FlashAttention q shape " << q_shape << " does not match k/v shape " << k_shape;
+    return RET_PARAM_INVALID;
+  }
+  param_->mask_batch_ = 0;
+  param_->mask_head_ = 0;
+  if (in_tensors_.size() > kMaskIndex) {
+    auto ret = CheckMask();
+    if (ret != RET_OK) {
+      return ret;
+    }
+  }
+  param_->scale_ = scale_ != 0.0f ? scale_ : 1.0f / std::sqrt(static_cast<float>(param_->head_size_));
+  InitTile();
+  task_num_ = FlashAttentionTaskNum(param_);
+  thread_num_ = MSMAX(MSMIN(op_parameter_->thread_num_, task_num_), 1);
+  workspace_size_ = FlashAttentionWorkspaceSize(param_);
+  return RET_OK;
+}
+
+int FlashAttentionCPUKernel::RunFlashAttention(float *workspace, int task_start, int task_end) {
+  auto q = reinterpret_cast<float *>(in_tensors_[FIRST_INPUT]->data());
+  auto k = reinterpret_cast<float *>(in_tensors_[SECOND_INPUT]->data());
+  auto v = reinterpret_cast<float *>(in_tensors_[THIRD_INPUT]->data());
+  auto mask = in_tensors_.size() > kMaskIndex ? reinterpret_cast<float *>(in_tensors_[kMaskIndex]->data()) : nullptr;
+  auto out = reinterpret_cast<float *>(out_tensors_.front()->data());
+  return FlashAttentionFp32(q, k, v, mask, out, workspace, param_, task_start, task_end);
+}
+
+int FlashAttentionCPUKernel::DoFlashAttention(int task_id) {
+  int stride = UP_DIV(task_num_, thread_num_);
+  int task_start = task_id * stride;
+  int task_end = MSMIN(task_start + stride, task_num_);
+  if (task_start >= task_end) {
+    return RET_OK;
+  }
+  auto ret = RunFlashAttention(workspace_ + workspace_size_ * task_id, task_start, task_end);
+  if (ret != NNACL_OK) {
+    MS_LOG(ERROR) << "FlashAttention failed, task_id: " << task_id << ", ret: " << ret;
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
+int FlashAttentionRun(void *cdata, int task_id, float, float) {
+  CHECK_NULL_RETURN(cdata);
+  auto kernel = reinterpret_cast<FlashAttentionCPUKernel *>(cdata);
+  return kernel->DoFlashAttention(task_id);
+}
+
+int FlashAttentionCPUKernel::Run() {
+  for (size_t i = 0; i < in_tensors_.size(); i++) {
+    CHECK_NULL_RETURN(in_tensors_[i]->data());
+  }
+  CHECK_NULL_RETURN(out_tensors_.front()->data());
+  workspace_ =
+    reinterpret_cast<float *>(ms_context_->allocator->Malloc(workspace_size_ * thread_num_ * sizeof(float)));
+  if (workspace_ == nullptr) {
+    MS_LOG(ERROR) << "malloc FlashAttention workspace failed, size: " << workspace_size_ * thread_num_;
+    return RET_NULL_PTR;
+  }
+  auto ret = ParallelLaunch(this->ms_context_, FlashAttentionRun, this, thread_num_);
+  ms_context_->allocator->Free(workspace_);
+  workspace_ = nullptr;
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "FlashAttention run failed, ret: " << ret;
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
+REG_KERNEL(kCPU, kNumberTypeFloat32, PrimType_Inner_FlashAttention, LiteKernelCreator<FlashAttentionCPUKernel>)
+}  // namespace mindspore::kernel
@@ -0,0 +1,55 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP32_FLASH_ATTENTION_FP32_H_
+#define MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP32_FLASH_ATTENTION_FP32_H_
+
+#include <vector>
+#include "src/litert/lite_kernel.h"
+#include "nnacl/flash_attention_parameter.h"
+
+namespace mindspore::kernel {
+class FlashAttentionCPUKernel : public LiteKernel {
+ public:
+  FlashAttentionCPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
+                          const std::vector<lite::Tensor *> &outputs, const lite::InnerContext *ctx)
+      : LiteKernel(parameter, inputs, outputs, ctx) {
+    param_ = reinterpret_cast<FlashAttentionParameter *>(op_parameter_);
+  }
+  ~FlashAttentionCPUKernel() override = default;
+
+  int Prepare() override;
+  int ReSize() override;
+  int Run() override;
+  int DoFlashAttention(int task_id);
+
+ protected:
+  virtual int RunFlashAttention(float *workspace, int task_start, int task_end);
+  TypeId data_type_ = kNumberTypeFloat32;
+  FlashAttentionParameter *param_ = nullptr;
+
+ private:
+  int CheckMask();
+  void InitTile();
+
+  float scale_ = 0.0f;
+  int task_num_ = 0;
+  size_t workspace_size_ = 0;
+  float *workspace_ = nullptr;
+};
+}  // namespace mindspore::kernel
+
+#endif  // MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP32_FLASH_ATTENTION_FP32_H_
@@ -51,23 +51,64 @@ using mindspore::schema::PrimitiveType_MatMulFusion;
 namespace mindspore::kernel {
 int MatmulCPUKernel::Prepare() {
   CHECK_NULL_RETURN(matmul_base_);
+#ifdef ENABLE_SPARSE_COMPUTE
+  if (PrepareSparse() == RET_OK) {
+    return RET_OK;
+  }
+#endif
   matmul_base_->set_name(name_);
   matmul_base_->set_workspace(workspace());
   return matmul_base_->MatmulPrepare();
 }
 
 int MatmulCPUKernel::ReSize() {
+#ifdef ENABLE_SPARSE_COMPUTE
+  if (sparse_kernel_ != nullptr) {
+    return sparse_kernel_->ReSize();
+  }
+#endif
   CHECK_NULL_RETURN(matmul_base_);
   matmul_base_->set_workspace(workspace());
   return matmul_base_->MatmulReSize();
 }
 
 int MatmulCPUKernel::Run() {
+#ifdef ENABLE_SPARSE_COMPUTE
+  if (sparse_kernel_ != nullptr) {
+    return sparse_kernel_->Run();
+  }
+#endif
   CHECK_NULL_RETURN(matmul_base_);
   matmul_base_->set_workspace(workspace());
   return matmul_base_->Run();
 }
 
+#ifdef ENABLE_SPARSE_COMPUTE
+int MatmulCPUKernel::PrepareSparse() {
+  // the dense kernel keeps the packed or trainable weights, only a sparse constant weight changes the kernel.
+  // the sparse kernel checks the weight density itself when preparing, so the weight is scanned once.
+  if (op_parameter_->is_train_session_ || weight_is_packed_) {
+    return lite::RET_NOT_SUPPORT;
+  }
+  auto kernel =
+    new (std::nothrow) MatmulSparseStructuredCPUKernel(op_parameter_, in_tensors_, out_tensors_, ms_context_);
+  if (kernel == nullptr) {
+    return lite::RET_NOT_SUPPORT;
+  }
+  kernel->set_name(name_);
+  auto ret = kernel->Prepare();
+  if (ret != RET_OK) {
+    MS_LOG(INFO) << name_ << " falls back to the dense matmul, ret: " << ret;
+    kernel->set_parameter(nullptr);
+    delete kernel;
+    return ret;
+  }
+  MS_LOG(INFO) << name_ << " runs the sparse matmul, weight format: " << kernel->GetWeightFormat();
+  sparse_kernel_ = kernel;
+  return RET_OK;
+}
+#endif
+
 MatmulFp32BaseCPUKernel *CreateMatmulFp32CPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
                                                    const std::vector<lite::Tensor *> &outputs,
                                                    const lite::InnerContext *ctx) {
@@ -113,6 +154,7 @@ MatmulFp32BaseCPUKernel *CreateMatmulFp32CPUKernel(OpParameter *parameter, const
 
 int MatmulCPUKernel::PreparePackedWeight(const lite::Tensor *tensor) {
   matmul_base_->SetWeightIsPacked(true);
+  weight_is_packed_ = true;
   return RET_OK;
 }
 }  // namespace mindspore::kernel
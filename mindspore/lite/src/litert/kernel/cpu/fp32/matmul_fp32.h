@@ -20,6 +20,9 @@
 #include <vector>
 #include "nnacl/matmul_parameter.h"
 #include "src/litert/kernel/cpu/fp32/matmul_fp32_base.h"
+#ifdef ENABLE_SPARSE_COMPUTE
+#include "src/litert/kernel/cpu/fp32_sparse/matmul_sparse_structured_fp32.h"
+#endif
 
 namespace mindspore::kernel {
 MatmulFp32BaseCPUKernel *CreateMatmulFp32CPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
@@ -33,6 +36,13 @@ class MatmulCPUKernel : public LiteKernel {
     matmul_base_ = CreateMatmulFp32CPUKernel(parameter, inputs, outputs, ctx);
   }
   ~MatmulCPUKernel() {
+#ifdef ENABLE_SPARSE_COMPUTE
+    if (sparse_kernel_ != nullptr) {
+      sparse_kernel_->set_parameter(nullptr);  // op_parameter will be freed by matmul_base_
+      delete sparse_kernel_;
+      sparse_kernel_ = nullptr;
+    }
+#endif
     if (matmul_base_ != nullptr) {
       op_parameter_ = nullptr;  // op_parameter will be freed in LiteKernel
       delete matmul_base_;
@@ -45,6 +55,11 @@ class MatmulCPUKernel : public LiteKernel {
     if (matmul_base_ != nullptr) {
       matmul_base_->set_in_tensors(in_tensors);
     }
+#ifdef ENABLE_SPARSE_COMPUTE
+    if (sparse_kernel_ != nullptr) {
+      sparse_kernel_->set_in_tensors(in_tensors);
+    }
+#endif
   }
 
   void set_in_tensor(lite::Tensor *in_tensor, size_t index) override {
@@ -53,6 +68,11 @@ class MatmulCPUKernel : public LiteKernel {
     if (matmul_base_ != nullptr) {
       matmul_base_->set_in_tensor(in_tensor, index);
     }
+#ifdef ENABLE_SPARSE_COMPUTE
+    if (sparse_kernel_ != nullptr) {
+      sparse_kernel_->set_in_tensor(in_tensor, index);
+    }
+#endif
   }
 
   void set_out_tensors(const std::vector<lite::Tensor *> &out_tensors) override {
@@ -60,6 +80,11 @@ class MatmulCPUKernel : public LiteKernel {
     if (matmul_base_ != nullptr) {
       matmul_base_->set_out_tensors(out_tensors);
     }
+#ifdef ENABLE_SPARSE_COMPUTE
+    if (sparse_kernel_ != nullptr) {
+      sparse_kernel_->set_out_tensors(out_tensors);
+    }
+#endif
   }
 
   void set_out_tensor(lite::Tensor *out_tensor, size_t index) override {
@@ -68,6 +93,11 @@ class MatmulCPUKernel : public LiteKernel {
     if (matmul_base_ != nullptr) {
       matmul_base_->set_out_tensor(out_tensor, index);
     }
+#ifdef ENABLE_SPARSE_COMPUTE
+    if (sparse_kernel_ != nullptr) {
+      sparse_kernel_->set_out_tensor(out_tensor, index);
+    }
+#endif
   }
 
   // Train API
@@ -91,7 +121,12 @@ class MatmulCPUKernel : public LiteKernel {
   int PreparePackedWeight(const lite::Tensor *tensor) override;
 
  private:
+#ifdef ENABLE_SPARSE_COMPUTE
+  int PrepareSparse();
+  MatmulSparseStructuredCPUKernel *sparse_kernel_ = nullptr;
+#endif
   MatmulFp32BaseCPUKernel *matmul_base_ = nullptr;
+  bool weight_is_packed_ = false;
 };
 }  // namespace mindspore::kernel
 #endif  // MINDSPORE_LITE_SRC_RUNTIME_KERNEL_CPU_FP32_MATMUL_FP32_H_
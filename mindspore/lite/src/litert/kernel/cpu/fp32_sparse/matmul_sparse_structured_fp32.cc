@@ -0,0 +1,285 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/litert/kernel/cpu/fp32_sparse/matmul_sparse_structured_fp32.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "include/errorcode.h"
+#include "nnacl/errorcode.h"
+#include "src/common/log_adapter.h"
+#include "src/litert/pack_weight_manager.h"
+
+using mindspore::lite::RET_ERROR;
+using mindspore::lite::RET_NOT_SUPPORT;
+using mindspore::lite::RET_NULL_PTR;
+using mindspore::lite::RET_OK;
+
+namespace mindspore::kernel {
+namespace {
+struct SparseFormatCandidate {
+  int format;
+  int block_k;
+  int block_n;
+};
+
+// 1x4 blocks keep most of the unstructured pruned weights, 4x4 blocks cost less index per value, the n:m formats
+// take the n of the pruning pattern found in the weight.
+constexpr SparseFormatCandidate kSparseFormatCandidates[] = {{SparseWeightFormat_Block, C1NUM, C4NUM},
+                                                             {SparseWeightFormat_Block, C4NUM, C4NUM},
+                                                             {SparseWeightFormat_NM, C4NUM, 0},
+                                                             {SparseWeightFormat_NM, C8NUM, 0},
+                                                             {SparseWeightFormat_NM, C16NUM, 0}};
+}  // namespace
+
+MatmulSparseStructuredCPUKernel::~MatmulSparseStructuredCPUKernel() {
+  if (packed_weight_ != nullptr) {
+    lite::PackWeightManager::GetInstance()->Free(packed_weight_);
+    packed_weight_ = nullptr;
+  }
+}
+
+bool MatmulSparseStructuredCPUKernel::IsSparseWeight(const MatMulParameter *param,
+                                                     const std::vector<lite::Tensor *> &inputs) {
+  if (param == nullptr || inputs.size() < C2NUM) {
+    return false;
+  }
+  if (param->act_type_ != ActType_No && param->act_type_ != ActType_Relu && param->act_type_ != ActType_Relu6) {
+    return false;
+  }
+  auto weight = inputs[SECOND_INPUT];
+  if (!weight->IsConst() || weight->data() == nullptr || weight->data_type() != kNumberTypeFloat32) {
+    return false;
+  }
+  auto shape = weight->shape();
+  if (shape.size() < C2NUM) {
+    return false;
+  }
+  for (size_t i = 0; i + C2NUM < shape.size(); i++) {
+    if (shape[i] != 1) {
+      return false;
+    }
+  }
+  if (inputs.size() > C2NUM && (!inputs[THIRD_INPUT]->IsConst() || inputs[THIRD_INPUT]->data() == nullptr)) {
+    return false;
+  }
+  auto size = weight->ElementsNum();
+  if (size <= 0) {
+    return false;
+  }
+  // the nonzero count is an integer, so it is at most threshold * size exactly when it is below the floor of it plus 1.
+  auto max_non_zero = static_cast<int>(std::floor(kSparseNMDensityThreshold * size)) + 1;
+  return SparseNonZeroLess(reinterpret_cast<const float *>(weight->data()), size, max_non_zero);
+}
+
+int MatmulSparseStructuredCPUKernel::ChooseFormat(const float *weight_data, int stride_k, int stride_n) {
+  int64_t best_values = INT64_MAX;
+  auto dense_values = static_cast<float>(deep_) * static_cast<float>(col_);
+  for (auto &candidate : kSparseFormatCandidates) {
+    int64_t values = 0;
+    int block_n = candidate.block_n;
+    bool accepted = false;
+    if (candidate.format == SparseWeightFormat_Block) {
+      auto block_num = SparseBlockNum(weight_data, deep_, col_, stride_k, stride_n, candidate.block_k, block_n);
+      values = static_cast<int64_t>(block_num) * candidate.block_k * block_n;
+      accepted = static_cast<float>(values) < kSparseBlockDensityThreshold * dense_values;
+    } else {
+      // the threshold is taken on the n:m pattern found in the weight, the packed values also count the padding of
+      // a deep not divisible by m.
+      block_n = std::max(SparseNMKeepNum(weight_data, deep_, col_, stride_k, stride_n, candidate.block_k), 1);
+      values = static_cast<int64_t>(UP_DIV(deep_, candidate.block_k)) * block_n * col_;
+      accepted = static_cast<float>(block_n) <= kSparseNMDensityThreshold * static_cast<float>(candidate.block_k);
+    }
+    // ties go to the block format, its tile loads are shared by four columns.
+    if (accepted && values < best_values) {
+      best_values = values;
+      format_ = candidate.format;
+      block_k_ = candidate.block_k;
+      block_n_ = block_n;
+    }
+  }
+  if (best_values == INT64_MAX) {
+    format_ = SparseWeightFormat_None;
+    MS_LOG(INFO) << name_ << " weight has no block or n:m structure.";
+    return RET_NOT_SUPPORT;
+  }
+  MS_LOG(INFO) << name_ << " sparse weight format: " << format_ << ", block: " << block_k_ << "x" << block_n_
+               << ", packed density: " << static_cast<float>(best_values) / dense_values;
+  if (format_ == SparseWeightFormat_Block) {
+    auto block_num = static_cast<int>(best_values / (block_k_ * block_n_));
+    packed_size_ = SparseBlockPackSize(col_, block_k_, block_n_, block_num);
+  } else {
+    packed_size_ = SparseNMPackSize(deep_, col_, block_n_, block_k_);
+  }
+  return RET_OK;
+}
+
+int MatmulSparseStructuredCPUKernel::PackWeight() {
+  auto weight_data = reinterpret_cast<const float *>(in_tensors_[SECOND_INPUT]->data());
+  CHECK_NULL_RETURN(weight_data);
+  int stride_k = params_->b_transpose_ ? 1 : col_;
+  int stride_n = params_->b_transpose_ ? deep_ : 1;
+  auto ret = ChooseFormat(weight_data, stride_k, stride_n);
+  if (ret != RET_OK) {
+    return ret;
+  }
+  bool is_packed = false;
+  packed_weight_ = lite::PackWeightManager::GetInstance()->GetPackData(weight_data, packed_size_, &is_packed);
+  if (packed_weight_ == nullptr) {
+    MS_LOG(ERROR) << "malloc sparse packed weight failed, size: " << packed_size_;
+    return RET_NULL_PTR;
+  }
+  if (!is_packed) {
+    if (format_ == SparseWeightFormat_Block) {
+      ret = SparseBlockPack(weight_data, deep_, col_, stride_k, stride_n, block_k_, block_n_, packed_weight_,
+                            packed_size_);
+    } else {
+      ret = SparseNMPack(weight_data, deep_, col_, stride_k, stride_n, block_n_, block_k_, packed_weight_,
+                         packed_size_);
+    }
+    if (ret != NNACL_OK) {
+      MS_LOG(ERROR) << "pack sparse weight failed, ret: " << ret;
+      return RET_ERROR;
+    }
+  }
+  ret = SparseStructuredWeightInit(packed_weight_, packed_size_, &weight_);
+  if (ret != NNACL_OK || weight_.deep_ != deep_ || weight_.col_ != col_) {
+    MS_LOG(ERROR) << "sparse packed weight is invalid, ret: " << ret;
+    return RET_ERROR;
+  }
+  pack_deep_ = SparseStructuredPackDeep(&weight_);
+  return RET_OK;
+}
+
+int MatmulSparseStructuredCPUKernel::Prepare() {
+  CHECK_LESS_RETURN(in_tensors_.size(), C2NUM);
+  CHECK_LESS_RETURN(out_tensors_.size(), 1);
+  CHECK_NULL_RETURN(params_);
+  if (!IsSparseWeight(params_, in_tensors_)) {
+    MS_LOG(INFO) << name_ << " weight is not sparse enough.";
+    return RET_NOT_SUPPORT;
+  }
+  auto b_shape = in_tensors_[SECOND_INPUT]->shape();
+  auto b_rank = b_shape.size();
+  deep_ = params_->b_transpose_ ? b_shape[b_rank - 1] : b_shape[b_rank - C2NUM];
+  col_ = params_->b_transpose_ ? b_shape[b_rank - C2NUM] : b_shape[b_rank - 1];
+  if (in_tensors_.size() > C2NUM) {
+    if (in_tensors_[THIRD_INPUT]->ElementsNum() != col_) {
+      MS_LOG(INFO) << name_ << " does not support broadcast bias.";
+      return RET_NOT_SUPPORT;
+    }
+    auto bias_data = reinterpret_cast<const float *>(in_tensors_[THIRD_INPUT]->data());
+    bias_.assign(bias_data, bias_data + col_);
+  }
+  auto ret = PackWeight();
+  if (ret != RET_OK) {
+    return ret;
+  }
+  if (!InferShapeDone()) {
+    return RET_OK;
+  }
+  return ReSize();
+}
+
+int MatmulSparseStructuredCPUKernel::ReSize() {
+  auto a_shape = in_tensors_[FIRST_INPUT]->shape();
+  auto a_rank = a_shape.size();
+  if (a_rank < C2NUM) {
+    MS_LOG(ERROR) << name_ << " input rank " << a_rank << " is less than 2.";
+    return RET_ERROR;
+  }
+  row_ = params_->a_transpose_ ? a_shape[a_rank - 1] : a_shape[a_rank - C2NUM];
+  auto a_deep = params_->a_transpose_ ? a_shape[a_rank - C2NUM] : a_shape[a_rank - 1];
+  if (a_deep != deep_) {
+    MS_LOG(ERROR) << name_ << " input deep " << a_deep << " does not match weight deep " << deep_;
+    return RET_ERROR;
+  }
+  batch_ = 1;
+  for (size_t i = 0; i + C2NUM < a_rank; i++) {
+    batch_ *= a_shape[i];
+  }
+  if (out_tensors_.front()->ElementsNum() != batch_ * row_ * col_) {
+    MS_LOG(ERROR) << name_ << " output size " << out_tensors_.front()->ElementsNum() << " is not "
+                  << batch_ * row_ * col_;
+    return RET_ERROR;
+  }
+  row_tile_num_ = UP_DIV(row_, SPARSE_ROW_TILE);
+  auto tile_num = batch_ * row_tile_num_;
+  // few row tiles, e.g. decoding, split the columns too so all threads have work.
+  col_part_num_ = 1;
+  if (tile_num > 0 && tile_num < op_parameter_->thread_num_) {
+    col_part_num_ = std::min(UP_DIV(op_parameter_->thread_num_, tile_num), UP_DIV(col_, SPARSE_COL_CHUNK));
+  }
+  col_part_size_ = UP_ROUND(UP_DIV(col_, col_part_num_), SPARSE_COL_CHUNK);
+  col_part_num_ = UP_DIV(col_, col_part_size_);
+  task_num_ = tile_num * col_part_num_;
+  thread_count_ = std::max(std::min(op_parameter_->thread_num_, task_num_), 1);
+  thread_buffer_size_ = static_cast<size_t>(pack_deep_ + SPARSE_COL_CHUNK) * SPARSE_ROW_TILE;
+  return RET_OK;
+}
+
+int MatmulSparseStructuredCPUKernel::DoSparseMatmul(int task_id) {
+  auto a = reinterpret_cast<const float *>(in_tensors_[FIRST_INPUT]->data());
+  auto c = reinterpret_cast<float *>(out_tensors_.front()->data());
+  float *a_tile = buffer_ + static_cast<size_t>(task_id) * thread_buffer_size_;
+  float *col_buf = a_tile + static_cast<size_t>(pack_deep_) * SPARSE_ROW_TILE;
+  int stride_row = params_->a_transpose_ ? 1 : deep_;
+  int stride_k = params_->a_transpose_ ? row_ : 1;
+  const float *bias = bias_.empty() ? nullptr : bias_.data();
+  for (int task = task_id; task < task_num_; task += thread_count_) {
+    int tile = task / col_part_num_;
+    int col_start = (task % col_part_num_) * col_part_size_;
+    int col_end = std::min(col_start + col_part_size_, col_);
+    int batch = tile / row_tile_num_;
+    int row_start = (tile % row_tile_num_) * SPARSE_ROW_TILE;
+    int rows = std::min(SPARSE_ROW_TILE, row_ - row_start);
+    const float *src = a + static_cast<size_t>(batch) * row_ * deep_ + row_start * stride_row;
+    SparsePackInputTile(src, a_tile, rows, deep_, pack_deep_, stride_row, stride_k);
+    float *dst = c + (static_cast<size_t>(batch) * row_ + row_start) * col_;
+    SparseStructuredMatmulTile(a_tile, &weight_, bias, dst, col_buf, rows, col_start, col_end, col_,
+                               static_cast<ActType>(params_->act_type_));
+  }
+  return RET_OK;
+}
+
+int SparseStructuredMatmulRun(void *cdata, int task_id, float, float) {
+  CHECK_NULL_RETURN(cdata);
+  auto kernel = reinterpret_cast<MatmulSparseStructuredCPUKernel *>(cdata);
+  return kernel->DoSparseMatmul(task_id);
+}
+
+int MatmulSparseStructuredCPUKernel::Run() {
+  CHECK_NULL_RETURN(in_tensors_[FIRST_INPUT]->data());
+  CHECK_NULL_RETURN(out_tensors_.front()->data());
+  if (task_num_ == 0) {
+    return RET_OK;
+  }
+  buffer_ = reinterpret_cast<float *>(
+    ms_context_->allocator->Malloc(thread_buffer_size_ * static_cast<size_t>(thread_count_) * sizeof(float)));
+  if (buffer_ == nullptr) {
+    MS_LOG(ERROR) << "malloc sparse matmul buffer failed.";
+    return RET_NULL_PTR;
+  }
+  auto ret = ParallelLaunch(this->ms_context_, SparseStructuredMatmulRun, this, thread_count_);
+  ms_context_->allocator->Free(buffer_);
+  buffer_ = nullptr;
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "sparse matmul run failed, ret: " << ret;
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+}  // namespace mindspore::kernel
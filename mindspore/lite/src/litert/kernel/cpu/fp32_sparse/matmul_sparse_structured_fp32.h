@@ -0,0 +1,79 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
+#define MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
+
+#include <vector>
+#include "src/litert/lite_kernel.h"
+#include "nnacl/matmul_parameter.h"
+#include "nnacl/fp32_sparse/matmul_sparse_structured_fp32.h"
+
+namespace mindspore::kernel {
+// packed weight values over dense weight values, a block sparse weight sparser than this runs the structured kernels.
+constexpr float kSparseBlockDensityThreshold = 0.3f;
+// an n:m sparse weight packs n / m of the values, the patterns keeping at most half of them (2:4, 4:8, 8:16) run the
+// structured kernels. It is the loosest threshold, so it also bounds the nonzero values of any sparse weight.
+constexpr float kSparseNMDensityThreshold = 0.5f;
+
+// MatMul with a constant weight which is block sparse or n:m sparse. The weight is packed once into the compressed
+// format taking the fewest values, the packed buffer is shared across model instances by the PackWeightManager.
+class MatmulSparseStructuredCPUKernel : public LiteKernel {
+ public:
+  MatmulSparseStructuredCPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
+                                  const std::vector<lite::Tensor *> &outputs, const lite::InnerContext *ctx)
+      : LiteKernel(parameter, inputs, outputs, ctx) {
+    params_ = reinterpret_cast<MatMulParameter *>(op_parameter_);
+  }
+  ~MatmulSparseStructuredCPUKernel() override;
+
+  // cheap check before creating the kernel: constant 2D weight with at most kSparseNMDensityThreshold nonzero values.
+  static bool IsSparseWeight(const MatMulParameter *param, const std::vector<lite::Tensor *> &inputs);
+
+  int Prepare() override;
+  int ReSize() override;
+  int Run() override;
+  int DoSparseMatmul(int task_id);
+  int GetWeightFormat() const { return weight_.format_; }
+
+ private:
+  int ChooseFormat(const float *weight_data, int stride_k, int stride_n);
+  int PackWeight();
+
+  MatMulParameter *params_ = nullptr;
+  SparseStructuredWeight weight_{};
+  void *packed_weight_ = nullptr;
+  size_t packed_size_ = 0;
+  int format_ = SparseWeightFormat_None;
+  int block_k_ = 0;
+  int block_n_ = 0;
+  // the constant tensors may be released after Prepare, the bias is kept like the packed weight.
+  std::vector<float> bias_;
+  int batch_ = 1;
+  int row_ = 0;
+  int deep_ = 0;
+  int col_ = 0;
+  int pack_deep_ = 0;
+  int row_tile_num_ = 0;
+  int col_part_num_ = 1;
+  int col_part_size_ = 0;
+  int task_num_ = 0;
+  int thread_count_ = 1;
+  size_t thread_buffer_size_ = 0;
+  float *buffer_ = nullptr;
+};
+}  // namespace mindspore::kernel
+#endif  // MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
@@ -141,6 +141,15 @@ int MatmulBaseInt8CPUKernel::RunImpl(int task_id) {
     filter_per_channel_ ? quant_param_->quant_multiplier_ + cur_stride : quant_param_->quant_multiplier_;
   int32_t *cur_zp = filter_per_channel_ ? quant_param_->filter_zp_ + cur_stride : quant_param_->filter_zp_;
 
+#ifdef ENABLE_AVX512
+  if (support_vnni_) {
+    MatmulVnniInt8(pack_a_ptr_, batch_b_ptr_ + cur_stride * param_->deep_align_, batch_c_ptr_ + cur_stride,
+                   param_->row_, cur_oc, param_->deep_align_, input_sums_, batch_sums_ + cur_stride,
+                   quant_param_->out_act_min_, quant_param_->out_act_max_, quant_param_->output_.zp_, cur_mul, cur_left,
+                   cur_right, param_->col_, filter_per_channel_, cur_zp);
+    return RET_OK;
+  }
+#endif
   MatmulInt8Opt(pack_a_ptr_, batch_b_ptr_ + cur_stride * param_->deep_align_, batch_c_ptr_ + cur_stride, param_->row_,
                 cur_oc, param_->deep_align_, input_sums_, batch_sums_ + cur_stride, quant_param_->out_act_min_,
                 quant_param_->out_act_max_, quant_param_->output_.zp_, cur_mul, cur_left, cur_right, param_->col_,
@@ -290,15 +299,28 @@ void MatmulBaseInt8CPUKernel::InitParameter() {
     deep_tile_ = C16NUM;
   }
 #else
+#ifdef ENABLE_AVX512
+  support_vnni_ = X86_Avx512Vnni_Support();
+#endif
   row_tile_ = C4NUM;
-  col_tile_ = C4NUM;
-  deep_tile_ = C16NUM;
+  if (support_vnni_) {
+    col_tile_ = C16NUM;
+    deep_tile_ = C4NUM;
+  } else {
+    col_tile_ = C4NUM;
+    deep_tile_ = C16NUM;
+  }
 #endif
   if (param_->a_transpose_) {
     a_pack_func_ = RowMajor2Col16x4MajorInt8;
   } else {
     a_pack_func_ = RowMajor2Row16x4MajorInt8;
   }
+#ifdef ENABLE_AVX512
+  if (support_vnni_) {
+    a_pack_func_ = param_->a_transpose_ ? RowMajor2ColVnniInt8 : RowMajor2RowVnniInt8;
+  }
+#endif
   if (param_->b_transpose_) {
 #ifdef ENABLE_ARM32
     b_pack_func_ = RowMajor2Row2x16MajorInt8;
@@ -309,7 +331,7 @@ void MatmulBaseInt8CPUKernel::InitParameter() {
       b_pack_func_ = RowMajor2Row16x4MajorInt8;
     }
 #else
-    b_pack_func_ = RowMajor2Row16x4MajorInt8;
+    b_pack_func_ = support_vnni_ ? RowMajor2Row4x16MajorInt8 : RowMajor2Row16x4MajorInt8;
 #endif
   } else {
 #ifdef ENABLE_ARM32
@@ -321,7 +343,7 @@ void MatmulBaseInt8CPUKernel::InitParameter() {
       b_pack_func_ = RowMajor2Col16x4MajorInt8;
     }
 #else
-    b_pack_func_ = RowMajor2Col16x4MajorInt8;
+    b_pack_func_ = support_vnni_ ? RowMajor2Col4x16MajorInt8 : RowMajor2Col16x4MajorInt8;
 #endif
   }
   return;
@@ -362,18 +384,25 @@ int MatmulBaseInt8CPUKernel::TransferB() {
                                                 : reinterpret_cast<int8_t *>(save_b_const_);
   CHECK_NULL_RETURN(weight_data);
   CHECK_NULL_RETURN(b_pack_func_);
+  auto calc_weight_bias_sums = CalcWeightBiasSums;
+#ifdef ENABLE_AVX512
+  if (support_vnni_) {
+    // the vnni kernel takes the input with an offset of 128, which is taken back through the weight sums
+    calc_weight_bias_sums = CalcVnniWeightBiasSums;
+  }
+#endif
   for (int i = 0; i < param_->batch; i++) {
     auto current_weight = weight_data + b_offset_[i] * param_->deep_ * param_->col_;
     auto current_b_pack = pack_b_ptr_ + b_offset_[i] * param_->col_align_ * param_->deep_align_;
     auto current_sums = weight_bias_sums_ + b_offset_[i] * param_->col_align_;
     if (param_->b_transpose_) {
       b_pack_func_(current_weight, current_b_pack, param_->col_, param_->deep_);
-      CalcWeightBiasSums(current_weight, param_->deep_, param_->col_, quant_param_->input_.zp_,
-                         quant_param_->filter_zp_, bias_ptr_, current_sums, ColMajor, filter_per_channel_);
+      calc_weight_bias_sums(current_weight, param_->deep_, param_->col_, quant_param_->input_.zp_,
+                            quant_param_->filter_zp_, bias_ptr_, current_sums, ColMajor, filter_per_channel_);
     } else {
       b_pack_func_(current_weight, current_b_pack, param_->deep_, param_->col_);
-      CalcWeightBiasSums(current_weight, param_->deep_, param_->col_, quant_param_->input_.zp_,
-                         quant_param_->filter_zp_, bias_ptr_, current_sums, RowMajor, filter_per_channel_);
+      calc_weight_bias_sums(current_weight, param_->deep_, param_->col_, quant_param_->input_.zp_,
+                            quant_param_->filter_zp_, bias_ptr_, current_sums, RowMajor, filter_per_channel_);
     }
   }
   if (save_b_const_ != nullptr) {
@@ -25,6 +25,10 @@
 #include "nnacl/int8/quantize.h"
 #include "nnacl/int8/common_func_int8.h"
 #include "nnacl/int8/matmul_int8.h"
+#ifdef ENABLE_AVX512
+#include "nnacl/int8/matmul_vnni_int8.h"
+#include "nnacl/intrinsics/ms_simd_cpu_info.h"
+#endif
 
 namespace mindspore::kernel {
 class MatmulBaseInt8CPUKernel : public LiteKernel {
@@ -90,6 +94,7 @@ class MatmulBaseInt8CPUKernel : public LiteKernel {
   int deep_tile_ = C16NUM;
   int channel_num_ = 0;
   bool support_sdot_ = false;
+  bool support_vnni_ = false;
   PackFunc a_pack_func_{nullptr};
   PackFunc b_pack_func_{nullptr};
   std::vector<int> a_offset_;
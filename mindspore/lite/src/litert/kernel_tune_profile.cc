@@ -0,0 +1,125 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/litert/kernel_tune_profile.h"
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <utility>
+#include "src/common/log_adapter.h"
+#include "include/errorcode.h"
+
+namespace mindspore::lite {
+std::string KernelTuneProfile::GenerateKey(const std::string &node_name, const std::vector<int> &shape,
+                                           int thread_num) {
+  std::string key = node_name + "|";
+  for (auto dim : shape) {
+    key += std::to_string(dim);
+    key += ',';
+  }
+  return key + "|t" + std::to_string(thread_num);
+}
+
+int KernelTuneProfile::Load() {
+  std::ifstream ifs(file_path_);
+  if (!ifs.is_open()) {
+    MS_LOG(INFO) << "kernel tune profile " << file_path_ << " does not exist.";
+    return RET_OK;
+  }
+  std::unique_lock<std::mutex> l(mutex_);
+  choices_.clear();
+  std::string line;
+  size_t line_num = 0;
+  while (std::getline(ifs, line)) {
+    line_num++;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    auto first_tab = line.find('\t');
+    auto second_tab = first_tab == std::string::npos ? std::string::npos : line.find('\t', first_tab + 1);
+    if (second_tab == std::string::npos) {
+      MS_LOG(WARNING) << "invalid line " << line_num << " of kernel tune profile " << file_path_;
+      return RET_ERROR;
+    }
+    KernelTuneChoice choice;
+    choice.variant = line.substr(first_tab + 1, second_tab - first_tab - 1);
+    choice.thread_num = std::atoi(line.substr(second_tab + 1).c_str());
+    if (choice.variant.empty() || choice.thread_num <= 0) {
+      MS_LOG(WARNING) << "invalid line " << line_num << " of kernel tune profile " << file_path_;
+      return RET_ERROR;
+    }
+    choices_[line.substr(0, first_tab)] = choice;
+  }
+  dirty_ = false;
+  MS_LOG(INFO) << "load " << choices_.size() << " kernel choices from " << file_path_;
+  return RET_OK;
+}
+
+int KernelTuneProfile::Save() {
+  std::unique_lock<std::mutex> l(mutex_);
+  if (!dirty_) {
+    return RET_OK;
+  }
+  std::ostringstream oss;
+  oss << "# kernel tune profile: key, variant, thread num\n";
+  for (const auto &[key, choice] : choices_) {
+    oss << key << '\t' << choice.variant << '\t' << choice.thread_num << '\n';
+  }
+  // write to a temporary file first, the sessions which are loading the profile never see a partial file.
+  auto tmp_path = file_path_ + ".tmp";
+  std::ofstream ofs(tmp_path, std::ios::trunc);
+  if (!ofs.is_open()) {
+    MS_LOG(ERROR) << "open " << tmp_path << " failed.";
+    return RET_ERROR;
+  }
+  ofs << oss.str();
+  ofs.close();
+  if (!ofs.good() || rename(tmp_path.c_str(), file_path_.c_str()) != 0) {
+    MS_LOG(ERROR) << "write kernel tune profile " << file_path_ << " failed.";
+    (void)remove(tmp_path.c_str());
+    return RET_ERROR;
+  }
+  dirty_ = false;
+  MS_LOG(INFO) << "save " << choices_.size() << " kernel choices to " << file_path_;
+  return RET_OK;
+}
+
+bool KernelTuneProfile::Find(const std::string &key, KernelTuneChoice *choice) const {
+  std::unique_lock<std::mutex> l(mutex_);
+  auto iter = choices_.find(key);
+  if (iter == choices_.end()) {
+    return false;
+  }
+  *choice = iter->second;
+  return true;
+}
+
+void KernelTuneProfile::Insert(const std::string &key, const KernelTuneChoice &choice) {
+  std::unique_lock<std::mutex> l(mutex_);
+  choices_[key] = choice;
+  dirty_ = true;
+}
+
+size_t KernelTuneProfile::Digest() const {
+  std::unique_lock<std::mutex> l(mutex_);
+  std::string content;
+  for (const auto &[key, choice] : choices_) {
+    content += key + '\t' + choice.variant + '\t' + std::to_string(choice.thread_num) + '\n';
+  }
+  return std::hash<std::string>{}(content);
+}
+}  // namespace mindspore::lite
@@ -0,0 +1,66 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_KERNEL_TUNE_PROFILE_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_KERNEL_TUNE_PROFILE_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mindspore::lite {
+// The kernel variant and the thread num picked for a node, e.g. winograd convolution with 2 threads.
+struct KernelTuneChoice {
+  std::string variant;
+  int thread_num = 0;
+};
+
+// Kernel choices of the nodes of a model, kept in a text file beside the model. Each line is
+//   <node name>|<input shape>|t<context thread num> <tab> <variant> <tab> <thread num>
+// In tune mode, a kernel which has several variants benchmarks them when its node has no choice yet and records the
+// fastest one. Otherwise the recorded choices replace the selection heuristics of the kernels.
+class KernelTuneProfile {
+ public:
+  KernelTuneProfile(std::string file_path, bool tune) : file_path_(std::move(file_path)), tune_(tune) {}
+  ~KernelTuneProfile() = default;
+
+  static std::string GenerateKey(const std::string &node_name, const std::vector<int> &shape, int thread_num);
+
+  // A missing file is an empty profile.
+  int Load();
+  // Write the profile when choices were recorded since the last Load or Save.
+  int Save();
+
+  bool Find(const std::string &key, KernelTuneChoice *choice) const;
+  void Insert(const std::string &key, const KernelTuneChoice &choice);
+
+  bool tune() const { return tune_; }
+  const std::string &file_path() const { return file_path_; }
+  // hash of the loaded choices, the packing layout of the weights depends on them.
+  size_t Digest() const;
+
+ private:
+  std::string file_path_;
+  bool tune_ = false;
+  bool dirty_ = false;
+  std::map<std::string, KernelTuneChoice> choices_;
+  mutable std::mutex mutex_;
+};
+}  // namespace mindspore::lite
+
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_KERNEL_TUNE_PROFILE_H_
@@ -619,12 +619,16 @@ int LiteSession::CompileGraph(Model *model) {
 
   non_tail_call_kernels_ = scheduler.NonTailCallNodes();
 
+  InitKernelTuneProfile();
+  BeginPackWeightCache(model);
   ret = PrepareKernels(model);
+  lite::PackWeightManager::GetInstance()->EndPackWeightCache(model, ret == RET_OK);
   if (ret != RET_OK) {
     MS_LOG(ERROR) << "Prepare kernels failed: " << ret;
     is_running_.store(false);
     return ret;
   }
+  SaveKernelTuneProfile();
 
   if (is_train_session_ || is_prepare_session_) {
     is_running_.store(false);
@@ -651,6 +655,7 @@ int LiteSession::CompileGraph(Model *model) {
   if (infer_along_running_) {
     this->context_->set_infer_checker(InferCheckerAll);
   }
+  InitShapePlanCache();
   is_running_.store(false);
   return RET_OK;
 }
@@ -1493,6 +1498,14 @@ int LiteSession::Resize(const std::vector<mindspore::lite::Tensor *> &inputs,
     return ret;
   }
 
+  // a plan cached for the same input shapes saves the memory offset assignment
+  const ShapePlan *shape_plan = nullptr;
+  std::string shape_plan_key;
+  if (shape_plan_cache_ != nullptr) {
+    shape_plan_key = ShapePlanCache::GenerateKey(inputs_);
+    shape_plan = shape_plan_cache_->Find(shape_plan_key);
+  }
+  // shape infer always runs, the infer functions also write op parameters such as split sizes and slice begins.
   ret = ReSizeKernels(kernels_, isolate_input_map_);
   if (ret != RET_OK) {
     ResetInputsShape(old_dims);
@@ -1504,22 +1517,182 @@ int LiteSession::Resize(const std::vector<mindspore::lite::Tensor *> &inputs,
     return ret;
   }
 
-  if (RuntimeAllocatorInit() != RET_OK) {
+  if (shape_plan != nullptr && !MatchShapePlan(*shape_plan)) {
+    MS_LOG(INFO) << "inferred shapes differ from the cached shape plan, plan again: " << shape_plan_key;
+    shape_plan = nullptr;
+  }
+  ret = shape_plan != nullptr ? RuntimeAllocatorRestore(*shape_plan) : RuntimeAllocatorInit();
+  if (ret != RET_OK) {
     MS_LOG(ERROR) << "Runtime allocator in resize failed.";
     is_running_.store(false);
     return RET_ERROR;
   }
+  if (shape_plan_cache_ != nullptr && shape_plan == nullptr) {
+    SaveShapePlan(shape_plan_key);
+  }
 
   auto status = GraphOptimizePass(&kernels_);
   if (status != RET_OK) {
     MS_LOG(ERROR) << "GraphOptimizePass failed.";
     return RET_ERROR;
   }
+  SaveKernelTuneProfile();
 
   is_running_.store(false);
   return RET_OK;
 }
 
+void LiteSession::BeginPackWeightCache(const Model *model) {
+  if (config_info_ == nullptr || is_train_session_) {
+    return;
+  }
+  auto common_context_iter = config_info_->find(kCommonContextSection);
+  if (common_context_iter == config_info_->end()) {
+    return;
+  }
+  auto cache_dir_iter = common_context_iter->second.find(kPackWeightCacheDirKey);
+  if (cache_dir_iter == common_context_iter->second.end() || cache_dir_iter->second.empty()) {
+    return;
+  }
+  auto &profile = context_->kernel_tune_profile_;
+  if (profile != nullptr && profile->tune()) {
+    MS_LOG(INFO) << "pack weight cache is not used while tuning kernels.";
+    return;
+  }
+  // the kernels and the packing functions are selected by the thread num, the float16 option and the kernel choices.
+  auto layout = "thread_" + std::to_string(context_->thread_num_) + (context_->IsCpuFloat16Enabled() ? "_fp16" : "");
+  if (profile != nullptr) {
+    layout += "_tune_" + std::to_string(profile->Digest());
+  }
+  lite::PackWeightManager::GetInstance()->BeginPackWeightCache(model, tensors_, cache_dir_iter->second, layout);
+}
+
+void LiteSession::InitKernelTuneProfile() {
+  context_->kernel_tune_profile_ = nullptr;
+  if (config_info_ == nullptr || is_train_session_) {
+    return;
+  }
+  auto common_context_iter = config_info_->find(kCommonContextSection);
+  if (common_context_iter == config_info_->end()) {
+    return;
+  }
+  auto profile_iter = common_context_iter->second.find(kKernelTuneProfileKey);
+  if (profile_iter == common_context_iter->second.end() || profile_iter->second.empty()) {
+    return;
+  }
+  auto enable_iter = common_context_iter->second.find(kEnableKernelTuneKey);
+  bool tune = enable_iter != common_context_iter->second.end() && enable_iter->second == "true";
+  auto profile = std::make_shared<KernelTuneProfile>(profile_iter->second, tune);
+  if (profile->Load() != RET_OK) {
+    // the profile only replaces the selection heuristics, the kernels are selected by them instead.
+    MS_LOG(WARNING) << "load kernel tune profile " << profile_iter->second
+                    << " failed, kernels are selected by heuristics.";
+    return;
+  }
+  context_->kernel_tune_profile_ = profile;
+}
+
+void LiteSession::SaveKernelTuneProfile() {
+  auto &profile = context_->kernel_tune_profile_;
+  if (profile == nullptr || !profile->tune()) {
+    return;
+  }
+  if (profile->Save() != RET_OK) {
+    MS_LOG(WARNING) << "save kernel tune profile " << profile->file_path() << " failed.";
+  }
+}
+
+void LiteSession::InitShapePlanCache() {
+  shape_plan_cache_ = nullptr;
+  if (config_info_ == nullptr || infer_along_running_ || is_control_flow_ || is_train_session_) {
+    return;
+  }
+  auto common_context_iter = config_info_->find(kCommonContextSection);
+  if (common_context_iter == config_info_->end()) {
+    return;
+  }
+  auto cache_size_iter = common_context_iter->second.find(kShapePlanCacheSizeKey);
+  if (cache_size_iter == common_context_iter->second.end()) {
+    return;
+  }
+  auto cache_size_opt = GenericParseValue<size_t>(cache_size_iter->second);
+  if (cache_size_opt.IsNone() || cache_size_opt.Get() == 0) {
+    MS_LOG(WARNING) << "shape plan cache size is invalid: " << cache_size_iter->second;
+    return;
+  }
+  if (ExistCustomCpuKernel()) {
+    MS_LOG(INFO) << "Not support shape plan cache with custom kernel.";
+    return;
+  }
+  if (runtime_allocator_ == nullptr) {
+    // a plan saves the offset assignment of the runtime allocator only, without it a hit gains nothing.
+    MS_LOG(INFO) << "Not support shape plan cache without runtime allocator.";
+    return;
+  }
+  for (auto kernel : kernels_) {
+    if (kernel->desc().arch != kernel::KERNEL_ARCH::kCPU || kernel->subgraph_type() == kernel::kNotSubGraph) {
+      MS_LOG(INFO) << "Not support shape plan cache for non-cpu subgraph: " << kernel->name();
+      return;
+    }
+    for (auto node : reinterpret_cast<kernel::SubGraphKernel *>(kernel)->nodes()) {
+      for (auto tensor : node->out_tensors()) {
+        if (tensor->data_type() == kObjectTypeTensorType) {
+          MS_LOG(INFO) << "Not support shape plan cache with tensorlist: " << tensor->tensor_name();
+          return;
+        }
+      }
+    }
+  }
+  shape_plan_cache_ = std::make_unique<ShapePlanCache>(cache_size_opt.Get());
+  SaveShapePlan(ShapePlanCache::GenerateKey(inputs_));
+}
+
+void LiteSession::SaveShapePlan(const std::string &key) {
+  ShapePlan plan;
+  for (auto kernel : kernels_) {
+    auto subgraph = reinterpret_cast<kernel::SubGraphKernel *>(kernel);
+    for (auto tensor : subgraph->in_tensors()) {
+      if (!tensor->IsConst()) {
+        plan.tensor_shapes.emplace_back(tensor, tensor->shape());
+      }
+    }
+    for (auto node : subgraph->nodes()) {
+      for (auto tensor : node->out_tensors()) {
+        if (!tensor->IsConst()) {
+          plan.tensor_shapes.emplace_back(tensor, tensor->shape());
+        }
+      }
+    }
+  }
+  for (auto &item : plan.tensor_shapes) {
+    auto &shape = item.second;
+    if (std::any_of(shape.begin(), shape.end(), [](int dim) { return dim < 0; })) {
+      MS_LOG(DEBUG) << "shape of " << item.first->tensor_name() << " is unknown, skip caching plan: " << key;
+      return;
+    }
+    if (runtime_allocator_ != nullptr && item.first->allocator() == runtime_allocator_) {
+      plan.runtime_tensors.push_back(item.first);
+    }
+  }
+  if (runtime_allocator_ != nullptr) {
+    for (auto &graph_out : isolate_graph_output_map_) {
+      if (graph_out.second->allocator() == runtime_allocator_) {
+        plan.runtime_tensors.push_back(graph_out.second);
+      }
+    }
+    plan.offset_map = runtime_allocator_->GetOffsetMap();
+    plan.total_size = runtime_allocator_->GetTotalSize();
+  }
+  shape_plan_cache_->Insert(key, std::move(plan));
+  MS_LOG(DEBUG) << "shape plan cache size: " << shape_plan_cache_->size()
+                << " | hit: " << shape_plan_cache_->hit_count() << " | miss: " << shape_plan_cache_->miss_count();
+}
+
+bool LiteSession::MatchShapePlan(const ShapePlan &plan) const {
+  return std::all_of(plan.tensor_shapes.begin(), plan.tensor_shapes.end(),
+                     [](const auto &item) { return item.first->shape() == item.second; });
+}
+
 int LiteSession::PreCheck(Model *model) {
   bool expected = false;
   if (!is_running_.compare_exchange_strong(expected, true)) {
@@ -1758,6 +1931,24 @@ int LiteSession::RuntimeAllocatorInit() {
   return RET_OK;
 }
 
+int LiteSession::RuntimeAllocatorRestore(const ShapePlan &plan) {
+  // the conditions of RuntimeAllocatorInit may have changed since the plan was saved.
+  if (RuntimeAllocatorValid() != RET_OK || ExistCustomCpuKernel() || runtime_allocator_ == nullptr) {
+    return RuntimeAllocatorInit();
+  }
+  runtime_allocator_->Clear(context_->allocator);
+  for (auto tensor : plan.runtime_tensors) {
+    tensor->set_allocator(runtime_allocator_);
+  }
+  runtime_allocator_->RestorePlan(plan.offset_map, plan.total_size);
+  auto ret = RuntimeAllocatorSetData();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "restore runtime allocator plan failed.";
+    return ret;
+  }
+  return RET_OK;
+}
+
 int LiteSession::RuntimeAllocatorSetData() {
   void *data = runtime_allocator_->MallocOptData();
   if (data == nullptr) {
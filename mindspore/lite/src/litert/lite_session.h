@@ -27,6 +27,7 @@
 #include "src/litert/lite_model.h"
 #include "src/litert/inner_context.h"
 #include "src/litert/runtime_allocator.h"
+#include "src/litert/shape_plan_cache.h"
 #include "schema/model_generated.h"
 #include "src/litert/executor.h"
 #include "src/tensor.h"
@@ -200,6 +201,18 @@ class MS_API LiteSession {
   virtual int RuntimeAllocatorValid();
   RuntimeAllocatorPtr runtime_allocator_ = nullptr;
 
+ protected:
+  void InitShapePlanCache();
+  void SaveShapePlan(const std::string &key);
+  bool MatchShapePlan(const ShapePlan &plan) const;
+  int RuntimeAllocatorRestore(const ShapePlan &plan);
+  std::unique_ptr<ShapePlanCache> shape_plan_cache_ = nullptr;
+
+ private:
+  void BeginPackWeightCache(const Model *model);
+  void InitKernelTuneProfile();
+  void SaveKernelTuneProfile();
+
  private:
   int AscendInit(const std::shared_ptr<InnerContext> &context);
 
@@ -0,0 +1,230 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/litert/pack_weight_cache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "src/common/log_adapter.h"
+
+namespace mindspore::lite {
+namespace {
+constexpr char kPackWeightCacheMagic[8] = "MSPACKW";
+// version 2 keeps the layout after the header
+constexpr uint32_t kPackWeightCacheVersion = 2;
+// the same alignment as the packed data malloced by the PackWeightManager
+constexpr size_t kPackWeightCacheAlign = 64;
+constexpr size_t kPackWeightCacheEntryAlign = 8;
+
+// the file is the header, the layout string, the entries and the packed data
+struct PackWeightCacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t entry_num;
+  uint64_t layout_size;
+};
+
+struct PackWeightCacheEntry {
+  uint64_t tensor_index;
+  uint64_t size;
+  uint64_t occurrence;
+  uint64_t offset;
+};
+
+size_t AlignUp(size_t size, size_t align = kPackWeightCacheAlign) { return (size + align - 1) & (~(align - 1)); }
+
+size_t EntriesOffset(size_t layout_size) {
+  return AlignUp(sizeof(PackWeightCacheHeader) + layout_size, kPackWeightCacheEntryAlign);
+}
+
+std::string HashToString(size_t hash) {
+  std::ostringstream oss;
+  oss << std::hex << std::setw(sizeof(size_t) * 2) << std::setfill('0') << hash;
+  return oss.str();
+}
+}  // namespace
+
+PackWeightCache::~PackWeightCache() {
+#if !defined(_WIN32) && !defined(_WIN64)
+  if (mapped_ != nullptr) {
+    (void)munmap(mapped_, mapped_size_);
+    mapped_ = nullptr;
+  }
+#endif
+}
+
+std::string PackWeightCache::GenerateFileName(const char *model_buf, size_t model_size, const std::string &layout) {
+  auto model_hash = std::hash<std::string_view>{}(std::string_view(model_buf, model_size));
+  auto layout_hash = std::hash<std::string>{}(layout);
+  return "pack_weight_" + HashToString(model_hash) + "_" + HashToString(layout_hash) + ".bin";
+}
+
+bool PackWeightCache::Load() {
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(MS_COMPILE_IOS)
+  auto fd = open(file_path_.c_str(), O_RDONLY);
+  if (fd == -1) {
+    MS_LOG(INFO) << "There is no pack weight cache file " << file_path_;
+    return false;
+  }
+  struct stat fd_stat;
+  if (fstat(fd, &fd_stat) != 0 || static_cast<size_t>(fd_stat.st_size) < sizeof(PackWeightCacheHeader)) {
+    MS_LOG(WARNING) << "Pack weight cache file " << file_path_ << " is invalid.";
+    (void)close(fd);
+    return false;
+  }
+  auto file_size = static_cast<size_t>(fd_stat.st_size);
+  auto buf = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  (void)close(fd);
+  if (buf == MAP_FAILED) {
+    MS_LOG(WARNING) << "Mmap pack weight cache file " << file_path_ << " failed.";
+    return false;
+  }
+  auto header = static_cast<const PackWeightCacheHeader *>(buf);
+  auto entry_num = header->entry_num;
+  bool valid = memcmp(header->magic, kPackWeightCacheMagic, sizeof(kPackWeightCacheMagic)) == 0 &&
+               header->version == kPackWeightCacheVersion && header->layout_size == layout_.size() &&
+               EntriesOffset(layout_.size()) <= file_size &&
+               layout_.compare(0, layout_.size(), reinterpret_cast<const char *>(header + 1), layout_.size()) == 0;
+  if (!valid) {
+    MS_LOG(WARNING) << "Pack weight cache file " << file_path_ << " is of another format version or layout, current "
+                    << "layout is " << layout_ << ". It is packed again.";
+    (void)munmap(buf, file_size);
+    return false;
+  }
+  auto entries_offset = EntriesOffset(layout_.size());
+  valid = entry_num <= (file_size - entries_offset) / sizeof(PackWeightCacheEntry);
+  auto file_entries = reinterpret_cast<const PackWeightCacheEntry *>(static_cast<const char *>(buf) + entries_offset);
+  for (uint64_t i = 0; valid && i < entry_num; ++i) {
+    const auto &entry = file_entries[i];
+    if (entry.offset % kPackWeightCacheAlign != 0 || entry.offset > file_size ||
+        entry.size > file_size - entry.offset) {
+      valid = false;
+      break;
+    }
+    entries_[{entry.tensor_index, entry.size, entry.occurrence}] = entry.offset;
+  }
+  if (!valid) {
+    MS_LOG(WARNING) << "Pack weight cache file " << file_path_ << " is invalid.";
+    entries_.clear();
+    (void)munmap(buf, file_size);
+    return false;
+  }
+  mapped_ = buf;
+  mapped_size_ = file_size;
+  MS_LOG(INFO) << "Load " << entries_.size() << " packed weights from " << file_path_;
+  return true;
+#else
+  MS_LOG(WARNING) << "Pack weight cache is unsupported on this platform.";
+  return false;
+#endif
+}
+
+PackWeightKey PackWeightCache::NextKey(size_t tensor_index, size_t size) {
+  return {tensor_index, size, occurrences_[{tensor_index, size}]++};
+}
+
+void *PackWeightCache::Find(const PackWeightKey &key) const {
+  auto iter = entries_.find(key);
+  if (iter == entries_.end()) {
+    return nullptr;
+  }
+  return static_cast<char *>(mapped_) + iter->second;
+}
+
+void PackWeightCache::AddPacked(const PackWeightKey &key, const void *data) { (void)packed_.emplace_back(key, data); }
+
+void PackWeightCache::RemovePacked(const void *data) {
+  for (auto iter = packed_.begin(); iter != packed_.end(); ++iter) {
+    if (iter->second == data) {
+      (void)packed_.erase(iter);
+      return;
+    }
+  }
+}
+
+bool PackWeightCache::Save() {
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(MS_COMPILE_IOS)
+  if (packed_.empty()) {
+    return true;
+  }
+  // keep the weights of the loaded file, the new file replaces it
+  std::vector<std::pair<PackWeightKey, const void *>> weights;
+  for (const auto &[key, offset] : entries_) {
+    (void)weights.emplace_back(key, static_cast<const char *>(mapped_) + offset);
+  }
+  (void)weights.insert(weights.end(), packed_.begin(), packed_.end());
+
+  PackWeightCacheHeader header{};
+  (void)memcpy(header.magic, kPackWeightCacheMagic, sizeof(kPackWeightCacheMagic));
+  header.version = kPackWeightCacheVersion;
+  header.entry_num = weights.size();
+  header.layout_size = layout_.size();
+  std::vector<PackWeightCacheEntry> file_entries;
+  auto entries_offset = EntriesOffset(layout_.size());
+  auto offset = AlignUp(entries_offset + weights.size() * sizeof(PackWeightCacheEntry));
+  for (const auto &[key, data] : weights) {
+    (void)file_entries.push_back({key.tensor_index, key.size, key.occurrence, offset});
+    offset = AlignUp(offset + key.size);
+  }
+
+  auto tmp_path = file_path_ + ".tmp" + std::to_string(getpid());
+  std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
+  if (!ofs.is_open()) {
+    MS_LOG(WARNING) << "Open " << tmp_path << " failed.";
+    return false;
+  }
+  const char padding[kPackWeightCacheAlign] = {0};
+  (void)ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  (void)ofs.write(layout_.data(), static_cast<std::streamsize>(layout_.size()));
+  (void)ofs.write(padding, static_cast<std::streamsize>(entries_offset - sizeof(header) - layout_.size()));
+  (void)ofs.write(reinterpret_cast<const char *>(file_entries.data()),
+                  static_cast<std::streamsize>(file_entries.size() * sizeof(PackWeightCacheEntry)));
+  size_t written = entries_offset + file_entries.size() * sizeof(PackWeightCacheEntry);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    (void)ofs.write(padding, static_cast<std::streamsize>(file_entries[i].offset - written));
+    (void)ofs.write(static_cast<const char *>(weights[i].second), static_cast<std::streamsize>(weights[i].first.size));
+    written = file_entries[i].offset + weights[i].first.size;
+  }
+  ofs.close();
+  if (!ofs.good()) {
+    MS_LOG(WARNING) << "Write pack weight cache file " << tmp_path << " failed.";
+    (void)remove(tmp_path.c_str());
+    return false;
+  }
+  if (rename(tmp_path.c_str(), file_path_.c_str()) != 0) {
+    MS_LOG(WARNING) << "Rename " << tmp_path << " to " << file_path_ << " failed.";
+    (void)remove(tmp_path.c_str());
+    return false;
+  }
+  MS_LOG(INFO) << "Save " << weights.size() << " packed weights to " << file_path_;
+  packed_.clear();
+  return true;
+#else
+  return false;
+#endif
+}
+}  // namespace mindspore::lite
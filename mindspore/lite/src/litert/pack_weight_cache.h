@@ -0,0 +1,81 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_PACK_WEIGHT_CACHE_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_PACK_WEIGHT_CACHE_H_
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace mindspore::lite {
+// A packed weight of a model: the index of its origin tensor, the packed size and how many times the same tensor was
+// packed to the same size before, since one const tensor can feed several kernels.
+struct PackWeightKey {
+  size_t tensor_index = 0;
+  size_t size = 0;
+  size_t occurrence = 0;
+  bool operator<(const PackWeightKey &other) const {
+    return std::tie(tensor_index, size, occurrence) < std::tie(other.tensor_index, other.size, other.occurrence);
+  }
+};
+
+// The packed weights of one model compiled in one layout, kept in a file of the cache directory. Later processes map
+// the file read only instead of packing again, so the pages of the packed weights are shared by all the processes of
+// the host through the page cache.
+//
+// The layout must cover everything the packing depends on besides the model: cpu isa, kernel selection options and
+// the library version. It is kept in the file and a file written in another layout or format version is rejected, so
+// the packed weights of another library version are never mapped.
+class PackWeightCache {
+ public:
+  PackWeightCache(std::string file_path, std::string layout)
+      : file_path_(std::move(file_path)), layout_(std::move(layout)) {}
+  ~PackWeightCache();
+
+  static std::string GenerateFileName(const char *model_buf, size_t model_size, const std::string &layout);
+
+  // Map the cache file, return false when there is no valid one of the layout and every Find misses.
+  bool Load();
+  // The key of the next pack of a tensor to the size, the packing order of a model is fixed.
+  PackWeightKey NextKey(size_t tensor_index, size_t size);
+  // The packed data of the key in the mapped file, nullptr when it is not cached.
+  void *Find(const PackWeightKey &key) const;
+  // Record the packed data of a missed key, the data must stay valid until Save or RemovePacked.
+  void AddPacked(const PackWeightKey &key, const void *data);
+  void RemovePacked(const void *data);
+  // Write the recorded data to a temporary file and rename it to the cache file, readers never see a partial file.
+  bool Save();
+
+  const std::string &file_path() const { return file_path_; }
+  bool loaded() const { return mapped_ != nullptr; }
+  size_t packed_num() const { return packed_.size(); }
+
+ private:
+  std::string file_path_;
+  std::string layout_;
+  void *mapped_ = nullptr;
+  size_t mapped_size_ = 0;
+  // key -> offset in the mapped file
+  std::map<PackWeightKey, size_t> entries_;
+  std::map<std::pair<size_t, size_t>, size_t> occurrences_;
+  std::vector<std::pair<PackWeightKey, const void *>> packed_;
+};
+}  // namespace mindspore::lite
+
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_PACK_WEIGHT_CACHE_H_
@@ -17,13 +17,35 @@
 #include <vector>
 #include <map>
 #include <string>
+#include "include/api/types.h"
 #include "src/common/graph_util.h"
+#include "src/common/file_utils.h"
+#ifdef ENABLE_AVX512
+#include "nnacl/intrinsics/ms_simd_cpu_info.h"
+#endif
 namespace mindspore::lite {
 namespace {
 #ifndef __ANDROID__
 constexpr size_t kMemAlignSize = 64;
 #endif
 
+// the instruction set the packing functions are selected for.
+std::string CpuIsa() {
+#if defined(ENABLE_ARM64)
+  return "arm64";
+#elif defined(ENABLE_ARM32)
+  return "arm32";
+#elif defined(ENABLE_AVX512)
+  return X86_Avx512_Support() ? "avx512" : "avx";
+#elif defined(ENABLE_AVX)
+  return "avx";
+#elif defined(ENABLE_SSE)
+  return "sse";
+#else
+  return "generic";
+#endif
+}
+
 #ifdef SHARING_MODEL_WEIGHT
 std::string ParseNumaId(const std::map<std::string, std::map<std::string, std::string>> *config_info) {
   std::string numa_id = "-1";
@@ -221,7 +243,107 @@ void *PackWeightManager::MallocData(size_t size) {
   return data;
 }
 
+void PackWeightManager::BeginPackWeightCache(const Model *model, const std::vector<Tensor *> &tensors,
+                                             const std::string &cache_dir, const std::string &layout) {
+#ifdef SHARING_MODEL_WEIGHT
+  if (pack_weight_ != nullptr) {
+    MS_LOG(INFO) << "pack weight cache is not used with shared pack weight.";
+    return;
+  }
+#endif
+  MS_CHECK_TRUE_RET_VOID(model != nullptr);
+  if (model->buf == nullptr || model->buf_size_ == 0) {
+    MS_LOG(INFO) << "model buf is released, pack weight cache is not used.";
+    return;
+  }
+  if (CreateDir(cache_dir) != RET_OK) {
+    MS_LOG(WARNING) << "create pack weight cache dir " << cache_dir << " failed, pack weight cache is not used.";
+    return;
+  }
+  // the pack layout of the kernels may change between versions, another version uses another file.
+  auto full_layout = layout + "_" + CpuIsa() + "_" + std::to_string(sizeof(void *)) + "_" + Version();
+  auto cache = std::make_shared<PackWeightCache>(
+    cache_dir + "/" + PackWeightCache::GenerateFileName(model->buf, model->buf_size_, full_layout), full_layout);
+  (void)cache->Load();
+  std::unique_lock<std::mutex> l(cache_mutex_);
+  pack_caches_[model] = cache;
+  for (size_t i = 0; i < tensors.size(); i++) {
+    auto tensor = tensors[i];
+    if (tensor != nullptr && tensor->IsConst() && tensor->data() != nullptr) {
+      (void)cache_origin_data_.emplace(tensor->data(), std::make_pair(cache, i));
+    }
+  }
+}
+
+void PackWeightManager::EndPackWeightCache(const Model *model, bool save) {
+  std::shared_ptr<PackWeightCache> cache = nullptr;
+  {
+    std::unique_lock<std::mutex> l(cache_mutex_);
+    auto iter = pack_caches_.find(model);
+    if (iter == pack_caches_.end()) {
+      return;
+    }
+    cache = iter->second;
+    (void)pack_caches_.erase(iter);
+    for (auto origin_iter = cache_origin_data_.begin(); origin_iter != cache_origin_data_.end();) {
+      origin_iter = origin_iter->second.first == cache ? cache_origin_data_.erase(origin_iter) : ++origin_iter;
+    }
+    for (auto packed_iter = cache_packed_data_.begin(); packed_iter != cache_packed_data_.end();) {
+      packed_iter = packed_iter->second == cache ? cache_packed_data_.erase(packed_iter) : ++packed_iter;
+    }
+  }
+  // the packed data is owned by the prepared kernels, it is valid until they are destroyed.
+  if (save && cache->packed_num() != 0 && !cache->Save()) {
+    MS_LOG(WARNING) << "save pack weight cache " << cache->file_path() << " failed.";
+  }
+}
+
+void *PackWeightManager::GetCachedPackData(const void *tensor_data, size_t size, bool *is_packed) {
+  std::unique_lock<std::mutex> l(cache_mutex_);
+  auto iter = cache_origin_data_.find(tensor_data);
+  if (iter == cache_origin_data_.end()) {
+    return nullptr;
+  }
+  auto cache = iter->second.first;
+  auto key = cache->NextKey(iter->second.second, size);
+  auto data = cache->Find(key);
+  if (data != nullptr) {
+    (void)cache_mapped_data_.emplace(data, cache);
+    *is_packed = true;
+    return data;
+  }
+  data = MallocData(size);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  cache->AddPacked(key, data);
+  cache_packed_data_[data] = cache;
+  *is_packed = false;
+  return data;
+}
+
+bool PackWeightManager::FreeCachedPackData(void *tensor_data) {
+  std::unique_lock<std::mutex> l(cache_mutex_);
+  auto mapped_iter = cache_mapped_data_.find(tensor_data);
+  if (mapped_iter != cache_mapped_data_.end()) {
+    (void)cache_mapped_data_.erase(mapped_iter);
+    return true;
+  }
+  auto packed_iter = cache_packed_data_.find(tensor_data);
+  if (packed_iter != cache_packed_data_.end()) {
+    packed_iter->second->RemovePacked(tensor_data);
+    (void)cache_packed_data_.erase(packed_iter);
+  }
+  return false;
+}
+
 void *PackWeightManager::GetPackData(const void *tensor_data, const size_t size, bool *is_packed) {
+  if (tensor_data != nullptr) {
+    auto data = GetCachedPackData(tensor_data, size, is_packed);
+    if (data != nullptr) {
+      return data;
+    }
+  }
 #ifdef SHARING_MODEL_WEIGHT
   if (pack_weight_ == nullptr) {
     void *data = MallocData(size);
@@ -247,6 +369,9 @@ void PackWeightManager::FreeData(void *tensor_data) {
 }
 
 void PackWeightManager::Free(void *tensor_data) {
+  if (tensor_data == nullptr || FreeCachedPackData(tensor_data)) {
+    return;
+  }
 #ifdef SHARING_MODEL_WEIGHT
   if (pack_weight_ == nullptr) {
     FreeData(tensor_data);
@@ -20,10 +20,13 @@
 #include <vector>
 #include <unordered_map>
 #include <map>
+#include <mutex>
 #include <string>
+#include <utility>
 #include "include/model.h"
 #include "include/errorcode.h"
 #include "src/tensor.h"
+#include "src/litert/pack_weight_cache.h"
 #ifdef SHARING_MODEL_WEIGHT
 #include "src/litert/pack_weight.h"
 #endif
@@ -44,10 +47,18 @@ class PackWeightManager {
   void *ReplaceFp16Data(void *origin_fp16_data, size_t size, bool *replace);
   void FreePackWeight(std::string runner_id, std::string model_id);
   std::string GenModelID();
+  // The packed weights of the model are looked up in and saved to a cache file of the cache directory while its kernels
+  // are prepared, the cache file is shared by the processes which prepare the same model in the same layout.
+  void BeginPackWeightCache(const Model *model, const std::vector<Tensor *> &tensors, const std::string &cache_dir,
+                            const std::string &layout);
+  void EndPackWeightCache(const Model *model, bool save);
 
  private:
   void *MallocData(size_t size);
   void FreeData(void *tensor_data);
+  void *GetCachedPackData(const void *tensor_data, size_t size, bool *is_packed);
+  // return true when the data is in a mapped cache file.
+  bool FreeCachedPackData(void *tensor_data);
   PackWeightManager() = default;
   bool is_parallel_ = false;
 #ifdef SHARING_MODEL_WEIGHT
@@ -56,6 +67,14 @@ class PackWeightManager {
   std::mutex manager_mutex_;
   std::vector<std::string> model_ids_;
   size_t model_id_ = 1;
+  std::mutex cache_mutex_;
+  std::unordered_map<const Model *, std::shared_ptr<PackWeightCache>> pack_caches_;
+  // origin data of the const tensors of the models being prepared -> cache and tensor index
+  std::unordered_map<const void *, std::pair<std::shared_ptr<PackWeightCache>, size_t>> cache_origin_data_;
+  // packed data to be saved when the models are prepared
+  std::unordered_map<const void *, std::shared_ptr<PackWeightCache>> cache_packed_data_;
+  // packed data in the mapped cache files, a file is unmapped after all its data is freed
+  std::unordered_multimap<const void *, std::shared_ptr<PackWeightCache>> cache_mapped_data_;
 };
 }  // namespace mindspore::lite
 #endif  // MINDSPORE_LITE_SRC_RUNTIME_PACK_WEIGHT_MANAGER_H_
@@ -79,6 +79,13 @@ void RuntimeAllocator::SetDataOffset(lite::Tensor *tensor, size_t offset) {
   return;
 }
 
+void RuntimeAllocator::RestorePlan(const std::unordered_map<lite::Tensor *, size_t> &offset_map, size_t total_size) {
+  offset_map_ = offset_map;
+  total_size_ = total_size;
+  free_list_.clear();
+  used_list_.clear();
+}
+
 void RuntimeAllocator::Clear(AllocatorPtr default_allocator) {
   total_size_ = 0;
   for (auto iter : offset_map_) {
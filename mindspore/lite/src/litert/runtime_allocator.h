@@ -44,6 +44,9 @@ class RuntimeAllocator : public Allocator {
   void FreeTensorData(lite::Tensor *tensor);
   void *MallocOptData();
   const std::unordered_map<lite::Tensor *, size_t> &GetOffsetMap() const { return offset_map_; }
+  size_t GetTotalSize() const { return total_size_; }
+  // reuse an offset plan computed before for the same shapes, instead of replaying Malloc/Free.
+  void RestorePlan(const std::unordered_map<lite::Tensor *, size_t> &offset_map, size_t total_size);
   void Clear(AllocatorPtr default_allocator);
 
  private:
@@ -0,0 +1,68 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/litert/shape_plan_cache.h"
+#include "src/common/log_adapter.h"
+
+namespace mindspore::lite {
+std::string ShapePlanCache::GenerateKey(const std::vector<Tensor *> &inputs) {
+  std::string key;
+  for (auto input : inputs) {
+    MS_ASSERT(input != nullptr);
+    for (auto dim : input->shape()) {
+      key += std::to_string(dim);
+      key += ',';
+    }
+    key += ';';
+  }
+  return key;
+}
+
+const ShapePlan *ShapePlanCache::Find(const std::string &key) {
+  auto iter = plan_map_.find(key);
+  if (iter == plan_map_.end()) {
+    miss_count_++;
+    return nullptr;
+  }
+  hit_count_++;
+  plans_.splice(plans_.begin(), plans_, iter->second);
+  return &(iter->second->second);
+}
+
+void ShapePlanCache::Insert(const std::string &key, ShapePlan &&plan) {
+  if (capacity_ == 0) {
+    return;
+  }
+  auto iter = plan_map_.find(key);
+  if (iter != plan_map_.end()) {
+    iter->second->second = std::move(plan);
+    plans_.splice(plans_.begin(), plans_, iter->second);
+    return;
+  }
+  if (plans_.size() >= capacity_) {
+    MS_LOG(DEBUG) << "shape plan cache is full, evict plan: " << plans_.back().first;
+    plan_map_.erase(plans_.back().first);
+    plans_.pop_back();
+  }
+  plans_.emplace_front(key, std::move(plan));
+  plan_map_[key] = plans_.begin();
+}
+
+void ShapePlanCache::Clear() {
+  plans_.clear();
+  plan_map_.clear();
+}
+}  // namespace mindspore::lite
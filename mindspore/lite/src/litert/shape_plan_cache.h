@@ -0,0 +1,66 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_SHAPE_PLAN_CACHE_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_SHAPE_PLAN_CACHE_H_
+
+#include <list>
+#include <string>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include "src/tensor.h"
+
+namespace mindspore::lite {
+// The memory plan 'Resize' derives from a set of input shapes: the offset of every tensor served by the runtime
+// allocator. Shape infer still runs on a hit, because infer functions also update op parameters, and the inferred
+// shapes are checked against tensor_shapes before the offsets are reused.
+struct ShapePlan {
+  std::vector<std::pair<Tensor *, std::vector<int>>> tensor_shapes;
+  // empty when the runtime allocator is not used.
+  std::vector<Tensor *> runtime_tensors;
+  std::unordered_map<Tensor *, size_t> offset_map;
+  size_t total_size = 0;
+};
+
+// LRU cache of ShapePlan keyed by the shapes of the graph inputs.
+class ShapePlanCache {
+ public:
+  explicit ShapePlanCache(size_t capacity) : capacity_(capacity) {}
+  ~ShapePlanCache() = default;
+
+  static std::string GenerateKey(const std::vector<Tensor *> &inputs);
+
+  // the returned plan is valid until the next Insert.
+  const ShapePlan *Find(const std::string &key);
+  void Insert(const std::string &key, ShapePlan &&plan);
+  void Clear();
+
+  size_t size() const { return plans_.size(); }
+  size_t hit_count() const { return hit_count_; }
+  size_t miss_count() const { return miss_count_; }
+
+ private:
+  using PlanList = std::list<std::pair<std::string, ShapePlan>>;
+  size_t capacity_ = 0;
+  PlanList plans_;  // most recently used at front
+  std::unordered_map<std::string, PlanList::iterator> plan_map_;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+};
+}  // namespace mindspore::lite
+
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_SHAPE_PLAN_CACHE_H_
@@ -0,0 +1,125 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <random>
+#include <vector>
+#include "common/common_test.h"
+#include "nnacl/int8/matmul_int8.h"
+#ifdef ENABLE_AVX512
+#include "nnacl/int8/matmul_vnni_int8.h"
+#include "nnacl/intrinsics/ms_simd_cpu_info.h"
+#endif
+
+namespace mindspore {
+class MatmulVnniInt8Test : public mindspore::CommonTest {
+ public:
+  MatmulVnniInt8Test() {}
+};
+
+#ifdef ENABLE_AVX512
+// a is deep x row when a_transpose is set, b is col x deep when b_transpose is set.
+void CheckMatmulVnniInt8(int row, int col, int deep, bool per_channel, bool a_transpose, bool b_transpose) {
+  std::mt19937 gen(row * col + deep);
+  std::uniform_int_distribution<int> dist(-128, 127);
+  std::vector<int8_t> a(row * deep);
+  std::vector<int8_t> b(deep * col);
+  for (auto &v : a) {
+    v = static_cast<int8_t>(dist(gen));
+  }
+  for (auto &v : b) {
+    v = static_cast<int8_t>(dist(gen));
+  }
+  std::vector<int32_t> multiplier(col, 1518500250);
+  std::vector<int32_t> left_shift(col, 0);
+  std::vector<int32_t> right_shift(col, -10);
+  std::vector<int32_t> filter_zp(col);
+  std::vector<int32_t> bias(col);
+  for (int c = 0; c < col; ++c) {
+    filter_zp[c] = c % 5 - 2;
+    bias[c] = c * 31 - 500;
+  }
+  int input_zp = -3;
+  int output_zp = 5;
+  int input_sum_zp = per_channel ? 1 : filter_zp[0];
+  DataOrder a_order = a_transpose ? ColMajor : RowMajor;
+  DataOrder b_order = b_transpose ? ColMajor : RowMajor;
+  std::vector<int32_t> input_sums(UP_ROUND(row, C4NUM));
+  CalcInputSums(a.data(), row, deep, input_sum_zp, input_sums.data(), a_order);
+
+  // reference: the 16x4 kernel
+  int deep16 = UP_ROUND(deep, C16NUM);
+  std::vector<int8_t> pack_a(UP_ROUND(row, C4NUM) * deep16, 0);
+  std::vector<int8_t> pack_b(UP_ROUND(col, C4NUM) * deep16, 0);
+  std::vector<int32_t> weight_sums(UP_ROUND(col, C4NUM));
+  if (a_transpose) {
+    RowMajor2Col16x4MajorInt8(a.data(), pack_a.data(), deep, row);
+  } else {
+    RowMajor2Row16x4MajorInt8(a.data(), pack_a.data(), row, deep);
+  }
+  if (b_transpose) {
+    RowMajor2Row16x4MajorInt8(b.data(), pack_b.data(), col, deep);
+  } else {
+    RowMajor2Col16x4MajorInt8(b.data(), pack_b.data(), deep, col);
+  }
+  CalcWeightBiasSums(b.data(), deep, col, input_zp, filter_zp.data(), bias.data(), weight_sums.data(), b_order,
+                     per_channel);
+  std::vector<int8_t> expect(row * col);
+  MatmulInt8Opt(pack_a.data(), pack_b.data(), expect.data(), row, col, deep16, input_sums.data(), weight_sums.data(),
+                INT8_MIN, INT8_MAX, output_zp, multiplier.data(), left_shift.data(), right_shift.data(), col,
+                per_channel, filter_zp.data());
+
+  int deep4 = UP_ROUND(deep, C4NUM);
+  std::vector<int8_t> vnni_a(row * deep4, 0);
+  std::vector<int8_t> vnni_b(UP_ROUND(col, C16NUM) * deep4, 0);
+  std::vector<int32_t> vnni_sums(UP_ROUND(col, C16NUM));
+  if (a_transpose) {
+    RowMajor2ColVnniInt8(a.data(), vnni_a.data(), deep, row);
+  } else {
+    RowMajor2RowVnniInt8(a.data(), vnni_a.data(), row, deep);
+  }
+  if (b_transpose) {
+    RowMajor2Row4x16MajorInt8(b.data(), vnni_b.data(), col, deep);
+  } else {
+    RowMajor2Col4x16MajorInt8(b.data(), vnni_b.data(), deep, col);
+  }
+  CalcVnniWeightBiasSums(b.data(), deep, col, input_zp, filter_zp.data(), bias.data(), vnni_sums.data(), b_order,
+                         per_channel);
+  std::vector<int8_t> output(row * col);
+  MatmulVnniInt8(vnni_a.data(), vnni_b.data(), output.data(), row, col, deep4, input_sums.data(), vnni_sums.data(),
+                 INT8_MIN, INT8_MAX, output_zp, multiplier.data(), left_shift.data(), right_shift.data(), col,
+                 per_channel, filter_zp.data());
+  ASSERT_EQ(expect, output);
+}
+
+/// Feature: VNNI int8 matmul.
+/// Description: Run the vnni kernel on shapes with row, col and deep tails, per-tensor and per-channel, with a and b
+/// transposed or not.
+/// Expectation: The output is bitwise equal to the 16x4 int8 kernel.
+TEST_F(MatmulVnniInt8Test, MatmulVnniInt8) {
+  IntelX86CpuInfoInit();
+  if (!X86_Avx512Vnni_Support()) {
+    return;
+  }
+  CheckMatmulVnniInt8(1, 1, 1, false, false, false);
+  CheckMatmulVnniInt8(13, 47, 29, false, false, true);
+  CheckMatmulVnniInt8(13, 47, 29, true, false, false);
+  CheckMatmulVnniInt8(64, 100, 257, true, false, true);
+  CheckMatmulVnniInt8(1, 1, 1, false, true, false);
+  CheckMatmulVnniInt8(13, 47, 29, false, true, false);
+  CheckMatmulVnniInt8(13, 47, 29, true, true, true);
+  CheckMatmulVnniInt8(64, 100, 257, true, true, false);
+}
+#endif
+}  // namespace mindspore
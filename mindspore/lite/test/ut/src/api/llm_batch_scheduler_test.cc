@@ -0,0 +1,352 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "src/extendrt/cxx_api/llm_engine/llm_kv_cache_manager.h"
+#include "src/extendrt/cxx_api/llm_engine/llm_batch_scheduler.h"
+#include "src/extendrt/cxx_api/llm_engine/llm_engine.h"
+#include "src/extendrt/cxx_api/llm_engine/llm_engine_plugin.h"
+
+namespace mindspore {
+// records the batches run by the engine instead of running a model.
+class FakeLLMEnginePlugin : public LLMEnginePluginBase {
+ public:
+  Status Init(const std::vector<LLMEngineModelInfo> &, LLMRole, uint64_t,
+              const std::map<std::string, std::string> &options, const std::string &,
+              const LLMEngineModelInfo &) override {
+    options_ = options;
+    return kSuccess;
+  }
+  void Finalize() override {}
+  Status Predict(const LLMReq &, const std::vector<MSTensor> &, std::vector<MSTensor> *) override { return kSuccess; }
+  Status Predict(const std::vector<LLMReq> &req, const std::vector<MSTensor> &, std::vector<MSTensor> *) override {
+    if (fail_predict_) {
+      fail_predict_ = false;
+      return kLiteError;
+    }
+    std::vector<uint64_t> batch;
+    for (auto &item : req) {
+      batch.push_back(item.req_id);
+    }
+    batches_.push_back(batch);
+    return kSuccess;
+  }
+  Status CompleteRequest(const LLMReq &) override { return kSuccess; }
+  LLMEngineStatus FetchStatus() override { return LLMEngineStatus(); }
+  Status PreloadPromptPrefix(const LLMReq &, const std::vector<MSTensor> &) override { return kSuccess; }
+  Status ReleasePromptPrefix(const LLMReq &) override { return kSuccess; }
+  Status PullKV(const LLMReq &) override { return kSuccess; }
+  Status MergeKV(const LLMReq &, uint32_t) override { return kSuccess; }
+  Status LinkClusters(const std::vector<LLMClusterInfo> &, std::vector<Status> *, int32_t) override {
+    return kSuccess;
+  }
+  Status UnlinkClusters(const std::vector<LLMClusterInfo> &, std::vector<Status> *, int32_t) override {
+    return kSuccess;
+  }
+
+  std::map<std::string, std::string> options_;
+  std::vector<std::vector<uint64_t>> batches_;
+  bool fail_predict_ = false;
+};
+
+class LLMBatchSchedulerTest : public CommonTest {
+ public:
+  LLMBatchSchedulerTest() = default;
+
+  std::shared_ptr<LLMKVCacheManager> CreateKVCache(size_t num_blocks) {
+    LLMKVCacheConfig config;
+    config.num_layers = 2;
+    config.num_kv_heads = 2;
+    config.head_dim = 4;
+    config.block_size = 4;
+    config.num_blocks = num_blocks;
+    auto kv_cache = std::make_shared<LLMKVCacheManager>();
+    EXPECT_EQ(kv_cache->Init(config), kSuccess);
+    return kv_cache;
+  }
+
+  LLMReq CreateReq(uint64_t req_id, uint64_t prompt_length, uint64_t prefix_id = UINT64_MAX) {
+    LLMReq req;
+    req.req_id = req_id;
+    req.prompt_length = prompt_length;
+    req.prefix_id = prefix_id;
+    return req;
+  }
+
+  std::map<std::string, std::string> CreateBatchingOptions(size_t num_blocks) {
+    return {{"llm.KvCacheNumBlocks", std::to_string(num_blocks)},
+            {"llm.KvCacheBlockSize", "4"},
+            {"llm.MaxBatchSize", "2"},
+            {"llm.MaxBatchTokens", "16"},
+            {"llm.OmCachePath", "./"}};
+  }
+};
+
+TEST_F(LLMBatchSchedulerTest, KVCacheBlockTable) {
+  auto kv_cache = CreateKVCache(8);
+  ASSERT_EQ(kv_cache->AddSequence(0), kSuccess);
+  ASSERT_EQ(kv_cache->AppendSlots(0, 5), kSuccess);
+  ASSERT_EQ(kv_cache->GetFreeBlockNum(), 6);
+  ASSERT_EQ(kv_cache->GetAppendBlockNum(0, 3), 0);
+  ASSERT_EQ(kv_cache->AppendSlots(0, 4), kSuccess);
+  std::vector<int32_t> block_table;
+  ASSERT_EQ(kv_cache->GetBlockTable(0, &block_table), kSuccess);
+  ASSERT_EQ(block_table.size(), 3);
+  std::vector<int64_t> slots;
+  ASSERT_EQ(kv_cache->GetSlotMapping(0, 4, 2, &slots), kSuccess);
+  ASSERT_EQ(slots[0], block_table[1] * 4);
+  ASSERT_EQ(slots[1], block_table[1] * 4 + 1);
+  ASSERT_NE(kv_cache->AppendSlots(0, 40), kSuccess);
+  ASSERT_EQ(kv_cache->FreeSequence(0), kSuccess);
+  ASSERT_EQ(kv_cache->GetFreeBlockNum(), 8);
+}
+
+TEST_F(LLMBatchSchedulerTest, KVCachePrefixSharing) {
+  auto kv_cache = CreateKVCache(8);
+  ASSERT_EQ(kv_cache->AddPrefix(100, 6), kSuccess);
+  ASSERT_EQ(kv_cache->GetFreeBlockNum(), 6);
+  std::vector<int32_t> prefix_table;
+  ASSERT_EQ(kv_cache->AddSequence(0, 100), kSuccess);
+  ASSERT_EQ(kv_cache->GetBlockTable(0, &prefix_table), kSuccess);
+  auto shared_block = prefix_table.back();
+  kv_cache->KeyBlock(1, shared_block)[0] = 7;
+  ASSERT_EQ(kv_cache->AddSequence(1, 100), kSuccess);
+  ASSERT_EQ(kv_cache->GetBlockRefCount(prefix_table[0]), 3);
+  // the last prefix block is half full and shared, writing to it copies it first.
+  ASSERT_EQ(kv_cache->GetAppendBlockNum(0, 1), 1);
+  ASSERT_EQ(kv_cache->AppendSlots(0, 1), kSuccess);
+  std::vector<int32_t> block_table;
+  ASSERT_EQ(kv_cache->GetBlockTable(0, &block_table), kSuccess);
+  ASSERT_EQ(block_table[0], prefix_table[0]);
+  ASSERT_NE(block_table[1], shared_block);
+  ASSERT_EQ(kv_cache->KeyBlock(1, block_table[1])[0], 7);
+  ASSERT_EQ(kv_cache->GetBlockRefCount(shared_block), 2);
+  ASSERT_EQ(kv_cache->ReleasePrefix(100), kSuccess);
+  ASSERT_EQ(kv_cache->FreeSequence(0), kSuccess);
+  ASSERT_EQ(kv_cache->FreeSequence(1), kSuccess);
+  ASSERT_EQ(kv_cache->GetFreeBlockNum(), 8);
+}
+
+TEST_F(LLMBatchSchedulerTest, ContinuousBatching) {
+  auto kv_cache = CreateKVCache(16);
+  LLMBatchSchedulerConfig config;
+  config.max_batch_size = 2;
+  config.max_batch_tokens = 32;
+  LLMBatchScheduler scheduler;
+  ASSERT_EQ(scheduler.Init(config, kv_cache), kSuccess);
+  ASSERT_EQ(scheduler.AddRequest(CreateReq(0, 7)), kSuccess);
+  ASSERT_EQ(scheduler.AddRequest(CreateReq(1, 3)), kSuccess);
+  ASSERT_EQ(scheduler.AddRequest(CreateReq(2, 5)), kSuccess);
+  ASSERT_EQ(scheduler.AddRequest(CreateReq(2, 5)), kLiteLLMRepeatRequest);
+
+  LLMScheduleOutput output;
+  ASSERT_EQ(scheduler.Schedule(&output), kSuccess);
+  ASSERT_EQ(output.seqs.size(), 2);
+  ASSERT_TRUE(output.seqs[0].is_prefill);
+  ASSERT_EQ(output.num_batch_tokens, 10);
+  ASSERT_EQ(scheduler.StepDone(output), kSuccess);
+
+  ASSERT_EQ(scheduler.Schedule(&output), kSuccess);
+  ASSERT_EQ(output.seqs.size(), 2);
+  ASSERT_FALSE(output.seqs[1].is_prefill);
+  ASSERT_EQ(output.seqs[1].start_pos, 3);
+  ASSERT_EQ(output.seqs[1].num_tokens, 1);
+  ASSERT_EQ(scheduler.StepDone(output), kSuccess);
+
+  // request 1 leaves the batch and request 2 joins it in the same step.
+  ASSERT_EQ(scheduler.CompleteRequest(CreateReq(1, 3)), kSuccess);
+  ASSERT_EQ(scheduler.Schedule(&output), kSuccess);
+  ASSERT_EQ(output.retired.size(), 1);
+  ASSERT_EQ(output.seqs.size(), 2);
+  ASSERT_EQ(output.seqs[0].req_id, 0);
+  ASSERT_EQ(output.seqs[0].num_tokens, 1);
+  ASSERT_EQ(output.seqs[1].req_id, 2);
+  ASSERT_TRUE(output.seqs[1].is_prefill);
+  ASSERT_EQ(output.num_batch_tokens, 6);
+  ASSERT_EQ(scheduler.StepDone(output), kSuccess);
+  ASSERT_EQ(scheduler.GetWaitingNum(), 0);
+}
+
+TEST_F(LLMBatchSchedulerTest, PreemptWhenKVCacheIsFull) {
+  auto kv_cache = CreateKVCache(4);
+  LLMBatchSchedulerConfig config;
+  config.max_batch_size = 4;
+  config.max_batch_tokens = 64;
+  LLMBatchScheduler scheduler;
+  ASSERT_EQ(scheduler.Init(config, kv_cache), kSuccess);
+  ASSERT_EQ(scheduler.AddRequest(CreateReq(0, 8)), kSuccess);
+  ASSERT_EQ(scheduler.AddRequest(CreateReq(1, 8)), kSuccess);
+  LLMScheduleOutput output;
+  ASSERT_EQ(scheduler.Schedule(&output), kSuccess);
+  ASSERT_EQ(output.seqs.size(), 2);
+  ASSERT_EQ(kv_cache->GetFreeBlockNum(), 0);
+  ASSERT_EQ(scheduler.StepDone(output), kSuccess);
+
+  // both need a new block, the latest admitted one gives its blocks back.
+  ASSERT_EQ(scheduler.Schedule(&output), kSuccess);
+  ASSERT_EQ(output.preempted.size(), 1);
+  ASSERT_EQ(output.preempted[0], 1);
+  ASSERT_EQ(output.seqs.size(), 1);
+  ASSERT_EQ(output.seqs[0].req_id, 0);
+  ASSERT_EQ(scheduler.StepDone(output), kSuccess);
+  ASSERT_EQ(scheduler.GetWaitingNum(), 1);
+
+  ASSERT_EQ(scheduler.CompleteRequest(CreateReq(0, 8)), kSuccess);
+  ASSERT_EQ(scheduler.Schedule(&output), kSuccess);
+  ASSERT_EQ(output.seqs.size(), 1);
+  ASSERT_EQ(output.seqs[0].req_id, 1);
+  ASSERT_TRUE(output.seqs[0].is_prefill);
+  // the token generated before preemption is recomputed with the prompt.
+  ASSERT_EQ(output.seqs[0].num_tokens, 9);
+}
+
+TEST_F(LLMBatchSchedulerTest, PrefixRequest) {
+  auto kv_cache = CreateKVCache(8);
+  ASSERT_EQ(kv_cache->AddPrefix(100, 8), kSuccess);
+  LLMBatchScheduler scheduler;
+  ASSERT_EQ(scheduler.Init(LLMBatchSchedulerConfig(), kv_cache), kSuccess);
+  ASSERT_EQ(scheduler.AddRequest(CreateReq(0, 3, 100)), kSuccess);
+  ASSERT_EQ(scheduler.AddRequest(CreateReq(1, 3, 200)), kLiteLLMKVCacheNotExist);
+  LLMScheduleOutput output;
+  ASSERT_EQ(scheduler.Schedule(&output), kSuccess);
+  ASSERT_EQ(output.seqs.size(), 1);
+  ASSERT_EQ(output.seqs[0].start_pos, 8);
+  ASSERT_EQ(output.seqs[0].num_tokens, 3);
+  ASSERT_EQ(output.seqs[0].block_table.size(), 3);
+}
+
+TEST_F(LLMBatchSchedulerTest, EngineContinuousBatching) {
+  auto plugin = std::make_shared<FakeLLMEnginePlugin>();
+  LLMEngine engine(plugin);
+  ASSERT_EQ(engine.Init({}, kLLMRoleDecoder, 0, CreateBatchingOptions(4), "", ""), kSuccess);
+  // the batching options are consumed by the engine.
+  ASSERT_EQ(plugin->options_.size(), 1);
+  ASSERT_EQ(plugin->options_.count("llm.OmCachePath"), 1);
+
+  std::vector<MSTensor> inputs;
+  std::vector<MSTensor> outputs;
+  ASSERT_NE(engine.Predict(std::vector<LLMReq>{CreateReq(0, 5)}, inputs, &outputs), kSuccess);
+  LLMScheduleOutput output;
+  ASSERT_EQ(engine.Schedule({CreateReq(0, 5), CreateReq(1, 3)}, &output), kSuccess);
+  ASSERT_EQ(output.seqs.size(), 2);
+  ASSERT_TRUE(output.seqs[0].is_prefill);
+  ASSERT_NE(engine.Schedule({}, &output), kSuccess);
+  // the batch must be the scheduled one, in the same order.
+  ASSERT_NE(engine.Predict({CreateReq(1, 3), CreateReq(0, 5)}, inputs, &outputs), kSuccess);
+  ASSERT_EQ(engine.Predict({CreateReq(0, 5), CreateReq(1, 3)}, inputs, &outputs), kSuccess);
+  ASSERT_EQ(plugin->batches_.size(), 1);
+  ASSERT_NE(engine.Predict({CreateReq(0, 5), CreateReq(1, 3)}, inputs, &outputs), kSuccess);
+  // 5 + 3 tokens take 3 blocks of 4 tokens.
+  ASSERT_EQ(engine.FetchStatus().empty_max_prompt_kv, 4);
+
+  ASSERT_EQ(engine.Schedule({}, &output), kSuccess);
+  ASSERT_EQ(output.seqs.size(), 2);
+  ASSERT_FALSE(output.seqs[0].is_prefill);
+  ASSERT_EQ(output.seqs[0].start_pos, 5);
+  ASSERT_EQ(output.seqs[0].num_tokens, 1);
+  // a failed step stays scheduled and is run again.
+  plugin->fail_predict_ = true;
+  ASSERT_NE(engine.Predict({CreateReq(0, 5), CreateReq(1, 3)}, inputs, &outputs), kSuccess);
+  ASSERT_EQ(engine.Predict({CreateReq(0, 5), CreateReq(1, 3)}, inputs, &outputs), kSuccess);
+
+  ASSERT_EQ(engine.CompleteRequest(CreateReq(0, 5)), kSuccess);
+  ASSERT_EQ(engine.Schedule({}, &output), kSuccess);
+  ASSERT_EQ(output.retired.size(), 1);
+  ASSERT_EQ(output.retired[0], 0);
+  ASSERT_EQ(output.seqs.size(), 1);
+  ASSERT_EQ(output.seqs[0].req_id, 1);
+  ASSERT_EQ(engine.Predict(std::vector<LLMReq>{CreateReq(1, 3)}, inputs, &outputs), kSuccess);
+  ASSERT_EQ(plugin->batches_.size(), 3);
+  engine.Finalize();
+}
+
+TEST_F(LLMBatchSchedulerTest, EngineWithoutBatching) {
+  auto plugin = std::make_shared<FakeLLMEnginePlugin>();
+  LLMEngine engine(plugin);
+  ASSERT_EQ(engine.Init({}, kLLMRoleDecoder, 0, {}, "", ""), kSuccess);
+  LLMScheduleOutput output;
+  ASSERT_EQ(engine.Schedule({CreateReq(0, 5)}, &output), kLiteUninitializedObj);
+  std::vector<MSTensor> inputs;
+  std::vector<MSTensor> outputs;
+  ASSERT_EQ(engine.Predict({CreateReq(1, 3), CreateReq(0, 5)}, inputs, &outputs), kSuccess);
+  ASSERT_EQ(plugin->batches_.size(), 1);
+
+  LLMEngine invalid_engine(std::make_shared<FakeLLMEnginePlugin>());
+  std::map<std::string, std::string> options = {{"llm.KvCacheNumBlocks", "-1"}};
+  ASSERT_EQ(invalid_engine.Init({}, kLLMRoleDecoder, 0, options, "", ""), kLiteParamInvalid);
+}
+
+TEST_F(LLMBatchSchedulerTest, EnginePrefixWhileStepping) {
+  constexpr size_t kNumBlocks = 64;
+  constexpr uint64_t kStepNum = 200;
+  auto plugin = std::make_shared<FakeLLMEnginePlugin>();
+  LLMEngine engine(plugin);
+  ASSERT_EQ(engine.Init({}, kLLMRoleDecoder, 0, CreateBatchingOptions(kNumBlocks), "", ""), kSuccess);
+  std::atomic_bool stop = false;
+  std::atomic_bool prefix_failed = false;
+  // prefixes are preloaded and released by another thread while the steps take and free blocks.
+  std::thread prefix_thread([&engine, &stop, &prefix_failed, this]() {
+    uint64_t prefix_id = 1000;
+    while (!stop) {
+      auto req = CreateReq(0, 4, prefix_id++);
+      auto ret = engine.PreloadPromptPrefix(req, {});
+      if (ret == kSuccess) {
+        prefix_failed = prefix_failed || engine.ReleasePromptPrefix(req) != kSuccess;
+      }
+      (void)engine.FetchStatus();
+    }
+  });
+  std::vector<MSTensor> inputs;
+  std::vector<MSTensor> outputs;
+  for (uint64_t step = 0; step < kStepNum; step++) {
+    LLMScheduleOutput output;
+    ASSERT_EQ(engine.Schedule({CreateReq(step, 4)}, &output), kSuccess);
+    std::vector<LLMReq> batch;
+    for (auto &seq : output.seqs) {
+      batch.push_back(CreateReq(seq.req_id, 4));
+    }
+    if (!batch.empty()) {
+      ASSERT_EQ(engine.Predict(batch, inputs, &outputs), kSuccess);
+    }
+    for (auto &req : batch) {
+      ASSERT_EQ(engine.CompleteRequest(req), kSuccess);
+    }
+  }
+  stop = true;
+  prefix_thread.join();
+  ASSERT_FALSE(prefix_failed);
+  // run the requests still waiting, every block is back once all of them are retired.
+  LLMScheduleOutput output;
+  ASSERT_EQ(engine.Schedule({}, &output), kSuccess);
+  while (!output.seqs.empty()) {
+    std::vector<LLMReq> batch;
+    for (auto &seq : output.seqs) {
+      batch.push_back(CreateReq(seq.req_id, 4));
+    }
+    ASSERT_EQ(engine.Predict(batch, inputs, &outputs), kSuccess);
+    for (auto &req : batch) {
+      ASSERT_EQ(engine.CompleteRequest(req), kSuccess);
+    }
+    ASSERT_EQ(engine.Schedule({}, &output), kSuccess);
+  }
+  ASSERT_EQ(engine.FetchStatus().empty_max_prompt_kv, kNumBlocks * 4);
+}
+}  // namespace mindspore
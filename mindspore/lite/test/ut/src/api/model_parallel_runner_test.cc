@@ -15,6 +15,7 @@
  */
 #include "include/api/model_parallel_runner.h"
 #include <memory>
+#include <thread>
 #include "common/common_test.h"
 #include "src/common/file_utils.h"
 
@@ -193,6 +194,85 @@ TEST_F(ModelParallelRunnerTest, RunnerPredict) {
   }
 }
 
+TEST_F(ModelParallelRunnerTest, RunnerPredictWithDynamicBatching) {
+  auto config = std::make_shared<RunnerConfig>();
+  ASSERT_NE(nullptr, config);
+
+  auto context = std::make_shared<Context>();
+  ASSERT_NE(nullptr, context);
+  auto &device_list = context->MutableDeviceInfo();
+  auto device_info = std::make_shared<mindspore::CPUDeviceInfo>();
+  ASSERT_NE(nullptr, device_info);
+  device_list.push_back(device_info);
+  ASSERT_EQ(device_list.size(), 1);
+
+  config->SetContext(context);
+  config->SetWorkersNum(2);
+  std::map<std::string, std::string> batch_config = {
+    {"enable_dynamic_batching", "true"}, {"max_batch_size", "4"}, {"batch_timeout_us", "2000"}};
+  config->SetConfigInfo("dynamic_batching", batch_config);
+  ModelParallelRunner runner;
+  auto status = runner.Init(model_path, config);
+  ASSERT_EQ(status, kSuccess);
+
+  // the first predict does warm up for all workers
+  auto inputs = runner.GetInputs();
+  SetInputTensorData(&inputs);
+  std::vector<MSTensor> outputs;
+  status = runner.Predict(inputs, &outputs);
+  ASSERT_EQ(status, kSuccess);
+
+  // every request gets its own input, so each must get its own slice of the batched output back
+  constexpr size_t kRequestNum = 4;
+  auto origin_data = static_cast<const float *>(inputs.front().Data().get());
+  auto element_num = inputs.front().ElementNum();
+  std::vector<std::vector<float>> request_data(kRequestNum);
+  std::vector<std::vector<MSTensor>> request_inputs(kRequestNum);
+  std::vector<std::vector<MSTensor>> expect_outputs(kRequestNum);
+  // a kernel callback keeps the request on the direct path, which gives the expected output
+  MSKernelCallBack direct = [](const std::vector<MSTensor> &, const std::vector<MSTensor> &, const MSCallBackParam &) {
+    return true;
+  };
+  for (size_t i = 0; i < kRequestNum; i++) {
+    request_data[i].resize(element_num);
+    for (int64_t j = 0; j < element_num; j++) {
+      request_data[i][j] = origin_data[j] * static_cast<float>(i + 1) / kRequestNum;
+    }
+    auto &input = inputs.front();
+    auto tensor = MSTensor::CreateRefTensor(input.Name(), input.DataType(), input.Shape(), request_data[i].data(),
+                                            request_data[i].size() * sizeof(float));
+    ASSERT_NE(tensor, nullptr);
+    request_inputs[i].push_back(*tensor);
+    MSTensor::DestroyTensorPtr(tensor);
+    ASSERT_EQ(runner.Predict(request_inputs[i], &expect_outputs[i], direct, nullptr), kSuccess);
+  }
+  std::vector<std::vector<MSTensor>> all_outputs(kRequestNum);
+  std::vector<Status> all_status(kRequestNum, kLiteError);
+  std::vector<std::thread> requests;
+  for (size_t i = 0; i < kRequestNum; i++) {
+    requests.push_back(
+      std::thread([&, i]() { all_status[i] = runner.Predict(request_inputs[i], &all_outputs[i]); }));
+  }
+  for (auto &request : requests) {
+    request.join();
+  }
+  for (size_t i = 0; i < kRequestNum; i++) {
+    ASSERT_EQ(all_status[i], kSuccess);
+    ASSERT_EQ(all_outputs[i].size(), 1);
+    ASSERT_EQ(all_outputs[i].front().DataSize(), kOutputDataSize);
+    ASSERT_EQ(all_outputs[i].front().Shape(), expect_outputs[i].front().Shape());
+    ASSERT_EQ(0, CompareOutputData(static_cast<const float *>(all_outputs[i].front().Data().get()),
+                                   static_cast<const float *>(expect_outputs[i].front().Data().get()),
+                                   all_outputs[i].front().ElementNum()));
+  }
+  // free user data
+  for (auto &tensor : inputs) {
+    char *data = static_cast<char *>(tensor.MutableData());
+    delete[] data;
+    tensor.SetData(nullptr);
+  }
+}
+
 TEST_F(ModelParallelRunnerTest, RunnerInitByBuf) {
   auto config = std::make_shared<RunnerConfig>();
   ASSERT_NE(nullptr, config);
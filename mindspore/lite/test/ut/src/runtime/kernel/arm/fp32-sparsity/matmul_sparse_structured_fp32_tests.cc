@@ -0,0 +1,249 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "common/common_test.h"
+#include "nnacl/matmul_parameter.h"
+#include "src/litert/inner_context.h"
+#include "src/litert/kernel/cpu/fp32/matmul_fp32.h"
+#include "src/litert/kernel/cpu/fp32_sparse/matmul_sparse_structured_fp32.h"
+
+namespace mindspore {
+class TestMatmulSparseStructuredFp32 : public mindspore::CommonTest {
+ public:
+  TestMatmulSparseStructuredFp32() {}
+
+  float RandomValue() {
+    seed_ = seed_ * 1103515245 + 12345;
+    return static_cast<float>((seed_ >> 16) % 2000) / 1000.0f - 1.0f;
+  }
+
+  int RandomInt(int range) {
+    seed_ = seed_ * 1103515245 + 12345;
+    return static_cast<int>((seed_ >> 16) % range);
+  }
+
+  // weight [deep][col] keeping one in four of the block_k x block_n blocks.
+  std::vector<float> BlockSparseWeight(int deep, int col, int block_k, int block_n) {
+    std::vector<float> weight(deep * col, 0.0f);
+    for (int k = 0; k < deep; k += block_k) {
+      for (int j = 0; j < col; j += block_n) {
+        if (RandomInt(C4NUM) != 0) {
+          continue;
+        }
+        for (int kk = k; kk < std::min(k + block_k, deep); kk++) {
+          for (int jj = j; jj < std::min(j + block_n, col); jj++) {
+            weight[kk * col + jj] = RandomValue();
+          }
+        }
+      }
+    }
+    return weight;
+  }
+
+  // weight [deep][col] with n nonzero values in every m deep elements of each column.
+  std::vector<float> NMSparseWeight(int deep, int col, int m, int n = 1) {
+    std::vector<float> weight(deep * col, 0.0f);
+    for (int j = 0; j < col; j++) {
+      for (int k = 0; k < deep; k += m) {
+        int offset = RandomInt(m);
+        for (int i = 0; i < n; i++) {
+          int pos = k + (offset + i) % m;
+          if (pos < deep) {
+            weight[pos * col + j] = RandomValue();
+          }
+        }
+      }
+    }
+    return weight;
+  }
+
+  std::vector<float> Transpose(const std::vector<float> &src, int row, int col) {
+    std::vector<float> dst(src.size());
+    for (int i = 0; i < row; i++) {
+      for (int j = 0; j < col; j++) {
+        dst[j * row + i] = src[i * col + j];
+      }
+    }
+    return dst;
+  }
+
+  // weight is [deep][col] no matter b_transpose, the weight tensor takes the transposed data.
+  void RunCase(int batch, int row, int deep, int col, const std::vector<float> &weight, bool b_transpose,
+               ActType act_type, int thread_num, bool through_matmul, int expect_format) {
+    std::vector<float> input(batch * row * deep);
+    for (auto &value : input) {
+      value = RandomValue();
+    }
+    std::vector<float> bias(col);
+    for (auto &value : bias) {
+      value = RandomValue();
+    }
+    auto weight_data = b_transpose ? Transpose(weight, deep, col) : weight;
+    std::vector<float> out(batch * row * col, 0.0f);
+    lite::Tensor in_tensor(kNumberTypeFloat32, {batch, row, deep});
+    std::vector<int> weight_shape = b_transpose ? std::vector<int>{col, deep} : std::vector<int>{deep, col};
+    lite::Tensor weight_tensor(kNumberTypeFloat32, weight_shape, NHWC, lite::Category::CONST_TENSOR);
+    lite::Tensor bias_tensor(kNumberTypeFloat32, {col}, NHWC, lite::Category::CONST_TENSOR);
+    lite::Tensor out_tensor(kNumberTypeFloat32, {batch, row, col});
+    in_tensor.set_data(input.data());
+    weight_tensor.set_data(weight_data.data());
+    bias_tensor.set_data(bias.data());
+    out_tensor.set_data(out.data());
+    std::vector<lite::Tensor *> inputs = {&in_tensor, &weight_tensor, &bias_tensor};
+    std::vector<lite::Tensor *> outputs = {&out_tensor};
+
+    auto param = reinterpret_cast<MatMulParameter *>(malloc(sizeof(MatMulParameter)));
+    ASSERT_NE(param, nullptr);
+    memset(param, 0, sizeof(MatMulParameter));
+    param->op_parameter_.type_ = schema::PrimitiveType_MatMulFusion;
+    param->op_parameter_.thread_num_ = thread_num;
+    param->b_transpose_ = b_transpose;
+    param->has_bias_ = true;
+    param->act_type_ = act_type;
+    auto ctx = std::make_shared<lite::InnerContext>();
+    ctx->thread_num_ = thread_num;
+    ASSERT_EQ(lite::RET_OK, ctx->Init());
+    kernel::LiteKernel *kernel = nullptr;
+    if (through_matmul) {
+      kernel = new kernel::MatmulCPUKernel(reinterpret_cast<OpParameter *>(param), inputs, outputs, ctx.get());
+    } else {
+      auto sparse_kernel =
+        new kernel::MatmulSparseStructuredCPUKernel(reinterpret_cast<OpParameter *>(param), inputs, outputs, ctx.get());
+      kernel = sparse_kernel;
+      ASSERT_EQ(lite::RET_OK, kernel->Prepare());
+      EXPECT_EQ(expect_format, sparse_kernel->GetWeightFormat());
+    }
+    if (through_matmul) {
+      ASSERT_EQ(lite::RET_OK, kernel->Prepare());
+    }
+    ASSERT_EQ(lite::RET_OK, kernel->Run());
+
+    std::vector<float> expect(out.size());
+    for (int r = 0; r < batch * row; r++) {
+      for (int j = 0; j < col; j++) {
+        float value = bias[j];
+        for (int k = 0; k < deep; k++) {
+          value += input[r * deep + k] * weight[k * col + j];
+        }
+        if (act_type == ActType_Relu) {
+          value = std::max(value, 0.0f);
+        }
+        expect[r * col + j] = value;
+      }
+    }
+    ASSERT_EQ(0, CompareOutputData(out.data(), expect.data(), out.size()));
+
+    for (auto tensor : inputs) {
+      tensor->set_data(nullptr);
+    }
+    out_tensor.set_data(nullptr);
+    delete kernel;
+  }
+
+ private:
+  uint32_t seed_ = 11;
+};
+
+TEST_F(TestMatmulSparseStructuredFp32, BlockSparse) {
+  auto weight = BlockSparseWeight(67, 45, C1NUM, C4NUM);
+  RunCase(2, 37, 67, 45, weight, false, ActType_Relu, 3, false, SparseWeightFormat_Block);
+}
+
+TEST_F(TestMatmulSparseStructuredFp32, BlockSparseSplitColumns) {
+  auto weight = BlockSparseWeight(64, 200, C4NUM, C4NUM);
+  RunCase(1, 3, 64, 200, weight, true, ActType_No, 4, false, SparseWeightFormat_Block);
+}
+
+TEST_F(TestMatmulSparseStructuredFp32, NMSparse) {
+  auto weight = NMSparseWeight(70, 33, C8NUM);
+  RunCase(1, 21, 70, 33, weight, true, ActType_No, 2, false, SparseWeightFormat_NM);
+}
+
+TEST_F(TestMatmulSparseStructuredFp32, SelectedByMatmul) {
+  auto weight = NMSparseWeight(48, 40, C16NUM);
+  RunCase(2, 17, 48, 40, weight, false, ActType_Relu, 2, true, SparseWeightFormat_NM);
+}
+
+TEST_F(TestMatmulSparseStructuredFp32, DenseWeightFallback) {
+  std::vector<float> weight(32 * 24);
+  for (auto &value : weight) {
+    value = RandomValue();
+  }
+  RunCase(1, 9, 32, 24, weight, false, ActType_No, 1, true, SparseWeightFormat_None);
+  lite::Tensor in_tensor(kNumberTypeFloat32, {9, 32});
+  lite::Tensor weight_tensor(kNumberTypeFloat32, {32, 24}, NHWC, lite::Category::CONST_TENSOR);
+  weight_tensor.set_data(weight.data());
+  MatMulParameter param;
+  memset(&param, 0, sizeof(MatMulParameter));
+  EXPECT_FALSE(kernel::MatmulSparseStructuredCPUKernel::IsSparseWeight(&param, {&in_tensor, &weight_tensor}));
+  weight_tensor.set_data(nullptr);
+}
+
+TEST_F(TestMatmulSparseStructuredFp32, NM2Of4Sparse) {
+  // 2:4 keeps half of the weight values, above the block threshold but within the n:m one.
+  auto weight = NMSparseWeight(64, 48, C4NUM, C2NUM);
+  RunCase(2, 13, 64, 48, weight, false, ActType_Relu, 2, false, SparseWeightFormat_NM);
+  RunCase(1, 7, 64, 48, weight, true, ActType_No, 1, false, SparseWeightFormat_NM);
+}
+
+TEST_F(TestMatmulSparseStructuredFp32, StructureThresholdFallback) {
+  // 12 dense rows in every 32, the 37.5% density passes the nonzero check but is above the block threshold and
+  // keeps more than half of the values of every n:m group.
+  std::vector<float> weight(64 * 48, 0.0f);
+  for (int k = 0; k < 64; k++) {
+    for (int j = 0; k % 32 < 12 && j < 48; j++) {
+      weight[k * 48 + j] = 1.0f;
+    }
+  }
+  lite::Tensor in_tensor(kNumberTypeFloat32, {5, 64});
+  lite::Tensor weight_tensor(kNumberTypeFloat32, {64, 48}, NHWC, lite::Category::CONST_TENSOR);
+  lite::Tensor out_tensor(kNumberTypeFloat32, {5, 48});
+  weight_tensor.set_data(weight.data());
+  auto param = reinterpret_cast<MatMulParameter *>(malloc(sizeof(MatMulParameter)));
+  ASSERT_NE(param, nullptr);
+  memset(param, 0, sizeof(MatMulParameter));
+  param->op_parameter_.thread_num_ = 1;
+  auto ctx = std::make_shared<lite::InnerContext>();
+  ASSERT_EQ(lite::RET_OK, ctx->Init());
+  auto kernel = new kernel::MatmulSparseStructuredCPUKernel(reinterpret_cast<OpParameter *>(param),
+                                                            {&in_tensor, &weight_tensor}, {&out_tensor}, ctx.get());
+  EXPECT_EQ(lite::RET_NOT_SUPPORT, kernel->Prepare());
+  EXPECT_EQ(SparseWeightFormat_None, kernel->GetWeightFormat());
+  weight_tensor.set_data(nullptr);
+  delete kernel;
+}
+
+TEST_F(TestMatmulSparseStructuredFp32, DensityThreshold) {
+  // 50% of 100 values is the threshold of the 2:4 pattern, the weight may have at most that many nonzeros.
+  std::vector<float> weight(10 * 10, 0.0f);
+  lite::Tensor in_tensor(kNumberTypeFloat32, {1, 10});
+  lite::Tensor weight_tensor(kNumberTypeFloat32, {10, 10}, NHWC, lite::Category::CONST_TENSOR);
+  weight_tensor.set_data(weight.data());
+  MatMulParameter param;
+  memset(&param, 0, sizeof(MatMulParameter));
+  EXPECT_TRUE(kernel::MatmulSparseStructuredCPUKernel::IsSparseWeight(&param, {&in_tensor, &weight_tensor}));
+  for (size_t i = 0; i < 50; i++) {
+    weight[weight.size() - 1 - i * 2] = 1.0f;
+  }
+  EXPECT_TRUE(kernel::MatmulSparseStructuredCPUKernel::IsSparseWeight(&param, {&in_tensor, &weight_tensor}));
+  weight[0] = 1.0f;
+  EXPECT_FALSE(kernel::MatmulSparseStructuredCPUKernel::IsSparseWeight(&param, {&in_tensor, &weight_tensor}));
+  weight_tensor.set_data(nullptr);
+}
+}  // namespace mindspore
@@ -0,0 +1,151 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "common/common_test.h"
+#include "nnacl/flash_attention_parameter.h"
+#include "mindspore/lite/src/litert/kernel_registry.h"
+
+namespace mindspore {
+class TestFlashAttentionFp32 : public mindspore::CommonTest {
+ public:
+  TestFlashAttentionFp32() {}
+
+  std::vector<float> RandomData(size_t size) {
+    std::vector<float> data(size);
+    for (auto &value : data) {
+      seed_ = seed_ * 1103515245 + 12345;
+      value = static_cast<float>((seed_ >> 16) % 2000) / 1000.0f - 1.0f;
+    }
+    return data;
+  }
+
+  // naive softmax(q * k^T * scale + mask) * v of BNSD q/k/v with the whole score matrix.
+  std::vector<float> Reference(const std::vector<float> &q, const std::vector<float> &k, const std::vector<float> &v,
+                               const std::vector<float> &mask, const std::vector<int> &q_shape,
+                               const std::vector<int> &k_shape, float scale, bool is_causal) {
+    int batch = q_shape[0], q_head = q_shape[1], q_seq = q_shape[2], head_size = q_shape[3];
+    int kv_head = k_shape[1], kv_seq = k_shape[2];
+    std::vector<float> out(q.size(), 0.0f);
+    std::vector<float> score(kv_seq);
+    for (int b = 0; b < batch; b++) {
+      for (int h = 0; h < q_head; h++) {
+        int kv_h = h / (q_head / kv_head);
+        const float *q_head_data = q.data() + (b * q_head + h) * q_seq * head_size;
+        const float *k_head_data = k.data() + (b * kv_head + kv_h) * kv_seq * head_size;
+        const float *v_head_data = v.data() + (b * kv_head + kv_h) * kv_seq * head_size;
+        float *out_head = out.data() + (b * q_head + h) * q_seq * head_size;
+        for (int i = 0; i < q_seq; i++) {
+          float max = -INFINITY;
+          for (int j = 0; j < kv_seq; j++) {
+            float dot = 0.0f;
+            for (int d = 0; d < head_size; d++) {
+              dot += q_head_data[i * head_size + d] * k_head_data[j * head_size + d];
+            }
+            score[j] = dot * scale + (mask.empty() ? 0.0f : mask[i * kv_seq + j]);
+            if (is_causal && j > i + kv_seq - q_seq) {
+              score[j] = -INFINITY;
+            }
+            max = std::max(max, score[j]);
+          }
+          float sum = 0.0f;
+          for (int j = 0; j < kv_seq; j++) {
+            score[j] = std::exp(score[j] - max);
+            sum += score[j];
+          }
+          for (int j = 0; j < kv_seq; j++) {
+            for (int d = 0; d < head_size; d++) {
+              out_head[i * head_size + d] += score[j] / sum * v_head_data[j * head_size + d];
+            }
+          }
+        }
+      }
+    }
+    return out;
+  }
+
+  void RunCase(const std::vector<int> &q_shape, const std::vector<int> &k_shape, float scale, bool is_causal,
+               bool with_mask, int thread_num) {
+    auto q = RandomData(q_shape[0] * q_shape[1] * q_shape[2] * q_shape[3]);
+    auto k = RandomData(k_shape[0] * k_shape[1] * k_shape[2] * k_shape[3]);
+    auto v = RandomData(k.size());
+    std::vector<float> mask;
+    if (with_mask) {
+      mask = RandomData(q_shape[2] * k_shape[2]);
+    }
+    std::vector<float> out(q.size(), 0.0f);
+    lite::Tensor q_tensor(kNumberTypeFloat32, q_shape);
+    lite::Tensor k_tensor(kNumberTypeFloat32, k_shape);
+    lite::Tensor v_tensor(kNumberTypeFloat32, k_shape);
+    lite::Tensor mask_tensor(kNumberTypeFloat32, {1, 1, q_shape[2], k_shape[2]});
+    lite::Tensor out_tensor(kNumberTypeFloat32, q_shape);
+    q_tensor.set_data(q.data());
+    k_tensor.set_data(k.data());
+    v_tensor.set_data(v.data());
+    mask_tensor.set_data(mask.data());
+    out_tensor.set_data(out.data());
+    std::vector<lite::Tensor *> inputs = {&q_tensor, &k_tensor, &v_tensor};
+    if (with_mask) {
+      inputs.push_back(&mask_tensor);
+    }
+    std::vector<lite::Tensor *> outputs = {&out_tensor};
+
+    auto param = reinterpret_cast<FlashAttentionParameter *>(malloc(sizeof(FlashAttentionParameter)));
+    ASSERT_NE(param, nullptr);
+    memset(param, 0, sizeof(FlashAttentionParameter));
+    param->op_parameter_.type_ = PrimType_Inner_FlashAttention;
+    param->op_parameter_.thread_num_ = thread_num;
+    param->scale_ = scale;
+    param->is_causal_ = is_causal;
+    kernel::KernelKey desc = {kernel::KERNEL_ARCH::kCPU, kNumberTypeFloat32, NHWC, PrimType_Inner_FlashAttention};
+    auto creator = lite::KernelRegistry::GetInstance()->GetCreator(desc);
+    ASSERT_NE(creator, nullptr);
+    auto ctx = std::make_shared<lite::InnerContext>();
+    ctx->thread_num_ = thread_num;
+    ASSERT_EQ(lite::RET_OK, ctx->Init());
+    auto kernel = creator(inputs, outputs, reinterpret_cast<OpParameter *>(param), ctx.get(), desc);
+    ASSERT_NE(kernel, nullptr);
+    EXPECT_EQ(lite::RET_OK, kernel->Prepare());
+    EXPECT_EQ(lite::RET_OK, kernel->Run());
+
+    float real_scale = scale != 0.0f ? scale : 1.0f / std::sqrt(static_cast<float>(q_shape[3]));
+    auto expect = Reference(q, k, v, mask, q_shape, k_shape, real_scale, is_causal);
+    ASSERT_EQ(0, CompareOutputData(out.data(), expect.data(), out.size()));
+
+    for (auto tensor : inputs) {
+      tensor->set_data(nullptr);
+    }
+    mask_tensor.set_data(nullptr);
+    out_tensor.set_data(nullptr);
+    delete kernel;
+  }
+
+ private:
+  uint32_t seed_ = 7;
+};
+
+TEST_F(TestFlashAttentionFp32, Basic) { RunCase({2, 2, 37, 20}, {2, 2, 37, 20}, 0.0f, false, false, 2); }
+
+TEST_F(TestFlashAttentionFp32, LongKeyTiles) { RunCase({1, 1, 3, 8}, {1, 1, 600, 8}, 0.5f, false, false, 1); }
+
+TEST_F(TestFlashAttentionFp32, CausalGroupedQuery) { RunCase({1, 4, 5, 16}, {1, 2, 40, 16}, 0.25f, true, false, 3); }
+
+TEST_F(TestFlashAttentionFp32, AdditiveMask) { RunCase({1, 2, 19, 24}, {1, 2, 19, 24}, 0.0f, true, true, 2); }
+}  // namespace mindspore
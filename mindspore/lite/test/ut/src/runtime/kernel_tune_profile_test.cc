@@ -0,0 +1,249 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "schema/inner/model_generated.h"
+#include "src/common/common.h"
+#include "src/litert/kernel_tune_profile.h"
+#include "src/litert/lite_session.h"
+#include "src/litert/kernel/cpu/fp32/convolution_delegate_fp32.h"
+#include "src/litert/kernel/cpu/fp32/convolution_im2col_base_fp32.h"
+#include "src/litert/kernel/cpu/fp32/convolution_winograd_base_fp32.h"
+
+namespace mindspore {
+class KernelTuneProfileTest : public mindspore::CommonTest {
+ public:
+  KernelTuneProfileTest() = default;
+  void TearDown() override { (void)remove(file_path_.c_str()); }
+
+ protected:
+  std::string file_path_ = "./kernel_tune_profile_test.txt";
+};
+
+TEST_F(KernelTuneProfileTest, GenerateKey) {
+  auto key = lite::KernelTuneProfile::GenerateKey("conv1", {1, 32, 32, 16}, 4);
+  ASSERT_EQ(key, "conv1|1,32,32,16,|t4");
+  ASSERT_NE(key, lite::KernelTuneProfile::GenerateKey("conv1", {1, 64, 64, 16}, 4));
+  ASSERT_NE(key, lite::KernelTuneProfile::GenerateKey("conv1", {1, 32, 32, 16}, 2));
+}
+
+TEST_F(KernelTuneProfileTest, SaveAndLoad) {
+  lite::KernelTuneProfile profile(file_path_, true);
+  ASSERT_EQ(profile.Load(), lite::RET_OK);
+  lite::KernelTuneChoice choice;
+  ASSERT_FALSE(profile.Find("conv1|1,32,32,16,|t4", &choice));
+  profile.Insert("conv1|1,32,32,16,|t4", {"winograd", 2});
+  profile.Insert("conv2|1,32,32,16,|t4", {"im2col", 4});
+  ASSERT_EQ(profile.Save(), lite::RET_OK);
+
+  lite::KernelTuneProfile loaded(file_path_, false);
+  ASSERT_EQ(loaded.Load(), lite::RET_OK);
+  ASSERT_TRUE(loaded.Find("conv1|1,32,32,16,|t4", &choice));
+  ASSERT_EQ(choice.variant, "winograd");
+  ASSERT_EQ(choice.thread_num, 2);
+  ASSERT_TRUE(loaded.Find("conv2|1,32,32,16,|t4", &choice));
+  ASSERT_EQ(choice.variant, "im2col");
+  ASSERT_EQ(loaded.Digest(), profile.Digest());
+  loaded.Insert("conv2|1,32,32,16,|t4", {"1x1", 1});
+  ASSERT_NE(loaded.Digest(), profile.Digest());
+}
+
+TEST_F(KernelTuneProfileTest, InvalidLine) {
+  std::ofstream ofs(file_path_);
+  ofs << "conv1|1,32,32,16,|t4\twinograd\n";
+  ofs.close();
+  lite::KernelTuneProfile profile(file_path_, false);
+  ASSERT_NE(profile.Load(), lite::RET_OK);
+}
+
+namespace {
+constexpr int kConvThreadNum = 2;
+constexpr int kConvChannel = 8;
+constexpr int kConvSize = 16;
+constexpr int kConvKernelSize = 3;
+
+class ConvolutionDelegateForTest : public kernel::ConvolutionDelegateCPUKernel {
+ public:
+  using kernel::ConvolutionDelegateCPUKernel::ConvolutionDelegateCPUKernel;
+  const kernel::LiteKernel *conv_kernel() const { return conv_kernel_; }
+};
+
+struct SelectedConvKernel {
+  bool winograd = false;
+  bool im2col = false;
+  int thread_num = 0;
+};
+
+// 3x3 same convolution of [1, 16, 16, 8] to 8 channels, the heuristics pick winograd for it.
+SelectedConvKernel SelectConvKernel(const std::string &node_name,
+                                    const std::shared_ptr<lite::KernelTuneProfile> &profile) {
+  SelectedConvKernel selected;
+  lite::InnerContext ctx;
+  ctx.thread_num_ = kConvThreadNum;
+  EXPECT_EQ(ctx.Init(), lite::RET_OK);
+  ctx.kernel_tune_profile_ = profile;
+  lite::Tensor input(kNumberTypeFloat32, {1, kConvSize, kConvSize, kConvChannel});
+  lite::Tensor weight(kNumberTypeFloat32, {kConvChannel, kConvKernelSize, kConvKernelSize, kConvChannel},
+                      mindspore::KHWC, lite::Category::CONST_TENSOR);
+  lite::Tensor output(kNumberTypeFloat32, {1, kConvSize, kConvSize, kConvChannel});
+  EXPECT_EQ(weight.MallocData(), lite::RET_OK);
+  (void)memset(weight.data(), 0, weight.Size());
+
+  auto conv_param = reinterpret_cast<ConvParameter *>(malloc(sizeof(ConvParameter)));
+  EXPECT_NE(conv_param, nullptr);
+  (void)memset(conv_param, 0, sizeof(ConvParameter));
+  conv_param->op_parameter_.type_ = PrimType_Conv2DFusion;
+  conv_param->op_parameter_.thread_num_ = kConvThreadNum;
+  conv_param->kernel_h_ = kConvKernelSize;
+  conv_param->kernel_w_ = kConvKernelSize;
+  conv_param->stride_h_ = 1;
+  conv_param->stride_w_ = 1;
+  conv_param->dilation_h_ = 1;
+  conv_param->dilation_w_ = 1;
+  conv_param->pad_u_ = 1;
+  conv_param->pad_d_ = 1;
+  conv_param->pad_l_ = 1;
+  conv_param->pad_r_ = 1;
+  conv_param->group_ = 1;
+  conv_param->input_channel_ = kConvChannel;
+  conv_param->output_channel_ = kConvChannel;
+  auto kernel = new ConvolutionDelegateForTest(reinterpret_cast<OpParameter *>(conv_param), {&input, &weight},
+                                               {&output}, &ctx);
+  kernel->set_name(node_name);
+  EXPECT_EQ(kernel->Prepare(), lite::RET_OK);
+  auto conv_kernel = kernel->conv_kernel();
+  EXPECT_NE(conv_kernel, nullptr);
+  if (conv_kernel != nullptr) {
+    selected.winograd = dynamic_cast<const kernel::ConvolutionWinogradBaseCPUKernel *>(conv_kernel) != nullptr;
+    selected.im2col = dynamic_cast<const kernel::ConvolutionIm2ColBaseCPUKernel *>(conv_kernel) != nullptr;
+    selected.thread_num = conv_kernel->op_parameter()->thread_num_;
+  }
+  delete kernel;
+  return selected;
+}
+
+// input [1, 16, 16, 8] -> 3x3 Conv2DFusion with 8 output channels -> output
+lite::Model *BuildConvModel(flatbuffers::FlatBufferBuilder *builder) {
+  auto meta_graph = std::make_shared<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+  meta_graph->version = Version();
+  auto conv = std::make_unique<schema::CNodeT>();
+  conv->inputIndex = {0, 1};
+  conv->outputIndex = {2};
+  conv->primitive = std::make_unique<schema::PrimitiveT>();
+  conv->primitive->value.type = schema::PrimitiveType_Conv2DFusion;
+  auto primitive = new schema::Conv2DFusionT;
+  primitive->format = schema::Format_NHWC;
+  primitive->kernel_size = {kConvKernelSize, kConvKernelSize};
+  primitive->stride = {1, 1};
+  primitive->dilation = {1, 1};
+  primitive->pad_mode = schema::PadMode_SAME;
+  primitive->pad_list = {1, 1, 1, 1};
+  primitive->group = 1;
+  primitive->in_channel = kConvChannel;
+  primitive->out_channel = kConvChannel;
+  conv->primitive->value.value = primitive;
+  conv->name = "conv";
+  meta_graph->nodes.emplace_back(std::move(conv));
+  std::vector<std::vector<int>> dims = {{1, kConvSize, kConvSize, kConvChannel},
+                                        {kConvChannel, kConvKernelSize, kConvKernelSize, kConvChannel},
+                                        {1, kConvSize, kConvSize, kConvChannel}};
+  std::vector<std::string> names = {"input", "weight", "output"};
+  for (size_t i = 0; i < names.size(); i++) {
+    auto tensor = std::make_unique<schema::TensorT>();
+    tensor->nodeType = i == 1 ? lite::NodeType_ValueNode : lite::NodeType_Parameter;
+    tensor->format = i == 1 ? schema::Format_KHWC : schema::Format_NHWC;
+    tensor->dataType = kNumberTypeFloat32;
+    tensor->dims = dims[i];
+    tensor->offset = -1;
+    tensor->name = names[i];
+    if (i == 1) {
+      tensor->data.resize(kConvChannel * kConvKernelSize * kConvKernelSize * kConvChannel * sizeof(float), 0);
+    }
+    meta_graph->allTensors.emplace_back(std::move(tensor));
+  }
+  meta_graph->inputIndex = {0};
+  meta_graph->outputIndex = {2};
+  auto offset = schema::MetaGraph::Pack(*builder, meta_graph.get());
+  builder->Finish(offset);
+  schema::FinishMetaGraphBuffer(*builder, offset);
+  return lite::Model::Import(reinterpret_cast<char *>(builder->GetBufferPointer()), builder->GetSize());
+}
+}  // namespace
+
+TEST_F(KernelTuneProfileTest, ConvolutionDelegateUsesProfiledChoice) {
+  auto profile = std::make_shared<lite::KernelTuneProfile>(file_path_, false);
+  std::vector<int> input_shape = {1, kConvSize, kConvSize, kConvChannel};
+  profile->Insert(lite::KernelTuneProfile::GenerateKey("conv1", input_shape, kConvThreadNum), {"im2col", 1});
+
+  auto heuristic = SelectConvKernel("conv1", nullptr);
+  ASSERT_TRUE(heuristic.winograd);
+  ASSERT_EQ(heuristic.thread_num, kConvThreadNum);
+
+  auto profiled = SelectConvKernel("conv1", profile);
+  ASSERT_TRUE(profiled.im2col);
+  ASSERT_FALSE(profiled.winograd);
+  ASSERT_EQ(profiled.thread_num, 1);
+
+  // a node, a shape or a thread num which is not profiled is selected by the heuristics
+  auto unknown = SelectConvKernel("conv2", profile);
+  ASSERT_TRUE(unknown.winograd);
+  ASSERT_EQ(unknown.thread_num, kConvThreadNum);
+}
+
+TEST_F(KernelTuneProfileTest, ConvolutionDelegateIgnoresUnfitChoice) {
+  auto profile = std::make_shared<lite::KernelTuneProfile>(file_path_, false);
+  std::vector<int> input_shape = {1, kConvSize, kConvSize, kConvChannel};
+  // 1x1 does not fit a 3x3 convolution, more threads than the context has are not used
+  profile->Insert(lite::KernelTuneProfile::GenerateKey("conv1", input_shape, kConvThreadNum), {"1x1", 1});
+  profile->Insert(lite::KernelTuneProfile::GenerateKey("conv2", input_shape, kConvThreadNum), {"im2col", 4});
+  auto unfit_variant = SelectConvKernel("conv1", profile);
+  ASSERT_TRUE(unfit_variant.winograd);
+  auto unfit_thread_num = SelectConvKernel("conv2", profile);
+  ASSERT_TRUE(unfit_thread_num.winograd);
+  ASSERT_EQ(unfit_thread_num.thread_num, kConvThreadNum);
+}
+
+TEST_F(KernelTuneProfileTest, InvalidProfileFallsBackToHeuristics) {
+  std::ofstream ofs(file_path_);
+  ofs << "conv|1,16,16,8,|t2\twinograd\n";
+  ofs.close();
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto model = BuildConvModel(&builder);
+  ASSERT_NE(model, nullptr);
+  std::map<std::string, std::map<std::string, std::string>> config_info = {
+    {lite::kCommonContextSection, {{lite::kKernelTuneProfileKey, file_path_}}}};
+  auto context = std::make_shared<lite::InnerContext>();
+  ASSERT_EQ(context->Init(), lite::RET_OK);
+  auto session = std::make_shared<lite::LiteSession>();
+  ASSERT_EQ(session->Init(context), lite::RET_OK);
+  session->SetConfigInfo(&config_info);
+  // a malformed profile must not fail the model, the kernels are selected as if there was none
+  ASSERT_EQ(session->CompileGraph(model), lite::RET_OK);
+  auto input = session->GetInputs().front();
+  ASSERT_NE(input->MutableData(), nullptr);
+  (void)memset(input->MutableData(), 0, input->Size());
+  ASSERT_EQ(session->RunGraph(), lite::RET_OK);
+  session = nullptr;
+  delete model;
+}
+}  // namespace mindspore
@@ -0,0 +1,255 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <dirent.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "schema/inner/model_generated.h"
+#include "src/common/common.h"
+#include "src/litert/lite_session.h"
+#include "src/litert/pack_weight_cache.h"
+
+namespace mindspore {
+class PackWeightCacheTest : public mindspore::CommonTest {
+ public:
+  PackWeightCacheTest() = default;
+  void TearDown() override { (void)remove(file_path_.c_str()); }
+
+ protected:
+  std::string file_path_ = "./pack_weight_cache_test.bin";
+  std::string layout_ = "thread_2_avx512_8_MindSpore Lite 2.2.0";
+};
+
+TEST_F(PackWeightCacheTest, GenerateFileName) {
+  std::vector<char> model(100, 1);
+  auto name = lite::PackWeightCache::GenerateFileName(model.data(), model.size(), "thread_2_avx512");
+  ASSERT_EQ(name, lite::PackWeightCache::GenerateFileName(model.data(), model.size(), "thread_2_avx512"));
+  ASSERT_NE(name, lite::PackWeightCache::GenerateFileName(model.data(), model.size(), "thread_2_avx"));
+  model[50] = 2;
+  ASSERT_NE(name, lite::PackWeightCache::GenerateFileName(model.data(), model.size(), "thread_2_avx512"));
+}
+
+TEST_F(PackWeightCacheTest, SaveAndLoad) {
+  std::vector<float> weight0(33, 1.0f);
+  std::vector<float> weight1(128, 2.0f);
+  lite::PackWeightCache cache(file_path_, layout_);
+  ASSERT_FALSE(cache.Load());
+  auto key0 = cache.NextKey(3, weight0.size() * sizeof(float));
+  auto key1 = cache.NextKey(3, weight0.size() * sizeof(float));
+  ASSERT_EQ(key1.occurrence, 1);
+  auto key2 = cache.NextKey(5, weight1.size() * sizeof(float));
+  ASSERT_EQ(cache.Find(key0), nullptr);
+  cache.AddPacked(key0, weight0.data());
+  cache.AddPacked(key1, weight1.data());
+  cache.AddPacked(key2, weight1.data());
+  cache.RemovePacked(weight1.data());
+  ASSERT_EQ(cache.packed_num(), 2);
+  ASSERT_TRUE(cache.Save());
+
+  lite::PackWeightCache loaded(file_path_, layout_);
+  ASSERT_TRUE(loaded.Load());
+  auto data0 = loaded.Find(loaded.NextKey(3, weight0.size() * sizeof(float)));
+  ASSERT_NE(data0, nullptr);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(data0) % 64, 0);
+  ASSERT_EQ(memcmp(data0, weight0.data(), weight0.size() * sizeof(float)), 0);
+  // the second pack of tensor 3 was removed before save
+  ASSERT_EQ(loaded.Find(loaded.NextKey(3, weight0.size() * sizeof(float))), nullptr);
+  auto data2 = loaded.Find(loaded.NextKey(5, weight1.size() * sizeof(float)));
+  ASSERT_NE(data2, nullptr);
+  ASSERT_EQ(memcmp(data2, weight1.data(), weight1.size() * sizeof(float)), 0);
+}
+
+TEST_F(PackWeightCacheTest, InvalidFile) {
+  auto file = fopen(file_path_.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  std::vector<char> content(256, 7);
+  ASSERT_EQ(fwrite(content.data(), 1, content.size(), file), content.size());
+  (void)fclose(file);
+  lite::PackWeightCache cache(file_path_, layout_);
+  ASSERT_FALSE(cache.Load());
+  ASSERT_EQ(cache.Find({0, 4, 0}), nullptr);
+}
+
+TEST_F(PackWeightCacheTest, RejectOtherLayout) {
+  std::vector<float> weight(16, 1.0f);
+  lite::PackWeightCache cache(file_path_, layout_);
+  cache.AddPacked(cache.NextKey(0, weight.size() * sizeof(float)), weight.data());
+  ASSERT_TRUE(cache.Save());
+  // the packing of another library version may differ
+  lite::PackWeightCache other_version(file_path_, "thread_2_avx512_8_MindSpore Lite 2.3.0");
+  ASSERT_FALSE(other_version.Load());
+  ASSERT_EQ(other_version.Find({0, weight.size() * sizeof(float), 0}), nullptr);
+  lite::PackWeightCache same_layout(file_path_, layout_);
+  ASSERT_TRUE(same_layout.Load());
+}
+
+namespace {
+constexpr int kRow = 2;
+constexpr int kDeep = 4;
+constexpr int kCol = 3;
+
+// input [2, 4] x const weight [3, 4]^T -> output [2, 3]
+lite::Model *BuildMatMulModel(flatbuffers::FlatBufferBuilder *builder, const std::vector<float> &weight) {
+  auto meta_graph = std::make_shared<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+  meta_graph->version = Version();
+  auto matmul = std::make_unique<schema::CNodeT>();
+  matmul->inputIndex = {0, 1};
+  matmul->outputIndex = {2};
+  matmul->primitive = std::make_unique<schema::PrimitiveT>();
+  matmul->primitive->value.type = schema::PrimitiveType_MatMulFusion;
+  auto primitive = new schema::MatMulFusionT;
+  primitive->transpose_b = true;
+  matmul->primitive->value.value = primitive;
+  matmul->name = "matmul";
+  meta_graph->nodes.emplace_back(std::move(matmul));
+  std::vector<std::vector<int>> dims = {{kRow, kDeep}, {kCol, kDeep}, {kRow, kCol}};
+  std::vector<std::string> names = {"input", "weight", "output"};
+  for (size_t i = 0; i < names.size(); i++) {
+    auto tensor = std::make_unique<schema::TensorT>();
+    tensor->nodeType = i == 1 ? lite::NodeType_ValueNode : lite::NodeType_Parameter;
+    tensor->format = schema::Format_NHWC;
+    tensor->dataType = kNumberTypeFloat32;
+    tensor->dims = dims[i];
+    tensor->offset = -1;
+    tensor->name = names[i];
+    if (i == 1) {
+      tensor->data.resize(weight.size() * sizeof(float));
+      memcpy(tensor->data.data(), weight.data(), tensor->data.size());
+    }
+    meta_graph->allTensors.emplace_back(std::move(tensor));
+  }
+  meta_graph->inputIndex = {0};
+  meta_graph->outputIndex = {2};
+  auto offset = schema::MetaGraph::Pack(*builder, meta_graph.get());
+  builder->Finish(offset);
+  schema::FinishMetaGraphBuffer(*builder, offset);
+  return lite::Model::Import(reinterpret_cast<char *>(builder->GetBufferPointer()), builder->GetSize());
+}
+
+std::vector<float> RunMatMul(lite::Model *model, std::map<std::string, std::map<std::string, std::string>> *config) {
+  auto context = std::make_shared<lite::InnerContext>();
+  EXPECT_EQ(context->Init(), lite::RET_OK);
+  auto session = std::make_shared<lite::LiteSession>();
+  EXPECT_EQ(session->Init(context), lite::RET_OK);
+  session->SetConfigInfo(config);
+  EXPECT_EQ(session->CompileGraph(model), lite::RET_OK);
+  auto input = static_cast<float *>(session->GetInputs().front()->MutableData());
+  EXPECT_NE(input, nullptr);
+  for (int i = 0; i < kRow * kDeep; i++) {
+    input[i] = static_cast<float>(i);
+  }
+  EXPECT_EQ(session->RunGraph(), lite::RET_OK);
+  auto output = session->GetOutputByTensorName("output");
+  EXPECT_NE(output, nullptr);
+  auto output_data = static_cast<float *>(output->data());
+  return std::vector<float>(output_data, output_data + kRow * kCol);
+}
+
+std::vector<std::string> ListCacheFiles(const std::string &dir) {
+  std::vector<std::string> files;
+  auto dir_ptr = opendir(dir.c_str());
+  if (dir_ptr == nullptr) {
+    return files;
+  }
+  for (auto entry = readdir(dir_ptr); entry != nullptr; entry = readdir(dir_ptr)) {
+    if (strncmp(entry->d_name, "pack_weight_", strlen("pack_weight_")) == 0) {
+      files.emplace_back(dir + "/" + entry->d_name);
+    }
+  }
+  (void)closedir(dir_ptr);
+  return files;
+}
+
+std::string ReadFile(const std::string &path) {
+  std::ifstream ifs(path, std::ios::binary);
+  std::stringstream content;
+  content << ifs.rdbuf();
+  return content.str();
+}
+
+void WriteFile(const std::string &path, const std::string &content) {
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  ofs << content;
+}
+}  // namespace
+
+TEST_F(PackWeightCacheTest, SessionUsesCacheOfSameVersionOnly) {
+  std::vector<float> weight(kCol * kDeep);
+  for (size_t i = 0; i < weight.size(); i++) {
+    weight[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto model = BuildMatMulModel(&builder, weight);
+  ASSERT_NE(model, nullptr);
+  const std::string cache_dir = "./pack_weight_cache_session_test";
+  std::map<std::string, std::map<std::string, std::string>> config_info = {
+    {lite::kCommonContextSection, {{lite::kPackWeightCacheDirKey, cache_dir}}}};
+  std::vector<float> expect(kRow * kCol, 0);
+  for (int r = 0; r < kRow; r++) {
+    for (int c = 0; c < kCol; c++) {
+      for (int d = 0; d < kDeep; d++) {
+        expect[r * kCol + c] += static_cast<float>(r * kDeep + d) * weight[c * kDeep + d];
+      }
+    }
+  }
+
+  // the first session packs the weight and saves it
+  ASSERT_EQ(RunMatMul(model, &config_info), expect);
+  auto files = ListCacheFiles(cache_dir);
+  ASSERT_EQ(files.size(), 1);
+  auto saved = ReadFile(files[0]);
+
+  // the packed data is taken from the file: zero it and the next session computes zeros
+  constexpr size_t kEntryNumOffset = 16;
+  constexpr size_t kLayoutSizeOffset = 24;
+  constexpr size_t kLayoutOffset = 32;
+  constexpr size_t kEntrySize = 32;
+  uint64_t entry_num = 0;
+  uint64_t layout_size = 0;
+  memcpy(&entry_num, saved.data() + kEntryNumOffset, sizeof(entry_num));
+  memcpy(&layout_size, saved.data() + kLayoutSizeOffset, sizeof(layout_size));
+  ASSERT_EQ(saved.compare(kLayoutOffset + layout_size - Version().size(), Version().size(), Version()), 0);
+  ASSERT_GT(entry_num, 0);
+  auto entries_offset = (kLayoutOffset + layout_size + 7) / 8 * 8;
+  auto zeroed = saved;
+  for (uint64_t i = 0; i < entry_num; i++) {
+    uint64_t size = 0;
+    uint64_t offset = 0;
+    memcpy(&size, saved.data() + entries_offset + i * kEntrySize + sizeof(uint64_t), sizeof(size));
+    memcpy(&offset, saved.data() + entries_offset + i * kEntrySize + 3 * sizeof(uint64_t), sizeof(offset));
+    ASSERT_LE(offset + size, zeroed.size());
+    memset(&zeroed[offset], 0, size);
+  }
+  WriteFile(files[0], zeroed);
+  ASSERT_EQ(RunMatMul(model, &config_info), std::vector<float>(kRow * kCol, 0));
+
+  // a file of another library version is rejected and replaced by the packing of this one
+  zeroed[kLayoutOffset + layout_size - 1] ^= 1;
+  WriteFile(files[0], zeroed);
+  ASSERT_EQ(RunMatMul(model, &config_info), expect);
+  ASSERT_EQ(ReadFile(files[0]), saved);
+
+  (void)remove(files[0].c_str());
+  (void)remove(cache_dir.c_str());
+  delete model;
+}
+}  // namespace mindspore
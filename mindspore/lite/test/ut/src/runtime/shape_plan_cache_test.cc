@@ -0,0 +1,225 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <map>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "schema/inner/model_generated.h"
+#include "src/common/common.h"
+#include "src/executor/sub_graph_kernel.h"
+#include "src/litert/lite_session.h"
+#include "src/litert/runtime_allocator.h"
+#include "src/litert/shape_plan_cache.h"
+
+namespace mindspore {
+class ShapePlanCacheTest : public mindspore::CommonTest {
+ public:
+  ShapePlanCacheTest() = default;
+};
+
+TEST_F(ShapePlanCacheTest, GenerateKey) {
+  lite::Tensor input0(kNumberTypeFloat32, {1, 32});
+  lite::Tensor input1(kNumberTypeInt32, {1, 32, 8});
+  auto key = lite::ShapePlanCache::GenerateKey({&input0, &input1});
+  input0.set_shape({1, 64});
+  ASSERT_NE(key, lite::ShapePlanCache::GenerateKey({&input0, &input1}));
+  input0.set_shape({1, 32});
+  ASSERT_EQ(key, lite::ShapePlanCache::GenerateKey({&input0, &input1}));
+}
+
+TEST_F(ShapePlanCacheTest, EvictLeastRecentlyUsed) {
+  lite::Tensor tensor(kNumberTypeFloat32, {1, 32});
+  lite::ShapePlanCache cache(2);
+  lite::ShapePlan plan_32;
+  plan_32.tensor_shapes.emplace_back(&tensor, std::vector<int>{1, 32});
+  plan_32.total_size = 32;
+  cache.Insert("32", std::move(plan_32));
+  lite::ShapePlan plan_64;
+  plan_64.total_size = 64;
+  cache.Insert("64", std::move(plan_64));
+
+  auto plan = cache.Find("32");
+  ASSERT_NE(plan, nullptr);
+  ASSERT_EQ(plan->total_size, 32);
+  ASSERT_EQ(plan->tensor_shapes.size(), 1);
+
+  // "64" is the least recently used one now
+  lite::ShapePlan plan_128;
+  plan_128.total_size = 128;
+  cache.Insert("128", std::move(plan_128));
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_EQ(cache.Find("64"), nullptr);
+  ASSERT_NE(cache.Find("32"), nullptr);
+  ASSERT_NE(cache.Find("128"), nullptr);
+  ASSERT_EQ(cache.hit_count(), 3);
+  ASSERT_EQ(cache.miss_count(), 1);
+}
+
+namespace {
+// input [1, n] -> Split(axis 1, 2 outputs) -> out0, out1
+lite::Model *BuildSplitModel(flatbuffers::FlatBufferBuilder *builder) {
+  auto meta_graph = std::make_shared<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+  meta_graph->version = Version();
+  auto split = std::make_unique<schema::CNodeT>();
+  split->inputIndex = {0};
+  split->outputIndex = {1, 2};
+  split->primitive = std::make_unique<schema::PrimitiveT>();
+  split->primitive->value.type = schema::PrimitiveType_Split;
+  auto primitive = new schema::SplitT;
+  primitive->output_num = 2;
+  primitive->axis = 1;
+  split->primitive->value.value = primitive;
+  split->name = "split";
+  meta_graph->nodes.emplace_back(std::move(split));
+  for (auto name : {"input", "out0", "out1"}) {
+    auto tensor = std::make_unique<schema::TensorT>();
+    tensor->nodeType = lite::NodeType_Parameter;
+    tensor->format = schema::Format_NHWC;
+    tensor->dataType = kNumberTypeFloat32;
+    tensor->dims = {1, 4};
+    tensor->offset = -1;
+    tensor->name = name;
+    meta_graph->allTensors.emplace_back(std::move(tensor));
+  }
+  meta_graph->inputIndex = {0};
+  meta_graph->outputIndex = {1, 2};
+  auto offset = schema::MetaGraph::Pack(*builder, meta_graph.get());
+  builder->Finish(offset);
+  schema::FinishMetaGraphBuffer(*builder, offset);
+  return lite::Model::Import(reinterpret_cast<char *>(builder->GetBufferPointer()), builder->GetSize());
+}
+
+// the runtime allocator is only valid on arm64 by default, the plans save its offsets.
+class PlanCacheSession : public lite::LiteSession {
+ public:
+  explicit PlanCacheSession(bool runtime_allocator) : runtime_allocator_valid_(runtime_allocator) {}
+  int RuntimeAllocatorValid() override { return runtime_allocator_valid_ ? lite::RET_OK : lite::RET_ERROR; }
+  const lite::ShapePlanCache *shape_plan_cache() const { return shape_plan_cache_.get(); }
+
+ private:
+  bool runtime_allocator_valid_ = true;
+};
+
+std::shared_ptr<PlanCacheSession> CompileSplitModel(
+  lite::Model *model, std::map<std::string, std::map<std::string, std::string>> *config_info,
+  bool runtime_allocator = true) {
+  auto context = std::make_shared<lite::InnerContext>();
+  EXPECT_EQ(context->Init(), lite::RET_OK);
+  auto session = std::make_shared<PlanCacheSession>(runtime_allocator);
+  EXPECT_EQ(session->Init(context), lite::RET_OK);
+  session->SetConfigInfo(config_info);
+  EXPECT_EQ(session->CompileGraph(model), lite::RET_OK);
+  return session;
+}
+
+// tensor name -> offset in the runtime allocator buffer
+std::map<std::string, size_t> RuntimeOffsets(const lite::LiteSession *session) {
+  std::map<std::string, size_t> offsets;
+  for (auto kernel : session->get_kernels()) {
+    for (auto node : reinterpret_cast<kernel::SubGraphKernel *>(kernel)->nodes()) {
+      for (auto tensor : node->out_tensors()) {
+        auto allocator = std::dynamic_pointer_cast<RuntimeAllocator>(tensor->allocator());
+        if (allocator != nullptr) {
+          offsets[tensor->tensor_name()] = allocator->GetOffsetMap().at(tensor);
+        }
+      }
+    }
+  }
+  return offsets;
+}
+
+void ResizeAndCheckSplit(lite::LiteSession *session, int size) {
+  auto input = session->GetInputs().front();
+  ASSERT_EQ(session->Resize({input}, {{1, size}}), lite::RET_OK);
+  auto data = static_cast<float *>(input->MutableData());
+  ASSERT_NE(data, nullptr);
+  for (int i = 0; i < size; i++) {
+    data[i] = static_cast<float>(i);
+  }
+  ASSERT_EQ(session->RunGraph(), lite::RET_OK);
+  auto out0 = session->GetOutputByTensorName("out0");
+  auto out1 = session->GetOutputByTensorName("out1");
+  ASSERT_NE(out0, nullptr);
+  ASSERT_NE(out1, nullptr);
+  ASSERT_EQ(out0->shape(), std::vector<int>({1, size / 2}));
+  ASSERT_EQ(out1->shape(), std::vector<int>({1, size / 2}));
+  auto out0_data = static_cast<float *>(out0->data());
+  auto out1_data = static_cast<float *>(out1->data());
+  for (int i = 0; i < size / 2; i++) {
+    ASSERT_EQ(out0_data[i], static_cast<float>(i));
+    ASSERT_EQ(out1_data[i], static_cast<float>(size / 2 + i));
+  }
+}
+}  // namespace
+
+TEST_F(ShapePlanCacheTest, SwitchCachedShapesWithSplit) {
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto model = BuildSplitModel(&builder);
+  ASSERT_NE(model, nullptr);
+  std::map<std::string, std::map<std::string, std::string>> config_info = {
+    {lite::kCommonContextSection, {{lite::kShapePlanCacheSizeKey, "4"}}}};
+  auto session = CompileSplitModel(model, &config_info);
+  auto cache = session->shape_plan_cache();
+  ASSERT_NE(cache, nullptr);
+
+  // the offsets a session without cache plans for each shape
+  std::map<std::string, std::map<std::string, std::string>> no_cache_config;
+  auto fresh_session = CompileSplitModel(model, &no_cache_config);
+  ASSERT_EQ(fresh_session->shape_plan_cache(), nullptr);
+  ResizeAndCheckSplit(fresh_session.get(), 8);
+  auto fresh_offsets_8 = RuntimeOffsets(fresh_session.get());
+  ResizeAndCheckSplit(fresh_session.get(), 4);
+  auto fresh_offsets_4 = RuntimeOffsets(fresh_session.get());
+  ASSERT_FALSE(fresh_offsets_4.empty());
+
+  // the plan of the compiled shape [1, 4] is saved by CompileGraph
+  ResizeAndCheckSplit(session.get(), 8);
+  ASSERT_EQ(cache->hit_count(), 0);
+  ASSERT_EQ(cache->miss_count(), 1);
+  ASSERT_EQ(RuntimeOffsets(session.get()), fresh_offsets_8);
+  // the split sizes are written by the split infer, a plan hit must not keep the ones of the previous shape
+  ResizeAndCheckSplit(session.get(), 4);
+  ASSERT_EQ(cache->hit_count(), 1);
+  ASSERT_EQ(RuntimeOffsets(session.get()), fresh_offsets_4);
+  ResizeAndCheckSplit(session.get(), 8);
+  ASSERT_EQ(cache->hit_count(), 2);
+  ASSERT_EQ(RuntimeOffsets(session.get()), fresh_offsets_8);
+  ResizeAndCheckSplit(session.get(), 4);
+  ASSERT_EQ(cache->hit_count(), 3);
+  ASSERT_EQ(cache->miss_count(), 1);
+  ASSERT_EQ(cache->size(), 2);
+  ASSERT_EQ(RuntimeOffsets(session.get()), fresh_offsets_4);
+  session = nullptr;
+  fresh_session = nullptr;
+  delete model;
+}
+
+TEST_F(ShapePlanCacheTest, NoCacheWithoutRuntimeAllocator) {
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto model = BuildSplitModel(&builder);
+  ASSERT_NE(model, nullptr);
+  std::map<std::string, std::map<std::string, std::string>> config_info = {
+    {lite::kCommonContextSection, {{lite::kShapePlanCacheSizeKey, "4"}}}};
+  // a plan has nothing to restore then, the cache would only add the matching and saving
+  auto session = CompileSplitModel(model, &config_info, false);
+  ASSERT_EQ(session->shape_plan_cache(), nullptr);
+  ResizeAndCheckSplit(session.get(), 8);
+  ResizeAndCheckSplit(session.get(), 4);
+  session = nullptr;
+  delete model;
+}
+}  // namespace mindspore
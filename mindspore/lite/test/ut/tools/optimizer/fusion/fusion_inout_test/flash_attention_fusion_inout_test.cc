@@ -0,0 +1,137 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define USE_DEPRECATED_API
+#include <memory>
+#include <string>
+#include <vector>
+#include "tools/optimizer/fusion/flash_attention_fusion_for_cpu.h"
+#include "test/ut/tools/optimizer/fusion/fusion_inout_test/fusion_inout_test.h"
+#include "tools/optimizer/common/gllo_utils.h"
+#include "mindspore/core/ops/framework_ops.h"
+#include "ops/fusion/mat_mul_fusion.h"
+#include "ops/fusion/mul_fusion.h"
+#include "ops/fusion/add_fusion.h"
+#include "ops/softmax.h"
+
+namespace mindspore {
+class FlashAttentionFusionInoutTest : public FusionInoutTest {
+ public:
+  FlashAttentionFusionInoutTest() = default;
+
+  // runs the fusion on softmax(q * k^T * 0.25 + mask) * v and returns the node producing the graph output.
+  AnfNodePtr FuseAttention(const std::vector<int64_t> &qk_shape, const std::vector<int64_t> &v_shape,
+                           const std::vector<int64_t> &mask_shape) {
+    qk_shape_ = qk_shape;
+    v_shape_ = v_shape;
+    mask_shape_ = mask_shape;
+    if (!DoTest()) {
+      return nullptr;
+    }
+    return graph_->get_return()->input(1);
+  }
+
+  static bool IsFlashAttention(const AnfNodePtr &node) {
+    if (!opt::CheckPrimitiveType(node, prim::kPrimCustom)) {
+      return false;
+    }
+    auto prim = GetValueNode<PrimitivePtr>(node->cast<CNodePtr>()->input(0));
+    MS_CHECK_TRUE_RET(prim != nullptr, false);
+    auto type = prim->GetAttr("type");
+    return type != nullptr && GetValue<std::string>(type) == "CpuFlashAttention";
+  }
+
+ protected:
+  void InitPass() override { this->pass_ = std::make_shared<opt::FlashAttentionFusionForCpu>(); }
+
+  void InitGraph() override {
+    this->graph_ = std::make_shared<FuncGraph>();
+    MS_CHECK_TRUE_MSG(graph_ != nullptr, , "Create FuncGraph failed");
+    auto q = AddParameter(graph_, 0, qk_shape_, kNumberTypeFloat32, "q");
+    auto k = AddParameter(graph_, 0, qk_shape_, kNumberTypeFloat32, "k");
+    auto v = AddParameter(graph_, 0, v_shape_, kNumberTypeFloat32, "v");
+    auto mask = AddParameter(graph_, 0, mask_shape_, kNumberTypeFloat32, "mask");
+    auto scale = AddParameter(graph_, sizeof(float), {1}, kNumberTypeFloat32, "scale");
+    if (q == nullptr || k == nullptr || v == nullptr || mask == nullptr || scale == nullptr) {
+      this->graph_ = nullptr;
+      return;
+    }
+    auto scale_tensor = scale->default_param()->cast<tensor::TensorPtr>();
+    static_cast<float *>(scale_tensor->data_c())[0] = 0.25f;
+
+    auto scores = AddMatMul(q, k, true, "matmul_qk");
+    auto mul_prim = std::make_shared<ops::MulFusion>();
+    mul_prim->Init(ActivationType::NO_ACTIVATION);
+    auto scaled = graph_->NewCNode(mul_prim->GetPrim(), {scores, scale});
+    auto add_prim = std::make_shared<ops::AddFusion>();
+    add_prim->Init(ActivationType::NO_ACTIVATION);
+    auto masked = graph_->NewCNode(add_prim->GetPrim(), {scaled, mask});
+    auto softmax_prim = std::make_shared<ops::Softmax>();
+    softmax_prim->Init(-1);
+    auto softmax = graph_->NewCNode(softmax_prim->GetPrim(), {masked});
+    auto output = AddMatMul(softmax, v, false, "matmul_sv");
+    if (AddReturn(graph_, {output}) == nullptr) {
+      this->graph_ = nullptr;
+    }
+  }
+
+ private:
+  CNodePtr AddMatMul(const AnfNodePtr &input1, const AnfNodePtr &input2, bool transpose_b, const std::string &name) {
+    auto prim = std::make_shared<ops::MatMulFusion>();
+    prim->Init(false, transpose_b, ActivationType::NO_ACTIVATION);
+    auto matmul = graph_->NewCNode(prim->GetPrim(), {input1, input2});
+    matmul->set_fullname_with_scope(name);
+    return matmul;
+  }
+
+  std::vector<int64_t> qk_shape_;
+  std::vector<int64_t> v_shape_;
+  std::vector<int64_t> mask_shape_;
+};
+
+TEST_F(FlashAttentionFusionInoutTest, FuseFullMask) {
+  auto output = FuseAttention({1, 2, 8, 16}, {1, 2, 8, 16}, {1, 2, 8, 8});
+  ASSERT_NE(output, nullptr);
+  ASSERT_TRUE(IsFlashAttention(output));
+  // q, k, v and mask
+  ASSERT_EQ(output->cast<CNodePtr>()->size(), 5);
+}
+
+TEST_F(FlashAttentionFusionInoutTest, FuseMaskBroadcastOverHeads) {
+  auto output = FuseAttention({1, 2, 8, 16}, {1, 2, 8, 16}, {1, 1, 8, 8});
+  ASSERT_NE(output, nullptr);
+  ASSERT_TRUE(IsFlashAttention(output));
+}
+
+TEST_F(FlashAttentionFusionInoutTest, RejectMaskBroadcastOverQuery) {
+  // the kernel needs [q_seq_len, kv_seq_len] mask rows, a padding mask of one row is not fused.
+  auto output = FuseAttention({1, 2, 8, 16}, {1, 2, 8, 16}, {1, 1, 1, 8});
+  ASSERT_NE(output, nullptr);
+  ASSERT_FALSE(IsFlashAttention(output));
+}
+
+TEST_F(FlashAttentionFusionInoutTest, RejectValueOfOtherShape) {
+  auto output = FuseAttention({1, 2, 8, 16}, {1, 2, 8, 32}, {1, 2, 8, 8});
+  ASSERT_NE(output, nullptr);
+  ASSERT_FALSE(IsFlashAttention(output));
+}
+
+TEST_F(FlashAttentionFusionInoutTest, RejectDynamicSeqLen) {
+  auto output = FuseAttention({1, 2, -1, 16}, {1, 2, -1, 16}, {1, 2, -1, -1});
+  ASSERT_NE(output, nullptr);
+  ASSERT_FALSE(IsFlashAttention(output));
+}
+}  // namespace mindspore
@@ -265,6 +265,30 @@ void BenchmarkFlags::InitResizeDimsList() {
   }
 }
 
+void BenchmarkFlags::InitShapeBucketsList() {
+  std::string content = this->shape_buckets_in_;
+  if (content.empty()) {
+    return;
+  }
+  auto bucket_strs = StrSplit(content, std::string(DELIM_SEMICOLON));
+  for (const auto &bucket_str : bucket_strs) {
+    std::vector<std::vector<int>> bucket;
+    auto shape_strs = StrSplit(bucket_str, std::string(DELIM_COLON));
+    std::cout << "Shape Bucket: ";
+    for (const auto &shape_str : shape_strs) {
+      std::vector<int> shape;
+      auto dim_strs = StrSplit(shape_str, std::string(DELIM_COMMA));
+      for (const auto &dim_str : dim_strs) {
+        shape.emplace_back(static_cast<int>(std::stoi(dim_str)));
+      }
+      std::cout << shape_str << " ";
+      bucket.emplace_back(shape);
+    }
+    std::cout << std::endl;
+    this->shape_buckets_.emplace_back(bucket);
+  }
+}
+
 void BenchmarkFlags::InitCoreList() {
   std::string core_list_str = this->core_list_str_;
   if (core_list_str.empty()) {
@@ -487,6 +511,7 @@ int BenchmarkBase::Init() {
   flags_->InitInputDataList();
   flags_->InitCoreList();
   flags_->InitResizeDimsList();
+  flags_->InitShapeBucketsList();
   if (!flags_->resize_dims_.empty() && !flags_->input_data_list_.empty() &&
       flags_->resize_dims_.size() != flags_->input_data_list_.size()) {
     MS_LOG(ERROR) << "Size of input resizeDims should be equal to size of input inDataPath";
@@ -69,6 +69,7 @@ constexpr float kFloatMSEC = 1000.0f;
 constexpr int kNumPrintMin = 5;
 constexpr const char *DELIM_COLON = ":";
 constexpr const char *DELIM_COMMA = ",";
+constexpr const char *DELIM_SEMICOLON = ";";
 constexpr const char *DELIM_SLASH = "/";
 constexpr size_t kEncMaxLen = 16;
 
@@ -143,6 +144,12 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
     AddFlag(&BenchmarkFlags::cosine_distance_threshold_, "cosineDistanceThreshold", "cosine distance threshold", -1.1);
     AddFlag(&BenchmarkFlags::resize_dims_in_, "inputShapes",
             "Shape of input data, the format should be NHWC. e.g. 1,32,32,32:1,1,32,32,1", "");
+    AddFlag(&BenchmarkFlags::shape_buckets_in_, "shapeBuckets",
+            "Input shapes alternated in benchmark loops to measure resize, buckets are split by ';'. "
+            "e.g. 1,32:1,32;1,64:1,64",
+            "");
+    AddFlag(&BenchmarkFlags::shape_plan_cache_size_, "shapePlanCacheSize",
+            "Number of input shapes whose infer and memory plan are cached, 0 means disabled", 0);
 #ifdef ENABLE_CLOUD_FUSION_INFERENCE
     // Distributed Infer
     AddFlag(&BenchmarkFlags::device_id_, "deviceId", "Set device id for distributed inference", -1);
@@ -170,6 +177,11 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
             "");
     AddFlag(&BenchmarkFlags::thread_num_remaining_per_worker_, "threadNumRemainingPerWorker",
             "thread num limit per worker ", "");
+    AddFlag(&BenchmarkFlags::enable_dynamic_batching_, "enableDynamicBatching",
+            "Enable merging parallel requests into one batch", false);
+    AddFlag(&BenchmarkFlags::max_batch_size_, "maxBatchSize", "max batch size of dynamic batching", "");
+    AddFlag(&BenchmarkFlags::batch_timeout_us_, "batchTimeoutUs", "max time(us) a request waits for dynamic batching",
+            "");
   }
 
   ~BenchmarkFlags() override = default;
@@ -178,6 +190,8 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
 
   void InitResizeDimsList();
 
+  void InitShapeBucketsList();
+
   void InitCoreList();
 
  public:
@@ -213,6 +227,9 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
   // Resize
   std::string resize_dims_in_;
   std::vector<std::vector<int>> resize_dims_;
+  std::string shape_buckets_in_;
+  std::vector<std::vector<std::vector<int>>> shape_buckets_;
+  int shape_plan_cache_size_ = 0;
   // Distributed Infer
   int device_id_;
   int rank_id_;
@@ -231,6 +248,9 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
   bool enable_shared_thread_pool_ = false;
   std::string thread_num_limit_per_worker_;
   std::string thread_num_remaining_per_worker_;
+  bool enable_dynamic_batching_ = false;
+  std::string max_batch_size_;
+  std::string batch_timeout_us_;
 };
 
 class MS_API BenchmarkBase {
@@ -889,6 +889,55 @@ int BenchmarkUnifiedApi::CompareDataGetTotalCosineDistanceAndSize(const std::str
   return RET_OK;
 }
 
+int BenchmarkUnifiedApi::MarkResizePerformance() {
+  MS_LOG(INFO) << "Running resize benchmark loops...";
+  std::cout << "Running resize benchmark loops..." << std::endl;
+  auto &shape_buckets = flags_->shape_buckets_;
+  uint64_t resize_time_avg = 0;
+  uint64_t run_time_avg = 0;
+  for (int i = 0; i < flags_->loop_count_ + flags_->warm_up_loop_count_; i++) {
+    auto &bucket = shape_buckets[static_cast<size_t>(i) % shape_buckets.size()];
+    std::vector<std::vector<int64_t>> resize_dims;
+    (void)std::transform(bucket.begin(), bucket.end(), std::back_inserter(resize_dims),
+                         [&](auto &shapes) { return this->ConverterToInt64Vector<int>(shapes); });
+    auto inputs = ms_model_.GetInputs();
+    auto start = GetTimeUs();
+    auto status = ms_model_.Resize(inputs, resize_dims);
+    if (status != kSuccess) {
+      MS_LOG(ERROR) << "Input tensor resize failed.";
+      std::cerr << "Input tensor resize failed." << std::endl;
+      return RET_ERROR;
+    }
+    auto resize_end = GetTimeUs();
+    for (auto &tensor : inputs) {
+      (void)memset(tensor.MutableData(), 0, tensor.DataSize());
+    }
+    std::vector<MSTensor> outputs;
+    auto run_start = GetTimeUs();
+    status = ms_model_.Predict(inputs, &outputs);
+    if (status != kSuccess) {
+      MS_LOG(ERROR) << "Inference error ";
+      std::cerr << "Inference error " << std::endl;
+      return RET_ERROR;
+    }
+    auto end = GetTimeUs();
+    if (i < flags_->warm_up_loop_count_) {
+      continue;
+    }
+    resize_time_avg += resize_end - start;
+    run_time_avg += end - run_start;
+  }
+  if (flags_->loop_count_ > 0) {
+    resize_time_avg /= static_cast<size_t>(flags_->loop_count_);
+    run_time_avg /= static_cast<size_t>(flags_->loop_count_);
+    printf("Model = %s, ShapeBuckets = %zu, ShapePlanCacheSize = %d, AvgResizeTime = %f ms, AvgRunTime = %f ms\n",
+           flags_->model_file_.substr(flags_->model_file_.find_last_of(DELIM_SLASH) + 1).c_str(),
+           shape_buckets.size(), flags_->shape_plan_cache_size_, resize_time_avg / kFloatMSEC,
+           run_time_avg / kFloatMSEC);
+  }
+  return RET_OK;
+}
+
 int BenchmarkUnifiedApi::MarkPerformance() {
   MS_LOG(INFO) << "Running warm up loops...";
   std::cout << "Running warm up loops..." << std::endl;
@@ -1120,6 +1169,10 @@ void BenchmarkUnifiedApi::ModelParallelRunnerRun(int task_num, int parallel_idx)
       return;
     }
     auto predict_end = GetTimeUs();
+    {
+      std::lock_guard<std::mutex> latency_lock(predict_latency_mutex_);
+      predict_latency_us_.push_back(predict_end - predict_start);
+    }
     std::cout << "parallel index: " << parallel_idx << " | task index: " << i
               << " | predict time: " << (predict_end - predict_start) / kFloatMSEC << " ms\n";
     for (size_t j = 0; j < in.size(); j++) {
@@ -1153,9 +1206,38 @@ int BenchmarkUnifiedApi::AddConfigInfo(const std::shared_ptr<RunnerConfig> &runn
     config[kEnableSharedThreadPoolKey] = "false";
   }
   runner_config->SetConfigInfo(kSharedThreadPoolSection, config);
+  if (flags_->enable_dynamic_batching_) {
+    std::map<std::string, std::string> batch_config;
+    batch_config[kEnableDynamicBatchingKey] = "true";
+    if (!flags_->max_batch_size_.empty()) {
+      batch_config[kMaxBatchSizeKey] = flags_->max_batch_size_;
+    }
+    if (!flags_->batch_timeout_us_.empty()) {
+      batch_config[kBatchTimeoutUsKey] = flags_->batch_timeout_us_;
+    }
+    runner_config->SetConfigInfo(kDynamicBatchingSection, batch_config);
+  }
   return RET_OK;
 }
 
+void BenchmarkUnifiedApi::PrintParallelLatency(uint64_t run_time_us) {
+  std::lock_guard<std::mutex> latency_lock(predict_latency_mutex_);
+  if (predict_latency_us_.empty() || run_time_us == 0) {
+    return;
+  }
+  std::sort(predict_latency_us_.begin(), predict_latency_us_.end());
+  auto percentile = [this](double ratio) {
+    auto index = static_cast<size_t>(ratio * (predict_latency_us_.size() - 1));
+    return predict_latency_us_[index] / kFloatMSEC;
+  };
+  constexpr double kP50 = 0.5;
+  constexpr double kP99 = 0.99;
+  constexpr double kUsPerSecond = 1000000.0;
+  std::cout << "parallel predict request num: " << predict_latency_us_.size()
+            << " | throughput: " << predict_latency_us_.size() * kUsPerSecond / run_time_us << " requests/s"
+            << " | latency p50: " << percentile(kP50) << " ms | latency p99: " << percentile(kP99) << " ms\n";
+}
+
 int BenchmarkUnifiedApi::ParallelInference(std::shared_ptr<mindspore::Context> context) {
   if (flags_->warm_up_loop_count_ > kMaxRequestNum || flags_->parallel_num_ > kMaxRequestNum) {
     MS_LOG(WARNING) << "in parallel predict warm up loop count should less than" << kMaxRequestNum;
@@ -1228,6 +1310,7 @@ int BenchmarkUnifiedApi::ParallelInference(std::shared_ptr<mindspore::Context> c
   std::cout << "=================================" << std::endl;
   std::cout << "parallel predict init time: " << (model_init_end - model_init_start) / kFloatMSEC << " ms\n";
   std::cout << "parallel predict all run time: " << (end_run_time - start_run_time) / kFloatMSEC << " ms\n";
+  PrintParallelLatency(end_run_time - start_run_time);
   std::cout << "=================================" << std::endl;
   return RET_OK;
 }
@@ -1320,6 +1403,10 @@ int BenchmarkUnifiedApi::RunBenchmark() {
   }
 #endif
 
+  if (flags_->shape_plan_cache_size_ > 0) {
+    ms_model_.UpdateConfig(kCommonContextSection,
+                           std::make_pair(kShapePlanCacheSizeKey, std::to_string(flags_->shape_plan_cache_size_)));
+  }
   status = CompileGraph(model_type, context, model_name);
   if (status != RET_OK) {
     MS_LOG(ERROR) << "Compile graph failed.";
@@ -1351,6 +1438,14 @@ int BenchmarkUnifiedApi::RunBenchmark() {
     MS_LOG(ERROR) << "Generate input data error";
     return status;
   }
+  if (!flags_->shape_buckets_.empty()) {
+    status = MarkResizePerformance();
+    if (status != RET_OK) {
+      MS_LOG(ERROR) << "Run MarkResizePerformance error: " << status;
+      std::cout << "Run MarkResizePerformance error: " << status << std::endl;
+    }
+    return status;
+  }
   if (!flags_->benchmark_data_file_.empty()) {
     status = MarkAccuracy();
     if (status != RET_OK) {
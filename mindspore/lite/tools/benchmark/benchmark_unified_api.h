@@ -30,6 +30,7 @@
 #include <cfloat>
 #include <utility>
 #include <atomic>
+#include <mutex>
 #ifndef BENCHMARK_CLIP_JSON
 #include <nlohmann/json.hpp>
 #endif
@@ -103,6 +104,7 @@ class MS_API BenchmarkUnifiedApi : public BenchmarkBase {
   void ModelParallelRunnerRun(int task_num, int parallel_idx);
   int ParallelInference(std::shared_ptr<mindspore::Context> context);
   int AddConfigInfo(const std::shared_ptr<RunnerConfig> &runner_config);
+  void PrintParallelLatency(uint64_t run_time_us);
 #endif
 
   template <typename T>
@@ -116,6 +118,8 @@ class MS_API BenchmarkUnifiedApi : public BenchmarkBase {
 
   int MarkPerformance();
 
+  int MarkResizePerformance();
+
   int MarkAccuracy();
 
   void UpdateDistributionName(const std::shared_ptr<mindspore::Context> &context, std::string *name);
@@ -137,6 +141,8 @@ class MS_API BenchmarkUnifiedApi : public BenchmarkBase {
   std::vector<std::vector<mindspore::MSTensor>> all_outputs_;
   std::atomic<bool> model_parallel_runner_ret_failed_{false};
   std::atomic<bool> runner_run_start_ = false;
+  std::mutex predict_latency_mutex_;
+  std::vector<uint64_t> predict_latency_us_;
   mindspore::ModelParallelRunner model_runner_;
 #endif
 
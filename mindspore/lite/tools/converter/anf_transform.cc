@@ -53,6 +53,7 @@
 #include "tools/optimizer/fusion/multi_head_attention_fusion.h"
 #include "tools/optimizer/fusion/encoder_layer_fusion.h"
 #include "tools/optimizer/fusion/decoder_layer_fusion.h"
+#include "tools/optimizer/fusion/flash_attention_fusion_for_cpu.h"
 #include "tools/optimizer/fusion/glu_fusion.h"
 #include "tools/optimizer/graph/unused_add_node_remove_pass.h"
 #include "tools/optimizer/fusion/tflite_rel_pos_multi_head_attention_fusion.h"
@@ -328,6 +329,10 @@ std::vector<opt::PassPtr> InitFusions(const std::shared_ptr<ConverterPara> &para
     fusions.push_back(std::make_shared<opt::EncoderLayerFusion>());
     fusions.push_back(std::make_shared<opt::DecoderLayerFusion>());
   }
+  // the fused op has cpu kernels only, Ascend fuses attention into its own FlashAttention op.
+  if (param->device.find("Ascend") == std::string::npos && !param->train_model) {
+    fusions.push_back(std::make_shared<opt::FlashAttentionFusionForCpu>());
+  }
   return fusions;
 }
 
@@ -0,0 +1,342 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define USE_DEPRECATED_API
+#include "tools/optimizer/fusion/flash_attention_fusion_for_cpu.h"
+#include <cstring>
+#include <map>
+#include <memory>
+#include <vector>
+#include "mindspore/core/ops/lite_ops.h"
+#include "mindspore/core/ops/nn_ops.h"
+#include "ops/custom.h"
+#include "ops/fusion/mat_mul_fusion.h"
+#include "ops/fusion/mul_fusion.h"
+#include "ops/fusion/div_fusion.h"
+#include "ops/fusion/add_fusion.h"
+#include "ops/softmax.h"
+#include "ops/op_utils.h"
+#include "tools/optimizer/common/gllo_utils.h"
+#include "nnacl/op_base.h"
+
+namespace mindspore::opt {
+namespace {
+constexpr auto kNameFlashAttentionScaleMask = "FlashAttentionScaleMask";
+constexpr auto kNameFlashAttentionScale = "FlashAttentionScale";
+constexpr auto kNameFlashAttentionMask = "FlashAttentionMask";
+constexpr auto kNameFlashAttention = "FlashAttention";
+constexpr size_t kBNSDRank = 4;
+constexpr int64_t kSeqLenIndex = 2;
+constexpr int64_t kHeadSizeIndex = 3;
+// an additive mask value at or below it is taken as masked out.
+constexpr float kMaskedValue = -10000.0f;
+
+bool IsMulOrDivNode(const BaseRef &n) {
+  return IsSpecifiedNode<&prim::kPrimMulFusion>(n) || IsSpecifiedNode<&prim::kPrimDivFusion>(n);
+}
+
+bool GetNodeShape(const AnfNodePtr &node, ShapeVector *shape) {
+  MS_ASSERT(node != nullptr && shape != nullptr);
+  auto abstract = node->abstract();
+  if (abstract == nullptr) {
+    return false;
+  }
+  return FetchShapeFromAbstract(abstract, shape) == RET_OK;
+}
+
+bool HasActivation(const CNodePtr &cnode) {
+  auto prim = GetValueNode<PrimitivePtr>(cnode->input(0));
+  MS_CHECK_TRUE_RET(prim != nullptr, true);
+  auto act = prim->GetAttr(ops::kActivationType);
+  return act != nullptr && GetValue<int64_t>(act) != static_cast<int64_t>(ActivationType::NO_ACTIVATION);
+}
+
+bool CheckMatMul(const CNodePtr &matmul, bool expect_transpose_b) {
+  MS_CHECK_TRUE_RET(matmul != nullptr && matmul->size() == kInputSizeThree, false);
+  auto matmul_prim = ops::GetOperator<ops::MatMulFusion>(matmul->input(0));
+  MS_CHECK_TRUE_RET(matmul_prim != nullptr, false);
+  bool transpose_a = matmul_prim->GetAttr(ops::kTransposeA) != nullptr && matmul_prim->get_transpose_a();
+  bool transpose_b = matmul_prim->GetAttr(ops::kTransposeB) != nullptr && matmul_prim->get_transpose_b();
+  return !transpose_a && transpose_b == expect_transpose_b && !HasActivation(matmul);
+}
+
+// returns the [B, N, S, D] key of q * k^T, or nullptr when k is not transposed on its last two axes.
+AnfNodePtr GetKeyNode(const CNodePtr &matmul_qk) {
+  if (CheckMatMul(matmul_qk, true)) {
+    return matmul_qk->input(kInputIndexTwo);
+  }
+  if (!CheckMatMul(matmul_qk, false) || !CheckPrimitiveType(matmul_qk->input(kInputIndexTwo), prim::kPrimTranspose)) {
+    return nullptr;
+  }
+  auto transpose = matmul_qk->input(kInputIndexTwo)->cast<CNodePtr>();
+  MS_CHECK_TRUE_RET(transpose != nullptr && transpose->size() == kInputSizeThree, nullptr);
+  auto perm_tensor = GetTensorInfo(transpose->input(kInputIndexTwo));
+  if (perm_tensor == nullptr || perm_tensor->data_type() != kNumberTypeInt32 ||
+      perm_tensor->DataSize() != kBNSDRank) {
+    return nullptr;
+  }
+  auto perm = static_cast<int32_t *>(perm_tensor->data_c());
+  MS_CHECK_TRUE_RET(perm != nullptr, nullptr);
+  if (perm[0] != 0 || perm[1] != 1 || perm[kSeqLenIndex] != kHeadSizeIndex || perm[kHeadSizeIndex] != kSeqLenIndex) {
+    return nullptr;
+  }
+  return transpose->input(1);
+}
+
+// the kernel reads v with the strides of k, so they must have the same shape. Only the batch may be dynamic, it is
+// the same batch as the one of q.
+bool IsKernelSupportedKV(const ShapeVector &q_shape, const ShapeVector &k_shape, const ShapeVector &v_shape) {
+  if (k_shape != v_shape || q_shape[0] != k_shape[0]) {
+    return false;
+  }
+  for (size_t i = 1; i < kBNSDRank; i++) {
+    if (q_shape[i] <= 0 || k_shape[i] <= 0) {
+      return false;
+    }
+  }
+  return q_shape[kHeadSizeIndex] == k_shape[kHeadSizeIndex] && q_shape[1] % k_shape[1] == 0;
+}
+
+// the kernel broadcasts the mask over batch and heads only, its last two axes must be [q_seq_len, kv_seq_len].
+bool IsKernelSupportedMask(const ShapeVector &mask_shape, const ShapeVector &q_shape, const ShapeVector &k_shape) {
+  if (mask_shape.size() != kBNSDRank) {
+    return false;
+  }
+  return (mask_shape[0] == 1 || mask_shape[0] == q_shape[0]) && (mask_shape[1] == 1 || mask_shape[1] == q_shape[1]) &&
+         mask_shape[kSeqLenIndex] == q_shape[kSeqLenIndex] && mask_shape[kHeadSizeIndex] == k_shape[kSeqLenIndex];
+}
+}  // namespace
+
+bool FlashAttentionFusionForCpu::InitVar() const {
+  q_ = std::make_shared<Var>();
+  MS_CHECK_TRUE_RET(q_ != nullptr, false);
+  k_ = std::make_shared<Var>();
+  MS_CHECK_TRUE_RET(k_ != nullptr, false);
+  v_ = std::make_shared<Var>();
+  MS_CHECK_TRUE_RET(v_ != nullptr, false);
+  scale_ = std::make_shared<CondVar>(IsParamOrValueNodeWithData);
+  MS_CHECK_TRUE_RET(scale_ != nullptr, false);
+  mask_ = std::make_shared<Var>();
+  MS_CHECK_TRUE_RET(mask_ != nullptr, false);
+  return true;
+}
+
+VectorRef FlashAttentionFusionForCpu::DefineFlashAttentionPattern(bool has_scale, bool has_mask) const {
+  auto is_matmul_qk = std::make_shared<CondVar>(IsSpecifiedNode<&prim::kPrimMatMulFusion>);
+  MS_CHECK_TRUE_RET(is_matmul_qk != nullptr, {});
+  VectorRef scores({is_matmul_qk, q_, k_});
+  if (has_scale) {
+    auto is_scale = std::make_shared<CondVar>(IsMulOrDivNode);
+    MS_CHECK_TRUE_RET(is_scale != nullptr, {});
+    scores = VectorRef({is_scale, scores, scale_});
+  }
+  if (has_mask) {
+    auto is_add = std::make_shared<CondVar>(IsSpecifiedNode<&prim::kPrimAddFusion>);
+    MS_CHECK_TRUE_RET(is_add != nullptr, {});
+    scores = VectorRef({is_add, scores, mask_});
+  }
+  auto is_softmax = std::make_shared<CondVar>(IsSpecifiedNode<&prim::kPrimSoftmax>);
+  MS_CHECK_TRUE_RET(is_softmax != nullptr, {});
+  VectorRef softmax({is_softmax, scores});
+  auto is_matmul_sv = std::make_shared<CondVar>(IsSpecifiedNode<&prim::kPrimMatMulFusion>);
+  MS_CHECK_TRUE_RET(is_matmul_sv != nullptr, {});
+  return VectorRef({is_matmul_sv, softmax, v_});
+}
+
+std::unordered_map<std::string, VectorRef> FlashAttentionFusionForCpu::DefinePatterns() const {
+  std::unordered_map<std::string, VectorRef> patterns;
+  if (!InitVar()) {
+    MS_LOG(ERROR) << "initial member failed.";
+    return patterns;
+  }
+  patterns[kNameFlashAttentionScaleMask] = DefineFlashAttentionPattern(true, true);
+  patterns[kNameFlashAttentionScale] = DefineFlashAttentionPattern(true, false);
+  patterns[kNameFlashAttentionMask] = DefineFlashAttentionPattern(false, true);
+  patterns[kNameFlashAttention] = DefineFlashAttentionPattern(false, false);
+  return patterns;
+}
+
+bool FlashAttentionFusionForCpu::GetScale(const CNodePtr &scale_cnode, float *scale) const {
+  if (HasActivation(scale_cnode)) {
+    return false;
+  }
+  auto scale_tensor = GetTensorInfo(scale_cnode->input(kInputIndexTwo));
+  if (scale_tensor == nullptr || scale_tensor->data_type() != kNumberTypeFloat32 || scale_tensor->DataSize() != 1) {
+    MS_LOG(INFO) << scale_cnode->fullname_with_scope() << " is not scaled by a float32 scalar.";
+    return false;
+  }
+  auto value = static_cast<float *>(scale_tensor->data_c())[0];
+  if (CheckPrimitiveType(scale_cnode, prim::kPrimDivFusion)) {
+    if (value == 0.0f) {
+      return false;
+    }
+    value = 1.0f / value;
+  }
+  *scale = value;
+  return true;
+}
+
+bool FlashAttentionFusionForCpu::IsCausalMask(const AnfNodePtr &mask, int64_t q_seq_len, int64_t kv_seq_len) const {
+  if (q_seq_len <= 0 || kv_seq_len < q_seq_len) {
+    return false;
+  }
+  auto mask_tensor = GetTensorInfo(mask);
+  if (mask_tensor == nullptr || mask_tensor->data_type() != kNumberTypeFloat32 ||
+      mask_tensor->DataSize() != static_cast<size_t>(q_seq_len * kv_seq_len)) {
+    return false;
+  }
+  auto mask_shape = mask_tensor->shape();
+  if (mask_shape.size() < C2NUM || mask_shape[mask_shape.size() - C2NUM] != q_seq_len ||
+      mask_shape.back() != kv_seq_len) {
+    return false;
+  }
+  auto data = static_cast<float *>(mask_tensor->data_c());
+  MS_CHECK_TRUE_RET(data != nullptr, false);
+  auto offset = kv_seq_len - q_seq_len;
+  for (int64_t i = 0; i < q_seq_len; i++) {
+    for (int64_t j = 0; j < kv_seq_len; j++) {
+      auto value = data[i * kv_seq_len + j];
+      bool visible = j <= i + offset;
+      if ((visible && value != 0.0f) || (!visible && value > kMaskedValue)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+CNodePtr FlashAttentionFusionForCpu::CreateFlashAttentionNode(const FuncGraphPtr &func_graph, const AnfNodePtr &node,
+                                                              const std::vector<AnfNodePtr> &inputs, float scale,
+                                                              bool is_causal) const {
+  auto fa_prim = std::make_shared<ops::Custom>();
+  MS_CHECK_TRUE_RET(fa_prim != nullptr, nullptr);
+  // "FlashAttention" is the Ascend op of FlashAttentionFusionForCustom, which takes other inputs and attrs.
+  fa_prim->set_type("CpuFlashAttention");
+  std::vector<uint8_t> scale_value(sizeof(float));
+  (void)memcpy(scale_value.data(), &scale, sizeof(float));
+  std::map<std::string, std::vector<uint8_t>> attrs = {{"scale_value", scale_value},
+                                                       {"is_causal", {static_cast<uint8_t>(is_causal)}}};
+  fa_prim->set_attr(attrs);
+  auto fa_prim_c = fa_prim->GetPrim();
+  MS_CHECK_TRUE_RET(fa_prim_c != nullptr, nullptr);
+  auto fa_cnode = func_graph->NewCNode(fa_prim_c, inputs);
+  MS_CHECK_TRUE_RET(fa_cnode != nullptr, nullptr);
+  fa_cnode->set_fullname_with_scope(node->fullname_with_scope() + "_flash_attention_fusion");
+  if (node->abstract() != nullptr) {
+    fa_cnode->set_abstract(node->abstract()->Clone());
+  }
+  return fa_cnode;
+}
+
+AnfNodePtr FlashAttentionFusionForCpu::Process(const std::string &pattern_name, const FuncGraphPtr &func_graph,
+                                               const AnfNodePtr &node, const EquivPtr &equiv) const {
+  if (func_graph == nullptr || node == nullptr || equiv == nullptr) {
+    lite::ReturnCode::GetSingleReturnCode()->UpdateReturnCode(lite::RET_NULL_PTR);
+    return nullptr;
+  }
+  auto matmul_sv = node->cast<CNodePtr>();
+  if (matmul_sv == nullptr || IsMarkedTrainOp(matmul_sv) || !CheckMatMul(matmul_sv, false)) {
+    return nullptr;
+  }
+  bool has_scale = pattern_name == kNameFlashAttentionScaleMask || pattern_name == kNameFlashAttentionScale;
+  bool has_mask = pattern_name == kNameFlashAttentionScaleMask || pattern_name == kNameFlashAttentionMask;
+
+  // walk up from the output, none of the intermediate results may be used by others.
+  auto softmax = matmul_sv->input(1)->cast<CNodePtr>();
+  MS_CHECK_TRUE_RET(softmax != nullptr, nullptr);
+  auto softmax_prim = ops::GetOperator<ops::Softmax>(softmax->input(0));
+  MS_CHECK_TRUE_RET(softmax_prim != nullptr && softmax_prim->GetAttr(ops::kAxis) != nullptr, nullptr);
+  auto axis = softmax_prim->get_axis();
+  if (axis.size() != 1 || (axis[0] != -1 && axis[0] != static_cast<int64_t>(kHeadSizeIndex))) {
+    return nullptr;
+  }
+  std::vector<CNodePtr> fused_nodes = {softmax};
+  auto scores = softmax->input(1)->cast<CNodePtr>();
+  if (has_mask) {
+    MS_CHECK_TRUE_RET(scores != nullptr, nullptr);
+    if (HasActivation(scores)) {
+      return nullptr;
+    }
+    fused_nodes.push_back(scores);
+    scores = scores->input(1)->cast<CNodePtr>();
+  }
+  float scale = 1.0f;
+  if (has_scale) {
+    MS_CHECK_TRUE_RET(scores != nullptr, nullptr);
+    if (!GetScale(scores, &scale)) {
+      return nullptr;
+    }
+    fused_nodes.push_back(scores);
+    scores = scores->input(1)->cast<CNodePtr>();
+  }
+  MS_CHECK_TRUE_RET(scores != nullptr, nullptr);
+  fused_nodes.push_back(scores);
+  for (auto &fused_node : fused_nodes) {
+    if (IsMultiOutputTensors(func_graph, fused_node)) {
+      MS_LOG(INFO) << fused_node->fullname_with_scope() << " is used by other nodes, can not fuse flash attention.";
+      return nullptr;
+    }
+  }
+
+  auto q = utils::cast<AnfNodePtr>((*equiv)[q_]);
+  auto k = GetKeyNode(scores);
+  auto v = utils::cast<AnfNodePtr>((*equiv)[v_]);
+  if (q == nullptr || k == nullptr || v == nullptr) {
+    return nullptr;
+  }
+  TypeId q_type;
+  if (GetDataTypeFromAnfNode(q, &q_type) != RET_OK || q_type != kNumberTypeFloat32) {
+    return nullptr;
+  }
+  ShapeVector q_shape;
+  ShapeVector k_shape;
+  ShapeVector v_shape;
+  if (!GetNodeShape(q, &q_shape) || !GetNodeShape(k, &k_shape) || !GetNodeShape(v, &v_shape) ||
+      q_shape.size() != kBNSDRank || k_shape.size() != kBNSDRank || v_shape.size() != kBNSDRank) {
+    MS_LOG(INFO) << "flash attention on cpu only supports q/k/v of BNSD layout, node: " << node->fullname_with_scope();
+    return nullptr;
+  }
+  if (!IsKernelSupportedKV(q_shape, k_shape, v_shape)) {
+    MS_LOG(INFO) << "flash attention on cpu does not support q shape " << q_shape << ", k shape " << k_shape
+                 << " and v shape " << v_shape << ", node: " << node->fullname_with_scope();
+    return nullptr;
+  }
+
+  std::vector<AnfNodePtr> inputs = {q, k, v};
+  bool is_causal = false;
+  if (has_mask) {
+    auto mask = utils::cast<AnfNodePtr>((*equiv)[mask_]);
+    MS_CHECK_TRUE_RET(mask != nullptr, nullptr);
+    is_causal = IsCausalMask(mask, q_shape[kSeqLenIndex], k_shape[kSeqLenIndex]);
+    if (!is_causal) {
+      ShapeVector mask_shape;
+      if (!GetNodeShape(mask, &mask_shape) || !IsKernelSupportedMask(mask_shape, q_shape, k_shape)) {
+        MS_LOG(INFO) << "flash attention on cpu does not support mask shape " << mask_shape
+                     << ", node: " << node->fullname_with_scope();
+        return nullptr;
+      }
+      inputs.push_back(mask);
+    }
+  }
+  auto fa_cnode = CreateFlashAttentionNode(func_graph, node, inputs, scale, is_causal);
+  if (fa_cnode == nullptr) {
+    MS_LOG(ERROR) << "create flash attention node failed, node: " << node->fullname_with_scope();
+    return nullptr;
+  }
+  MS_LOG(INFO) << "fuse flash attention node " << fa_cnode->fullname_with_scope() << ", is causal: " << is_causal;
+  return fa_cnode;
+}
+}  // namespace mindspore::opt
@@ -0,0 +1,75 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_TOOLS_OPTIMIZER_FUSION_FLASH_ATTENTION_FUSION_FOR_CPU_H_
+#define MINDSPORE_LITE_TOOLS_OPTIMIZER_FUSION_FLASH_ATTENTION_FUSION_FOR_CPU_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "tools/optimizer/common/multiple_pattern_process_pass.h"
+
+namespace mindspore {
+namespace opt {
+/*
+ * Fuse the scaled dot product attention of BNSD q/k/v into a Custom CpuFlashAttention op run by the lite CPU kernel,
+ * which never materializes the seq x seq score matrix.
+ *
+ *      q     k      (k: matmul transpose_b, or Transpose(k, [0, 1, 3, 2]))
+ *       \   /
+ *       matmul
+ *         |
+ *     mul / div  scale      (optional, scalar constant)
+ *         |
+ *        add     mask       (optional, [B or 1, N or 1, Sq, Skv], a constant causal mask is turned into is_causal)
+ *         |
+ *      softmax              (last axis)
+ *         |
+ *       matmul   v
+ *
+ * As the kernel requires, q/k/v are static but the batch, k and v have the same shape and the number of q heads is a
+ * multiple of that of kv heads.
+ */
+class FlashAttentionFusionForCpu : public MultiplePatternProcessPass {
+ public:
+  explicit FlashAttentionFusionForCpu(const std::string &name = "FlashAttentionFusionForCpu", bool multigraph = true)
+      : MultiplePatternProcessPass(name, multigraph) {}
+
+  ~FlashAttentionFusionForCpu() override = default;
+
+  std::unordered_map<std::string, VectorRef> DefinePatterns() const override;
+
+  AnfNodePtr Process(const std::string &pattern_name, const FuncGraphPtr &func_graph, const AnfNodePtr &node,
+                     const EquivPtr &equiv) const override;
+
+ private:
+  bool InitVar() const;
+  VectorRef DefineFlashAttentionPattern(bool has_scale, bool has_mask) const;
+  bool GetScale(const CNodePtr &scale_cnode, float *scale) const;
+  bool IsCausalMask(const AnfNodePtr &mask, int64_t q_seq_len, int64_t kv_seq_len) const;
+  CNodePtr CreateFlashAttentionNode(const FuncGraphPtr &func_graph, const AnfNodePtr &node,
+                                    const std::vector<AnfNodePtr> &inputs, float scale, bool is_causal) const;
+
+ protected:
+  mutable VarPtr q_ = nullptr;
+  mutable VarPtr k_ = nullptr;
+  mutable VarPtr v_ = nullptr;
+  mutable VarPtr scale_ = nullptr;
+  mutable VarPtr mask_ = nullptr;
+};
+}  // namespace opt
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_TOOLS_OPTIMIZER_FUSION_FLASH_ATTENTION_FUSION_FOR_CPU_H_
@@ -672,6 +672,45 @@ class Tensor(Tensor_, metaclass=_TensorMeta):
 
         return Tensor(Tensor_.from_numpy(array))
 
+    @staticmethod
+    def from_dlpack(ext_tensor):
+        """
+        Convert a tensor of another framework to Tensor through DLPack.
+        If the data is compact and row-major, the tensor will be constructed using the same memory without copy.
+        Otherwise, the data will be copied to a row-major tensor.
+
+        Args:
+            ext_tensor (object): An object implementing `__dlpack__` on cpu, or a DLPack capsule.
+
+        Returns:
+            Tensor, has the same data type and shape as input.
+
+        Examples:
+            >>> import numpy as np
+            >>> from mindspore import Tensor
+            >>> x = np.array([1, 2])
+            >>> output = Tensor.from_dlpack(x)
+            >>> print(output)
+            [1 2]
+        """
+        return Tensor(Tensor_.from_dlpack(ext_tensor))
+
+    def __dlpack__(self, stream=None):
+        """
+        Export the tensor as a DLPack capsule sharing the same memory, for `from_dlpack` of other frameworks.
+        Only tensors on cpu are exported, `stream` must be None.
+        """
+        if stream is not None:
+            raise ValueError(f"For '__dlpack__', 'stream' must be None for a tensor on cpu, but got {stream}.")
+        self._init_check()
+        return Tensor_.to_dlpack(self)
+
+    def __dlpack_device__(self):
+        """
+        Get the DLPack device type and id of the tensor.
+        """
+        return Tensor_.dlpack_device(self)
+
     def ndimension(self):
         r"""
         Alias for :func:`mindspore.Tensor.ndim`.
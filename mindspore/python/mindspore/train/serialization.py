@@ -63,7 +63,7 @@ from mindspore.parallel._ps_context import _set_checkpoint_load_status, _store_w
     _store_warm_up_ptr_by_tensor_list, _cache_enable
 from mindspore.train._utils import read_proto
 from mindspore._c_expression import load_mindir, _encrypt, _decrypt, _is_cipher_file, dynamic_obfuscate_mindir, \
-    split_mindir, split_dynamic_mindir
+    split_mindir, split_dynamic_mindir, CheckpointWriter
 from ..ops.operations._opaque_predicate_registry import add_opaque_predicate, clean_funcs
 from ..ops.operations import Cast
 
@@ -84,6 +84,7 @@ mindir_to_tensor_type = {1: mstype.float32, 2: mstype.uint8, 3: mstype.int8, 4:
                          11: mstype.float64, 12: mstype.uint32, 13: mstype.uint64}
 
 _ckpt_mutex = RLock()
+_ckpt_writer = None
 
 # unit is KB
 SLICE_SIZE = 512 * 1024
@@ -411,6 +412,14 @@ def save_checkpoint(save_obj, ckpt_file_name, integrated_save=True,
                                  be saved. Default: ``None`` .
         kwargs (dict): Configuration options dictionary.
 
+            - sharded (bool): Whether to save a sharded checkpoint, `ckpt_file_name` is then a directory holding the
+              shard files and the manifest, the shards are written in the background on the host threads and
+              `async_save` only decides whether to wait for them. Encryption and string values are not supported.
+              Default: ``False`` .
+            - incremental (bool): For a sharded checkpoint, whether to write only the parameters changed since the
+              last sharded save, the manifest refers the others to the files of the earlier checkpoints, which must
+              be kept. Default: ``False`` .
+
     Raises:
         TypeError: If the parameter `save_obj` is not :class:`mindspore.nn.Cell` , list or dict type.
         TypeError: If the parameter `integrated_save` or `async_save` is not bool type.
@@ -442,6 +451,10 @@ def save_checkpoint(save_obj, ckpt_file_name, integrated_save=True,
         - `Saving and Loading the Model - Saving and Loading the Model Weight
           <https://mindspore.cn/tutorials/en/r2.2/beginner/save_load.html#saving-and-loading-the-model-weight>`_
     """
+    if kwargs.get('sharded', False):
+        _save_sharded_checkpoint(save_obj, ckpt_file_name, integrated_save, async_save, append_dict, enc_key,
+                                 choice_func, kwargs.get('incremental', False))
+        return
     ckpt_file_name = _check_save_obj_and_ckpt_file_name(save_obj, ckpt_file_name)
     integrated_save = Validator.check_bool(integrated_save)
     async_save = Validator.check_bool(async_save)
@@ -526,6 +539,54 @@ def save_checkpoint(save_obj, ckpt_file_name, integrated_save=True,
     logger.info("Saving checkpoint process is finished.")
 
 
+def _save_sharded_checkpoint(save_obj, ckpt_dir, integrated_save, async_save, append_dict, enc_key, choice_func,
+                             incremental):
+    """Save the parameters to a sharded checkpoint directory by the checkpoint writer."""
+    global _ckpt_writer
+    if not isinstance(save_obj, (nn.Cell, list, dict)):
+        raise TypeError("For 'save_checkpoint', the parameter 'save_obj' must be nn.Cell, list or dict, "
+                        "but got {}.".format(type(save_obj)))
+    ckpt_dir = os.path.abspath(Validator.check_isinstance('ckpt_file_name', ckpt_dir, str))
+    if os.path.isfile(ckpt_dir):
+        raise NotADirectoryError("For 'save_checkpoint', the sharded checkpoint {} is a file, it must be a "
+                                 "directory.".format(ckpt_dir))
+    if enc_key is not None:
+        raise ValueError("For 'save_checkpoint', the sharded checkpoint does not support encryption.")
+    integrated_save = Validator.check_bool(integrated_save)
+    async_save = Validator.check_bool(async_save)
+    incremental = Validator.check_bool(incremental)
+    append_dict = _check_append_dict(append_dict)
+    save_obj = _convert_save_obj_to_param_list(save_obj, integrated_save, append_dict, choice_func)
+    if append_dict:
+        for k_name, value in append_dict.items():
+            save_obj.append({"name": k_name, "data": value})
+
+    tensors = OrderedDict()
+    for param in save_obj:
+        data = param["data"]
+        if isinstance(data, list):
+            # The persistent, offloaded and bfloat16 parameters are converted to [kind, tensor, shape, dtype, ...].
+            data = cpu_cast(data[1], mstype.bfloat16) if data[0] == "BFloat16_tensor" else data[1]
+        if isinstance(data, Parameter):
+            data.init_data()
+        if isinstance(data, (int, float, bool)):
+            data = Tensor(data)
+        if not isinstance(data, Tensor) or isinstance(data, MapParameter):
+            raise TypeError("For 'save_checkpoint', the sharded checkpoint only supports Tensor and Parameter, "
+                            "but got {} for {}.".format(type(data), param["name"]))
+        tensors[param["name"]] = data
+
+    logger.info("Execute the process of saving the sharded checkpoint.")
+    with _ckpt_mutex:
+        if _ckpt_writer is None:
+            _ckpt_writer = CheckpointWriter()
+        if not _ckpt_writer.save(ckpt_dir, tensors, incremental):
+            raise RuntimeError("For 'save_checkpoint', save the sharded checkpoint {} failed.".format(ckpt_dir))
+        if not async_save and not _ckpt_writer.wait():
+            raise RuntimeError("For 'save_checkpoint', write the sharded checkpoint {} failed.".format(ckpt_dir))
+    logger.info("Saving the sharded checkpoint process is finished.")
+
+
 def _convert_list_to_param_list(save_obj, choice_func):
     """Convert a list of Parameter to param_list."""
     param_list = []
@@ -1078,6 +1139,9 @@ def load_checkpoint(ckpt_file_name, net=None, strict_load=False, filter_prefix=N
         - `Saving and Loading the Model - Saving and Loading the Model Weight
           <https://mindspore.cn/tutorials/en/r2.2/beginner/save_load.html#saving-and-loading-the-model-weight>`_
     """
+    if isinstance(ckpt_file_name, str) and os.path.isdir(ckpt_file_name):
+        return _load_sharded_checkpoint(ckpt_file_name, net, strict_load, filter_prefix, dec_key, specify_prefix,
+                                        choice_func)
     ckpt_file_name = _check_ckpt_file_name(ckpt_file_name)
     specify_prefix = _check_prefix(specify_prefix)
     filter_prefix = _check_prefix(filter_prefix)
@@ -1168,6 +1232,37 @@ def load_checkpoint(ckpt_file_name, net=None, strict_load=False, filter_prefix=N
     return parameter_dict
 
 
+def _load_sharded_checkpoint(ckpt_dir, net, strict_load, filter_prefix, dec_key, specify_prefix, choice_func):
+    """Load the parameters of a sharded checkpoint directory saved by save_checkpoint."""
+    if dec_key is not None:
+        raise ValueError("For 'load_checkpoint', the sharded checkpoint does not support decryption.")
+    specify_prefix = _check_prefix(specify_prefix)
+    filter_prefix = _check_prefix(filter_prefix)
+    ckpt_dir = os.path.abspath(ckpt_dir)
+    if not os.path.isfile(os.path.join(ckpt_dir, "manifest.json")):
+        raise ValueError("For 'load_checkpoint', the directory {} is not a sharded checkpoint, the manifest.json "
+                         "does not exist.".format(ckpt_dir))
+    logger.info("Execute the process of loading the sharded checkpoint.")
+    try:
+        tensors = CheckpointWriter.load(ckpt_dir)
+    except RuntimeError as e:
+        raise ValueError(e.__str__() + "\nFor 'load_checkpoint', "
+                                       "failed to load the sharded checkpoint {}.".format(ckpt_dir)) from e
+    parameter_dict = {}
+    for name, data in tensors.items():
+        if not _whether_load_param(specify_prefix, filter_prefix, name):
+            continue
+        if specify_prefix is None and filter_prefix is None and choice_func is not None and not choice_func(name):
+            continue
+        parameter_dict[name] = Parameter(Tensor(data), name=name)
+    if not parameter_dict:
+        raise ValueError(f"The loaded parameter dict is empty after filter or specify, please check whether "
+                         f"'filter_prefix', 'specify_prefix' or 'choice_func' are set correctly.")
+    if net is not None:
+        load_param_into_net(net, parameter_dict, strict_load)
+    return parameter_dict
+
+
 def _load_map_parameter(checkpoint_list, element, element_id, map_data_list,
                         map_shape_list, parameter_dict):
     """load map parameter."""
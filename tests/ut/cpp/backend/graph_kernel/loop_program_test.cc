@@ -0,0 +1,156 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "utils/ms_context.h"
+#include "mindspore/core/ops/framework_ops.h"
+#include "include/backend/kernel_info.h"
+#include "include/backend/anf_runtime_algorithm.h"
+#include "include/common/utils/anfalgo.h"
+#include "backend/common/graph_kernel/core/graph_builder.h"
+#include "backend/common/graph_kernel/loop_program_split.h"
+#include "backend/common/graph_kernel/model/graph_builder.h"
+#include "backend/common/graph_kernel/model/loop_program.h"
+
+namespace mindspore::graphkernel {
+namespace {
+using KernelBuildInfoBuilder = kernel::KernelBuildInfo::KernelBuildInfoBuilder;
+const ShapeVector kShape = {4, 8};
+
+// Give the node the abstract and kernel info of a float32 [4, 8] tensor, as the kernel select does.
+void SetTensorInfo(const AnfNodePtr &node, size_t input_num) {
+  node->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, kShape));
+  KernelBuildInfoBuilder builder;
+  builder.SetInputsFormat(std::vector<std::string>(input_num, kOpFormat_DEFAULT));
+  builder.SetInputsDeviceType(std::vector<TypeId>(input_num, kNumberTypeFloat32));
+  builder.SetOutputsFormat({kOpFormat_DEFAULT});
+  builder.SetOutputsDeviceType({kNumberTypeFloat32});
+  builder.SetProcessor(kernel::Processor::CPU);
+  builder.SetKernelType(KernelType::CPU_KERNEL);
+  node->set_kernel_info(std::make_shared<device::KernelInfo>());
+  AnfAlgo::SetSelectKernelBuildInfo(builder.Build(), node.get());
+}
+}  // namespace
+
+class TestLoopProgram : public UT::Common {
+ public:
+  TestLoopProgram() = default;
+  void SetUp() override {
+    auto context = MsContext::GetInstance();
+    MS_EXCEPTION_IF_NULL(context);
+    context->set_param<std::string>(MS_CTX_DEVICE_TARGET, kCPUDevice);
+  }
+
+ protected:
+  ParameterPtr NewParameter(const FuncGraphPtr &fg) const {
+    auto param = fg->add_parameter();
+    SetTensorInfo(param, 0);
+    return param;
+  }
+
+  CNodePtr NewCNode(const FuncGraphPtr &fg, const std::string &name, const AnfNodePtrList &inputs) const {
+    AnfNodePtrList node_inputs{NewValueNode(std::make_shared<Primitive>(name))};
+    (void)node_inputs.insert(node_inputs.end(), inputs.begin(), inputs.end());
+    auto node = fg->NewCNode(node_inputs);
+    SetTensorInfo(node, inputs.size());
+    return node;
+  }
+};
+
+/// Feature: LoopProgram lowering.
+/// Description: Lower an elementwise cluster ending with a reduce of the innermost axis.
+/// Expectation: The rows are the outer axis, the reduce runs over the inner block.
+TEST_F(TestLoopProgram, test_lower_elemwise_reduce) {
+  inner::GraphBuilder gb("elemwise_reduce");
+  auto x = gb.Parameter({kShape, kNumberTypeFloat32, kOpFormat_DEFAULT});
+  auto y = gb.Parameter({{1, 8}, kNumberTypeFloat32, kOpFormat_DEFAULT});
+  auto sum = gb.ReduceSum(gb.Exp(gb.Add(x, y)), {-1}, true);
+  gb.SetOutputs({sum});
+  auto program = inner::LoopProgram::Lower(gb.Get());
+  ASSERT_NE(program, nullptr);
+  EXPECT_TRUE(program->has_reduce());
+  EXPECT_EQ(program->row_num(), 4);
+  EXPECT_EQ(program->inner_size(), 8);
+  EXPECT_EQ(program->inputs().size(), 2);
+  EXPECT_EQ(program->outputs().size(), 1);
+  EXPECT_EQ(program->instructions().back().op, inner::LoopProgram::OpCode::kReduceSum);
+}
+
+/// Feature: LoopProgram lowering.
+/// Description: Lower clusters with a transpose, an unsupported op and an integer input.
+/// Expectation: The lowering fails instead of producing a wrong loop nest.
+TEST_F(TestLoopProgram, test_lower_unsupported) {
+  {
+    inner::GraphBuilder gb("transpose");
+    auto x = gb.Parameter({kShape, kNumberTypeFloat32, kOpFormat_DEFAULT});
+    gb.SetOutputs({gb.Exp(gb.Transpose(x, {1, 0}))});
+    EXPECT_EQ(inner::LoopProgram::Lower(gb.Get()), nullptr);
+  }
+  {
+    inner::GraphBuilder gb("asin");
+    auto x = gb.Parameter({kShape, kNumberTypeFloat32, kOpFormat_DEFAULT});
+    gb.SetOutputs({gb.Emit("Asin", {gb.Exp(x)})});
+    EXPECT_EQ(inner::LoopProgram::Lower(gb.Get()), nullptr);
+  }
+  {
+    inner::GraphBuilder gb("int32");
+    auto x = gb.Parameter({kShape, kNumberTypeInt32, kOpFormat_DEFAULT});
+    gb.SetOutputs({gb.Add(x, x)});
+    EXPECT_EQ(inner::LoopProgram::Lower(gb.Get()), nullptr);
+  }
+}
+
+/// Feature: LoopProgramSplit pass.
+/// Description: Run the pass on a graph with a cluster that can be lowered and a cluster with an unsupported op.
+/// Expectation: The first cluster is kept with its program cached on the sub graph, the second is split to single ops.
+TEST_F(TestLoopProgram, test_loop_program_split) {
+  auto fg = std::make_shared<FuncGraph>();
+  auto x = NewParameter(fg);
+  auto y = NewParameter(fg);
+  auto add = NewCNode(fg, "Add", {x, y});
+  auto exp = NewCNode(fg, "Exp", {add});
+  auto mul = NewCNode(fg, "Mul", {exp, y});
+  auto asin = NewCNode(fg, "Asin", {mul});
+  auto sub = NewCNode(fg, "Sub", {asin, x});
+  auto ret = fg->NewCNode({NewValueNode(prim::kPrimReturn), sub});
+  fg->set_return(ret);
+  auto lowered = ReplaceNodesWithGraphKernelNode({add, exp}, fg);
+  auto unsupported = ReplaceNodesWithGraphKernelNode({mul, asin, sub}, fg);
+  ASSERT_TRUE(common::AnfAlgo::IsGraphKernel(lowered));
+  ASSERT_TRUE(common::AnfAlgo::IsGraphKernel(unsupported));
+
+  EXPECT_TRUE(std::make_shared<LoopProgramSplit>()->Run(fg));
+  auto nodes = TopoSort(fg->get_return());
+  size_t graph_kernel_num = 0;
+  size_t asin_num = 0;
+  for (const auto &node : nodes) {
+    if (common::AnfAlgo::IsGraphKernel(node)) {
+      ++graph_kernel_num;
+      EXPECT_EQ(node, lowered);
+    }
+    if (IsPrimitiveCNode(node, std::make_shared<Primitive>("Asin"))) {
+      ++asin_num;
+    }
+  }
+  EXPECT_EQ(graph_kernel_num, 1);
+  EXPECT_EQ(asin_num, 1);
+  auto sub_graph = common::AnfAlgo::GetCNodeFuncGraphPtr(lowered);
+  ASSERT_NE(sub_graph, nullptr);
+  EXPECT_NE(sub_graph->user_data<inner::LoopProgram>(), nullptr);
+}
+}  // namespace mindspore::graphkernel
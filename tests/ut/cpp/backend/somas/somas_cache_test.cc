@@ -0,0 +1,168 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdio>
+#include <sys/stat.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "backend/common/somas/somas.h"
+
+namespace mindspore::somas {
+namespace {
+// A somas model built by hand: a chain of kernels, kernel i writes tensor i, which kernel i + 1 reads.
+class TestCacheSomas : public Somas {
+ public:
+  explicit TestCacheSomas(const std::vector<size_t> &sizes) {
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      auto node = std::make_shared<SomasNode>("Default/Kernel-op" + std::to_string(i), i, kCommonNode, 0);
+      auto tensor = std::make_shared<SomasTensor>(i, i, 0, sizes[i], sizes[i]);
+      tensor->lifetime_ = Lifetime(i, i + 1);
+      tensor->type_ = kCommon;
+      tensor->contiguous_ = false;
+      node->output_tensors_.push_back(tensor);
+      if (i > 0) {
+        node->input_tensors_.push_back(tensors_list_.back());
+      }
+      nodes_list_.push_back(node);
+      tensors_list_.push_back(tensor);
+    }
+  }
+
+  // Place the tensors one after another, as a solver without reuse would.
+  void Place() {
+    reused_memory_size_ = 0;
+    for (const auto &tensor : tensors_list_) {
+      tensor->offset_ = reused_memory_size_;
+      reused_memory_size_ += tensor->aligned_size_;
+    }
+  }
+
+  void ClearOffsets() {
+    reused_memory_size_ = 0;
+    for (const auto &tensor : tensors_list_) {
+      tensor->offset_ = 0;
+    }
+  }
+
+  bool Load(const session::KernelGraph &graph) { return LoadSomasCache(graph); }
+  void Save(const session::KernelGraph &graph) {
+    (void)CalcSomasModelHash(graph);
+    SaveSomasResult(graph);
+  }
+  std::string CacheFile(const session::KernelGraph &graph) {
+    (void)CalcSomasModelHash(graph);
+    return GetSomasCacheFile(".json");
+  }
+  SomasTensorPtr Tensor(size_t id) const { return tensors_list_[id]; }
+  size_t ReusedMemorySize() const { return reused_memory_size_; }
+
+ private:
+  bool Initialize() override { return true; }
+  string GetDeviceName() const override { return "TestCache"; }
+  size_t GetAlignSize(size_t original_size) const override { return original_size; }
+  bool GetDependExecOrderFlag(const session::KernelGraph &) const override { return false; }
+  bool InitDevSpecControlTensors(const session::KernelGraph &) override { return true; }
+  bool DevSpecNodeProcess(const session::KernelGraph &) override { return true; }
+  bool NeedContiguous(const std::vector<size_t> &) const override { return false; }
+};
+}  // namespace
+
+class TestSomasCache : public UT::Common {
+ public:
+  TestSomasCache() = default;
+
+  void TearDown() override {
+    for (const auto &file : cache_files_) {
+      (void)rmdir(file.c_str());
+      (void)remove(file.c_str());
+    }
+  }
+
+ protected:
+  session::KernelGraph graph_;
+  std::vector<std::string> cache_files_;
+};
+
+/// Feature: Somas result cache.
+/// Description: Save the result of a model, then load it into a model built again with other scope names.
+/// Expectation: The fingerprint is the same, the cached offsets are loaded.
+TEST_F(TestSomasCache, test_cache_hit) {
+  std::vector<size_t> sizes{512, 1024, 256, 2048};
+  TestCacheSomas saved(sizes);
+  saved.Place();
+  saved.Save(graph_);
+  cache_files_.push_back(saved.CacheFile(graph_));
+
+  TestCacheSomas loaded(sizes);
+  ASSERT_EQ(loaded.CacheFile(graph_), saved.CacheFile(graph_));
+  ASSERT_TRUE(loaded.Load(graph_));
+  ASSERT_EQ(loaded.ReusedMemorySize(), saved.ReusedMemorySize());
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    ASSERT_EQ(loaded.Tensor(i)->GetOffset(), saved.Tensor(i)->GetOffset());
+  }
+}
+
+/// Feature: Somas result cache.
+/// Description: Change the size or the lifetime of one tensor after saving the result.
+/// Expectation: The fingerprint changes and the cache misses.
+TEST_F(TestSomasCache, test_cache_miss_on_model_change) {
+  std::vector<size_t> sizes{512, 1024, 256, 2048};
+  TestCacheSomas saved(sizes);
+  saved.Place();
+  saved.Save(graph_);
+  cache_files_.push_back(saved.CacheFile(graph_));
+
+  auto resized = sizes;
+  resized[2] = 512;
+  TestCacheSomas resized_somas(resized);
+  ASSERT_NE(resized_somas.CacheFile(graph_), saved.CacheFile(graph_));
+  ASSERT_FALSE(resized_somas.Load(graph_));
+
+  TestCacheSomas lifetime_somas(sizes);
+  lifetime_somas.Tensor(1)->lifetime_.end_ = 3;
+  ASSERT_NE(lifetime_somas.CacheFile(graph_), saved.CacheFile(graph_));
+  ASSERT_FALSE(lifetime_somas.Load(graph_));
+}
+
+/// Feature: Somas result cache.
+/// Description: Load a corrupt result, a result of another shape and a result path which can not be read.
+/// Expectation: Each one is a cache miss without an exception, so the model is solved again.
+TEST_F(TestSomasCache, test_corrupt_cache_falls_back) {
+  std::vector<size_t> sizes{512, 1024, 256};
+  TestCacheSomas somas(sizes);
+  somas.Place();
+  somas.Save(graph_);
+  auto cache_file = somas.CacheFile(graph_);
+  cache_files_.push_back(cache_file);
+  somas.ClearOffsets();
+  // The result is saved read only.
+  ASSERT_EQ(chmod(cache_file.c_str(), S_IRUSR | S_IWUSR), 0);
+
+  for (const auto &content : {std::string("{\"version\": 2, \"hash_id\": "), std::string("[1, 2, 3]"),
+                              std::string("{\"version\": 2, \"tensors\": \"none\"}")}) {
+    std::ofstream ofs(cache_file, std::ios::trunc);
+    ofs << content;
+    ofs.close();
+    ASSERT_FALSE(somas.Load(graph_));
+  }
+
+  ASSERT_EQ(remove(cache_file.c_str()), 0);
+  ASSERT_EQ(mkdir(cache_file.c_str(), S_IRWXU), 0);
+  ASSERT_FALSE(somas.Load(graph_));
+}
+}  // namespace mindspore::somas
@@ -14,7 +14,11 @@
  * limitations under the License.
  */
 
+#include <cstdio>
+#include <fstream>
 #include <random>
+#include <sstream>
+#include <thread>
 #include "common/common_test.h"
 #include "include/common/profiler.h"
 
@@ -126,5 +130,64 @@ TEST_F(TestProfiler, test_profiler) {
     }
   }
 }
+
+size_t CountSubString(const std::string &str, const std::string &sub) {
+  size_t count = 0;
+  for (auto pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + sub.size())) {
+    ++count;
+  }
+  return count;
+}
+
+/// Feature: test runtime trace.
+/// Description: record events from short-lived threads and flush after each thread exits.
+/// Expectation: all events and thread names are written to the trace file, the buffers of the exited threads are
+/// reused by the next threads.
+TEST_F(TestProfiler, test_runtime_trace) {
+  auto &tracer = RuntimeTracer::GetInstance();
+  ASSERT_FALSE(tracer.enable());
+  const std::string file_name = "./runtime_trace_test.json";
+  (void)std::remove(file_name.c_str());
+  constexpr size_t kFlushInterval = 1000;
+  tracer.Enable(file_name, kFlushInterval);
+  ASSERT_TRUE(tracer.enable());
+
+  const auto buffer_num = tracer.buffer_num();
+  constexpr size_t kThreadNum = 8;
+  constexpr size_t kEventNum = 100;
+  for (size_t i = 0; i < kThreadNum; ++i) {
+    std::thread trace_thread([&tracer, i]() {
+      tracer.SetThreadName("TraceThread" + std::to_string(i));
+      auto name_id = tracer.InternName("Default/network/op_test" + std::to_string(i % 2) + "-op1");
+      for (size_t j = 0; j < kEventNum; ++j) {
+        auto start_ticks = RuntimeTracer::GetTicks();
+        if (j % 2 == 0) {
+          tracer.Record(ProfilerModule::kKernel, ProfilerEvent::kKernelLaunch, name_id, start_ticks,
+                        RuntimeTracer::GetTicks());
+        } else {
+          tracer.RecordStage(ProfilerStage::kRunGraph, start_ticks, RuntimeTracer::GetTicks());
+        }
+      }
+    });
+    trace_thread.join();
+    tracer.Flush();
+  }
+  EXPECT_LE(tracer.buffer_num(), buffer_num + 1);
+  tracer.Disable();
+  ASSERT_FALSE(tracer.enable());
+
+  std::ifstream trace_file(file_name);
+  ASSERT_TRUE(trace_file.is_open());
+  std::stringstream content;
+  content << trace_file.rdbuf();
+  const auto trace = content.str();
+  EXPECT_EQ(kThreadNum * kEventNum, CountSubString(trace, "\"ph\":\"X\""));
+  EXPECT_EQ(kThreadNum * kEventNum / 2, CountSubString(trace, "Kernel::KernelLaunch::op_test"));
+  EXPECT_EQ(kThreadNum, CountSubString(trace, "\"name\":\"thread_name\""));
+  for (size_t i = 0; i < kThreadNum; ++i) {
+    EXPECT_NE(std::string::npos, trace.find("TraceThread" + std::to_string(i)));
+  }
+  (void)std::remove(file_name.c_str());
+}
 }  // namespace runtime
 }  // namespace mindspore
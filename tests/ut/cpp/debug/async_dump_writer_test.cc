@@ -0,0 +1,210 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "utils/convert_utils_base.h"
+#include "include/backend/debug/data_dump/async_dump_writer.h"
+#include "debug/data_dump/npy_header.h"
+
+namespace mindspore {
+namespace {
+constexpr auto kStatFileName = "statistic.csv";
+constexpr size_t kLz4FrameHeaderSize = 7;
+constexpr uint32_t kLz4UncompressedBlock = 0x80000000U;
+constexpr size_t kLz4MinMatch = 4;
+constexpr size_t kLz4LengthMask = 15;
+
+bool ReadLz4Length(const std::string &src, size_t *pos, size_t *length) {
+  constexpr uint8_t kLengthByteMax = 255;
+  uint8_t value = kLengthByteMax;
+  while (value == kLengthByteMax) {
+    if (*pos >= src.size()) {
+      return false;
+    }
+    value = static_cast<uint8_t>(src[(*pos)++]);
+    *length += value;
+  }
+  return true;
+}
+
+// Decode an independent lz4 block, the matches only refer to the output of the same block.
+bool DecodeLz4Block(const std::string &src, std::string *output) {
+  const size_t block_start = output->size();
+  size_t pos = 0;
+  while (pos < src.size()) {
+    auto token = static_cast<uint8_t>(src[pos++]);
+    size_t literal_len = token >> 4;
+    if (literal_len == kLz4LengthMask && !ReadLz4Length(src, &pos, &literal_len)) {
+      return false;
+    }
+    if (pos + literal_len > src.size()) {
+      return false;
+    }
+    (void)output->append(src, pos, literal_len);
+    pos += literal_len;
+    // The last sequence has literals only.
+    if (pos == src.size()) {
+      return true;
+    }
+    if (pos + 2 > src.size()) {
+      return false;
+    }
+    size_t offset = static_cast<uint8_t>(src[pos]) | (static_cast<size_t>(static_cast<uint8_t>(src[pos + 1])) << 8);
+    pos += 2;
+    size_t match_len = token & kLz4LengthMask;
+    if (match_len == kLz4LengthMask && !ReadLz4Length(src, &pos, &match_len)) {
+      return false;
+    }
+    match_len += kLz4MinMatch;
+    if (offset == 0 || offset > output->size() - block_start) {
+      return false;
+    }
+    // The match may overlap the bytes it produces.
+    size_t match_start = output->size() - offset;
+    for (size_t i = 0; i < match_len; ++i) {
+      output->push_back((*output)[match_start + i]);
+    }
+  }
+  return false;
+}
+
+// Decode a lz4 frame without checksums, the format written by AsyncDumpWriter::CompressLz4Frame.
+bool DecodeLz4Frame(const std::string &frame, std::string *output) {
+  const std::string lz4_magic("\x04\x22\x4d\x18", 4);
+  if (frame.size() < kLz4FrameHeaderSize || frame.compare(0, lz4_magic.size(), lz4_magic) != 0) {
+    return false;
+  }
+  size_t pos = kLz4FrameHeaderSize;
+  while (pos + sizeof(uint32_t) <= frame.size()) {
+    uint32_t block_size = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+      block_size |= static_cast<uint32_t>(static_cast<uint8_t>(frame[pos + i])) << (i * 8);
+    }
+    pos += sizeof(uint32_t);
+    // End mark.
+    if (block_size == 0) {
+      return pos == frame.size();
+    }
+    size_t size = block_size & ~kLz4UncompressedBlock;
+    if (pos + size > frame.size()) {
+      return false;
+    }
+    if ((block_size & kLz4UncompressedBlock) != 0) {
+      (void)output->append(frame, pos, size);
+    } else if (!DecodeLz4Block(frame.substr(pos, size), output)) {
+      return false;
+    }
+    pos += size;
+  }
+  return false;
+}
+}  // namespace
+
+class TestAsyncDumpWriter : public UT::Common {
+ public:
+  TestAsyncDumpWriter() = default;
+
+  void TearDown() override {
+    for (const auto &suffix : {".npy", ".npy.lz4"}) {
+      (void)remove((dump_dir_ + "/Add.add.0.0.1.output.0.DefaultFormat" + suffix).c_str());
+    }
+    (void)remove((dump_dir_ + "/" + kStatFileName).c_str());
+    (void)remove(dump_dir_.c_str());
+  }
+
+  std::string ReadFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+  }
+
+ protected:
+  std::string dump_dir_ = "/tmp/async_dump_writer_test";
+  std::string filename_ = dump_dir_ + "/Add.add.0.0.1.output.0.DefaultFormat";
+};
+
+/// Feature: Asynchronous e2e dump.
+/// Description: Submit a tensor, update it after Submit returns and wait for the writer.
+/// Expectation: The npy file holds the submitted values and statistic.csv records its statistics in the format of
+/// the synchronous dump.
+TEST_F(TestAsyncDumpWriter, test_write_npy_and_statistics) {
+  std::vector<float> data{1, -2, 0, 4, 5, 4};
+  AsyncDumpWriter writer(2, 1024, false);
+  writer.Submit(filename_, data.data(), data.size() * sizeof(float), ShapeVector{2, 3}, kNumberTypeFloat32);
+  data[0] = 100;
+  writer.Wait();
+  ASSERT_EQ(writer.degraded_count(), 0);
+
+  auto npy = ReadFile(filename_ + ".npy");
+  ASSERT_GT(npy.size(), data.size() * sizeof(float));
+  auto values = reinterpret_cast<const float *>(npy.data() + npy.size() - data.size() * sizeof(float));
+  ASSERT_EQ(values[0], 1);
+  ASSERT_EQ(values[5], 4);
+  auto stat = ReadFile(dump_dir_ + "/" + kStatFileName);
+  ASSERT_EQ(stat.find("Op Type,Op Name,Task ID,Stream ID,Timestamp,IO,Slot,Data Size,Data Type,Shape,"), 0);
+  ASSERT_NE(stat.find("\nAdd,add,0,0,1,output,0,24,float32,\"(2,3)\",5,-2,2,6,1,4,0,0,0,1,"), std::string::npos);
+}
+
+/// Feature: Asynchronous e2e dump.
+/// Description: Submit a parameter whose name has dots to a writer whose staging buffers can not hold it.
+/// Expectation: Only the statistics of the tensor are dumped, with the whole parameter name as the op name.
+TEST_F(TestAsyncDumpWriter, test_degrade_to_statistics) {
+  std::vector<int32_t> data(64, 3);
+  AsyncDumpWriter writer(1, 16, false);
+  writer.Submit(dump_dir_ + "/Parameter.conv1.weight.0.0.1.output.0.DefaultFormat", data.data(),
+                data.size() * sizeof(int32_t), ShapeVector{64}, kNumberTypeInt32);
+  writer.Wait();
+  ASSERT_EQ(writer.degraded_count(), 1);
+  std::ifstream npy(dump_dir_ + "/Parameter.conv1.weight.0.0.1.output.0.DefaultFormat.npy");
+  ASSERT_FALSE(npy.is_open());
+  auto stat = ReadFile(dump_dir_ + "/" + kStatFileName);
+  ASSERT_NE(stat.find("\nParameter,conv1.weight,0,0,1,output,0,256,int32,\"(64)\",3,3,3,64,0,64,0,0,0,0,"),
+            std::string::npos);
+}
+
+/// Feature: Asynchronous e2e dump.
+/// Description: Submit a tensor of more than one lz4 block, half repetitive and half random, to a writer with lz4
+/// compression.
+/// Expectation: The tensor is written as a lz4 frame smaller than the data, which decodes to the npy file.
+TEST_F(TestAsyncDumpWriter, test_lz4_compression) {
+  constexpr size_t kElementNum = 5 * 1024 * 1024 / sizeof(float);
+  std::vector<float> data(kElementNum);
+  std::mt19937 random(0);
+  std::uniform_real_distribution<float> distribution(-1, 1);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = (i < data.size() / 2 ? static_cast<float>(i % 16) : distribution(random));
+  }
+  const size_t data_size = data.size() * sizeof(float);
+  AsyncDumpWriter writer(1, 2 * data_size, true);
+  writer.Submit(filename_, data.data(), data_size, ShapeVector{SizeToLong(data.size())}, kNumberTypeFloat32);
+  writer.Wait();
+  auto frame = ReadFile(filename_ + ".npy.lz4");
+  ASSERT_LT(frame.size(), data_size * 3 / 4);
+  std::string decoded;
+  ASSERT_TRUE(DecodeLz4Frame(frame, &decoded));
+  auto npy_header = GenerateNpyHeader(ShapeVector{SizeToLong(data.size())}, kNumberTypeFloat32);
+  ASSERT_EQ(decoded.size(), npy_header.size() + data_size);
+  ASSERT_EQ(decoded.substr(0, npy_header.size()), npy_header);
+  ASSERT_EQ(memcmp(decoded.data() + npy_header.size(), data.data(), data_size), 0);
+}
+}  // namespace mindspore
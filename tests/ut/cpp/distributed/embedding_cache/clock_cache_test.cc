@@ -0,0 +1,97 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <list>
+
+#include "common/common_test.h"
+#include "distributed/embedding_cache/cache_strategy/clock_cache.h"
+
+namespace mindspore {
+namespace distributed {
+class TestClockCache : public UT::Common {
+ public:
+  TestClockCache() = default;
+  virtual ~TestClockCache() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+using Element = typename ClockCache<int, int>::Element;
+/// Feature: test clock cache all api.
+/// Description: test clock cache data structure and interface.
+/// Expectation: all interface work normally or throw expectant exception.
+TEST_F(TestClockCache, test_clock_cache) {
+  distributed::ClockCache<int, int> cache(5);
+  EXPECT_EQ(cache.capacity(), 5);
+  std::vector<Element> origin_elements = {{1, 11}, {2, 22}, {3, 33}};
+  for (const auto &item : origin_elements) {
+    EXPECT_NO_THROW(cache.Put(item.first, item.second));
+  }
+  EXPECT_TRUE(cache.Exists(1));
+  EXPECT_TRUE(cache.Exists(2));
+  EXPECT_TRUE(cache.Exists(3));
+  EXPECT_FALSE(cache.Exists(4));
+  EXPECT_EQ(origin_elements.size(), cache.size());
+  EXPECT_FALSE(cache.IsFull());
+  EXPECT_EQ(cache.Export().size(), origin_elements.size());
+  EXPECT_EQ((cache.Front()), (std::pair<int, int>(3, 33)));
+  EXPECT_EQ((cache.Back()), (std::pair<int, int>(1, 11)));
+
+  // The referenced elements get a second chance, so the unreferenced element 2 is evicted first.
+  int value = 0;
+  EXPECT_TRUE(cache.Get(1, &value));
+  EXPECT_EQ(value, 11);
+  EXPECT_TRUE(cache.Get(3, &value));
+  EXPECT_EQ(value, 33);
+  EXPECT_EQ((cache.Front()), (std::pair<int, int>(3, 33)));
+  EXPECT_EQ((cache.Back()), (std::pair<int, int>(2, 22)));
+  EXPECT_NO_THROW(cache.Put(4, 44));
+  EXPECT_NO_THROW(cache.Put(5, 55));
+  EXPECT_TRUE(cache.IsFull());
+  EXPECT_THROW(cache.Put(6, 66), std::runtime_error);
+
+  std::vector<Element> evict_elements;
+  EXPECT_NO_THROW(cache.TryEvict(2, &evict_elements));
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_EQ(evict_elements.size(), 2);
+  EXPECT_EQ((evict_elements[0]), (std::pair<int, int>(2, 22)));
+  EXPECT_EQ((evict_elements[1]), (std::pair<int, int>(4, 44)));
+  EXPECT_TRUE(cache.Exists(1));
+  EXPECT_TRUE(cache.Exists(3));
+  EXPECT_TRUE(cache.Exists(5));
+
+  // All reference bits have been cleared by the sweep, the next victim is the element after the clock hand.
+  EXPECT_NO_THROW(cache.Put(6, 66));
+  EXPECT_NO_THROW(cache.Put(1, 111));
+  EXPECT_TRUE(cache.Get(1, &value));
+  EXPECT_EQ(value, 111);
+  evict_elements.clear();
+  EXPECT_NO_THROW(cache.TryEvict(2, &evict_elements));
+  EXPECT_EQ(evict_elements.size(), 1);
+  EXPECT_EQ((evict_elements[0]), (std::pair<int, int>(5, 55)));
+
+  EXPECT_FALSE(cache.Get(7, &value));
+  EXPECT_EQ(cache.hit_count(), 3);
+  EXPECT_EQ(cache.miss_count(), 1);
+  EXPECT_DOUBLE_EQ(cache.hit_rate(), 0.75);
+  cache.ResetStatistics();
+  EXPECT_EQ(cache.hit_count(), 0);
+  EXPECT_THROW(cache.TryEvict(6, &evict_elements), std::runtime_error);
+}
+}  // namespace distributed
+}  // namespace mindspore
@@ -0,0 +1,106 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <vector>
+
+#include "common/common_test.h"
+#include "include/backend/distributed/embedding_cache/embedding_cache_utils.h"
+#include "include/backend/distributed/embedding_cache/embedding_hash_map.h"
+
+namespace mindspore {
+namespace distributed {
+class TestEmbeddingCachePrefetch : public UT::Common {
+ public:
+  TestEmbeddingCachePrefetch() = default;
+  virtual ~TestEmbeddingCachePrefetch() = default;
+
+  void SetUp() override { (void)unsetenv(kEnvEmbeddingCachePrefetchSteps); }
+  void TearDown() override { (void)unsetenv(kEnvEmbeddingCachePrefetchSteps); }
+};
+
+/// Feature: configurable lookahead steps of embedding cache prefetch.
+/// Description: get the lookahead step number without the environment variable.
+/// Expectation: a single worker prefetches kMultiBatchThreshold steps once and multiple workers one step, as before.
+TEST_F(TestEmbeddingCachePrefetch, test_default_prefetch_steps) {
+  EXPECT_EQ(kMultiBatchThreshold, GetMultiBatchThreshold(1));
+  EXPECT_EQ(1, GetMultiBatchThreshold(2));
+}
+
+/// Feature: configurable lookahead steps of embedding cache prefetch.
+/// Description: set the lookahead step number to valid and invalid values.
+/// Expectation: a single worker uses the valid value, multiple workers ignore it and the invalid values throw.
+TEST_F(TestEmbeddingCachePrefetch, test_configured_prefetch_steps) {
+  (void)setenv(kEnvEmbeddingCachePrefetchSteps, "4", 1);
+  EXPECT_EQ(4, GetMultiBatchThreshold(1));
+  EXPECT_EQ(1, GetMultiBatchThreshold(2));
+
+  (void)setenv(kEnvEmbeddingCachePrefetchSteps, "1024", 1);
+  EXPECT_EQ(kMaxMultiBatchThreshold, GetMultiBatchThreshold(1));
+
+  for (const char *invalid_steps : {"0", "1025", "steps"}) {
+    (void)setenv(kEnvEmbeddingCachePrefetchSteps, invalid_steps, 1);
+    EXPECT_ANY_THROW(GetMultiBatchThreshold(1));
+  }
+}
+
+/// Feature: prefetch the embedding cache of several steps ahead of the graph.
+/// Description: insert the missing ids of three prefetched steps into a hash map holding four ids, while the graph
+/// runs the first step and then the second one.
+/// Expectation: the missing ids take the free slots in order, then evict the ids of the steps the graph has run in
+/// the order they were inserted, and the ids of the steps not run yet are never evicted.
+TEST_F(TestEmbeddingCachePrefetch, test_cache_miss_order_with_prefetch_steps) {
+  // Two slots are reserved for the out of range ids, four are left.
+  EmbeddingHashMap hash_map(6);
+  std::vector<int> swap_out_index(4);
+  std::vector<int> swap_out_ids(4);
+  size_t swap_out_size = 0;
+  bool need_wait_graph = false;
+  auto parse = [&](int id, size_t data_step, size_t graph_running_step) {
+    return hash_map.ParseData(id, swap_out_index.data(), swap_out_ids.data(), data_step, graph_running_step,
+                              &swap_out_size, &need_wait_graph);
+  };
+
+  // The steps 1 and 2 are prefetched while the graph runs the step 1.
+  EXPECT_EQ(1, parse(10, 1, 1));
+  EXPECT_EQ(2, parse(11, 1, 1));
+  EXPECT_EQ(3, parse(12, 2, 1));
+  EXPECT_EQ(4, parse(13, 2, 1));
+  EXPECT_EQ(0, swap_out_size);
+
+  // The step 3 waits for the graph, all the cached ids are used by the steps not run yet.
+  EXPECT_EQ(kInvalidIndexValue, parse(14, 3, 1));
+  EXPECT_EQ(0, swap_out_size);
+
+  // After the graph runs the step 1, the ids of the step 1 are swapped out in order.
+  EXPECT_EQ(1, parse(14, 3, 2));
+  EXPECT_EQ(2, parse(15, 3, 2));
+  ASSERT_EQ(2, swap_out_size);
+  EXPECT_EQ(1, swap_out_index[0]);
+  EXPECT_EQ(10, swap_out_ids[0]);
+  EXPECT_EQ(2, swap_out_index[1]);
+  EXPECT_EQ(11, swap_out_ids[1]);
+
+  // The ids of the step 2 are still pinned.
+  EXPECT_EQ(kInvalidIndexValue, parse(16, 3, 2));
+  EXPECT_EQ(2, swap_out_size);
+  int index = kInvalidIndexValue;
+  EXPECT_TRUE(hash_map.GetIndex(12, &index));
+  EXPECT_EQ(3, index);
+  EXPECT_FALSE(hash_map.GetIndex(10, &index));
+}
+}  // namespace distributed
+}  // namespace mindspore
@@ -0,0 +1,212 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/common_test.h"
+#include "distributed/embedding_cache/cache_strategy/lru_cache.h"
+#include "distributed/embedding_cache/cache_strategy/clock_cache.h"
+#include "distributed/embedding_cache/cache_strategy/w_tinylfu_cache.h"
+#include "utils/ms_utils.h"
+
+namespace mindspore {
+namespace distributed {
+namespace {
+// The environment variable used to set a recorded id trace file to replay, the file holds the ids of embedding lookup
+// separated by white spaces.
+constexpr auto kEnvEmbeddingCacheTraceFile = "MS_EMBEDDING_CACHE_TRACE_FILE";
+constexpr size_t kReplayBatchSize = 1024;
+}  // namespace
+
+class TestWTinyLFUCache : public UT::Common {
+ public:
+  TestWTinyLFUCache() = default;
+  virtual ~TestWTinyLFUCache() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+
+  // Generate ids following the zipfian distribution over [0, id_num), interleaved with scans of cold ids which are
+  // never accessed again.
+  std::vector<int64_t> GenerateTrace(size_t id_num, size_t access_num, double skew, size_t scan_interval,
+                                     size_t scan_len) {
+    std::vector<double> cdf(id_num);
+    double sum = 0;
+    for (size_t i = 0; i < id_num; ++i) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+      cdf[i] = sum;
+    }
+    std::mt19937_64 engine(0);
+    std::uniform_real_distribution<double> distribution(0, sum);
+    std::vector<int64_t> trace;
+    int64_t cold_id = static_cast<int64_t>(id_num);
+    for (size_t i = 0; i < access_num; ++i) {
+      if (scan_interval != 0 && i % scan_interval == 0) {
+        for (size_t j = 0; j < scan_len; ++j) {
+          trace.push_back(cold_id++);
+        }
+      }
+      auto iter = std::lower_bound(cdf.begin(), cdf.end(), distribution(engine));
+      trace.push_back(std::min<int64_t>(iter - cdf.begin(), static_cast<int64_t>(id_num - 1)));
+    }
+    return trace;
+  }
+
+  // Replay the trace in batches the same way as the embedding storage: query all unique keys of a batch, reserve space
+  // for the missing keys and insert them. Return the hit rate.
+  double Replay(Cache<int64_t, int> *cache, const std::vector<int64_t> &trace, const std::string &name) {
+    MS_EXCEPTION_IF_NULL(cache);
+    std::vector<int64_t> miss_keys;
+    std::vector<Cache<int64_t, int>::Element> evicted_elements;
+    std::unordered_set<int64_t> batch_keys;
+    int value = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t begin = 0; begin < trace.size(); begin += kReplayBatchSize) {
+      size_t end = std::min(begin + kReplayBatchSize, trace.size());
+      batch_keys.clear();
+      miss_keys.clear();
+      for (size_t i = begin; i < end; ++i) {
+        if (!batch_keys.insert(trace[i]).second) {
+          continue;
+        }
+        if (!cache->Get(trace[i], &value)) {
+          miss_keys.push_back(trace[i]);
+        }
+      }
+      evicted_elements.clear();
+      cache->TryEvict(miss_keys.size(), &evicted_elements);
+      for (const auto &key : miss_keys) {
+        cache->Put(key, 0);
+      }
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    MS_LOG(WARNING) << name << " cache replays " << trace.size() << " ids, hit rate: " << cache->hit_rate()
+                    << ", cost: " << cost.count() << "us";
+    return cache->hit_rate();
+  }
+};
+
+using Element = typename WTinyLFUCache<int, int>::Element;
+/// Feature: test w-tinylfu cache all api.
+/// Description: test w-tinylfu cache data structure, frequency sketch and admission.
+/// Expectation: all interface work normally or throw expectant exception.
+TEST_F(TestWTinyLFUCache, test_w_tinylfu_cache) {
+  FrequencySketch<int> sketch(16);
+  for (size_t i = 0; i < 20; ++i) {
+    sketch.Increment(1);
+  }
+  sketch.Increment(2);
+  EXPECT_EQ(sketch.Frequency(1), 15);
+  EXPECT_GE(sketch.Frequency(2), 1);
+  sketch.Reset();
+  EXPECT_EQ(sketch.Frequency(1), 7);
+
+  // One slot for window cache and nine slots for main cache, the window cache holds all new elements until TryEvict.
+  distributed::WTinyLFUCache<int, int> cache(10, 0.1);
+  EXPECT_EQ(cache.capacity(), 10);
+  int value = 0;
+  for (int key = 0; key < 10; ++key) {
+    EXPECT_FALSE(cache.Get(key, &value));
+    EXPECT_NO_THROW(cache.Put(key, key * 10));
+  }
+  EXPECT_TRUE(cache.IsFull());
+  EXPECT_EQ(cache.Export().size(), 10);
+  EXPECT_EQ((cache.Front()), (std::pair<int, int>(9, 90)));
+  EXPECT_THROW(cache.Put(10, 100), std::runtime_error);
+
+  // Make keys [0, 8) hot, the main cache keeps 8 elements when one slot is reserved in each TryEvict.
+  for (int round = 0; round < 3; ++round) {
+    for (int key = 0; key < 8; ++key) {
+      EXPECT_TRUE(cache.Get(key, &value));
+      EXPECT_EQ(value, key * 10);
+    }
+  }
+
+  // A scan of cold keys only passes through the window cache.
+  std::vector<Element> evict_elements;
+  for (int key = 100; key < 110; ++key) {
+    EXPECT_FALSE(cache.Get(key, &value));
+    cache.TryEvict(1, &evict_elements);
+    cache.Put(key, key * 10);
+  }
+  EXPECT_EQ(evict_elements.size(), 10);
+  for (int key = 0; key < 8; ++key) {
+    EXPECT_TRUE(cache.Exists(key));
+  }
+  EXPECT_TRUE(cache.Exists(109));
+
+  // A key accessed more frequently than the main victim is admitted.
+  for (int round = 0; round < 8; ++round) {
+    EXPECT_FALSE(cache.Get(200, &value));
+  }
+  evict_elements.clear();
+  cache.TryEvict(1, &evict_elements);
+  cache.Put(200, 2000);
+  evict_elements.clear();
+  cache.TryEvict(1, &evict_elements);
+  cache.Put(201, 2010);
+  EXPECT_TRUE(cache.Exists(200));
+  EXPECT_TRUE(cache.Get(200, &value));
+  EXPECT_EQ(value, 2000);
+  EXPECT_EQ(cache.size(), 10);
+
+  evict_elements.clear();
+  EXPECT_NO_THROW(cache.TryEvict(10, &evict_elements));
+  EXPECT_EQ(evict_elements.size(), 10);
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_THROW(cache.TryEvict(11, &evict_elements), std::runtime_error);
+}
+
+/// Feature: test cache strategies on id trace.
+/// Description: replay a recorded id trace or a zipfian id trace with cold scans over lru, clock and w-tinylfu cache.
+/// Expectation: w-tinylfu cache gets a higher hit rate than lru cache on the zipfian trace.
+TEST_F(TestWTinyLFUCache, test_replay_id_trace) {
+  std::vector<int64_t> trace;
+  std::string trace_file = common::GetEnv(kEnvEmbeddingCacheTraceFile);
+  if (!trace_file.empty()) {
+    std::ifstream ifs(trace_file);
+    ASSERT_TRUE(ifs.good());
+    int64_t id = 0;
+    while (ifs >> id) {
+      trace.push_back(id);
+    }
+  } else {
+    trace = GenerateTrace(100000, 500000, 0.9, 50000, 20000);
+  }
+  ASSERT_FALSE(trace.empty());
+
+  const size_t capacity = 5000;
+  LRUCache<int64_t, int> lru_cache(capacity);
+  ClockCache<int64_t, int> clock_cache(capacity);
+  WTinyLFUCache<int64_t, int> w_tinylfu_cache(capacity);
+  double lru_hit_rate = Replay(&lru_cache, trace, "LRU");
+  double clock_hit_rate = Replay(&clock_cache, trace, "CLOCK");
+  double w_tinylfu_hit_rate = Replay(&w_tinylfu_cache, trace, "W-TinyLFU");
+  if (trace_file.empty()) {
+    EXPECT_GT(clock_hit_rate, lru_hit_rate);
+    EXPECT_GT(w_tinylfu_hit_rate, lru_hit_rate);
+  }
+}
+}  // namespace distributed
+}  // namespace mindspore
@@ -0,0 +1,219 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "include/backend/distributed/rpc/tcp/tcp_server.h"
+#include "include/backend/distributed/rpc/tcp/tcp_client.h"
+#include "include/backend/distributed/rpc/tcp/buffer_pool.h"
+#include "include/backend/distributed/rpc/tcp/constants.h"
+#include "common/common_test.h"
+
+namespace mindspore {
+namespace distributed {
+namespace rpc {
+namespace {
+constexpr size_t kMinBenchMsgSize = 4UL << 10;
+constexpr size_t kMaxBenchMsgSize = 64UL << 20;
+// Every message size sends at most this many bytes in each round, and at least kMinBenchMsgNum messages.
+constexpr size_t kBenchBytesPerRound = 256UL << 20;
+constexpr size_t kMinBenchMsgNum = 4;
+constexpr size_t kMaxBenchMsgNum = 256;
+constexpr int kBenchTimeoutInSec = 60;
+}  // namespace
+
+class TCPBandwidthTest : public UT::Common {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+
+  std::unique_ptr<MessageBase> CreateMessage(const std::string &server_url, void *data, size_t msg_size) {
+    std::unique_ptr<MessageBase> message = std::make_unique<MessageBase>();
+    message->name = "bandwidth";
+    message->from = AID("client", "");
+    message->to = AID("server", server_url);
+    message->data = data;
+    message->size = msg_size;
+    return message;
+  }
+
+  bool WaitForRecvNum(size_t expected_num) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(kBenchTimeoutInSec);
+    while (recv_num_ < expected_num) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  // Send messages of 4KB to 64MB from the tensor like buffer without copying it into the message, the server receives
+  // them into the buffers of a message buffer pool. Report the bandwidth of pipelined messages and the p99 latency of
+  // one message at a time.
+  void RunLoopbackBenchmark() {
+    auto pool = std::make_shared<MessageBufferPool>();
+    std::unique_ptr<TCPServer> server = std::make_unique<TCPServer>();
+    server->SetMessageBufferPool(pool);
+    ASSERT_TRUE(server->Initialize());
+    recv_num_ = 0;
+    corrupted_num_ = 0;
+    server->SetMessageHandler([this](MessageBase *const message) -> MessageBase *const {
+      auto data = static_cast<const char *>(message->data);
+      if (message->size == 0 || data[0] != 'A' || data[message->size - 1] != 'A') {
+        ++corrupted_num_;
+      }
+      // Deleting the pooled message returns its body buffer to the pool.
+      delete message;
+      ++recv_num_;
+      return NULL_MSG;
+    });
+
+    std::unique_ptr<TCPClient> client = std::make_unique<TCPClient>();
+    ASSERT_TRUE(client->Initialize());
+    auto server_url = server->GetIP() + ":" + std::to_string(server->GetPort());
+    // The buffer is owned by the test, the connection only notifies that it is no longer used.
+    std::atomic<size_t> released_num(0);
+    ASSERT_TRUE(client->Connect(server_url, 1, [&released_num](void *) {
+      ++released_num;
+      return true;
+    }));
+
+    std::vector<char> buffer(kMaxBenchMsgSize, 'A');
+    size_t total_msg_num = 0;
+    for (size_t msg_size = kMinBenchMsgSize; msg_size <= kMaxBenchMsgSize; msg_size *= 4) {
+      size_t msg_num = std::min(kMaxBenchMsgNum, std::max(kMinBenchMsgNum, kBenchBytesPerRound / msg_size));
+      total_msg_num += 2 * msg_num;
+
+      // Latency: send the next message after the previous one is received.
+      recv_num_ = 0;
+      std::vector<double> latencies;
+      for (size_t i = 0; i < msg_num; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        client->SendAsync(CreateMessage(server_url, buffer.data(), msg_size));
+        ASSERT_TRUE(WaitForRecvNum(i + 1));
+        auto latency = std::chrono::steady_clock::now() - start;
+        latencies.push_back(std::chrono::duration<double, std::micro>(latency).count());
+      }
+
+      // Bandwidth: send all the messages without waiting.
+      recv_num_ = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < msg_num; ++i) {
+        client->SendAsync(CreateMessage(server_url, buffer.data(), msg_size));
+      }
+      ASSERT_TRUE(WaitForRecvNum(msg_num));
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      std::sort(latencies.begin(), latencies.end());
+      const size_t percentile = 99;
+      const size_t percent = 100;
+      double p99 = latencies[std::min(latencies.size() - 1, latencies.size() * percentile / percent)];
+      const double giga = 1e9;
+      MS_LOG(WARNING) << "Message size: " << msg_size << ", bandwidth: " << msg_num * msg_size / seconds / giga
+                      << " GB/s, p99 latency: " << p99 << " us, zero copy: " << common::GetEnv(kEnvEnableRpcZeroCopy);
+    }
+    EXPECT_EQ(0, corrupted_num_);
+
+    // The messages sent with MSG_ZEROCOPY are released after the kernel notifies the completion.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(kBenchTimeoutInSec);
+    while (released_num < total_msg_num && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(total_msg_num, released_num);
+
+    client->Disconnect(server_url);
+    client->Finalize();
+    server->Finalize();
+  }
+
+  std::atomic<size_t> recv_num_{0};
+  std::atomic<size_t> corrupted_num_{0};
+};
+
+/// Feature: message buffer pool for the tcp server.
+/// Description: allocate and free buffers of different sizes.
+/// Expectation: the freed buffer is reused by the allocation in the same size class and the cache size is limited.
+TEST_F(TCPBandwidthTest, BufferPoolReuse) {
+  const size_t max_cached_size = 64UL << 10;
+  MessageBufferPool pool(max_cached_size);
+  void *small = pool.Allocate(3000);
+  ASSERT_NE(small, nullptr);
+  EXPECT_TRUE(pool.Free(small));
+  EXPECT_EQ(4096, pool.cached_size());
+  EXPECT_EQ(small, pool.Allocate(4096));
+  EXPECT_EQ(0, pool.cached_size());
+
+  void *large = pool.Allocate(max_cached_size + 1);
+  ASSERT_NE(large, nullptr);
+  EXPECT_TRUE(pool.Free(large));
+  EXPECT_EQ(0, pool.cached_size());
+
+  int not_pooled = 0;
+  EXPECT_FALSE(pool.Free(&not_pooled));
+  EXPECT_TRUE(pool.Free(small));
+}
+
+/// Feature: message buffer pool for the tcp server.
+/// Description: create pooled messages, delete one and take the buffer out of the other.
+/// Expectation: deleting the message returns its buffer to the pool, the released buffer is freed by the caller.
+TEST_F(TCPBandwidthTest, PooledMessageReturnsBuffer) {
+  auto pool = std::make_shared<MessageBufferPool>();
+  MessageBase *message = new PooledMessage(pool, 5000);
+  ASSERT_NE(message->data, nullptr);
+  EXPECT_EQ(5000, message->size);
+  void *buffer = message->data;
+  delete message;
+  EXPECT_EQ(8192, pool->cached_size());
+
+  auto pooled = std::make_unique<PooledMessage>(pool, 8000);
+  EXPECT_EQ(buffer, pooled->data);
+  EXPECT_EQ(0, pool->cached_size());
+  void *released = pooled->ReleaseData();
+  pooled.reset();
+  EXPECT_EQ(0, pool->cached_size());
+  EXPECT_TRUE(pool->Free(released));
+  EXPECT_EQ(8192, pool->cached_size());
+}
+
+/// Feature: batched scatter gather sending on the tcp connection.
+/// Description: send 4KB to 64MB messages over the loopback and receive them into pooled buffers.
+/// Expectation: all the messages are received intact, the bandwidth and p99 latency are reported.
+TEST_F(TCPBandwidthTest, LoopbackBandwidth) {
+  (void)unsetenv(kEnvEnableRpcZeroCopy);
+  RunLoopbackBenchmark();
+}
+
+/// Feature: MSG_ZEROCOPY sending on the tcp connection.
+/// Description: send 4KB to 64MB messages over the loopback with zero copy enabled.
+/// Expectation: all the messages are received intact and the large bodies are released after completion.
+TEST_F(TCPBandwidthTest, LoopbackBandwidthZeroCopy) {
+  (void)setenv(kEnvEnableRpcZeroCopy, "1", 1);
+  RunLoopbackBenchmark();
+  (void)unsetenv(kEnvEnableRpcZeroCopy);
+}
+}  // namespace rpc
+}  // namespace distributed
+}  // namespace mindspore
@@ -15,11 +15,18 @@
  */
 
 #include <sys/resource.h>
+#include <sys/socket.h>
 #include <sys/types.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
 #include <dirent.h>
 #include <atomic>
+#include <cstdlib>
+#include <set>
 #include <string>
 #include <thread>
+#include <vector>
 #include <csignal>
 
 #include <gtest/gtest.h>
@@ -27,6 +34,8 @@
 #include "include/backend/distributed/rpc/tcp/tcp_server.h"
 #include "include/backend/distributed/rpc/tcp/tcp_client.h"
 #include "include/backend/distributed/rpc/tcp/constants.h"
+#include "distributed/rpc/tcp/tcp_comm.h"
+#include "distributed/rpc/tcp/socket_operation.h"
 #include "common/common_test.h"
 
 namespace mindspore {
@@ -335,6 +344,118 @@ TEST_F(TCPTest, SendLargeMessages) {
   server->Finalize();
 }
 
+/// Feature: test receiving messages on sharded event loops.
+/// Description: start a socket server with 4 receiving event loops and send messages to it from 8 tcp clients.
+/// Expectation: all the messages are received.
+TEST_F(TCPTest, ShardedRecvEventLoops) {
+  (void)setenv(kEnvRpcRecvEventLoopNum, "4", 1);
+  std::unique_ptr<TCPServer> server = std::make_unique<TCPServer>();
+  bool ret = server->Initialize();
+  (void)unsetenv(kEnvRpcRecvEventLoopNum);
+  ASSERT_TRUE(ret);
+
+  std::atomic<size_t> recv_num(0);
+  server->SetMessageHandler([&](MessageBase *const message) -> MessageBase *const {
+    ++recv_num;
+    return NULL_MSG;
+  });
+
+  auto client_url = "127.0.0.1:1234";
+  auto server_url = server->GetIP() + ":" + std::to_string(server->GetPort());
+  const size_t client_num = 8;
+  const size_t msg_num = 16;
+  std::vector<std::unique_ptr<TCPClient>> clients;
+  for (size_t i = 0; i < client_num; ++i) {
+    clients.push_back(std::make_unique<TCPClient>());
+    ASSERT_TRUE(clients.back()->Initialize());
+    ASSERT_TRUE(clients.back()->Connect(server_url));
+  }
+  for (size_t i = 0; i < msg_num; ++i) {
+    for (auto &client : clients) {
+      client->SendAsync(CreateMessage(server_url, client_url));
+    }
+  }
+
+  // Wait timeout: 10s
+  int timeout_in_ms = 10000;
+  const int sleep_in_ms = 10;
+  while (recv_num < client_num * msg_num && timeout_in_ms > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_in_ms));
+    timeout_in_ms -= sleep_in_ms;
+  }
+  EXPECT_EQ(client_num * msg_num, recv_num);
+
+  // Destroy
+  for (auto &client : clients) {
+    client->Disconnect(server_url);
+    client->Finalize();
+  }
+  server->Finalize();
+}
+
+/// Feature: test assigning the connections to the sharded receiving event loops.
+/// Description: hash fixed peers to 4 and 5 loops, then connect 16 sockets to a server with 4 loops.
+/// Expectation: the peers spread over all the loops and only move to the added loop, every accepted connection is
+/// handled by the loop selected for its peer.
+TEST_F(TCPTest, RecvEventLoopAssignment) {
+  const size_t loop_num = 4;
+  (void)setenv(kEnvRpcRecvEventLoopNum, std::to_string(loop_num).c_str(), 1);
+  TCPComm server;
+  bool ret = server.Initialize();
+  (void)setenv(kEnvRpcRecvEventLoopNum, std::to_string(loop_num + 1).c_str(), 1);
+  TCPComm grown_server;
+  ret = grown_server.Initialize() && ret;
+  (void)unsetenv(kEnvRpcRecvEventLoopNum);
+  ASSERT_TRUE(ret);
+
+  std::set<size_t> used_loops;
+  for (size_t port = 10000; port < 10064; ++port) {
+    auto peer = "127.0.0.1:" + std::to_string(port);
+    size_t loop_index = server.SelectRecvEventLoop(peer);
+    ASSERT_LT(loop_index, loop_num);
+    (void)used_loops.insert(loop_index);
+    size_t grown_loop_index = grown_server.SelectRecvEventLoop(peer);
+    EXPECT_TRUE(grown_loop_index == loop_index || grown_loop_index == loop_num);
+  }
+  EXPECT_EQ(loop_num, used_loops.size());
+  grown_server.Finalize();
+
+  ASSERT_EQ(0, server.StartServerSocket("127.0.0.1:0", {}));
+  struct sockaddr_in server_addr = {};
+  server_addr.sin_family = AF_INET;
+  server_addr.sin_port = htons(SocketOperation::GetPort(server.GetServerFd()));
+  server_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+  std::vector<int> client_fds;
+  std::vector<std::string> peers;
+  for (size_t i = 0; i < 16; ++i) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_LE(0, fd);
+    client_fds.push_back(fd);
+    ASSERT_EQ(0, connect(fd, reinterpret_cast<struct sockaddr *>(&server_addr), sizeof(server_addr)));
+    struct sockaddr_in local_addr = {};
+    socklen_t addr_len = sizeof(local_addr);
+    ASSERT_EQ(0, getsockname(fd, reinterpret_cast<struct sockaddr *>(&local_addr), &addr_len));
+    peers.push_back("127.0.0.1:" + std::to_string(ntohs(local_addr.sin_port)));
+  }
+
+  for (const auto &peer : peers) {
+    // Wait timeout: 10s
+    int timeout_in_ms = 10000;
+    const int sleep_in_ms = 10;
+    while (server.GetRecvEventLoopIndex(peer) < 0 && timeout_in_ms > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(sleep_in_ms));
+      timeout_in_ms -= sleep_in_ms;
+    }
+    EXPECT_EQ(static_cast<int>(server.SelectRecvEventLoop(peer)), server.GetRecvEventLoopIndex(peer));
+  }
+
+  // Destroy
+  for (int fd : client_fds) {
+    (void)close(fd);
+  }
+  server.Finalize();
+}
+
 /// Feature: test delete invalid tcp connection used in connection pool in tcp client when some socket error happened.
 /// Description: start a socket server and tcp client pair and stop the tcp server.
 /// Expectation: the connection from the tcp client to the tcp server will be deleted automatically.
@@ -13,7 +13,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <vector>
 #include <string>
@@ -23,6 +25,7 @@
 
 #include "securec/include/securec.h"
 #include "ir/tensor.h"
+#include "actor/actormgr.h"
 #include "pybind_api/ir/tensor_py.h"
 
 using mindspore::tensor::TensorPy;
@@ -467,6 +470,129 @@ TEST_F(TestTensor, TensorOffloadTest) {
   }
 }
 
+/// Feature: Tensor dtype conversion
+/// Description: Create float16 and bfloat16 tensors from a float32 buffer large enough to be converted in chunks.
+/// Expectation: Every element equals the scalar conversion, also for the tail after the vectorized blocks.
+TEST_F(TestTensor, TensorConvertFloat16Test) {
+  const int64_t kElemNum = (1 << 20) + 3;
+  std::vector<float> data(kElemNum);
+  for (int64_t i = 0; i < kElemNum; ++i) {
+    data[i] = static_cast<float>(i % 2001 - 1000) * 0.37f;
+  }
+  data[1] = std::numeric_limits<float>::quiet_NaN();
+  data[kElemNum - 1] = std::numeric_limits<float>::infinity();
+  Tensor fp16_tensor(kNumberTypeFloat16, {kElemNum}, data.data(), kNumberTypeFloat32);
+  Tensor bf16_tensor(kNumberTypeBFloat16, {kElemNum}, data.data(), kNumberTypeFloat32);
+  auto fp16_data = static_cast<float16 *>(fp16_tensor.data_c());
+  auto bf16_data = static_cast<bfloat16 *>(bf16_tensor.data_c());
+  for (int64_t i = 0; i < kElemNum; ++i) {
+    ASSERT_EQ(fp16_data[i].int_value(), static_cast<float16>(data[i]).int_value());
+    ASSERT_EQ(bf16_data[i].int_value(), static_cast<bfloat16>(data[i]).int_value());
+  }
+
+  Tensor fp32_tensor(kNumberTypeFloat32, {kElemNum}, fp16_data, kNumberTypeFloat16);
+  auto fp32_data = static_cast<float *>(fp32_tensor.data_c());
+  for (int64_t i = 2; i < kElemNum; ++i) {
+    ASSERT_EQ(fp32_data[i], static_cast<float>(fp16_data[i]));
+  }
+  ASSERT_TRUE(std::isnan(fp32_data[1]));
+}
+
+/// Feature: Tensor dtype conversion
+/// Description: Convert NaNs with payloads, negative NaNs and signaling NaNs between float32 and the 16-bit types,
+/// with enough elements to go through the vectorized blocks and the scalar tail.
+/// Expectation: The bits of every element equal the scalar conversion.
+TEST_F(TestTensor, TensorConvertNaNTest) {
+  const std::vector<uint32_t> nan_bits = {0x7fc00000, 0xffc00000, 0x7fc00001, 0xffc12345, 0x7f800001,
+                                          0xff800001, 0x7fffffff, 0xffffffff, 0x7fa00000, 0xff801000};
+  const int64_t kElemNum = 37;
+  std::vector<float> data(kElemNum);
+  for (int64_t i = 0; i < kElemNum; ++i) {
+    if (i % 3 == 0) {
+      (void)memcpy_s(&data[i], sizeof(float), &nan_bits[i % nan_bits.size()], sizeof(uint32_t));
+    } else {
+      data[i] = static_cast<float>(i) * -1.25f;
+    }
+  }
+  Tensor fp16_tensor(kNumberTypeFloat16, {kElemNum}, data.data(), kNumberTypeFloat32);
+  Tensor bf16_tensor(kNumberTypeBFloat16, {kElemNum}, data.data(), kNumberTypeFloat32);
+  auto fp16_data = static_cast<float16 *>(fp16_tensor.data_c());
+  auto bf16_data = static_cast<bfloat16 *>(bf16_tensor.data_c());
+  for (int64_t i = 0; i < kElemNum; ++i) {
+    ASSERT_EQ(fp16_data[i].int_value(), static_cast<float16>(data[i]).int_value());
+    ASSERT_EQ(bf16_data[i].int_value(), static_cast<bfloat16>(data[i]).int_value());
+  }
+
+  const std::vector<uint16_t> half_nan_bits = {0x7e00, 0xfe00, 0x7c01, 0xfc01, 0x7d55, 0xfe01, 0x7fff, 0xffff};
+  std::vector<float16> half_data(kElemNum);
+  for (int64_t i = 0; i < kElemNum; ++i) {
+    half_data[i] = i % 2 == 0 ? float16::FromRaw(half_nan_bits[i % half_nan_bits.size()])
+                              : static_cast<float16>(static_cast<float>(i) * 0.5f);
+  }
+  Tensor fp32_tensor(kNumberTypeFloat32, {kElemNum}, half_data.data(), kNumberTypeFloat16);
+  auto fp32_data = static_cast<float *>(fp32_tensor.data_c());
+  for (int64_t i = 0; i < kElemNum; ++i) {
+    uint32_t actual = 0;
+    uint32_t expect = 0;
+    float expect_value = static_cast<float>(half_data[i]);
+    (void)memcpy_s(&actual, sizeof(actual), &fp32_data[i], sizeof(float));
+    (void)memcpy_s(&expect, sizeof(expect), &expect_value, sizeof(float));
+    ASSERT_EQ(actual, expect);
+  }
+}
+
+/// Feature: Tensor dtype conversion
+/// Description: Convert positive and negative float32 denormals, the largest and smallest ones included, to the
+/// 16-bit types, with enough elements to go through the vectorized blocks and the scalar tail.
+/// Expectation: The bits of every element equal the scalar conversion, denormals are not flushed to zero.
+TEST_F(TestTensor, TensorConvertDenormalTest) {
+  const std::vector<uint32_t> denormal_bits = {0x00000001, 0x80000001, 0x007fffff, 0x807fffff, 0x00008000,
+                                               0x00018000, 0x0000ffff, 0x80010000, 0x00400000, 0x007f8000};
+  const int64_t kElemNum = 37;
+  std::vector<float> data(kElemNum);
+  for (int64_t i = 0; i < kElemNum; ++i) {
+    if (i % 4 == 3) {
+      data[i] = static_cast<float>(i) * 0.75f;
+    } else {
+      (void)memcpy_s(&data[i], sizeof(float), &denormal_bits[i % denormal_bits.size()], sizeof(uint32_t));
+    }
+  }
+  Tensor fp16_tensor(kNumberTypeFloat16, {kElemNum}, data.data(), kNumberTypeFloat32);
+  Tensor bf16_tensor(kNumberTypeBFloat16, {kElemNum}, data.data(), kNumberTypeFloat32);
+  auto fp16_data = static_cast<float16 *>(fp16_tensor.data_c());
+  auto bf16_data = static_cast<bfloat16 *>(bf16_tensor.data_c());
+  for (int64_t i = 0; i < kElemNum; ++i) {
+    ASSERT_EQ(fp16_data[i].int_value(), static_cast<float16>(data[i]).int_value());
+    ASSERT_EQ(bf16_data[i].int_value(), static_cast<bfloat16>(data[i]).int_value());
+  }
+  // The largest denormal rounds up to the smallest normal bfloat16.
+  ASSERT_EQ(bf16_data[2].int_value(), 0x0080);
+  ASSERT_EQ(bf16_data[8].int_value(), 0x0040);
+}
+
+/// Feature: Tensor dtype conversion
+/// Description: Convert a large float32 buffer to float16 on the kernel threads of the actor runtime.
+/// Expectation: Every element equals the scalar conversion.
+TEST_F(TestTensor, TensorConvertOnActorThreadPoolTest) {
+  auto actor_manager = ActorMgr::GetActorMgrRef();
+  if (actor_manager->GetActorThreadPool() == nullptr) {
+    const size_t kActorThreadNum = 1;
+    const size_t kMaxThreadNum = 4;
+    ASSERT_EQ(actor_manager->Initialize(true, kActorThreadNum, kMaxThreadNum), 0);
+  }
+  ASSERT_NE(actor_manager->GetActorThreadPool(), nullptr);
+  const int64_t kElemNum = (1 << 21) + 5;
+  std::vector<float> data(kElemNum);
+  for (int64_t i = 0; i < kElemNum; ++i) {
+    data[i] = static_cast<float>(i % 4099 - 2049) * 0.013f;
+  }
+  Tensor fp16_tensor(kNumberTypeFloat16, {kElemNum}, data.data(), kNumberTypeFloat32);
+  auto fp16_data = static_cast<float16 *>(fp16_tensor.data_c());
+  for (int64_t i = 0; i < kElemNum; ++i) {
+    ASSERT_EQ(fp16_data[i].int_value(), static_cast<float16>(data[i]).int_value());
+  }
+}
+
 /// Feature: SparseTensor
 /// Description: test AbstractSparseTensor/SparseTensorType API.
 /// Expectation: AbstractSparseTensor/SparseTensorType work as expected.
@@ -0,0 +1,47 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vector>
+#include "common/common_test.h"
+#include "plugin/device/cpu/kernel/matmul_cpu_kernel.h"
+#include "plugin/device/cpu/kernel/unique_cpu_kernel.h"
+
+namespace mindspore {
+namespace kernel {
+class KernelFlopsEstimateTest : public UT::Common {
+ public:
+  KernelFlopsEstimateTest() = default;
+};
+
+/// Feature: Roofline statistics of the CPU profiler.
+/// Description: Estimate the flops of MatMul and BatchMatMul with and without transposed inputs.
+/// Expectation: Two operations per output element and element of the reduced axis.
+TEST_F(KernelFlopsEstimateTest, test_matmul_flops) {
+  MatMulCpuKernelMod matmul("MatMul");
+  ASSERT_EQ(matmul.EstimateFlops({{4, 8}, {8, 16}}, {{4, 16}}), 2 * 4 * 16 * 8);
+  ASSERT_EQ(matmul.EstimateFlops({{8, 4}, {16, 8}}, {{4, 16}}), 2 * 4 * 16 * 8);
+  MatMulCpuKernelMod batch_matmul("BatchMatMul");
+  ASSERT_EQ(batch_matmul.EstimateFlops({{3, 4, 8}, {8, 16}}, {{3, 4, 16}}), 2 * 3 * 4 * 16 * 8);
+}
+
+/// Feature: Roofline statistics of the CPU profiler.
+/// Description: Estimate the flops of a kernel without its own estimate.
+/// Expectation: One operation per output element.
+TEST_F(KernelFlopsEstimateTest, test_default_flops) {
+  UniqueCpuKernelMod unique;
+  ASSERT_EQ(unique.EstimateFlops({{9}}, {{9}, {9}}), 18);
+}
+}  // namespace kernel
+}  // namespace mindspore
@@ -0,0 +1,262 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+#include "common/common_test.h"
+#include "base/float16.h"
+#include "backend/common/graph_kernel/model/graph_builder.h"
+#include "backend/common/graph_kernel/model/loop_program.h"
+#include "plugin/device/cpu/kernel/loop_program_cpu_kernel.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+using graphkernel::inner::GraphBuilder;
+using graphkernel::inner::LoopProgram;
+
+// The per-op reference kernels, each op reads and writes whole tensors in float32 like the single op cpu kernels.
+std::vector<float> Unary(const std::vector<float> &x, const std::function<float(float)> &func) {
+  std::vector<float> out(x.size());
+  (void)std::transform(x.begin(), x.end(), out.begin(), func);
+  return out;
+}
+
+// Binary op of numpy broadcast, the shapes are aligned to the right.
+std::vector<float> Binary(const std::vector<float> &a, const ShapeVector &a_shape, const std::vector<float> &b,
+                          const ShapeVector &b_shape, const ShapeVector &out_shape,
+                          const std::function<float(float, float)> &func) {
+  auto strides = [&out_shape](const ShapeVector &shape) {
+    ShapeVector result(out_shape.size(), 0);
+    int64_t stride = 1;
+    for (size_t i = shape.size(); i > 0; --i) {
+      auto d = out_shape.size() - shape.size() + i - 1;
+      result[d] = shape[i - 1] == 1 ? 0 : stride;
+      stride *= shape[i - 1];
+    }
+    return result;
+  };
+  auto a_strides = strides(a_shape);
+  auto b_strides = strides(b_shape);
+  int64_t size = 1;
+  for (auto dim : out_shape) {
+    size *= dim;
+  }
+  std::vector<float> out(LongToSize(size));
+  for (int64_t i = 0; i < size; ++i) {
+    int64_t a_index = 0;
+    int64_t b_index = 0;
+    auto rest = i;
+    for (size_t d = out_shape.size(); d > 0; --d) {
+      auto pos = rest % out_shape[d - 1];
+      rest /= out_shape[d - 1];
+      a_index += pos * a_strides[d - 1];
+      b_index += pos * b_strides[d - 1];
+    }
+    out[LongToSize(i)] = func(a[LongToSize(a_index)], b[LongToSize(b_index)]);
+  }
+  return out;
+}
+
+// Reduce the last axis of a [rows, cols] tensor.
+std::vector<float> ReduceLast(const std::vector<float> &x, size_t cols,
+                              const std::function<float(float, float)> &func) {
+  std::vector<float> out(x.size() / cols);
+  for (size_t r = 0; r < out.size(); ++r) {
+    out[r] = x[r * cols];
+    for (size_t c = 1; c < cols; ++c) {
+      out[r] = func(out[r], x[r * cols + c]);
+    }
+  }
+  return out;
+}
+
+std::vector<float> RoundToHalf(const std::vector<float> &x) {
+  return Unary(x, [](float v) { return static_cast<float>(float16(v)); });
+}
+}  // namespace
+
+class LoopProgramCpuKernelTest : public UT::Common {
+ public:
+  LoopProgramCpuKernelTest() = default;
+
+ protected:
+  std::vector<float> Random(size_t size, float low, float high) {
+    std::uniform_real_distribution<float> dist(low, high);
+    std::vector<float> data(size);
+    for (auto &value : data) {
+      value = dist(engine_);
+    }
+    return data;
+  }
+
+  // Lower the graph and launch its kernel on the buffers, the buffers must have the sizes of the arguments.
+  void Launch(const GraphBuilder &gb, const std::vector<void *> &inputs, const std::vector<void *> &outputs,
+              const std::vector<size_t> &input_sizes, const std::vector<size_t> &output_sizes) {
+    auto program = LoopProgram::Lower(gb.Get());
+    ASSERT_NE(program, nullptr);
+    auto kernel = std::make_shared<LoopProgramCpuKernelMod>("loop_program_test", program);
+    ASSERT_EQ(kernel->GetInputSizeList(), input_sizes);
+    ASSERT_EQ(kernel->GetOutputSizeList(), output_sizes);
+    std::vector<AddressPtr> input_addrs;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      (void)input_addrs.emplace_back(std::make_shared<Address>(inputs[i], input_sizes[i]));
+    }
+    std::vector<AddressPtr> output_addrs;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      (void)output_addrs.emplace_back(std::make_shared<Address>(outputs[i], output_sizes[i]));
+    }
+    ASSERT_TRUE(kernel->Launch(input_addrs, {}, output_addrs, nullptr));
+  }
+
+  void ExpectNear(const std::vector<float> &actual, const std::vector<float> &expect, float rtol, float atol) {
+    ASSERT_EQ(actual.size(), expect.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+      ASSERT_NEAR(actual[i], expect[i], atol + rtol * std::fabs(expect[i])) << "at " << i;
+    }
+  }
+
+  std::mt19937 engine_{2023};
+};
+
+/// Feature: LoopProgram cpu kernel.
+/// Description: Run an elementwise cluster of 40000 elements with two outputs and a const, cut into several tiles
+/// with a partial last one.
+/// Expectation: The outputs match the per-op reference kernels.
+TEST_F(LoopProgramCpuKernelTest, test_elemwise) {
+  const ShapeVector shape = {8, 5000};
+  const size_t size = 8 * 5000;
+  GraphBuilder gb("elemwise");
+  auto x = gb.Parameter({shape, kNumberTypeFloat32, kOpFormat_DEFAULT});
+  auto y = gb.Parameter({shape, kNumberTypeFloat32, kOpFormat_DEFAULT});
+  auto add = gb.Add(x, y);
+  auto out = gb.Tanh(gb.Mul(gb.Exp(gb.Sub(x, y)), gb.Tensor(0.5, kNumberTypeFloat32)));
+  gb.SetOutputs({out, add});
+  auto x_data = Random(size, -2, 2);
+  auto y_data = Random(size, -2, 2);
+  std::vector<float> out_data(size, 0);
+  std::vector<float> add_data(size, 0);
+  Launch(gb, {x_data.data(), y_data.data()}, {out_data.data(), add_data.data()}, {size * 4, size * 4},
+         {size * 4, size * 4});
+
+  auto sub = Binary(x_data, shape, y_data, shape, shape, std::minus<float>());
+  auto exp = Unary(sub, [](float v) { return std::exp(v); });
+  auto mul = Binary(exp, shape, {0.5f}, {}, shape, std::multiplies<float>());
+  // The nnacl tanh, which the Tanh op kernel runs too, is an approximation within 1e-4.
+  ExpectNear(out_data, Unary(mul, [](float v) { return std::tanh(v); }), 1e-4, 1e-6);
+  ExpectNear(add_data, Binary(x_data, shape, y_data, shape, shape, std::plus<float>()), 0, 0);
+}
+
+/// Feature: LoopProgram cpu kernel.
+/// Description: Run a cluster broadcasting a per channel value over the inner axis and an inner vector over the rows.
+/// Expectation: The output matches the per-op reference kernels.
+TEST_F(LoopProgramCpuKernelTest, test_broadcast) {
+  const ShapeVector shape = {6, 7, 300};
+  const ShapeVector scale_shape = {7, 1};
+  const ShapeVector bias_shape = {300};
+  GraphBuilder gb("broadcast");
+  auto x = gb.Parameter({shape, kNumberTypeFloat32, kOpFormat_DEFAULT});
+  auto scale = gb.Parameter({scale_shape, kNumberTypeFloat32, kOpFormat_DEFAULT});
+  auto bias = gb.Parameter({bias_shape, kNumberTypeFloat32, kOpFormat_DEFAULT});
+  auto out = gb.Emit("Maximum", {gb.Add(gb.Mul(x, scale), bias), gb.Tensor(0, kNumberTypeFloat32)});
+  gb.SetOutputs({out});
+  const size_t size = 6 * 7 * 300;
+  auto x_data = Random(size, -1, 1);
+  auto scale_data = Random(7, 0.5, 2);
+  auto bias_data = Random(300, -1, 1);
+  std::vector<float> out_data(size, 0);
+  Launch(gb, {x_data.data(), scale_data.data(), bias_data.data()}, {out_data.data()}, {size * 4, 7 * 4, 300 * 4},
+         {size * 4});
+
+  auto mul = Binary(x_data, shape, scale_data, scale_shape, shape, std::multiplies<float>());
+  auto add = Binary(mul, shape, bias_data, bias_shape, shape, std::plus<float>());
+  auto expect = Binary(add, shape, {0.0f}, {}, shape, [](float a, float b) { return std::max(a, b); });
+  ExpectNear(out_data, expect, 0, 0);
+}
+
+/// Feature: LoopProgram cpu kernel.
+/// Description: Run a softmax cluster, which reduces each row twice, and store a reduced value as an output too.
+/// Expectation: The outputs match the per-op reference kernels.
+TEST_F(LoopProgramCpuKernelTest, test_reduce) {
+  const ShapeVector shape = {33, 129};
+  const ShapeVector reduced_shape = {33, 1};
+  GraphBuilder gb("softmax");
+  auto x = gb.Parameter({shape, kNumberTypeFloat32, kOpFormat_DEFAULT});
+  auto max = gb.ReduceMax(x, {-1}, true);
+  auto exp = gb.Exp(gb.Sub(x, max));
+  auto sum = gb.ReduceSum(exp, {-1}, true);
+  auto min = gb.ReduceMin(x, {-1}, true);
+  gb.SetOutputs({gb.Div(exp, sum), sum, min});
+  const size_t size = 33 * 129;
+  auto x_data = Random(size, -5, 5);
+  std::vector<float> out_data(size, 0);
+  std::vector<float> sum_data(33, 0);
+  std::vector<float> min_data(33, 0);
+  Launch(gb, {x_data.data()}, {out_data.data(), sum_data.data(), min_data.data()}, {size * 4},
+         {size * 4, 33 * 4, 33 * 4});
+
+  auto max_ref = ReduceLast(x_data, 129, [](float a, float b) { return std::max(a, b); });
+  auto sub_ref = Binary(x_data, shape, max_ref, reduced_shape, shape, std::minus<float>());
+  auto exp_ref = Unary(sub_ref, [](float v) { return std::exp(v); });
+  auto sum_ref = ReduceLast(exp_ref, 129, std::plus<float>());
+  ExpectNear(out_data, Binary(exp_ref, shape, sum_ref, reduced_shape, shape, std::divides<float>()), 1e-5, 1e-7);
+  ExpectNear(sum_data, sum_ref, 1e-5, 0);
+  ExpectNear(min_data, ReduceLast(x_data, 129, [](float a, float b) { return std::min(a, b); }), 0, 0);
+}
+
+/// Feature: LoopProgram cpu kernel.
+/// Description: Run a float16 cluster with a cast to float32 and a cast back to float16 inside.
+/// Expectation: The outputs match the per-op reference kernels within the float16 rounding of each op.
+TEST_F(LoopProgramCpuKernelTest, test_float16) {
+  const ShapeVector shape = {16, 200};
+  const ShapeVector y_shape = {200};
+  GraphBuilder gb("float16");
+  auto x = gb.Parameter({shape, kNumberTypeFloat16, kOpFormat_DEFAULT});
+  auto y = gb.Parameter({y_shape, kNumberTypeFloat16, kOpFormat_DEFAULT});
+  auto muladd = gb.Add(gb.Mul(x, y), x);
+  auto exp = gb.Cast(gb.Exp(gb.Cast(x, kNumberTypeFloat32)), kNumberTypeFloat16);
+  gb.SetOutputs({muladd, gb.Sub(exp, y)});
+  const size_t size = 16 * 200;
+  auto x_ref = RoundToHalf(Random(size, -2, 2));
+  auto y_ref = RoundToHalf(Random(200, -2, 2));
+  std::vector<float16> x_data(size);
+  std::vector<float16> y_data(200);
+  (void)std::transform(x_ref.begin(), x_ref.end(), x_data.begin(), [](float v) { return float16(v); });
+  (void)std::transform(y_ref.begin(), y_ref.end(), y_data.begin(), [](float v) { return float16(v); });
+  std::vector<float16> muladd_data(size);
+  std::vector<float16> sub_data(size);
+  Launch(gb, {x_data.data(), y_data.data()}, {muladd_data.data(), sub_data.data()}, {size * 2, 200 * 2},
+         {size * 2, size * 2});
+
+  // The single ops round every result to float16, the cluster only rounds at the casts and the outputs.
+  auto mul_ref = RoundToHalf(Binary(x_ref, shape, y_ref, y_shape, shape, std::multiplies<float>()));
+  auto muladd_ref = RoundToHalf(Binary(mul_ref, shape, x_ref, shape, shape, std::plus<float>()));
+  auto exp_ref = RoundToHalf(Unary(x_ref, [](float v) { return std::exp(v); }));
+  auto sub_ref = RoundToHalf(Binary(exp_ref, shape, y_ref, y_shape, shape, std::minus<float>()));
+  std::vector<float> muladd_out(size);
+  std::vector<float> sub_out(size);
+  (void)std::transform(muladd_data.begin(), muladd_data.end(), muladd_out.begin(),
+                       [](float16 v) { return static_cast<float>(v); });
+  (void)std::transform(sub_data.begin(), sub_data.end(), sub_out.begin(),
+                       [](float16 v) { return static_cast<float>(v); });
+  ExpectNear(muladd_out, muladd_ref, 2e-3, 4e-3);
+  ExpectNear(sub_out, sub_ref, 2e-3, 4e-3);
+}
+}  // namespace kernel
+}  // namespace mindspore
@@ -0,0 +1,88 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "load_mindir/mmap_tensor_data.h"
+#include "ir/tensor.h"
+#include "utils/ms_utils.h"
+
+namespace mindspore {
+class TestMmapTensorData : public UT::Common {
+ public:
+  TestMmapTensorData() = default;
+
+  void SetUp() override {
+    // The first byte is the byte order flag, followed by two float tensors of 4 elements.
+    std::vector<float> values{0, 1, 2, 3, 4, 5, 6, 7, 8};
+    auto bytes = reinterpret_cast<char *>(values.data());
+    bytes[0] = static_cast<char>(common::IsLittleByteOrder());
+    auto fp = fopen(file_.c_str(), "wb");
+    ASSERT_NE(fp, nullptr);
+    (void)fwrite(values.data(), sizeof(float), values.size(), fp);
+    (void)fclose(fp);
+  }
+
+  void TearDown() override { (void)remove(file_.c_str()); }
+
+ protected:
+  std::string file_ = "./mmap_tensor_data_test.data";
+};
+
+/// Feature: Mmap MindIR external data.
+/// Description: Build tensors on a mapped external data file and update one of them.
+/// Expectation: The tensors read the file data, the update is not visible to other mappings of the file.
+TEST_F(TestMmapTensorData, test_mmap_tensor_data) {
+  auto file = MappedFile::Open(file_, common::IsLittleByteOrder());
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(file->size(), 9 * sizeof(float));
+  ShapeVector shape{2, 2};
+  auto data0 = std::make_shared<tensor::MmapTensorData>(file, sizeof(float), kNumberTypeFloat32, shape);
+  auto data1 = std::make_shared<tensor::MmapTensorData>(file, 5 * sizeof(float), kNumberTypeFloat32, shape);
+  auto tensor0 = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, shape, data0);
+  auto tensor1 = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, shape, data1);
+  ASSERT_EQ(tensor0->data().nbytes(), 4 * sizeof(float));
+  auto values0 = static_cast<float *>(tensor0->data_c());
+  auto values1 = static_cast<float *>(tensor1->data_c());
+  ASSERT_EQ(values0[0], 1);
+  ASSERT_EQ(values0[3], 4);
+  ASSERT_EQ(values1[0], 5);
+  ASSERT_EQ(values1[3], 8);
+
+  values0[1] = 10;
+  ASSERT_EQ(static_cast<float *>(tensor0->data_c())[1], 10);
+  auto other_file = MappedFile::Open(file_, common::IsLittleByteOrder());
+  ASSERT_NE(other_file, nullptr);
+  auto other_values = reinterpret_cast<float *>(other_file->data());
+  ASSERT_EQ(other_values[2], 2);
+
+  tensor::Tensor copy(*tensor1);
+  ASSERT_TRUE(copy.ValueEqual(*tensor1));
+  ASSERT_NE(copy.data_c(), tensor1->data_c());
+}
+
+/// Feature: Mmap MindIR external data.
+/// Description: Open a file with the other byte order and map tensor data out of the file range.
+/// Expectation: The file is rejected and the tensor data throws.
+TEST_F(TestMmapTensorData, test_mmap_tensor_data_invalid) {
+  ASSERT_EQ(MappedFile::Open(file_, !common::IsLittleByteOrder()), nullptr);
+  ASSERT_EQ(MappedFile::Open("./not_exist.data", common::IsLittleByteOrder()), nullptr);
+  auto file = MappedFile::Open(file_, common::IsLittleByteOrder());
+  ASSERT_NE(file, nullptr);
+  ASSERT_ANY_THROW(tensor::MmapTensorData(file, 6 * sizeof(float), kNumberTypeFloat32, ShapeVector{2, 2}));
+}
+}  // namespace mindspore
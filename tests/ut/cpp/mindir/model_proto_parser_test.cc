@@ -0,0 +1,157 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "load_mindir/model_proto_parser.h"
+#include "utils/convert_utils_base.h"
+#include "utils/log_adapter.h"
+#include "utils/ms_utils.h"
+
+namespace mindspore {
+namespace {
+// Set to the node numbers of the load time benchmark, e.g. "10000,100000,1000000".
+constexpr char kEnvParseBenchmarkNodes[] = "MS_MINDIR_PARSE_BENCHMARK_NODES";
+constexpr size_t kParameterSize = 4096;
+
+void AddNodes(mind_ir::GraphProto *graph, size_t node_num) {
+  for (size_t i = 0; i < node_num; ++i) {
+    auto node = graph->add_node();
+    node->set_op_type("REF::Add");
+    node->set_name(graph->name() + "_node_" + std::to_string(i));
+    node->add_input(i == 0 ? graph->name() + "_param_0" : graph->name() + "_node_" + std::to_string(i - 1));
+    node->add_input(graph->name() + "_param_" + std::to_string(i % graph->parameter_size()));
+    node->add_output(node->name());
+    auto attr = node->add_attribute();
+    attr->set_name("shape");
+    attr->set_type(mind_ir::AttributeProto_AttributeType_TUPLE);
+    attr->add_ints(SizeToLong(i));
+  }
+}
+
+// A main graph holding the parameters and most of the nodes, and function graphs holding the rest.
+std::string BuildSyntheticModel(size_t node_num, size_t function_num) {
+  mind_ir::ModelProto model;
+  model.set_ir_version("0.1.1");
+  model.set_producer_name("MindSpore");
+  model.set_little_endian(common::IsLittleByteOrder());
+  auto main_graph = model.mutable_graph();
+  main_graph->set_name("main_graph");
+  size_t parameter_num = std::max<size_t>(node_num / 100, 1);
+  for (size_t i = 0; i < parameter_num; ++i) {
+    auto parameter = main_graph->add_parameter();
+    parameter->set_name("main_graph_param_" + std::to_string(i));
+    parameter->set_data_type(mind_ir::TensorProto_DataType_FLOAT);
+    parameter->add_dims(SizeToLong(kParameterSize / sizeof(float)));
+    parameter->set_raw_data(std::string(kParameterSize, static_cast<char>(i)));
+  }
+  size_t function_node_num = node_num / (function_num + 1);
+  AddNodes(main_graph, node_num - function_node_num * function_num);
+  for (size_t i = 0; i < function_num; ++i) {
+    auto function = model.add_functions();
+    function->set_name("function_" + std::to_string(i));
+    auto parameter = function->add_parameter();
+    parameter->set_name(function->name() + "_param_0");
+    AddNodes(function, function_node_num);
+  }
+  model.mutable_user_info()->insert({"key", "value"});
+  return model.SerializeAsString();
+}
+}  // namespace
+
+class TestModelProtoParser : public UT::Common {
+ public:
+  TestModelProtoParser() = default;
+};
+
+/// Feature: Parallel MindIR parsing.
+/// Description: Parse a synthetic model with several threads.
+/// Expectation: The parsed model is the same as the one parsed by protobuf on one thread.
+TEST_F(TestModelProtoParser, test_parse_model_parallel) {
+  auto buffer = BuildSyntheticModel(10000, 16);
+  mind_ir::ModelProto expect;
+  ASSERT_TRUE(expect.ParseFromString(buffer));
+  mind_ir::ModelProto model;
+  ASSERT_TRUE(ParseModelProtoParallel(buffer.data(), buffer.size(), &model, 4));
+  ASSERT_EQ(model.functions_size(), 16);
+  ASSERT_EQ(model.graph().node_size(), expect.graph().node_size());
+  ASSERT_EQ(model.graph().parameter_size(), expect.graph().parameter_size());
+  ASSERT_EQ(model.user_info().at("key"), "value");
+  ASSERT_EQ(model.SerializeAsString(), expect.SerializeAsString());
+}
+
+/// Feature: Parallel MindIR parsing.
+/// Description: Parse a truncated model.
+/// Expectation: Parsing fails.
+TEST_F(TestModelProtoParser, test_parse_model_parallel_truncated) {
+  auto buffer = BuildSyntheticModel(10000, 4);
+  mind_ir::ModelProto model;
+  ASSERT_FALSE(ParseModelProtoParallel(buffer.data(), buffer.size() - 1, &model, 4));
+  ASSERT_FALSE(ParseModelProtoParallel(nullptr, buffer.size(), &model, 4));
+}
+
+/// Feature: Parallel MindIR parsing.
+/// Description: Parse a synthetic model file, and a file which does not exist.
+/// Expectation: The model parsed from the mapped file is the same as the one parsed by protobuf, a missing file fails.
+TEST_F(TestModelProtoParser, test_parse_model_file) {
+  auto buffer = BuildSyntheticModel(10000, 4);
+  std::string path = "./test_parse_model_file.mindir";
+  {
+    std::ofstream output(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    ASSERT_TRUE(output.is_open());
+    (void)output.write(buffer.data(), SizeToLong(buffer.size()));
+  }
+  mind_ir::ModelProto expect;
+  ASSERT_TRUE(expect.ParseFromString(buffer));
+  mind_ir::ModelProto model;
+  ASSERT_TRUE(ParseModelProtoFile(path, &model, 4));
+  ASSERT_EQ(model.SerializeAsString(), expect.SerializeAsString());
+  (void)std::remove(path.c_str());
+  ASSERT_FALSE(ParseModelProtoFile(path, &model, 4));
+}
+
+/// Feature: Parallel MindIR parsing.
+/// Description: Load time benchmark of synthetic models with the node numbers given by the environment variable.
+/// Expectation: The parallel parser produces the same models.
+TEST_F(TestModelProtoParser, test_parse_model_benchmark) {
+  auto node_nums = common::GetEnv(kEnvParseBenchmarkNodes);
+  if (node_nums.empty()) {
+    return;
+  }
+  size_t pos = 0;
+  while (pos < node_nums.size()) {
+    auto next = node_nums.find(',', pos);
+    auto node_num = std::stoul(node_nums.substr(pos, next == std::string::npos ? std::string::npos : next - pos));
+    pos = next == std::string::npos ? node_nums.size() : next + 1;
+    auto buffer = BuildSyntheticModel(node_num, 64);
+
+    auto start = std::chrono::steady_clock::now();
+    mind_ir::ModelProto expect;
+    ASSERT_TRUE(expect.ParseFromString(buffer));
+    auto serial_cost = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    mind_ir::ModelProto model;
+    ASSERT_TRUE(ParseModelProtoParallel(buffer.data(), buffer.size(), &model));
+    auto parallel_cost = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(model.SerializeAsString(), expect.SerializeAsString());
+    MS_LOG(INFO) << "Nodes: " << node_num << ", model size: " << buffer.size() << ", protobuf: " << serial_cost
+                 << " ms, parallel: " << parallel_cost << " ms, speedup: " << serial_cost / parallel_cost;
+  }
+}
+}  // namespace mindspore
@@ -14,6 +14,10 @@
  * limitations under the License.
  */
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "pipeline/jit/ps/static_analysis/evaluator.h"
 #include "pipeline/jit/ps/static_analysis/prim.h"
 
@@ -61,6 +65,82 @@ TEST_F(TestEvaluatorCacheMap, test_evaluator_cache_map) {
   ASSERT_TRUE(iter == cache.end());
 }
 
+namespace {
+AbstractBasePtrList ShardedCacheKey(int64_t i) {
+  return {FromValue(i, false), FromValue(i + 1, false)};
+}
+}  // namespace
+
+// Feature: Sharded evaluator cache.
+// Description: set, get, find and list the items of an EvalResultCache.
+// Expectation: equal keys find the stored item, a missing key finds nothing, and clear empties every shard.
+TEST_F(TestEvaluatorCacheMap, test_sharded_eval_result_cache) {
+  EvalResultCache cache;
+  constexpr int64_t kKeyNum = 100;
+  std::vector<AbstractBasePtrList> keys;
+  for (int64_t i = 0; i < kKeyNum; ++i) {
+    (void)keys.emplace_back(ShardedCacheKey(i));
+    cache.set(keys.back(), std::make_shared<EvalResult>(FromValue(i, false), std::make_shared<AttrValueMap>()));
+  }
+  ASSERT_EQ(cache.size(), kKeyNum);
+  ASSERT_EQ(cache.items().size(), kKeyNum);
+
+  auto item = cache.find(ShardedCacheKey(7));
+  ASSERT_TRUE(item.has_value());
+  ASSERT_TRUE(item->first[0] == keys[7][0]);
+  ASSERT_EQ(GetValue<int64_t>(item->second->abstract()->BuildValue()), 7);
+  ASSERT_TRUE(cache.get(ShardedCacheKey(7)) == item->second);
+  ASSERT_FALSE(cache.find(ShardedCacheKey(kKeyNum)).has_value());
+  ASSERT_TRUE(cache.get(ShardedCacheKey(kKeyNum)) == nullptr);
+
+  cache.clear();
+  ASSERT_TRUE(cache.empty());
+  ASSERT_TRUE(cache.items().empty());
+}
+
+// Feature: Sharded evaluator cache.
+// Description: several threads look up and fill the same EvalResultCache at the same time.
+// Expectation: every lookup sees either no item or the item set for its key, and each key is stored once.
+TEST_F(TestEvaluatorCacheMap, test_sharded_eval_result_cache_contention) {
+  EvalResultCache cache;
+  constexpr int64_t kKeyNum = 512;
+  constexpr size_t kThreadNum = 8;
+  constexpr size_t kRoundNum = 4;
+  std::vector<AbstractBasePtrList> keys;
+  for (int64_t i = 0; i < kKeyNum; ++i) {
+    (void)keys.emplace_back(ShardedCacheKey(i));
+  }
+  std::atomic<size_t> mismatch{0};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreadNum; ++t) {
+    (void)threads.emplace_back([&cache, &keys, &mismatch, t]() {
+      for (size_t round = 0; round < kRoundNum; ++round) {
+        for (size_t n = 0; n < keys.size(); ++n) {
+          // Each thread starts from another key, so the threads hit the shards in different orders.
+          auto i = static_cast<int64_t>((n + t * keys.size() / kThreadNum) % keys.size());
+          auto item = cache.find(keys[i]);
+          if (!item.has_value()) {
+            cache.set(keys[i], std::make_shared<EvalResult>(FromValue(i, false), std::make_shared<AttrValueMap>()));
+            item = cache.find(keys[i]);
+          }
+          if (!item.has_value() || GetValue<int64_t>(item->second->abstract()->BuildValue()) != i ||
+              !AbstractBasePtrListDeepEqual(item->first, keys[i])) {
+            ++mismatch;
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(mismatch.load(), 0);
+  ASSERT_EQ(cache.size(), kKeyNum);
+  for (const auto &item : cache.items()) {
+    ASSERT_EQ(GetValue<int64_t>(item.second->abstract()->BuildValue()), GetValue<int64_t>(item.first[0]->BuildValue()));
+  }
+}
+
 /* skip ut test cases temporarily
 class TestStandardEvaluator : public UT::Common {
  public:
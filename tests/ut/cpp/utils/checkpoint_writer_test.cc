@@ -0,0 +1,165 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "include/common/utils/checkpoint_writer.h"
+#include "utils/system/sha256.h"
+
+namespace mindspore {
+class TestCheckpointWriter : public UT::Common {
+ public:
+  TestCheckpointWriter() = default;
+
+  void TearDown() override {
+    for (const auto &dir : {full_dir_, inc_dir_}) {
+      for (const auto &file : ListFiles(dir)) {
+        (void)remove((dir + "/" + file).c_str());
+      }
+      (void)remove(dir.c_str());
+    }
+  }
+
+  std::vector<std::string> ListFiles(const std::string &dir, const std::string &prefix = "") {
+    std::vector<std::string> files;
+    auto dir_handle = opendir(dir.c_str());
+    if (dir_handle == nullptr) {
+      return files;
+    }
+    for (auto entry = readdir(dir_handle); entry != nullptr; entry = readdir(dir_handle)) {
+      std::string name = entry->d_name;
+      if (name != "." && name != ".." && name.compare(0, prefix.size(), prefix) == 0) {
+        files.push_back(name);
+      }
+    }
+    (void)closedir(dir_handle);
+    return files;
+  }
+
+  tensor::TensorPtr MakeTensor(const ShapeVector &shape, float value) {
+    auto tensor = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, shape);
+    auto data = static_cast<float *>(tensor->data_c());
+    for (int64_t i = 0; i < tensor->DataSize(); ++i) {
+      data[i] = value + static_cast<float>(i);
+    }
+    return tensor;
+  }
+
+  // Copy the data of the tensors, the copy constructor of Tensor shares it.
+  NamedTensors CopyTensors(const NamedTensors &tensors) {
+    NamedTensors copies;
+    for (const auto &[name, tensor] : tensors) {
+      (void)copies.emplace_back(name, std::make_shared<tensor::Tensor>(*tensor, tensor->data_type()));
+    }
+    return copies;
+  }
+
+  void CheckTensors(const NamedTensors &expect, const NamedTensors &actual) {
+    ASSERT_EQ(expect.size(), actual.size());
+    for (size_t i = 0; i < expect.size(); ++i) {
+      ASSERT_EQ(expect[i].first, actual[i].first);
+      ASSERT_EQ(expect[i].second->data_type(), actual[i].second->data_type());
+      ASSERT_EQ(expect[i].second->shape(), actual[i].second->shape());
+      // Tensors without data never compare equal.
+      if (expect[i].second->DataSize() > 0) {
+        ASSERT_TRUE(expect[i].second->ValueEqual(*actual[i].second));
+      }
+    }
+  }
+
+ protected:
+  std::string full_dir_ = "./checkpoint_writer_test_full";
+  std::string inc_dir_ = "./checkpoint_writer_test_inc";
+};
+
+/// Feature: Sharded asynchronous checkpoint.
+/// Description: Save tensors, update them after Save returns and load the checkpoint with and without mmap.
+/// Expectation: The loaded tensors hold the values of the snapshot.
+TEST_F(TestCheckpointWriter, test_save_and_load) {
+  NamedTensors tensors{
+    {"weight", MakeTensor({64, 33}, 1)}, {"bias", MakeTensor({33}, 2)}, {"empty", MakeTensor({0}, 0)}};
+  auto expect = CopyTensors(tensors);
+  CheckpointWriter writer(2);
+  ASSERT_TRUE(writer.Save(full_dir_, tensors));
+  static_cast<float *>(tensors[0].second->data_c())[0] = -1;
+  ASSERT_TRUE(writer.Wait());
+
+  NamedTensors loaded;
+  ASSERT_TRUE(CheckpointWriter::Load(full_dir_, false, &loaded));
+  CheckTensors(expect, loaded);
+  NamedTensors mapped;
+  ASSERT_TRUE(CheckpointWriter::Load(full_dir_, true, &mapped));
+  CheckTensors(expect, mapped);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(mapped[0].second->data_c()) % 64, 0);
+}
+
+/// Feature: Sharded asynchronous checkpoint.
+/// Description: Save a checkpoint incrementally after updating one tensor, then save it in full to the directory
+/// the incremental checkpoint refers to.
+/// Expectation: Only the updated tensor is written, the full save does not overwrite the shards referred to.
+TEST_F(TestCheckpointWriter, test_incremental_save) {
+  NamedTensors tensors{{"a", MakeTensor({128}, 1)}, {"b", MakeTensor({256}, 2)}, {"c", MakeTensor({16, 4}, 3)}};
+  auto expect = CopyTensors(tensors);
+  CheckpointWriter writer(4);
+  ASSERT_TRUE(writer.Save(full_dir_, tensors, true));
+  ASSERT_TRUE(writer.Wait());
+  auto full_shards = ListFiles(full_dir_, "shard_");
+  ASSERT_EQ(full_shards.size(), 3);
+  static_cast<float *>(tensors[1].second->data_c())[3] = 100;
+  ASSERT_TRUE(writer.Save(inc_dir_, tensors, true));
+  ASSERT_TRUE(writer.Wait());
+
+  auto inc_shards = ListFiles(inc_dir_, "shard_");
+  ASSERT_EQ(inc_shards.size(), 1);
+  std::ifstream shard(inc_dir_ + "/" + inc_shards[0], std::ios::binary | std::ios::ate);
+  ASSERT_TRUE(shard.is_open());
+  ASSERT_EQ(static_cast<size_t>(shard.tellg()), 64 + 256 * sizeof(float));
+  NamedTensors loaded;
+  ASSERT_TRUE(CheckpointWriter::Load(inc_dir_, false, &loaded));
+  CheckTensors(tensors, loaded);
+
+  // A full save to the directory the incremental checkpoint refers to keeps the shards referred to.
+  static_cast<float *>(tensors[0].second->data_c())[0] = -1;
+  ASSERT_TRUE(writer.Save(full_dir_, tensors));
+  ASSERT_TRUE(writer.Wait());
+  ASSERT_EQ(ListFiles(full_dir_, "shard_").size(), 6);
+  ASSERT_TRUE(CheckpointWriter::Load(full_dir_, false, &loaded));
+  CheckTensors(tensors, loaded);
+  ASSERT_TRUE(CheckpointWriter::Load(inc_dir_, false, &loaded));
+  static_cast<float *>(expect[1].second->data_c())[3] = 100;
+  CheckTensors(expect, loaded);
+}
+
+/// Feature: Sharded asynchronous checkpoint.
+/// Description: Digest buffers around the SHA-256 block and padding boundaries in place.
+/// Expectation: The digests are the ones of the copied strings.
+TEST_F(TestCheckpointWriter, test_digest_buffer) {
+  ASSERT_EQ(system::sha256::GetHashFromBuffer("abc", 3),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  std::string data(1000, 0);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>(i * 131 + 7);
+  }
+  for (size_t size : {1, 55, 56, 63, 64, 65, 119, 120, 128, 1000}) {
+    ASSERT_EQ(system::sha256::GetHashFromBuffer(data.data(), size),
+              system::sha256::GetHashFromString(data.substr(0, size)));
+  }
+  ASSERT_EQ(system::sha256::GetHashFromBuffer(data.data(), 0), "");
+}
+}  // namespace mindspore
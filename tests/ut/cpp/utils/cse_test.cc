@@ -69,5 +69,105 @@ TEST_F(TestCSE, TestHasHiddenSideEffect) {
   call_node_count = GetFuncGraphCallCount(hidden_effect_node_call_graph);
   ASSERT_EQ(call_node_count, 2);
 }
+
+// Feature: CSE.
+// Description: run CSE, rewire an input through the manager and run CSE again.
+// Expectation: the structural hashes are cached by the first run, the manager resets the hashes of the rewired node
+// and its users only, and the second run merges the nodes that became equal.
+TEST_F(TestCSE, TestCachedStructuralHash) {
+  auto fg = std::make_shared<FuncGraph>();
+  auto x = fg->add_parameter();
+  auto y = fg->add_parameter();
+  auto add_prim = NewValueNode(prim::kPrimAdd);
+  auto mul_prim = NewValueNode(prim::kPrimMul);
+  auto make_tuple_prim = NewValueNode(prim::kPrimMakeTuple);
+  auto add1 = fg->NewCNode({add_prim, x, y});
+  auto add2 = fg->NewCNode({add_prim, x, x});
+  auto mul1 = fg->NewCNode({mul_prim, add1, y});
+  auto mul2 = fg->NewCNode({mul_prim, add2, y});
+  auto out = fg->NewCNode({make_tuple_prim, mul1, mul2});
+  fg->set_output(out);
+  auto manager = Manage(fg, true);
+
+  CSE cse_instance;
+  ASSERT_FALSE(cse_instance.Cse(fg, manager));
+  ASSERT_NE(add1->structural_hash(), 0);
+  ASSERT_NE(mul1->structural_hash(), 0);
+  ASSERT_NE(out->structural_hash(), 0);
+
+  manager->SetEdge(add2, 2, y);
+  ASSERT_EQ(add2->structural_hash(), 0);
+  ASSERT_EQ(mul2->structural_hash(), 0);
+  ASSERT_EQ(out->structural_hash(), 0);
+  ASSERT_NE(add1->structural_hash(), 0);
+  ASSERT_NE(mul1->structural_hash(), 0);
+
+  ASSERT_TRUE(cse_instance.Cse(fg, manager));
+  auto new_out = fg->output()->cast<CNodePtr>();
+  ASSERT_TRUE(new_out != nullptr);
+  ASSERT_EQ(new_out->input(1), new_out->input(2));
+}
+
+// Feature: CSE.
+// Description: run CSE twice on a graph that is not changed in between.
+// Expectation: the second run reuses the hashes cached on the nodes instead of computing them again.
+TEST_F(TestCSE, TestReuseStructuralHash) {
+  auto fg = std::make_shared<FuncGraph>();
+  auto x = fg->add_parameter();
+  auto y = fg->add_parameter();
+  auto add_prim = NewValueNode(prim::kPrimAdd);
+  auto mul_prim = NewValueNode(prim::kPrimMul);
+  auto add = fg->NewCNode({add_prim, x, y});
+  auto mul = fg->NewCNode({mul_prim, add, y});
+  fg->set_output(mul);
+  auto manager = Manage(fg, true);
+
+  CSE cse_instance;
+  ASSERT_FALSE(cse_instance.Cse(fg, manager));
+  auto add_hash = add->structural_hash();
+  ASSERT_NE(add_hash, 0);
+  constexpr std::size_t kMarker = 12345;
+  mul->set_structural_hash(kMarker);
+
+  ASSERT_FALSE(cse_instance.Cse(fg, manager));
+  ASSERT_EQ(add->structural_hash(), add_hash);
+  ASSERT_EQ(mul->structural_hash(), kMarker);
+}
+
+// Feature: CSE.
+// Description: run CSE, replace a node through the manager and run CSE again.
+// Expectation: the replacement resets the hashes of the users of the replaced node and their users only, and the
+// second run merges the users that became equal.
+TEST_F(TestCSE, TestReplaceResetsStructuralHash) {
+  auto fg = std::make_shared<FuncGraph>();
+  auto x = fg->add_parameter();
+  auto y = fg->add_parameter();
+  auto add_prim = NewValueNode(prim::kPrimAdd);
+  auto sub_prim = NewValueNode(prim::kPrimSub);
+  auto mul_prim = NewValueNode(prim::kPrimMul);
+  auto make_tuple_prim = NewValueNode(prim::kPrimMakeTuple);
+  auto add1 = fg->NewCNode({add_prim, x, y});
+  auto sub = fg->NewCNode({sub_prim, x, y});
+  auto mul1 = fg->NewCNode({mul_prim, add1, y});
+  auto mul2 = fg->NewCNode({mul_prim, sub, y});
+  auto out = fg->NewCNode({make_tuple_prim, mul1, mul2});
+  fg->set_output(out);
+  auto manager = Manage(fg, true);
+
+  CSE cse_instance;
+  ASSERT_FALSE(cse_instance.Cse(fg, manager));
+  ASSERT_NE(mul2->structural_hash(), 0);
+
+  ASSERT_TRUE(manager->Replace(sub, add1));
+  ASSERT_EQ(mul2->structural_hash(), 0);
+  ASSERT_EQ(out->structural_hash(), 0);
+  ASSERT_NE(add1->structural_hash(), 0);
+  ASSERT_NE(mul1->structural_hash(), 0);
+
+  ASSERT_TRUE(cse_instance.Cse(fg, manager));
+  auto new_out = fg->output()->cast<CNodePtr>();
+  ASSERT_TRUE(new_out != nullptr);
+  ASSERT_EQ(new_out->input(1), new_out->input(2));
+}
 }  // namespace opt
 }  // namespace mindspore
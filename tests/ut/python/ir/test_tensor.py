@@ -560,3 +560,33 @@ def test_tensor_from_numpy():
     x = np.array([[1, 2], [3, 4]], order='F')
     b = Tensor.from_numpy(x)
     assert np.all(b.asnumpy() == np.array([[1, 2], [3, 4]]))
+
+
+def test_tensor_dlpack():
+    """
+    Feature: DLPack exchange of tensors.
+    Description: Import numpy arrays through DLPack and export a tensor back to numpy.
+    Expectation: Compact data is shared in both directions, strided data is copied in row-major order.
+    """
+    a = np.arange(6, dtype=np.float32).reshape(2, 3)
+    t = ms.Tensor.from_dlpack(a)
+    assert t.dtype == ms.float32
+    assert t.shape == (2, 3)
+    a[1, 2] = 100
+    assert t.asnumpy()[1, 2] == 100
+    del a
+    assert np.all(t.asnumpy()[0] == np.array([0, 1, 2]))
+
+    b = np.arange(12, dtype=np.int64).reshape(3, 4).T
+    tb = ms.Tensor.from_dlpack(b)
+    assert np.all(tb.asnumpy() == b)
+    b[0, 0] = -1
+    assert tb.asnumpy()[0, 0] == 0
+
+    x = Tensor(np.ones((2, 2), np.float32))
+    assert x.__dlpack_device__() == (1, 0)
+    y = np.from_dlpack(x)
+    y[0, 0] = 5
+    assert x.asnumpy()[0, 0] == 5
+    with pytest.raises(TypeError):
+        ms.Tensor.from_dlpack([1, 2, 3])
@@ -479,6 +479,41 @@ def test_save_and_load_checkpoint_for_network_with_encryption():
         os.remove(ckpt_path)
 
 
+def test_save_and_load_sharded_checkpoint():
+    """
+    Feature: Sharded checkpoint.
+    Description: Save a sharded checkpoint, update one parameter and save it incrementally to another directory.
+    Expectation: Both checkpoints load the parameters saved to them.
+    """
+    context.set_context(mode=context.GRAPH_MODE)
+    weight = Tensor(np.arange(48).reshape(4, 12), dtype=mstype.float32)
+    bias = Tensor(np.ones([12]), dtype=mstype.float32)
+    full_dir = "./sharded_ckpt_full"
+    inc_dir = "./sharded_ckpt_inc"
+    save_checkpoint({"weight": Parameter(weight, name="weight"), "bias": Parameter(bias, name="bias")}, full_dir,
+                    sharded=True, incremental=True)
+    new_bias = Tensor(np.zeros([12]), dtype=mstype.float32)
+    save_checkpoint({"weight": Parameter(weight, name="weight"), "bias": Parameter(new_bias, name="bias")}, inc_dir,
+                    sharded=True, incremental=True)
+    full_dict = load_checkpoint(full_dir)
+    inc_dict = load_checkpoint(inc_dir, choice_func=lambda x: x == "bias")
+    assert np.allclose(full_dict["weight"].asnumpy(), weight.asnumpy())
+    assert np.allclose(full_dict["bias"].asnumpy(), bias.asnumpy())
+    assert list(inc_dict.keys()) == ["bias"]
+    assert np.allclose(inc_dict["bias"].asnumpy(), new_bias.asnumpy())
+    assert len([name for name in os.listdir(inc_dir) if name.startswith("shard_")]) == 1
+    assert list(load_checkpoint(full_dir, filter_prefix="bias").keys()) == ["weight"]
+    assert list(load_checkpoint(full_dir, specify_prefix=["bias"]).keys()) == ["bias"]
+    with pytest.raises(ValueError):
+        load_checkpoint(full_dir, dec_key=secrets.token_bytes(16))
+    with pytest.raises(ValueError):
+        save_checkpoint({"bias": Parameter(bias, name="bias")}, full_dir, enc_key=secrets.token_bytes(16),
+                        sharded=True)
+    import shutil
+    shutil.rmtree(full_dir)
+    shutil.rmtree(inc_dir)
+
+
 class MYNET(nn.Cell):
     """ NET definition """
 